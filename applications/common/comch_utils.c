@@ -30,15 +30,32 @@
 
 #include <samples/common.h>
 
+#include <string.h>
 #include <time.h>
 
 #include "comch_utils.h"
 
 DOCA_LOG_REGISTER(COMCH_UTILS);
 
-#define COMCH_NUM_TASKS 1024 /* Tasks for sending comch messages */
+#define COMCH_NUM_TASKS 1024	  /* Tasks for sending comch messages */
+#define COMCH_PROGRESS_BUDGET 64 /* Maximum events handled per call to progress a multi-connection server */
 #define SLEEP_IN_NANOS (10 * 1000)
 
+struct comch_cfg;
+
+/* State kept for each connection, the doca connection user data points to it */
+struct comch_connection_slot {
+	struct comch_cfg *comch_cfg;		  /* Configuration object the connection belongs to */
+	struct doca_comch_connection *connection; /* Connection using the slot, NULL if the slot is free */
+	void *conn_user_data;			  /* Per-connection user data set by the app */
+	uint32_t inflight_sends;		  /* Send tasks submitted and not yet completed */
+	uint32_t max_inflight_sends;		  /* Share of the send task pool the connection may hold */
+	uint64_t rx_msgs;			  /* Messages received on the connection */
+	uint64_t rx_bytes;			  /* Bytes received on the connection */
+	uint64_t tx_bytes;			  /* Bytes sent on the connection */
+	struct timespec connect_time;		  /* Time the connection was established */
+};
+
 struct comch_cfg {
 	void *app_user_data;  /* User-data supplied by the app */
 	struct doca_pe *pe;   /* Progress engine for comch */
@@ -52,6 +69,18 @@ struct comch_cfg {
 	struct doca_dev_rep *dev_rep;			 /* Representor in use (DPU only) */
 	uint32_t max_buf_size;				 /* Maximum size of message on channel */
 	uint8_t is_server;				 /* Indicator of client or server */
+	uint8_t is_multi;				 /* Server accepts more than one connection */
+	struct comch_connection_slot *slots;		 /* Connection slots, one per allowed connection */
+	uint32_t max_connections;			 /* Number of connection slots */
+	uint32_t num_connections;			 /* Number of connected slots */
+	uint32_t next_poll;				 /* Slot the next fair progress round starts from */
+	doca_comch_event_msg_recv_cb_t app_recv_cb;	 /* Receive callback of the app, dispatched per message */
+	comch_utils_connection_event_cb_t connect_cb;	 /* App callback for a new connection (server only) */
+	comch_utils_connection_event_cb_t disconnect_cb; /* App callback for a closed connection (server only) */
+	uint64_t total_connections;			 /* Connections accepted since the server started */
+	uint64_t total_rx_bytes;			 /* Bytes received on connections that have closed */
+	uint64_t total_tx_bytes;			 /* Bytes sent on connections that have closed */
+	struct timespec start_time;			 /* Time the server started accepting connections */
 };
 
 /*
@@ -67,9 +96,13 @@ static void comch_send_completion(struct doca_comch_task_send *task,
 				  union doca_data task_user_data,
 				  union doca_data ctx_user_data)
 {
-	(void)task_user_data;
+	struct comch_connection_slot *slot = (struct comch_connection_slot *)task_user_data.ptr;
+
 	(void)ctx_user_data;
 
+	if (slot != NULL && slot->inflight_sends > 0)
+		slot->inflight_sends--;
+
 	doca_task_free(doca_comch_task_send_as_task(task));
 }
 
@@ -87,13 +120,96 @@ static void comch_send_completion_err(struct doca_comch_task_send *task,
 				      union doca_data task_user_data,
 				      union doca_data ctx_user_data)
 {
-	(void)task_user_data;
+	struct comch_connection_slot *slot = (struct comch_connection_slot *)task_user_data.ptr;
+
 	(void)ctx_user_data;
 
+	if (slot != NULL && slot->inflight_sends > 0)
+		slot->inflight_sends--;
+
 	doca_task_free(doca_comch_task_send_as_task(task));
 	DOCA_LOG_ERR("Send Task got a completion error");
 }
 
+/*
+ * Seconds elapsed between two points in time
+ *
+ * @start [in]: start time
+ * @end [in]: end time
+ * @return: elapsed seconds
+ */
+static double comch_elapsed_secs(const struct timespec *start, const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Bind a connection to a free slot of the configuration object
+ *
+ * @comch_cfg [in]: comch utils configuration object
+ * @comch_connection [in]: connection to bind
+ * @return: bound slot, or NULL if all slots are in use
+ */
+static struct comch_connection_slot *comch_slot_bind(struct comch_cfg *comch_cfg,
+						     struct doca_comch_connection *comch_connection)
+{
+	struct comch_connection_slot *slot;
+	uint32_t i, inflight_sends;
+
+	for (i = 0; i < comch_cfg->max_connections; i++) {
+		slot = &comch_cfg->slots[i];
+		if (slot->connection != NULL)
+			continue;
+
+		/* Sends of the previous owner may still be completing and count against the shared pool */
+		inflight_sends = slot->inflight_sends;
+		memset(slot, 0, sizeof(*slot));
+		slot->inflight_sends = inflight_sends;
+		slot->comch_cfg = comch_cfg;
+		slot->connection = comch_connection;
+		/* Split the send task pool so a busy connection cannot starve the others */
+		slot->max_inflight_sends = COMCH_NUM_TASKS / comch_cfg->max_connections;
+		clock_gettime(CLOCK_MONOTONIC, &slot->connect_time);
+		comch_cfg->num_connections++;
+		comch_cfg->total_connections++;
+		return slot;
+	}
+
+	return NULL;
+}
+
+/*
+ * Release the slot of a closed connection and fold its counters into the server totals
+ *
+ * @slot [in]: slot to release
+ */
+static void comch_slot_release(struct comch_connection_slot *slot)
+{
+	struct comch_cfg *comch_cfg = slot->comch_cfg;
+	struct timespec now;
+	double secs;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	secs = comch_elapsed_secs(&slot->connect_time, &now);
+	if (secs <= 0)
+		secs = 1e-9;
+
+	DOCA_LOG_DBG("Connection closed after %.3f s: received %lu messages, %lu bytes (%.2f MB/s), sent %lu bytes",
+		     secs,
+		     slot->rx_msgs,
+		     slot->rx_bytes,
+		     slot->rx_bytes / secs / 1e6,
+		     slot->tx_bytes);
+
+	comch_cfg->total_rx_bytes += slot->rx_bytes;
+	comch_cfg->total_tx_bytes += slot->tx_bytes;
+	comch_cfg->num_connections--;
+
+	/* In flight completions may still reference the slot, keep it owned by the configuration object */
+	slot->connection = NULL;
+	slot->conn_user_data = NULL;
+}
+
 /*
  * Callback for new server connection
  *
@@ -107,6 +223,8 @@ static void server_connection_cb(struct doca_comch_event_connection_status_chang
 {
 	struct doca_comch_server *server = doca_comch_server_get_server_ctx(comch_connection);
 	union doca_data ctx_user_data = {0};
+	union doca_data conn_user_data = {0};
+	struct comch_connection_slot *slot;
 	struct comch_cfg *comch_cfg;
 	doca_error_t result;
 
@@ -129,7 +247,7 @@ static void server_connection_cb(struct doca_comch_event_connection_status_chang
 		return;
 	}
 
-	if (comch_cfg->active_connection != NULL) {
+	if (!comch_cfg->is_multi && comch_cfg->active_connection != NULL) {
 		DOCA_LOG_ERR("A connection already exists on the server - rejecting new attempt");
 		result = doca_comch_server_disconnect(server, comch_connection);
 		if (result != DOCA_SUCCESS)
@@ -137,15 +255,30 @@ static void server_connection_cb(struct doca_comch_event_connection_status_chang
 		return;
 	}
 
-	result = doca_comch_connection_set_user_data(comch_connection, ctx_user_data);
+	slot = comch_slot_bind(comch_cfg, comch_connection);
+	if (slot == NULL) {
+		DOCA_LOG_ERR("Server already has %u connections - rejecting new attempt", comch_cfg->max_connections);
+		result = doca_comch_server_disconnect(server, comch_connection);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to properly reject connection");
+		return;
+	}
+
+	conn_user_data.ptr = slot;
+	result = doca_comch_connection_set_user_data(comch_connection, conn_user_data);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to set user data on connection: %s", doca_error_get_descr(result));
+		comch_slot_release(slot);
 		return;
 	}
 
-	comch_cfg->active_connection = comch_connection;
+	if (!comch_cfg->is_multi)
+		comch_cfg->active_connection = comch_connection;
+
+	if (comch_cfg->connect_cb != NULL)
+		comch_cfg->connect_cb(comch_connection, comch_cfg->app_user_data);
 
-	DOCA_LOG_TRC("Server received a new connection");
+	DOCA_LOG_TRC("Server received a new connection, %u connected", comch_cfg->num_connections);
 }
 
 /*
@@ -161,6 +294,7 @@ static void server_disconnection_cb(struct doca_comch_event_connection_status_ch
 {
 	struct doca_comch_server *server = doca_comch_server_get_server_ctx(comch_connection);
 	union doca_data ctx_user_data = {0};
+	struct comch_connection_slot *slot;
 	struct comch_cfg *comch_cfg;
 	doca_error_t result;
 
@@ -179,21 +313,32 @@ static void server_disconnection_cb(struct doca_comch_event_connection_status_ch
 		return;
 	}
 
-	comch_cfg->active_connection = NULL;
+	/* Rejected connections were never bound to a slot */
+	slot = (struct comch_connection_slot *)doca_comch_connection_get_user_data(comch_connection).ptr;
+	if (slot == NULL || slot->connection != comch_connection)
+		return;
+
+	if (comch_cfg->disconnect_cb != NULL)
+		comch_cfg->disconnect_cb(comch_connection, comch_cfg->app_user_data);
+
+	comch_slot_release(slot);
 
-	DOCA_LOG_TRC("Server received a client disconnection");
+	if (comch_cfg->active_connection == comch_connection)
+		comch_cfg->active_connection = NULL;
+
+	DOCA_LOG_TRC("Server received a client disconnection, %u connected", comch_cfg->num_connections);
 }
 
 /*
- * Extract the comch_cfg data from a connection
+ * Extract the connection slot from a connection
  *
- * @connection [in]: connection to extract comch_cfg from
- * @return: pointer to the comch_cfg object
+ * @connection [in]: connection to extract the slot from
+ * @return: pointer to the slot
  */
-static inline struct comch_cfg *get_comch_cfg_from_connection(struct doca_comch_connection *connection)
+static inline struct comch_connection_slot *get_slot_from_connection(struct doca_comch_connection *connection)
 {
 	union doca_data connection_user_data;
-	struct comch_cfg *comch_cfg;
+	struct comch_connection_slot *slot;
 
 	if (connection == NULL) {
 		DOCA_LOG_ERR("Connection is NULL");
@@ -201,23 +346,73 @@ static inline struct comch_cfg *get_comch_cfg_from_connection(struct doca_comch_
 	}
 
 	connection_user_data = doca_comch_connection_get_user_data(connection);
-	comch_cfg = connection_user_data.ptr;
+	slot = connection_user_data.ptr;
 
-	if (comch_cfg == NULL)
+	if (slot == NULL || slot->comch_cfg == NULL) {
 		DOCA_LOG_ERR("Failed to get user data from connection");
+		return NULL;
+	}
+
+	return slot;
+}
+
+/*
+ * Extract the comch_cfg data from a connection
+ *
+ * @connection [in]: connection to extract comch_cfg from
+ * @return: pointer to the comch_cfg object
+ */
+static inline struct comch_cfg *get_comch_cfg_from_connection(struct doca_comch_connection *connection)
+{
+	struct comch_connection_slot *slot = get_slot_from_connection(connection);
+
+	if (slot == NULL)
+		return NULL;
+
+	return slot->comch_cfg;
+}
+
+/*
+ * Callback for new messages on the server, accounts the message to its connection and passes it to the app
+ *
+ * @event [in]: receive event
+ * @recv_buffer [in]: received message
+ * @msg_len [in]: length of the message
+ * @comch_connection [in]: connection the message was received on
+ */
+static void server_recv_dispatch_cb(struct doca_comch_event_msg_recv *event,
+				    uint8_t *recv_buffer,
+				    uint32_t msg_len,
+				    struct doca_comch_connection *comch_connection)
+{
+	struct comch_connection_slot *slot = get_slot_from_connection(comch_connection);
+
+	if (slot == NULL)
+		return;
+
+	slot->rx_msgs++;
+	slot->rx_bytes += msg_len;
 
-	return comch_cfg;
+	slot->comch_cfg->app_recv_cb(event, recv_buffer, msg_len, comch_connection);
 }
 
 doca_error_t comch_utils_send(struct doca_comch_connection *connection, const void *msg, uint32_t len)
 {
-	struct comch_cfg *comch_cfg = get_comch_cfg_from_connection(connection);
+	struct comch_connection_slot *slot = get_slot_from_connection(connection);
+	struct comch_cfg *comch_cfg;
 	struct doca_comch_task_send *task;
+	union doca_data task_user_data = {0};
 	doca_error_t result;
 
-	if (comch_cfg == NULL)
+	if (slot == NULL)
 		return DOCA_ERROR_NOT_FOUND;
 
+	comch_cfg = slot->comch_cfg;
+
+	/* The connection used up its share of the task pool, progress to free some before retrying */
+	if (slot->inflight_sends >= slot->max_inflight_sends)
+		return DOCA_ERROR_AGAIN;
+
 	if (len > comch_cfg->max_buf_size) {
 		DOCA_LOG_ERR("Message length of %u larger than max comch length of %u", len, comch_cfg->max_buf_size);
 		return DOCA_ERROR_INVALID_VALUE;
@@ -241,6 +436,9 @@ doca_error_t comch_utils_send(struct doca_comch_connection *connection, const vo
 		return result;
 	}
 
+	task_user_data.ptr = slot;
+	doca_task_set_user_data(doca_comch_task_send_as_task(task), task_user_data);
+
 	result = doca_task_submit(doca_comch_task_send_as_task(task));
 	if (result != DOCA_SUCCESS) {
 		doca_task_free(doca_comch_task_send_as_task(task));
@@ -248,6 +446,9 @@ doca_error_t comch_utils_send(struct doca_comch_connection *connection, const vo
 		return result;
 	}
 
+	slot->inflight_sends++;
+	slot->tx_bytes += len;
+
 	return DOCA_SUCCESS;
 }
 
@@ -261,6 +462,24 @@ void *comch_utils_get_user_data(struct doca_comch_connection *connection)
 	return comch_cfg->app_user_data;
 }
 
+void comch_utils_set_connection_user_data(struct doca_comch_connection *connection, void *conn_user_data)
+{
+	struct comch_connection_slot *slot = get_slot_from_connection(connection);
+
+	if (slot != NULL)
+		slot->conn_user_data = conn_user_data;
+}
+
+void *comch_utils_get_connection_user_data(struct doca_comch_connection *connection)
+{
+	struct comch_connection_slot *slot = get_slot_from_connection(connection);
+
+	if (slot == NULL)
+		return NULL;
+
+	return slot->conn_user_data;
+}
+
 doca_error_t comch_utils_progress_connection(struct doca_comch_connection *connection)
 {
 	struct comch_cfg *comch_cfg = get_comch_cfg_from_connection(connection);
@@ -293,18 +512,85 @@ uint32_t comch_utils_get_max_buffer_size(struct comch_cfg *comch_cfg)
 	return comch_cfg->max_buf_size;
 }
 
-doca_error_t comch_utils_fast_path_init(const char *server_name,
-					const char *pci_addr,
-					const char *rep_pci_addr,
-					void *user_data,
-					doca_comch_event_msg_recv_cb_t client_recv_event_cb,
-					doca_comch_event_msg_recv_cb_t server_recv_event_cb,
-					doca_comch_event_consumer_cb_t new_consumer_event_cb,
-					doca_comch_event_consumer_cb_t expired_consumer_event_cb,
-					struct comch_cfg **comch_cfg)
+uint32_t comch_utils_get_num_connections(struct comch_cfg *comch_cfg)
+{
+	if (comch_cfg == NULL) {
+		DOCA_LOG_ERR("Configuration object is NULL");
+		return 0;
+	}
+
+	return comch_cfg->num_connections;
+}
+
+doca_error_t comch_utils_progress_server(struct comch_cfg *comch_cfg, comch_utils_connection_poll_cb_t poll_cb)
+{
+	struct comch_connection_slot *slot;
+	uint32_t i, idx, budget = COMCH_PROGRESS_BUDGET;
+	doca_error_t result;
+
+	if (comch_cfg == NULL) {
+		DOCA_LOG_ERR("Configuration object is NULL");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	/* Bound the events handled per call so that app work on every connection runs at a steady rate */
+	while (budget-- > 0 && doca_pe_progress(comch_cfg->pe) != 0)
+		;
+
+	if (poll_cb == NULL || comch_cfg->num_connections == 0)
+		return DOCA_SUCCESS;
+
+	/* Rotate the first connection polled so none is always served last */
+	idx = comch_cfg->next_poll;
+	comch_cfg->next_poll = (comch_cfg->next_poll + 1) % comch_cfg->max_connections;
+
+	for (i = 0; i < comch_cfg->max_connections; i++, idx = (idx + 1) % comch_cfg->max_connections) {
+		slot = &comch_cfg->slots[idx];
+		if (slot->connection == NULL)
+			continue;
+
+		result = poll_cb(slot->connection);
+		if (result != DOCA_SUCCESS)
+			return result;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Set up a comch client or server
+ *
+ * @server_name [in]: name for server to use or client to connect to
+ * @pci_addr [in]: PCI address of device to use
+ * @rep_pci_addr [in]: Repr address to use (server/DPU side only)
+ * @user_data [in]: app user data that can be returned from a connection event
+ * @client_recv_event_cb [in]: callback for new messages on client (client side only)
+ * @server_recv_event_cb [in]: callback for new messages on server (server side only)
+ * @new_consumer_event_cb [in]: callback for new consumers created across the connection
+ * @expired_consumer_event_cb [in]: callback for expired consumers on the connection
+ * @max_connections [in]: number of clients the server accepts, 0 for the single connection mode
+ * @connect_cb [in]: callback for a new connection on a multi-connection server, can be NULL
+ * @disconnect_cb [in]: callback for a closed connection on a multi-connection server, can be NULL
+ * @comch_cfg [out]: comch utils configuration object
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t comch_utils_create(const char *server_name,
+				       const char *pci_addr,
+				       const char *rep_pci_addr,
+				       void *user_data,
+				       doca_comch_event_msg_recv_cb_t client_recv_event_cb,
+				       doca_comch_event_msg_recv_cb_t server_recv_event_cb,
+				       doca_comch_event_consumer_cb_t new_consumer_event_cb,
+				       doca_comch_event_consumer_cb_t expired_consumer_event_cb,
+				       uint32_t max_connections,
+				       comch_utils_connection_event_cb_t connect_cb,
+				       comch_utils_connection_event_cb_t disconnect_cb,
+				       struct comch_cfg **comch_cfg)
 {
 	enum doca_ctx_states state;
 	union doca_data comch_user_data = {0};
+	union doca_data conn_user_data = {0};
+	struct comch_connection_slot *slot;
 	struct timespec ts = {
 		.tv_nsec = SLEEP_IN_NANOS,
 	};
@@ -343,6 +629,11 @@ doca_error_t comch_utils_fast_path_init(const char *server_name,
 	}
 #endif
 
+	if (max_connections > COMCH_NUM_TASKS) {
+		DOCA_LOG_ERR("Init: at most %u connections are supported", COMCH_NUM_TASKS);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
 	cfg = (struct comch_cfg *)calloc(1, sizeof(struct comch_cfg));
 	if (cfg == NULL) {
 		DOCA_LOG_ERR("Failed to comch configuration data");
@@ -356,6 +647,19 @@ doca_error_t comch_utils_fast_path_init(const char *server_name,
 	cfg->app_user_data = user_data;
 	comch_user_data.ptr = cfg;
 
+	cfg->is_multi = (max_connections != 0);
+	cfg->max_connections = cfg->is_multi ? max_connections : 1;
+	cfg->app_recv_cb = server_recv_event_cb;
+	cfg->connect_cb = connect_cb;
+	cfg->disconnect_cb = disconnect_cb;
+
+	cfg->slots = (struct comch_connection_slot *)calloc(cfg->max_connections, sizeof(*cfg->slots));
+	if (cfg->slots == NULL) {
+		DOCA_LOG_ERR("Failed to allocate %u comch connection slots", cfg->max_connections);
+		result = DOCA_ERROR_NO_MEMORY;
+		goto destroy_comch_cfg;
+	}
+
 	result = doca_pe_create(&cfg->pe);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to create comch progress engine: %s", doca_error_get_descr(result));
@@ -422,7 +726,7 @@ doca_error_t comch_utils_fast_path_init(const char *server_name,
 			goto destroy_comch_ep;
 		}
 
-		result = doca_comch_server_event_msg_recv_register(cfg->server, server_recv_event_cb);
+		result = doca_comch_server_event_msg_recv_register(cfg->server, server_recv_dispatch_cb);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to register comch server receive event callback: %s",
 				     doca_error_get_descr(result));
@@ -461,6 +765,14 @@ doca_error_t comch_utils_fast_path_init(const char *server_name,
 			goto destroy_comch_ep;
 		}
 
+		clock_gettime(CLOCK_MONOTONIC, &cfg->start_time);
+
+		/* Clients of a multi-connection server come and go while the app progresses the server */
+		if (cfg->is_multi) {
+			DOCA_LOG_INFO("Server accepting up to %u clients", cfg->max_connections);
+			goto out;
+		}
+
 		DOCA_LOG_INFO("Server waiting on a client to connect");
 
 		/* Connection will be populated when a single client connects */
@@ -545,9 +857,12 @@ doca_error_t comch_utils_fast_path_init(const char *server_name,
 		}
 
 		(void)doca_comch_client_get_connection(cfg->client, &cfg->active_connection);
-		doca_comch_connection_set_user_data(cfg->active_connection, comch_user_data);
+		slot = comch_slot_bind(cfg, cfg->active_connection);
+		conn_user_data.ptr = slot;
+		doca_comch_connection_set_user_data(cfg->active_connection, conn_user_data);
 	}
 
+out:
 	*comch_cfg = cfg;
 
 	return DOCA_SUCCESS;
@@ -565,11 +880,80 @@ close_device:
 destroy_pe:
 	doca_pe_destroy(cfg->pe);
 destroy_comch_cfg:
+	free(cfg->slots);
 	free(cfg);
 
 	return result;
 }
 
+doca_error_t comch_utils_fast_path_init(const char *server_name,
+					const char *pci_addr,
+					const char *rep_pci_addr,
+					void *user_data,
+					doca_comch_event_msg_recv_cb_t client_recv_event_cb,
+					doca_comch_event_msg_recv_cb_t server_recv_event_cb,
+					doca_comch_event_consumer_cb_t new_consumer_event_cb,
+					doca_comch_event_consumer_cb_t expired_consumer_event_cb,
+					struct comch_cfg **comch_cfg)
+{
+	return comch_utils_create(server_name,
+				  pci_addr,
+				  rep_pci_addr,
+				  user_data,
+				  client_recv_event_cb,
+				  server_recv_event_cb,
+				  new_consumer_event_cb,
+				  expired_consumer_event_cb,
+				  0,
+				  NULL,
+				  NULL,
+				  comch_cfg);
+}
+
+doca_error_t comch_utils_multi_server_init(const char *server_name,
+					   const char *pci_addr,
+					   const char *rep_pci_addr,
+					   void *user_data,
+					   uint32_t max_connections,
+					   doca_comch_event_msg_recv_cb_t server_recv_event_cb,
+					   comch_utils_connection_event_cb_t connect_cb,
+					   comch_utils_connection_event_cb_t disconnect_cb,
+					   struct comch_cfg **comch_cfg)
+{
+#ifndef DOCA_ARCH_DPU
+	(void)server_name;
+	(void)pci_addr;
+	(void)rep_pci_addr;
+	(void)user_data;
+	(void)max_connections;
+	(void)server_recv_event_cb;
+	(void)connect_cb;
+	(void)disconnect_cb;
+	(void)comch_cfg;
+
+	DOCA_LOG_ERR("Init: multi-connection mode is only available on the server (DPU) side");
+	return DOCA_ERROR_NOT_SUPPORTED;
+#else
+	if (max_connections == 0) {
+		DOCA_LOG_ERR("Init: multi-connection server must accept at least one client");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	return comch_utils_create(server_name,
+				  pci_addr,
+				  rep_pci_addr,
+				  user_data,
+				  NULL,
+				  server_recv_event_cb,
+				  NULL,
+				  NULL,
+				  max_connections,
+				  connect_cb,
+				  disconnect_cb,
+				  comch_cfg);
+#endif
+}
+
 doca_error_t comch_utils_init(const char *server_name,
 			      const char *pci_addr,
 			      const char *rep_pci_addr,
@@ -589,6 +973,30 @@ doca_error_t comch_utils_init(const char *server_name,
 					  comch_cfg);
 }
 
+/*
+ * Log the aggregate traffic a multi-connection server handled over its lifetime
+ *
+ * @comch_cfg [in]: comch utils configuration object
+ */
+static void comch_log_server_totals(struct comch_cfg *comch_cfg)
+{
+	struct timespec now;
+	double secs;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	secs = comch_elapsed_secs(&comch_cfg->start_time, &now);
+	if (secs <= 0)
+		secs = 1e-9;
+
+	DOCA_LOG_INFO("Served %lu connections in %.3f s: received %lu bytes (%.2f MB/s), sent %lu bytes (%.2f MB/s)",
+		      comch_cfg->total_connections,
+		      secs,
+		      comch_cfg->total_rx_bytes,
+		      comch_cfg->total_rx_bytes / secs / 1e6,
+		      comch_cfg->total_tx_bytes,
+		      comch_cfg->total_tx_bytes / secs / 1e6);
+}
+
 doca_error_t comch_utils_destroy(struct comch_cfg *comch_cfg)
 {
 	enum doca_ctx_states state;
@@ -598,11 +1006,14 @@ doca_error_t comch_utils_destroy(struct comch_cfg *comch_cfg)
 	doca_error_t result;
 
 	if (comch_cfg->is_server) {
-		/* Wait until the client has closed the connection to end gracefully */
-		while (comch_cfg->active_connection != NULL) {
+		/* Wait until the clients have closed their connections to end gracefully */
+		while (comch_cfg->num_connections != 0) {
 			(void)doca_pe_progress(comch_cfg->pe);
 			nanosleep(&ts, &ts);
 		}
+
+		if (comch_cfg->is_multi)
+			comch_log_server_totals(comch_cfg);
 	}
 
 	result = doca_ctx_stop(comch_cfg->ctx);
@@ -650,6 +1061,7 @@ doca_error_t comch_utils_destroy(struct comch_cfg *comch_cfg)
 		return result;
 	}
 
+	free(comch_cfg->slots);
 	free(comch_cfg);
 
 	return DOCA_SUCCESS;
@@ -35,6 +35,22 @@
 
 struct comch_cfg;
 
+/*
+ * Callback for a connection opened or closed on a multi-connection server
+ *
+ * @connection [in]: connection the event occurred on
+ * @user_data [in]: app user data passed to comch_utils_multi_server_init
+ */
+typedef void (*comch_utils_connection_event_cb_t)(struct doca_comch_connection *connection, void *user_data);
+
+/*
+ * Callback run for every connection on each call to comch_utils_progress_server
+ *
+ * @connection [in]: connection to do app work for
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+typedef doca_error_t (*comch_utils_connection_poll_cb_t)(struct doca_comch_connection *connection);
+
 /*
  * Set up a new comch channel for control messages
  *
@@ -90,10 +106,39 @@ doca_error_t comch_utils_fast_path_init(const char *server_name,
 					doca_comch_event_consumer_cb_t expired_consumer_event_cb,
 					struct comch_cfg **comch_cfg);
 
+/*
+ * Set up a comch server that serves several clients at once
+ *
+ * Unlike comch_utils_init() this returns as soon as the server is started; clients connect and disconnect while the
+ * app calls comch_utils_progress_server(). Each connection gets an equal share of the send task pool, so
+ * comch_utils_send() returns DOCA_ERROR_AGAIN on a connection that has used up its share even if other connections
+ * still have tasks available. Server (DPU) side only.
+ *
+ * @server_name [in]: name for server to use
+ * @pci_addr [in]: PCI address of device to use
+ * @rep_pci_addr [in]: Repr address to use
+ * @user_data [in]: app user data shared by all connections
+ * @max_connections [in]: maximum number of connected clients, further attempts are rejected
+ * @server_recv_event_cb [in]: callback for new messages on any connection
+ * @connect_cb [in]: callback for a new connection, can be NULL
+ * @disconnect_cb [in]: callback for a closed connection, can be NULL
+ * @comch_cfg [out]: comch utils configuration object
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t comch_utils_multi_server_init(const char *server_name,
+					   const char *pci_addr,
+					   const char *rep_pci_addr,
+					   void *user_data,
+					   uint32_t max_connections,
+					   doca_comch_event_msg_recv_cb_t server_recv_event_cb,
+					   comch_utils_connection_event_cb_t connect_cb,
+					   comch_utils_connection_event_cb_t disconnect_cb,
+					   struct comch_cfg **comch_cfg);
+
 /*
  * Tear down the comch created with init_comch
  *
- * The server side waits until the client has complete before exiting
+ * The server side waits until all clients have completed before exiting
  *
  * @comch_cfg [in]: pointer to comch utils configuration object to destroy
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
@@ -123,6 +168,22 @@ doca_error_t comch_utils_send(struct doca_comch_connection *connection, const vo
  */
 void *comch_utils_get_user_data(struct doca_comch_connection *connection);
 
+/*
+ * Attach app data to a single connection, typically from the connect callback of a multi-connection server
+ *
+ * @connection [in]: pointer to connection object
+ * @conn_user_data [in]: per-connection data, cleared when the connection closes
+ */
+void comch_utils_set_connection_user_data(struct doca_comch_connection *connection, void *conn_user_data);
+
+/*
+ * Return the app data attached to a connection with comch_utils_set_connection_user_data
+ *
+ * @connection [in]: pointer to connection object
+ * @return: pointer to the per-connection data, NULL if none was set
+ */
+void *comch_utils_get_connection_user_data(struct doca_comch_connection *connection);
+
 /*
  * Call progress on the client/server associated with a given connection
  *
@@ -131,10 +192,22 @@ void *comch_utils_get_user_data(struct doca_comch_connection *connection);
  */
 doca_error_t comch_utils_progress_connection(struct doca_comch_connection *connection);
 
+/*
+ * Progress a multi-connection server and run app work fairly across its connections
+ *
+ * Handles a bounded number of comch events, then calls poll_cb once for every connected client. The connection
+ * polled first rotates between calls so that no client is always served last.
+ *
+ * @comch_cfg [in]: pointer to comch utils configuration object
+ * @poll_cb [in]: per-connection app work, can be NULL to only progress comch
+ * @return: DOCA_SUCCESS on success and the first error returned by poll_cb otherwise
+ */
+doca_error_t comch_utils_progress_server(struct comch_cfg *comch_cfg, comch_utils_connection_poll_cb_t poll_cb);
+
 /*
  * Get the connection associated with a comch utils configuration object
  *
- * Comch utils only supports one connection per server
+ * Only valid for a single connection client or server, multi-connection servers return NULL
  *
  * @comch_cfg [in]: pointer to comch utils configuration object
  * @return: pointer to associated connection
@@ -151,4 +224,12 @@ struct doca_comch_connection *comch_util_get_connection(struct comch_cfg *comch_
  */
 uint32_t comch_utils_get_max_buffer_size(struct comch_cfg *comch_cfg);
 
+/*
+ * Get the number of clients currently connected to a server
+ *
+ * @comch_cfg [in]: pointer to comch utils configuration object
+ * @return: number of connected clients
+ */
+uint32_t comch_utils_get_num_connections(struct comch_cfg *comch_cfg);
+
 #endif /* COMCH_UTILS_H_ */
@@ -23,12 +23,15 @@
  *
  */
 
+#include <dirent.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <time.h>
 #include <netinet/in.h>
 #include <errno.h>
 #include <sys/epoll.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <doca_buf.h>
@@ -52,6 +55,11 @@
 
 DOCA_LOG_REGISTER(DMA_COPY_CORE);
 
+struct dma_batch_file {
+	char path[MAX_ARG_SIZE]; /* Path of the file on the host */
+	uint64_t size;		 /* File size in bytes */
+};
+
 /*
  * Get DOCA DMA maximum buffer size allowed
  *
@@ -124,6 +132,10 @@ static doca_error_t args_validation_callback(void *config)
 {
 	struct dma_copy_cfg *cfg = (struct dma_copy_cfg *)config;
 
+	/* In batch mode the path is a manifest or directory (host) or the output directory (DPU), checked on start */
+	if (cfg->batch)
+		return DOCA_SUCCESS;
+
 	if (access(cfg->file_path, F_OK | R_OK) == 0) {
 		cfg->is_file_found_locally = true;
 		return validate_file_size(cfg->file_path, &cfg->file_size);
@@ -204,23 +216,40 @@ static doca_error_t rep_pci_addr_callback(void *param, void *config)
 }
 
 /*
- * Save remote buffer information into a file
+ * ARGP Callback - Handle batch mode parameter
  *
- * @cfg [in]: Application configuration
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t batch_callback(void *param, void *config)
+{
+	struct dma_copy_cfg *cfg = (struct dma_copy_cfg *)config;
+
+	cfg->batch = *(bool *)param;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Write a buffer into a file
+ *
+ * @file_path [in]: File to create
  * @buffer [in]: Buffer to read information from
+ * @file_size [in]: Number of bytes to write
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t save_buffer_into_a_file(struct dma_copy_cfg *cfg, const char *buffer)
+static doca_error_t write_buffer_to_file(const char *file_path, const char *buffer, uint64_t file_size)
 {
 	FILE *fp;
 
-	fp = fopen(cfg->file_path, "w");
+	fp = fopen(file_path, "w");
 	if (fp == NULL) {
-		DOCA_LOG_ERR("Failed to create the DMA copy file");
+		DOCA_LOG_ERR("Failed to create the DMA copy file %s", file_path);
 		return DOCA_ERROR_IO_FAILED;
 	}
 
-	if (fwrite(buffer, 1, cfg->file_size, fp) != cfg->file_size) {
+	if (fwrite(buffer, 1, file_size, fp) != file_size) {
 		DOCA_LOG_ERR("Failed to write full content into the output file");
 		fclose(fp);
 		return DOCA_ERROR_IO_FAILED;
@@ -232,25 +261,38 @@ static doca_error_t save_buffer_into_a_file(struct dma_copy_cfg *cfg, const char
 }
 
 /*
- * Fill local buffer with file content
+ * Save remote buffer information into a file
  *
  * @cfg [in]: Application configuration
+ * @buffer [in]: Buffer to read information from
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t save_buffer_into_a_file(struct dma_copy_cfg *cfg, const char *buffer)
+{
+	return write_buffer_to_file(cfg->file_path, buffer, cfg->file_size);
+}
+
+/*
+ * Read a file into a buffer
+ *
+ * @file_path [in]: File to read
  * @buffer [out]: Buffer to save information into
+ * @file_size [in]: Number of bytes to read
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t fill_buffer_with_file_content(struct dma_copy_cfg *cfg, char *buffer)
+static doca_error_t read_file_into_buffer(const char *file_path, char *buffer, uint64_t file_size)
 {
 	FILE *fp;
 
-	fp = fopen(cfg->file_path, "r");
+	fp = fopen(file_path, "r");
 	if (fp == NULL) {
-		DOCA_LOG_ERR("Failed to open %s", cfg->file_path);
+		DOCA_LOG_ERR("Failed to open %s", file_path);
 		return DOCA_ERROR_IO_FAILED;
 	}
 
 	/* Read file content and store it in the local buffer which will be exported */
-	if (fread(buffer, 1, cfg->file_size, fp) != cfg->file_size) {
-		DOCA_LOG_ERR("Failed to read content from file: %s", cfg->file_path);
+	if (fread(buffer, 1, file_size, fp) != file_size) {
+		DOCA_LOG_ERR("Failed to read content from file: %s", file_path);
 		fclose(fp);
 		return DOCA_ERROR_IO_FAILED;
 	}
@@ -259,6 +301,235 @@ static doca_error_t fill_buffer_with_file_content(struct dma_copy_cfg *cfg, char
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Fill local buffer with file content
+ *
+ * @cfg [in]: Application configuration
+ * @buffer [out]: Buffer to save information into
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t fill_buffer_with_file_content(struct dma_copy_cfg *cfg, char *buffer)
+{
+	return read_file_into_buffer(cfg->file_path, buffer, cfg->file_size);
+}
+
+/*
+ * Append a regular file to the batch file list
+ *
+ * @path [in]: File path
+ * @files [in/out]: Batch file list, grown as needed
+ * @num_files [in/out]: Number of files in the list
+ * @capacity [in/out]: Number of entries allocated for the list
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t batch_add_file(const char *path,
+				   struct dma_batch_file **files,
+				   uint32_t *num_files,
+				   uint32_t *capacity)
+{
+	struct dma_batch_file *new_files;
+	struct stat st;
+
+	if (strnlen(path, MAX_ARG_SIZE) == MAX_ARG_SIZE) {
+		DOCA_LOG_ERR("Batch file path %s exceeded buffer size - MAX=%d", path, MAX_ARG_SIZE - 1);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+		DOCA_LOG_ERR("Batch entry %s is not a regular file", path);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	if (*num_files == *capacity) {
+		*capacity = *capacity == 0 ? 64 : *capacity * 2;
+		new_files = realloc(*files, *capacity * sizeof(**files));
+		if (new_files == NULL) {
+			DOCA_LOG_ERR("Failed to allocate memory for batch file list");
+			return DOCA_ERROR_NO_MEMORY;
+		}
+		*files = new_files;
+	}
+
+	strlcpy((*files)[*num_files].path, path, MAX_ARG_SIZE);
+	(*files)[*num_files].size = st.st_size;
+	(*num_files)++;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Get the name a batch file is written under on the DPU
+ *
+ * @file [in]: Batch file
+ * @return: File name without its directories
+ */
+static const char *batch_file_name(const struct dma_batch_file *file)
+{
+	const char *file_name = strrchr(file->path, '/');
+
+	return file_name == NULL ? file->path : file_name + 1;
+}
+
+/*
+ * Compare two file names, qsort() callback
+ *
+ * @a [in]: Pointer to the first file name
+ * @b [in]: Pointer to the second file name
+ * @return: strcmp() of the two names
+ */
+static int batch_file_name_cmp(const void *a, const void *b)
+{
+	return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/*
+ * Check that no two batch files share a name, the DPU writes every file into one output directory by name only
+ *
+ * @files [in]: Batch file list
+ * @num_files [in]: Number of files in the list
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t batch_check_unique_names(const struct dma_batch_file *files, uint32_t num_files)
+{
+	doca_error_t result = DOCA_SUCCESS;
+	const char **names;
+	uint32_t i;
+
+	names = malloc(num_files * sizeof(*names));
+	if (names == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for batch file names");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	for (i = 0; i < num_files; i++)
+		names[i] = batch_file_name(&files[i]);
+	qsort(names, num_files, sizeof(*names), batch_file_name_cmp);
+
+	for (i = 1; i < num_files; i++) {
+		if (strcmp(names[i - 1], names[i]) == 0) {
+			DOCA_LOG_ERR("Batch contains more than one file named %s", names[i]);
+			result = DOCA_ERROR_INVALID_VALUE;
+			break;
+		}
+	}
+
+	free(names);
+	return result;
+}
+
+/*
+ * Build the batch file list from a directory, taking its regular files, or from a manifest with one path per line.
+ * Empty manifest lines and lines starting with '#' are ignored, two entries with the same file name are rejected.
+ *
+ * @path [in]: Directory or manifest path
+ * @files [out]: Batch file list, to be freed by the caller
+ * @num_files [out]: Number of files in the list
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t batch_load_file_list(const char *path, struct dma_batch_file **files, uint32_t *num_files)
+{
+	char entry_path[MAX_ARG_SIZE * 2];
+	struct dirent *entry;
+	struct stat st;
+	uint32_t capacity = 0;
+	doca_error_t result = DOCA_SUCCESS;
+	DIR *dir;
+	FILE *fp;
+
+	*files = NULL;
+	*num_files = 0;
+
+	if (stat(path, &st) != 0) {
+		DOCA_LOG_ERR("Failed to find batch manifest or directory %s", path);
+		return DOCA_ERROR_NOT_FOUND;
+	}
+
+	if (S_ISDIR(st.st_mode)) {
+		dir = opendir(path);
+		if (dir == NULL) {
+			DOCA_LOG_ERR("Failed to open directory %s", path);
+			return DOCA_ERROR_IO_FAILED;
+		}
+
+		while ((entry = readdir(dir)) != NULL) {
+			if (entry->d_name[0] == '.')
+				continue;
+
+			snprintf(entry_path, sizeof(entry_path), "%s/%s", path, entry->d_name);
+			if (stat(entry_path, &st) != 0 || !S_ISREG(st.st_mode))
+				continue;
+
+			result = batch_add_file(entry_path, files, num_files, &capacity);
+			if (result != DOCA_SUCCESS)
+				break;
+		}
+		closedir(dir);
+	} else {
+		fp = fopen(path, "r");
+		if (fp == NULL) {
+			DOCA_LOG_ERR("Failed to open batch manifest %s", path);
+			return DOCA_ERROR_IO_FAILED;
+		}
+
+		while (fgets(entry_path, sizeof(entry_path), fp) != NULL) {
+			if (strchr(entry_path, '\n') == NULL && !feof(fp)) {
+				DOCA_LOG_ERR("Batch manifest line exceeded buffer size - MAX=%d", MAX_ARG_SIZE - 1);
+				result = DOCA_ERROR_INVALID_VALUE;
+				break;
+			}
+
+			entry_path[strcspn(entry_path, "\r\n")] = '\0';
+			if (entry_path[0] == '\0' || entry_path[0] == '#')
+				continue;
+
+			result = batch_add_file(entry_path, files, num_files, &capacity);
+			if (result != DOCA_SUCCESS)
+				break;
+		}
+		fclose(fp);
+	}
+
+	if (result == DOCA_SUCCESS && *num_files == 0) {
+		DOCA_LOG_ERR("No files to copy were found in %s", path);
+		result = DOCA_ERROR_NOT_FOUND;
+	}
+
+	if (result == DOCA_SUCCESS)
+		result = batch_check_unique_names(*files, *num_files);
+
+	if (result != DOCA_SUCCESS) {
+		free(*files);
+		*files = NULL;
+	}
+
+	return result;
+}
+
+/*
+ * Log the aggregate rate of a batch
+ *
+ * @num_files [in]: Number of files copied
+ * @total_bytes [in]: Number of bytes copied
+ * @start [in]: Time the batch session started
+ */
+static void batch_report_throughput(uint32_t num_files, uint64_t total_bytes, const struct timespec *start)
+{
+	struct timespec end;
+	double elapsed;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	elapsed = (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+	if (elapsed <= 0)
+		elapsed = 1e-9;
+
+	DOCA_LOG_INFO("Batch of %u files (%" PRIu64 " bytes) copied in %.3f seconds: %.1f files/s, %.3f GB/s",
+		      num_files,
+		      total_bytes,
+		      elapsed,
+		      num_files / elapsed,
+		      total_bytes / elapsed / 1e9);
+}
+
 /*
  * Allocate memory and populate it into the memory map
  *
@@ -420,7 +691,7 @@ static doca_error_t check_dev_dma_capable(struct doca_devinfo *devinfo)
 doca_error_t register_dma_copy_params(void)
 {
 	doca_error_t result;
-	struct doca_argp_param *file_path_param, *dev_pci_addr_param, *rep_pci_addr_param;
+	struct doca_argp_param *file_path_param, *dev_pci_addr_param, *rep_pci_addr_param, *batch_param;
 
 	/* Create and register string to dma copy param */
 	result = doca_argp_param_create(&file_path_param);
@@ -477,6 +748,25 @@ doca_error_t register_dma_copy_params(void)
 		return result;
 	}
 
+	/* Create and register batch mode flag */
+	result = doca_argp_param_create(&batch_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(batch_param, "b");
+	doca_argp_param_set_long_name(batch_param, "batch");
+	doca_argp_param_set_description(batch_param,
+					"Copy many files from Host to DPU over one session, the file is a manifest or "
+					"directory on the Host and the output directory on the DPU");
+	doca_argp_param_set_callback(batch_param, batch_callback);
+	doca_argp_param_set_type(batch_param, DOCA_ARGP_TYPE_BOOLEAN);
+	result = doca_argp_register_param(batch_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	/* Register validation callback */
 	result = doca_argp_register_validation_callback(args_validation_callback);
 	if (result != DOCA_SUCCESS) {
@@ -581,14 +871,15 @@ static doca_error_t destroy_dma_copy_resources(struct dma_copy_resources *resour
  * Allocate DMA copy resources
  *
  * @resources [out]: DOCA DMA copy resources
+ * @num_tasks [in]: Number of DMA tasks that may be in flight at once
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t allocate_dma_copy_resources(struct dma_copy_resources *resources)
+static doca_error_t allocate_dma_copy_resources(struct dma_copy_resources *resources, uint32_t num_tasks)
 {
 	struct program_core_objects *state = NULL;
 	doca_error_t result, tmp_result;
-	/* Two buffers for source and destination */
-	uint32_t max_bufs = 2;
+	/* Two buffers for source and destination of each task */
+	uint32_t max_bufs = 2 * num_tasks;
 
 	resources->state = malloc(sizeof(*(resources->state)));
 	if (resources->state == NULL) {
@@ -628,7 +919,7 @@ static doca_error_t allocate_dma_copy_resources(struct dma_copy_resources *resou
 	result = doca_dma_task_memcpy_set_conf(resources->dma_ctx,
 					       dma_memcpy_completed_callback,
 					       dma_memcpy_error_callback,
-					       NUM_DMA_TASKS);
+					       num_tasks);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Unable to set configurations for DMA memcpy task: %s", doca_error_get_descr(result));
 		goto destroy_dma;
@@ -732,6 +1023,29 @@ static doca_error_t host_process_dma_direction_and_size(struct dma_copy_cfg *cfg
 	return comch_utils_send(comch_connection, exp_msg, exp_msg_len);
 }
 
+/*
+ * Process a batch slot release message on the host
+ *
+ * @cfg [in]: dma copy configuration information
+ * @done_msg [in]: the slot release message received
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t host_process_batch_slot_done(struct dma_copy_cfg *cfg,
+						 struct comch_msg_dma_batch_slot_done *done_msg)
+{
+	uint32_t file_idx = ntohl(done_msg->file_idx);
+	struct dma_batch_slot *slot = &cfg->slots[file_idx % DMA_BATCH_NUM_SLOTS];
+
+	if (!cfg->batch || !slot->in_use || slot->file_idx != file_idx) {
+		DOCA_LOG_ERR("Unexpected release of batch file %u", file_idx);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	slot->in_use = false;
+
+	return DOCA_SUCCESS;
+}
+
 void host_recv_event_cb(struct doca_comch_event_msg_recv *event,
 			uint8_t *recv_buffer,
 			uint32_t msg_len,
@@ -805,6 +1119,40 @@ void host_recv_event_cb(struct doca_comch_event_msg_recv *event,
 		else
 			cfg->comch_state = COMCH_COMPLETE;
 
+		break;
+	case COMCH_MSG_BATCH_SLOT_DONE:
+		if (msg_len != sizeof(struct comch_msg_dma_batch_slot_done)) {
+			DOCA_LOG_ERR("Slot release message has bad length. Length: %u, expected: %lu",
+				     msg_len,
+				     sizeof(struct comch_msg_dma_batch_slot_done));
+			send_status_msg(comch_connection, STATUS_FAILURE);
+			cfg->comch_state = COMCH_ERROR;
+			return;
+		}
+
+		result = host_process_batch_slot_done(cfg, (struct comch_msg_dma_batch_slot_done *)recv_buffer);
+		if (result != DOCA_SUCCESS) {
+			send_status_msg(comch_connection, STATUS_FAILURE);
+			cfg->comch_state = COMCH_ERROR;
+			return;
+		}
+
+		break;
+	case COMCH_MSG_BATCH_END:
+		if (msg_len != sizeof(struct comch_msg_dma_batch_end)) {
+			DOCA_LOG_ERR("Batch end message has bad length. Length: %u, expected: %lu",
+				     msg_len,
+				     sizeof(struct comch_msg_dma_batch_end));
+			send_status_msg(comch_connection, STATUS_FAILURE);
+			cfg->comch_state = COMCH_ERROR;
+			return;
+		}
+
+		/* A session ending without a success status has failed on the DPU */
+		cfg->batch_ended = true;
+		if (cfg->comch_state == COMCH_NEGOTIATING)
+			cfg->comch_state = COMCH_ERROR;
+
 		break;
 	default:
 		DOCA_LOG_ERR("Received bad message type. Type: %u", comch_msg->type);
@@ -837,24 +1185,85 @@ static doca_error_t send_file_direction_request(struct dma_copy_cfg *dma_cfg, st
 	return comch_utils_send(comch_util_get_connection(comch_cfg), &dir_msg, sizeof(struct comch_msg_dma_direction));
 }
 
-doca_error_t host_start_dma_copy(struct dma_copy_cfg *dma_cfg, struct comch_cfg *comch_cfg)
+/*
+ * Announce a file staged in its batch slot to the DPU
+ *
+ * @dma_cfg [in]: dma copy configuration information
+ * @comch_cfg [in]: comch object to send message across
+ * @file_idx [in]: Index of the file in the batch
+ * @file [in]: File staged in the slot
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t send_batch_file_msg(struct dma_copy_cfg *dma_cfg,
+					struct comch_cfg *comch_cfg,
+					uint32_t file_idx,
+					const struct dma_batch_file *file)
+{
+	char file_msg_buf[dma_cfg->max_comch_buffer];
+	struct comch_msg_dma_batch_file *file_msg = (struct comch_msg_dma_batch_file *)file_msg_buf;
+	const char *file_name = batch_file_name(file);
+	size_t name_len;
+
+	/* The DPU gets the file name only, it writes the file into its output directory */
+	name_len = strlen(file_name) + 1;
+	if (sizeof(*file_msg) + name_len > dma_cfg->max_comch_buffer) {
+		DOCA_LOG_ERR("File name %s exceeds max length of comch", file_name);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	file_msg->type = COMCH_MSG_BATCH_FILE;
+	file_msg->file_idx = htonl(file_idx);
+	file_msg->file_size = htonq(file->size);
+	memcpy(file_msg->file_name, file_name, name_len);
+
+	return comch_utils_send(comch_util_get_connection(comch_cfg), file_msg, sizeof(*file_msg) + name_len);
+}
+
+/*
+ * Start a batch DMA session on the Host - the staging buffer is exported once and each file is read into a free slot
+ * while the DPU copies and writes the files of the other slots
+ *
+ * @dma_cfg [in]: App configuration structure
+ * @comch_cfg [in]: Doca comch initialized objects
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t host_start_dma_batch(struct dma_copy_cfg *dma_cfg, struct comch_cfg *comch_cfg)
 {
+	char start_msg_buf[dma_cfg->max_comch_buffer];
+	struct comch_msg_dma_batch_start *start_msg = (struct comch_msg_dma_batch_start *)start_msg_buf;
+	struct dma_batch_file *files = NULL;
+	struct dma_batch_slot *slot;
+	const void *export_desc;
+	size_t export_desc_len, start_msg_len;
+	uint64_t total_bytes = 0;
+	struct timespec start_ts;
+	uint32_t i;
 	doca_error_t result, tmp_result;
 	struct timespec ts = {
 		.tv_nsec = SLEEP_IN_NANOS,
 	};
 
-	dma_cfg->max_comch_buffer = comch_utils_get_max_buffer_size(comch_cfg);
-	if (dma_cfg->max_comch_buffer == 0) {
-		DOCA_LOG_ERR("Comch max buffer length is 0");
-		return DOCA_ERROR_INVALID_VALUE;
+	result = batch_load_file_list(dma_cfg->file_path, &files, &dma_cfg->num_files);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	/* Every slot fits the largest file */
+	dma_cfg->slot_size = 1;
+	for (i = 0; i < dma_cfg->num_files; i++) {
+		dma_cfg->slot_size = MAX(dma_cfg->slot_size, files[i].size);
+		total_bytes += files[i].size;
 	}
+	DOCA_LOG_INFO("Copying a batch of %u files to the DPU through %d slots of %" PRIu64 " bytes",
+		      dma_cfg->num_files,
+		      DMA_BATCH_NUM_SLOTS,
+		      dma_cfg->slot_size);
+
+	clock_gettime(CLOCK_MONOTONIC, &start_ts);
 
-	/* Open DOCA dma device */
 	result = open_dma_device(&dma_cfg->dev);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to open DOCA DMA device: %s", doca_error_get_descr(result));
-		return result;
+		goto free_files;
 	}
 
 	result = doca_mmap_create(&dma_cfg->file_mmap);
@@ -869,54 +1278,206 @@ doca_error_t host_start_dma_copy(struct dma_copy_cfg *dma_cfg, struct comch_cfg
 		goto destroy_mmap;
 	}
 
-	/*
-	 * If the file is local, allocate a DMA buffer and populate it now.
-	 * If file is remote, the buffer can be allocated in the callback when the size if known.
-	 */
-	if (dma_cfg->is_file_found_locally == true) {
-		result = memory_alloc_and_populate(dma_cfg->file_mmap,
-						   dma_cfg->file_size,
-						   DOCA_ACCESS_FLAG_PCI_READ_ONLY,
-						   &dma_cfg->file_buffer);
-		if (result != DOCA_SUCCESS)
-			goto destroy_mmap;
+	result = memory_alloc_and_populate(dma_cfg->file_mmap,
+					   DMA_BATCH_NUM_SLOTS * dma_cfg->slot_size,
+					   DOCA_ACCESS_FLAG_PCI_READ_ONLY,
+					   &dma_cfg->file_buffer);
+	if (result != DOCA_SUCCESS)
+		goto destroy_mmap;
 
-		result = fill_buffer_with_file_content(dma_cfg, dma_cfg->file_buffer);
-		if (result != DOCA_SUCCESS)
-			goto free_buffer;
+	result = doca_mmap_export_pci(dma_cfg->file_mmap, dma_cfg->dev, &export_desc, &export_desc_len);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to export DOCA mmap: %s", doca_error_get_descr(result));
+		goto free_buffer;
 	}
 
+	start_msg_len = export_desc_len + sizeof(struct comch_msg_dma_batch_start);
+	if (start_msg_len > dma_cfg->max_comch_buffer) {
+		DOCA_LOG_ERR("Batch start message exceeds max length of comch. Message len: %lu, Max len: %u",
+			     start_msg_len,
+			     dma_cfg->max_comch_buffer);
+		result = DOCA_ERROR_INVALID_VALUE;
+		goto free_buffer;
+	}
+
+	start_msg->type = COMCH_MSG_BATCH_START;
+	start_msg->num_files = htonl(dma_cfg->num_files);
+	start_msg->slot_size = htonq(dma_cfg->slot_size);
+	start_msg->host_addr = htonq((uintptr_t)dma_cfg->file_buffer);
+	start_msg->export_desc_len = htonq(export_desc_len);
+	memcpy(start_msg->exported_mmap, export_desc, export_desc_len);
+
 	dma_cfg->comch_state = COMCH_NEGOTIATING;
-	result = send_file_direction_request(dma_cfg, comch_cfg);
+	result = comch_utils_send(comch_util_get_connection(comch_cfg), start_msg, start_msg_len);
 	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to send direction negotiation message: %s", doca_error_get_descr(result));
+		DOCA_LOG_ERR("Failed to send batch start message: %s", doca_error_get_descr(result));
 		goto free_buffer;
 	}
 
-	/* Wait for a signal that the DPU has completed the DMA copy */
+	/* File i is staged in slot i % slots as soon as the DPU released the file previously held there */
+	for (i = 0; i < dma_cfg->num_files; i++) {
+		slot = &dma_cfg->slots[i % DMA_BATCH_NUM_SLOTS];
+		while (slot->in_use && dma_cfg->comch_state == COMCH_NEGOTIATING) {
+			nanosleep(&ts, &ts);
+			result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+			if (result != DOCA_SUCCESS) {
+				DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+				goto end_session;
+			}
+		}
+
+		if (dma_cfg->comch_state != COMCH_NEGOTIATING)
+			break;
+
+		result = read_file_into_buffer(files[i].path,
+					       dma_cfg->file_buffer + (i % DMA_BATCH_NUM_SLOTS) * dma_cfg->slot_size,
+					       files[i].size);
+		if (result != DOCA_SUCCESS)
+			goto end_session;
+
+		slot->in_use = true;
+		slot->file_idx = i;
+		slot->file_size = files[i].size;
+		result = send_batch_file_msg(dma_cfg, comch_cfg, i, &files[i]);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to send batch file message: %s", doca_error_get_descr(result));
+			goto end_session;
+		}
+	}
+
+	/* Wait for a signal that the DPU has written all files */
 	while (dma_cfg->comch_state == COMCH_NEGOTIATING) {
 		nanosleep(&ts, &ts);
 		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
-			goto free_buffer;
+			goto end_session;
 		}
 	}
 
-	if (dma_cfg->comch_state == COMCH_ERROR) {
-		DOCA_LOG_ERR("Failure was detected in dma copy");
+	if (dma_cfg->comch_state == COMCH_ERROR || i != dma_cfg->num_files) {
+		DOCA_LOG_ERR("Failure was detected in batch dma copy");
 		result = DOCA_ERROR_BAD_STATE;
-		goto free_buffer;
+		goto end_session;
 	}
 
-	DOCA_LOG_INFO("Final status message was successfully received");
+	batch_report_throughput(dma_cfg->num_files, total_bytes, &start_ts);
 
-	if (!dma_cfg->is_file_found_locally) {
-		/*  File was copied successfully into the buffer, save it into file */
-		DOCA_LOG_INFO("Writing DMA buffer into a file on %s", dma_cfg->file_path);
-		result = save_buffer_into_a_file(dma_cfg, dma_cfg->file_buffer);
+end_session:
+	/* The DPU may still read the staging buffer, it is only released once the DPU reports the session ended */
+	if (result != DOCA_SUCCESS && dma_cfg->comch_state == COMCH_NEGOTIATING)
+		send_status_msg(comch_util_get_connection(comch_cfg), STATUS_FAILURE);
+	while (!dma_cfg->batch_ended) {
+		nanosleep(&ts, &ts);
+		tmp_result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+		if (tmp_result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(tmp_result));
+			DOCA_ERROR_PROPAGATE(result, tmp_result);
+			break;
+		}
 	}
-
+free_buffer:
+	free(dma_cfg->file_buffer);
+destroy_mmap:
+	tmp_result = doca_mmap_destroy(dma_cfg->file_mmap);
+	if (tmp_result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to destroy DOCA mmap: %s", doca_error_get_descr(tmp_result));
+		DOCA_ERROR_PROPAGATE(result, tmp_result);
+	}
+close_device:
+	tmp_result = doca_dev_close(dma_cfg->dev);
+	if (tmp_result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to close DOCA device: %s", doca_error_get_descr(tmp_result));
+		DOCA_ERROR_PROPAGATE(result, tmp_result);
+	}
+free_files:
+	free(files);
+	return result;
+}
+
+doca_error_t host_start_dma_copy(struct dma_copy_cfg *dma_cfg, struct comch_cfg *comch_cfg)
+{
+	doca_error_t result, tmp_result;
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
+
+	dma_cfg->max_comch_buffer = comch_utils_get_max_buffer_size(comch_cfg);
+	if (dma_cfg->max_comch_buffer == 0) {
+		DOCA_LOG_ERR("Comch max buffer length is 0");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	if (dma_cfg->batch)
+		return host_start_dma_batch(dma_cfg, comch_cfg);
+
+	/* Open DOCA dma device */
+	result = open_dma_device(&dma_cfg->dev);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to open DOCA DMA device: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = doca_mmap_create(&dma_cfg->file_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to create mmap: %s", doca_error_get_descr(result));
+		goto close_device;
+	}
+
+	result = doca_mmap_add_dev(dma_cfg->file_mmap, dma_cfg->dev);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to add device to mmap: %s", doca_error_get_descr(result));
+		goto destroy_mmap;
+	}
+
+	/*
+	 * If the file is local, allocate a DMA buffer and populate it now.
+	 * If file is remote, the buffer can be allocated in the callback when the size if known.
+	 */
+	if (dma_cfg->is_file_found_locally == true) {
+		result = memory_alloc_and_populate(dma_cfg->file_mmap,
+						   dma_cfg->file_size,
+						   DOCA_ACCESS_FLAG_PCI_READ_ONLY,
+						   &dma_cfg->file_buffer);
+		if (result != DOCA_SUCCESS)
+			goto destroy_mmap;
+
+		result = fill_buffer_with_file_content(dma_cfg, dma_cfg->file_buffer);
+		if (result != DOCA_SUCCESS)
+			goto free_buffer;
+	}
+
+	dma_cfg->comch_state = COMCH_NEGOTIATING;
+	result = send_file_direction_request(dma_cfg, comch_cfg);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to send direction negotiation message: %s", doca_error_get_descr(result));
+		goto free_buffer;
+	}
+
+	/* Wait for a signal that the DPU has completed the DMA copy */
+	while (dma_cfg->comch_state == COMCH_NEGOTIATING) {
+		nanosleep(&ts, &ts);
+		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+			goto free_buffer;
+		}
+	}
+
+	if (dma_cfg->comch_state == COMCH_ERROR) {
+		DOCA_LOG_ERR("Failure was detected in dma copy");
+		result = DOCA_ERROR_BAD_STATE;
+		goto free_buffer;
+	}
+
+	DOCA_LOG_INFO("Final status message was successfully received");
+
+	if (!dma_cfg->is_file_found_locally) {
+		/*  File was copied successfully into the buffer, save it into file */
+		DOCA_LOG_INFO("Writing DMA buffer into a file on %s", dma_cfg->file_path);
+		result = save_buffer_into_a_file(dma_cfg, dma_cfg->file_buffer);
+	}
+
 free_buffer:
 	free(dma_cfg->file_buffer);
 destroy_mmap:
@@ -949,6 +1510,11 @@ static doca_error_t dpu_process_dma_direction_and_size(struct dma_copy_cfg *cfg,
 	struct comch_msg_dma_direction resp_dir_msg = {.type = COMCH_MSG_DIRECTION};
 	doca_error_t result;
 
+	if (cfg->batch) {
+		DOCA_LOG_ERR("Error - DPU runs in batch mode but Host does not");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
 	/* Make sure file is located only on one side */
 	if (cfg->is_file_found_locally && dir_msg->file_in_host == true) {
 		DOCA_LOG_ERR("Error - File was found on both Host and DPU");
@@ -1015,6 +1581,100 @@ static doca_error_t dpu_process_export_descriptor(struct dma_copy_cfg *cfg,
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Process a batch start message on the DPU
+ *
+ * @cfg [in]: dma copy configuration information
+ * @start_msg [in]: the batch start message received
+ * @msg_len [in]: length of the message received
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dpu_process_batch_start(struct dma_copy_cfg *cfg,
+					    struct comch_msg_dma_batch_start *start_msg,
+					    uint32_t msg_len)
+{
+	size_t desc_len = ntohq(start_msg->export_desc_len);
+
+	if (!cfg->batch) {
+		DOCA_LOG_ERR("Error - Host runs in batch mode but DPU does not");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	if (msg_len != sizeof(*start_msg) + desc_len) {
+		DOCA_LOG_ERR("Batch start message has bad length. Length: %u, expected: %lu",
+			     msg_len,
+			     sizeof(*start_msg) + desc_len);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	cfg->num_files = ntohl(start_msg->num_files);
+	cfg->slot_size = ntohq(start_msg->slot_size);
+	if (cfg->num_files == 0 || cfg->slot_size == 0) {
+		DOCA_LOG_ERR("Batch start message has no files or empty slots");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	cfg->exported_mmap = malloc(desc_len);
+	if (cfg->exported_mmap == NULL) {
+		DOCA_LOG_ERR("Failed to allocate export descriptor memory");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	memcpy(cfg->exported_mmap, start_msg->exported_mmap, desc_len);
+	cfg->exported_mmap_len = desc_len;
+	cfg->host_addr = (uint8_t *)ntohq(start_msg->host_addr);
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Process a batch file message on the DPU, the file is copied once the local slot is free
+ *
+ * @cfg [in]: dma copy configuration information
+ * @file_msg [in]: the batch file message received
+ * @msg_len [in]: length of the message received
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dpu_process_batch_file(struct dma_copy_cfg *cfg,
+					   struct comch_msg_dma_batch_file *file_msg,
+					   uint32_t msg_len)
+{
+	uint32_t file_idx = ntohl(file_msg->file_idx);
+	size_t name_len = msg_len - sizeof(*file_msg);
+	const char *file_name = file_msg->file_name;
+	struct dma_batch_slot *slot;
+
+	if (cfg->num_files == 0 || file_idx >= cfg->num_files) {
+		DOCA_LOG_ERR("Unexpected batch file %u", file_idx);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	slot = &cfg->slots[file_idx % DMA_BATCH_NUM_SLOTS];
+	if (slot->in_use) {
+		DOCA_LOG_ERR("Batch file %u was sent to a slot still in use", file_idx);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	/* The name is written under the output directory, so it must not leave it */
+	if (name_len < 2 || name_len > MAX_ARG_SIZE || strnlen(file_name, name_len) != name_len - 1 ||
+	    strchr(file_name, '/') != NULL || strcmp(file_name, ".") == 0 || strcmp(file_name, "..") == 0) {
+		DOCA_LOG_ERR("Batch file %u has an invalid name", file_idx);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	slot->file_size = ntohq(file_msg->file_size);
+	if (slot->file_size > cfg->slot_size) {
+		DOCA_LOG_ERR("Batch file %u of %" PRIu64 " bytes exceeds the slot size", file_idx, slot->file_size);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	memcpy(slot->file_name, file_name, name_len);
+	slot->file_idx = file_idx;
+	slot->in_use = true;
+
+	return DOCA_SUCCESS;
+}
+
 void dpu_recv_event_cb(struct doca_comch_event_msg_recv *event,
 		       uint8_t *recv_buffer,
 		       uint32_t msg_len,
@@ -1104,6 +1764,43 @@ void dpu_recv_event_cb(struct doca_comch_event_msg_recv *event,
 		if (status->is_success == STATUS_FAILURE)
 			cfg->comch_state = COMCH_ERROR;
 
+		break;
+	case COMCH_MSG_BATCH_START:
+		if (msg_len <= sizeof(struct comch_msg_dma_batch_start)) {
+			DOCA_LOG_ERR("Batch start message has bad length. Length: %u, expected at least: %lu",
+				     msg_len,
+				     sizeof(struct comch_msg_dma_batch_start));
+			send_status_msg(comch_connection, STATUS_FAILURE);
+			cfg->comch_state = COMCH_ERROR;
+			return;
+		}
+
+		result = dpu_process_batch_start(cfg, (struct comch_msg_dma_batch_start *)recv_buffer, msg_len);
+		if (result != DOCA_SUCCESS) {
+			send_status_msg(comch_connection, STATUS_FAILURE);
+			cfg->comch_state = COMCH_ERROR;
+			return;
+		}
+
+		/* The staging buffer is known, files can be copied as they are announced */
+		cfg->comch_state = COMCH_COMPLETE;
+		break;
+	case COMCH_MSG_BATCH_FILE:
+		if (msg_len <= sizeof(struct comch_msg_dma_batch_file)) {
+			DOCA_LOG_ERR("Batch file message has bad length. Length: %u, expected at least: %lu",
+				     msg_len,
+				     sizeof(struct comch_msg_dma_batch_file));
+			send_status_msg(comch_connection, STATUS_FAILURE);
+			cfg->comch_state = COMCH_ERROR;
+			return;
+		}
+
+		result = dpu_process_batch_file(cfg, (struct comch_msg_dma_batch_file *)recv_buffer, msg_len);
+		if (result != DOCA_SUCCESS) {
+			send_status_msg(comch_connection, STATUS_FAILURE);
+			cfg->comch_state = COMCH_ERROR;
+			return;
+		}
 		break;
 	default:
 		DOCA_LOG_ERR("Received bad message type. Type: %u", comch_msg->type);
@@ -1113,6 +1810,355 @@ void dpu_recv_event_cb(struct doca_comch_event_msg_recv *event,
 	}
 }
 
+/*
+ * Submit the DMA copy of a batch slot from the host staging buffer to the local slot, without waiting for it
+ *
+ * @resources [in]: DMA copy resources
+ * @slot [in]: Slot holding the file to copy
+ * @num_remaining_tasks [in/out]: Number of tasks in flight
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dpu_submit_batch_dma_task(struct dma_copy_resources *resources,
+					      struct dma_batch_slot *slot,
+					      size_t *num_remaining_tasks)
+{
+	union doca_data task_user_data = {0};
+	void *data;
+	doca_error_t result;
+
+	/* Empty files have nothing to copy */
+	if (slot->file_size == 0) {
+		slot->task_result = DOCA_SUCCESS;
+		return DOCA_SUCCESS;
+	}
+
+	result = doca_buf_get_data(slot->remote_buf, &data);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to get data address from DOCA buffer: %s", doca_error_get_descr(result));
+		return result;
+	}
+	result = doca_buf_set_data(slot->remote_buf, data, slot->file_size);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to set data for DOCA buffer: %s", doca_error_get_descr(result));
+		return result;
+	}
+	result = doca_buf_reset_data_len(slot->local_buf);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to reset data length of DOCA buffer: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* The completion callbacks store the task result in the slot */
+	slot->task_result = DOCA_ERROR_IN_PROGRESS;
+	task_user_data.ptr = &slot->task_result;
+	result = doca_dma_task_memcpy_alloc_init(resources->dma_ctx,
+						 slot->remote_buf,
+						 slot->local_buf,
+						 task_user_data,
+						 &slot->task);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to allocate DMA memcpy task: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = doca_task_submit(doca_dma_task_memcpy_as_task(slot->task));
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to submit DMA task: %s", doca_error_get_descr(result));
+		doca_task_free(doca_dma_task_memcpy_as_task(slot->task));
+		slot->task = NULL;
+		return result;
+	}
+
+	(*num_remaining_tasks)++;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Complete a copied batch slot - release the host slot and write the local slot into the output directory
+ *
+ * @dma_cfg [in]: App configuration structure
+ * @comch_cfg [in]: Doca comch initialized objects
+ * @slot [in]: Slot whose DMA task completed
+ * @local_data [in]: Local slot buffer
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dpu_complete_batch_slot(struct dma_copy_cfg *dma_cfg,
+					    struct comch_cfg *comch_cfg,
+					    struct dma_batch_slot *slot,
+					    const char *local_data)
+{
+	struct comch_msg_dma_batch_slot_done done_msg = {.type = COMCH_MSG_BATCH_SLOT_DONE};
+	char file_path[MAX_ARG_SIZE * 2];
+	uint64_t file_size = slot->file_size;
+	doca_error_t result;
+
+	if (slot->task != NULL) {
+		doca_task_free(doca_dma_task_memcpy_as_task(slot->task));
+		slot->task = NULL;
+	}
+
+	if (slot->task_result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("DMA copy of batch file %u failed: %s",
+			     slot->file_idx,
+			     doca_error_get_descr(slot->task_result));
+		return slot->task_result;
+	}
+
+	snprintf(file_path, sizeof(file_path), "%s/%s", dma_cfg->file_path, slot->file_name);
+
+	/* Release the host slot before writing so the host stages the next file meanwhile */
+	done_msg.file_idx = htonl(slot->file_idx);
+	slot->in_use = false;
+	result = comch_utils_send(comch_util_get_connection(comch_cfg), &done_msg, sizeof(done_msg));
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to send slot release message: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	return write_buffer_to_file(file_path, local_data, file_size);
+}
+
+/*
+ * Start a batch DMA session on the DPU - the host staging buffer is imported once and up to a slot count of copies
+ * are kept in flight, each copied file is written into the output directory while the next copies run
+ *
+ * @dma_cfg [in]: App configuration structure
+ * @comch_cfg [in]: Doca comch initialized objects
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t dpu_start_dma_batch(struct dma_copy_cfg *dma_cfg, struct comch_cfg *comch_cfg)
+{
+	struct comch_msg_dma_batch_end end_msg = {.type = COMCH_MSG_BATCH_END};
+	struct dma_copy_resources resources = {0};
+	struct program_core_objects *state = NULL;
+	struct doca_mmap *remote_mmap = NULL;
+	struct dma_batch_slot *slot;
+	union doca_data ctx_user_data = {0};
+	const char *local_data;
+	size_t num_remaining_tasks = 0;
+	uint32_t next_submit = 0, next_done = 0, i;
+	uint64_t total_bytes = 0;
+	struct timespec start_ts;
+	struct stat st;
+	doca_error_t result, tmp_result;
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
+
+	/* Received files are written into the output directory */
+	if (stat(dma_cfg->file_path, &st) != 0) {
+		if (mkdir(dma_cfg->file_path, 0755) != 0) {
+			DOCA_LOG_ERR("Failed to create output directory %s: %s", dma_cfg->file_path, strerror(errno));
+			result = DOCA_ERROR_IO_FAILED;
+			goto end_session;
+		}
+	} else if (!S_ISDIR(st.st_mode)) {
+		DOCA_LOG_ERR("Batch output path %s is not a directory", dma_cfg->file_path);
+		result = DOCA_ERROR_INVALID_VALUE;
+		goto end_session;
+	}
+
+	result = allocate_dma_copy_resources(&resources, DMA_BATCH_NUM_SLOTS);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to allocate DMA copy resources: %s", doca_error_get_descr(result));
+		goto end_session;
+	}
+	state = resources.state;
+
+	result = get_dma_max_buf_size(&resources, &dma_cfg->max_dma_buf_size);
+	if (result != DOCA_SUCCESS)
+		goto destroy_dma_resources;
+
+	/* Include tasks counter in user data of context to be decremented in callbacks */
+	ctx_user_data.ptr = &num_remaining_tasks;
+	doca_ctx_set_user_data(state->ctx, ctx_user_data);
+
+	result = doca_ctx_start(state->ctx);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to start DMA context: %s", doca_error_get_descr(result));
+		goto destroy_dma_resources;
+	}
+
+	/* Wait until the batch start message is received on comch */
+	while (dma_cfg->comch_state == COMCH_NEGOTIATING) {
+		nanosleep(&ts, &ts);
+		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+			goto stop_dma;
+		}
+	}
+
+	if (dma_cfg->comch_state == COMCH_ERROR) {
+		DOCA_LOG_ERR("Comch batch negotiation failed");
+		result = DOCA_ERROR_BAD_STATE;
+		goto stop_dma;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start_ts);
+
+	if (dma_cfg->slot_size > dma_cfg->max_dma_buf_size) {
+		DOCA_LOG_ERR("DMA device maximum allowed file size in bytes is %" PRIu64
+			     ", largest batch file size is %" PRIu64 " bytes",
+			     dma_cfg->max_dma_buf_size,
+			     dma_cfg->slot_size);
+		result = DOCA_ERROR_INVALID_VALUE;
+		goto stop_dma;
+	}
+
+	result = memory_alloc_and_populate(state->src_mmap,
+					   DMA_BATCH_NUM_SLOTS * dma_cfg->slot_size,
+					   DOCA_ACCESS_FLAG_LOCAL_READ_WRITE,
+					   &dma_cfg->file_buffer);
+	if (result != DOCA_SUCCESS)
+		goto stop_dma;
+
+	result = doca_mmap_create_from_export(NULL,
+					      (const void *)dma_cfg->exported_mmap,
+					      dma_cfg->exported_mmap_len,
+					      state->dev,
+					      &remote_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create memory map from export: %s", doca_error_get_descr(result));
+		goto free_buffer;
+	}
+
+	/* Buffers of every slot are built once and reused by all the files of the slot */
+	for (i = 0; i < DMA_BATCH_NUM_SLOTS; i++) {
+		slot = &dma_cfg->slots[i];
+		result = doca_buf_inventory_buf_get_by_addr(state->buf_inv,
+							    remote_mmap,
+							    dma_cfg->host_addr + i * dma_cfg->slot_size,
+							    dma_cfg->slot_size,
+							    &slot->remote_buf);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Unable to acquire DOCA remote buffer: %s", doca_error_get_descr(result));
+			goto destroy_bufs;
+		}
+
+		result = doca_buf_inventory_buf_get_by_addr(state->buf_inv,
+							    state->src_mmap,
+							    dma_cfg->file_buffer + i * dma_cfg->slot_size,
+							    dma_cfg->slot_size,
+							    &slot->local_buf);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Unable to acquire DOCA local buffer: %s", doca_error_get_descr(result));
+			goto destroy_bufs;
+		}
+	}
+
+	/* Files complete in order, a local slot takes its next file once the previous one was written */
+	while (next_done < dma_cfg->num_files) {
+		if (dma_cfg->comch_state == COMCH_ERROR) {
+			DOCA_LOG_ERR("Failure was detected in batch dma copy");
+			result = DOCA_ERROR_BAD_STATE;
+			goto drain_tasks;
+		}
+
+		while (next_submit < dma_cfg->num_files && next_submit - next_done < DMA_BATCH_NUM_SLOTS) {
+			slot = &dma_cfg->slots[next_submit % DMA_BATCH_NUM_SLOTS];
+			if (!slot->in_use || slot->file_idx != next_submit)
+				break;
+
+			result = dpu_submit_batch_dma_task(&resources, slot, &num_remaining_tasks);
+			if (result != DOCA_SUCCESS)
+				goto drain_tasks;
+			next_submit++;
+		}
+
+		slot = &dma_cfg->slots[next_done % DMA_BATCH_NUM_SLOTS];
+		if (next_done == next_submit || slot->task_result == DOCA_ERROR_IN_PROGRESS) {
+			if (doca_pe_progress(state->pe) != 0)
+				continue;
+
+			nanosleep(&ts, &ts);
+			result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+			if (result != DOCA_SUCCESS) {
+				DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+				goto drain_tasks;
+			}
+			continue;
+		}
+
+		total_bytes += slot->file_size;
+		local_data = dma_cfg->file_buffer + (next_done % DMA_BATCH_NUM_SLOTS) * dma_cfg->slot_size;
+		result = dpu_complete_batch_slot(dma_cfg, comch_cfg, slot, local_data);
+		if (result != DOCA_SUCCESS)
+			goto drain_tasks;
+		next_done++;
+	}
+
+	send_status_msg(comch_util_get_connection(comch_cfg), STATUS_SUCCESS);
+	batch_report_throughput(dma_cfg->num_files, total_bytes, &start_ts);
+
+drain_tasks:
+	/* Wait for copies still in flight before releasing their buffers */
+	while (num_remaining_tasks > 0) {
+		if (doca_pe_progress(state->pe) == 0)
+			nanosleep(&ts, &ts);
+	}
+	for (i = 0; i < DMA_BATCH_NUM_SLOTS; i++) {
+		if (dma_cfg->slots[i].task != NULL) {
+			doca_task_free(doca_dma_task_memcpy_as_task(dma_cfg->slots[i].task));
+			dma_cfg->slots[i].task = NULL;
+		}
+	}
+destroy_bufs:
+	for (i = 0; i < DMA_BATCH_NUM_SLOTS; i++) {
+		slot = &dma_cfg->slots[i];
+		if (slot->local_buf != NULL) {
+			tmp_result = doca_buf_dec_refcount(slot->local_buf, NULL);
+			if (tmp_result != DOCA_SUCCESS) {
+				DOCA_ERROR_PROPAGATE(result, tmp_result);
+				DOCA_LOG_ERR("Failed to destroy local DOCA buffer: %s",
+					     doca_error_get_descr(tmp_result));
+			}
+		}
+		if (slot->remote_buf != NULL) {
+			tmp_result = doca_buf_dec_refcount(slot->remote_buf, NULL);
+			if (tmp_result != DOCA_SUCCESS) {
+				DOCA_ERROR_PROPAGATE(result, tmp_result);
+				DOCA_LOG_ERR("Failed to destroy remote DOCA buffer: %s",
+					     doca_error_get_descr(tmp_result));
+			}
+		}
+	}
+	tmp_result = doca_mmap_destroy(remote_mmap);
+	if (tmp_result != DOCA_SUCCESS) {
+		DOCA_ERROR_PROPAGATE(result, tmp_result);
+		DOCA_LOG_ERR("Failed to destroy remote DOCA mmap: %s", doca_error_get_descr(tmp_result));
+	}
+free_buffer:
+	free(dma_cfg->file_buffer);
+stop_dma:
+	/* A failure signalled by the host or already reported by the receive callback needs no status */
+	if (result != DOCA_SUCCESS && dma_cfg->comch_state != COMCH_ERROR)
+		send_status_msg(comch_util_get_connection(comch_cfg), STATUS_FAILURE);
+	tmp_result = request_stop_ctx(state->pe, state->ctx);
+	if (tmp_result != DOCA_SUCCESS) {
+		DOCA_ERROR_PROPAGATE(result, tmp_result);
+		DOCA_LOG_ERR("Unable to stop context: %s", doca_error_get_descr(tmp_result));
+	}
+	state->ctx = NULL;
+destroy_dma_resources:
+	if (dma_cfg->exported_mmap != NULL)
+		free(dma_cfg->exported_mmap);
+	tmp_result = destroy_dma_copy_resources(&resources);
+	if (tmp_result != DOCA_SUCCESS) {
+		DOCA_ERROR_PROPAGATE(result, tmp_result);
+		DOCA_LOG_ERR("Failed to destroy DMA copy resources: %s", doca_error_get_descr(tmp_result));
+	}
+end_session:
+	/* No DMA reads the host staging buffer anymore, the host holds on to it until this message */
+	tmp_result = comch_utils_send(comch_util_get_connection(comch_cfg), &end_msg, sizeof(end_msg));
+	if (tmp_result != DOCA_SUCCESS) {
+		DOCA_ERROR_PROPAGATE(result, tmp_result);
+		DOCA_LOG_ERR("Failed to send batch end message: %s", doca_error_get_descr(tmp_result));
+	}
+	return result;
+}
+
 doca_error_t dpu_start_dma_copy(struct dma_copy_cfg *dma_cfg, struct comch_cfg *comch_cfg)
 {
 	struct dma_copy_resources resources = {0};
@@ -1131,8 +2177,11 @@ doca_error_t dpu_start_dma_copy(struct dma_copy_cfg *dma_cfg, struct comch_cfg *
 		.tv_nsec = SLEEP_IN_NANOS,
 	};
 
+	if (dma_cfg->batch)
+		return dpu_start_dma_batch(dma_cfg, comch_cfg);
+
 	/* Allocate DMA copy resources */
-	result = allocate_dma_copy_resources(&resources);
+	result = allocate_dma_copy_resources(&resources, NUM_DMA_TASKS);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to allocate DMA copy resources: %s", doca_error_get_descr(result));
 		return result;
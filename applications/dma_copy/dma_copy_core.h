@@ -39,6 +39,7 @@
 #define MAX_ARG_SIZE 128	      /* PCI address and file path maximum length */
 #define SERVER_NAME "dma copy server" /* Comm Channel service name */
 #define NUM_DMA_TASKS (1)	      /* DMA tasks number */
+#define DMA_BATCH_NUM_SLOTS (4)	      /* Staging slots in batch mode, a file is read, copied or written per slot */
 
 enum dma_copy_mode {
 	DMA_COPY_MODE_HOST, /* Run endpoint in Host */
@@ -49,6 +50,10 @@ enum comch_msg_type {
 	COMCH_MSG_DIRECTION = 1,	 /* Message type to negotiate file direction */
 	COMCH_MSG_EXPORT_DESCRIPTOR = 2, /* Message type to export dma descriptor information */
 	COMCH_MSG_STATUS = 3,		 /* Generic success/fail message type */
+	COMCH_MSG_BATCH_START = 4,	 /* Message type to start a batch session and export the staging buffer */
+	COMCH_MSG_BATCH_FILE = 5,	 /* Message type to announce a file ready in a staging slot */
+	COMCH_MSG_BATCH_SLOT_DONE = 6,	 /* Message type to release a staging slot after its DMA completed */
+	COMCH_MSG_BATCH_END = 7,	 /* Message type to report the DPU no longer accesses the staging buffer */
 };
 
 struct comch_msg_dma_direction {
@@ -69,6 +74,31 @@ struct comch_msg_dma_status {
 	bool is_success;	  /* Indicate success or failure for last message sent */
 };
 
+struct comch_msg_dma_batch_start {
+	enum comch_msg_type type; /* COMCH_MSG_BATCH_START */
+	uint32_t num_files;	  /* Number of files in the batch */
+	uint64_t slot_size;	  /* Size of each staging slot in bytes */
+	uint64_t host_addr;	  /* Address of the staging buffer on host side */
+	size_t export_desc_len;	  /* Length of the exported mmap */
+	uint8_t exported_mmap[];  /* Variable sized array containing exported mmap */
+};
+
+struct comch_msg_dma_batch_file {
+	enum comch_msg_type type; /* COMCH_MSG_BATCH_FILE */
+	uint32_t file_idx;	  /* Index of the file in the batch, selects the staging slot */
+	uint64_t file_size;	  /* File size in bytes */
+	char file_name[];	  /* NULL terminated file name, without directories */
+};
+
+struct comch_msg_dma_batch_slot_done {
+	enum comch_msg_type type; /* COMCH_MSG_BATCH_SLOT_DONE */
+	uint32_t file_idx;	  /* Index of the file whose staging slot can be reused */
+};
+
+struct comch_msg_dma_batch_end {
+	enum comch_msg_type type; /* COMCH_MSG_BATCH_END */
+};
+
 struct comch_msg {
 	enum comch_msg_type type; /* Indicator of message type */
 	union {
@@ -78,6 +108,17 @@ struct comch_msg {
 	};
 };
 
+struct dma_batch_slot {
+	bool in_use;			   /* File in the slot was announced and not yet released */
+	uint32_t file_idx;		   /* Index of the file in the slot */
+	uint64_t file_size;		   /* Size of the file in the slot */
+	char file_name[MAX_ARG_SIZE];	   /* Name of the file in the slot (DPU only) */
+	struct doca_buf *local_buf;	   /* DOCA buffer on the local slot (DPU only) */
+	struct doca_buf *remote_buf;	   /* DOCA buffer on the host slot (DPU only) */
+	struct doca_dma_task_memcpy *task; /* DMA task in flight for the slot (DPU only) */
+	doca_error_t task_result;	   /* Result of the DMA task, DOCA_ERROR_IN_PROGRESS until completion */
+};
+
 enum dma_comch_state {
 	COMCH_NEGOTIATING, /* DMA metadata is being negotiated */
 	COMCH_COMPLETE,	   /* DMA metadata successfully passed */
@@ -104,6 +145,13 @@ struct dma_copy_cfg {
 	/* Comch connection info */
 	uint32_t max_comch_buffer;	  /* Max buffer size the comch is configure for */
 	enum dma_comch_state comch_state; /* Current state of DMA metadata negotiation on the comch */
+
+	/* Batch mode fields, file_path is a manifest or directory on the host and the output directory on the DPU */
+	bool batch;					  /* Copy many files over a single session */
+	uint32_t num_files;				  /* Number of files in the batch */
+	uint64_t slot_size;				  /* Size of each staging slot in bytes */
+	struct dma_batch_slot slots[DMA_BATCH_NUM_SLOTS]; /* Staging slots, file i uses slot i % num slots */
+	bool batch_ended;				  /* DPU reported the end of the session (host only) */
 };
 
 struct dma_copy_resources {
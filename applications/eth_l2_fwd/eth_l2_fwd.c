@@ -252,6 +252,43 @@ static doca_error_t max_forwardings_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * ARGP Callback - Handle per-packet processing stages parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR_... otherwise
+ */
+static doca_error_t pkt_stages_callback(void *param, void *config)
+{
+	struct eth_l2_fwd_cfg *app_cfg = (struct eth_l2_fwd_cfg *)config;
+	const char *stages_list = (char *)param;
+
+	return eth_l2_fwd_parse_stages(stages_list, &app_cfg->pkt_stages);
+}
+
+/*
+ * ARGP Callback - Handle VLAN ID parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR_... otherwise
+ */
+static doca_error_t vlan_id_callback(void *param, void *config)
+{
+	struct eth_l2_fwd_cfg *app_cfg = (struct eth_l2_fwd_cfg *)config;
+	int *vlan_id = (int *)param;
+
+	if (*vlan_id < 1 || *vlan_id > 4094) {
+		DOCA_LOG_ERR("VLAN ID parameter must be between 1 and 4094");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	app_cfg->vlan_id = *vlan_id;
+
+	return DOCA_SUCCESS;
+}
+
 /*
  * Registers all flags used by the application for DOCA argument parser, so that when parsing
  * it can be parsed accordingly
@@ -262,7 +299,7 @@ static doca_error_t register_eth_l2_fwd_params(void)
 {
 	doca_error_t result;
 	struct doca_argp_param *mlxdevs_names, *pkts_recv_rate, *max_pkt_size, *pkt_max_process_time, *num_task_batches,
-		*one_sided_fwd, *max_fwds;
+		*one_sided_fwd, *max_fwds, *pkt_stages, *vlan_id;
 
 	/* Create and register IB devices names param */
 	result = doca_argp_param_create(&mlxdevs_names);
@@ -396,6 +433,44 @@ static doca_error_t register_eth_l2_fwd_params(void)
 		return result;
 	}
 
+	/* Create and register per-packet processing stages param */
+	result = doca_argp_param_create(&pkt_stages);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(pkt_stages, "s");
+	doca_argp_param_set_long_name(pkt_stages, "stages");
+	doca_argp_param_set_arguments(pkt_stages, "<stage1,stage2,...>");
+	doca_argp_param_set_description(
+		pkt_stages,
+		"Set per-packet processing stages separated by a comma: vlan-pop, csum, mac-swap, vlan-push. default is none.");
+	doca_argp_param_set_callback(pkt_stages, pkt_stages_callback);
+	doca_argp_param_set_type(pkt_stages, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(pkt_stages);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register VLAN ID param */
+	result = doca_argp_param_create(&vlan_id);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(vlan_id, "vi");
+	doca_argp_param_set_long_name(vlan_id, "vlan-id");
+	doca_argp_param_set_arguments(vlan_id, "<id>");
+	doca_argp_param_set_description(vlan_id, "Set VLAN ID inserted by the vlan-push stage, default is 1.");
+	doca_argp_param_set_callback(vlan_id, vlan_id_callback);
+	doca_argp_param_set_type(vlan_id, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(vlan_id);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	return DOCA_SUCCESS;
 }
 
@@ -413,7 +488,9 @@ int main(int argc, char **argv)
 					 .max_pkt_size = ETH_L2_FWD_MAX_PKT_SIZE_DEFAULT,
 					 .pkt_max_process_time = ETH_L2_FWD_PKT_MAX_PROCESS_TIME_DEFAULT,
 					 .num_task_batches = ETH_L2_FWD_NUM_TASK_BATCHES_DEFAULT,
-					 .one_sided_fwd = 0};
+					 .one_sided_fwd = 0,
+					 .pkt_stages = 0,
+					 .vlan_id = ETH_L2_FWD_VLAN_ID_DEFAULT};
 	struct doca_log_backend *sdk_log;
 	doca_error_t result;
 	int exit_status = EXIT_SUCCESS;
@@ -24,7 +24,13 @@
  */
 
 #include <inttypes.h>
+#include <string.h>
 #include <time.h>
+#include <arpa/inet.h>
+#include <net/ethernet.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
 
 #include <doca_buf.h>
 #include <doca_common_defines.h>
@@ -43,6 +49,12 @@
 
 #define NS_PER_SEC 1E9		 /* Nano-seconds per second */
 #define STATS_MAX_BUFF_SIZE 1024 /* Max buffer size to hold statistics string */
+#define STAGES_LIST_MAX_LEN 128	 /* Max length of the per-packet stages list argument */
+#define VLAN_HDR_LEN 4		 /* Length of an 802.1Q tag */
+#define MAC_ADDRS_LEN (2 * ETHER_ADDR_LEN) /* Length of the destination and source MAC addresses */
+#define IPV4_FRAG_MASK 0x3fff	 /* IPv4 MF flag and fragment offset bits */
+#define TCP_CSUM_OFFSET 16	 /* Offset of the checksum field in the TCP header */
+#define UDP_CSUM_OFFSET 6	 /* Offset of the checksum field in the UDP header */
 
 DOCA_LOG_REGISTER(ETH_L2_FWD : Core);
 
@@ -75,6 +87,441 @@ static struct eth_l2_fwd_stats stats = {.dev1_stats.rx_pkts = 0,
 					.dev2_stats.rx_dropped = 0,
 					.dev2_stats.total_tx_pkts = 0};
 
+/* Per-packet processing stage accounting */
+struct eth_l2_fwd_stage_stats {
+	uint64_t pkts;	 /* Number of packets that went through the stage */
+	uint64_t cycles; /* Cycles spent in the stage, see read_cycles() */
+	uint64_t misses;   /* Packets the stage could not handle (truncated L4 header, no room for a VLAN tag) */
+	uint64_t bad_csum; /* Packets forwarded untouched because they arrived with a bad checksum */
+};
+
+/* Handler of a single per-packet processing stage, applied over a whole burst */
+typedef void (*eth_l2_fwd_stage_handler)(struct doca_buf **pkt_array,
+					 uint16_t nb_pkts,
+					 struct eth_l2_fwd_stage_stats *stage_stats);
+
+static uint8_t pkt_stages = 0; /* Enabled per-packet processing stages */
+static uint16_t vlan_tci = 0;  /* Network order TCI inserted by the VLAN push stage */
+static struct eth_l2_fwd_stage_stats stage_stats[ETH_L2_FWD_NUM_STAGES];
+
+static const char *const stage_names[ETH_L2_FWD_NUM_STAGES] = {
+	[ETH_L2_FWD_STAGE_VLAN_POP] = "vlan-pop",
+	[ETH_L2_FWD_STAGE_CSUM] = "csum",
+	[ETH_L2_FWD_STAGE_MAC_SWAP] = "mac-swap",
+	[ETH_L2_FWD_STAGE_VLAN_PUSH] = "vlan-push",
+};
+
+/*
+ * Reads the counter used for per-stage cycle accounting
+ *
+ * @note On Arm this is the generic timer, which ticks slower than the core clock
+ *
+ * @return: current counter value
+ */
+static inline uint64_t read_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+	uint64_t cnt;
+
+	asm volatile("mrs %0, cntvct_el0" : "=r"(cnt));
+	return cnt;
+#else
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_nsec + (uint64_t)t.tv_sec * NS_PER_SEC;
+#endif
+}
+
+/*
+ * Adds a buffer to a 32-bit ones' complement sum, 16 bits at a time
+ *
+ * @note The sum is byte order independent (RFC 1071), so the folded result can be stored as is
+ *
+ * @data [in]: Buffer to sum
+ * @len [in]: Buffer length
+ * @sum [in]: Initial sum
+ * @return: the updated unfolded sum
+ */
+static uint32_t csum_partial(const uint8_t *data, size_t len, uint32_t sum)
+{
+	uint16_t word;
+
+	for (; len > 1; len -= 2, data += 2) {
+		memcpy(&word, data, sizeof(word));
+		sum += word;
+	}
+	if (len) {
+		word = 0;
+		memcpy(&word, data, 1);
+		sum += word;
+	}
+
+	return sum;
+}
+
+/*
+ * Folds a 32-bit ones' complement sum into a 16-bit checksum
+ *
+ * @sum [in]: Unfolded sum
+ * @return: the complemented 16-bit checksum
+ */
+static uint16_t csum_fold(uint32_t sum)
+{
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)~sum;
+}
+
+/*
+ * Gets the L3 header of an Ethernet frame, skipping a single 802.1Q tag if present
+ *
+ * @data [in]: Frame start
+ * @len [in]: Frame length
+ * @ether_type [out]: Network order EtherType of the L3 header
+ * @return: offset of the L3 header, or 0 if the frame is too short
+ */
+static size_t get_l3_offset(const uint8_t *data, size_t len, uint16_t *ether_type)
+{
+	size_t offset = ETHER_HDR_LEN;
+
+	if (len < ETHER_HDR_LEN)
+		return 0;
+	memcpy(ether_type, data + MAC_ADDRS_LEN, sizeof(*ether_type));
+	if (*ether_type == htons(ETHERTYPE_VLAN)) {
+		offset += VLAN_HDR_LEN;
+		if (len < offset)
+			return 0;
+		memcpy(ether_type, data + MAC_ADDRS_LEN + VLAN_HDR_LEN, sizeof(*ether_type));
+	}
+
+	return offset;
+}
+
+/*
+ * Validates the TCP/UDP checksum of a packet
+ *
+ * @l4 [in]: L4 header start, holding at least the checksum field
+ * @l4_len [in]: L4 header and payload length
+ * @proto [in]: L4 protocol
+ * @pseudo_sum [in]: Unfolded sum of the pseudo header, including protocol and length
+ * @return: true if the received checksum is valid or absent, false otherwise
+ */
+static bool l4_csum_valid(const uint8_t *l4, size_t l4_len, uint8_t proto, uint32_t pseudo_sum)
+{
+	uint16_t csum;
+
+	if (proto == IPPROTO_UDP) {
+		memcpy(&csum, l4 + UDP_CSUM_OFFSET, sizeof(csum));
+		/* A zero UDP checksum means the sender did not compute one */
+		if (csum == 0)
+			return true;
+	}
+
+	return csum_fold(csum_partial(l4, l4_len, pseudo_sum)) == 0;
+}
+
+/*
+ * Rewrites the TCP/UDP checksum of a packet, an absent UDP checksum is left absent
+ *
+ * @l4 [in/out]: L4 header start, holding at least the checksum field
+ * @l4_len [in]: L4 header and payload length
+ * @proto [in]: L4 protocol
+ * @pseudo_sum [in]: Unfolded sum of the pseudo header, including protocol and length
+ */
+static void l4_csum_set(uint8_t *l4, size_t l4_len, uint8_t proto, uint32_t pseudo_sum)
+{
+	size_t csum_offset = proto == IPPROTO_TCP ? TCP_CSUM_OFFSET : UDP_CSUM_OFFSET;
+	uint16_t csum;
+
+	memcpy(&csum, l4 + csum_offset, sizeof(csum));
+	if (proto == IPPROTO_UDP && csum == 0)
+		return;
+
+	memset(l4 + csum_offset, 0, sizeof(csum));
+	csum = csum_fold(csum_partial(l4, l4_len, pseudo_sum));
+	if (proto == IPPROTO_UDP && csum == 0)
+		csum = 0xffff;
+	memcpy(l4 + csum_offset, &csum, sizeof(csum));
+}
+
+/*
+ * Checksum stage - validates and recomputes IPv4 header and TCP/UDP checksums, fragments L4 is left untouched.
+ * Packets that arrive with a bad checksum are forwarded as received, so the receiver still sees the corruption
+ *
+ * @pkt_array [in]: Burst of packets
+ * @nb_pkts [in]: Number of packets in the burst
+ * @stage_stats [in/out]: Stage statistics, bad_csum counts packets that arrived with a bad checksum
+ */
+static void stage_csum(struct doca_buf **pkt_array, uint16_t nb_pkts, struct eth_l2_fwd_stage_stats *stage_stats)
+{
+	uint16_t i, ether_type;
+	uint32_t pseudo_sum;
+	size_t len, l3_offset, l3_len, l4_len, csum_offset;
+	uint8_t *data, *l4, proto;
+	struct iphdr *ipv4;
+	bool l4_csum;
+
+	for (i = 0; i < nb_pkts; i++) {
+		(void)doca_buf_get_data(pkt_array[i], (void **)&data);
+		(void)doca_buf_get_data_len(pkt_array[i], &len);
+
+		l3_offset = get_l3_offset(data, len, &ether_type);
+		if (l3_offset == 0)
+			continue;
+
+		ipv4 = NULL;
+		if (ether_type == htons(ETHERTYPE_IP) && len >= l3_offset + sizeof(struct iphdr)) {
+			ipv4 = (struct iphdr *)(data + l3_offset);
+
+			l3_len = ipv4->ihl * 4;
+			if (l3_len < sizeof(struct iphdr) || len < l3_offset + l3_len)
+				continue;
+
+			if (csum_fold(csum_partial((uint8_t *)ipv4, l3_len, 0)) != 0) {
+				stage_stats->bad_csum++;
+				continue;
+			}
+
+			proto = ipv4->protocol;
+			l4_len = ntohs(ipv4->tot_len) > l3_len ? ntohs(ipv4->tot_len) - l3_len : 0;
+			if ((ntohs(ipv4->frag_off) & IPV4_FRAG_MASK) != 0)
+				proto = IPPROTO_NONE;
+			pseudo_sum = csum_partial((uint8_t *)&ipv4->saddr, 2 * sizeof(ipv4->saddr), 0);
+		} else if (ether_type == htons(ETHERTYPE_IPV6) && len >= l3_offset + sizeof(struct ip6_hdr)) {
+			struct ip6_hdr *ipv6 = (struct ip6_hdr *)(data + l3_offset);
+
+			/* Extension headers are not parsed, only TCP/UDP directly following the base header */
+			l3_len = sizeof(struct ip6_hdr);
+			proto = ipv6->ip6_nxt;
+			l4_len = ntohs(ipv6->ip6_plen);
+			pseudo_sum = csum_partial((uint8_t *)&ipv6->ip6_src, 2 * sizeof(ipv6->ip6_src), 0);
+		} else
+			continue;
+
+		l4 = data + l3_offset + l3_len;
+		l4_csum = (proto == IPPROTO_TCP || proto == IPPROTO_UDP) && len >= l3_offset + l3_len + l4_len;
+		if (l4_csum) {
+			csum_offset = proto == IPPROTO_TCP ? TCP_CSUM_OFFSET : UDP_CSUM_OFFSET;
+			if (l4_len < csum_offset + sizeof(uint16_t)) {
+				stage_stats->misses++;
+				continue;
+			}
+			pseudo_sum += htons(proto) + htons((uint16_t)l4_len);
+			if (!l4_csum_valid(l4, l4_len, proto, pseudo_sum)) {
+				stage_stats->bad_csum++;
+				continue;
+			}
+		}
+
+		/* Only packets that arrived with valid checksums are rewritten */
+		if (ipv4 != NULL) {
+			ipv4->check = 0;
+			ipv4->check = csum_fold(csum_partial((uint8_t *)ipv4, l3_len, 0));
+		}
+		if (l4_csum)
+			l4_csum_set(l4, l4_len, proto, pseudo_sum);
+	}
+}
+
+/*
+ * MAC swap stage - swaps the source and destination MAC addresses
+ *
+ * @pkt_array [in]: Burst of packets
+ * @nb_pkts [in]: Number of packets in the burst
+ * @stage_stats [in/out]: Stage statistics
+ */
+static void stage_mac_swap(struct doca_buf **pkt_array, uint16_t nb_pkts, struct eth_l2_fwd_stage_stats *stage_stats)
+{
+	uint8_t tmp[ETHER_ADDR_LEN];
+	uint8_t *data;
+	size_t len;
+	uint16_t i;
+
+	(void)stage_stats;
+
+	for (i = 0; i < nb_pkts; i++) {
+		(void)doca_buf_get_data(pkt_array[i], (void **)&data);
+		(void)doca_buf_get_data_len(pkt_array[i], &len);
+		if (len < ETHER_HDR_LEN)
+			continue;
+
+		memcpy(tmp, data, ETHER_ADDR_LEN);
+		memcpy(data, data + ETHER_ADDR_LEN, ETHER_ADDR_LEN);
+		memcpy(data + ETHER_ADDR_LEN, tmp, ETHER_ADDR_LEN);
+	}
+}
+
+/*
+ * VLAN pop stage - strips the outermost 802.1Q tag by moving the MAC addresses over it
+ *
+ * @pkt_array [in]: Burst of packets
+ * @nb_pkts [in]: Number of packets in the burst
+ * @stage_stats [in/out]: Stage statistics
+ */
+static void stage_vlan_pop(struct doca_buf **pkt_array, uint16_t nb_pkts, struct eth_l2_fwd_stage_stats *stage_stats)
+{
+	uint16_t i, ether_type;
+	uint8_t *data;
+	size_t len;
+
+	(void)stage_stats;
+
+	for (i = 0; i < nb_pkts; i++) {
+		(void)doca_buf_get_data(pkt_array[i], (void **)&data);
+		(void)doca_buf_get_data_len(pkt_array[i], &len);
+		if (len < ETHER_HDR_LEN + VLAN_HDR_LEN)
+			continue;
+
+		memcpy(&ether_type, data + MAC_ADDRS_LEN, sizeof(ether_type));
+		if (ether_type != htons(ETHERTYPE_VLAN))
+			continue;
+
+		memmove(data + VLAN_HDR_LEN, data, MAC_ADDRS_LEN);
+		(void)doca_buf_set_data(pkt_array[i], data + VLAN_HDR_LEN, len - VLAN_HDR_LEN);
+	}
+}
+
+/*
+ * VLAN push stage - inserts an 802.1Q tag, using the buffer headroom if available and the tailroom otherwise
+ *
+ * @pkt_array [in]: Burst of packets
+ * @nb_pkts [in]: Number of packets in the burst
+ * @stage_stats [in/out]: Stage statistics, misses count packets with no room for the tag
+ */
+static void stage_vlan_push(struct doca_buf **pkt_array, uint16_t nb_pkts, struct eth_l2_fwd_stage_stats *stage_stats)
+{
+	uint16_t i, tpid = htons(ETHERTYPE_VLAN);
+	uint8_t *head, *data;
+	size_t len, buf_len;
+
+	for (i = 0; i < nb_pkts; i++) {
+		(void)doca_buf_get_head(pkt_array[i], (void **)&head);
+		(void)doca_buf_get_len(pkt_array[i], &buf_len);
+		(void)doca_buf_get_data(pkt_array[i], (void **)&data);
+		(void)doca_buf_get_data_len(pkt_array[i], &len);
+		if (len < MAC_ADDRS_LEN)
+			continue;
+
+		if ((size_t)(data - head) >= VLAN_HDR_LEN) {
+			memmove(data - VLAN_HDR_LEN, data, MAC_ADDRS_LEN);
+			data -= VLAN_HDR_LEN;
+		} else if ((size_t)(data - head) + len + VLAN_HDR_LEN <= buf_len) {
+			memmove(data + MAC_ADDRS_LEN + VLAN_HDR_LEN, data + MAC_ADDRS_LEN, len - MAC_ADDRS_LEN);
+		} else {
+			stage_stats->misses++;
+			continue;
+		}
+
+		memcpy(data + MAC_ADDRS_LEN, &tpid, sizeof(tpid));
+		memcpy(data + MAC_ADDRS_LEN + sizeof(tpid), &vlan_tci, sizeof(vlan_tci));
+		(void)doca_buf_set_data(pkt_array[i], data, len + VLAN_HDR_LEN);
+	}
+}
+
+static const eth_l2_fwd_stage_handler stage_handlers[ETH_L2_FWD_NUM_STAGES] = {
+	[ETH_L2_FWD_STAGE_VLAN_POP] = stage_vlan_pop,
+	[ETH_L2_FWD_STAGE_CSUM] = stage_csum,
+	[ETH_L2_FWD_STAGE_MAC_SWAP] = stage_mac_swap,
+	[ETH_L2_FWD_STAGE_VLAN_PUSH] = stage_vlan_push,
+};
+
+/*
+ * Runs the enabled per-packet processing stages over a received burst, one stage at a time
+ *
+ * @pkt_array [in]: Burst of packets
+ * @nb_pkts [in]: Number of packets in the burst
+ */
+static void process_pkts(struct doca_buf **pkt_array, uint16_t nb_pkts)
+{
+	uint64_t start, end;
+	int stage;
+
+	start = read_cycles();
+	for (stage = 0; stage < ETH_L2_FWD_NUM_STAGES; stage++) {
+		if (!(pkt_stages & ETH_L2_FWD_STAGE_BIT(stage)))
+			continue;
+
+		stage_handlers[stage](pkt_array, nb_pkts, &stage_stats[stage]);
+
+		end = read_cycles();
+		stage_stats[stage].cycles += end - start;
+		stage_stats[stage].pkts += nb_pkts;
+		start = end;
+	}
+}
+
+doca_error_t eth_l2_fwd_parse_stages(const char *stages_list, uint8_t *stages)
+{
+	char list[STAGES_LIST_MAX_LEN];
+	char *saveptr = NULL;
+	char *name;
+	int stage;
+
+	if (strnlen(stages_list, STAGES_LIST_MAX_LEN) == STAGES_LIST_MAX_LEN) {
+		DOCA_LOG_ERR("Stages list is too long, max length is %d", STAGES_LIST_MAX_LEN - 1);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	strcpy(list, stages_list);
+
+	*stages = 0;
+	for (name = strtok_r(list, ",", &saveptr); name != NULL; name = strtok_r(NULL, ",", &saveptr)) {
+		for (stage = 0; stage < ETH_L2_FWD_NUM_STAGES; stage++) {
+			if (strcmp(name, stage_names[stage]) == 0)
+				break;
+		}
+		if (stage == ETH_L2_FWD_NUM_STAGES) {
+			DOCA_LOG_ERR("Unknown packet processing stage \"%s\"", name);
+			return DOCA_ERROR_INVALID_VALUE;
+		}
+		*stages |= ETH_L2_FWD_STAGE_BIT(stage);
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Prints the per-packet processing stages statistics, if any stage is enabled
+ */
+static void eth_l2_fwd_show_stage_stats(void)
+{
+	char buff[STATS_MAX_BUFF_SIZE];
+	int curr_buff_offset = 0;
+	int stage;
+
+	if (pkt_stages == 0)
+		return;
+
+	curr_buff_offset += snprintf(
+		buff,
+		sizeof(buff),
+		"\n**************************** Per-packet stage statistics *********************************\n");
+	for (stage = 0; stage < ETH_L2_FWD_NUM_STAGES; stage++) {
+		if (!(pkt_stages & ETH_L2_FWD_STAGE_BIT(stage)))
+			continue;
+
+		curr_buff_offset += snprintf(buff + curr_buff_offset,
+					     sizeof(buff) - curr_buff_offset,
+					     "%-10s packets: %-17" PRIu64 " cycles/pkt: %-10.1f misses: %-10" PRIu64
+					     " bad csum: %-" PRIu64 "\n",
+					     stage_names[stage],
+					     stage_stats[stage].pkts,
+					     stage_stats[stage].pkts ?
+						     (double)stage_stats[stage].cycles / stage_stats[stage].pkts :
+						     0.0,
+					     stage_stats[stage].misses,
+					     stage_stats[stage].bad_csum);
+	}
+	snprintf(buff + curr_buff_offset,
+		 sizeof(buff) - curr_buff_offset,
+		 "******************************************************************************************");
+
+	DOCA_LOG_INFO("%s", buff);
+}
+
 /*
  * Prints the forwarding statistics of the running application instance
  *
@@ -183,6 +630,8 @@ static void eth_l2_fwd_show_stats(void)
 
 	DOCA_LOG_INFO("%s", buff);
 
+	eth_l2_fwd_show_stage_stats();
+
 	prev_total_rx_pkts_dev1 = dev1_total_rx_pkts;
 	prev_total_tx_pkts_dev1 = stats.dev1_stats.total_tx_pkts;
 
@@ -320,6 +769,9 @@ static void rx_success_cb1(struct doca_eth_rxq_event_batch_managed_recv *event_b
 		return;
 	}
 
+	if (pkt_stages != 0)
+		process_pkts(pkt_array, events_number);
+
 	memcpy(batch_pkt_array, pkt_array, sizeof(struct doca_buf *) * events_number);
 
 	/* Return value is not checked since this is data-path (previous call result check prevents incorrect behavior)
@@ -370,6 +822,9 @@ static void rx_success_cb2(struct doca_eth_rxq_event_batch_managed_recv *event_b
 		return;
 	}
 
+	if (pkt_stages != 0)
+		process_pkts(pkt_array, events_number);
+
 	memcpy(batch_pkt_array, pkt_array, sizeof(struct doca_buf *) * events_number);
 
 	/* Return value is not checked since this is data-path (previous call result check prevents incorrect behavior)
@@ -738,6 +1193,9 @@ doca_error_t eth_l2_fwd_execute(struct eth_l2_fwd_cfg *cfg, struct eth_l2_fwd_re
 	struct eth_rxq_flow_config flow_cfg;
 	doca_error_t result;
 
+	pkt_stages = cfg->pkt_stages;
+	vlan_tci = htons(cfg->vlan_id);
+
 	result = open_doca_device_with_ibdev_name((uint8_t *)cfg->mlxdev_name1,
 						  strlen(cfg->mlxdev_name1),
 						  check_device_caps,
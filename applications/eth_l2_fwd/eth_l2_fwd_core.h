@@ -37,6 +37,18 @@
 #define ETH_L2_FWD_LOG_MAX_LRO_DEFAULT 15
 #define ETH_L2_FWD_NUM_TASK_BATCHES_DEFAULT 32
 #define ETH_L2_FWD_NUM_TASKS_PER_BATCH 128
+#define ETH_L2_FWD_VLAN_ID_DEFAULT 1
+
+/* Optional per-packet processing stages, applied burst-wise over every received batch in this order */
+enum eth_l2_fwd_stage {
+	ETH_L2_FWD_STAGE_VLAN_POP,  /* Strip the outermost 802.1Q tag */
+	ETH_L2_FWD_STAGE_CSUM,	    /* Validate and recompute IPv4 header and TCP/UDP checksums, keep bad ones */
+	ETH_L2_FWD_STAGE_MAC_SWAP,  /* Swap source and destination MAC addresses */
+	ETH_L2_FWD_STAGE_VLAN_PUSH, /* Insert an 802.1Q tag carrying the configured VLAN ID */
+	ETH_L2_FWD_NUM_STAGES,
+};
+
+#define ETH_L2_FWD_STAGE_BIT(stage) (1U << (stage))
 
 /* Ethernet L2 Forwarding application configuration */
 struct eth_l2_fwd_cfg {
@@ -52,6 +64,8 @@ struct eth_l2_fwd_cfg {
 					* 1 - device 1 -> device 2
 					* 2 - device 2 -> device 1
 					*/
+	uint8_t pkt_stages;	       /* Bitmask of enabled per-packet stages, see ETH_L2_FWD_STAGE_BIT() */
+	uint16_t vlan_id;	       /* VLAN ID inserted by the VLAN push stage */
 };
 
 /* DOCA mmap resources */
@@ -95,6 +109,15 @@ struct eth_l2_fwd_resources {
  */
 doca_error_t eth_l2_fwd_execute(struct eth_l2_fwd_cfg *cfg, struct eth_l2_fwd_resources *state);
 
+/*
+ * Parses a comma separated list of per-packet processing stage names
+ *
+ * @stages_list [in]: Stage names list, e.g. "csum,mac-swap"
+ * @stages [out]: Bitmask of the parsed stages
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR_INVALID_VALUE if an unknown stage name was given
+ */
+doca_error_t eth_l2_fwd_parse_stages(const char *stages_list, uint8_t *stages);
+
 /*
  * Stops the application forcefully during execution
  */
@@ -36,6 +36,23 @@
 
 DOCA_LOG_REGISTER(FILE_COMPRESSION);
 
+/*
+ * Close the control channel the application ran on
+ *
+ * @comch_cfg [in]: comch object, NULL in SHM mode
+ * @compress_cfg [in]: application config struct
+ */
+static void destroy_control_channel(struct comch_cfg *comch_cfg, struct file_compression_config *compress_cfg)
+{
+	if (compress_cfg->transfer_mode == TRANSFER_MODE_SHM) {
+		bulk_ctrl_destroy(&compress_cfg->ctrl);
+		return;
+	}
+
+	if (comch_utils_destroy(comch_cfg) != DOCA_SUCCESS)
+		DOCA_LOG_ERR("Failed to destroy DOCA Comch");
+}
+
 /*
  * File Compression application main function
  *
@@ -49,7 +66,7 @@ int main(int argc, char **argv)
 		.mode = NO_VALID_INPUT,
 	};
 
-	struct comch_cfg *comch_cfg;
+	struct comch_cfg *comch_cfg = NULL;
 	struct compress_resources resources = {0};
 	doca_error_t result;
 	struct doca_log_backend *sdk_log;
@@ -100,15 +117,22 @@ int main(int argc, char **argv)
 		return EXIT_FAILURE;
 	}
 
-	result = comch_utils_init(SERVER_NAME,
-				  compress_cfg.cc_dev_pci_addr,
-				  compress_cfg.cc_dev_rep_pci_addr,
-				  &compress_cfg,
-				  client_recv_event_cb,
-				  server_recv_event_cb,
-				  &comch_cfg);
+	/* Comch pairs the host with the DPU, SHM mode runs both sides on one host over a local control channel */
+	if (compress_cfg.transfer_mode == TRANSFER_MODE_SHM)
+		result = bulk_ctrl_init(SERVER_NAME,
+					compress_cfg.mode == SERVER,
+					compress_cfg.timeout,
+					&compress_cfg.ctrl);
+	else
+		result = comch_utils_init(SERVER_NAME,
+					  compress_cfg.cc_dev_pci_addr,
+					  compress_cfg.cc_dev_rep_pci_addr,
+					  &compress_cfg,
+					  client_recv_event_cb,
+					  server_recv_event_cb,
+					  &comch_cfg);
 	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to initialize a comch: %s", doca_error_get_descr(result));
+		DOCA_LOG_ERR("Failed to initialize the control channel: %s", doca_error_get_descr(result));
 		file_compression_cleanup(&compress_cfg, &resources);
 		doca_argp_destroy();
 		return EXIT_FAILURE;
@@ -122,17 +146,13 @@ int main(int argc, char **argv)
 
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("File compression encountered errors");
-		result = comch_utils_destroy(comch_cfg);
-		if (result != DOCA_SUCCESS)
-			DOCA_LOG_ERR("Failed to destroy DOCA Comch");
+		destroy_control_channel(comch_cfg, &compress_cfg);
 		file_compression_cleanup(&compress_cfg, &resources);
 		doca_argp_destroy();
 		return EXIT_FAILURE;
 	}
 
-	result = comch_utils_destroy(comch_cfg);
-	if (result != DOCA_SUCCESS)
-		DOCA_LOG_ERR("Failed to destroy DOCA Comch");
+	destroy_control_channel(comch_cfg, &compress_cfg);
 
 	file_compression_cleanup(&compress_cfg, &resources);
 
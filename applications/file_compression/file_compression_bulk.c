@@ -0,0 +1,804 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <doca_buf.h>
+#include <doca_buf_inventory.h>
+#include <doca_ctx.h>
+#include <doca_log.h>
+#include <doca_pe.h>
+
+#include <pack.h>
+#include <utils.h>
+
+#include "file_compression_bulk.h"
+
+#define BULK_SHM_NAME_PREFIX "/doca_file_compression_" /* Prefix of the shared memory object name */
+#define BULK_DMA_MAX_CHUNK (16 * 1024 * 1024)	       /* Upper bound on a single DMA memcpy */
+#define BULK_DMA_MAX_INFLIGHT 16		       /* DMA memcpy tasks kept in flight */
+#define SLEEP_IN_NANOS (10 * 1000)		       /* Progress engine polling interval when idle */
+#define BULK_CTRL_RETRY_NANOS (100 * 1000 * 1000)      /* Interval between client connection attempts */
+
+DOCA_LOG_REGISTER(FILE_COMPRESSION::Bulk);
+
+doca_error_t bulk_transfer_mode_parse(const char *name, enum file_compression_transfer_mode *mode)
+{
+	if (strcmp(name, "comch") == 0)
+		*mode = TRANSFER_MODE_COMCH;
+	else if (strcmp(name, "dma") == 0)
+		*mode = TRANSFER_MODE_DMA;
+	else if (strcmp(name, "shm") == 0)
+		*mode = TRANSFER_MODE_SHM;
+	else {
+		DOCA_LOG_ERR("Unknown transfer mode %s, expected comch, dma or shm", name);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	return DOCA_SUCCESS;
+}
+
+const char *bulk_transfer_mode_name(enum file_compression_transfer_mode mode)
+{
+	switch (mode) {
+	case TRANSFER_MODE_COMCH:
+		return "comch";
+	case TRANSFER_MODE_DMA:
+		return "dma";
+	case TRANSFER_MODE_SHM:
+		return "shm";
+	}
+	return "unknown";
+}
+
+/*
+ * Check if a DOCA device can export memory to the PCI peer
+ *
+ * @devinfo [in]: device to check
+ * @return: DOCA_SUCCESS if export is supported and DOCA_ERROR otherwise
+ */
+static doca_error_t check_dev_export_capable(struct doca_devinfo *devinfo)
+{
+	uint8_t supported = 0;
+	doca_error_t result;
+
+	result = doca_mmap_cap_is_export_pci_supported(devinfo, &supported);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	return supported ? DOCA_SUCCESS : DOCA_ERROR_NOT_SUPPORTED;
+}
+
+/*
+ * Check if a DOCA device supports DMA memcpy tasks
+ *
+ * @devinfo [in]: device to check
+ * @return: DOCA_SUCCESS if DMA is supported and DOCA_ERROR otherwise
+ */
+static doca_error_t check_dev_dma_capable(struct doca_devinfo *devinfo)
+{
+	return doca_dma_cap_task_memcpy_is_supported(devinfo);
+}
+
+/*
+ * Allocate the receive buffer and export it through a DOCA mmap
+ *
+ * @pci_addr [in]: PCI address of the device to export through
+ * @rx [in/out]: bulk receiver, len is already set
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t bulk_receiver_init_dma(const char *pci_addr, struct bulk_receiver *rx)
+{
+	doca_error_t result;
+
+	result = open_doca_device_with_pci(pci_addr, check_dev_export_capable, &rx->dev);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to open a device that can export memory: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	rx->buf = calloc(1, rx->len);
+	if (rx->buf == NULL) {
+		DOCA_LOG_ERR("Failed to allocate receive buffer");
+		result = DOCA_ERROR_NO_MEMORY;
+		goto close_dev;
+	}
+
+	result = doca_mmap_create(&rx->mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to create receive buffer memory map: %s", doca_error_get_descr(result));
+		goto free_buf;
+	}
+
+	result = doca_mmap_add_dev(rx->mmap, rx->dev);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to add device to receive buffer memory map: %s", doca_error_get_descr(result));
+		goto destroy_mmap;
+	}
+
+	/* The client writes the file into the buffer across PCI */
+	result = doca_mmap_set_permissions(rx->mmap, DOCA_ACCESS_FLAG_PCI_READ_WRITE);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to set access permissions of memory map: %s", doca_error_get_descr(result));
+		goto destroy_mmap;
+	}
+
+	result = doca_mmap_set_memrange(rx->mmap, rx->buf, rx->len);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to set memrange of memory map: %s", doca_error_get_descr(result));
+		goto destroy_mmap;
+	}
+
+	result = doca_mmap_start(rx->mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to start memory map: %s", doca_error_get_descr(result));
+		goto destroy_mmap;
+	}
+
+	return DOCA_SUCCESS;
+
+destroy_mmap:
+	doca_mmap_destroy(rx->mmap);
+	rx->mmap = NULL;
+free_buf:
+	free(rx->buf);
+	rx->buf = NULL;
+close_dev:
+	doca_dev_close(rx->dev);
+	rx->dev = NULL;
+	return result;
+}
+
+/*
+ * Allocate the receive buffer as a named shared memory object
+ *
+ * @rx [in/out]: bulk receiver, len is already set
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t bulk_receiver_init_shm(struct bulk_receiver *rx)
+{
+	void *addr;
+	int fd;
+
+	snprintf(rx->shm_name, sizeof(rx->shm_name), BULK_SHM_NAME_PREFIX "%d", (int)getpid());
+
+	fd = shm_open(rx->shm_name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		DOCA_LOG_ERR("Failed to create shared memory object %s: %s", rx->shm_name, strerror(errno));
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	if (ftruncate(fd, rx->len) < 0) {
+		DOCA_LOG_ERR("Failed to size shared memory object %s: %s", rx->shm_name, strerror(errno));
+		close(fd);
+		shm_unlink(rx->shm_name);
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	addr = mmap(NULL, rx->len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		DOCA_LOG_ERR("Failed to map shared memory object %s: %s", rx->shm_name, strerror(errno));
+		shm_unlink(rx->shm_name);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	rx->buf = addr;
+	return DOCA_SUCCESS;
+}
+
+doca_error_t bulk_receiver_init(enum file_compression_transfer_mode mode,
+				const char *pci_addr,
+				uint64_t len,
+				struct bulk_receiver *rx)
+{
+	memset(rx, 0, sizeof(*rx));
+	rx->mode = mode;
+	rx->len = len;
+
+	switch (mode) {
+	case TRANSFER_MODE_DMA:
+		return bulk_receiver_init_dma(pci_addr, rx);
+	case TRANSFER_MODE_SHM:
+		return bulk_receiver_init_shm(rx);
+	default:
+		DOCA_LOG_ERR("Transfer mode %s does not use a bulk receiver", bulk_transfer_mode_name(mode));
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+}
+
+doca_error_t bulk_receiver_export(struct bulk_receiver *rx, uint8_t *msg, uint32_t max_msg_len, uint32_t *msg_len)
+{
+	struct bulk_msg_export *exp_msg = (struct bulk_msg_export *)msg;
+	const void *desc;
+	size_t desc_len;
+	doca_error_t result;
+
+	if (rx->mode == TRANSFER_MODE_DMA) {
+		result = doca_mmap_export_pci(rx->mmap, rx->dev, &desc, &desc_len);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to export receive buffer memory map: %s", doca_error_get_descr(result));
+			return result;
+		}
+	} else {
+		desc = rx->shm_name;
+		desc_len = strlen(rx->shm_name) + 1;
+	}
+
+	if (sizeof(*exp_msg) + desc_len > max_msg_len) {
+		DOCA_LOG_ERR("Export descriptor of %zu bytes does not fit in a %u bytes control message",
+			     desc_len,
+			     max_msg_len);
+		return DOCA_ERROR_TOO_BIG;
+	}
+
+	exp_msg->type = htonl(BULK_MSG_EXPORT);
+	exp_msg->desc_len = htonl(desc_len);
+	exp_msg->addr = htonq((uint64_t)rx->buf);
+	exp_msg->len = htonq(rx->len);
+	memcpy(exp_msg->desc, desc, desc_len);
+	*msg_len = sizeof(*exp_msg) + desc_len;
+
+	return DOCA_SUCCESS;
+}
+
+void bulk_receiver_destroy(struct bulk_receiver *rx)
+{
+	doca_error_t result;
+
+	if (rx->buf == NULL)
+		return;
+
+	if (rx->mode == TRANSFER_MODE_DMA) {
+		result = doca_mmap_destroy(rx->mmap);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy receive buffer memory map: %s", doca_error_get_descr(result));
+		free(rx->buf);
+		result = doca_dev_close(rx->dev);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to close device: %s", doca_error_get_descr(result));
+	} else {
+		munmap(rx->buf, rx->len);
+		shm_unlink(rx->shm_name);
+	}
+
+	memset(rx, 0, sizeof(*rx));
+}
+
+/*
+ * DMA memcpy task completed callback
+ *
+ * @dma_task [in]: completed task
+ * @task_user_data [in]: doca_data from the task
+ * @ctx_user_data [in]: doca_data from the context
+ */
+static void bulk_dma_completed_callback(struct doca_dma_task_memcpy *dma_task,
+					union doca_data task_user_data,
+					union doca_data ctx_user_data)
+{
+	struct bulk_sender *tx = (struct bulk_sender *)ctx_user_data.ptr;
+
+	(void)task_user_data;
+
+	doca_buf_dec_refcount((struct doca_buf *)doca_dma_task_memcpy_get_src(dma_task), NULL);
+	doca_buf_dec_refcount(doca_dma_task_memcpy_get_dst(dma_task), NULL);
+	doca_task_free(doca_dma_task_memcpy_as_task(dma_task));
+	--tx->num_inflight;
+}
+
+/*
+ * DMA memcpy task error callback
+ *
+ * @dma_task [in]: failed task
+ * @task_user_data [in]: doca_data from the task
+ * @ctx_user_data [in]: doca_data from the context
+ */
+static void bulk_dma_error_callback(struct doca_dma_task_memcpy *dma_task,
+				    union doca_data task_user_data,
+				    union doca_data ctx_user_data)
+{
+	struct bulk_sender *tx = (struct bulk_sender *)ctx_user_data.ptr;
+	struct doca_task *task = doca_dma_task_memcpy_as_task(dma_task);
+
+	(void)task_user_data;
+
+	if (tx->dma_result == DOCA_SUCCESS)
+		tx->dma_result = doca_task_get_status(task);
+
+	doca_buf_dec_refcount((struct doca_buf *)doca_dma_task_memcpy_get_src(dma_task), NULL);
+	doca_buf_dec_refcount(doca_dma_task_memcpy_get_dst(dma_task), NULL);
+	doca_task_free(task);
+	--tx->num_inflight;
+}
+
+/*
+ * Create the DMA context and import the server receive buffer
+ *
+ * @pci_addr [in]: PCI address of the DMA capable device
+ * @desc [in]: exported mmap descriptor
+ * @desc_len [in]: length of desc
+ * @tx [in/out]: bulk sender, remote_buf and remote_len are already set
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t bulk_sender_init_dma(const char *pci_addr,
+					 const uint8_t *desc,
+					 size_t desc_len,
+					 struct bulk_sender *tx)
+{
+	struct program_core_objects *state = &tx->state;
+	union doca_data ctx_user_data = {0};
+	doca_error_t result;
+
+	result = open_doca_device_with_pci(pci_addr, check_dev_dma_capable, &state->dev);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to open DMA capable device: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Every task in flight holds a source and a destination buffer */
+	result = create_core_objects(state, 2 * BULK_DMA_MAX_INFLIGHT);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create core objects: %s", doca_error_get_descr(result));
+		goto destroy_core_objects;
+	}
+
+	result = doca_dma_cap_task_memcpy_get_max_buf_size(doca_dev_as_devinfo(state->dev), &tx->max_dma_buf_size);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to get DMA memcpy maximum buffer size: %s", doca_error_get_descr(result));
+		goto destroy_core_objects;
+	}
+
+	result = doca_dma_create(state->dev, &tx->dma_ctx);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to create DOCA DMA context: %s", doca_error_get_descr(result));
+		goto destroy_core_objects;
+	}
+	state->ctx = doca_dma_as_ctx(tx->dma_ctx);
+
+	result = doca_pe_connect_ctx(state->pe, state->ctx);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to set DOCA progress engine to DOCA DMA: %s", doca_error_get_descr(result));
+		goto destroy_dma;
+	}
+
+	result = doca_dma_task_memcpy_set_conf(tx->dma_ctx,
+					       bulk_dma_completed_callback,
+					       bulk_dma_error_callback,
+					       BULK_DMA_MAX_INFLIGHT);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to set configurations for DMA memcpy task: %s", doca_error_get_descr(result));
+		goto destroy_dma;
+	}
+
+	ctx_user_data.ptr = tx;
+	doca_ctx_set_user_data(state->ctx, ctx_user_data);
+
+	result = doca_ctx_start(state->ctx);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to start DMA context: %s", doca_error_get_descr(result));
+		goto destroy_dma;
+	}
+
+	result = doca_mmap_create_from_export(NULL, desc, desc_len, state->dev, &tx->remote_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create memory map from export: %s", doca_error_get_descr(result));
+		goto stop_dma;
+	}
+
+	return DOCA_SUCCESS;
+
+stop_dma:
+	request_stop_ctx(state->pe, state->ctx);
+destroy_dma:
+	doca_dma_destroy(tx->dma_ctx);
+	tx->dma_ctx = NULL;
+	state->ctx = NULL;
+destroy_core_objects:
+	destroy_core_objects(state);
+	return result;
+}
+
+/*
+ * Map the shared memory object published by the server
+ *
+ * @desc [in]: shared memory object name
+ * @desc_len [in]: length of desc, including the terminator
+ * @tx [in/out]: bulk sender, remote_len is already set
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t bulk_sender_init_shm(const uint8_t *desc, size_t desc_len, struct bulk_sender *tx)
+{
+	const char *name = (const char *)desc;
+	void *addr;
+	int fd;
+
+	if (desc_len == 0 || desc_len > BULK_SHM_NAME_LEN || name[desc_len - 1] != '\0') {
+		DOCA_LOG_ERR("Malformed shared memory object name in export message");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0) {
+		DOCA_LOG_ERR("Failed to open shared memory object %s: %s", name, strerror(errno));
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	addr = mmap(NULL, tx->remote_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		DOCA_LOG_ERR("Failed to map shared memory object %s: %s", name, strerror(errno));
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	tx->remote_buf = addr;
+	return DOCA_SUCCESS;
+}
+
+doca_error_t bulk_sender_init(enum file_compression_transfer_mode mode,
+			      const char *pci_addr,
+			      const struct bulk_msg_export *msg,
+			      uint32_t msg_len,
+			      struct bulk_sender *tx)
+{
+	uint32_t desc_len;
+
+	memset(tx, 0, sizeof(*tx));
+	tx->mode = mode;
+
+	if (msg_len < sizeof(*msg) || ntohl(msg->type) != BULK_MSG_EXPORT) {
+		DOCA_LOG_ERR("Unexpected export message received");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	desc_len = ntohl(msg->desc_len);
+	if (desc_len != msg_len - sizeof(*msg)) {
+		DOCA_LOG_ERR("Export descriptor length %u does not match message length %u", desc_len, msg_len);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	tx->remote_len = ntohq(msg->len);
+
+	switch (mode) {
+	case TRANSFER_MODE_DMA:
+		tx->remote_buf = (uint8_t *)ntohq(msg->addr);
+		return bulk_sender_init_dma(pci_addr, msg->desc, desc_len, tx);
+	case TRANSFER_MODE_SHM:
+		return bulk_sender_init_shm(msg->desc, desc_len, tx);
+	default:
+		DOCA_LOG_ERR("Transfer mode %s does not use a bulk sender", bulk_transfer_mode_name(mode));
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+}
+
+/*
+ * Submit one DMA memcpy from the local buffer to the server receive buffer
+ *
+ * @tx [in]: bulk sender
+ * @src [in]: local source address, inside the source mmap
+ * @dst [in]: server destination address, inside the remote mmap
+ * @len [in]: number of bytes to copy
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t bulk_dma_submit(struct bulk_sender *tx, uint8_t *src, uint8_t *dst, size_t len)
+{
+	struct program_core_objects *state = &tx->state;
+	struct doca_dma_task_memcpy *dma_task;
+	struct doca_buf *src_buf;
+	struct doca_buf *dst_buf;
+	union doca_data task_user_data = {0};
+	doca_error_t result;
+
+	result = doca_buf_inventory_buf_get_by_data(state->buf_inv, state->src_mmap, src, len, &src_buf);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to acquire DOCA buffer for local data: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = doca_buf_inventory_buf_get_by_addr(state->buf_inv, tx->remote_mmap, dst, len, &dst_buf);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to acquire DOCA buffer for remote data: %s", doca_error_get_descr(result));
+		goto dec_src_buf;
+	}
+
+	result = doca_dma_task_memcpy_alloc_init(tx->dma_ctx, src_buf, dst_buf, task_user_data, &dma_task);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to allocate DMA memcpy task: %s", doca_error_get_descr(result));
+		goto dec_dst_buf;
+	}
+
+	result = doca_task_submit(doca_dma_task_memcpy_as_task(dma_task));
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to submit DMA memcpy task: %s", doca_error_get_descr(result));
+		doca_task_free(doca_dma_task_memcpy_as_task(dma_task));
+		goto dec_dst_buf;
+	}
+
+	tx->num_inflight++;
+	return DOCA_SUCCESS;
+
+dec_dst_buf:
+	doca_buf_dec_refcount(dst_buf, NULL);
+dec_src_buf:
+	doca_buf_dec_refcount(src_buf, NULL);
+	return result;
+}
+
+/*
+ * Write a buffer to the server with a pipeline of large DMA memcpy tasks
+ *
+ * @tx [in]: bulk sender
+ * @data [in]: data to write
+ * @len [in]: data length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t bulk_sender_write_dma(struct bulk_sender *tx, uint8_t *data, uint64_t len)
+{
+	struct program_core_objects *state = &tx->state;
+	uint64_t chunk = MIN(tx->max_dma_buf_size, BULK_DMA_MAX_CHUNK);
+	uint64_t offset = 0;
+	size_t chunk_len;
+	doca_error_t result;
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
+
+	result = doca_mmap_set_memrange(state->src_mmap, data, len);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to set memory range of source memory map: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = doca_mmap_start(state->src_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to start source memory map: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	tx->dma_result = DOCA_SUCCESS;
+	while (offset < len || tx->num_inflight > 0) {
+		if (offset < len && tx->num_inflight < BULK_DMA_MAX_INFLIGHT && tx->dma_result == DOCA_SUCCESS) {
+			chunk_len = MIN(chunk, len - offset);
+			result = bulk_dma_submit(tx, data + offset, tx->remote_buf + offset, chunk_len);
+			if (result != DOCA_SUCCESS) {
+				tx->dma_result = result;
+				offset = len;
+				continue;
+			}
+			offset += chunk_len;
+			continue;
+		}
+
+		/* Stop submitting after the first failure and drain what is in flight */
+		if (tx->dma_result != DOCA_SUCCESS)
+			offset = len;
+
+		if (doca_pe_progress(state->pe) == 0)
+			nanosleep(&ts, &ts);
+	}
+
+	if (tx->dma_result != DOCA_SUCCESS)
+		DOCA_LOG_ERR("DMA write to the server failed: %s", doca_error_get_descr(tx->dma_result));
+
+	return tx->dma_result;
+}
+
+doca_error_t bulk_sender_write(struct bulk_sender *tx, uint8_t *data, uint64_t len)
+{
+	if (len > tx->remote_len) {
+		DOCA_LOG_ERR("File of %" PRIu64 " bytes exceeds the server buffer of %" PRIu64 " bytes",
+			     len,
+			     tx->remote_len);
+		return DOCA_ERROR_TOO_BIG;
+	}
+
+	if (tx->mode == TRANSFER_MODE_DMA)
+		return bulk_sender_write_dma(tx, data, len);
+
+	memcpy(tx->remote_buf, data, len);
+	return DOCA_SUCCESS;
+}
+
+void bulk_sender_destroy(struct bulk_sender *tx)
+{
+	struct program_core_objects *state = &tx->state;
+	doca_error_t result;
+
+	if (tx->mode == TRANSFER_MODE_SHM) {
+		if (tx->remote_buf != NULL)
+			munmap(tx->remote_buf, tx->remote_len);
+		memset(tx, 0, sizeof(*tx));
+		return;
+	}
+
+	if (tx->remote_mmap != NULL) {
+		result = doca_mmap_destroy(tx->remote_mmap);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy remote memory map: %s", doca_error_get_descr(result));
+	}
+
+	if (state->ctx != NULL) {
+		result = request_stop_ctx(state->pe, state->ctx);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Unable to stop DMA context: %s", doca_error_get_descr(result));
+		state->ctx = NULL;
+	}
+
+	if (tx->dma_ctx != NULL) {
+		result = doca_dma_destroy(tx->dma_ctx);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy DOCA DMA context: %s", doca_error_get_descr(result));
+	}
+
+	result = destroy_core_objects(state);
+	if (result != DOCA_SUCCESS)
+		DOCA_LOG_ERR("Failed to destroy DOCA core objects: %s", doca_error_get_descr(result));
+
+	memset(tx, 0, sizeof(*tx));
+}
+
+doca_error_t bulk_ctrl_init(const char *name, bool is_server, int timeout, struct bulk_ctrl *ctrl)
+{
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+	};
+	size_t name_len = strlen(name);
+	socklen_t addr_len;
+	int num_attempts = MAX(timeout, 1) * (1000 * 1000 * 1000 / BULK_CTRL_RETRY_NANOS);
+	struct timespec ts = {
+		.tv_nsec = BULK_CTRL_RETRY_NANOS,
+	};
+	int fd;
+
+	ctrl->fd = -1;
+
+	/* Abstract socket address, the leading zero byte keeps the name out of the file system */
+	if (name_len + 1 > sizeof(addr.sun_path)) {
+		DOCA_LOG_ERR("Control channel name %s is too long", name);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	memcpy(addr.sun_path + 1, name, name_len);
+	addr_len = offsetof(struct sockaddr_un, sun_path) + 1 + name_len;
+
+	ctrl->buf = malloc(BULK_CTRL_MAX_MSG + 1);
+	if (ctrl->buf == NULL) {
+		DOCA_LOG_ERR("Failed to allocate control channel receive buffer");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+	if (fd < 0) {
+		DOCA_LOG_ERR("Failed to create control channel socket: %s", strerror(errno));
+		goto free_buf;
+	}
+
+	if (is_server) {
+		if (bind(fd, (struct sockaddr *)&addr, addr_len) < 0 || listen(fd, 1) < 0) {
+			DOCA_LOG_ERR("Failed to listen on control channel %s: %s", name, strerror(errno));
+			goto close_fd;
+		}
+
+		DOCA_LOG_INFO("Server waiting on a client to connect");
+		ctrl->fd = accept(fd, NULL, NULL);
+		if (ctrl->fd < 0) {
+			DOCA_LOG_ERR("Failed to accept control channel connection: %s", strerror(errno));
+			goto close_fd;
+		}
+		close(fd);
+	} else {
+		while (connect(fd, (struct sockaddr *)&addr, addr_len) < 0) {
+			if ((errno != ECONNREFUSED && errno != ENOENT) || --num_attempts == 0) {
+				DOCA_LOG_ERR("Failed to connect to control channel %s: %s", name, strerror(errno));
+				goto close_fd;
+			}
+			nanosleep(&ts, &ts);
+		}
+		ctrl->fd = fd;
+	}
+
+	/* Progress polls the socket, it must never block */
+	if (fcntl(ctrl->fd, F_SETFL, fcntl(ctrl->fd, F_GETFL) | O_NONBLOCK) < 0) {
+		DOCA_LOG_ERR("Failed to set control channel socket non blocking: %s", strerror(errno));
+		fd = ctrl->fd;
+		ctrl->fd = -1;
+		goto close_fd;
+	}
+
+	return DOCA_SUCCESS;
+
+close_fd:
+	close(fd);
+free_buf:
+	free(ctrl->buf);
+	ctrl->buf = NULL;
+	return DOCA_ERROR_IO_FAILED;
+}
+
+doca_error_t bulk_ctrl_send(struct bulk_ctrl *ctrl, const void *msg, uint32_t len)
+{
+	ssize_t ret;
+
+	if (len > BULK_CTRL_MAX_MSG) {
+		DOCA_LOG_ERR("Control message of %u bytes exceeds the maximum of %u", len, BULK_CTRL_MAX_MSG);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	ret = send(ctrl->fd, msg, len, MSG_NOSIGNAL);
+	if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		return DOCA_ERROR_AGAIN;
+	if (ret != (ssize_t)len) {
+		DOCA_LOG_ERR("Failed to send control message: %s", strerror(errno));
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+doca_error_t bulk_ctrl_progress(struct bulk_ctrl *ctrl, bulk_ctrl_recv_cb_t recv_cb, void *user_data)
+{
+	bool received = false;
+	ssize_t ret;
+
+	while (true) {
+		ret = recv(ctrl->fd, ctrl->buf, BULK_CTRL_MAX_MSG, 0);
+		if (ret > 0) {
+			recv_cb(ctrl->buf, ret, user_data);
+			received = true;
+			continue;
+		}
+
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return DOCA_SUCCESS;
+
+		/* The peer closing is only reported once the messages it sent before are handled */
+		if (ret == 0 && received)
+			return DOCA_SUCCESS;
+
+		DOCA_LOG_ERR("Control channel closed: %s", (ret == 0) ? "peer disconnected" : strerror(errno));
+		return DOCA_ERROR_CONNECTION_ABORTED;
+	}
+}
+
+void bulk_ctrl_destroy(struct bulk_ctrl *ctrl)
+{
+	if (ctrl->fd >= 0)
+		close(ctrl->fd);
+	ctrl->fd = -1;
+	free(ctrl->buf);
+	ctrl->buf = NULL;
+}
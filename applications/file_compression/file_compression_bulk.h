@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef FILE_COMPRESSION_BULK_H_
+#define FILE_COMPRESSION_BULK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <doca_dev.h>
+#include <doca_dma.h>
+#include <doca_error.h>
+#include <doca_mmap.h>
+
+#include <samples/common.h>
+
+#define BULK_SHM_NAME_LEN 64	 /* Maximum shared memory object name length, including the terminator */
+#define BULK_CTRL_MAX_MSG 4080 /* Maximum control message length on the local control channel */
+
+/* Data path used to move the compressed file from the client to the server */
+enum file_compression_transfer_mode {
+	TRANSFER_MODE_COMCH, /* File data is carried in comch messages */
+	TRANSFER_MODE_DMA,   /* File data is written with DOCA DMA into a buffer exported by the server */
+	TRANSFER_MODE_SHM,   /* File data is written into a shared memory object published by the server */
+};
+
+/* Control messages of the bulk transfer modes, all fields are sent in network byte order */
+enum bulk_msg_type {
+	BULK_MSG_EXPORT = 1, /* Server publishes its receive buffer */
+	BULK_MSG_DONE = 2,   /* Client has written the file into the receive buffer */
+};
+
+struct bulk_msg_export {
+	uint32_t type;	   /* BULK_MSG_EXPORT */
+	uint32_t desc_len; /* Length of the descriptor that follows */
+	uint64_t addr;	   /* Server address of the receive buffer */
+	uint64_t len;	   /* Length of the receive buffer */
+	uint8_t desc[];	   /* Exported mmap (DMA) or shared memory object name (SHM) */
+};
+
+struct bulk_msg_done {
+	uint32_t type;	   /* BULK_MSG_DONE */
+	uint32_t status;   /* Zero if the file was written, non zero otherwise */
+	uint64_t file_len; /* Number of bytes written to the receive buffer */
+	uint64_t checksum; /* Checksum of the file */
+};
+
+/* Server side of a bulk transfer, owns the buffer the client writes into */
+struct bulk_receiver {
+	enum file_compression_transfer_mode mode; /* TRANSFER_MODE_DMA or TRANSFER_MODE_SHM */
+	struct doca_dev *dev;			  /* Device the buffer is exported through (DMA) */
+	struct doca_mmap *mmap;			  /* Mmap exported to the client (DMA) */
+	char shm_name[BULK_SHM_NAME_LEN];	  /* Shared memory object name (SHM) */
+	uint8_t *buf;				  /* Receive buffer */
+	uint64_t len;				  /* Receive buffer length */
+};
+
+/* Client side of a bulk transfer */
+struct bulk_sender {
+	enum file_compression_transfer_mode mode; /* TRANSFER_MODE_DMA or TRANSFER_MODE_SHM */
+	struct program_core_objects state;	  /* DMA device, local mmap, inventory and progress engine (DMA) */
+	struct doca_dma *dma_ctx;		  /* DMA context (DMA) */
+	struct doca_mmap *remote_mmap;		  /* Mmap created from the server export (DMA) */
+	uint64_t max_dma_buf_size;		  /* Largest single DMA memcpy supported (DMA) */
+	uint32_t num_inflight;			  /* DMA memcpy tasks not yet completed (DMA) */
+	doca_error_t dma_result;		  /* First DMA memcpy error seen (DMA) */
+	uint8_t *remote_buf;			  /* Server buffer address (DMA) or local view of it (SHM) */
+	uint64_t remote_len;			  /* Server buffer length */
+};
+
+/*
+ * Local stand-in for the comch control path, used in SHM mode where the client and the server run on the same host
+ * and comch, which pairs a host with a DPU, cannot connect them
+ */
+struct bulk_ctrl {
+	int fd;	      /* Connected UNIX socket, -1 if not connected */
+	uint8_t *buf; /* Receive buffer, one byte larger than the maximal message for the receiver to terminate it */
+};
+
+/*
+ * Control message receive callback of the local control channel
+ *
+ * @recv_buffer [in]: message data, one byte past msg_len may be written
+ * @msg_len [in]: number of bytes in recv_buffer
+ * @user_data [in]: user data given to bulk_ctrl_progress()
+ */
+typedef void (*bulk_ctrl_recv_cb_t)(uint8_t *recv_buffer, uint32_t msg_len, void *user_data);
+
+/*
+ * Parse a transfer mode name
+ *
+ * @name [in]: "comch", "dma" or "shm"
+ * @mode [out]: parsed transfer mode
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_transfer_mode_parse(const char *name, enum file_compression_transfer_mode *mode);
+
+/*
+ * Get the name of a transfer mode
+ *
+ * @mode [in]: transfer mode
+ * @return: transfer mode name
+ */
+const char *bulk_transfer_mode_name(enum file_compression_transfer_mode mode);
+
+/*
+ * Allocate the server receive buffer and make it reachable by the client
+ *
+ * @mode [in]: bulk transfer mode
+ * @pci_addr [in]: PCI address of the device used to export the buffer (DMA only)
+ * @len [in]: receive buffer length
+ * @rx [out]: bulk receiver to initialize
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_receiver_init(enum file_compression_transfer_mode mode,
+				const char *pci_addr,
+				uint64_t len,
+				struct bulk_receiver *rx);
+
+/*
+ * Build the export message describing the receive buffer
+ *
+ * @rx [in]: bulk receiver
+ * @msg [out]: buffer to build the message in
+ * @max_msg_len [in]: size of msg, usually the maximal comch message size
+ * @msg_len [out]: length of the built message
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_receiver_export(struct bulk_receiver *rx, uint8_t *msg, uint32_t max_msg_len, uint32_t *msg_len);
+
+/*
+ * Release the receive buffer and everything exporting it
+ *
+ * @rx [in]: bulk receiver
+ */
+void bulk_receiver_destroy(struct bulk_receiver *rx);
+
+/*
+ * Attach to the receive buffer described by a server export message
+ *
+ * @mode [in]: bulk transfer mode
+ * @pci_addr [in]: PCI address of the DMA capable device (DMA only)
+ * @msg [in]: export message received from the server
+ * @msg_len [in]: length of msg
+ * @tx [out]: bulk sender to initialize
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_sender_init(enum file_compression_transfer_mode mode,
+			      const char *pci_addr,
+			      const struct bulk_msg_export *msg,
+			      uint32_t msg_len,
+			      struct bulk_sender *tx);
+
+/*
+ * Write a buffer to the start of the server receive buffer and wait until it is complete
+ *
+ * @tx [in]: bulk sender
+ * @data [in]: data to write
+ * @len [in]: data length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_sender_write(struct bulk_sender *tx, uint8_t *data, uint64_t len);
+
+/*
+ * Detach from the server receive buffer and release the sender resources
+ *
+ * @tx [in]: bulk sender
+ */
+void bulk_sender_destroy(struct bulk_sender *tx);
+
+/*
+ * Connect the local control channel, the server waits for a client and the client retries until the server is up
+ *
+ * @name [in]: channel name, both sides must use the same name
+ * @is_server [in]: true to accept the connection, false to initiate it
+ * @timeout [in]: number of seconds the client keeps retrying to connect
+ * @ctrl [out]: control channel to initialize
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_ctrl_init(const char *name, bool is_server, int timeout, struct bulk_ctrl *ctrl);
+
+/*
+ * Send a message on the local control channel
+ *
+ * @ctrl [in]: control channel
+ * @msg [in]: message to send
+ * @len [in]: message length, up to BULK_CTRL_MAX_MSG bytes
+ * @return: DOCA_SUCCESS on success, DOCA_ERROR_AGAIN if the socket is full and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_ctrl_send(struct bulk_ctrl *ctrl, const void *msg, uint32_t len);
+
+/*
+ * Deliver all pending control messages to the receive callback
+ *
+ * @ctrl [in]: control channel
+ * @recv_cb [in]: callback invoked for each message
+ * @user_data [in]: user data passed to recv_cb
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t bulk_ctrl_progress(struct bulk_ctrl *ctrl, bulk_ctrl_recv_cb_t recv_cb, void *user_data);
+
+/*
+ * Close the local control channel
+ *
+ * @ctrl [in]: control channel
+ */
+void bulk_ctrl_destroy(struct bulk_ctrl *ctrl);
+
+#endif /* FILE_COMPRESSION_BULK_H_ */
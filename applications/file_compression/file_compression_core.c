@@ -67,6 +67,8 @@ static doca_error_t get_compress_max_buf_size(struct compress_resources *resourc
 
 	if (resources->mode == COMPRESS_MODE_COMPRESS_DEFLATE)
 		result = doca_compress_cap_task_compress_deflate_get_max_buf_size(compress_dev_info, max_buf_size);
+	else if (resources->mode == COMPRESS_MODE_DECOMPRESS_LZ4_STREAM)
+		result = doca_compress_cap_task_decompress_lz4_stream_get_max_buf_size(compress_dev_info, max_buf_size);
 	else
 		result = doca_compress_cap_task_decompress_deflate_get_max_buf_size(compress_dev_info, max_buf_size);
 
@@ -82,16 +84,21 @@ static doca_error_t get_compress_max_buf_size(struct compress_resources *resourc
  * Allocate DOCA compress needed resources with 2 buffers
  *
  * @mode [in]: Running mode
+ * @codec [in]: Codec the file is compressed with
  * @resources [out]: DOCA compress resources pointer
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t get_compress_resources(enum file_compression_mode mode, struct compress_resources *resources)
+static doca_error_t get_compress_resources(enum file_compression_mode mode,
+					   enum file_compression_codec codec,
+					   struct compress_resources *resources)
 {
 	uint32_t max_bufs = 2;
 	doca_error_t result;
 
 	if (mode == CLIENT)
 		resources->mode = COMPRESS_MODE_COMPRESS_DEFLATE;
+	else if (codec == COMPRESS_CODEC_LZ4)
+		resources->mode = COMPRESS_MODE_DECOMPRESS_LZ4_STREAM;
 	else
 		resources->mode = COMPRESS_MODE_DECOMPRESS_DEFLATE;
 
@@ -121,14 +128,32 @@ static doca_error_t init_compress_resources(struct file_compression_config *comp
 	/* Default is to use HW compress */
 	*method = COMPRESS_DEFLATE_HW;
 
+	if (compress_cfg->codec == COMPRESS_CODEC_LZ4 && !lz4_sw_is_supported()) {
+		DOCA_LOG_ERR("LZ4 codec requires the application to be built with liblz4");
+		return DOCA_ERROR_NOT_SUPPORTED;
+	}
+
+	/* DOCA Compress has no LZ4 compress task, the client compresses LZ4 blocks in parallel in SW */
+	if (compress_cfg->mode == CLIENT && compress_cfg->codec == COMPRESS_CODEC_LZ4) {
+		resources->mode = COMPRESS_MODE_COMPRESS_DEFLATE;
+		*method = COMPRESS_DEFLATE_SW;
+		*max_buf_size = SW_MAX_FILE_SIZE;
+		return DOCA_SUCCESS;
+	}
+
 	/* Allocate compress resources */
-	result = get_compress_resources(compress_cfg->mode, resources);
+	result = get_compress_resources(compress_cfg->mode, compress_cfg->codec, resources);
 	if (result != DOCA_SUCCESS) {
 		if (resources->mode == COMPRESS_MODE_COMPRESS_DEFLATE) {
 			DOCA_LOG_INFO("Failed to find device for compress task, running SW compress with zlib");
 			*method = COMPRESS_DEFLATE_SW;
 			*max_buf_size = SW_MAX_FILE_SIZE;
 			result = DOCA_SUCCESS;
+		} else if (resources->mode == COMPRESS_MODE_DECOMPRESS_LZ4_STREAM) {
+			DOCA_LOG_INFO("Failed to find device for LZ4 decompress task, running SW decompress");
+			*method = COMPRESS_DEFLATE_SW;
+			*max_buf_size = SW_MAX_FILE_SIZE;
+			result = DOCA_SUCCESS;
 		} else if (resources->mode == COMPRESS_MODE_DECOMPRESS_DEFLATE)
 			DOCA_LOG_ERR("Failed to allocate compress resources: %s", doca_error_get_descr(result));
 	} else {
@@ -202,6 +227,44 @@ static doca_error_t populate_dst_buf(struct program_core_objects *state,
 	return result;
 }
 
+/*
+ * Strip the LZ4 frame header and decompress its blocks with the DOCA Compress LZ4 stream task
+ *
+ * @resources [in]: DOCA compress resources
+ * @src_doca_buf [in]: buffer holding the LZ4 frame
+ * @dst_doca_buf [in]: buffer to decompress into
+ * @output_chksum [out]: CRC checksum of the decompressed data
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t decompress_lz4_frame_hw(struct compress_resources *resources,
+					    struct doca_buf *src_doca_buf,
+					    struct doca_buf *dst_doca_buf,
+					    uint64_t *output_chksum)
+{
+	struct compress_cfg lz4_cfg = {0};
+	uint32_t crc;
+	doca_error_t result;
+
+	result = parse_lz4_frame(src_doca_buf, &lz4_cfg, NULL, NULL);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to parse LZ4 frame: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = submit_decompress_lz4_stream_task(resources,
+						   lz4_cfg.has_block_checksum,
+						   lz4_cfg.are_blocks_independent,
+						   src_doca_buf,
+						   dst_doca_buf,
+						   &crc,
+						   NULL);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	*output_chksum = crc;
+	return DOCA_SUCCESS;
+}
+
 /*
  * Allocate DOCA compress resources and submit compress/decompress task
  *
@@ -271,6 +334,8 @@ static doca_error_t compress_file_hw(char *file_data,
 
 	if (resources->mode == COMPRESS_MODE_COMPRESS_DEFLATE)
 		result = submit_compress_deflate_task(resources, src_doca_buf, dst_doca_buf, output_chksum);
+	else if (resources->mode == COMPRESS_MODE_DECOMPRESS_LZ4_STREAM)
+		result = decompress_lz4_frame_hw(resources, src_doca_buf, dst_doca_buf, output_chksum);
 	else
 		result = submit_decompress_deflate_task(resources, src_doca_buf, dst_doca_buf, output_chksum);
 	if (result != DOCA_SUCCESS) {
@@ -381,6 +446,44 @@ static void calculate_checksum_sw(char *file_data, size_t file_size, uint64_t *o
 	*output_chksum = result_checksum;
 }
 
+/*
+ * Calculate the checksum of an LZ4 transfer with zlib. The LZ4 stream task only reports a CRC, so the upper
+ * 32 bits are left zero.
+ *
+ * @file_data [in]: file data to the source buffer
+ * @file_size [in]: file size
+ * @output_chksum [out]: the calculated checksum
+ */
+static void calculate_lz4_checksum_sw(const uint8_t *file_data, size_t file_size, uint64_t *output_chksum)
+{
+	uint32_t crc;
+
+	crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, file_data, file_size);
+
+	*output_chksum = crc;
+}
+
+/*
+ * Compress the input file into an LZ4 frame on the client, blocks are compressed in parallel with liblz4
+ *
+ * @file_data [in]: file data to compress
+ * @file_size [in]: file size
+ * @compressed_file [out]: allocated LZ4 frame
+ * @compressed_file_len [out]: LZ4 frame length
+ * @output_chksum [out]: the calculated checksum
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t compress_file_lz4(char *file_data,
+				      size_t file_size,
+				      uint8_t **compressed_file,
+				      size_t *compressed_file_len,
+				      uint64_t *output_chksum)
+{
+	calculate_lz4_checksum_sw((const uint8_t *)file_data, file_size, output_chksum);
+	return lz4_frame_compress((const uint8_t *)file_data, file_size, compressed_file, compressed_file_len);
+}
+
 /*
  * Compress / decompress the input file data
  *
@@ -389,6 +492,7 @@ static void calculate_checksum_sw(char *file_data, size_t file_size, uint64_t *o
  * @max_buf_size [in]: maximum compress buffer size allowed
  * @resources [in]: DOCA compress resources
  * @method [in]: Compression method to be used
+ * @codec [in]: Codec the file is compressed with
  * @compressed_file [out]: destination buffer with the result
  * @compressed_file_len [out]: destination buffer size
  * @output_chksum [out]: the calculated checksum
@@ -399,19 +503,28 @@ static doca_error_t compress_file(char *file_data,
 				  uint64_t max_buf_size,
 				  struct compress_resources *resources,
 				  enum file_compression_compress_method method,
+				  enum file_compression_codec codec,
 				  uint8_t **compressed_file,
 				  size_t *compressed_file_len,
 				  uint64_t *output_chksum)
 {
 	size_t dst_buf_size = 0;
+	doca_error_t result;
 
 	enum compress_mode;
 
+	/* The LZ4 frame is sized by the compressor, the other paths write into a preallocated buffer */
+	if (resources->mode == COMPRESS_MODE_COMPRESS_DEFLATE && codec == COMPRESS_CODEC_LZ4) {
+		*compressed_file = NULL;
+		return compress_file_lz4(file_data, file_size, compressed_file, compressed_file_len, output_chksum);
+	}
+
 	if (resources->mode == COMPRESS_MODE_COMPRESS_DEFLATE) {
 		dst_buf_size = MAX(file_size + 16, file_size * 2);
 		if (dst_buf_size > max_buf_size)
 			dst_buf_size = max_buf_size;
-	} else if (resources->mode == COMPRESS_MODE_DECOMPRESS_DEFLATE)
+	} else if (resources->mode == COMPRESS_MODE_DECOMPRESS_DEFLATE ||
+		   resources->mode == COMPRESS_MODE_DECOMPRESS_LZ4_STREAM)
 		dst_buf_size = MIN(max_buf_size, DECOMPRESS_RATIO * file_size);
 
 	*compressed_file = calloc(1, dst_buf_size);
@@ -420,7 +533,16 @@ static doca_error_t compress_file(char *file_data,
 		return DOCA_ERROR_NO_MEMORY;
 	}
 
-	if (method == COMPRESS_DEFLATE_SW) {
+	if (method == COMPRESS_DEFLATE_SW && codec == COMPRESS_CODEC_LZ4) {
+		result = lz4_frame_decompress((const uint8_t *)file_data,
+					      file_size,
+					      *compressed_file,
+					      dst_buf_size,
+					      compressed_file_len);
+		if (result == DOCA_SUCCESS)
+			calculate_lz4_checksum_sw(*compressed_file, *compressed_file_len, output_chksum);
+		return result;
+	} else if (method == COMPRESS_DEFLATE_SW) {
 		calculate_checksum_sw(file_data, file_size, output_chksum);
 		return compress_file_sw(file_data, file_size, dst_buf_size, compressed_file, compressed_file_len);
 	} else
@@ -433,6 +555,120 @@ static doca_error_t compress_file(char *file_data,
 					output_chksum);
 }
 
+/*
+ * Log the throughput of a file transfer
+ *
+ * @mode [in]: transfer mode the file was moved with
+ * @len [in]: number of bytes transferred
+ * @start [in]: time the transfer started
+ * @end [in]: time the transfer ended
+ */
+static void report_throughput(enum file_compression_transfer_mode mode,
+			      uint64_t len,
+			      const struct timespec *start,
+			      const struct timespec *end)
+{
+	double secs = (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+
+	if (secs <= 0)
+		secs = 1e-9;
+
+	DOCA_LOG_INFO("Transferred %" PRIu64 " bytes over %s in %.3f ms, %.2f MB/s",
+		      len,
+		      bulk_transfer_mode_name(mode),
+		      secs * 1e3,
+		      len / secs / 1e6);
+}
+
+/*
+ * Log the ratio and throughput of a codec run, throughput is measured on the uncompressed size so that
+ * runs of different codecs over the same file can be compared
+ *
+ * @compress_cfg [in]: application config struct
+ * @compressed_len [in]: compressed size
+ * @uncompressed_len [in]: uncompressed size
+ * @start [in]: time the codec started
+ * @end [in]: time the codec ended
+ */
+static void report_codec(struct file_compression_config *compress_cfg,
+			 uint64_t compressed_len,
+			 uint64_t uncompressed_len,
+			 const struct timespec *start,
+			 const struct timespec *end)
+{
+	double secs = (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+
+	if (secs <= 0)
+		secs = 1e-9;
+	if (compressed_len == 0)
+		compressed_len = 1;
+
+	DOCA_LOG_INFO("%s %s (%s): %" PRIu64 " -> %" PRIu64 " bytes, ratio %.3f, %.3f ms, %.2f MB/s",
+		      (compress_cfg->mode == CLIENT) ? "Compressed" : "Decompressed",
+		      compress_codec_name(compress_cfg->codec),
+		      (compress_cfg->compress_method == COMPRESS_DEFLATE_HW) ? "HW" : "SW",
+		      (compress_cfg->mode == CLIENT) ? uncompressed_len : compressed_len,
+		      (compress_cfg->mode == CLIENT) ? compressed_len : uncompressed_len,
+		      (double)uncompressed_len / compressed_len,
+		      secs * 1e3,
+		      uncompressed_len / secs / 1e6);
+}
+
+static void client_recv_msg(uint8_t *recv_buffer, uint32_t msg_len, void *user_data);
+static void server_recv_msg(uint8_t *recv_buffer, uint32_t msg_len, void *user_data);
+
+/*
+ * Send a control message to the peer, over comch or over the local control channel in SHM mode
+ *
+ * @compress_cfg [in]: compression configuration information
+ * @comch_cfg [in]: comch configuration object, NULL in SHM mode
+ * @msg [in]: message to send
+ * @len [in]: message length
+ * @return: DOCA_SUCCESS on success, DOCA_ERROR_AGAIN if the message should be resent and DOCA_ERROR otherwise
+ */
+static doca_error_t ctrl_send(struct file_compression_config *compress_cfg,
+			      struct comch_cfg *comch_cfg,
+			      const void *msg,
+			      uint32_t len)
+{
+	if (compress_cfg->transfer_mode == TRANSFER_MODE_SHM)
+		return bulk_ctrl_send(&compress_cfg->ctrl, msg, len);
+
+	return comch_utils_send(comch_util_get_connection(comch_cfg), msg, len);
+}
+
+/*
+ * Handle pending control messages from the peer
+ *
+ * @compress_cfg [in]: compression configuration information
+ * @comch_cfg [in]: comch configuration object, NULL in SHM mode
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t ctrl_progress(struct file_compression_config *compress_cfg, struct comch_cfg *comch_cfg)
+{
+	if (compress_cfg->transfer_mode == TRANSFER_MODE_SHM)
+		return bulk_ctrl_progress(&compress_cfg->ctrl,
+					  (compress_cfg->mode == CLIENT) ? client_recv_msg : server_recv_msg,
+					  compress_cfg);
+
+	return comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+}
+
+/*
+ * Get the maximal control message size
+ *
+ * @compress_cfg [in]: compression configuration information
+ * @comch_cfg [in]: comch configuration object, NULL in SHM mode
+ * @return: maximal control message size
+ */
+static uint32_t ctrl_get_max_msg_size(struct file_compression_config *compress_cfg, struct comch_cfg *comch_cfg)
+{
+	if (compress_cfg->transfer_mode == TRANSFER_MODE_SHM)
+		return BULK_CTRL_MAX_MSG;
+
+	return comch_utils_get_max_buffer_size(comch_cfg);
+}
+
 /*
  * Send the input file with comch to the server in segments of max_comch_msg length
  *
@@ -452,9 +688,11 @@ static doca_error_t send_file(struct file_compression_config *compress_cfg,
 	struct file_info_message file_meta = {};
 	uint32_t max_comch_msg;
 	uint32_t total_msgs;
+	size_t total_len = file_size;
 	size_t msg_len;
 	uint32_t i;
 	doca_error_t result;
+	struct timespec start, end;
 	struct timespec ts = {
 		.tv_nsec = SLEEP_IN_NANOS,
 	};
@@ -477,6 +715,7 @@ static doca_error_t send_file(struct file_compression_config *compress_cfg,
 	}
 
 	/* Send file to the server */
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	for (i = 0; i < total_msgs; i++) {
 		/* Stop sending if the server is done receiving */
 		if (compress_cfg->state == TRANSFER_COMPLETE)
@@ -499,18 +738,109 @@ static doca_error_t send_file(struct file_compression_config *compress_cfg,
 		file_data += msg_len;
 		file_size -= msg_len;
 	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	report_throughput(compress_cfg->transfer_mode, total_len, &start, &end);
+
 	return DOCA_SUCCESS;
 }
 
-void client_recv_event_cb(struct doca_comch_event_msg_recv *event,
-			  uint8_t *recv_buffer,
-			  uint32_t msg_len,
-			  struct doca_comch_connection *comch_connection)
+/*
+ * Write the input file directly into the receive buffer exported by the server, comch only carries the buffer
+ * descriptor and the completion
+ *
+ * @compress_cfg [in]: compression configuration information
+ * @comch_cfg [in]: comch configuration object for the control messages, NULL in SHM mode
+ * @file_data [in]: file data to the source buffer
+ * @file_size [in]: file size
+ * @checksum [in]: checksum of the file
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t send_file_bulk(struct file_compression_config *compress_cfg,
+				   struct comch_cfg *comch_cfg,
+				   uint8_t *file_data,
+				   size_t file_size,
+				   uint64_t checksum)
 {
-	struct file_compression_config *cfg = comch_utils_get_user_data(comch_connection);
+	struct bulk_msg_done done_msg = {};
+	struct bulk_sender tx;
+	struct timespec start = {0}, end = {0};
+	doca_error_t result, tmp_result;
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
 
-	/* A message is only expected from the server when it has read the compressed file successfully */
-	(void)event;
+	/* The server exports its receive buffer as soon as the connection is established */
+	while (compress_cfg->bulk_export == NULL) {
+		if (compress_cfg->state == TRANSFER_COMPLETE || compress_cfg->state == TRANSFER_ERROR) {
+			DOCA_LOG_ERR("Server did not export a receive buffer");
+			return DOCA_ERROR_BAD_STATE;
+		}
+
+		nanosleep(&ts, &ts);
+		result = ctrl_progress(compress_cfg, comch_cfg);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Control connection unexpectedly dropped: %s", doca_error_get_descr(result));
+			return result;
+		}
+	}
+
+	result = bulk_sender_init(compress_cfg->transfer_mode,
+				  compress_cfg->cc_dev_pci_addr,
+				  (struct bulk_msg_export *)compress_cfg->bulk_export,
+				  compress_cfg->bulk_export_len,
+				  &tx);
+	if (result == DOCA_SUCCESS) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		result = bulk_sender_write(&tx, file_data, file_size);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		bulk_sender_destroy(&tx);
+	}
+
+	/* Report failures too so the server does not wait for a file that never arrives */
+	done_msg.type = htonl(BULK_MSG_DONE);
+	done_msg.status = htonl(result != DOCA_SUCCESS);
+	done_msg.file_len = htonq(file_size);
+	done_msg.checksum = htonq(checksum);
+
+	tmp_result = ctrl_send(compress_cfg, comch_cfg, &done_msg, sizeof(done_msg));
+	if (tmp_result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to send transfer done message: %s", doca_error_get_descr(tmp_result));
+		DOCA_ERROR_PROPAGATE(result, tmp_result);
+	}
+
+	if (result == DOCA_SUCCESS)
+		report_throughput(compress_cfg->transfer_mode, file_size, &start, &end);
+
+	return result;
+}
+
+/*
+ * Handle a control message received by the client
+ *
+ * @recv_buffer [in]: array of bytes containing the message data
+ * @msg_len [in]: number of bytes in the recv_buffer
+ * @user_data [in]: application config struct
+ */
+static void client_recv_msg(uint8_t *recv_buffer, uint32_t msg_len, void *user_data)
+{
+	struct file_compression_config *cfg = (struct file_compression_config *)user_data;
+
+	/* In bulk modes the server first exports the buffer the file should be written into */
+	if (cfg->transfer_mode != TRANSFER_MODE_COMCH && cfg->bulk_export == NULL &&
+	    msg_len >= sizeof(struct bulk_msg_export) &&
+	    ntohl(((struct bulk_msg_export *)recv_buffer)->type) == BULK_MSG_EXPORT) {
+		cfg->bulk_export = malloc(msg_len);
+		if (cfg->bulk_export == NULL) {
+			DOCA_LOG_ERR("Failed to allocate export message");
+			cfg->state = TRANSFER_ERROR;
+			return;
+		}
+		memcpy(cfg->bulk_export, recv_buffer, msg_len);
+		cfg->bulk_export_len = msg_len;
+		return;
+	}
+
+	/* Any other message is only expected from the server when it has read the compressed file successfully */
 
 	/* Print the completion message sent from the server */
 	recv_buffer[msg_len] = '\0';
@@ -518,6 +848,16 @@ void client_recv_event_cb(struct doca_comch_event_msg_recv *event,
 	cfg->state = TRANSFER_COMPLETE;
 }
 
+void client_recv_event_cb(struct doca_comch_event_msg_recv *event,
+			  uint8_t *recv_buffer,
+			  uint32_t msg_len,
+			  struct doca_comch_connection *comch_connection)
+{
+	(void)event;
+
+	client_recv_msg(recv_buffer, msg_len, comch_utils_get_user_data(comch_connection));
+}
+
 doca_error_t file_compression_client(struct comch_cfg *comch_cfg,
 				     struct file_compression_config *compress_cfg,
 				     struct compress_resources *resources)
@@ -529,6 +869,7 @@ doca_error_t file_compression_client(struct comch_cfg *comch_cfg,
 	size_t compressed_file_len;
 	uint64_t checksum;
 	doca_error_t result;
+	struct timespec start, end;
 	struct timespec ts = {
 		.tv_nsec = SLEEP_IN_NANOS,
 	};
@@ -561,11 +902,13 @@ doca_error_t file_compression_client(struct comch_cfg *comch_cfg,
 
 	DOCA_LOG_TRC("File size: %ld", statbuf.st_size);
 	/* Send compress task */
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	result = compress_file(file_data,
 			       statbuf.st_size,
 			       compress_cfg->max_compress_file_len,
 			       resources,
 			       compress_cfg->compress_method,
+			       compress_cfg->codec,
 			       &compressed_file,
 			       &compressed_file_len,
 			       &checksum);
@@ -574,11 +917,16 @@ doca_error_t file_compression_client(struct comch_cfg *comch_cfg,
 		free(compressed_file);
 		return result;
 	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
 	close(fd);
+	report_codec(compress_cfg, compressed_file_len, statbuf.st_size, &start, &end);
 	DOCA_LOG_TRC("Compressed file size: %ld", compressed_file_len);
 
 	/* Send the file content to the server */
-	result = send_file(compress_cfg, comch_cfg, (char *)compressed_file, compressed_file_len, checksum);
+	if (compress_cfg->transfer_mode == TRANSFER_MODE_COMCH)
+		result = send_file(compress_cfg, comch_cfg, (char *)compressed_file, compressed_file_len, checksum);
+	else
+		result = send_file_bulk(compress_cfg, comch_cfg, compressed_file, compressed_file_len, checksum);
 	if (result != DOCA_SUCCESS) {
 		free(compressed_file);
 		return result;
@@ -588,9 +936,9 @@ doca_error_t file_compression_client(struct comch_cfg *comch_cfg,
 	/* Wait for a signal that the transfer has complete */
 	while (compress_cfg->state != TRANSFER_COMPLETE) {
 		nanosleep(&ts, &ts);
-		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+		result = ctrl_progress(compress_cfg, comch_cfg);
 		if (result != DOCA_SUCCESS) {
-			DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+			DOCA_LOG_ERR("Control connection unexpectedly dropped: %s", doca_error_get_descr(result));
 			return result;
 		}
 	}
@@ -598,16 +946,18 @@ doca_error_t file_compression_client(struct comch_cfg *comch_cfg,
 	return result;
 }
 
-void server_recv_event_cb(struct doca_comch_event_msg_recv *event,
-			  uint8_t *recv_buffer,
-			  uint32_t msg_len,
-			  struct doca_comch_connection *comch_connection)
+/*
+ * Handle a control or file data message received by the server
+ *
+ * @recv_buffer [in]: array of bytes containing the message data
+ * @msg_len [in]: number of bytes in the recv_buffer
+ * @user_data [in]: application config struct
+ */
+static void server_recv_msg(uint8_t *recv_buffer, uint32_t msg_len, void *user_data)
 {
-	struct file_compression_config *cfg = comch_utils_get_user_data(comch_connection);
+	struct file_compression_config *cfg = (struct file_compression_config *)user_data;
 	struct server_runtime_data *server_data;
 
-	(void)event;
-
 	if (cfg == NULL) {
 		DOCA_LOG_ERR("Cannot get configuration information");
 		return;
@@ -619,6 +969,40 @@ void server_recv_event_cb(struct doca_comch_event_msg_recv *event,
 
 	server_data = &cfg->server_data;
 
+	/* In bulk modes the file is already in the receive buffer, comch only reports its length and checksum */
+	if (cfg->transfer_mode != TRANSFER_MODE_COMCH) {
+		struct bulk_msg_done *done_msg = (struct bulk_msg_done *)recv_buffer;
+		uint64_t file_len;
+
+		if (msg_len != sizeof(struct bulk_msg_done) || ntohl(done_msg->type) != BULK_MSG_DONE) {
+			DOCA_LOG_ERR("Unexpected transfer done message received. Size %u, expected size %lu",
+				     msg_len,
+				     sizeof(struct bulk_msg_done));
+			cfg->state = TRANSFER_ERROR;
+			return;
+		}
+
+		if (ntohl(done_msg->status) != 0) {
+			DOCA_LOG_ERR("Client failed to write the file into the receive buffer");
+			cfg->state = TRANSFER_ERROR;
+			return;
+		}
+
+		file_len = ntohq(done_msg->file_len);
+		if (file_len == 0 || file_len > server_data->bulk_rx.len) {
+			DOCA_LOG_ERR("Invalid received file length %lu, receive buffer size: %lu",
+				     file_len,
+				     server_data->bulk_rx.len);
+			cfg->state = TRANSFER_ERROR;
+			return;
+		}
+
+		server_data->received_file_length = file_len;
+		server_data->expected_checksum = ntohq(done_msg->checksum);
+		cfg->state = TRANSFER_COMPLETE;
+		return;
+	}
+
 	/* First received message should contain file metadata */
 	if (server_data->expected_file_chunks == 0) {
 		struct file_info_message *file_info = (struct file_info_message *)recv_buffer;
@@ -644,13 +1028,60 @@ void server_recv_event_cb(struct doca_comch_event_msg_recv *event,
 		cfg->state = TRANSFER_ERROR;
 		return;
 	}
+	if (server_data->received_file_chunks == 0)
+		clock_gettime(CLOCK_MONOTONIC, &server_data->transfer_start);
+
 	memcpy(server_data->compressed_file + server_data->received_file_length, recv_buffer, msg_len);
 
 	server_data->received_file_chunks += 1;
 	server_data->received_file_length += msg_len;
 
-	if (server_data->received_file_chunks == server_data->expected_file_chunks)
+	if (server_data->received_file_chunks == server_data->expected_file_chunks) {
+		struct timespec end;
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		report_throughput(cfg->transfer_mode,
+				  server_data->received_file_length,
+				  &server_data->transfer_start,
+				  &end);
 		cfg->state = TRANSFER_COMPLETE;
+	}
+}
+
+void server_recv_event_cb(struct doca_comch_event_msg_recv *event,
+			  uint8_t *recv_buffer,
+			  uint32_t msg_len,
+			  struct doca_comch_connection *comch_connection)
+{
+	(void)event;
+
+	server_recv_msg(recv_buffer, msg_len, comch_utils_get_user_data(comch_connection));
+}
+
+/*
+ * Send the client the descriptor of the buffer it should write the file into
+ *
+ * @comch_cfg [in]: comch object to use for control messages, NULL in SHM mode
+ * @compress_cfg [in]: application config struct
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t server_export_receive_buffer(struct comch_cfg *comch_cfg,
+						 struct file_compression_config *compress_cfg)
+{
+	uint32_t max_comch_msg = ctrl_get_max_msg_size(compress_cfg, comch_cfg);
+	uint8_t export_msg[max_comch_msg];
+	uint32_t export_msg_len;
+	doca_error_t result;
+
+	result = bulk_receiver_export(&compress_cfg->server_data.bulk_rx, export_msg, max_comch_msg, &export_msg_len);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = ctrl_send(compress_cfg, comch_cfg, export_msg, export_msg_len);
+	if (result != DOCA_SUCCESS)
+		DOCA_LOG_ERR("Failed to send export message: %s", doca_error_get_descr(result));
+
+	return result;
 }
 
 doca_error_t file_compression_server(struct comch_cfg *comch_cfg,
@@ -665,6 +1096,7 @@ doca_error_t file_compression_server(struct comch_cfg *comch_cfg,
 	size_t data_len;
 	int counter = 0;
 	int num_of_iterations = (compress_cfg->timeout * 1000 * 1000) / (SLEEP_IN_NANOS / 1000);
+	struct timespec start, end;
 	struct timespec ts = {
 		.tv_nsec = SLEEP_IN_NANOS,
 	};
@@ -672,12 +1104,18 @@ doca_error_t file_compression_server(struct comch_cfg *comch_cfg,
 
 	server_data = (struct server_runtime_data *)&compress_cfg->server_data;
 
-	/* Wait on comch to complete client to server transactions */
+	if (compress_cfg->transfer_mode != TRANSFER_MODE_COMCH) {
+		result = server_export_receive_buffer(comch_cfg, compress_cfg);
+		if (result != DOCA_SUCCESS)
+			goto finish_msg;
+	}
+
+	/* Wait on the control path to complete client to server transactions */
 	while (compress_cfg->state != TRANSFER_COMPLETE && compress_cfg->state != TRANSFER_ERROR) {
 		nanosleep(&ts, &ts);
-		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+		result = ctrl_progress(compress_cfg, comch_cfg);
 		if (result != DOCA_SUCCESS) {
-			DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+			DOCA_LOG_ERR("Control connection unexpectedly dropped: %s", doca_error_get_descr(result));
 			return result;
 		}
 
@@ -698,11 +1136,13 @@ doca_error_t file_compression_server(struct comch_cfg *comch_cfg,
 		goto finish_msg;
 	}
 
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	result = compress_file(server_data->compressed_file,
 			       server_data->received_file_length,
 			       compress_cfg->max_compress_file_len,
 			       resources,
 			       compress_cfg->compress_method,
+			       compress_cfg->codec,
 			       &resp_head,
 			       &data_len,
 			       &checksum);
@@ -711,6 +1151,8 @@ doca_error_t file_compression_server(struct comch_cfg *comch_cfg,
 		free(resp_head);
 		goto finish_msg;
 	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	report_codec(compress_cfg, server_data->received_file_length, data_len, &start, &end);
 	if (checksum == server_data->expected_checksum)
 		DOCA_LOG_INFO("SUCCESS: file was received and decompressed successfully");
 	else {
@@ -741,7 +1183,7 @@ doca_error_t file_compression_server(struct comch_cfg *comch_cfg,
 	close(fd);
 
 finish_msg:
-	if (comch_utils_send(comch_util_get_connection(comch_cfg), finish_msg, sizeof(finish_msg)) != DOCA_SUCCESS)
+	if (ctrl_send(compress_cfg, comch_cfg, finish_msg, sizeof(finish_msg)) != DOCA_SUCCESS)
 		DOCA_LOG_ERR("Failed to send finish message: %s", doca_error_get_descr(result));
 
 	return result;
@@ -763,13 +1205,25 @@ doca_error_t file_compression_init(struct file_compression_config *compress_cfg,
 		return result;
 
 	/* Server should preallocate memory to receive a file */
-	if (compress_cfg->mode == SERVER) {
+	if (compress_cfg->mode == SERVER && compress_cfg->transfer_mode == TRANSFER_MODE_COMCH) {
 		compress_cfg->server_data.compressed_file = calloc(1, compress_cfg->max_compress_file_len);
 		if (compress_cfg->server_data.compressed_file == NULL) {
 			DOCA_LOG_ERR("Failed to allocate file memory");
 			(void)destroy_compress_resources(resources);
 			return DOCA_ERROR_NO_MEMORY;
 		}
+	} else if (compress_cfg->mode == SERVER) {
+		/* In bulk modes the client writes the file straight into a buffer reachable from its side */
+		result = bulk_receiver_init(compress_cfg->transfer_mode,
+					    compress_cfg->cc_dev_pci_addr,
+					    compress_cfg->max_compress_file_len,
+					    &compress_cfg->server_data.bulk_rx);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to allocate bulk receive buffer: %s", doca_error_get_descr(result));
+			(void)destroy_compress_resources(resources);
+			return result;
+		}
+		compress_cfg->server_data.compressed_file = (char *)compress_cfg->server_data.bulk_rx.buf;
 	}
 
 	return DOCA_SUCCESS;
@@ -786,8 +1240,14 @@ void file_compression_cleanup(struct file_compression_config *compress_cfg, stru
 		DOCA_LOG_ERR("Failed to destroy compress resources: %s", doca_error_get_descr(result));
 
 	if (compress_cfg->mode == SERVER) {
-		free(compress_cfg->server_data.compressed_file);
+		if (compress_cfg->transfer_mode == TRANSFER_MODE_COMCH)
+			free(compress_cfg->server_data.compressed_file);
+		else
+			bulk_receiver_destroy(&compress_cfg->server_data.bulk_rx);
 		compress_cfg->server_data.compressed_file = NULL;
+	} else {
+		free(compress_cfg->bulk_export);
+		compress_cfg->bulk_export = NULL;
 	}
 }
 
@@ -877,6 +1337,50 @@ static doca_error_t timeout_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * ARGP Callback - Handle transfer mode parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t transfer_mode_callback(void *param, void *config)
+{
+	struct file_compression_config *compress_cfg = (struct file_compression_config *)config;
+
+	return bulk_transfer_mode_parse((char *)param, &compress_cfg->transfer_mode);
+}
+
+/*
+ * ARGP Callback - Handle codec parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t codec_callback(void *param, void *config)
+{
+	struct file_compression_config *compress_cfg = (struct file_compression_config *)config;
+
+	return compress_codec_parse((char *)param, &compress_cfg->codec);
+}
+
+/*
+ * ARGP Callback - Handle server role parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t server_callback(void *param, void *config)
+{
+	struct file_compression_config *compress_cfg = (struct file_compression_config *)config;
+
+	if (*(bool *)param)
+		compress_cfg->mode = SERVER;
+	return DOCA_SUCCESS;
+}
+
 /*
  * ARGP validation Callback - check if the running mode is valid and that the input file exists in client mode
  *
@@ -890,10 +1394,18 @@ static doca_error_t args_validation_callback(void *cfg)
 	if (compress_cfg->mode == CLIENT && (access(compress_cfg->file_path, F_OK) == -1)) {
 		DOCA_LOG_ERR("File was not found %s", compress_cfg->file_path);
 		return DOCA_ERROR_NOT_FOUND;
-	} else if (compress_cfg->mode == SERVER && strlen(compress_cfg->cc_dev_rep_pci_addr) == 0) {
+	} else if (compress_cfg->mode == SERVER && compress_cfg->transfer_mode != TRANSFER_MODE_SHM &&
+		   strlen(compress_cfg->cc_dev_rep_pci_addr) == 0) {
 		DOCA_LOG_ERR("Missing representor PCI address for server");
 		return DOCA_ERROR_NOT_FOUND;
 	}
+#ifdef DOCA_ARCH_HOST
+	/* Comch and DMA pair the host with the DPU, only SHM can run both sides on the host */
+	if (compress_cfg->mode == SERVER && compress_cfg->transfer_mode != TRANSFER_MODE_SHM) {
+		DOCA_LOG_ERR("Running the server on the host requires the shm transfer mode");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+#endif
 	return DOCA_SUCCESS;
 }
 
@@ -902,6 +1414,9 @@ doca_error_t register_file_compression_params(void)
 	doca_error_t result;
 
 	struct doca_argp_param *dev_pci_addr_param, *rep_pci_addr_param, *file_param, *timeout_param;
+	struct doca_argp_param *transfer_mode_param;
+	struct doca_argp_param *codec_param;
+	struct doca_argp_param *server_param;
 
 	/* Create and register pci param */
 	result = doca_argp_param_create(&dev_pci_addr_param);
@@ -974,6 +1489,60 @@ doca_error_t register_file_compression_params(void)
 		return result;
 	}
 
+	/* Create and register transfer mode */
+	result = doca_argp_param_create(&transfer_mode_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(transfer_mode_param, "m");
+	doca_argp_param_set_long_name(transfer_mode_param, "transfer-mode");
+	doca_argp_param_set_description(transfer_mode_param,
+					"File data path {comch, dma, shm}, shm runs both sides on one host");
+	doca_argp_param_set_callback(transfer_mode_param, transfer_mode_callback);
+	doca_argp_param_set_type(transfer_mode_param, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(transfer_mode_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register codec */
+	result = doca_argp_param_create(&codec_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(codec_param, "c");
+	doca_argp_param_set_long_name(codec_param, "codec");
+	doca_argp_param_set_description(codec_param,
+					"Compression codec {deflate, lz4}, client and server must use the same codec");
+	doca_argp_param_set_callback(codec_param, codec_callback);
+	doca_argp_param_set_type(codec_param, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(codec_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register server role */
+	result = doca_argp_param_create(&server_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(server_param, "s");
+	doca_argp_param_set_long_name(server_param, "server");
+	doca_argp_param_set_description(server_param,
+					"Run as the server on the host, only with the shm transfer mode");
+	doca_argp_param_set_callback(server_param, server_callback);
+	doca_argp_param_set_type(server_param, DOCA_ARGP_TYPE_BOOLEAN);
+	result = doca_argp_register_param(server_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	/* Register version callback for DOCA SDK & RUNTIME */
 	result = doca_argp_register_version_callback(sdk_version_callback);
 	if (result != DOCA_SUCCESS) {
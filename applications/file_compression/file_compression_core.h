@@ -26,12 +26,16 @@
 #ifndef FILE_COMPRESSION_CORE_H_
 #define FILE_COMPRESSION_CORE_H_
 
+#include <time.h>
+
 #include <doca_buf.h>
 #include <doca_buf_inventory.h>
 #include <doca_ctx.h>
 #include <doca_compress.h>
 
 #include "comch_utils.h"
+#include "file_compression_bulk.h"
+#include "file_compression_lz4.h"
 
 #include <samples/common.h>
 #include <samples/doca_compress/compress_common.h>
@@ -46,7 +50,7 @@ enum file_compression_mode {
 /* File compression compress method */
 enum file_compression_compress_method {
 	COMPRESS_DEFLATE_HW, /* Compress file using DOCA Compress library */
-	COMPRESS_DEFLATE_SW  /* Compress file using zlib */
+	COMPRESS_DEFLATE_SW  /* Compress file in software, zlib for deflate and liblz4 for LZ4 */
 };
 
 /* State of the file transfer on the doca comch control path */
@@ -58,11 +62,13 @@ enum transfer_state {
 };
 
 struct server_runtime_data {
-	uint64_t expected_checksum;    /* Expected checksum of transferred file */
-	uint32_t expected_file_chunks; /* Number of chunks file should be sent in */
-	uint32_t received_file_chunks; /* Current number of chunks received */
-	uint32_t received_file_length; /* Current length of file data received */
-	char *compressed_file;	       /* File received on server */
+	uint64_t expected_checksum;	/* Expected checksum of transferred file */
+	uint32_t expected_file_chunks;	/* Number of chunks file should be sent in */
+	uint32_t received_file_chunks;	/* Current number of chunks received */
+	uint32_t received_file_length;	/* Current length of file data received */
+	char *compressed_file;		/* File received on server */
+	struct timespec transfer_start; /* Time the first file chunk was received on comch */
+	struct bulk_receiver bulk_rx;	/* Receive buffer the client writes into in bulk transfer modes */
 };
 
 /* File compression configuration struct */
@@ -74,8 +80,13 @@ struct file_compression_config {
 	int timeout;						  /* Application timeout in seconds */
 	enum file_compression_compress_method compress_method;	  /* Whether to run compress with HW or SW */
 	uint64_t max_compress_file_len;				  /* Max supported length of compress file */
-	struct server_runtime_data server_data; /* Data populated on server side during file transmission */
-	enum transfer_state state;		/* Indicator of completion of a file transfer */
+	struct server_runtime_data server_data;		   /* Data populated on server side during file transmission */
+	enum transfer_state state;			   /* Indicator of completion of a file transfer */
+	enum file_compression_transfer_mode transfer_mode; /* Data path used for the compressed file */
+	uint8_t *bulk_export;				   /* Export message received by the client in bulk modes */
+	uint32_t bulk_export_len;			   /* Length of the export message */
+	enum file_compression_codec codec;		   /* Codec the file is compressed with */
+	struct bulk_ctrl ctrl;				   /* Control channel replacing comch in SHM mode */
 };
 
 /*
@@ -98,7 +109,7 @@ void file_compression_cleanup(struct file_compression_config *compress_cfg, stru
 /*
  * Run client logic
  *
- * @comch_cfg [in]: comch object to use for control messages
+ * @comch_cfg [in]: comch object to use for control messages, NULL in SHM mode
  * @compress_cfg [in]: application config struct
  * @resources [in]: DOCA compress resources pointer
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
@@ -110,7 +121,7 @@ doca_error_t file_compression_client(struct comch_cfg *comch_cfg,
 /*
  * Run server logic
  *
- * @comch_cfg [in]: comch object to use for control messages
+ * @comch_cfg [in]: comch object to use for control messages, NULL in SHM mode
  * @compress_cfg [in]: application config struct
  * @resources [in]: DOCA compress resources pointer
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
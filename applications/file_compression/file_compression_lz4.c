@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#include <lz4frame.h>
+#endif
+
+#include <doca_log.h>
+
+#include <utils.h>
+
+#include "file_compression_lz4.h"
+
+#define LZ4_BLOCK_HEADER_LEN 4		 /* Little endian size that precedes every block */
+#define LZ4_BLOCK_UNCOMPRESSED (1U << 31) /* Block size flag of a block stored as is */
+#define LZ4_END_MARK_LEN 4		 /* Zero block size that ends the frame */
+
+DOCA_LOG_REGISTER(FILE_COMPRESSION::LZ4);
+
+doca_error_t compress_codec_parse(const char *name, enum file_compression_codec *codec)
+{
+	if (strcmp(name, "deflate") == 0)
+		*codec = COMPRESS_CODEC_DEFLATE;
+	else if (strcmp(name, "lz4") == 0)
+		*codec = COMPRESS_CODEC_LZ4;
+	else {
+		DOCA_LOG_ERR("Unknown codec %s, expected deflate or lz4", name);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	return DOCA_SUCCESS;
+}
+
+const char *compress_codec_name(enum file_compression_codec codec)
+{
+	switch (codec) {
+	case COMPRESS_CODEC_DEFLATE:
+		return "deflate";
+	case COMPRESS_CODEC_LZ4:
+		return "lz4";
+	}
+	return "unknown";
+}
+
+#ifdef HAVE_LZ4
+
+/* Range of blocks compressed by one thread */
+struct lz4_block_job {
+	const uint8_t *src;    /* Data to compress */
+	size_t src_len;	       /* Data length */
+	uint8_t *staging;      /* Compressed blocks, one bound sized slot per block */
+	size_t slot_size;      /* Size of a staging slot */
+	uint32_t *block_sizes; /* Stored size of each block, with the uncompressed flag when stored as is */
+	uint32_t first_block;  /* First block of the range */
+	uint32_t num_blocks;   /* Number of blocks in the range */
+};
+
+/*
+ * Compress a range of independent blocks, a block that does not shrink is stored as is
+ *
+ * @arg [in]: struct lz4_block_job describing the range
+ * @return: NULL
+ */
+static void *lz4_compress_blocks(void *arg)
+{
+	struct lz4_block_job *job = (struct lz4_block_job *)arg;
+	const uint8_t *block;
+	uint8_t *slot;
+	uint32_t i, idx;
+	int block_len, compressed_len;
+
+	for (i = 0; i < job->num_blocks; i++) {
+		idx = job->first_block + i;
+		block = job->src + (size_t)idx * LZ4_FRAME_BLOCK_SIZE;
+		block_len = MIN(job->src_len - (size_t)idx * LZ4_FRAME_BLOCK_SIZE, LZ4_FRAME_BLOCK_SIZE);
+		slot = job->staging + (size_t)idx * job->slot_size;
+
+		compressed_len = LZ4_compress_default((const char *)block, (char *)slot, block_len, job->slot_size);
+		if (compressed_len > 0 && compressed_len < block_len) {
+			job->block_sizes[idx] = compressed_len;
+		} else {
+			memcpy(slot, block, block_len);
+			job->block_sizes[idx] = block_len | LZ4_BLOCK_UNCOMPRESSED;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Write a 32 bit value in little endian order
+ *
+ * @dst [in]: destination
+ * @value [in]: value to write
+ */
+static void lz4_write_le32(uint8_t *dst, uint32_t value)
+{
+	dst[0] = value;
+	dst[1] = value >> 8;
+	dst[2] = value >> 16;
+	dst[3] = value >> 24;
+}
+
+/*
+ * Write the LZ4 frame header of a frame of independent 64 KB blocks without checksums
+ *
+ * @dst [in]: destination, at least LZ4F_HEADER_SIZE_MAX bytes
+ * @header_len [out]: header length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t lz4_write_frame_header(uint8_t *dst, size_t *header_len)
+{
+	LZ4F_preferences_t prefs;
+	LZ4F_cctx *cctx;
+	LZ4F_errorCode_t err;
+	size_t len;
+
+	memset(&prefs, 0, sizeof(prefs));
+	prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+	prefs.frameInfo.blockMode = LZ4F_blockIndependent;
+	prefs.frameInfo.contentChecksumFlag = LZ4F_noContentChecksum;
+	prefs.frameInfo.blockChecksumFlag = LZ4F_noBlockChecksum;
+	prefs.frameInfo.frameType = LZ4F_frame;
+
+	err = LZ4F_createCompressionContext(&cctx, LZ4F_VERSION);
+	if (LZ4F_isError(err)) {
+		DOCA_LOG_ERR("Failed to create LZ4 compression context: %s", LZ4F_getErrorName(err));
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	/* Only the header is taken from the frame API, it also computes the header checksum */
+	len = LZ4F_compressBegin(cctx, dst, LZ4F_HEADER_SIZE_MAX, &prefs);
+	LZ4F_freeCompressionContext(cctx);
+	if (LZ4F_isError(len)) {
+		DOCA_LOG_ERR("Failed to write LZ4 frame header: %s", LZ4F_getErrorName(len));
+		return DOCA_ERROR_UNEXPECTED;
+	}
+
+	*header_len = len;
+	return DOCA_SUCCESS;
+}
+
+bool lz4_sw_is_supported(void)
+{
+	return true;
+}
+
+doca_error_t lz4_frame_compress(const uint8_t *src, size_t src_len, uint8_t **dst, size_t *dst_len)
+{
+	struct lz4_block_job jobs[LZ4_MAX_THREADS];
+	pthread_t threads[LZ4_MAX_THREADS];
+	bool started[LZ4_MAX_THREADS] = {false};
+	uint32_t num_blocks, num_threads, blocks_per_thread, block_len, i;
+	uint32_t *block_sizes;
+	uint8_t *staging, *frame, *pos;
+	size_t slot_size, header_len;
+	long num_cpus;
+	doca_error_t result;
+
+	num_blocks = (src_len + LZ4_FRAME_BLOCK_SIZE - 1) / LZ4_FRAME_BLOCK_SIZE;
+	slot_size = LZ4_compressBound(LZ4_FRAME_BLOCK_SIZE);
+
+	num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	num_threads = MIN(MIN((uint32_t)MAX(num_cpus, 1), LZ4_MAX_THREADS), MAX(num_blocks, 1));
+	blocks_per_thread = (num_blocks + num_threads - 1) / num_threads;
+
+	block_sizes = calloc(MAX(num_blocks, 1), sizeof(*block_sizes));
+	staging = malloc(MAX(num_blocks, 1) * slot_size);
+	/* A stored block is never larger than its source, so the frame fits header, source and block headers */
+	frame = malloc(LZ4F_HEADER_SIZE_MAX + src_len + (size_t)num_blocks * LZ4_BLOCK_HEADER_LEN + LZ4_END_MARK_LEN);
+	if (block_sizes == NULL || staging == NULL || frame == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for LZ4 compression of %u blocks", num_blocks);
+		result = DOCA_ERROR_NO_MEMORY;
+		goto free_frame;
+	}
+
+	result = lz4_write_frame_header(frame, &header_len);
+	if (result != DOCA_SUCCESS)
+		goto free_frame;
+
+	/* Blocks are independent so each thread compresses a contiguous range without sharing state */
+	for (i = 0; i < num_threads; i++) {
+		jobs[i].src = src;
+		jobs[i].src_len = src_len;
+		jobs[i].staging = staging;
+		jobs[i].slot_size = slot_size;
+		jobs[i].block_sizes = block_sizes;
+		jobs[i].first_block = MIN(i * blocks_per_thread, num_blocks);
+		jobs[i].num_blocks = MIN(blocks_per_thread, num_blocks - jobs[i].first_block);
+	}
+
+	/* Rounding up the blocks per thread can leave the last ranges empty, no thread is started for those */
+	for (i = 1; i < num_threads; i++) {
+		if (jobs[i].num_blocks == 0)
+			continue;
+
+		if (pthread_create(&threads[i], NULL, lz4_compress_blocks, &jobs[i]) != 0) {
+			DOCA_LOG_WARN("Failed to create LZ4 compression thread, compressing its blocks inline");
+			lz4_compress_blocks(&jobs[i]);
+			continue;
+		}
+		started[i] = true;
+	}
+	lz4_compress_blocks(&jobs[0]);
+	for (i = 1; i < num_threads; i++) {
+		if (started[i])
+			pthread_join(threads[i], NULL);
+	}
+
+	pos = frame + header_len;
+	for (i = 0; i < num_blocks; i++) {
+		block_len = block_sizes[i] & ~LZ4_BLOCK_UNCOMPRESSED;
+		lz4_write_le32(pos, block_sizes[i]);
+		memcpy(pos + LZ4_BLOCK_HEADER_LEN, staging + (size_t)i * slot_size, block_len);
+		pos += LZ4_BLOCK_HEADER_LEN + block_len;
+	}
+	lz4_write_le32(pos, 0);
+	pos += LZ4_END_MARK_LEN;
+
+	DOCA_LOG_DBG("Compressed %u LZ4 blocks on %u threads", num_blocks, num_threads);
+
+	*dst = frame;
+	*dst_len = pos - frame;
+	frame = NULL;
+
+free_frame:
+	free(frame);
+	free(staging);
+	free(block_sizes);
+	return result;
+}
+
+doca_error_t lz4_frame_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_size, size_t *dst_len)
+{
+	LZ4F_dctx *dctx;
+	LZ4F_errorCode_t err;
+	size_t in_len, out_len, in_pos = 0, out_pos = 0, ret;
+	doca_error_t result = DOCA_SUCCESS;
+
+	err = LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION);
+	if (LZ4F_isError(err)) {
+		DOCA_LOG_ERR("Failed to create LZ4 decompression context: %s", LZ4F_getErrorName(err));
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	do {
+		in_len = src_len - in_pos;
+		out_len = dst_size - out_pos;
+		ret = LZ4F_decompress(dctx, dst + out_pos, &out_len, src + in_pos, &in_len, NULL);
+		if (LZ4F_isError(ret)) {
+			DOCA_LOG_ERR("Failed to decompress LZ4 frame: %s", LZ4F_getErrorName(ret));
+			result = DOCA_ERROR_INVALID_VALUE;
+			break;
+		}
+		in_pos += in_len;
+		out_pos += out_len;
+
+		/* No progress with input left means the output buffer is full */
+		if (ret != 0 && ((in_len == 0 && out_len == 0) || in_pos == src_len)) {
+			DOCA_LOG_ERR("LZ4 frame is truncated or decompresses beyond %zu bytes", dst_size);
+			result = DOCA_ERROR_INVALID_VALUE;
+			break;
+		}
+	} while (ret != 0);
+
+	LZ4F_freeDecompressionContext(dctx);
+
+	*dst_len = out_pos;
+	return result;
+}
+
+#else /* HAVE_LZ4 */
+
+bool lz4_sw_is_supported(void)
+{
+	return false;
+}
+
+doca_error_t lz4_frame_compress(const uint8_t *src, size_t src_len, uint8_t **dst, size_t *dst_len)
+{
+	(void)src;
+	(void)src_len;
+	(void)dst;
+	(void)dst_len;
+
+	DOCA_LOG_ERR("LZ4 compression requires the application to be built with liblz4");
+	return DOCA_ERROR_NOT_SUPPORTED;
+}
+
+doca_error_t lz4_frame_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_size, size_t *dst_len)
+{
+	(void)src;
+	(void)src_len;
+	(void)dst;
+	(void)dst_size;
+	(void)dst_len;
+
+	DOCA_LOG_ERR("LZ4 software decompression requires the application to be built with liblz4");
+	return DOCA_ERROR_NOT_SUPPORTED;
+}
+
+#endif /* HAVE_LZ4 */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef FILE_COMPRESSION_LZ4_H_
+#define FILE_COMPRESSION_LZ4_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <doca_error.h>
+
+#define LZ4_FRAME_BLOCK_SIZE (64 * 1024) /* Uncompressed size of a frame block, matches the 64 KB block size ID */
+#define LZ4_MAX_THREADS 16		 /* Maximum number of threads compressing blocks in parallel */
+
+/* Codec used to compress the file on the client */
+enum file_compression_codec {
+	COMPRESS_CODEC_DEFLATE, /* Raw deflate stream */
+	COMPRESS_CODEC_LZ4,	/* LZ4 frame of independent blocks */
+};
+
+/*
+ * Check if the software LZ4 codec was built in
+ *
+ * @return: true if liblz4 is available
+ */
+bool lz4_sw_is_supported(void);
+
+/*
+ * Compress a buffer into an LZ4 frame of independent blocks. Blocks are compressed in parallel and then
+ * concatenated in order behind the frame header.
+ *
+ * @src [in]: data to compress
+ * @src_len [in]: data length
+ * @dst [out]: allocated frame, to be freed by the caller
+ * @dst_len [out]: frame length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t lz4_frame_compress(const uint8_t *src, size_t src_len, uint8_t **dst, size_t *dst_len);
+
+/*
+ * Decompress an LZ4 frame in software
+ *
+ * @src [in]: LZ4 frame
+ * @src_len [in]: frame length
+ * @dst [in]: buffer to decompress into
+ * @dst_size [in]: size of dst
+ * @dst_len [out]: decompressed length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t lz4_frame_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_size, size_t *dst_len);
+
+/*
+ * Parse codec name
+ *
+ * @name [in]: codec name, "deflate" or "lz4"
+ * @codec [out]: parsed codec
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t compress_codec_parse(const char *name, enum file_compression_codec *codec);
+
+/*
+ * Get codec name
+ *
+ * @codec [in]: codec
+ * @return: codec name
+ */
+const char *compress_codec_name(enum file_compression_codec codec);
+
+#endif /* FILE_COMPRESSION_LZ4_H_ */
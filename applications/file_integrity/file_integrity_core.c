@@ -36,6 +36,7 @@
 #include <doca_mmap.h>
 #include <doca_pe.h>
 
+#include <pack.h>
 #include <utils.h>
 
 #include "file_integrity_core.h"
@@ -44,6 +45,8 @@
 #define DEFAULT_TIMEOUT (10)			  /* default timeout for receiving messages */
 #define SHA_ALGORITHM (DOCA_SHA_ALGORITHM_SHA256) /* doca_sha_algorithm for the sample */
 #define LOG_NUM_SHA_TASKS (0)			  /* Log of SHA tasks number */
+#define MERKLE_MAX_ROUNDS (16)			  /* Rounds of block retransmission before giving up */
+#define MERKLE_PROGRESS_SUFFIX ".merkle"	  /* Suffix of the server progress file */
 
 DOCA_LOG_REGISTER(FILE_INTEGRITY::Core);
 
@@ -265,6 +268,27 @@ static doca_error_t calculate_sha(struct program_core_objects *state,
 	return result;
 }
 
+/*
+ * Check if a block is corrupted on its first transmission, corrupted blocks are spread evenly over the file
+ *
+ * @index [in]: block index
+ * @num_blocks [in]: number of blocks in the file
+ * @num_corrupt [in]: number of blocks to corrupt
+ * @return: true if the block should be corrupted
+ */
+static bool is_corrupted_block(uint32_t index, uint32_t num_blocks, uint32_t num_corrupt)
+{
+	uint32_t stride;
+
+	if (num_corrupt == 0)
+		return false;
+	if (num_corrupt >= num_blocks)
+		return true;
+
+	stride = num_blocks / num_corrupt;
+	return (index % stride) == 0 && (index / stride) < num_corrupt;
+}
+
 /*
  * Send the input file over comch to the server in segments of that can be handled by SHA
  *
@@ -286,6 +310,8 @@ static doca_error_t send_file(struct comch_cfg *comch_cfg,
 			      uint32_t min_partial_block_size)
 {
 	struct file_integrity_metadata_msg *meta_msg;
+	char *corrupt_buf = NULL;
+	char *msg_data;
 	size_t meta_msg_len;
 	uint32_t total_msgs;
 	uint32_t max_comch_msg;
@@ -338,6 +364,15 @@ static doca_error_t send_file(struct comch_cfg *comch_cfg,
 
 	free(meta_msg);
 
+	/* Chunks are corrupted in a copy, the file itself is mapped shared */
+	if (app_cfg->corrupt_blocks != 0) {
+		corrupt_buf = malloc(partial_block_size);
+		if (corrupt_buf == NULL) {
+			DOCA_LOG_ERR("Failed to allocate memory for corrupted chunk");
+			return DOCA_ERROR_NO_MEMORY;
+		}
+	}
+
 	/* Send file to the server */
 	for (i = 0; i < total_msgs; i++) {
 		msg_len = MIN(file_size, partial_block_size);
@@ -346,25 +381,252 @@ static doca_error_t send_file(struct comch_cfg *comch_cfg,
 		if (app_cfg->state == TRANSFER_COMPLETE)
 			break;
 
-		result = comch_utils_send(comch_util_get_connection(comch_cfg), file_data, msg_len);
+		msg_data = file_data;
+		if (is_corrupted_block(i, total_msgs, app_cfg->corrupt_blocks)) {
+			memcpy(corrupt_buf, file_data, msg_len);
+			corrupt_buf[0] ^= 0xff;
+			msg_data = corrupt_buf;
+		}
+
+		result = comch_utils_send(comch_util_get_connection(comch_cfg), msg_data, msg_len);
 		while (result == DOCA_ERROR_AGAIN) {
 			nanosleep(&ts, &ts);
 			result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
 			if (result != DOCA_SUCCESS)
 				break;
-			result = comch_utils_send(comch_util_get_connection(comch_cfg), file_data, msg_len);
+			result = comch_utils_send(comch_util_get_connection(comch_cfg), msg_data, msg_len);
 		}
 
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("File data was not sent: %s", doca_error_get_descr(result));
+			free(corrupt_buf);
 			return result;
 		}
 		file_data += msg_len;
 		file_size -= msg_len;
 	}
+	free(corrupt_buf);
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Send a message over comch, progressing the connection while the send queue is full
+ *
+ * @comch_cfg [in]: comch configuration object to send the message across
+ * @msg [in]: message to send
+ * @len [in]: message length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t comch_send_retry(struct comch_cfg *comch_cfg, const void *msg, uint32_t len)
+{
+	doca_error_t result;
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
+
+	result = comch_utils_send(comch_util_get_connection(comch_cfg), msg, len);
+	while (result == DOCA_ERROR_AGAIN) {
+		nanosleep(&ts, &ts);
+		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+		if (result != DOCA_SUCCESS)
+			break;
+		result = comch_utils_send(comch_util_get_connection(comch_cfg), msg, len);
+	}
+
+	if (result != DOCA_SUCCESS)
+		DOCA_LOG_ERR("Failed to send comch message: %s", doca_error_get_descr(result));
+
+	return result;
+}
+
+/*
+ * Send the input file as Merkle tree blocks and resend the blocks the server reports as missing or corrupted
+ * until every block is verified
+ *
+ * @comch_cfg [in]: comch configuration object to send file across
+ * @app_cfg [in]: app configuration
+ * @state [in]: application core object struct
+ * @sha_ctx [in]: context of SHA library
+ * @file_data [in]: file data to the source buffer
+ * @file_size [in]: file size
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t send_file_merkle(struct comch_cfg *comch_cfg,
+				     struct file_integrity_config *app_cfg,
+				     struct program_core_objects *state,
+				     struct doca_sha *sha_ctx,
+				     char *file_data,
+				     size_t file_size)
+{
+	struct merkle_transfer *merkle = &app_cfg->merkle;
+	struct merkle_msg_meta meta_msg = {};
+	struct merkle_msg_end end_msg = {};
+	struct merkle_msg_leaves *leaves_msg;
+	struct merkle_msg_block *block_msg;
+	struct doca_buf *dst_doca_buf = NULL;
+	struct merkle_sha msha;
+	uint32_t max_comch_msg, leaves_per_msg, count, block_len, i;
+	uint32_t round = 0, blocks_sent = 0, blocks_resent = 0;
+	uint8_t *msg_buf;
+	doca_error_t result;
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
+
+	/* A block travels in a single message and the SHA buffer also hashes pairs of digests */
+	max_comch_msg = comch_utils_get_max_buffer_size(comch_cfg);
+	if (app_cfg->block_size < 2 * MERKLE_DIGEST_LEN ||
+	    max_comch_msg < sizeof(struct merkle_msg_block) + app_cfg->block_size) {
+		DOCA_LOG_ERR("Invalid block size %u, should be at least %u and fit in a %u bytes comch message",
+			     app_cfg->block_size,
+			     2 * MERKLE_DIGEST_LEN,
+			     max_comch_msg);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	msg_buf = malloc(max_comch_msg);
+	if (msg_buf == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for block messages");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	result = populate_dst_buf(state, &dst_doca_buf);
+	if (result != DOCA_SUCCESS)
+		goto free_msg_buf;
+
+	result = merkle_sha_init(&msha, sha_ctx, state, dst_doca_buf, app_cfg->block_size);
+	if (result != DOCA_SUCCESS)
+		goto dec_dst_buf;
+
+	merkle->file_len = file_size;
+	merkle->block_size = app_cfg->block_size;
+	result = merkle_build(&msha, file_data, merkle);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to build Merkle tree: %s", doca_error_get_descr(result));
+		goto free_merkle;
+	}
+	DOCA_LOG_INFO("Merkle tree built over %u blocks of %u bytes", merkle->num_blocks, merkle->block_size);
+
+	meta_msg.type = htonl(MERKLE_MSG_META);
+	meta_msg.block_size = htonl(merkle->block_size);
+	meta_msg.num_blocks = htonl(merkle->num_blocks);
+	meta_msg.file_len = htonq(merkle->file_len);
+	memcpy(meta_msg.root, merkle->root, MERKLE_DIGEST_LEN);
+	result = comch_send_retry(comch_cfg, &meta_msg, sizeof(meta_msg));
+	if (result != DOCA_SUCCESS)
+		goto free_merkle;
+
+	/* The server checks the leaves against the root before trusting them to verify blocks */
+	leaves_msg = (struct merkle_msg_leaves *)msg_buf;
+	leaves_per_msg = (max_comch_msg - sizeof(*leaves_msg)) / MERKLE_DIGEST_LEN;
+	for (i = 0; i < merkle->num_blocks; i += count) {
+		count = MIN(leaves_per_msg, merkle->num_blocks - i);
+		leaves_msg->type = htonl(MERKLE_MSG_LEAVES);
+		leaves_msg->first = htonl(i);
+		leaves_msg->count = htonl(count);
+		memcpy(leaves_msg->digests, merkle->leaves + (size_t)i * MERKLE_DIGEST_LEN, count * MERKLE_DIGEST_LEN);
+		result = comch_send_retry(comch_cfg, leaves_msg, sizeof(*leaves_msg) + count * MERKLE_DIGEST_LEN);
+		if (result != DOCA_SUCCESS)
+			goto free_merkle;
+	}
+
+	/* Every round sends the blocks the server still needs, the first list skips blocks of a resumed transfer */
+	block_msg = (struct merkle_msg_block *)msg_buf;
+	end_msg.type = htonl(MERKLE_MSG_END);
+	while (true) {
+		while (!merkle->round_ready && app_cfg->state != TRANSFER_COMPLETE &&
+		       app_cfg->state != TRANSFER_ERROR) {
+			nanosleep(&ts, &ts);
+			result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+			if (result != DOCA_SUCCESS) {
+				DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+				goto free_merkle;
+			}
+		}
+
+		if (app_cfg->state == TRANSFER_COMPLETE)
+			break;
+
+		if (app_cfg->state == TRANSFER_ERROR || round == MERKLE_MAX_ROUNDS) {
+			DOCA_LOG_ERR("Block transfer failed after %u rounds", round);
+			result = DOCA_ERROR_BAD_STATE;
+			goto free_merkle;
+		}
+
+		merkle->round_ready = false;
+		merkle->need_received = 0;
+
+		for (i = 0; i < merkle->num_blocks; i++) {
+			if (!merkle->blocks[i])
+				continue;
+
+			block_len = merkle_block_len(merkle, i);
+			block_msg->type = htonl(MERKLE_MSG_BLOCK);
+			block_msg->index = htonl(i);
+			memcpy(block_msg->data, file_data + (uint64_t)i * merkle->block_size, block_len);
+			if (round == 0 && is_corrupted_block(i, merkle->num_blocks, app_cfg->corrupt_blocks))
+				block_msg->data[0] ^= 0xff;
+
+			result = comch_send_retry(comch_cfg, block_msg, sizeof(*block_msg) + block_len);
+			if (result != DOCA_SUCCESS)
+				goto free_merkle;
+
+			blocks_sent++;
+			if (round > 0)
+				blocks_resent++;
+		}
+
+		result = comch_send_retry(comch_cfg, &end_msg, sizeof(end_msg));
+		if (result != DOCA_SUCCESS)
+			goto free_merkle;
+		round++;
+	}
+
+	DOCA_LOG_INFO("Block transfer finished: %u blocks sent, %u retransmitted, %u rounds",
+		      blocks_sent,
+		      blocks_resent,
+		      round);
+
+free_merkle:
+	merkle_transfer_free(merkle);
+	merkle_sha_destroy(&msha);
+dec_dst_buf:
+	doca_buf_dec_refcount(dst_doca_buf, NULL);
+free_msg_buf:
+	free(msg_buf);
+	return result;
+}
+
+/*
+ * Handle a list of blocks the server still needs
+ *
+ * @cfg [in]: app configuration
+ * @need_msg [in]: need message received
+ * @msg_len [in]: message length
+ */
+static void client_merkle_need(struct file_integrity_config *cfg, struct merkle_msg_need *need_msg, uint32_t msg_len)
+{
+	struct merkle_transfer *merkle = &cfg->merkle;
+	uint32_t first = ntohl(need_msg->first);
+	uint32_t count = ntohl(need_msg->count);
+
+	if (merkle->blocks == NULL || (uint64_t)first + count > merkle->num_blocks ||
+	    msg_len != sizeof(*need_msg) + count) {
+		DOCA_LOG_ERR("Unexpected need message received. First block %u, count %u, size %u",
+			     first,
+			     count,
+			     msg_len);
+		cfg->state = TRANSFER_ERROR;
+		return;
+	}
+
+	memcpy(merkle->blocks + first, need_msg->need, count);
+	merkle->need_received += count;
+
+	if (ntohl(need_msg->last) != 0)
+		merkle->round_ready = true;
+}
+
 void client_recv_event_cb(struct doca_comch_event_msg_recv *event,
 			  uint8_t *recv_buffer,
 			  uint32_t msg_len,
@@ -372,9 +634,17 @@ void client_recv_event_cb(struct doca_comch_event_msg_recv *event,
 {
 	struct file_integrity_config *cfg = comch_utils_get_user_data(comch_connection);
 
-	/* A message is only expected from the server when it has finished processing the file */
 	(void)event;
 
+	/* In block mode the server lists the blocks it needs before it is done */
+	if (cfg->block_size != 0 && msg_len >= sizeof(struct merkle_msg_need) &&
+	    ntohl(((struct merkle_msg_need *)recv_buffer)->type) == MERKLE_MSG_NEED) {
+		client_merkle_need(cfg, (struct merkle_msg_need *)recv_buffer, msg_len);
+		return;
+	}
+
+	/* Any other message is only expected from the server when it has finished processing the file */
+
 	/* Print the completion message sent from the server */
 	recv_buffer[msg_len] = '\0';
 	DOCA_LOG_INFO("Received message: %s", recv_buffer);
@@ -397,8 +667,11 @@ doca_error_t file_integrity_client(struct comch_cfg *comch_cfg,
 	int fd;
 	uint64_t max_source_buffer_size;
 	uint32_t min_partial_block_size;
+	struct timespec start, end;
 	doca_error_t result;
 
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
 	fd = open(app_cfg->file_path, O_RDWR);
 	if (fd < 0) {
 		DOCA_LOG_ERR("Failed to open %s", app_cfg->file_path);
@@ -429,7 +702,8 @@ doca_error_t file_integrity_client(struct comch_cfg *comch_cfg,
 		return result;
 	}
 
-	if (statbuf.st_size <= 0 || (uint64_t)statbuf.st_size > max_source_buffer_size) {
+	/* Only whole file hashing is bounded by the SHA source buffer size */
+	if (statbuf.st_size <= 0 || (app_cfg->block_size == 0 && (uint64_t)statbuf.st_size > max_source_buffer_size)) {
 		DOCA_LOG_ERR("Invalid file size. Should be greater then zero and smaller than %lu",
 			     max_source_buffer_size);
 		close(fd);
@@ -443,6 +717,19 @@ doca_error_t file_integrity_client(struct comch_cfg *comch_cfg,
 		return DOCA_ERROR_NO_MEMORY;
 	}
 
+	if (app_cfg->block_size != 0) {
+		result = send_file_merkle(comch_cfg, app_cfg, state, sha_ctx, file_data, statbuf.st_size);
+		munmap(file_data, statbuf.st_size);
+		close(fd);
+		if (result != DOCA_SUCCESS)
+			return result;
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		DOCA_LOG_INFO("End-to-end transfer time: %.3f ms",
+			      (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+		return DOCA_SUCCESS;
+	}
+
 	/* Calculate SHA */
 	result = calculate_sha(state, sha_ctx, &dst_doca_buf, file_data, statbuf.st_size);
 	if (result != DOCA_SUCCESS) {
@@ -502,9 +789,239 @@ doca_error_t file_integrity_client(struct comch_cfg *comch_cfg,
 		}
 	}
 
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	DOCA_LOG_INFO("End-to-end transfer time: %.3f ms",
+		      (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+
 	return result;
 }
 
+/*
+ * Build the path of the server progress file
+ *
+ * @cfg [in]: app configuration
+ * @path [out]: progress file path
+ * @path_len [in]: size of path
+ */
+static void merkle_progress_path(struct file_integrity_config *cfg, char *path, size_t path_len)
+{
+	snprintf(path, path_len, "%s%s", cfg->file_path, MERKLE_PROGRESS_SUFFIX);
+}
+
+/*
+ * Handle the Merkle transfer metadata message on the server
+ *
+ * @cfg [in]: app configuration
+ * @meta_msg [in]: metadata message received
+ * @msg_len [in]: message length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t server_merkle_meta(struct file_integrity_config *cfg,
+				       struct merkle_msg_meta *meta_msg,
+				       uint32_t msg_len)
+{
+	struct merkle_transfer *merkle = &cfg->merkle;
+	size_t max_block_size = cfg->server_data.merkle_sha.src_len - sizeof(struct merkle_msg_block);
+	uint64_t file_len;
+	uint32_t block_size, num_blocks;
+
+	if (msg_len != sizeof(*meta_msg) || merkle->leaves != NULL) {
+		DOCA_LOG_ERR("Unexpected Merkle metadata message received. Size %u, expected size %lu",
+			     msg_len,
+			     sizeof(*meta_msg));
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	file_len = ntohq(meta_msg->file_len);
+	block_size = ntohl(meta_msg->block_size);
+	num_blocks = ntohl(meta_msg->num_blocks);
+	if (file_len == 0 || block_size == 0 || block_size > max_block_size ||
+	    num_blocks != (file_len + block_size - 1) / block_size) {
+		DOCA_LOG_ERR("Invalid Merkle layout: file length %lu, block size %u, %u blocks",
+			     file_len,
+			     block_size,
+			     num_blocks);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	merkle->file_len = file_len;
+	merkle->block_size = block_size;
+	merkle->num_blocks = num_blocks;
+	memcpy(merkle->root, meta_msg->root, MERKLE_DIGEST_LEN);
+
+	merkle->leaves = calloc(num_blocks, MERKLE_DIGEST_LEN);
+	merkle->blocks = calloc(num_blocks, 1);
+	if (merkle->leaves == NULL || merkle->blocks == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for %u tree leaves", num_blocks);
+		merkle_transfer_free(merkle);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	DOCA_LOG_INFO("Receiving %lu bytes in %u blocks of %u bytes", file_len, num_blocks, block_size);
+	cfg->state = TRANSFER_IN_PROGRESS;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Handle a range of leaf digests on the server, the complete list is checked against the tree root
+ *
+ * @cfg [in]: app configuration
+ * @leaves_msg [in]: leaves message received
+ * @msg_len [in]: message length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t server_merkle_leaves(struct file_integrity_config *cfg,
+					 struct merkle_msg_leaves *leaves_msg,
+					 uint32_t msg_len)
+{
+	struct merkle_transfer *merkle = &cfg->merkle;
+	char progress_path[MAX_FILE_NAME + sizeof(MERKLE_PROGRESS_SUFFIX)];
+	uint8_t root[MERKLE_DIGEST_LEN];
+	uint32_t first, count;
+	doca_error_t result;
+
+	if (msg_len < sizeof(*leaves_msg) || merkle->leaves == NULL) {
+		DOCA_LOG_ERR("Unexpected Merkle leaves message received");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	first = ntohl(leaves_msg->first);
+	count = ntohl(leaves_msg->count);
+	if (first != merkle->leaves_received || (uint64_t)first + count > merkle->num_blocks ||
+	    msg_len != sizeof(*leaves_msg) + (uint64_t)count * MERKLE_DIGEST_LEN) {
+		DOCA_LOG_ERR("Invalid Merkle leaves message. First leaf %u, count %u, size %u", first, count, msg_len);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	memcpy(merkle->leaves + (size_t)first * MERKLE_DIGEST_LEN, leaves_msg->digests, count * MERKLE_DIGEST_LEN);
+	merkle->leaves_received += count;
+	if (merkle->leaves_received != merkle->num_blocks)
+		return DOCA_SUCCESS;
+
+	result = merkle_root(&cfg->server_data.merkle_sha, merkle->leaves, merkle->num_blocks, root);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	if (memcmp(root, merkle->root, MERKLE_DIGEST_LEN) != 0) {
+		DOCA_LOG_ERR("ERROR: leaf digests do not match the Merkle root");
+		return DOCA_ERROR_BAD_STATE;
+	}
+
+	merkle_progress_path(cfg, progress_path, sizeof(progress_path));
+	result = merkle_progress_open(progress_path, merkle);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	/* Ask for the first round of blocks */
+	merkle->round_ready = true;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Verify a block against its leaf digest on the server and write it to the file if it matches
+ *
+ * @cfg [in]: app configuration
+ * @block_msg [in]: block message received
+ * @msg_len [in]: message length
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t server_merkle_block(struct file_integrity_config *cfg,
+					struct merkle_msg_block *block_msg,
+					uint32_t msg_len)
+{
+	struct merkle_transfer *merkle = &cfg->merkle;
+	uint8_t digest[MERKLE_DIGEST_LEN];
+	uint32_t index, block_len;
+	doca_error_t result;
+
+	if (msg_len < sizeof(*block_msg) || merkle->num_blocks == 0 ||
+	    merkle->leaves_received != merkle->num_blocks) {
+		DOCA_LOG_ERR("Unexpected Merkle block message received");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	index = ntohl(block_msg->index);
+	block_len = msg_len - sizeof(*block_msg);
+	if (index >= merkle->num_blocks || block_len != merkle_block_len(merkle, index)) {
+		DOCA_LOG_ERR("Invalid Merkle block message. Block %u, length %u", index, block_len);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	if (merkle->blocks[index])
+		return DOCA_SUCCESS;
+
+	result = merkle_sha_digest(&cfg->server_data.merkle_sha, block_msg->data, block_len, digest);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	if (memcmp(digest, merkle->leaves + (size_t)index * MERKLE_DIGEST_LEN, MERKLE_DIGEST_LEN) != 0) {
+		DOCA_LOG_WARN("Block %u failed verification, it will be requested again", index);
+		merkle->blocks_failed++;
+		return DOCA_SUCCESS;
+	}
+
+	if ((size_t)pwrite(cfg->server_data.fd, block_msg->data, block_len, (off_t)index * merkle->block_size) !=
+	    block_len) {
+		DOCA_LOG_ERR("Failed to write block %u into the output file", index);
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	merkle_progress_mark(merkle, index);
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Handle a Merkle block transfer message on the server
+ *
+ * @cfg [in]: app configuration
+ * @recv_buffer [in]: array of bytes containing the message data
+ * @msg_len [in]: number of bytes in the recv_buffer
+ */
+static void server_merkle_recv(struct file_integrity_config *cfg, uint8_t *recv_buffer, uint32_t msg_len)
+{
+	struct merkle_transfer *merkle = &cfg->merkle;
+	doca_error_t result;
+
+	cfg->server_data.received_msgs++;
+
+	if (msg_len < sizeof(uint32_t)) {
+		DOCA_LOG_ERR("Unexpected message of %u bytes received", msg_len);
+		cfg->state = TRANSFER_ERROR;
+		return;
+	}
+
+	switch (ntohl(*(uint32_t *)recv_buffer)) {
+	case MERKLE_MSG_META:
+		result = server_merkle_meta(cfg, (struct merkle_msg_meta *)recv_buffer, msg_len);
+		break;
+	case MERKLE_MSG_LEAVES:
+		result = server_merkle_leaves(cfg, (struct merkle_msg_leaves *)recv_buffer, msg_len);
+		break;
+	case MERKLE_MSG_BLOCK:
+		result = server_merkle_block(cfg, (struct merkle_msg_block *)recv_buffer, msg_len);
+		break;
+	case MERKLE_MSG_END:
+		if (merkle->num_blocks == 0 || merkle->leaves_received != merkle->num_blocks) {
+			DOCA_LOG_ERR("Unexpected Merkle round end message received");
+			result = DOCA_ERROR_INVALID_VALUE;
+			break;
+		}
+		/* Either done or ask again for the blocks that failed verification or never arrived */
+		if (merkle->blocks_verified == merkle->num_blocks)
+			cfg->state = TRANSFER_COMPLETE;
+		else
+			merkle->round_ready = true;
+		result = DOCA_SUCCESS;
+		break;
+	default:
+		DOCA_LOG_ERR("Unexpected message type received in block mode");
+		result = DOCA_ERROR_INVALID_VALUE;
+	}
+
+	if (result != DOCA_SUCCESS)
+		cfg->state = TRANSFER_ERROR;
+}
+
 void server_recv_event_cb(struct doca_comch_event_msg_recv *event,
 			  uint8_t *recv_buffer,
 			  uint32_t msg_len,
@@ -532,6 +1049,11 @@ void server_recv_event_cb(struct doca_comch_event_msg_recv *event,
 
 	server_data = &cfg->server_data;
 
+	if (cfg->block_size != 0) {
+		server_merkle_recv(cfg, recv_buffer, msg_len);
+		return;
+	}
+
 	/* First received message should contain file metadata */
 	if (server_data->expected_file_chunks == 0) {
 		struct file_integrity_metadata_msg *file_meta = (struct file_integrity_metadata_msg *)recv_buffer;
@@ -796,6 +1318,170 @@ static void uninit_async_sha_recv_data(struct server_runtime_data *server_data)
 	server_data->fd = 0;
 }
 
+/*
+ * Send the list of blocks the server still needs, in as many messages as required
+ *
+ * @comch_cfg [in]: comch configuration object
+ * @merkle [in]: Merkle transfer
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t server_merkle_send_need(struct comch_cfg *comch_cfg, struct merkle_transfer *merkle)
+{
+	uint32_t max_comch_msg = comch_utils_get_max_buffer_size(comch_cfg);
+	uint32_t per_msg = max_comch_msg - sizeof(struct merkle_msg_need);
+	struct merkle_msg_need *need_msg;
+	uint32_t first, count, i;
+	doca_error_t result = DOCA_SUCCESS;
+
+	need_msg = malloc(max_comch_msg);
+	if (need_msg == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for need message");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	DOCA_LOG_INFO("Requesting %u of %u blocks, %u failed verification so far",
+		      merkle->num_blocks - merkle->blocks_verified,
+		      merkle->num_blocks,
+		      merkle->blocks_failed);
+
+	for (first = 0; first < merkle->num_blocks; first += count) {
+		count = MIN(per_msg, merkle->num_blocks - first);
+		need_msg->type = htonl(MERKLE_MSG_NEED);
+		need_msg->first = htonl(first);
+		need_msg->count = htonl(count);
+		need_msg->last = htonl(first + count == merkle->num_blocks);
+		for (i = 0; i < count; i++)
+			need_msg->need[i] = !merkle->blocks[first + i];
+
+		result = comch_send_retry(comch_cfg, need_msg, sizeof(*need_msg) + count);
+		if (result != DOCA_SUCCESS)
+			break;
+	}
+
+	free(need_msg);
+	return result;
+}
+
+/*
+ * Run server logic in block mode - verify every block against the Merkle tree as it arrives and request the missing
+ * ones until the file is complete. Verified blocks are recorded in a progress file so an interrupted transfer
+ * resumes from them.
+ *
+ * @comch_cfg [in]: comch configuration object
+ * @app_cfg [in]: application config struct
+ * @state [in]: application core object struct
+ * @sha_ctx [in]: context of SHA library
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t file_integrity_server_merkle(struct comch_cfg *comch_cfg,
+						 struct file_integrity_config *app_cfg,
+						 struct program_core_objects *state,
+						 struct doca_sha *sha_ctx)
+{
+	struct server_runtime_data *server_data = &app_cfg->server_data;
+	struct merkle_transfer *merkle = &app_cfg->merkle;
+	struct doca_buf *dst_doca_buf = NULL;
+	char progress_path[MAX_FILE_NAME + sizeof(MERKLE_PROGRESS_SUFFIX)];
+	char finish_msg[] = "Server was done receiving messages";
+	uint32_t last_received_msgs = 0;
+	bool complete = false;
+	int counter = 0;
+	int num_of_iterations = (app_cfg->timeout * 1000 * 1000) / (SLEEP_IN_NANOS / 1000);
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
+	doca_error_t result;
+
+	merkle->progress_fd = -1;
+
+	result = populate_dst_buf(state, &dst_doca_buf);
+	if (result != DOCA_SUCCESS)
+		goto finish_msg;
+
+	/* Blocks land at their own offset and a resumed transfer keeps the verified ones, so do not truncate */
+	server_data->fd = open(app_cfg->file_path, O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR | S_IRGRP);
+	if (server_data->fd < 0) {
+		DOCA_LOG_ERR("Failed to open %s", app_cfg->file_path);
+		result = DOCA_ERROR_IO_FAILED;
+		goto free_dst_buf;
+	}
+
+	result = merkle_sha_init(&server_data->merkle_sha,
+				 sha_ctx,
+				 state,
+				 dst_doca_buf,
+				 comch_utils_get_max_buffer_size(comch_cfg));
+	if (result != DOCA_SUCCESS)
+		goto close_fd;
+
+	/* Wait on comch to complete client to server transactions */
+	while (app_cfg->state != TRANSFER_COMPLETE && app_cfg->state != TRANSFER_ERROR) {
+		nanosleep(&ts, &ts);
+		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Comch connection unexpectedly dropped: %s", doca_error_get_descr(result));
+			goto uninit_merkle;
+		}
+
+		if (merkle->round_ready) {
+			merkle->round_ready = false;
+			result = server_merkle_send_need(comch_cfg, merkle);
+			if (result != DOCA_SUCCESS)
+				goto uninit_merkle;
+		}
+
+		if (app_cfg->state == TRANSFER_IDLE)
+			continue;
+
+		/* The timeout only applies while the client is silent */
+		if (server_data->received_msgs != last_received_msgs) {
+			last_received_msgs = server_data->received_msgs;
+			counter = 0;
+			continue;
+		}
+
+		counter++;
+		if (counter == num_of_iterations) {
+			DOCA_LOG_ERR("Message was not received at the given timeout");
+			result = DOCA_ERROR_BAD_STATE;
+			goto uninit_merkle;
+		}
+	}
+
+	if (app_cfg->state == TRANSFER_ERROR) {
+		DOCA_LOG_ERR("Error detected during comch exchange");
+		result = DOCA_ERROR_BAD_STATE;
+		goto uninit_merkle;
+	}
+
+	/* Drop any leftover of a longer file previously written at the same path */
+	if (ftruncate(server_data->fd, merkle->file_len) < 0) {
+		DOCA_LOG_ERR("Failed to truncate %s: %s", app_cfg->file_path, strerror(errno));
+		result = DOCA_ERROR_IO_FAILED;
+		goto uninit_merkle;
+	}
+
+	DOCA_LOG_INFO("SUCCESS: all %u blocks match the Merkle root, %u blocks failed verification and were resent",
+		      merkle->num_blocks,
+		      merkle->blocks_failed);
+	complete = true;
+
+uninit_merkle:
+	merkle_progress_path(app_cfg, progress_path, sizeof(progress_path));
+	merkle_progress_close(progress_path, merkle, complete);
+	merkle_transfer_free(merkle);
+	merkle_sha_destroy(&server_data->merkle_sha);
+close_fd:
+	close(server_data->fd);
+free_dst_buf:
+	doca_buf_dec_refcount(dst_doca_buf, NULL);
+finish_msg:
+	if (comch_utils_send(comch_util_get_connection(comch_cfg), finish_msg, sizeof(finish_msg)) != DOCA_SUCCESS)
+		DOCA_LOG_ERR("Failed to send finish message: %s", doca_error_get_descr(result));
+
+	return result;
+}
+
 doca_error_t file_integrity_server(struct comch_cfg *comch_cfg,
 				   struct file_integrity_config *app_cfg,
 				   struct program_core_objects *state,
@@ -815,6 +1501,9 @@ doca_error_t file_integrity_server(struct comch_cfg *comch_cfg,
 	};
 	doca_error_t result;
 
+	if (app_cfg->block_size != 0)
+		return file_integrity_server_merkle(comch_cfg, app_cfg, state, sha_ctx);
+
 	result = populate_dst_buf(state, &dst_doca_buf);
 	if (result != DOCA_SUCCESS)
 		goto finish_msg;
@@ -1202,6 +1891,46 @@ static doca_error_t timeout_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * ARGP Callback - Handle block size parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t block_size_callback(void *param, void *config)
+{
+	struct file_integrity_config *app_cfg = (struct file_integrity_config *)config;
+	int *block_size = (int *)param;
+
+	if (*block_size < 0) {
+		DOCA_LOG_ERR("Block size parameter must not be negative");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	app_cfg->block_size = *block_size;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle corrupt blocks parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t corrupt_blocks_callback(void *param, void *config)
+{
+	struct file_integrity_config *app_cfg = (struct file_integrity_config *)config;
+	int *corrupt_blocks = (int *)param;
+
+	if (*corrupt_blocks < 0) {
+		DOCA_LOG_ERR("Corrupt blocks parameter must not be negative");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	app_cfg->corrupt_blocks = *corrupt_blocks;
+	return DOCA_SUCCESS;
+}
+
 /*
  * ARGP validation Callback - check if the running mode is valid and that the input file exists in client mode
  *
@@ -1227,6 +1956,7 @@ doca_error_t register_file_integrity_params(void)
 	doca_error_t result;
 
 	struct doca_argp_param *dev_pci_addr_param, *rep_pci_addr_param, *file_param, *timeout_param;
+	struct doca_argp_param *block_size_param, *corrupt_blocks_param;
 
 	/* Create and register DOCA Comch device PCI address */
 	result = doca_argp_param_create(&dev_pci_addr_param);
@@ -1299,6 +2029,42 @@ doca_error_t register_file_integrity_params(void)
 		return result;
 	}
 
+	/* Create and register block size */
+	result = doca_argp_param_create(&block_size_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(block_size_param, "b");
+	doca_argp_param_set_long_name(block_size_param, "block-size");
+	doca_argp_param_set_description(block_size_param,
+					"Verify Merkle tree blocks of the given size and resend only bad blocks, "
+					"set on both sides (default: 0, hash the whole file)");
+	doca_argp_param_set_callback(block_size_param, block_size_callback);
+	doca_argp_param_set_type(block_size_param, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(block_size_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register corrupt blocks */
+	result = doca_argp_param_create(&corrupt_blocks_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_long_name(corrupt_blocks_param, "corrupt-blocks");
+	doca_argp_param_set_description(corrupt_blocks_param,
+					"Client only, number of blocks to corrupt on their first transmission");
+	doca_argp_param_set_callback(corrupt_blocks_param, corrupt_blocks_callback);
+	doca_argp_param_set_type(corrupt_blocks_param, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(corrupt_blocks_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	/* Register version callback for DOCA SDK & RUNTIME */
 	result = doca_argp_register_version_callback(sdk_version_callback);
 	if (result != DOCA_SUCCESS) {
@@ -32,6 +32,7 @@
 #include <doca_sha.h>
 
 #include "comch_utils.h"
+#include "file_integrity_merkle.h"
 
 #include <samples/common.h>
 
@@ -68,6 +69,10 @@ struct server_runtime_data {
 	struct program_core_objects *sha_state;			  /* Core state of SHA context */
 	size_t active_sha_tasks;				  /* Variable indicating number of active tasks */
 	int fd;							  /* File descriptor for writing data to */
+
+	/* Merkle block transfer data */
+	struct merkle_sha merkle_sha; /* SHA engine verifying blocks and leaf digests */
+	uint32_t received_msgs;	      /* Number of messages handled, any activity resets the timeout */
 };
 
 struct file_integrity_metadata_msg {
@@ -84,6 +89,9 @@ struct file_integrity_config {
 	int timeout;						  /* Application timeout in seconds */
 	struct server_runtime_data server_data; /* Data populated on server side during file transmission */
 	enum transfer_state state;		/* Indicator of completion of a file transfer */
+	uint32_t block_size;			/* Merkle block size, zero hashes the file as a whole */
+	uint32_t corrupt_blocks;		/* Number of blocks the client corrupts on first transmission */
+	struct merkle_transfer merkle;		/* Merkle block transfer state */
 };
 
 /*
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <doca_log.h>
+#include <doca_mmap.h>
+#include <doca_pe.h>
+
+#include "file_integrity_merkle.h"
+
+#define SLEEP_IN_NANOS (10 * 1000)		 /* Sample the task every 10 microseconds */
+#define SHA_ALGORITHM (DOCA_SHA_ALGORITHM_SHA256) /* doca_sha_algorithm of every tree node */
+#define MERKLE_PROGRESS_MAGIC 0x4d4b4c50524f4731 /* Identifies a progress file */
+
+DOCA_LOG_REGISTER(FILE_INTEGRITY::Merkle);
+
+/* Header of the progress file, followed by one verified flag per block */
+struct merkle_progress_hdr {
+	uint64_t magic;			 /* MERKLE_PROGRESS_MAGIC */
+	uint64_t file_len;		 /* Length of the file */
+	uint32_t block_size;		 /* Size of every block but the last */
+	uint32_t num_blocks;		 /* Number of blocks */
+	uint8_t root[MERKLE_DIGEST_LEN]; /* Root of the tree the verified blocks belong to */
+};
+
+doca_error_t merkle_sha_init(struct merkle_sha *msha,
+			     struct doca_sha *sha_ctx,
+			     struct program_core_objects *state,
+			     struct doca_buf *dst_buf,
+			     size_t src_len)
+{
+	union doca_data task_user_data = {0};
+	union doca_data ctx_user_data = {0};
+	doca_error_t result;
+
+	memset(msha, 0, sizeof(*msha));
+	msha->state = state;
+	msha->dst_buf = dst_buf;
+	msha->src_len = src_len;
+
+	msha->src_data = calloc(1, src_len);
+	if (msha->src_data == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for SHA data buffer");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	result = doca_mmap_set_memrange(state->src_mmap, msha->src_data, src_len);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to set memory range of source memory map: %s", doca_error_get_descr(result));
+		goto free_src_data;
+	}
+
+	result = doca_mmap_start(state->src_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to start source memory map: %s", doca_error_get_descr(result));
+		goto free_src_data;
+	}
+
+	result = doca_buf_inventory_buf_get_by_data(state->buf_inv,
+						    state->src_mmap,
+						    msha->src_data,
+						    src_len,
+						    &msha->src_buf);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Unable to acquire DOCA buffer representing source buffer: %s",
+			     doca_error_get_descr(result));
+		goto stop_mmap;
+	}
+
+	/* Task completion decrements the number of active tasks */
+	ctx_user_data.ptr = &msha->active_tasks;
+	result = doca_ctx_set_user_data(state->ctx, ctx_user_data);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to set DOCA context user data: %s", doca_error_get_descr(result));
+		goto free_doca_buf;
+	}
+
+	result = doca_ctx_start(state->ctx);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to start DOCA context: %s", doca_error_get_descr(result));
+		goto free_doca_buf;
+	}
+
+	result = doca_sha_task_hash_alloc_init(sha_ctx,
+					       SHA_ALGORITHM,
+					       msha->src_buf,
+					       dst_buf,
+					       task_user_data,
+					       &msha->task);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to allocate SHA hash task: %s", doca_error_get_descr(result));
+		goto stop_ctx;
+	}
+
+	return DOCA_SUCCESS;
+
+stop_ctx:
+	doca_ctx_stop(state->ctx);
+free_doca_buf:
+	doca_buf_dec_refcount(msha->src_buf, NULL);
+stop_mmap:
+	doca_mmap_stop(state->src_mmap);
+free_src_data:
+	free(msha->src_data);
+	msha->src_data = NULL;
+
+	return result;
+}
+
+void merkle_sha_destroy(struct merkle_sha *msha)
+{
+	if (msha->src_data == NULL)
+		return;
+
+	doca_task_free(doca_sha_task_hash_as_task(msha->task));
+	doca_buf_dec_refcount(msha->src_buf, NULL);
+	doca_mmap_stop(msha->state->src_mmap);
+	free(msha->src_data);
+	memset(msha, 0, sizeof(*msha));
+}
+
+doca_error_t merkle_sha_digest(struct merkle_sha *msha, const void *data, size_t len, uint8_t *digest)
+{
+	union doca_data task_user_data = {0};
+	struct doca_task *task = doca_sha_task_hash_as_task(msha->task);
+	uint8_t *dst_data;
+	size_t dst_len;
+	doca_error_t result, task_result;
+	struct timespec ts = {
+		.tv_nsec = SLEEP_IN_NANOS,
+	};
+
+	if (len > msha->src_len) {
+		DOCA_LOG_ERR("Cannot hash %zu bytes, SHA buffer holds %zu bytes", len, msha->src_len);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	memcpy(msha->src_data, data, len);
+	result = doca_buf_set_data(msha->src_buf, msha->src_data, len);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("doca_buf_set_data() for request doca_buf failure: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* The digest of the previous task is still accounted in the destination buffer */
+	result = doca_buf_reset_data_len(msha->dst_buf);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to reset destination buffer: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = doca_sha_task_hash_set_src(msha->task, msha->src_buf);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to set source for SHA hash task: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	task_user_data.ptr = &task_result;
+	doca_task_set_user_data(task, task_user_data);
+
+	msha->active_tasks++;
+	result = doca_task_submit(task);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to submit SHA hash task: %s", doca_error_get_descr(result));
+		msha->active_tasks--;
+		return result;
+	}
+
+	while (msha->active_tasks > 0) {
+		if (doca_pe_progress(msha->state->pe) == 0)
+			nanosleep(&ts, &ts);
+	}
+
+	if (task_result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("SHA hash task failed: %s", doca_error_get_descr(task_result));
+		return task_result;
+	}
+
+	result = doca_buf_get_data(msha->dst_buf, (void **)&dst_data);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to get the data of DOCA buffer: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = doca_buf_get_data_len(msha->dst_buf, &dst_len);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to get the data length of DOCA buffer: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	if (dst_len < MERKLE_DIGEST_LEN) {
+		DOCA_LOG_ERR("SHA output of %zu bytes is shorter than a digest", dst_len);
+		return DOCA_ERROR_UNEXPECTED;
+	}
+
+	memcpy(digest, dst_data, MERKLE_DIGEST_LEN);
+	return DOCA_SUCCESS;
+}
+
+doca_error_t merkle_root(struct merkle_sha *msha, const uint8_t *leaves, uint32_t num_leaves, uint8_t *root)
+{
+	uint8_t *level;
+	uint32_t n, i;
+	doca_error_t result = DOCA_SUCCESS;
+
+	if (num_leaves == 0)
+		return DOCA_ERROR_INVALID_VALUE;
+
+	level = malloc((size_t)num_leaves * MERKLE_DIGEST_LEN);
+	if (level == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for tree level");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+	memcpy(level, leaves, (size_t)num_leaves * MERKLE_DIGEST_LEN);
+
+	/* Parents are written in place, node i is only overwritten after the pair reading it was hashed */
+	for (n = num_leaves; n > 1; n = (n + 1) / 2) {
+		for (i = 0; i < n / 2; i++) {
+			result = merkle_sha_digest(msha,
+						   level + (size_t)2 * i * MERKLE_DIGEST_LEN,
+						   2 * MERKLE_DIGEST_LEN,
+						   level + (size_t)i * MERKLE_DIGEST_LEN);
+			if (result != DOCA_SUCCESS)
+				goto free_level;
+		}
+		if (n % 2)
+			memcpy(level + (size_t)(n / 2) * MERKLE_DIGEST_LEN,
+			       level + (size_t)(n - 1) * MERKLE_DIGEST_LEN,
+			       MERKLE_DIGEST_LEN);
+	}
+
+	memcpy(root, level, MERKLE_DIGEST_LEN);
+
+free_level:
+	free(level);
+	return result;
+}
+
+doca_error_t merkle_build(struct merkle_sha *msha, const char *file_data, struct merkle_transfer *merkle)
+{
+	uint32_t i;
+	doca_error_t result;
+
+	merkle->num_blocks = (merkle->file_len + merkle->block_size - 1) / merkle->block_size;
+	merkle->leaves = calloc(merkle->num_blocks, MERKLE_DIGEST_LEN);
+	merkle->blocks = calloc(merkle->num_blocks, 1);
+	if (merkle->leaves == NULL || merkle->blocks == NULL) {
+		DOCA_LOG_ERR("Failed to allocate memory for %u tree leaves", merkle->num_blocks);
+		merkle_transfer_free(merkle);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	for (i = 0; i < merkle->num_blocks; i++) {
+		result = merkle_sha_digest(msha,
+					   file_data + (uint64_t)i * merkle->block_size,
+					   merkle_block_len(merkle, i),
+					   merkle->leaves + (size_t)i * MERKLE_DIGEST_LEN);
+		if (result != DOCA_SUCCESS)
+			return result;
+	}
+
+	return merkle_root(msha, merkle->leaves, merkle->num_blocks, merkle->root);
+}
+
+doca_error_t merkle_progress_open(const char *path, struct merkle_transfer *merkle)
+{
+	struct merkle_progress_hdr hdr = {};
+	struct merkle_progress_hdr saved = {};
+	uint32_t i;
+
+	hdr.magic = MERKLE_PROGRESS_MAGIC;
+	hdr.file_len = merkle->file_len;
+	hdr.block_size = merkle->block_size;
+	hdr.num_blocks = merkle->num_blocks;
+	memcpy(hdr.root, merkle->root, MERKLE_DIGEST_LEN);
+
+	merkle->progress_fd = open(path, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+	if (merkle->progress_fd < 0) {
+		DOCA_LOG_ERR("Failed to open progress file %s: %s", path, strerror(errno));
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	/* Blocks verified by an earlier attempt are only trusted if they belong to the same tree */
+	if ((size_t)pread(merkle->progress_fd, &saved, sizeof(saved), 0) == sizeof(saved) &&
+	    memcmp(&saved, &hdr, sizeof(hdr)) == 0 &&
+	    (size_t)pread(merkle->progress_fd, merkle->blocks, merkle->num_blocks, sizeof(hdr)) == merkle->num_blocks) {
+		for (i = 0; i < merkle->num_blocks; i++)
+			merkle->blocks_verified += (merkle->blocks[i] != 0);
+		DOCA_LOG_INFO("Resuming transfer, %u of %u blocks already verified",
+			      merkle->blocks_verified,
+			      merkle->num_blocks);
+		return DOCA_SUCCESS;
+	}
+
+	memset(merkle->blocks, 0, merkle->num_blocks);
+	if (ftruncate(merkle->progress_fd, 0) < 0 ||
+	    (size_t)pwrite(merkle->progress_fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+	    (size_t)pwrite(merkle->progress_fd, merkle->blocks, merkle->num_blocks, sizeof(hdr)) !=
+		    merkle->num_blocks) {
+		DOCA_LOG_ERR("Failed to initialize progress file %s: %s", path, strerror(errno));
+		close(merkle->progress_fd);
+		merkle->progress_fd = -1;
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+void merkle_progress_mark(struct merkle_transfer *merkle, uint32_t index)
+{
+	uint8_t verified = 1;
+
+	merkle->blocks[index] = verified;
+	merkle->blocks_verified++;
+
+	/* A lost update only costs the retransmission of the block on resume */
+	if (pwrite(merkle->progress_fd, &verified, 1, sizeof(struct merkle_progress_hdr) + index) != 1)
+		DOCA_LOG_WARN("Failed to record block %u in progress file: %s", index, strerror(errno));
+}
+
+void merkle_progress_close(const char *path, struct merkle_transfer *merkle, bool complete)
+{
+	if (merkle->progress_fd < 0)
+		return;
+
+	close(merkle->progress_fd);
+	merkle->progress_fd = -1;
+
+	if (complete && unlink(path) < 0)
+		DOCA_LOG_WARN("Failed to remove progress file %s: %s", path, strerror(errno));
+}
+
+void merkle_transfer_free(struct merkle_transfer *merkle)
+{
+	free(merkle->leaves);
+	merkle->leaves = NULL;
+	free(merkle->blocks);
+	merkle->blocks = NULL;
+}
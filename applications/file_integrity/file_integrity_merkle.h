@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef FILE_INTEGRITY_MERKLE_H_
+#define FILE_INTEGRITY_MERKLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <doca_buf.h>
+#include <doca_sha.h>
+
+#include <samples/common.h>
+
+#define MERKLE_DIGEST_LEN 32 /* SHA256 digest length of every tree node */
+
+/* Control and data messages of the Merkle block transfer, all fields are sent in network byte order */
+enum merkle_msg_type {
+	MERKLE_MSG_META = 0x4d4b0001, /* Client announces the file layout and the tree root */
+	MERKLE_MSG_LEAVES,	      /* Client sends a range of leaf digests */
+	MERKLE_MSG_BLOCK,	      /* Client sends one file block */
+	MERKLE_MSG_END,		      /* Client finished sending the blocks of a round */
+	MERKLE_MSG_NEED,	      /* Server lists a range of blocks it still needs */
+};
+
+struct merkle_msg_meta {
+	uint32_t type;			 /* MERKLE_MSG_META */
+	uint32_t block_size;		 /* Size of every block but the last */
+	uint32_t num_blocks;		 /* Number of blocks, and of tree leaves */
+	uint32_t reserved;		 /* Must be zero */
+	uint64_t file_len;		 /* Length of the file */
+	uint8_t root[MERKLE_DIGEST_LEN]; /* Root of the Merkle tree */
+};
+
+struct merkle_msg_leaves {
+	uint32_t type;	   /* MERKLE_MSG_LEAVES */
+	uint32_t first;	   /* Index of the first leaf in the message */
+	uint32_t count;	   /* Number of leaf digests in the message */
+	uint8_t digests[]; /* count digests of MERKLE_DIGEST_LEN bytes */
+};
+
+struct merkle_msg_block {
+	uint32_t type;	/* MERKLE_MSG_BLOCK */
+	uint32_t index; /* Block index, the length is implied by the message length */
+	uint8_t data[]; /* Block data */
+};
+
+struct merkle_msg_end {
+	uint32_t type; /* MERKLE_MSG_END */
+};
+
+struct merkle_msg_need {
+	uint32_t type;	/* MERKLE_MSG_NEED */
+	uint32_t first; /* Index of the first block described in the message */
+	uint32_t count; /* Number of blocks described in the message */
+	uint32_t last;	/* Non zero in the last message of the list */
+	uint8_t need[]; /* One byte per block, non zero if the block must be sent */
+};
+
+/* Single buffered DOCA SHA hash engine, data to hash is copied into a registered buffer */
+struct merkle_sha {
+	struct program_core_objects *state; /* Core objects of the SHA context */
+	char *src_data;			    /* Registered buffer holding the data to hash */
+	size_t src_len;			    /* Size of src_data */
+	struct doca_buf *src_buf;	    /* Doca_buf wrapping src_data */
+	struct doca_buf *dst_buf;	    /* Doca_buf receiving the digest */
+	struct doca_sha_task_hash *task;    /* Hash task reused for every digest */
+	size_t active_tasks;		    /* Number of submitted tasks, decremented by the task callbacks */
+};
+
+/* State of a Merkle block transfer, shared by both sides */
+struct merkle_transfer {
+	uint64_t file_len;		 /* Length of the file */
+	uint32_t block_size;		 /* Size of every block but the last */
+	uint32_t num_blocks;		 /* Number of blocks */
+	uint8_t root[MERKLE_DIGEST_LEN]; /* Root of the tree */
+	uint8_t *leaves;		 /* num_blocks leaf digests */
+	uint8_t *blocks;		 /* Per block flag: needed on the client, verified on the server */
+	uint32_t leaves_received;	 /* Number of leaf digests received (server) */
+	uint32_t blocks_verified;	 /* Number of blocks verified (server) */
+	uint32_t blocks_failed;		 /* Number of blocks that failed verification (server) */
+	uint32_t need_received;		 /* Number of block flags received in the current round (client) */
+	bool round_ready;		 /* A need list (client) or a round of blocks (server) is complete */
+	int progress_fd;		 /* Progress file used to resume an interrupted transfer (server) */
+};
+
+/*
+ * Number of bytes in a block of the transfer
+ *
+ * @merkle [in]: Merkle transfer
+ * @index [in]: block index
+ * @return: block length
+ */
+static inline uint32_t merkle_block_len(const struct merkle_transfer *merkle, uint32_t index)
+{
+	uint64_t offset = (uint64_t)index * merkle->block_size;
+
+	return (merkle->file_len - offset < merkle->block_size) ? merkle->file_len - offset : merkle->block_size;
+}
+
+/*
+ * Prepare the SHA engine, the SHA context is started here
+ *
+ * @msha [out]: SHA engine to initialize
+ * @sha_ctx [in]: SHA context with hash task configuration set
+ * @state [in]: core objects of the SHA context, src_mmap must not be started yet
+ * @dst_buf [in]: buffer receiving the digests
+ * @src_len [in]: largest amount of data hashed at once
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t merkle_sha_init(struct merkle_sha *msha,
+			     struct doca_sha *sha_ctx,
+			     struct program_core_objects *state,
+			     struct doca_buf *dst_buf,
+			     size_t src_len);
+
+/*
+ * Release the SHA engine resources, the SHA context is stopped by file_integrity_cleanup()
+ *
+ * @msha [in]: SHA engine
+ */
+void merkle_sha_destroy(struct merkle_sha *msha);
+
+/*
+ * Hash a buffer
+ *
+ * @msha [in]: SHA engine
+ * @data [in]: data to hash
+ * @len [in]: data length, at most src_len
+ * @digest [out]: MERKLE_DIGEST_LEN bytes digest
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t merkle_sha_digest(struct merkle_sha *msha, const void *data, size_t len, uint8_t *digest);
+
+/*
+ * Compute the root of the tree built over the leaf digests, an odd node is promoted to the next level
+ *
+ * @msha [in]: SHA engine, src_len must be at least two digests
+ * @leaves [in]: leaf digests
+ * @num_leaves [in]: number of leaf digests
+ * @root [out]: MERKLE_DIGEST_LEN bytes root
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t merkle_root(struct merkle_sha *msha, const uint8_t *leaves, uint32_t num_leaves, uint8_t *root);
+
+/*
+ * Hash every block of a file and compute the tree root
+ *
+ * @msha [in]: SHA engine, src_len must be at least one block
+ * @file_data [in]: file content
+ * @merkle [in/out]: transfer with file_len and block_size set, leaves, blocks and root are filled
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t merkle_build(struct merkle_sha *msha, const char *file_data, struct merkle_transfer *merkle);
+
+/*
+ * Open the progress file of a transfer and load the blocks verified by a previous attempt of the same file
+ *
+ * @path [in]: progress file path
+ * @merkle [in/out]: transfer with the layout and root set, verified blocks are flagged
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t merkle_progress_open(const char *path, struct merkle_transfer *merkle);
+
+/*
+ * Record a verified block in the progress file
+ *
+ * @merkle [in]: transfer
+ * @index [in]: verified block index
+ */
+void merkle_progress_mark(struct merkle_transfer *merkle, uint32_t index);
+
+/*
+ * Close the progress file, removing it if the transfer is complete
+ *
+ * @path [in]: progress file path
+ * @merkle [in]: transfer
+ * @complete [in]: true if every block was verified
+ */
+void merkle_progress_close(const char *path, struct merkle_transfer *merkle, bool complete);
+
+/*
+ * Release the transfer state
+ *
+ * @merkle [in]: transfer
+ */
+void merkle_transfer_free(struct merkle_transfer *merkle);
+
+#endif /* FILE_INTEGRITY_MERKLE_H_ */
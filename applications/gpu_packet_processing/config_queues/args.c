@@ -71,6 +71,23 @@ static doca_error_t http_server_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Enable CPU filters self test.
+ *
+ * @param [in]: Command line parameter
+ * @config [in]: Application configuration structure
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR_INVALID_VALUE otherwise
+ */
+static doca_error_t cpu_filters_test_callback(void *param, void *config)
+{
+	struct app_gpu_cfg *app_cfg = (struct app_gpu_cfg *)config;
+	bool cpu_filters_test = *((bool *)param);
+
+	app_cfg->cpu_filters_test = cpu_filters_test;
+
+	return DOCA_SUCCESS;
+}
+
 /*
  * Get NIC PCIe address input.
  *
@@ -120,7 +137,7 @@ static doca_error_t queue_num_callback(void *param, void *config)
 doca_error_t register_application_params(void)
 {
 	doca_error_t result;
-	struct doca_argp_param *gpu_param, *nic_param, *queue_param, *server_param;
+	struct doca_argp_param *gpu_param, *nic_param, *queue_param, *server_param, *filters_test_param;
 
 	result = doca_argp_param_create(&gpu_param);
 	if (result != DOCA_SUCCESS) {
@@ -197,6 +214,24 @@ doca_error_t register_application_params(void)
 		return result;
 	}
 
+	result = doca_argp_param_create(&filters_test_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	doca_argp_param_set_short_name(filters_test_param, "t");
+	doca_argp_param_set_long_name(filters_test_param, "cpu-filters-test");
+	doca_argp_param_set_description(filters_test_param,
+					"Check the CPU filters against the GPU filters truth table and benchmark them");
+	doca_argp_param_set_callback(filters_test_param, cpu_filters_test_callback);
+	doca_argp_param_set_type(filters_test_param, DOCA_ARGP_TYPE_BOOLEAN);
+	result = doca_argp_register_param(filters_test_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	/* Register version callback for DOCA SDK & RUNTIME */
 	result = doca_argp_register_version_callback(sdk_version_callback);
 	if (result != DOCA_SUCCESS) {
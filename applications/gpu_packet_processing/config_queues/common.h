@@ -37,6 +37,7 @@ struct app_gpu_cfg {
 	char nic_pcie_addr[DOCA_DEVINFO_PCI_ADDR_SIZE]; /* Network card PCIe address */
 	uint8_t queue_num;				/* Number of GPU receive queues */
 	bool http_server;				/* Enable GPU HTTP server */
+	bool cpu_filters_test;				/* Check and benchmark the CPU filters at startup */
 };
 
 /* Application TCP receive queues objects */
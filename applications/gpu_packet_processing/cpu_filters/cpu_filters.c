@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <doca_log.h>
+
+#include "cpu_filters.h"
+
+DOCA_LOG_REGISTER(CPU_FILTERS);
+
+#define HTTP_PATTERN_NUM 4 /* GET, HEAD, POST and generic HTTP */
+#define SELF_TEST_PKT_NUM 4096 /* Packets in the self test burst */
+#define SELF_TEST_PKT_SIZE 128 /* Room for the largest TCP header plus payload prefix */
+#define SELF_TEST_BENCH_ROUNDS 256 /* Bursts classified to measure throughput */
+#define TRUTH_TCP_NUM (sizeof(truth_tcp) / sizeof(truth_tcp[0]))
+#define TRUTH_UDP_NUM (sizeof(truth_udp) / sizeof(truth_udp[0]))
+#define NS_PER_SEC 1000000000.0
+
+/*
+ * HTTP request/response prefixes, indexed by the matching enum cpu_filter_tcp_class value so the lowest
+ * matching index is also the class with the highest priority. Bytes past the prefix length are zero in
+ * both pattern and mask.
+ */
+static const uint8_t http_pattern[HTTP_PATTERN_NUM][CPU_FILTER_PAYLOAD_PREFIX] = {
+	{'G', 'E', 'T', WHITESPACE_ASCII, '/'},
+	{'H', 'E', 'A', 'D', WHITESPACE_ASCII, '/'},
+	{'P', 'O', 'S', 'T', WHITESPACE_ASCII, '/'},
+	{'H', 'T', 'T', 'P', '/', '1', '.', '1'},
+};
+
+static const uint8_t http_mask[HTTP_PATTERN_NUM][CPU_FILTER_PAYLOAD_PREFIX] = {
+	{0xff, 0xff, 0xff, 0xff, 0xff},
+	{0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+	{0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+	{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+};
+
+/* Expected class of a TCP packet, as given by the gpu_kernels/filters.cuh predicates */
+struct truth_tcp_row {
+	const char *payload;		    /* Payload prefix, remaining bytes are zero */
+	uint8_t flags;			    /* TCP flags */
+	enum cpu_filter_tcp_class expected; /* Expected class */
+};
+
+/* Expected DNS match of a UDP packet, as given by filter_is_dns() */
+struct truth_udp_row {
+	uint16_t dst_port; /* Destination port in host order */
+	uint8_t dns;	   /* Expected filter_is_dns() result */
+};
+
+/*
+ * One row per branch of the filters.cuh predicates, applied in the receive_tcp.cu kernel order:
+ * GET, HEAD, POST, HTTP/1.1, then FIN, SYN and ACK flags. HTTP matches win over any flag.
+ */
+static const struct truth_tcp_row truth_tcp[] = {
+	{"GET /", 0, CPU_FILTER_TCP_HTTP_GET},
+	{"GET /", TCP_FLAG_ACK | TCP_FLAG_PSH | TCP_FLAG_FIN, CPU_FILTER_TCP_HTTP_GET},
+	{"GET/", 0, CPU_FILTER_TCP_OTHERS},
+	{"GEt /", TCP_FLAG_FIN, CPU_FILTER_TCP_FIN},
+	{"GET ", TCP_FLAG_ACK, CPU_FILTER_TCP_ACK},
+	{"get /", 0, CPU_FILTER_TCP_OTHERS},
+	{"HEAD /", TCP_FLAG_SYN, CPU_FILTER_TCP_HTTP_HEAD},
+	{"HEAD/", TCP_FLAG_SYN, CPU_FILTER_TCP_SYN},
+	{"HEAT /", 0, CPU_FILTER_TCP_OTHERS},
+	{"HE", TCP_FLAG_ACK, CPU_FILTER_TCP_ACK},
+	{"POST /", TCP_FLAG_FIN, CPU_FILTER_TCP_HTTP_POST},
+	{"POST  /", 0, CPU_FILTER_TCP_OTHERS},
+	{"PUT /", TCP_FLAG_ACK, CPU_FILTER_TCP_ACK},
+	{"HTTP/1.1", 0, CPU_FILTER_TCP_HTTP},
+	{"HTTP/1.1 200", TCP_FLAG_ACK, CPU_FILTER_TCP_HTTP},
+	{"HTTP/1.0", TCP_FLAG_ACK, CPU_FILTER_TCP_ACK},
+	{"HTTP/2", 0, CPU_FILTER_TCP_OTHERS},
+	{"", TCP_FLAG_FIN | TCP_FLAG_SYN | TCP_FLAG_ACK, CPU_FILTER_TCP_FIN},
+	{"", TCP_FLAG_SYN | TCP_FLAG_ACK, CPU_FILTER_TCP_SYN},
+	{"", TCP_FLAG_ACK | TCP_FLAG_RST, CPU_FILTER_TCP_ACK},
+	{"", TCP_FLAG_RST | TCP_FLAG_PSH | TCP_FLAG_URG, CPU_FILTER_TCP_OTHERS},
+	{"", 0, CPU_FILTER_TCP_OTHERS},
+};
+
+/* filter_is_dns() only looks at the destination port */
+static const struct truth_udp_row truth_udp[] = {
+	{DNS_POST, 1},
+	{DNS_POST + 1, 0},
+	{DNS_POST << 8, 0},
+	{0, 0},
+};
+
+/*
+ * Class of a non HTTP TCP packet, derived from its flags only
+ *
+ * @flags [in]: TCP flags
+ * @return: packet class
+ */
+static inline uint8_t tcp_flags_class(uint8_t flags)
+{
+	if (flags & TCP_FLAG_FIN)
+		return CPU_FILTER_TCP_FIN;
+	if (flags & TCP_FLAG_SYN)
+		return CPU_FILTER_TCP_SYN;
+	if (flags & CPU_FILTER_ACK_MASK)
+		return CPU_FILTER_TCP_ACK;
+	return CPU_FILTER_TCP_OTHERS;
+}
+
+/*
+ * Load payload prefix and TCP flags of a packet
+ *
+ * @pkt [in]: raw packet address
+ * @prefix [out]: first CPU_FILTER_PAYLOAD_PREFIX payload bytes
+ * @flags [out]: TCP flags
+ */
+static inline void tcp_load(const uint8_t *pkt, uint64_t *prefix, uint8_t *flags)
+{
+	const struct eth_ip_tcp_hdr *hdr;
+	const uint8_t *payload;
+
+	cpu_raw_to_tcp(pkt, &hdr, &payload);
+	memcpy(prefix, payload, sizeof(*prefix));
+	*flags = hdr->l4_hdr.tcp_flags;
+}
+
+void cpu_filters_classify_tcp(const uint8_t *const *pkts,
+			      uint32_t nb_pkts,
+			      uint8_t *classes,
+			      struct stats_tcp *stats)
+{
+	uint32_t count[CPU_FILTER_TCP_CLASS_NUM] = {0};
+	uint32_t idx = 0;
+	uint8_t cls;
+
+#if defined(__AVX2__)
+	/* All four patterns in one 256 bit register, compared at once against the broadcast payload prefix */
+	__m256i pattern = _mm256_loadu_si256((const __m256i *)http_pattern);
+	__m256i mask = _mm256_loadu_si256((const __m256i *)http_mask);
+
+	for (; idx < nb_pkts; idx++) {
+		uint64_t prefix;
+		uint8_t flags;
+		__m256i data;
+		uint32_t hit;
+
+		tcp_load(pkts[idx], &prefix, &flags);
+		data = _mm256_and_si256(_mm256_set1_epi64x((long long)prefix), mask);
+		hit = (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(data, pattern)));
+		cls = hit ? (uint8_t)__builtin_ctz(hit) : tcp_flags_class(flags);
+		count[cls]++;
+		if (classes)
+			classes[idx] = cls;
+	}
+#elif defined(__SSE2__)
+	/* Two patterns per 128 bit register, compared against the broadcast payload prefix */
+	__m128i pattern_lo = _mm_loadu_si128((const __m128i *)http_pattern[0]);
+	__m128i pattern_hi = _mm_loadu_si128((const __m128i *)http_pattern[2]);
+	__m128i mask_lo = _mm_loadu_si128((const __m128i *)http_mask[0]);
+	__m128i mask_hi = _mm_loadu_si128((const __m128i *)http_mask[2]);
+
+	for (; idx < nb_pkts; idx++) {
+		uint64_t prefix;
+		uint8_t flags;
+		__m128i data, eq_lo, eq_hi;
+		uint32_t hit;
+
+		tcp_load(pkts[idx], &prefix, &flags);
+		data = _mm_set1_epi64x((long long)prefix);
+		eq_lo = _mm_cmpeq_epi32(_mm_and_si128(data, mask_lo), pattern_lo);
+		eq_hi = _mm_cmpeq_epi32(_mm_and_si128(data, mask_hi), pattern_hi);
+		/* No 64 bit compare before SSE4.1, a pattern matches when both of its 32 bit halves do */
+		eq_lo = _mm_and_si128(eq_lo, _mm_shuffle_epi32(eq_lo, _MM_SHUFFLE(2, 3, 0, 1)));
+		eq_hi = _mm_and_si128(eq_hi, _mm_shuffle_epi32(eq_hi, _MM_SHUFFLE(2, 3, 0, 1)));
+		hit = (uint32_t)_mm_movemask_pd(_mm_castsi128_pd(eq_lo)) |
+		      ((uint32_t)_mm_movemask_pd(_mm_castsi128_pd(eq_hi)) << 2);
+		cls = hit ? (uint8_t)__builtin_ctz(hit) : tcp_flags_class(flags);
+		count[cls]++;
+		if (classes)
+			classes[idx] = cls;
+	}
+#endif
+
+	/* No SIMD instruction set available: one 64 bit compare per pattern */
+	for (; idx < nb_pkts; idx++) {
+		uint64_t prefix, pat, msk;
+		uint8_t flags;
+
+		tcp_load(pkts[idx], &prefix, &flags);
+		cls = tcp_flags_class(flags);
+		for (int p = HTTP_PATTERN_NUM - 1; p >= 0; p--) {
+			memcpy(&pat, http_pattern[p], sizeof(pat));
+			memcpy(&msk, http_mask[p], sizeof(msk));
+			if ((prefix & msk) == pat)
+				cls = (uint8_t)p;
+		}
+		count[cls]++;
+		if (classes)
+			classes[idx] = cls;
+	}
+
+	if (stats == NULL)
+		return;
+
+	stats->http_get += count[CPU_FILTER_TCP_HTTP_GET];
+	stats->http_head += count[CPU_FILTER_TCP_HTTP_HEAD];
+	stats->http_post += count[CPU_FILTER_TCP_HTTP_POST];
+	stats->http += count[CPU_FILTER_TCP_HTTP];
+	stats->tcp_fin += count[CPU_FILTER_TCP_FIN];
+	stats->tcp_syn += count[CPU_FILTER_TCP_SYN];
+	stats->tcp_ack += count[CPU_FILTER_TCP_ACK];
+	stats->others += count[CPU_FILTER_TCP_OTHERS];
+	stats->total += nb_pkts;
+}
+
+void cpu_filters_classify_udp(const uint8_t *const *pkts, uint32_t nb_pkts, struct stats_udp *stats)
+{
+	const struct eth_ip_udp_hdr *hdr;
+	const uint8_t *payload;
+	uint64_t dns = 0;
+
+	/* A single 16 bit compare per packet, the header loads dominate so there is nothing to vectorize */
+	for (uint32_t idx = 0; idx < nb_pkts; idx++) {
+		cpu_raw_to_udp(pkts[idx], &hdr, &payload);
+		dns += cpu_filter_is_dns(&(hdr->l4_hdr), payload);
+	}
+
+	stats->dns += dns;
+	stats->others += nb_pkts - dns;
+	stats->total += nb_pkts;
+}
+
+/*
+ * Get monotonic timestamp in nanoseconds
+ *
+ * @return: timestamp
+ */
+static uint64_t self_test_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (uint64_t)t.tv_nsec + (uint64_t)t.tv_sec * 1000 * 1000 * 1000;
+}
+
+/*
+ * Check both TCP classifiers and the UDP classifier against the filters.cuh truth tables
+ *
+ * @buf [in]: buffer of SELF_TEST_PKT_NUM packets of SELF_TEST_PKT_SIZE bytes
+ * @pkts [in]: packet addresses in buf
+ * @classes [in]: buffer of SELF_TEST_PKT_NUM classes
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR_UNEXPECTED otherwise
+ */
+static doca_error_t self_test_truth_table(uint8_t *buf, const uint8_t **pkts, uint8_t *classes)
+{
+	struct stats_udp udp_st = {0};
+	uint64_t dns = 0;
+	doca_error_t result = DOCA_SUCCESS;
+
+	memset(buf, 0, TRUTH_TCP_NUM * SELF_TEST_PKT_SIZE);
+	for (uint32_t idx = 0; idx < TRUTH_TCP_NUM; idx++) {
+		uint8_t *pkt = buf + (size_t)idx * SELF_TEST_PKT_SIZE;
+		struct eth_ip_tcp_hdr *hdr = (struct eth_ip_tcp_hdr *)pkt;
+		uint8_t *payload;
+
+		/* Alternate shortest and longest TCP headers to cover the payload offset */
+		hdr->l4_hdr.dt_off = (uint8_t)((idx % 2 ? 15 : 5) << 4);
+		hdr->l4_hdr.tcp_flags = truth_tcp[idx].flags;
+		payload = pkt + sizeof(struct ether_hdr) + sizeof(struct ipv4_hdr) +
+			  ((hdr->l4_hdr.dt_off >> 4) * sizeof(int));
+		memcpy(payload, truth_tcp[idx].payload, strlen(truth_tcp[idx].payload));
+	}
+
+	cpu_filters_classify_tcp(pkts, TRUTH_TCP_NUM, classes, NULL);
+	for (uint32_t idx = 0; idx < TRUTH_TCP_NUM; idx++) {
+		enum cpu_filter_tcp_class scalar = cpu_filter_tcp_class_scalar(pkts[idx]);
+
+		if (scalar != truth_tcp[idx].expected || classes[idx] != truth_tcp[idx].expected) {
+			DOCA_LOG_ERR("CPU TCP filters truth table row %u: expected %d, per packet %d, burst %d",
+				     idx,
+				     truth_tcp[idx].expected,
+				     scalar,
+				     classes[idx]);
+			result = DOCA_ERROR_UNEXPECTED;
+		}
+	}
+
+	memset(buf, 0, TRUTH_UDP_NUM * SELF_TEST_PKT_SIZE);
+	for (uint32_t idx = 0; idx < TRUTH_UDP_NUM; idx++) {
+		struct eth_ip_udp_hdr *hdr = (struct eth_ip_udp_hdr *)(buf + (size_t)idx * SELF_TEST_PKT_SIZE);
+
+		hdr->l4_hdr.dst_port = BYTE_SWAP16(truth_udp[idx].dst_port);
+		dns += truth_udp[idx].dns;
+	}
+
+	cpu_filters_classify_udp(pkts, TRUTH_UDP_NUM, &udp_st);
+	if (udp_st.dns != dns || udp_st.others != TRUTH_UDP_NUM - dns) {
+		DOCA_LOG_ERR("CPU UDP filters truth table: DNS %lu expected %lu", udp_st.dns, dns);
+		result = DOCA_ERROR_UNEXPECTED;
+	}
+
+	return result;
+}
+
+/*
+ * Fill a synthetic TCP packet with payloads close to every HTTP filter and random flags
+ *
+ * @pkt [out]: packet buffer of SELF_TEST_PKT_SIZE bytes
+ * @seed [in/out]: random seed
+ */
+static void self_test_fill_tcp(uint8_t *pkt, unsigned int *seed)
+{
+	static const char *const payloads[] = {
+		"GET /index",
+		"GET/index",
+		"GEt /",
+		"HEAD /",
+		"HEAD/",
+		"HEAT /",
+		"POST /",
+		"POST  /",
+		"PUT /",
+		"HTTP/1.1 200",
+		"HTTP/1.0 200",
+		"HTTP/2 200",
+		"HE",
+	};
+	const int nb_payloads = sizeof(payloads) / sizeof(payloads[0]);
+	struct eth_ip_tcp_hdr *hdr = (struct eth_ip_tcp_hdr *)pkt;
+	uint8_t *payload;
+	int pick;
+
+	for (int idx = 0; idx < SELF_TEST_PKT_SIZE; idx++)
+		pkt[idx] = (uint8_t)rand_r(seed);
+
+	/* Data offset 5 to 15 words */
+	hdr->l4_hdr.dt_off = (uint8_t)((5 + rand_r(seed) % 11) << 4);
+	payload = pkt + sizeof(struct ether_hdr) + sizeof(struct ipv4_hdr) + ((hdr->l4_hdr.dt_off >> 4) * sizeof(int));
+
+	/* One in four payloads is left random */
+	pick = rand_r(seed) % (nb_payloads + nb_payloads / 3);
+	if (pick < nb_payloads)
+		memcpy(payload, payloads[pick], strlen(payloads[pick]));
+}
+
+doca_error_t cpu_filters_self_test(void)
+{
+	const uint8_t **pkts;
+	uint8_t *buf, *classes;
+	struct stats_tcp tcp_st = {0};
+	struct stats_udp udp_st = {0};
+	unsigned int seed = 0x5eed;
+	uint64_t dns = 0, mismatch = 0;
+	uint64_t start, scalar_ns, burst_ns;
+	doca_error_t result = DOCA_SUCCESS;
+
+	buf = malloc((size_t)SELF_TEST_PKT_NUM * SELF_TEST_PKT_SIZE);
+	pkts = malloc(SELF_TEST_PKT_NUM * sizeof(*pkts));
+	classes = malloc(SELF_TEST_PKT_NUM);
+	if (buf == NULL || pkts == NULL || classes == NULL) {
+		DOCA_LOG_ERR("Failed to allocate CPU filters self test buffers");
+		result = DOCA_ERROR_NO_MEMORY;
+		goto exit;
+	}
+
+	for (int idx = 0; idx < SELF_TEST_PKT_NUM; idx++)
+		pkts[idx] = buf + (size_t)idx * SELF_TEST_PKT_SIZE;
+
+	result = self_test_truth_table(buf, pkts, classes);
+	if (result != DOCA_SUCCESS)
+		goto exit;
+
+	for (int idx = 0; idx < SELF_TEST_PKT_NUM; idx++)
+		self_test_fill_tcp(buf + (size_t)idx * SELF_TEST_PKT_SIZE, &seed);
+
+	/* Differential check of the burst classifier against the per packet filters on random packets */
+	cpu_filters_classify_tcp(pkts, SELF_TEST_PKT_NUM - 1, classes, &tcp_st);
+	for (int idx = 0; idx < SELF_TEST_PKT_NUM - 1; idx++) {
+		if (classes[idx] != cpu_filter_tcp_class_scalar(pkts[idx]))
+			mismatch++;
+	}
+	if (mismatch != 0 || tcp_st.total != SELF_TEST_PKT_NUM - 1) {
+		DOCA_LOG_ERR("CPU TCP filters mismatch on %lu of %d packets", mismatch, SELF_TEST_PKT_NUM - 1);
+		result = DOCA_ERROR_UNEXPECTED;
+		goto exit;
+	}
+
+	start = self_test_ns();
+	for (int round = 0; round < SELF_TEST_BENCH_ROUNDS; round++)
+		for (int idx = 0; idx < SELF_TEST_PKT_NUM; idx++)
+			classes[idx] = cpu_filter_tcp_class_scalar(pkts[idx]);
+	scalar_ns = self_test_ns() - start;
+
+	start = self_test_ns();
+	for (int round = 0; round < SELF_TEST_BENCH_ROUNDS; round++)
+		cpu_filters_classify_tcp(pkts, SELF_TEST_PKT_NUM, classes, NULL);
+	burst_ns = self_test_ns() - start;
+
+	DOCA_LOG_INFO("CPU TCP filters: per packet %.2f Mpps, burst %.2f Mpps",
+		      (double)SELF_TEST_BENCH_ROUNDS * SELF_TEST_PKT_NUM / ((double)scalar_ns / NS_PER_SEC) / 1e6,
+		      (double)SELF_TEST_BENCH_ROUNDS * SELF_TEST_PKT_NUM / ((double)burst_ns / NS_PER_SEC) / 1e6);
+
+	/* UDP packets reuse the same buffers, a quarter of them addressed to the DNS port */
+	for (int idx = 0; idx < SELF_TEST_PKT_NUM; idx++) {
+		struct eth_ip_udp_hdr *hdr = (struct eth_ip_udp_hdr *)(buf + (size_t)idx * SELF_TEST_PKT_SIZE);
+
+		if (rand_r(&seed) % 4 == 0)
+			hdr->l4_hdr.dst_port = BYTE_SWAP16(DNS_POST);
+		dns += cpu_filter_is_dns(&(hdr->l4_hdr), NULL);
+	}
+
+	start = self_test_ns();
+	for (int round = 0; round < SELF_TEST_BENCH_ROUNDS; round++)
+		cpu_filters_classify_udp(pkts, SELF_TEST_PKT_NUM, &udp_st);
+	burst_ns = self_test_ns() - start;
+
+	if (udp_st.dns != dns * SELF_TEST_BENCH_ROUNDS ||
+	    udp_st.others != (SELF_TEST_PKT_NUM - dns) * SELF_TEST_BENCH_ROUNDS) {
+		DOCA_LOG_ERR("CPU UDP filters mismatch: DNS %lu expected %lu",
+			     udp_st.dns,
+			     dns * SELF_TEST_BENCH_ROUNDS);
+		result = DOCA_ERROR_UNEXPECTED;
+		goto exit;
+	}
+
+	DOCA_LOG_INFO("CPU UDP filters: burst %.2f Mpps",
+		      (double)SELF_TEST_BENCH_ROUNDS * SELF_TEST_PKT_NUM / ((double)burst_ns / NS_PER_SEC) / 1e6);
+
+exit:
+	free(classes);
+	free(pkts);
+	free(buf);
+
+	return result;
+}
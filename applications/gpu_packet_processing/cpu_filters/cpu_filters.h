@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef DOCA_GPU_PACKET_PROCESSING_CPU_FILTERS_H
+#define DOCA_GPU_PACKET_PROCESSING_CPU_FILTERS_H
+
+#include <stdint.h>
+
+#include <doca_error.h>
+
+#include "packets.h"
+
+/* CPU counterpart of gpu_kernels/filters.cuh ACK_MASK */
+#define CPU_FILTER_ACK_MASK (0x00 | TCP_FLAG_ACK)
+/* Payload bytes inspected by the HTTP filters, the packet buffer must have them readable */
+#define CPU_FILTER_PAYLOAD_PREFIX 8
+
+/* TCP packet classes, in the same priority order applied by the GPU receive kernel */
+enum cpu_filter_tcp_class {
+	CPU_FILTER_TCP_HTTP_GET = 0, /* HTTP GET packet */
+	CPU_FILTER_TCP_HTTP_HEAD,    /* HTTP HEAD packet */
+	CPU_FILTER_TCP_HTTP_POST,    /* HTTP POST packet */
+	CPU_FILTER_TCP_HTTP,	     /* Generic HTTP packet */
+	CPU_FILTER_TCP_FIN,	     /* TCP with FIN flag */
+	CPU_FILTER_TCP_SYN,	     /* TCP with SYN flag */
+	CPU_FILTER_TCP_ACK,	     /* TCP with ACK flag */
+	CPU_FILTER_TCP_OTHERS,	     /* Other TCP packets */
+	CPU_FILTER_TCP_CLASS_NUM,    /* Number of TCP classes */
+};
+
+/*
+ * Get TCP header and payload of a raw Ethernet/IPv4/TCP frame, same as raw_to_tcp() on the GPU
+ *
+ * @pkt [in]: raw packet address
+ * @hdr [out]: packet headers
+ * @payload [out]: TCP payload
+ */
+static inline void cpu_raw_to_tcp(const uint8_t *pkt, const struct eth_ip_tcp_hdr **hdr, const uint8_t **payload)
+{
+	(*hdr) = (const struct eth_ip_tcp_hdr *)pkt;
+	(*payload) = pkt + sizeof(struct ether_hdr) + sizeof(struct ipv4_hdr) +
+		     (((*hdr)->l4_hdr.dt_off >> 4) * sizeof(int));
+}
+
+/*
+ * Get UDP header and payload of a raw Ethernet/IPv4/UDP frame, same as raw_to_udp() on the GPU
+ *
+ * @pkt [in]: raw packet address
+ * @hdr [out]: packet headers
+ * @payload [out]: UDP payload
+ */
+static inline void cpu_raw_to_udp(const uint8_t *pkt, const struct eth_ip_udp_hdr **hdr, const uint8_t **payload)
+{
+	(*hdr) = (const struct eth_ip_udp_hdr *)pkt;
+	(*payload) = pkt + sizeof(struct eth_ip_udp_hdr);
+}
+
+/*
+ * Check if payload starts with "HTTP/1.1"
+ *
+ * @pld [in]: TCP payload
+ * @return: 1 on match and 0 otherwise
+ */
+static inline int cpu_filter_is_http(const uint8_t *pld)
+{
+	if (pld[0] != 'H')
+		return 0;
+	if (pld[1] == 'T' && pld[2] == 'T' && pld[3] == 'P' && pld[4] == '/' && pld[5] == '1' && pld[6] == '.' &&
+	    pld[7] == '1')
+		return 1;
+	return 0;
+}
+
+/*
+ * Check if payload starts with "GET /"
+ *
+ * @pld [in]: TCP payload
+ * @return: 1 on match and 0 otherwise
+ */
+static inline int cpu_filter_is_http_get(const uint8_t *pld)
+{
+	if (pld[0] != 'G')
+		return 0;
+	if (pld[1] == 'E' && pld[2] == 'T' && pld[3] == WHITESPACE_ASCII && pld[4] == '/')
+		return 1;
+	return 0;
+}
+
+/*
+ * Check if payload starts with "POST /"
+ *
+ * @pld [in]: TCP payload
+ * @return: 1 on match and 0 otherwise
+ */
+static inline int cpu_filter_is_http_post(const uint8_t *pld)
+{
+	if (pld[0] != 'P')
+		return 0;
+	if (pld[1] == 'O' && pld[2] == 'S' && pld[3] == 'T' && pld[4] == WHITESPACE_ASCII && pld[5] == '/')
+		return 1;
+	return 0;
+}
+
+/*
+ * Check if payload starts with "HEAD /"
+ *
+ * @pld [in]: TCP payload
+ * @return: 1 on match and 0 otherwise
+ */
+static inline int cpu_filter_is_http_head(const uint8_t *pld)
+{
+	if (pld[0] != 'H' || pld[1] != 'E')
+		return 0;
+	if (pld[2] == 'A' && pld[3] == 'D' && pld[4] == WHITESPACE_ASCII && pld[5] == '/')
+		return 1;
+	return 0;
+}
+
+/*
+ * Check TCP SYN flag
+ *
+ * @l4_hdr [in]: TCP header
+ * @return: non zero if set
+ */
+static inline int cpu_filter_is_tcp_syn(const struct tcp_hdr *l4_hdr)
+{
+	return l4_hdr->tcp_flags & TCP_FLAG_SYN;
+}
+
+/*
+ * Check TCP FIN flag
+ *
+ * @l4_hdr [in]: TCP header
+ * @return: non zero if set
+ */
+static inline int cpu_filter_is_tcp_fin(const struct tcp_hdr *l4_hdr)
+{
+	return l4_hdr->tcp_flags & TCP_FLAG_FIN;
+}
+
+/*
+ * Check TCP ACK flag
+ *
+ * @l4_hdr [in]: TCP header
+ * @return: non zero if set
+ */
+static inline int cpu_filter_is_tcp_ack(const struct tcp_hdr *l4_hdr)
+{
+	return l4_hdr->tcp_flags & CPU_FILTER_ACK_MASK;
+}
+
+/*
+ * Check if UDP packet is addressed to the DNS port
+ *
+ * @l4_hdr [in]: UDP header
+ * @pld [in]: UDP payload
+ * @return: 1 on match and 0 otherwise
+ */
+static inline int cpu_filter_is_dns(const struct udp_hdr *l4_hdr, const uint8_t *pld)
+{
+	(void)pld;
+
+	if (BYTE_SWAP16(l4_hdr->dst_port) == DNS_POST)
+		return 1;
+
+	return 0;
+}
+
+/*
+ * Classify a single TCP packet, one filter at a time as the GPU receive kernel does
+ *
+ * @pkt [in]: raw packet address
+ * @return: packet class
+ */
+static inline enum cpu_filter_tcp_class cpu_filter_tcp_class_scalar(const uint8_t *pkt)
+{
+	const struct eth_ip_tcp_hdr *hdr;
+	const uint8_t *payload;
+
+	cpu_raw_to_tcp(pkt, &hdr, &payload);
+
+	if (cpu_filter_is_http_get(payload))
+		return CPU_FILTER_TCP_HTTP_GET;
+	else if (cpu_filter_is_http_head(payload))
+		return CPU_FILTER_TCP_HTTP_HEAD;
+	else if (cpu_filter_is_http_post(payload))
+		return CPU_FILTER_TCP_HTTP_POST;
+	else if (cpu_filter_is_http(payload))
+		return CPU_FILTER_TCP_HTTP;
+	else if (cpu_filter_is_tcp_fin(&(hdr->l4_hdr)))
+		return CPU_FILTER_TCP_FIN;
+	else if (cpu_filter_is_tcp_syn(&(hdr->l4_hdr)))
+		return CPU_FILTER_TCP_SYN;
+	else if (cpu_filter_is_tcp_ack(&(hdr->l4_hdr)))
+		return CPU_FILTER_TCP_ACK;
+	return CPU_FILTER_TCP_OTHERS;
+}
+
+/*
+ * Classify a burst of TCP packets, using SIMD compares on the payload prefix when available
+ *
+ * @pkts [in]: raw packet addresses
+ * @nb_pkts [in]: number of packets
+ * @classes [out]: class of each packet, may be NULL
+ * @stats [out]: stats to increment, may be NULL
+ */
+void cpu_filters_classify_tcp(const uint8_t *const *pkts,
+			      uint32_t nb_pkts,
+			      uint8_t *classes,
+			      struct stats_tcp *stats);
+
+/*
+ * Classify a burst of UDP packets
+ *
+ * @pkts [in]: raw packet addresses
+ * @nb_pkts [in]: number of packets
+ * @stats [out]: stats to increment
+ */
+void cpu_filters_classify_udp(const uint8_t *const *pkts, uint32_t nb_pkts, struct stats_udp *stats);
+
+/*
+ * Check the classifiers against the gpu_kernels/filters.cuh truth table and the burst classifier against
+ * the per packet filters on random packets, then report their throughput
+ *
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t cpu_filters_self_test(void);
+
+#endif /* DOCA_GPU_PACKET_PROCESSING_CPU_FILTERS_H */
@@ -25,13 +25,18 @@
 
 #include "tcp_cpu_rss_func.h"
 #include "tcp_session_table.h"
+#include "cpu_filters/cpu_filters.h"
 
 DOCA_LOG_REGISTER(TCP_CPU_RSS);
 
+struct stats_tcp tcp_cpu_rss_stats[MAX_QUEUES];
+
 int tcp_cpu_rss_func(void *lcore_args)
 {
 	struct rte_mbuf **rx_packets;
 	struct rte_mbuf **tx_packets;
+	const uint8_t **rx_addr;
+	struct stats_tcp stats = {0};
 	uint32_t num_tx_packets = 0;
 	uint16_t port_id = DPDK_DEFAULT_PORT;
 	const struct rxq_tcp_queues *tcp_queues = lcore_args;
@@ -71,12 +76,28 @@ int tcp_cpu_rss_func(void *lcore_args)
 		return -1;
 	}
 
+	rx_addr = (const uint8_t **)calloc(TCP_PACKET_MAX_BURST_SIZE, sizeof(uint8_t *));
+	if (rx_addr == NULL) {
+		free(rx_packets);
+		free(tx_packets);
+		DOCA_LOG_ERR("No memory available to allocate DPDK rx packet addresses");
+		return -1;
+	}
+
 	DOCA_LOG_INFO("Core %u is performing TCP SYN/FIN processing on queue %u", rte_lcore_id(), queue_id);
 
 	/* read global force_quit */
 	while (DOCA_GPUNETIO_VOLATILE(force_quit) == false) {
 		int num_rx_packets = rte_eth_rx_burst(port_id, queue_id, rx_packets, TCP_PACKET_MAX_BURST_SIZE);
 
+		if (num_rx_packets > 0) {
+			/* Payload prefix reads stay within the mbuf data room even for header only packets */
+			for (int i = 0; i < num_rx_packets; i++)
+				rx_addr[i] = rte_pktmbuf_mtod(rx_packets[i], const uint8_t *);
+			cpu_filters_classify_tcp(rx_addr, num_rx_packets, NULL, &stats);
+			DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[queue_id]) = stats;
+		}
+
 		for (int i = 0; i < num_rx_packets; i++) {
 			const struct rte_mbuf *pkt = rx_packets[i];
 			const struct rte_tcp_hdr *tcp_hdr = extract_tcp_hdr(pkt);
@@ -127,12 +148,14 @@ int tcp_cpu_rss_func(void *lcore_args)
 
 	free(rx_packets);
 	free(tx_packets);
+	free(rx_addr);
 
 	return 0;
 error:
 
 	free(rx_packets);
 	free(tx_packets);
+	free(rx_addr);
 
 	return -1;
 }
@@ -39,6 +39,9 @@
 
 #define TCP_PACKET_MAX_BURST_SIZE 4096
 
+/* Filter stats of the packets received by each CPU RSS queue */
+extern struct stats_tcp tcp_cpu_rss_stats[MAX_QUEUES];
+
 /*
  * Launch CPU thread to manage TCP 3way handshake
  *
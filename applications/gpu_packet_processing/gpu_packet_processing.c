@@ -30,6 +30,7 @@
 #include "common.h"
 #include "dpdk_tcp/tcp_session_table.h"
 #include "dpdk_tcp/tcp_cpu_rss_func.h"
+#include "cpu_filters/cpu_filters.h"
 
 #define SLEEP_IN_NANOS (10 * 1000) /* Sample the PE every 10 microseconds  */
 
@@ -243,6 +244,20 @@ static void stats_core(void *args)
 				       tcp_st[idxq].total);
 			}
 
+			for (int idxq = 0; app_cfg.http_server && idxq < tcp_queues.numq_cpu_rss; idxq++) {
+				printf("[TCP CPU] QUEUE: %d HTTP: %d HTTP HEAD: %d HTTP GET: %d HTTP POST: %d TCP [SYN: %d FIN: %d ACK: %d] OTHER: %d TOTAL: %d\n",
+				       idxq,
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].http),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].http_head),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].http_get),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].http_post),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].tcp_syn),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].tcp_fin),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].tcp_ack),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].others),
+				       DOCA_GPUNETIO_VOLATILE(tcp_cpu_rss_stats[idxq].total));
+			}
+
 			interval_print = get_ns(&interval_sec);
 		}
 	}
@@ -322,6 +337,15 @@ int main(int argc, char **argv)
 		      app_cfg.queue_num,
 		      (app_cfg.http_server == true ? "Yes" : "No"));
 
+	/* CPU filters classify the packets received by the CPU RSS queues, they must agree with the GPU ones */
+	if (app_cfg.cpu_filters_test) {
+		result = cpu_filters_self_test();
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Function cpu_filters_self_test returned %s", doca_error_get_descr(result));
+			return EXIT_FAILURE;
+		}
+	}
+
 	/* In a multi-GPU system, ensure CUDA refers to the right GPU device */
 	cuda_ret = cudaDeviceGetByPCIBusId(&cuda_id, app_cfg.gpu_pcie_addr);
 	if (cuda_ret != cudaSuccess) {
@@ -38,6 +38,7 @@
 
 #define IP_FRAG_TBL_TIMEOUT_MS 2
 #define IP_FRAG_TBL_SIZE 2048
+#define IP_FRAG_REPLAY_LOOPS 1
 
 DOCA_LOG_REGISTER(IP_FRAG);
 
@@ -70,6 +71,8 @@ static doca_error_t ip_frag_mode_callback(void *param, void *config)
 		cfg->mode = IP_FRAG_MODE_BIDIR;
 	} else if (!strcmp(mode_str, "multiport")) {
 		cfg->mode = IP_FRAG_MODE_MULTIPORT;
+	} else if (!strcmp(mode_str, "replay")) {
+		cfg->mode = IP_FRAG_MODE_REPLAY;
 	} else {
 		DOCA_LOG_ERR("Unsupported mode: %s", mode_str);
 		return DOCA_ERROR_INVALID_VALUE;
@@ -167,6 +170,69 @@ static doca_error_t ip_frag_mbuf_hw_cksum_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Callback to handle replay mode pcap source
+ *
+ * @param [in]: pcap file path string.
+ * @config [in]: Ip_frag config.
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t ip_frag_replay_pcap_callback(void *param, void *config)
+{
+	struct ip_frag_config *cfg = config;
+	const char *path = param;
+
+	if (strnlen(path, sizeof(cfg->replay_pcap)) == sizeof(cfg->replay_pcap)) {
+		DOCA_LOG_ERR("Replay pcap path is too long, max %zu", sizeof(cfg->replay_pcap) - 1);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	strcpy(cfg->replay_pcap, path);
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Callback to handle replay mode pcap sink prefix
+ *
+ * @param [in]: pcap file path prefix string.
+ * @config [in]: Ip_frag config.
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t ip_frag_replay_out_callback(void *param, void *config)
+{
+	struct ip_frag_config *cfg = config;
+	const char *path = param;
+
+	if (strnlen(path, sizeof(cfg->replay_out)) == sizeof(cfg->replay_out)) {
+		DOCA_LOG_ERR("Replay output path is too long, max %zu", sizeof(cfg->replay_out) - 1);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	strcpy(cfg->replay_out, path);
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Callback to handle replay mode number of passes over the capture
+ *
+ * @param [in]: loops integer.
+ * @config [in]: Ip_frag config.
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t ip_frag_replay_loops_callback(void *param, void *config)
+{
+	const int loops = *(const int *)param;
+	struct ip_frag_config *cfg = config;
+
+	if (loops < 0) {
+		DOCA_LOG_ERR("Invalid replay loops: %d", loops);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	cfg->replay_loops = loops;
+
+	return DOCA_SUCCESS;
+}
+
 /*
  * Handle application parameters registration
  *
@@ -179,6 +245,7 @@ static doca_error_t ip_frag_register_params(void)
 	struct doca_argp_param *frag_tbl_timeout_param;
 	struct doca_argp_param *frag_tbl_size_param;
 	struct doca_argp_param *mbuf_chain_param;
+	struct doca_argp_param *replay_param;
 	doca_error_t result;
 
 	/* Create and register ip_frag application mode */
@@ -194,8 +261,9 @@ static doca_error_t ip_frag_register_params(void)
 		"Ip_frag application mode."
 		" Bidirectional mode forwards packets between a single reassembly port and a single fragmentation port (two ports in total)."
 		" Multiport mode forwards packets between two pairs of reassembly and fragmentation ports (four ports in total)."
+		" Replay mode fragments and reassembles the packets of a pcap file on every core, without any ports."
 		" For more information consult DOCA IP Fragmentation Application Guide."
-		" Format: bidir, multiport");
+		" Format: bidir, multiport, replay");
 	doca_argp_param_set_callback(app_mode_param, ip_frag_mode_callback);
 	doca_argp_param_set_type(app_mode_param, DOCA_ARGP_TYPE_STRING);
 	doca_argp_param_set_mandatory(app_mode_param);
@@ -295,6 +363,62 @@ static doca_error_t ip_frag_register_params(void)
 		return result;
 	}
 
+	/* Create and register ip_frag replay mode pcap source */
+	result = doca_argp_param_create(&replay_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(replay_param, "rp");
+	doca_argp_param_set_long_name(replay_param, "replay-pcap");
+	doca_argp_param_set_description(
+		replay_param,
+		"Replay mode pcap file of unfragmented packets, reassembled packets are verified against them");
+	doca_argp_param_set_callback(replay_param, ip_frag_replay_pcap_callback);
+	doca_argp_param_set_type(replay_param, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(replay_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register ip_frag replay mode pcap sink */
+	result = doca_argp_param_create(&replay_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(replay_param, "ro");
+	doca_argp_param_set_long_name(replay_param, "replay-out");
+	doca_argp_param_set_description(
+		replay_param,
+		"Replay mode pcap sink prefix, the first pass of each core is written to <prefix>.<lcore>");
+	doca_argp_param_set_callback(replay_param, ip_frag_replay_out_callback);
+	doca_argp_param_set_type(replay_param, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(replay_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register ip_frag replay mode number of passes */
+	result = doca_argp_param_create(&replay_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(replay_param, "rl");
+	doca_argp_param_set_long_name(replay_param, "replay-loops");
+	doca_argp_param_set_description(replay_param,
+					"Replay mode passes over the pcap file per core, 0 to replay until stopped");
+	doca_argp_param_set_callback(replay_param, ip_frag_replay_loops_callback);
+	doca_argp_param_set_type(replay_param, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(replay_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	return DOCA_SUCCESS;
 }
 
@@ -332,14 +456,14 @@ static doca_error_t ip_frag_dpdk_config_tx_offloads(struct ip_frag_config *cfg,
 /*
  * Validate application mode fits the number of operating ports.
  *
- * @mode [in]: application mode.
+ * @cfg [in]: application config.
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t validate_mode(enum ip_frag_mode mode)
+static doca_error_t validate_mode(const struct ip_frag_config *cfg)
 {
 	uint32_t num_ports = rte_eth_dev_count_avail();
 
-	switch (mode) {
+	switch (cfg->mode) {
 	case IP_FRAG_MODE_BIDIR:
 		if (num_ports != 2) {
 			DOCA_LOG_ERR("Bidir mode requires two ports.");
@@ -352,8 +476,14 @@ static doca_error_t validate_mode(enum ip_frag_mode mode)
 			return DOCA_ERROR_NOT_SUPPORTED;
 		}
 		break;
+	case IP_FRAG_MODE_REPLAY:
+		if (!cfg->replay_pcap[0]) {
+			DOCA_LOG_ERR("Replay mode requires a pcap file.");
+			return DOCA_ERROR_INVALID_VALUE;
+		}
+		break;
 	default:
-		DOCA_LOG_ERR("Unsupported application mode: %u", mode);
+		DOCA_LOG_ERR("Unsupported application mode: %u", cfg->mode);
 		return DOCA_ERROR_NOT_SUPPORTED;
 	};
 
@@ -376,6 +506,7 @@ int main(int argc, char **argv)
 		.hw_cksum = true,
 		.frag_tbl_timeout = IP_FRAG_TBL_TIMEOUT_MS,
 		.frag_tbl_size = IP_FRAG_TBL_SIZE,
+		.replay_loops = IP_FRAG_REPLAY_LOOPS,
 	};
 	struct doca_log_backend *sdk_log;
 	int exit_status = EXIT_FAILURE;
@@ -415,7 +546,7 @@ int main(int argc, char **argv)
 		goto argp_cleanup;
 	}
 
-	result = validate_mode(cfg.mode);
+	result = validate_mode(&cfg);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to validate mode");
 		goto dpdk_cleanup;
@@ -433,11 +564,13 @@ int main(int argc, char **argv)
 		goto dpdk_cleanup;
 	}
 
-	/* update queues and ports */
-	result = dpdk_queues_and_ports_init(&dpdk_config);
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to update ports and queues");
-		goto dpdk_cleanup;
+	/* update queues and ports, replay mode runs without any */
+	if (cfg.mode != IP_FRAG_MODE_REPLAY) {
+		result = dpdk_queues_and_ports_init(&dpdk_config);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to update ports and queues");
+			goto dpdk_cleanup;
+		}
 	}
 
 	signal(SIGINT, signal_handler);
@@ -452,7 +585,8 @@ int main(int argc, char **argv)
 
 	exit_status = EXIT_SUCCESS;
 dpdk_ports_queues_cleanup:
-	dpdk_queues_and_ports_fini(&dpdk_config);
+	if (cfg.mode != IP_FRAG_MODE_REPLAY)
+		dpdk_queues_and_ports_fini(&dpdk_config);
 dpdk_cleanup:
 	dpdk_fini();
 argp_cleanup:
@@ -24,6 +24,7 @@
  */
 
 #include "ip_frag_dp.h"
+#include "ip_frag_replay.h"
 #include <flow_common.h>
 
 #include <doca_log.h>
@@ -36,6 +37,7 @@
 #include <rte_ethdev.h>
 #include <rte_ip_frag.h>
 #include <rte_cycles.h>
+#include <rte_errno.h>
 #include <rte_mempool.h>
 
 #include <stdbool.h>
@@ -46,6 +48,13 @@
 
 #define IP_FRAG_TBL_BUCKET_SIZE 4
 
+/* Replay mode loops the bidir topology back on itself: capture packets are fragmented towards the reassembly port
+ * and the reassembled packets are sent to the fragmentation port, which is where they get verified */
+#define IP_FRAG_REPLAY_RX_PORT IP_FRAG_PORT_FRAGMENT_0
+#define IP_FRAG_REPLAY_FRAGS_PORT IP_FRAG_PORT_REASSEMBLE_0
+#define IP_FRAG_REPLAY_SINK_PORT IP_FRAG_PORT_FRAGMENT_0
+#define IP_FRAG_REPLAY_NUM_PORTS 2
+
 DOCA_LOG_REGISTER(IP_FRAG::DP);
 
 struct ip_frag_sw_counters {
@@ -57,6 +66,26 @@ struct ip_frag_sw_counters {
 	uint64_t err;		/* Errors */
 };
 
+struct ip_frag_replay_wt {
+	const struct ip_frag_replay_src *src;	   /* Loaded capture */
+	struct rte_mempool *pool;		   /* Mempool for the per-burst copies of the capture packets */
+	struct rte_eth_dev_tx_buffer *sink_buffer; /* Reassembled packets pending verification */
+	FILE *sink;				   /* Pcap sink of the first pass, NULL if disabled or done */
+	uint32_t loops_left;			   /* Passes left over the capture, 0 for no limit */
+	uint32_t cursor;			   /* Next capture packet to replay */
+	uint32_t burst_start;			   /* Start of the capture packets range of the current burst */
+	uint32_t burst_end;			   /* End of the capture packets range of the current burst */
+	uint32_t nb_seen;			   /* Capture packets of the current burst out of reassembly */
+	bool seen[IP_FRAG_MAX_PKT_BURST];	   /* Capture packets of the current burst out of reassembly */
+	uint64_t pkts;				   /* Capture packets replayed */
+	uint64_t verified;			   /* Reassembled packets identical to the capture packet */
+	uint64_t mismatched;			   /* Reassembled packets different from the capture packet */
+	uint64_t missing;			   /* Capture packets that did not come out of reassembly */
+	uint64_t alloc_err;			   /* Failed capture packet copies */
+	uint64_t proc_tsc;			   /* Cycles spent fragmenting and reassembling */
+	uint64_t sink_tsc;			   /* Cycles spent verifying and writing the pcap sink */
+};
+
 struct ip_frag_wt_data {
 	const struct ip_frag_config *cfg;			  /* Application config */
 	uint16_t queue_id;					  /* Queue id */
@@ -66,6 +95,7 @@ struct ip_frag_wt_data {
 	struct rte_ip_frag_tbl *frag_tbl;			  /* Fragmentation table */
 	struct rte_mempool *indirect_pool;			  /* Indirect memory pool */
 	struct rte_ip_frag_death_row death_row;			  /* Fragmentation table expired fragments death row */
+	struct ip_frag_replay_wt replay;			  /* Replay mode state */
 } __rte_aligned(RTE_CACHE_LINE_SIZE);
 
 bool force_stop = false;
@@ -83,6 +113,58 @@ static void ip_frag_pkt_err_drop(struct ip_frag_wt_data *wt_data, uint16_t rx_po
 	rte_pktmbuf_free(pkt);
 }
 
+static void ip_frag_tx_flush(struct ip_frag_wt_data *wt_data, uint16_t tx_port_id);
+
+/*
+ * Get the replay mode index of the capture packet a packet comes from.
+ *
+ * @cfg [in]: application config
+ * @pkt [in]: packet
+ * @return: pointer to the capture index
+ */
+static inline uint32_t *ip_frag_replay_idx(const struct ip_frag_config *cfg, struct rte_mbuf *pkt)
+{
+	return RTE_MBUF_DYNFIELD(pkt, cfg->mbuf_replay_idx_offset, uint32_t *);
+}
+
+/*
+ * Get the TX buffer packets sent to the port are accumulated in.
+ *
+ * @wt_data [in]: worker thread data
+ * @tx_port_id [in]: outgoing packet port id
+ * @return: TX buffer
+ */
+static inline struct rte_eth_dev_tx_buffer *ip_frag_tx_buffer_get(struct ip_frag_wt_data *wt_data,
+								  uint16_t tx_port_id)
+{
+	if (unlikely(wt_data->cfg->mode == IP_FRAG_MODE_REPLAY) && tx_port_id == IP_FRAG_REPLAY_SINK_PORT)
+		return wt_data->replay.sink_buffer;
+
+	return wt_data->tx_buffer;
+}
+
+/*
+ * Buffer the packet for sending, flushing the TX buffer when it gets full.
+ *
+ * @wt_data [in]: worker thread data
+ * @tx_port_id [in]: outgoing packet port id
+ * @pkt [in]: packet
+ */
+static inline void ip_frag_tx_buffer(struct ip_frag_wt_data *wt_data, uint16_t tx_port_id, struct rte_mbuf *pkt)
+{
+	struct rte_eth_dev_tx_buffer *tx_buffer;
+
+	if (likely(wt_data->cfg->mode != IP_FRAG_MODE_REPLAY)) {
+		rte_eth_tx_buffer(tx_port_id, wt_data->queue_id, wt_data->tx_buffer, pkt);
+		return;
+	}
+
+	tx_buffer = ip_frag_tx_buffer_get(wt_data, tx_port_id);
+	tx_buffer->pkts[tx_buffer->length++] = pkt;
+	if (tx_buffer->length == tx_buffer->size)
+		ip_frag_tx_flush(wt_data, tx_port_id);
+}
+
 /*
  * Parse the packet.
  *
@@ -478,7 +560,7 @@ static void ip_frag_pkt_reassemble(struct ip_frag_wt_data *wt_data,
 		case DOCA_SUCCESS:
 			wt_data->sw_counters[rx_port_id].whole++;
 			ip_frag_pkt_fixup(wt_data, inferred_pkt_type, pkt, &parse_ctx);
-			rte_eth_tx_buffer(tx_port_id, wt_data->queue_id, wt_data->tx_buffer, pkt);
+			ip_frag_tx_buffer(wt_data, tx_port_id, pkt);
 			break;
 
 		case DOCA_ERROR_AGAIN:
@@ -624,7 +706,7 @@ static void ip_frag_pkt_fragment(struct ip_frag_wt_data *wt_data,
 
 	if (rte_pktmbuf_pkt_len(pkt) <= wt_data->cfg->mtu) {
 		wt_data->sw_counters[rx_port_id].mtu_fits_rx++;
-		rte_eth_tx_buffer(tx_port_id, wt_data->queue_id, tx_buffer, pkt);
+		ip_frag_tx_buffer(wt_data, tx_port_id, pkt);
 		return;
 	}
 
@@ -651,6 +733,11 @@ static void ip_frag_pkt_fragment(struct ip_frag_wt_data *wt_data,
 		DOCA_LOG_ERR("RTE fragmentation failed with code: %d", -num_frags);
 		return;
 	}
+
+	for (i = tx_buffer->length; i < tx_buffer->length + num_frags; i++) {
+		if (unlikely(wt_data->cfg->mode == IP_FRAG_MODE_REPLAY))
+			*ip_frag_replay_idx(wt_data->cfg, tx_buffer->pkts[i]) = *ip_frag_replay_idx(wt_data->cfg, pkt);
+	}
 	rte_pktmbuf_free(pkt);
 
 	for (i = tx_buffer->length; i < tx_buffer->length + num_frags; i++) {
@@ -697,13 +784,13 @@ static void ip_frag_pkts_fragment(struct ip_frag_wt_data *wt_data,
 		rte_prefetch0(rte_pktmbuf_mtod(pkts[i + IP_FRAG_BURST_PREFETCH], void *));
 		ip_frag_pkt_fragment(wt_data, rx_port_id, tx_port_id, pkts[i]);
 		if (tx_buffer->size - tx_buffer->length < IP_FRAG_FLUSH_THRESHOLD)
-			rte_eth_tx_buffer_flush(tx_port_id, wt_data->queue_id, tx_buffer);
+			ip_frag_tx_flush(wt_data, tx_port_id);
 	}
 
 	for (; i < pkts_cnt; i++) {
 		ip_frag_pkt_fragment(wt_data, rx_port_id, tx_port_id, pkts[i]);
 		if (tx_buffer->size - tx_buffer->length < IP_FRAG_FLUSH_THRESHOLD)
-			rte_eth_tx_buffer_flush(tx_port_id, wt_data->queue_id, tx_buffer);
+			ip_frag_tx_flush(wt_data, tx_port_id);
 	}
 }
 
@@ -724,6 +811,138 @@ static void ip_frag_wt_fragment(struct ip_frag_wt_data *wt_data, uint16_t rx_por
 	rte_eth_tx_buffer_flush(tx_port_id, wt_data->queue_id, wt_data->tx_buffer);
 }
 
+/*
+ * Replay mode sink: verify the reassembled packets against the capture packets they were fragmented from, write them
+ * to the pcap sink and free them.
+ *
+ * @wt_data [in]: worker thread data
+ */
+static void ip_frag_replay_sink_flush(struct ip_frag_wt_data *wt_data)
+{
+	struct ip_frag_replay_wt *replay = &wt_data->replay;
+	struct rte_eth_dev_tx_buffer *sink_buffer = replay->sink_buffer;
+	uint64_t start_tsc = rte_rdtsc();
+	struct rte_mbuf *pkt;
+	uint32_t idx;
+	uint16_t i;
+
+	for (i = 0; i < sink_buffer->length; i++) {
+		pkt = sink_buffer->pkts[i];
+
+		/* Packets may come out of reassembly in any order, or not at all; match them by capture index */
+		idx = *ip_frag_replay_idx(wt_data->cfg, pkt);
+		if (idx >= replay->burst_start && idx < replay->burst_end && !replay->seen[idx - replay->burst_start]) {
+			replay->seen[idx - replay->burst_start] = true;
+			replay->nb_seen++;
+			if (ip_frag_replay_pkt_equal(pkt, replay->src->pkts[idx]))
+				replay->verified++;
+			else
+				replay->mismatched++;
+		} else {
+			replay->mismatched++;
+		}
+
+		if (replay->sink)
+			ip_frag_pcap_sink_write(replay->sink, pkt);
+		rte_pktmbuf_free(pkt);
+	}
+	sink_buffer->length = 0;
+
+	replay->sink_tsc += rte_rdtsc() - start_tsc;
+}
+
+/*
+ * Send buffered packets. In replay mode the fragments are looped back into reassembly and the reassembled packets go
+ * to the replay sink instead of a port.
+ *
+ * @wt_data [in]: worker thread data
+ * @tx_port_id [in]: outgoing packet port id
+ */
+static void ip_frag_tx_flush(struct ip_frag_wt_data *wt_data, uint16_t tx_port_id)
+{
+	struct rte_eth_dev_tx_buffer *tx_buffer = wt_data->tx_buffer;
+	struct rte_mbuf *pkts[IP_FRAG_MAX_PKT_BURST];
+	uint16_t pkts_cnt;
+
+	if (likely(wt_data->cfg->mode != IP_FRAG_MODE_REPLAY)) {
+		rte_eth_tx_buffer_flush(tx_port_id, wt_data->queue_id, tx_buffer);
+		return;
+	}
+
+	if (tx_port_id == IP_FRAG_REPLAY_SINK_PORT) {
+		ip_frag_replay_sink_flush(wt_data);
+		return;
+	}
+
+	pkts_cnt = tx_buffer->length;
+	memcpy(pkts, tx_buffer->pkts, pkts_cnt * sizeof(pkts[0]));
+	tx_buffer->length = 0;
+	ip_frag_pkts_reassemble(wt_data,
+				IP_FRAG_REPLAY_FRAGS_PORT,
+				IP_FRAG_REPLAY_SINK_PORT,
+				PARSER_PKT_TYPE_UNKNOWN,
+				pkts,
+				pkts_cnt,
+				rte_rdtsc());
+}
+
+/*
+ * Replay a burst of capture packets: fragment them, reassemble the fragments and verify the result. Each pass over the
+ * capture starts from the first packet.
+ *
+ * @wt_data [in]: worker thread data
+ * @return: false once all the requested passes over the capture are done, true otherwise
+ */
+static bool ip_frag_wt_replay(struct ip_frag_wt_data *wt_data)
+{
+	struct ip_frag_replay_wt *replay = &wt_data->replay;
+	const struct ip_frag_replay_src *src = replay->src;
+	struct rte_mbuf *pkts[IP_FRAG_MAX_PKT_BURST];
+	uint64_t start_tsc;
+	uint64_t sink_tsc;
+	uint16_t pkts_cnt;
+
+	if (replay->cursor == src->nb_pkts) {
+		replay->cursor = 0;
+		if (replay->sink) {
+			ip_frag_pcap_sink_close(replay->sink);
+			replay->sink = NULL;
+		}
+		if (wt_data->cfg->replay_loops && --replay->loops_left == 0)
+			return false;
+	}
+
+	for (pkts_cnt = 0; pkts_cnt < IP_FRAG_MAX_PKT_BURST && replay->cursor + pkts_cnt < src->nb_pkts; pkts_cnt++) {
+		pkts[pkts_cnt] = rte_pktmbuf_copy(src->pkts[replay->cursor + pkts_cnt], replay->pool, 0, UINT32_MAX);
+		if (unlikely(!pkts[pkts_cnt])) {
+			replay->alloc_err++;
+			break;
+		}
+		*ip_frag_replay_idx(wt_data->cfg, pkts[pkts_cnt]) = replay->cursor + pkts_cnt;
+	}
+	if (unlikely(!pkts_cnt))
+		return true;
+
+	replay->burst_start = replay->cursor;
+	replay->burst_end = replay->cursor + pkts_cnt;
+	replay->cursor += pkts_cnt;
+	replay->nb_seen = 0;
+	memset(replay->seen, 0, pkts_cnt * sizeof(replay->seen[0]));
+
+	sink_tsc = replay->sink_tsc;
+	start_tsc = rte_rdtsc();
+	ip_frag_pkts_fragment(wt_data, IP_FRAG_REPLAY_RX_PORT, IP_FRAG_REPLAY_FRAGS_PORT, pkts, pkts_cnt);
+	ip_frag_tx_flush(wt_data, IP_FRAG_REPLAY_FRAGS_PORT);
+	ip_frag_tx_flush(wt_data, IP_FRAG_REPLAY_SINK_PORT);
+	rte_ip_frag_table_del_expired_entries(wt_data->frag_tbl, &wt_data->death_row, rte_rdtsc());
+	rte_ip_frag_free_death_row(&wt_data->death_row, IP_FRAG_BURST_PREFETCH);
+	replay->proc_tsc += rte_rdtsc() - start_tsc - (replay->sink_tsc - sink_tsc);
+
+	replay->missing += pkts_cnt - replay->nb_seen;
+	replay->pkts += pkts_cnt;
+	return true;
+}
+
 /*
  * Worker thread main run loop
  *
@@ -756,6 +975,10 @@ static int ip_frag_wt_thread_main(void *param)
 			ip_frag_wt_fragment(wt_data, IP_FRAG_PORT_REASSEMBLE_1, IP_FRAG_PORT_REASSEMBLE_0);
 			ip_frag_wt_fragment(wt_data, IP_FRAG_PORT_FRAGMENT_1, IP_FRAG_PORT_FRAGMENT_0);
 			break;
+		case IP_FRAG_MODE_REPLAY:
+			if (!ip_frag_wt_replay(wt_data))
+				return 0;
+			break;
 		default:
 			DOCA_LOG_ERR("Unsupported application mode: %u", wt_data->cfg->mode);
 			return EINVAL;
@@ -799,6 +1022,31 @@ static doca_error_t ip_frag_mbuf_flags_init(struct ip_frag_config *cfg)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Register the mbuf field replay mode tags packets with the index of their capture packet
+ *
+ * @cfg [in]: application config
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t ip_frag_replay_idx_init(struct ip_frag_config *cfg)
+{
+	static const struct rte_mbuf_dynfield idx_desc = {
+		.name = "ip_frag replay index",
+		.size = sizeof(uint32_t),
+		.align = __alignof__(uint32_t),
+	};
+	int offset;
+
+	offset = rte_mbuf_dynfield_register(&idx_desc);
+	if (offset < 0) {
+		DOCA_LOG_ERR("Failed to register mbuf replay index field with code: %d", rte_errno);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	cfg->mbuf_replay_idx_offset = offset;
+	return DOCA_SUCCESS;
+}
+
 /*
  * Initialize indirect fragmentation mempools
  *
@@ -1063,6 +1311,125 @@ static void ip_frag_debug_counters_print(struct ip_frag_ctx *ctx, struct ip_frag
 	DOCA_LOG_INFO("");
 }
 
+/*
+ * Cleanup replay mode state of each worker
+ *
+ * @wt_data_arr [in]: worker thread data array
+ */
+static void ip_frag_replay_wt_cleanup(struct ip_frag_wt_data *wt_data_arr)
+{
+	struct ip_frag_replay_wt *replay;
+	unsigned lcore;
+
+	RTE_LCORE_FOREACH(lcore)
+	{
+		replay = &wt_data_arr[lcore].replay;
+
+		if (replay->sink)
+			ip_frag_pcap_sink_close(replay->sink);
+		rte_free(replay->sink_buffer);
+	}
+}
+
+/*
+ * Initialize replay mode state of each worker
+ *
+ * @cfg [in]: application config
+ * @src [in]: loaded capture
+ * @pool [in]: mempool for the per-burst copies of the capture packets
+ * @wt_data_arr [in]: worker thread data array
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t ip_frag_replay_wt_init(const struct ip_frag_config *cfg,
+					   const struct ip_frag_replay_src *src,
+					   struct rte_mempool *pool,
+					   struct ip_frag_wt_data *wt_data_arr)
+{
+	char sink_path[PATH_MAX + 16];
+	struct ip_frag_replay_wt *replay;
+	doca_error_t ret;
+	unsigned lcore;
+
+	RTE_LCORE_FOREACH(lcore)
+	{
+		replay = &wt_data_arr[lcore].replay;
+		replay->src = src;
+		replay->pool = pool;
+		replay->loops_left = cfg->replay_loops;
+
+		replay->sink_buffer = rte_zmalloc_socket("Replay sink buffer",
+							 RTE_ETH_TX_BUFFER_SIZE(IP_FRAG_MAX_PKT_BURST),
+							 RTE_CACHE_LINE_SIZE,
+							 rte_lcore_to_socket_id(lcore));
+		if (!replay->sink_buffer) {
+			DOCA_LOG_ERR("Failed to allocate worker thread replay sink buffer");
+			ret = DOCA_ERROR_NO_MEMORY;
+			goto cleanup;
+		}
+		rte_eth_tx_buffer_init(replay->sink_buffer, IP_FRAG_MAX_PKT_BURST);
+
+		if (cfg->replay_out[0]) {
+			snprintf(sink_path, sizeof(sink_path), "%s.%u", cfg->replay_out, lcore);
+			ret = ip_frag_pcap_sink_open(sink_path, &replay->sink);
+			if (ret != DOCA_SUCCESS)
+				goto cleanup;
+		}
+	}
+
+	return DOCA_SUCCESS;
+
+cleanup:
+	ip_frag_replay_wt_cleanup(wt_data_arr);
+	return ret;
+}
+
+/*
+ * Print replay mode verification results and throughput of each worker
+ *
+ * @wt_data_arr [in]: worker thread data array
+ */
+static void ip_frag_replay_stats_print(struct ip_frag_wt_data *wt_data_arr)
+{
+	struct ip_frag_replay_wt sum = {0};
+	struct ip_frag_replay_wt *replay;
+	double mpps_sum = 0;
+	double mpps;
+	unsigned lcore;
+
+	DOCA_LOG_INFO("//////////////////// REPLAY ////////////////////");
+
+	RTE_LCORE_FOREACH(lcore)
+	{
+		replay = &wt_data_arr[lcore].replay;
+		mpps = replay->proc_tsc ? (double)replay->pkts * rte_get_tsc_hz() / replay->proc_tsc / 1e6 : 0;
+
+		DOCA_LOG_INFO(
+			"Core replay %3u pkts=%-10lu verified=%-10lu mismatched=%-8lu missing=%-8lu alloc_err=%-8lu Mpps=%.3f",
+			lcore,
+			replay->pkts,
+			replay->verified,
+			replay->mismatched,
+			replay->missing,
+			replay->alloc_err,
+			mpps);
+
+		sum.pkts += replay->pkts;
+		sum.verified += replay->verified;
+		sum.mismatched += replay->mismatched;
+		sum.missing += replay->missing;
+		sum.alloc_err += replay->alloc_err;
+		mpps_sum += mpps;
+	}
+
+	DOCA_LOG_INFO("TOTAL replay     pkts=%-10lu verified=%-10lu mismatched=%-8lu missing=%-8lu alloc_err=%-8lu Mpps=%.3f",
+		      sum.pkts,
+		      sum.verified,
+		      sum.mismatched,
+		      sum.missing,
+		      sum.alloc_err,
+		      mpps_sum);
+}
+
 /*
  * Create a flow pipe
  *
@@ -1240,6 +1607,87 @@ static doca_error_t ip_frag_rss_pipes_create(struct ip_frag_ctx *ctx)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * IP fragmentation replay mode: every lcore replays the whole capture through fragmentation and reassembly, no ports
+ * or DOCA Flow are involved.
+ *
+ * @cfg [in]: application config
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t ip_frag_replay(struct ip_frag_config *cfg)
+{
+	struct rte_mempool *indirect_pools[RTE_MAX_NUMA_NODES] = {NULL};
+	struct ip_frag_ctx ctx = {
+		.num_ports = IP_FRAG_REPLAY_NUM_PORTS,
+		.num_queues = rte_lcore_count(),
+	};
+	struct ip_frag_replay_src src;
+	struct ip_frag_wt_data *wt_data_arr;
+	struct rte_mempool *pool;
+	doca_error_t ret;
+
+	if (cfg->hw_cksum) {
+		DOCA_LOG_INFO("Replay mode has no port to offload checksums to, calculating them in software");
+		cfg->hw_cksum = false;
+	}
+
+	ret = ip_frag_mbuf_flags_init(cfg);
+	if (ret != DOCA_SUCCESS)
+		return ret;
+
+	ret = ip_frag_replay_idx_init(cfg);
+	if (ret != DOCA_SUCCESS)
+		return ret;
+
+	ret = ip_frag_replay_src_load(cfg->replay_pcap, &src);
+	if (ret != DOCA_SUCCESS)
+		return ret;
+
+	pool = rte_pktmbuf_pool_create("Replay mempool",
+				       NUM_MBUFS * ctx.num_queues,
+				       MBUF_CACHE_SIZE,
+				       0,
+				       src.data_room_size,
+				       rte_socket_id());
+	if (!pool) {
+		DOCA_LOG_ERR("Failed to allocate replay mempool");
+		ret = DOCA_ERROR_NO_MEMORY;
+		goto cleanup_src;
+	}
+
+	ret = ip_frag_indirect_pool_init(ctx.num_queues, indirect_pools);
+	if (ret != DOCA_SUCCESS)
+		goto cleanup_pool;
+
+	ret = ip_frag_wt_data_init(cfg, indirect_pools, &wt_data_arr);
+	if (ret != DOCA_SUCCESS)
+		goto cleanup_pool;
+
+	ret = ip_frag_replay_wt_init(cfg, &src, pool, wt_data_arr);
+	if (ret != DOCA_SUCCESS)
+		goto cleanup_wt_data;
+
+	DOCA_LOG_INFO("Initialization finished, replaying %u packets", src.nb_pkts);
+	if (rte_eal_mp_remote_launch(ip_frag_wt_thread_main, wt_data_arr, CALL_MAIN)) {
+		DOCA_LOG_ERR("Failed to launch worker threads");
+		ret = DOCA_ERROR_DRIVER;
+		goto cleanup_replay;
+	}
+	rte_eal_mp_wait_lcore();
+
+	ip_frag_debug_counters_print(&ctx, wt_data_arr);
+	ip_frag_replay_stats_print(wt_data_arr);
+cleanup_replay:
+	ip_frag_replay_wt_cleanup(wt_data_arr);
+cleanup_wt_data:
+	ip_frag_wt_data_cleanup(wt_data_arr);
+cleanup_pool:
+	rte_mempool_free(pool);
+cleanup_src:
+	ip_frag_replay_src_destroy(&src);
+	return ret;
+}
+
 doca_error_t ip_frag(struct ip_frag_config *cfg, struct application_dpdk_config *dpdk_cfg)
 {
 	struct rte_mempool *indirect_pools[RTE_MAX_NUMA_NODES] = {NULL};
@@ -1253,6 +1701,9 @@ doca_error_t ip_frag(struct ip_frag_config *cfg, struct application_dpdk_config
 	struct flow_resources resource = {0};
 	doca_error_t ret;
 
+	if (cfg->mode == IP_FRAG_MODE_REPLAY)
+		return ip_frag_replay(cfg);
+
 	ret = init_doca_flow(ctx.num_queues, "vnf,hws", &resource, nr_shared_resources);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to init DOCA Flow: %s", doca_error_get_descr(ret));
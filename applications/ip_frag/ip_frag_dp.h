@@ -30,6 +30,7 @@
 #include <doca_flow.h>
 #include <dpdk_utils.h>
 
+#include <limits.h>
 #include <stdbool.h>
 
 #define UNUSED(x) ((void)(x))
@@ -37,6 +38,7 @@
 enum ip_frag_mode {
 	IP_FRAG_MODE_BIDIR,
 	IP_FRAG_MODE_MULTIPORT,
+	IP_FRAG_MODE_REPLAY,
 };
 
 enum ip_frag_port {
@@ -57,11 +59,15 @@ struct ip_frag_config {
 	enum ip_frag_mode mode;		   /* Application mode */
 	uint64_t mbuf_flag_outer_modified; /* RTE mbuf outer fragmentation flag mask */
 	uint64_t mbuf_flag_inner_modified; /* RTE mbuf inner fragmentation flag mask */
+	int mbuf_replay_idx_offset;	   /* RTE mbuf replay mode capture index field offset */
 	uint16_t mtu;			   /* MTU */
 	bool mbuf_chain;		   /* Use chained mbuf optimization */
 	bool hw_cksum;			   /* Use hardware checksum optimization */
 	uint32_t frag_tbl_timeout;	   /* Fragmentation table timeout in ms */
 	uint32_t frag_tbl_size;		   /* Fragmentation table size */
+	char replay_pcap[PATH_MAX];	   /* Replay mode pcap source */
+	char replay_out[PATH_MAX];	   /* Replay mode pcap sink prefix, empty to disable */
+	uint32_t replay_loops;		   /* Replay mode passes over the source, 0 for no limit */
 };
 
 struct ip_frag_pipe_cfg {
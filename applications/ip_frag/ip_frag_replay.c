@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "ip_frag_replay.h"
+
+#include <doca_log.h>
+
+#include <rte_byteorder.h>
+#include <rte_malloc.h>
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#define PCAP_MAGIC_USEC 0xa1b2c3d4 /* Microsecond resolution timestamps */
+#define PCAP_MAGIC_NSEC 0xa1b23c4d /* Nanosecond resolution timestamps */
+#define PCAP_VERSION_MAJOR 2
+#define PCAP_VERSION_MINOR 4
+#define PCAP_LINKTYPE_ETHERNET 1
+#define PCAP_SNAPLEN UINT16_MAX
+
+DOCA_LOG_REGISTER(IP_FRAG::REPLAY);
+
+struct pcap_file_hdr {
+	uint32_t magic;		/* Magic number, also encodes byte order and timestamp resolution */
+	uint16_t version_major; /* Major version */
+	uint16_t version_minor; /* Minor version */
+	int32_t thiszone;	/* GMT to local time correction */
+	uint32_t sigfigs;	/* Accuracy of timestamps */
+	uint32_t snaplen;	/* Max length of captured packets */
+	uint32_t linktype;	/* Data link type */
+};
+
+struct pcap_rec_hdr {
+	uint32_t ts_sec;   /* Timestamp seconds */
+	uint32_t ts_frac;  /* Timestamp microseconds or nanoseconds */
+	uint32_t incl_len; /* Number of bytes saved in the file */
+	uint32_t orig_len; /* Actual length of the packet */
+};
+
+/*
+ * Read the next pcap record header
+ *
+ * @file [in]: pcap file positioned at a record header
+ * @swapped [in]: true if the file byte order differs from the host one
+ * @rec [out]: record header in host byte order
+ * @return: true if a whole record header was read
+ */
+static bool pcap_rec_hdr_read(FILE *file, bool swapped, struct pcap_rec_hdr *rec)
+{
+	if (fread(rec, sizeof(*rec), 1, file) != 1)
+		return false;
+
+	if (swapped) {
+		rec->incl_len = rte_bswap32(rec->incl_len);
+		rec->orig_len = rte_bswap32(rec->orig_len);
+	}
+
+	return true;
+}
+
+/*
+ * Open a pcap file for reading and validate its header
+ *
+ * @path [in]: pcap file path
+ * @swapped [out]: true if the file byte order differs from the host one
+ * @file [out]: pcap file positioned at the first record
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t pcap_src_open(const char *path, bool *swapped, FILE **file)
+{
+	struct pcap_file_hdr hdr;
+	uint32_t linktype;
+
+	*file = fopen(path, "rb");
+	if (*file == NULL) {
+		DOCA_LOG_ERR("Failed to open pcap file %s: %s", path, strerror(errno));
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, *file) != 1) {
+		DOCA_LOG_ERR("Failed to read pcap file %s header", path);
+		goto invalid;
+	}
+
+	if (hdr.magic == PCAP_MAGIC_USEC || hdr.magic == PCAP_MAGIC_NSEC) {
+		*swapped = false;
+	} else if (hdr.magic == rte_bswap32(PCAP_MAGIC_USEC) || hdr.magic == rte_bswap32(PCAP_MAGIC_NSEC)) {
+		*swapped = true;
+	} else {
+		DOCA_LOG_ERR("File %s is not a pcap file (magic 0x%x)", path, hdr.magic);
+		goto invalid;
+	}
+
+	linktype = *swapped ? rte_bswap32(hdr.linktype) : hdr.linktype;
+	if (linktype != PCAP_LINKTYPE_ETHERNET) {
+		DOCA_LOG_ERR("Unsupported pcap link type %u, only Ethernet captures can be replayed", linktype);
+		goto invalid;
+	}
+
+	return DOCA_SUCCESS;
+
+invalid:
+	fclose(*file);
+	*file = NULL;
+	return DOCA_ERROR_INVALID_VALUE;
+}
+
+doca_error_t ip_frag_replay_src_load(const char *path, struct ip_frag_replay_src *src)
+{
+	struct pcap_rec_hdr rec;
+	uint32_t max_len = 0;
+	uint32_t nb_skipped = 0;
+	struct rte_mbuf *pkt;
+	doca_error_t ret;
+	bool swapped;
+	long data_pos;
+	FILE *file;
+	char *data;
+
+	memset(src, 0, sizeof(*src));
+
+	ret = pcap_src_open(path, &swapped, &file);
+	if (ret != DOCA_SUCCESS)
+		return ret;
+	data_pos = ftell(file);
+
+	/* First pass sizes the mempool: packets count and the largest packet */
+	while (pcap_rec_hdr_read(file, swapped, &rec)) {
+		if (rec.incl_len < rec.orig_len || rec.incl_len > PCAP_SNAPLEN - RTE_PKTMBUF_HEADROOM) {
+			nb_skipped++;
+		} else {
+			src->nb_pkts++;
+			max_len = RTE_MAX(max_len, rec.incl_len);
+		}
+
+		if (fseek(file, rec.incl_len, SEEK_CUR)) {
+			DOCA_LOG_ERR("Truncated pcap file %s", path);
+			ret = DOCA_ERROR_IO_FAILED;
+			goto close_file;
+		}
+	}
+
+	if (src->nb_pkts == 0) {
+		DOCA_LOG_ERR("No packets to replay in pcap file %s", path);
+		ret = DOCA_ERROR_INVALID_VALUE;
+		goto close_file;
+	}
+	if (nb_skipped)
+		DOCA_LOG_WARN("Skipping %u truncated or oversized packets of pcap file %s", nb_skipped, path);
+
+	src->data_room_size = RTE_MAX(RTE_MBUF_DEFAULT_BUF_SIZE, RTE_PKTMBUF_HEADROOM + max_len);
+	src->pool = rte_pktmbuf_pool_create("Replay capture", src->nb_pkts, 0, 0, src->data_room_size, rte_socket_id());
+	if (src->pool == NULL) {
+		DOCA_LOG_ERR("Failed to allocate replay capture mempool of %u packets", src->nb_pkts);
+		ret = DOCA_ERROR_NO_MEMORY;
+		goto close_file;
+	}
+
+	src->pkts = rte_calloc("Replay capture", src->nb_pkts, sizeof(*src->pkts), 0);
+	if (src->pkts == NULL) {
+		DOCA_LOG_ERR("Failed to allocate replay capture packets array");
+		ret = DOCA_ERROR_NO_MEMORY;
+		goto destroy_src;
+	}
+
+	/* Second pass copies the packets into the mempool */
+	fseek(file, data_pos, SEEK_SET);
+	src->nb_pkts = 0;
+	while (pcap_rec_hdr_read(file, swapped, &rec)) {
+		if (rec.incl_len < rec.orig_len || rec.incl_len > PCAP_SNAPLEN - RTE_PKTMBUF_HEADROOM) {
+			fseek(file, rec.incl_len, SEEK_CUR);
+			continue;
+		}
+
+		pkt = rte_pktmbuf_alloc(src->pool);
+		data = pkt ? rte_pktmbuf_append(pkt, rec.incl_len) : NULL;
+		if (data == NULL || fread(data, rec.incl_len, 1, file) != 1) {
+			DOCA_LOG_ERR("Failed to load packet %u of pcap file %s", src->nb_pkts, path);
+			rte_pktmbuf_free(pkt);
+			ret = DOCA_ERROR_IO_FAILED;
+			goto destroy_src;
+		}
+		src->pkts[src->nb_pkts++] = pkt;
+	}
+
+	fclose(file);
+	DOCA_LOG_INFO("Loaded %u packets from pcap file %s, largest packet is %u bytes", src->nb_pkts, path, max_len);
+	return DOCA_SUCCESS;
+
+destroy_src:
+	ip_frag_replay_src_destroy(src);
+close_file:
+	fclose(file);
+	return ret;
+}
+
+void ip_frag_replay_src_destroy(struct ip_frag_replay_src *src)
+{
+	uint32_t i;
+
+	if (src->pkts) {
+		for (i = 0; i < src->nb_pkts; i++)
+			rte_pktmbuf_free(src->pkts[i]);
+		rte_free(src->pkts);
+	}
+	rte_mempool_free(src->pool);
+	memset(src, 0, sizeof(*src));
+}
+
+doca_error_t ip_frag_pcap_sink_open(const char *path, FILE **sink)
+{
+	const struct pcap_file_hdr hdr = {
+		.magic = PCAP_MAGIC_USEC,
+		.version_major = PCAP_VERSION_MAJOR,
+		.version_minor = PCAP_VERSION_MINOR,
+		.snaplen = PCAP_SNAPLEN,
+		.linktype = PCAP_LINKTYPE_ETHERNET,
+	};
+
+	*sink = fopen(path, "wb");
+	if (*sink == NULL) {
+		DOCA_LOG_ERR("Failed to create pcap file %s: %s", path, strerror(errno));
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	if (fwrite(&hdr, sizeof(hdr), 1, *sink) != 1) {
+		DOCA_LOG_ERR("Failed to write pcap file %s header", path);
+		fclose(*sink);
+		*sink = NULL;
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+void ip_frag_pcap_sink_write(FILE *sink, const struct rte_mbuf *pkt)
+{
+	struct pcap_rec_hdr rec;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	rec.ts_sec = ts.tv_sec;
+	rec.ts_frac = ts.tv_nsec / 1000;
+	rec.incl_len = rte_pktmbuf_pkt_len(pkt);
+	rec.orig_len = rte_pktmbuf_pkt_len(pkt);
+	fwrite(&rec, sizeof(rec), 1, sink);
+
+	for (; pkt; pkt = pkt->next)
+		fwrite(rte_pktmbuf_mtod(pkt, const void *), rte_pktmbuf_data_len(pkt), 1, sink);
+}
+
+void ip_frag_pcap_sink_close(FILE *sink)
+{
+	fclose(sink);
+}
+
+bool ip_frag_replay_pkt_equal(const struct rte_mbuf *pkt, const struct rte_mbuf *ref)
+{
+	const uint8_t *ref_data = rte_pktmbuf_mtod(ref, const uint8_t *);
+
+	if (rte_pktmbuf_pkt_len(pkt) != rte_pktmbuf_pkt_len(ref))
+		return false;
+
+	for (; pkt; pkt = pkt->next) {
+		if (memcmp(rte_pktmbuf_mtod(pkt, const void *), ref_data, rte_pktmbuf_data_len(pkt)))
+			return false;
+		ref_data += rte_pktmbuf_data_len(pkt);
+	}
+
+	return true;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef IP_FRAG_REPLAY_H_
+#define IP_FRAG_REPLAY_H_
+
+#include <doca_error.h>
+
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+
+struct ip_frag_replay_src {
+	struct rte_mempool *pool; /* Mempool holding the loaded packets */
+	struct rte_mbuf **pkts;	  /* Loaded packets, in capture order */
+	uint32_t nb_pkts;	  /* Number of loaded packets */
+	uint16_t data_room_size;  /* Mbuf data room size large enough to hold any loaded packet */
+};
+
+/*
+ * Load all packets of a pcap capture into a dedicated mempool
+ *
+ * @path [in]: pcap file path, must be an Ethernet capture
+ * @src [out]: loaded capture
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t ip_frag_replay_src_load(const char *path, struct ip_frag_replay_src *src);
+
+/*
+ * Free a loaded capture
+ *
+ * @src [in]: loaded capture
+ */
+void ip_frag_replay_src_destroy(struct ip_frag_replay_src *src);
+
+/*
+ * Create a pcap file and write its header
+ *
+ * @path [in]: pcap file path
+ * @sink [out]: opened pcap file
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t ip_frag_pcap_sink_open(const char *path, FILE **sink);
+
+/*
+ * Append a (possibly chained) packet to a pcap file
+ *
+ * @sink [in]: pcap file
+ * @pkt [in]: packet
+ */
+void ip_frag_pcap_sink_write(FILE *sink, const struct rte_mbuf *pkt);
+
+/*
+ * Close a pcap file
+ *
+ * @sink [in]: pcap file
+ */
+void ip_frag_pcap_sink_close(FILE *sink);
+
+/*
+ * Compare a (possibly chained) packet with a contiguous reference packet
+ *
+ * @pkt [in]: packet
+ * @ref [in]: single segment reference packet
+ * @return: true if both packets hold the same bytes
+ */
+bool ip_frag_replay_pkt_equal(const struct rte_mbuf *pkt, const struct rte_mbuf *ref);
+
+#endif /* IP_FRAG_REPLAY_H_ */
@@ -24,6 +24,10 @@
  */
 
 #include <ctype.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
 #include <json-c/json.h>
 
 #include <rte_hash_crc.h>
@@ -40,6 +44,8 @@
 DOCA_LOG_REGISTER(IPSEC_SECURITY_GW::config);
 
 #define MAX_CORES (32)
+#define CONFIG_READ_CHUNK_SIZE (64 * 1024)  /* Bytes of the config file fed to the JSON tokener at a time */
+#define CONFIG_MIN_RULES_PER_WORKER (4096) /* Smallest rule range worth converting on its own thread */
 
 /*
  * Parse hex key string to array of uint8_t
@@ -475,18 +481,15 @@ static doca_error_t parse_encrypt_ipv4(struct json_object *cur_rule, struct encr
 }
 
 /*
- * Parse IPv6 encrypt addresses from json object rule
+ * Parse IPv6 encrypt addresses from json object rule, the addresses are added to the IPv6 table once all the rules
+ * are parsed
  *
  * @cur_rule [in]: json object of the current rule to parse
  * @rule [out]: the current encrypt rule to fill
- * @ip6_table [out]: created hash table with IP addresses
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t parse_encrypt_ipv6(struct json_object *cur_rule,
-				       struct encrypt_rule *rule,
-				       struct rte_hash **ip6_table)
+static doca_error_t parse_encrypt_ipv6(struct json_object *cur_rule, struct encrypt_rule *rule)
 {
-	int ret;
 	doca_error_t result;
 
 	result = create_ipv6(cur_rule, "src-ip", rule->ip6.src_ip);
@@ -497,24 +500,6 @@ static doca_error_t parse_encrypt_ipv6(struct json_object *cur_rule,
 	if (result != DOCA_SUCCESS)
 		return result;
 
-	ret = rte_hash_lookup(*ip6_table, (void *)rule->ip6.src_ip);
-	if (ret < 0) {
-		ret = rte_hash_add_key(*ip6_table, rule->ip6.src_ip);
-		if (ret < 0) {
-			DOCA_LOG_ERR("Failed to add address to hash table");
-			return DOCA_ERROR_DRIVER;
-		}
-	}
-
-	ret = rte_hash_lookup(*ip6_table, (void *)rule->ip6.dst_ip);
-	if (ret < 0) {
-		ret = rte_hash_add_key(*ip6_table, rule->ip6.dst_ip);
-		if (ret < 0) {
-			DOCA_LOG_ERR("Failed to add address to hash table");
-			return DOCA_ERROR_DRIVER;
-		}
-	}
-
 	return DOCA_SUCCESS;
 }
 
@@ -542,160 +527,267 @@ static doca_error_t parse_encrypt_encap_ip(struct json_object *cur_rule, struct
 }
 
 /*
- * Parse json object of the decryption rules and set it in decrypt_rules array
+ * Parse json object of a single decryption rule
  *
- * @json_rules [in]: json object of the rules to parse
- * @app_cfg [in/out]: internal array will hold the decryption rules
+ * @cur_rule [in]: json object of the rule to parse
+ * @rule [out]: the decryption rule to fill
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t parse_json_decrypt_rules(struct json_object *json_rules, struct ipsec_security_gw_config *app_cfg)
+static doca_error_t parse_json_decrypt_rule(struct json_object *cur_rule, struct decrypt_rule *rule)
 {
-	int i;
 	doca_error_t result;
-	struct json_object *cur_rule;
 
-	DOCA_LOG_DBG("Number of decrypt rules in input file: %d", app_cfg->app_rules.nb_decrypt_rules);
+	result = create_l3_type(cur_rule, "ip-version", &rule->l3_type);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-	for (i = 0; i < app_cfg->app_rules.nb_decrypt_rules; i++) {
-		cur_rule = json_object_array_get_idx(json_rules, i);
-		result = create_l3_type(cur_rule, "ip-version", &app_cfg->app_rules.decrypt_rules[i].l3_type);
+	if (rule->l3_type == DOCA_FLOW_L3_TYPE_IP4) {
+		result = create_ipv4(cur_rule, "dst-ip", &rule->dst_ip4);
 		if (result != DOCA_SUCCESS)
 			return result;
-
-		if (app_cfg->app_rules.decrypt_rules[i].l3_type == DOCA_FLOW_L3_TYPE_IP4) {
-			result = create_ipv4(cur_rule, "dst-ip", &app_cfg->app_rules.decrypt_rules[i].dst_ip4);
-			if (result != DOCA_SUCCESS)
-				return result;
-		} else {
-			result = create_ipv6(cur_rule, "dst-ip", app_cfg->app_rules.decrypt_rules[i].dst_ip6);
-			if (result != DOCA_SUCCESS)
-				return result;
-		}
-		result = create_spi(cur_rule, &app_cfg->app_rules.decrypt_rules[i].esp_spi);
+	} else {
+		result = create_ipv6(cur_rule, "dst-ip", rule->dst_ip6);
 		if (result != DOCA_SUCCESS)
 			return result;
+	}
+	result = create_spi(cur_rule, &rule->esp_spi);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		result = create_l3_type(cur_rule,
-					"inner-ip-version",
-					&app_cfg->app_rules.decrypt_rules[i].inner_l3_type);
-		if (result != DOCA_SUCCESS)
-			return result;
+	result = create_l3_type(cur_rule, "inner-ip-version", &rule->inner_l3_type);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		result = create_key_type(cur_rule, &app_cfg->app_rules.decrypt_rules[i].sa_attrs.key_type);
-		if (result != DOCA_SUCCESS)
-			return result;
+	result = create_key_type(cur_rule, &rule->sa_attrs.key_type);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		result = create_key(cur_rule,
-				    app_cfg->app_rules.decrypt_rules[i].sa_attrs.key_type,
-				    app_cfg->app_rules.decrypt_rules[i].sa_attrs.enc_key_data);
-		if (result != DOCA_SUCCESS)
-			return result;
+	result = create_key(cur_rule, rule->sa_attrs.key_type, rule->sa_attrs.enc_key_data);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		result = create_iv(cur_rule, &app_cfg->app_rules.decrypt_rules[i].sa_attrs.iv);
-		if (result != DOCA_SUCCESS)
-			return result;
+	result = create_iv(cur_rule, &rule->sa_attrs.iv);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		result = create_salt(cur_rule, &app_cfg->app_rules.decrypt_rules[i].sa_attrs.salt);
-		if (result != DOCA_SUCCESS)
-			return result;
+	result = create_salt(cur_rule, &rule->sa_attrs.salt);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		result = create_lifetime_threshold(cur_rule,
-						   &app_cfg->app_rules.decrypt_rules[i].sa_attrs.lifetime_threshold);
-		if (result != DOCA_SUCCESS)
-			return result;
+	result = create_lifetime_threshold(cur_rule, &rule->sa_attrs.lifetime_threshold);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_esn_en(cur_rule, &rule->sa_attrs.esn_en);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		result = create_esn_en(cur_rule, &app_cfg->app_rules.decrypt_rules[i].sa_attrs.esn_en);
-		if (result != DOCA_SUCCESS)
-			return result;
-	}
 	return DOCA_SUCCESS;
 }
 
 /*
- * Parse json object of the encryption rules and set it in encrypt_rules array
+ * Parse json object of a single encryption rule
  *
- * @json_rules [in]: json object of the rules to parse
- * @app_cfg [in/out]: application configuration structure, will holds the encryption rules
+ * @cur_rule [in]: json object of the rule to parse
+ * @mode [in]: application mode, tunnel mode rules carry an encap address
+ * @rule [out]: the encryption rule to fill
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t parse_json_encrypt_rules(struct json_object *json_rules, struct ipsec_security_gw_config *app_cfg)
+static doca_error_t parse_json_encrypt_rule(struct json_object *cur_rule,
+					    enum ipsec_security_gw_mode mode,
+					    struct encrypt_rule *rule)
 {
-	int i;
 	doca_error_t result;
-	struct json_object *cur_rule;
 
-	DOCA_LOG_DBG("Number of encrypt rules in input file: %d", app_cfg->app_rules.nb_encrypt_rules);
+	result = create_l3_type(cur_rule, "ip-version", &rule->l3_type);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-	for (i = 0; i < app_cfg->app_rules.nb_encrypt_rules; i++) {
-		cur_rule = json_object_array_get_idx(json_rules, i);
-		result = create_l3_type(cur_rule, "ip-version", &app_cfg->app_rules.encrypt_rules[i].l3_type);
+	result = create_protocol(cur_rule, &rule->protocol);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_l3_type(cur_rule, "encap-ip-version", &rule->encap_l3_type);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	if (rule->l3_type == DOCA_FLOW_L3_TYPE_IP4) {
+		result = parse_encrypt_ipv4(cur_rule, rule);
 		if (result != DOCA_SUCCESS)
 			return result;
-
-		result = create_protocol(cur_rule, &app_cfg->app_rules.encrypt_rules[i].protocol);
+	} else {
+		result = parse_encrypt_ipv6(cur_rule, rule);
 		if (result != DOCA_SUCCESS)
 			return result;
-
-		result = create_l3_type(cur_rule,
-					"encap-ip-version",
-					&app_cfg->app_rules.encrypt_rules[i].encap_l3_type);
+	}
+	if (mode == IPSEC_SECURITY_GW_TUNNEL) {
+		result = parse_encrypt_encap_ip(cur_rule, rule);
 		if (result != DOCA_SUCCESS)
 			return result;
+	}
+	result = create_port(cur_rule, "src-port", &rule->src_port);
+	if (result != DOCA_SUCCESS)
+		return result;
 
-		if (app_cfg->app_rules.encrypt_rules[i].l3_type == DOCA_FLOW_L3_TYPE_IP4) {
-			result = parse_encrypt_ipv4(cur_rule, &app_cfg->app_rules.encrypt_rules[i]);
-			if (result != DOCA_SUCCESS)
-				return result;
-		} else {
-			result =
-				parse_encrypt_ipv6(cur_rule, &app_cfg->app_rules.encrypt_rules[i], &app_cfg->ip6_table);
-			if (result != DOCA_SUCCESS)
-				return result;
-		}
-		if (app_cfg->mode == IPSEC_SECURITY_GW_TUNNEL) {
-			result = parse_encrypt_encap_ip(cur_rule, &app_cfg->app_rules.encrypt_rules[i]);
-			if (result != DOCA_SUCCESS)
-				return result;
+	result = create_port(cur_rule, "dst-port", &rule->dst_port);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_spi(cur_rule, &rule->esp_spi);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_key_type(cur_rule, &rule->sa_attrs.key_type);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_key(cur_rule, rule->sa_attrs.key_type, rule->sa_attrs.enc_key_data);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_iv(cur_rule, &rule->sa_attrs.iv);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_salt(cur_rule, &rule->sa_attrs.salt);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_lifetime_threshold(cur_rule, &rule->sa_attrs.lifetime_threshold);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = create_esn_en(cur_rule, &rule->sa_attrs.esn_en);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	return DOCA_SUCCESS;
+}
+
+/* Range of rules converted by one worker thread */
+struct rules_parse_job {
+	struct json_object *json_rules;		  /* json array of the rules */
+	struct ipsec_security_gw_config *app_cfg; /* application configuration, holds the rules arrays */
+	bool is_encrypt;			  /* Whether the array holds encryption or decryption rules */
+	int first_rule;				  /* Index of the first rule in the range */
+	int nb_rules;				  /* Number of rules in the range */
+	doca_error_t result;			  /* Result of the conversion */
+};
+
+/*
+ * Convert a range of json rules, the json objects are only read so ranges can be converted concurrently
+ *
+ * @arg [in]: struct rules_parse_job describing the range
+ * @return: NULL
+ */
+static void *parse_json_rules_range(void *arg)
+{
+	struct rules_parse_job *job = (struct rules_parse_job *)arg;
+	struct ipsec_security_gw_config *app_cfg = job->app_cfg;
+	struct json_object *cur_rule;
+	int i;
+
+	job->result = DOCA_SUCCESS;
+	for (i = job->first_rule; i < job->first_rule + job->nb_rules; i++) {
+		cur_rule = json_object_array_get_idx(job->json_rules, i);
+		if (job->is_encrypt)
+			job->result =
+				parse_json_encrypt_rule(cur_rule, app_cfg->mode, &app_cfg->app_rules.encrypt_rules[i]);
+		else
+			job->result = parse_json_decrypt_rule(cur_rule, &app_cfg->app_rules.decrypt_rules[i]);
+		if (job->result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to parse %s rule number %d", job->is_encrypt ? "encrypt" : "decrypt", i);
+			break;
 		}
-		result = create_port(cur_rule, "src-port", &app_cfg->app_rules.encrypt_rules[i].src_port);
-		if (result != DOCA_SUCCESS)
-			return result;
+	}
 
-		result = create_port(cur_rule, "dst-port", &app_cfg->app_rules.encrypt_rules[i].dst_port);
-		if (result != DOCA_SUCCESS)
-			return result;
+	return NULL;
+}
 
-		result = create_spi(cur_rule, &app_cfg->app_rules.encrypt_rules[i].esp_spi);
-		if (result != DOCA_SUCCESS)
-			return result;
+/*
+ * Parse json array of rules into the encrypt_rules or decrypt_rules array. Large arrays are split in contiguous
+ * ranges converted by worker threads.
+ *
+ * @json_rules [in]: json object of the rules to parse
+ * @nb_rules [in]: number of rules in the array
+ * @is_encrypt [in]: whether the array holds encryption or decryption rules
+ * @app_cfg [in/out]: application configuration structure, will hold the rules
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t parse_json_rules(struct json_object *json_rules,
+				     int nb_rules,
+				     bool is_encrypt,
+				     struct ipsec_security_gw_config *app_cfg)
+{
+	struct rules_parse_job jobs[MAX_CORES];
+	pthread_t threads[MAX_CORES];
+	bool started[MAX_CORES] = {false};
+	int nb_workers, rules_per_worker, i;
+	long nb_cpus;
+	doca_error_t result = DOCA_SUCCESS;
 
-		result = create_key_type(cur_rule, &app_cfg->app_rules.encrypt_rules[i].sa_attrs.key_type);
-		if (result != DOCA_SUCCESS)
-			return result;
+	DOCA_LOG_DBG("Number of %s rules in input file: %d", is_encrypt ? "encrypt" : "decrypt", nb_rules);
 
-		result = create_key(cur_rule,
-				    app_cfg->app_rules.encrypt_rules[i].sa_attrs.key_type,
-				    app_cfg->app_rules.encrypt_rules[i].sa_attrs.enc_key_data);
-		if (result != DOCA_SUCCESS)
-			return result;
+	if (nb_rules == 0)
+		return DOCA_SUCCESS;
 
-		result = create_iv(cur_rule, &app_cfg->app_rules.encrypt_rules[i].sa_attrs.iv);
-		if (result != DOCA_SUCCESS)
-			return result;
+	nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	nb_workers = MIN(MAX(nb_cpus, 1), MAX_CORES);
+	nb_workers = MAX(MIN(nb_workers, nb_rules / CONFIG_MIN_RULES_PER_WORKER), 1);
+	rules_per_worker = (nb_rules + nb_workers - 1) / nb_workers;
 
-		result = create_salt(cur_rule, &app_cfg->app_rules.encrypt_rules[i].sa_attrs.salt);
-		if (result != DOCA_SUCCESS)
-			return result;
+	for (i = 0; i < nb_workers; i++) {
+		jobs[i].json_rules = json_rules;
+		jobs[i].app_cfg = app_cfg;
+		jobs[i].is_encrypt = is_encrypt;
+		jobs[i].first_rule = MIN(i * rules_per_worker, nb_rules);
+		jobs[i].nb_rules = MIN(rules_per_worker, nb_rules - jobs[i].first_rule);
+	}
 
-		result = create_lifetime_threshold(cur_rule,
-						   &app_cfg->app_rules.encrypt_rules[i].sa_attrs.lifetime_threshold);
-		if (result != DOCA_SUCCESS)
-			return result;
+	/* The calling thread converts the first range itself */
+	for (i = 1; i < nb_workers; i++) {
+		if (pthread_create(&threads[i], NULL, parse_json_rules_range, &jobs[i]) == 0)
+			started[i] = true;
+		else
+			parse_json_rules_range(&jobs[i]);
+	}
+	parse_json_rules_range(&jobs[0]);
 
-		result = create_esn_en(cur_rule, &app_cfg->app_rules.encrypt_rules[i].sa_attrs.esn_en);
-		if (result != DOCA_SUCCESS)
-			return result;
+	for (i = 0; i < nb_workers; i++) {
+		if (started[i])
+			pthread_join(threads[i], NULL);
+		if (result == DOCA_SUCCESS)
+			result = jobs[i].result;
+	}
+
+	return result;
+}
+
+/*
+ * Add the IPv6 addresses of the encryption rules to the IPv6 table. Adding an existing key returns its index, so
+ * every address is added without a lookup first. Rules are visited in file order so the ids match a rule by rule
+ * insertion.
+ *
+ * @app_cfg [in/out]: application configuration structure, holds the rules and the table
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t load_ip6_table(struct ipsec_security_gw_config *app_cfg)
+{
+	struct encrypt_rule *rule;
+	int i;
+
+	for (i = 0; i < app_cfg->app_rules.nb_encrypt_rules; i++) {
+		rule = &app_cfg->app_rules.encrypt_rules[i];
+		if (rule->l3_type != DOCA_FLOW_L3_TYPE_IP6)
+			continue;
+
+		if (rte_hash_add_key(app_cfg->ip6_table, rule->ip6.src_ip) < 0 ||
+		    rte_hash_add_key(app_cfg->ip6_table, rule->ip6.dst_ip) < 0) {
+			DOCA_LOG_ERR("Failed to add address to hash table");
+			return DOCA_ERROR_DRIVER;
+		}
 	}
+
 	return DOCA_SUCCESS;
 }
 
@@ -1121,42 +1213,103 @@ static doca_error_t parse_json_config(struct json_object *json_config, struct ip
 }
 
 /*
- * Check the input file size and allocate a buffer to read it
+ * Read and tokenize the json config file in fixed size chunks, so the raw file is never held in memory as a whole
+ * next to the parsed object tree
  *
- * @fp [in]: file pointer to the input rules file
+ * @json_path [in]: path of the json config file
+ * @parsed_json [out]: parsed json object, to be released with json_object_put()
  * @file_length [out]: total bytes in file
- * @json_data [out]: allocated buffer, with null termination
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t allocate_json_buffer_dynamic(FILE *fp, size_t *file_length, char **json_data)
+static doca_error_t read_json_stream(const char *json_path, struct json_object **parsed_json, size_t *file_length)
 {
-	ssize_t buf_len = 0;
-
-	/* use fseek to put file counter to the end, and calculate file length */
-	if (fseek(fp, 0L, SEEK_END) == 0) {
-		buf_len = ftell(fp);
-		if (buf_len < 0) {
-			DOCA_LOG_ERR("ftell() function failed");
-			return DOCA_ERROR_IO_FAILED;
-		}
+	struct json_tokener *tokener;
+	struct json_object *json = NULL;
+	enum json_tokener_error jerr = json_tokener_continue;
+	char *chunk;
+	size_t chunk_len;
+	FILE *json_fp;
+	doca_error_t result = DOCA_SUCCESS;
 
-		/* dynamic allocation */
-		*json_data = (char *)calloc(1, buf_len + 1);
-		if (*json_data == NULL) {
-			DOCA_LOG_ERR("malloc() function failed");
-			return DOCA_ERROR_NO_MEMORY;
-		}
+	*file_length = 0;
 
-		/* return file counter to the beginning */
-		if (fseek(fp, 0L, SEEK_SET) != 0) {
-			free(*json_data);
-			*json_data = NULL;
-			DOCA_LOG_ERR("fseek() function failed");
-			return DOCA_ERROR_IO_FAILED;
-		}
+	json_fp = fopen(json_path, "r");
+	if (json_fp == NULL) {
+		DOCA_LOG_ERR("JSON file open failed");
+		return DOCA_ERROR_IO_FAILED;
 	}
-	*file_length = buf_len;
-	return DOCA_SUCCESS;
+
+	chunk = (char *)malloc(CONFIG_READ_CHUNK_SIZE);
+	tokener = json_tokener_new();
+	if (chunk == NULL || tokener == NULL) {
+		DOCA_LOG_ERR("Failed to allocate json tokener");
+		result = DOCA_ERROR_NO_MEMORY;
+		goto close_file;
+	}
+
+	while (jerr == json_tokener_continue) {
+		chunk_len = fread(chunk, 1, CONFIG_READ_CHUNK_SIZE, json_fp);
+		if (chunk_len == 0)
+			break;
+		*file_length += chunk_len;
+
+		json = json_tokener_parse_ex(tokener, chunk, chunk_len);
+		jerr = json_tokener_get_error(tokener);
+	}
+
+	if (ferror(json_fp)) {
+		DOCA_LOG_ERR("Failed to read JSON file");
+		result = DOCA_ERROR_IO_FAILED;
+	} else if (jerr == json_tokener_continue) {
+		DOCA_LOG_ERR("JSON file ended before the config was complete");
+		result = DOCA_ERROR_INVALID_VALUE;
+	} else if (jerr != json_tokener_success || json == NULL) {
+		DOCA_LOG_ERR("Failed to parse JSON file: %s", json_tokener_error_desc(jerr));
+		result = DOCA_ERROR_INVALID_VALUE;
+	}
+
+	if (result != DOCA_SUCCESS && json != NULL) {
+		json_object_put(json);
+		json = NULL;
+	}
+	*parsed_json = json;
+
+close_file:
+	if (tokener != NULL)
+		json_tokener_free(tokener);
+	free(chunk);
+	fclose(json_fp);
+	return result;
+}
+
+/*
+ * Log the rate rules were loaded at and the peak resident memory of the process
+ *
+ * @app_cfg [in]: application configuration structure, holds the loaded rules
+ * @file_length [in]: size of the config file
+ * @start [in]: time config loading started
+ */
+static void report_config_load(struct ipsec_security_gw_config *app_cfg, size_t file_length, struct timespec *start)
+{
+	struct rusage usage;
+	struct timespec end;
+	double secs;
+	int nb_rules = app_cfg->app_rules.nb_encrypt_rules + app_cfg->app_rules.nb_decrypt_rules;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	secs = (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+	if (secs <= 0)
+		secs = 1e-9;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		usage.ru_maxrss = 0;
+
+	DOCA_LOG_INFO("Loaded %d rules from %zu bytes of config in %.3f s (%.0f rules/s), peak RSS %ld KB",
+		      nb_rules,
+		      file_length,
+		      secs,
+		      nb_rules / secs,
+		      usage.ru_maxrss);
 }
 
 /*
@@ -1235,9 +1388,8 @@ static doca_error_t create_ip6_table(struct rte_hash **ip6_table)
 
 doca_error_t ipsec_security_gw_parse_config(struct ipsec_security_gw_config *app_cfg)
 {
-	FILE *json_fp;
 	size_t file_length;
-	char *json_data = NULL;
+	struct timespec start;
 	struct json_object *parsed_json;
 	struct json_object *json_encrypt_rules;
 	struct json_object *json_decrypt_rules;
@@ -1254,25 +1406,14 @@ doca_error_t ipsec_security_gw_parse_config(struct ipsec_security_gw_config *app
 	/* set default DOCA Flow mode to vnf */
 	app_cfg->flow_mode = IPSEC_SECURITY_GW_VNF;
 
-	json_fp = fopen(app_cfg->json_path, "r");
-	if (json_fp == NULL) {
-		DOCA_LOG_ERR("JSON file open failed");
-		return DOCA_ERROR_IO_FAILED;
-	}
+	clock_gettime(CLOCK_MONOTONIC, &start);
 
-	result = allocate_json_buffer_dynamic(json_fp, &file_length, &json_data);
+	result = read_json_stream(app_cfg->json_path, &parsed_json, &file_length);
 	if (result != DOCA_SUCCESS) {
-		fclose(json_fp);
-		DOCA_LOG_ERR("Failed to allocate data buffer for the json file");
+		DOCA_LOG_ERR("Failed to read the json file");
 		return result;
 	}
 
-	if (fread(json_data, 1, file_length, json_fp) < file_length)
-		DOCA_LOG_DBG("EOF reached");
-	fclose(json_fp);
-
-	parsed_json = json_tokener_parse(json_data);
-
 	if (json_object_object_get_ex(parsed_json, "config", &json_config)) {
 		result = parse_json_config(json_config, app_cfg);
 		if (result != DOCA_SUCCESS) {
@@ -1342,20 +1483,25 @@ doca_error_t ipsec_security_gw_parse_config(struct ipsec_security_gw_config *app
 
 	/* parse the rules and insert to the allocated arrays */
 	if (!app_cfg->socket_ctx.socket_conf) {
-		result = parse_json_encrypt_rules(json_encrypt_rules, app_cfg);
+		result = parse_json_rules(json_encrypt_rules, app_cfg->app_rules.nb_encrypt_rules, true, app_cfg);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to parse encrypt rules");
 			goto dec_enc_release;
 		}
 
-		result = parse_json_decrypt_rules(json_decrypt_rules, app_cfg);
+		result = parse_json_rules(json_decrypt_rules, app_cfg->app_rules.nb_decrypt_rules, false, app_cfg);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to parse decrypt rules");
 			goto dec_enc_release;
 		}
+
+		result = load_ip6_table(app_cfg);
+		if (result != DOCA_SUCCESS)
+			goto dec_enc_release;
+
+		report_config_load(app_cfg, file_length, &start);
 	}
 	json_object_put(parsed_json);
-	free(json_data);
 	return DOCA_SUCCESS;
 dec_enc_release:
 	free(app_cfg->app_rules.decrypt_rules);
@@ -1363,7 +1509,6 @@ encrypt_release:
 	free(app_cfg->app_rules.encrypt_rules);
 json_release:
 	json_object_put(parsed_json);
-	free(json_data);
 	return result;
 }
 
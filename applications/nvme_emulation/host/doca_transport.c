@@ -23,6 +23,7 @@
  *
  */
 
+#include "spdk/json.h"
 #include "spdk/nvmf_transport.h"
 #include "spdk/util.h"
 #include "spdk/thread.h"
@@ -38,6 +39,7 @@
 #include "nvme_pci_common.h"
 #include "nvme_pci_type_config.h"
 #include "nvmf_doca_io.h"
+#include "nvmf_doca_io_common.h"
 
 DOCA_LOG_REGISTER(NVME_EMULATION_DOCA_TRANSPORT);
 
@@ -53,6 +55,8 @@ DOCA_LOG_REGISTER(NVME_EMULATION_DOCA_TRANSPORT);
 #define NVMF_DOCA_DEFAULT_BUFFER_CACHE_SIZE 0
 #define NVMF_DOCA_DIF_INSERT_OR_STRIP false
 #define NVMF_DOCA_DEFAULT_ABORT_TIMEOUT_SEC 1
+#define NVMF_DOCA_DEFAULT_DMA_POOL_64K_BUFS 16
+#define NVMF_DOCA_DEFAULT_DMA_POOL_1M_BUFS 0
 
 #define NVMF_ADMIN_QUEUE_ID 0
 #define ADMIN_QP_POLL_RATE_LIMIT 1000
@@ -164,8 +168,14 @@ struct nvmf_doca_admin_poll_group {
 	TAILQ_HEAD(, nvmf_doca_pci_dev_admin) pci_dev_admins; /**< PCI devices list */
 };
 
+struct nvmf_doca_transport_opts {
+	uint32_t dma_pool_64k_bufs; /**< Number of 64KiB DPU data buffers allocated per IO SQ */
+	uint32_t dma_pool_1m_bufs;  /**< Number of 1MiB DPU data buffers allocated per IO SQ */
+};
+
 struct nvmf_doca_transport {
 	struct spdk_nvmf_transport transport;			      /**< NVMF transport */
+	struct nvmf_doca_transport_opts doca_opts;		      /**< DOCA transport specific options */
 	TAILQ_HEAD(, nvmf_doca_emulation_manager) emulation_managers; /**< Emulation managers list */
 	TAILQ_HEAD(, nvmf_doca_poll_group) poll_groups;		      /**< Doca poll group list */
 	struct nvmf_doca_poll_group *last_selected_pg;		      /**< Last selected poll group for round robin */
@@ -174,9 +184,6 @@ struct nvmf_doca_transport {
 };
 
 /* Static functions forward declarations */
-#define NVME_PAGE_SIZE 4096
-
-static void post_cqe_from_response(struct nvmf_doca_request *request, void *arg);
 static void nvmf_doca_on_post_cqe_complete(struct nvmf_doca_cq *cq, union doca_data user_data);
 static void nvmf_doca_on_fetch_sqe_complete(struct nvmf_doca_sq *sq, struct nvmf_doca_sqe *sqe, uint16_t sqe_idx);
 static void nvmf_doca_on_copy_data_complete(struct nvmf_doca_sq *sq,
@@ -185,10 +192,6 @@ static void nvmf_doca_on_copy_data_complete(struct nvmf_doca_sq *sq,
 					    union doca_data user_data);
 static void nvmf_doca_on_post_nvm_cqe_complete(struct nvmf_doca_cq *cq, union doca_data user_data);
 static void nvmf_doca_on_fetch_nvm_sqe_complete(struct nvmf_doca_sq *sq, struct nvmf_doca_sqe *sqe, uint16_t sqe_idx);
-static void nvmf_doca_on_copy_nvm_data_complete(struct nvmf_doca_sq *sq,
-						struct doca_buf *dst,
-						struct doca_buf *src,
-						union doca_data user_data);
 static void nvmf_doca_pci_dev_admin_reset_continue(struct nvmf_doca_pci_dev_admin *pci_dev_admin);
 static void handle_controller_register_events(struct doca_devemu_pci_dev *pci_dev,
 					      const struct bar_region_config *config);
@@ -199,8 +202,15 @@ static void nvmf_doca_on_admin_sq_stop(struct nvmf_doca_sq *sq);
 static doca_error_t nvmf_doca_create_host_mmap(struct doca_devemu_pci_dev *pci_dev,
 					       struct doca_dev *emulation_manager,
 					       struct doca_mmap **mmap_out);
-static void buffers_ready_copy_data_dpu_to_host(struct nvmf_doca_request *request);
-static void buffers_ready_copy_data_host_to_dpu(struct nvmf_doca_request *request);
+static void nvmf_doca_spdk_request_exec(struct nvmf_doca_request *request);
+
+/* NVM commands move data and CQEs with DMA and are executed by the NVMf target */
+static const struct nvmf_doca_io_ops nvmf_doca_transport_io_ops = {
+	.copy_data = nvmf_doca_sq_copy_data,
+	.post_cqe = nvmf_doca_io_post_cqe,
+	.exec = nvmf_doca_spdk_request_exec,
+};
+
 static void nvmf_doca_opts_init(struct spdk_nvmf_transport_opts *opts)
 {
 	DOCA_LOG_DBG("Entering function %s", __func__);
@@ -589,6 +599,14 @@ static doca_error_t nvmf_doca_admin_poll_group_create(struct nvmf_doca_admin_pol
 	return DOCA_SUCCESS;
 }
 
+static const struct spdk_json_object_decoder nvmf_doca_transport_opts_decoder[] = {
+	{"dma_pool_64k_bufs",
+	 offsetof(struct nvmf_doca_transport_opts, dma_pool_64k_bufs),
+	 spdk_json_decode_uint32,
+	 true},
+	{"dma_pool_1m_bufs", offsetof(struct nvmf_doca_transport_opts, dma_pool_1m_bufs), spdk_json_decode_uint32, true},
+};
+
 /*
  * Creates the DOCA transport
  *
@@ -600,8 +618,6 @@ static doca_error_t nvmf_doca_admin_poll_group_create(struct nvmf_doca_admin_pol
  */
 static struct spdk_nvmf_transport *nvmf_doca_create(struct spdk_nvmf_transport_opts *opts)
 {
-	(void)opts;
-
 	DOCA_LOG_DBG("Entering function %s", __func__);
 
 	struct doca_devinfo **dev_list;
@@ -620,6 +636,18 @@ static struct spdk_nvmf_transport *nvmf_doca_create(struct spdk_nvmf_transport_o
 	TAILQ_INIT(&doca_transport->emulation_managers);
 	doca_transport->last_selected_pg = NULL;
 
+	doca_transport->doca_opts.dma_pool_64k_bufs = NVMF_DOCA_DEFAULT_DMA_POOL_64K_BUFS;
+	doca_transport->doca_opts.dma_pool_1m_bufs = NVMF_DOCA_DEFAULT_DMA_POOL_1M_BUFS;
+	if (opts->transport_specific != NULL &&
+	    spdk_json_decode_object_relaxed(opts->transport_specific,
+					    nvmf_doca_transport_opts_decoder,
+					    SPDK_COUNTOF(nvmf_doca_transport_opts_decoder),
+					    &doca_transport->doca_opts)) {
+		DOCA_LOG_ERR("Failed to decode DOCA transport specific options");
+		free(doca_transport);
+		return NULL;
+	}
+
 	ret = doca_devinfo_create_list(&dev_list, &nb_devs);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Method doca_devinfo_create_list failed: %s", doca_error_get_name(ret));
@@ -683,8 +711,10 @@ static void nvmf_doca_dump_opts(struct spdk_nvmf_transport *transport, struct sp
 {
 	DOCA_LOG_DBG("Entering function %s", __func__);
 
-	(void)transport;
-	(void)w;
+	struct nvmf_doca_transport *doca_transport = SPDK_CONTAINEROF(transport, struct nvmf_doca_transport, transport);
+
+	spdk_json_write_named_uint32(w, "dma_pool_64k_bufs", doca_transport->doca_opts.dma_pool_64k_bufs);
+	spdk_json_write_named_uint32(w, "dma_pool_1m_bufs", doca_transport->doca_opts.dma_pool_1m_bufs);
 }
 
 /*
@@ -924,7 +954,7 @@ static void nvmf_doca_pci_dev_poll_group_stop_io_sq_done(void *ctx)
 		free(delete_io_sq_ctx);
 
 		request->request.rsp->nvme_cpl.cid = request->request.cmd->nvme_cmd.cid;
-		post_cqe_from_response(request, request);
+		nvmf_doca_request_post_cqe(request, request);
 	}
 }
 
@@ -994,7 +1024,7 @@ static void nvmf_doca_pci_dev_poll_group_stop_io_cq_done(void *ctx)
 		free(delete_io_cq_ctx);
 
 		request->request.rsp->nvme_cpl.cid = request->request.cmd->nvme_cmd.cid;
-		post_cqe_from_response(request, request);
+		nvmf_doca_request_post_cqe(request, request);
 	}
 }
 
@@ -1232,6 +1262,7 @@ static void nvmf_doca_create_admin_qp(void *cb_arg)
 		.copy_data_cb = nvmf_doca_on_copy_data_complete,
 		.stop_sq_cb = nvmf_doca_on_admin_sq_stop,
 		.stop_io_cb = nvmf_doca_on_admin_cq_stop,
+		.ops = &nvmf_doca_transport_io_ops,
 	};
 
 	struct nvmf_doca_io *emulated_cq = calloc(1, sizeof(*emulated_cq));
@@ -2049,6 +2080,58 @@ static void nvmf_doca_poll_group_destroy(struct spdk_nvmf_transport_poll_group *
 	free(doca_pg);
 }
 
+/*
+ * Dump the DMA pool counters of all SQs handled by the poll group into JSON
+ *
+ * Callback invoked by the NVMf target once user issues the get stats RPC, on the thread of the poll group
+ *
+ * @group [in]: The poll group
+ * @w [out]: The JSON dump
+ */
+static void nvmf_doca_poll_group_dump_stat(struct spdk_nvmf_transport_poll_group *group, struct spdk_json_write_ctx *w)
+{
+	struct nvmf_doca_poll_group *doca_pg = SPDK_CONTAINEROF(group, struct nvmf_doca_poll_group, pg);
+	struct nvmf_doca_dma_pool_class_stats totals[NVMF_DOCA_DMA_POOL_NUM_CLASSES] = {0};
+	uint32_t buf_sizes[NVMF_DOCA_DMA_POOL_NUM_CLASSES] = {0};
+	uint64_t num_bufs[NVMF_DOCA_DMA_POOL_NUM_CLASSES] = {0};
+	struct nvmf_doca_pci_dev_poll_group *pci_dev_pg;
+	struct nvmf_doca_io *io;
+	struct nvmf_doca_sq *sq;
+
+	TAILQ_FOREACH(pci_dev_pg, &doca_pg->pci_dev_pg_list, link)
+	{
+		TAILQ_FOREACH(io, &pci_dev_pg->io_cqs, pci_dev_pg_link)
+		{
+			TAILQ_FOREACH(sq, &io->sq_list, link)
+			{
+				for (int cls = 0; cls < NVMF_DOCA_DMA_POOL_NUM_CLASSES; cls++) {
+					const struct nvmf_doca_dma_pool_class *pool_class = &sq->dma_pool.classes[cls];
+
+					buf_sizes[cls] = pool_class->buf_size;
+					num_bufs[cls] += pool_class->num_bufs;
+					totals[cls].requests += pool_class->stats.requests;
+					totals[cls].misses += pool_class->stats.misses;
+					totals[cls].allocs += pool_class->stats.allocs;
+					totals[cls].bytes += pool_class->stats.bytes;
+				}
+			}
+		}
+	}
+
+	spdk_json_write_named_array_begin(w, "dma_pool_classes");
+	for (int cls = 0; cls < NVMF_DOCA_DMA_POOL_NUM_CLASSES; cls++) {
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_uint32(w, "buf_size", buf_sizes[cls]);
+		spdk_json_write_named_uint64(w, "num_bufs", num_bufs[cls]);
+		spdk_json_write_named_uint64(w, "requests", totals[cls].requests);
+		spdk_json_write_named_uint64(w, "misses", totals[cls].misses);
+		spdk_json_write_named_uint64(w, "allocs", totals[cls].allocs);
+		spdk_json_write_named_uint64(w, "bytes", totals[cls].bytes);
+		spdk_json_write_object_end(w);
+	}
+	spdk_json_write_array_end(w);
+}
+
 /*
  * Picks the optimal poll group to add the QP to
  *
@@ -2412,130 +2495,13 @@ static int nvmf_doca_qpair_get_listen_trid(struct spdk_nvmf_qpair *qpair, struct
 #define FEAT_CMD_HOST_IDENTIFIER_SIZE 8
 
 /*
- * Map the data described by PRP list entries used in NVME command in IOV structres
- *
- * @request [in]: The NVMf request which holds the ??
- * @arg [in]: Argument associated with the callback
- */
-static void copy_prp_list_data(struct nvmf_doca_request *request, void *arg)
-{
-	DOCA_LOG_TRC("Entering function %s", __func__);
-
-	(void)arg;
-	void *data_out_address;
-	uintptr_t *prp_list_addr;
-	uint32_t idx = 1; /* idx 0 is already occupied */
-	uint32_t remaining_length;
-	uint32_t length = request->residual_length;
-
-	doca_buf_get_head(request->prp_dpu_buf, (void **)&prp_list_addr);
-
-	doca_buf_dec_refcount(request->prp_dpu_buf, NULL);
-	request->prp_dpu_buf = NULL;
-	doca_buf_dec_refcount(request->prp_host_buf, NULL);
-	request->prp_host_buf = NULL;
-
-	/* Iterate over the prp entries */
-	while (length != 0) {
-		remaining_length = spdk_min(length, NVME_PAGE_SIZE);
-
-		request->host_buffer[idx] = nvmf_doca_sq_get_host_buffer(request->doca_sq, prp_list_addr[idx - 1]);
-		request->dpu_buffer[idx] = nvmf_doca_sq_get_dpu_buffer(request->doca_sq);
-		doca_buf_get_head(request->dpu_buffer[idx], &data_out_address);
-
-		request->request.iov[idx].iov_base = data_out_address;
-		request->request.iov[idx].iov_len = remaining_length;
-		request->request.iovcnt++;
-
-		length -= remaining_length;
-		idx++;
-	}
-	request->num_of_buffers = request->request.iovcnt;
-
-	if (request->request.cmd->nvme_cmd.opc == SPDK_NVME_OPC_WRITE) {
-		buffers_ready_copy_data_host_to_dpu(request);
-	} else {
-		buffers_ready_copy_data_dpu_to_host(request);
-	}
-}
-
-/*
- * This method is responsible for mapping the data described by PRP entries used in NVME command in IOV structres.
+ * Execute the request by the NVMf target, the transport completes it through nvmf_doca_req_complete()
  *
  * @request [in]: The NVMf request
  */
-static void nvme_cmd_map_prps(struct nvmf_doca_request *request)
+static void nvmf_doca_spdk_request_exec(struct nvmf_doca_request *request)
 {
-	DOCA_LOG_TRC("Entering function %s", __func__);
-
-	uint64_t prp1, prp2;
-	uint32_t remaining_length, number_of_pages;
-	uint64_t *prp_list;
-	uint32_t length = request->request.length;
-
-	prp1 = request->request.cmd->nvme_cmd.dptr.prp.prp1;
-	prp2 = request->request.cmd->nvme_cmd.dptr.prp.prp2;
-
-	/* PRP1 may start with unaligned page address */
-	remaining_length = NVME_PAGE_SIZE - (prp1 % NVME_PAGE_SIZE);
-	remaining_length = spdk_min(length, remaining_length);
-
-	void *data_out_address;
-	request->host_buffer[0] = nvmf_doca_sq_get_host_buffer(request->doca_sq, prp1);
-	request->dpu_buffer[0] = nvmf_doca_sq_get_dpu_buffer(request->doca_sq);
-	doca_buf_get_head(request->dpu_buffer[0], &data_out_address);
-
-	request->request.iov[0].iov_base = data_out_address;
-	request->request.iov[0].iov_len = remaining_length;
-	request->request.iovcnt++;
-
-	length -= remaining_length;
-
-	if (length == 0) {
-		/* There is only one prp entry */
-		request->num_of_buffers = request->request.iovcnt;
-
-		if (request->request.cmd->nvme_cmd.opc == SPDK_NVME_OPC_WRITE) {
-			buffers_ready_copy_data_host_to_dpu(request);
-		} else {
-			buffers_ready_copy_data_dpu_to_host(request);
-		}
-
-	} else if (length <= NVME_PAGE_SIZE) {
-		/* Data crosses exactly one memory page boundray, there are two PRP entries */
-		request->host_buffer[1] = nvmf_doca_sq_get_host_buffer(request->doca_sq, prp2);
-		request->dpu_buffer[1] = nvmf_doca_sq_get_dpu_buffer(request->doca_sq);
-		doca_buf_get_head(request->dpu_buffer[1], &data_out_address);
-
-		request->request.iov[1].iov_base = data_out_address;
-		request->request.iov[1].iov_len = length;
-		request->request.iovcnt++;
-		request->num_of_buffers = request->request.iovcnt;
-
-		if (request->request.cmd->nvme_cmd.opc == SPDK_NVME_OPC_WRITE) {
-			buffers_ready_copy_data_host_to_dpu(request);
-		} else {
-			buffers_ready_copy_data_dpu_to_host(request);
-		}
-	} else {
-		/* PRP list used and prp2 holds a pointer to it*/
-		number_of_pages = SPDK_CEIL_DIV(length, NVME_PAGE_SIZE);
-
-		request->prp_host_buf = nvmf_doca_sq_get_host_buffer(request->doca_sq, prp2);
-		request->prp_dpu_buf = nvmf_doca_sq_get_dpu_buffer(request->doca_sq);
-
-		union doca_data user_data;
-		user_data.ptr = request;
-		request->residual_length = length;
-		request->doca_cb = copy_prp_list_data;
-		request->num_of_buffers = 1;
-
-		nvmf_doca_sq_copy_data(request->doca_sq,
-				       request->prp_dpu_buf,
-				       request->prp_host_buf,
-				       number_of_pages * sizeof(*prp_list),
-				       user_data);
-	}
+	spdk_nvmf_request_exec(&request->request);
 }
 
 /*
@@ -2549,54 +2515,22 @@ static void init_dpu_host_buffers(struct nvmf_doca_request *request)
 
 	if (request->doca_sq->sq_id != NVMF_ADMIN_QUEUE_ID) {
 		if (request->request.cmd->nvme_cmd.psdt == SPDK_NVME_PSDT_PRP) {
-			return nvme_cmd_map_prps(request);
+			return nvmf_doca_request_map_prps(request);
 		}
 	}
 
 	void *data_out_address;
 	uintptr_t host_data_out_io_address = request->request.cmd->nvme_cmd.dptr.prp.prp1;
 	request->num_of_buffers = 1;
-	request->host_buffer[0] = nvmf_doca_sq_get_host_buffer(request->doca_sq, host_data_out_io_address);
+	request->num_segments = 1;
+	request->host_buffer[0] =
+		nvmf_doca_sq_get_host_buffer(request->doca_sq, host_data_out_io_address, DMA_POOL_DATA_BUFFER_SIZE);
 	request->dpu_buffer[0] = nvmf_doca_sq_get_dpu_buffer(request->doca_sq);
 	doca_buf_get_head(request->dpu_buffer[0], &data_out_address);
 	spdk_iov_one(request->request.iov, (int *)&request->request.iovcnt, data_out_address, request->request.length);
 	request->request.data = data_out_address;
 }
 
-/*
- * Post CQE based on the NVMf response
- *
- * @request [in]: The NVMf request which holds the response
- * @arg [in]: Argument associated with the callback
- */
-static void post_cqe_from_response(struct nvmf_doca_request *request, void *arg)
-{
-	(void)arg;
-
-	union doca_data user_data;
-	user_data.ptr = request;
-
-	// Update SQ head
-	request->request.rsp->nvme_cpl.sqhd = request->sqe_idx;
-
-	nvmf_doca_io_post_cqe(request->doca_sq->io,
-			      (const struct nvmf_doca_cqe *)&request->request.rsp->nvme_cpl,
-			      user_data);
-}
-
-/*
- * Post CQE based on the NVMf response
- *
- * @request [in]: The NVMf request which holds the response
- */
-static void post_error_cqe_from_response(struct nvmf_doca_request *request)
-{
-	request->request.rsp->nvme_cpl.cid = request->request.cmd->nvme_cmd.cid;
-	request->request.rsp->nvme_cpl.status.sc = 1;
-
-	post_cqe_from_response(request, request);
-}
-
 /*
  * Begin async operation of copying data from DPU to Host
  *
@@ -2610,7 +2544,7 @@ static void copy_dpu_data_to_host(struct nvmf_doca_request *request, void *arg)
 	(void)arg;
 	union doca_data user_data;
 	user_data.ptr = request;
-	request->doca_cb = post_cqe_from_response;
+	request->doca_cb = nvmf_doca_request_post_cqe;
 
 	if (request->request.cmd->nvme_cmd.opc == SPDK_NVME_OPC_IDENTIFY) {
 		struct spdk_nvme_ctrlr_data *cdata = (struct spdk_nvme_ctrlr_data *)request->request.data;
@@ -2626,32 +2560,6 @@ static void copy_dpu_data_to_host(struct nvmf_doca_request *request, void *arg)
 			       user_data);
 }
 
-/*
- * Begin async operation of copying data from DPU to Host for NVM commands
- *
- * @request [in]: The NVMf request
- * @arg [in]: Argument associated with the callback
- */
-static void copy_nvme_dpu_data_to_host(struct nvmf_doca_request *request, void *arg)
-{
-	DOCA_LOG_TRC("Entering function %s", __func__);
-
-	(void)arg;
-	union doca_data user_data;
-	user_data.ptr = request;
-	request->doca_cb = post_cqe_from_response;
-
-	uint32_t idx = request->num_of_buffers;
-
-	for (idx = 0; idx < request->num_of_buffers; idx++) {
-		nvmf_doca_sq_copy_data(request->doca_sq,
-				       request->host_buffer[idx],
-				       request->dpu_buffer[idx],
-				       request->request.iov[idx].iov_len,
-				       user_data);
-	}
-}
-
 /*
  * Begin async operation of handling NVMe admin command that requires copying data back to Host
  *
@@ -2682,20 +2590,6 @@ static void begin_nvme_cmd_data_dpu_to_host(struct nvmf_doca_request *request)
 	init_dpu_host_buffers(request);
 }
 
-/*
- * Copy data back to host onve the buffers have been inilialized and ready
- *
- * @request [in]: The request of NVM read
- */
-static void buffers_ready_copy_data_dpu_to_host(struct nvmf_doca_request *request)
-{
-	DOCA_LOG_TRC("Entering function %s", __func__);
-
-	request->doca_cb = copy_nvme_dpu_data_to_host;
-
-	spdk_nvmf_request_exec(&request->request);
-}
-
 /*
  * Begin async NVMf request
  *
@@ -2706,7 +2600,7 @@ static void execute_spdk_request(struct nvmf_doca_request *request, void *arg)
 {
 	(void)arg;
 
-	request->doca_cb = post_cqe_from_response;
+	request->doca_cb = nvmf_doca_request_post_cqe;
 	spdk_nvmf_request_exec(&request->request);
 }
 
@@ -2746,31 +2640,6 @@ static void begin_nvme_cmd_data_host_to_dpu(struct nvmf_doca_request *request)
 	init_dpu_host_buffers(request);
 }
 
-/*
- * Copy data to dpu once the buffers have been inilialized and ready
- *
- * @request [in]: The request of NVM write
- */
-static void buffers_ready_copy_data_host_to_dpu(struct nvmf_doca_request *request)
-{
-	DOCA_LOG_TRC("Entering function %s", __func__);
-
-	union doca_data user_data;
-
-	user_data.ptr = request;
-	request->doca_cb = execute_spdk_request;
-
-	uint32_t idx = request->num_of_buffers;
-
-	for (idx = 0; idx < request->num_of_buffers; idx++) {
-		nvmf_doca_sq_copy_data(request->doca_sq,
-				       request->dpu_buffer[idx],
-				       request->host_buffer[idx],
-				       request->request.iov[idx].iov_len,
-				       user_data);
-	}
-}
-
 /*
  * Begin async operation of handling NVMe command that does not require copy of data between Host and DPU
  *
@@ -2778,7 +2647,7 @@ static void buffers_ready_copy_data_host_to_dpu(struct nvmf_doca_request *reques
  */
 static void begin_nvme_cmd_data_none(struct nvmf_doca_request *request)
 {
-	request->doca_cb = post_cqe_from_response;
+	request->doca_cb = nvmf_doca_request_post_cqe;
 	spdk_nvmf_request_exec(&request->request);
 }
 
@@ -2812,7 +2681,7 @@ static void nvmf_doca_poll_group_create_io_cq_done(void *args)
 	free(ctx);
 
 	request->request.rsp->nvme_cpl.cid = request->request.cmd->nvme_cmd.cid;
-	post_cqe_from_response(request, request);
+	nvmf_doca_request_post_cqe(request, request);
 }
 
 /*
@@ -2936,9 +2805,10 @@ static void nvmf_doca_poll_group_create_io_cq(void *args)
 		.max_num_sq = 64,
 		.post_cqe_cb = nvmf_doca_on_post_nvm_cqe_complete,
 		.fetch_sqe_cb = nvmf_doca_on_fetch_nvm_sqe_complete,
-		.copy_data_cb = nvmf_doca_on_copy_nvm_data_complete,
+		.copy_data_cb = nvmf_doca_request_on_copy_nvm_data,
 		.stop_sq_cb = nvmf_doca_on_io_sq_stop,
 		.stop_io_cb = nvmf_doca_on_io_cq_stop,
+		.ops = &nvmf_doca_transport_io_ops,
 	};
 
 	struct nvmf_doca_io *io_cq = ctx->io_cq;
@@ -2969,7 +2839,7 @@ static void handle_create_io_cq(struct nvmf_doca_sq *sq, struct nvmf_doca_reques
 	struct nvmf_doca_io *io_cq = calloc(1, sizeof(*io_cq));
 	if (io_cq == NULL) {
 		DOCA_LOG_ERR("Failed to create IO CQ: Out of memory");
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 
@@ -2979,7 +2849,7 @@ static void handle_create_io_cq(struct nvmf_doca_sq *sq, struct nvmf_doca_reques
 	if (create_io_cq_ctx == NULL) {
 		DOCA_LOG_ERR("Failed to create IO CQ: Out of memory");
 		free(io_cq);
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 	*create_io_cq_ctx = (struct nvmf_doca_poll_group_create_io_cq_ctx){
@@ -3007,14 +2877,14 @@ static void handle_delete_io_cq(struct nvmf_doca_sq *sq, struct nvmf_doca_reques
 	struct nvmf_doca_io *io_cq = admin_qp_find_io_cq_by_id(admin_qp, io_cq_id);
 	if (io_cq == NULL) {
 		DOCA_LOG_ERR("Failed to delete IO CQ: IO CQ with ID %u does not exist", io_cq_id);
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 
 	struct nvmf_doca_poll_group_delete_io_cq_ctx *delete_io_cq_ctx = calloc(1, sizeof(*delete_io_cq_ctx));
 	if (delete_io_cq_ctx == NULL) {
 		DOCA_LOG_ERR("Failed to delete IO CQ: Out of memory");
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 	*delete_io_cq_ctx = (struct nvmf_doca_poll_group_delete_io_cq_ctx){
@@ -3048,7 +2918,7 @@ static void nvmf_doca_poll_group_create_io_sq_done(void *args)
 	free(ctx);
 
 	request->request.rsp->nvme_cpl.cid = request->request.cmd->nvme_cmd.cid;
-	post_cqe_from_response(request, request);
+	nvmf_doca_request_post_cqe(request, request);
 }
 
 /*
@@ -3063,6 +2933,8 @@ static void nvmf_doca_poll_group_create_io_sq(void *args)
 	struct spdk_nvme_cmd *cmd = &request->request.cmd->nvme_cmd;
 	struct nvmf_doca_pci_dev_poll_group *pci_dev_pg = ctx->pci_dev_pg;
 	struct nvmf_doca_pci_dev_admin *pci_dev_admin = pci_dev_pg->pci_dev_admin;
+	struct nvmf_doca_transport *doca_transport =
+		SPDK_CONTAINEROF(pci_dev_pg->poll_group->pg.transport, struct nvmf_doca_transport, transport);
 	uint32_t qsize = cmd->cdw10_bits.create_io_q.qsize + 1;
 
 	struct nvmf_doca_io_add_sq_attr sq_attr = {
@@ -3074,6 +2946,8 @@ static void nvmf_doca_poll_group_create_io_sq(void *args)
 		.host_sq_address = cmd->dptr.prp.prp1,
 		.sq_id = cmd->cdw10_bits.create_io_q.qid,
 		.transport = pci_dev_pg->poll_group->pg.transport,
+		.dma_pool_64k_bufs = doca_transport->doca_opts.dma_pool_64k_bufs,
+		.dma_pool_1m_bufs = doca_transport->doca_opts.dma_pool_1m_bufs,
 		.ctx = args,
 	};
 	nvmf_doca_io_add_sq(ctx->io_cq, &sq_attr, ctx->io_sq);
@@ -3092,7 +2966,7 @@ static void handle_create_io_sq(struct nvmf_doca_sq *sq, struct nvmf_doca_reques
 	struct nvmf_doca_io *io_cq = admin_qp_find_io_cq_by_id(admin_qp, io_cq_id);
 	if (io_cq == NULL) {
 		DOCA_LOG_ERR("Failed to create IO SQ: IO CQ with ID %u not found", io_cq_id);
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 
@@ -3101,7 +2975,7 @@ static void handle_create_io_sq(struct nvmf_doca_sq *sq, struct nvmf_doca_reques
 	struct nvmf_doca_sq *io_sq = calloc(1, sizeof(*io_sq));
 	if (io_sq == NULL) {
 		DOCA_LOG_ERR("Failed to create IO SQ: Out of memory");
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 
@@ -3109,7 +2983,7 @@ static void handle_create_io_sq(struct nvmf_doca_sq *sq, struct nvmf_doca_reques
 	if (create_io_sq_ctx == NULL) {
 		DOCA_LOG_ERR("Failed to create IO SQ: Out of memory");
 		free(io_sq);
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 	*create_io_sq_ctx = (struct nvmf_doca_poll_group_create_io_sq_ctx){
@@ -3136,14 +3010,14 @@ static void handle_delete_io_sq(struct nvmf_doca_sq *sq, struct nvmf_doca_reques
 	struct nvmf_doca_sq *io_sq = admin_qp_find_io_sq_by_id(admin_qp, io_sq_id);
 	if (io_sq == NULL) {
 		DOCA_LOG_ERR("Failed to delete IO SQ: IO SQ with ID %u does not exist", io_sq_id);
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 
 	struct nvmf_doca_poll_group_delete_io_sq_ctx *delete_io_sq_ctx = calloc(1, sizeof(*delete_io_sq_ctx));
 	if (delete_io_sq_ctx == NULL) {
 		DOCA_LOG_ERR("Failed to delete IO SQ: Out of memory");
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 	*delete_io_sq_ctx = (struct nvmf_doca_poll_group_delete_io_sq_ctx){
@@ -3269,14 +3143,14 @@ static void nvmf_doca_on_fetch_sqe_complete(struct nvmf_doca_sq *sq, struct nvmf
 	case SPDK_NVME_DATA_NONE:
 		/**
 		 * This will begin an async flow passing through the following methods
-		 * begin_nvme_cmd_data_none ---> post_cqe_from_response ---> nvmf_doca_on_post_cqe_complete
+		 * begin_nvme_cmd_data_none ---> nvmf_doca_request_post_cqe ---> nvmf_doca_on_post_cqe_complete
 		 */
 		begin_nvme_cmd_data_none(request);
 		break;
 	case SPDK_NVME_DATA_HOST_TO_CONTROLLER:
 		/**
 		 * This will begin an async flow passing through the following methods
-		 * begin_nvme_admin_cmd_data_host_to_dpu ---> execute_spdk_request ---> post_cqe_from_response --->
+		 * begin_nvme_admin_cmd_data_host_to_dpu ---> execute_spdk_request ---> nvmf_doca_request_post_cqe --->
 		 * nvmf_doca_on_post_cqe_complete
 		 */
 		begin_nvme_admin_cmd_data_host_to_dpu(request);
@@ -3284,7 +3158,7 @@ static void nvmf_doca_on_fetch_sqe_complete(struct nvmf_doca_sq *sq, struct nvmf
 	case SPDK_NVME_DATA_CONTROLLER_TO_HOST:
 		/**
 		 * This will begin an async flow passing through the following methods
-		 * begin_nvme_admin_cmd_data_dpu_to_host ---> copy_dpu_data_to_host ---> post_cqe_from_response --->
+		 * begin_nvme_admin_cmd_data_dpu_to_host ---> copy_dpu_data_to_host ---> nvmf_doca_request_post_cqe --->
 		 * nvmf_doca_on_post_cqe_complete
 		 */
 		begin_nvme_admin_cmd_data_dpu_to_host(request);
@@ -3328,7 +3202,7 @@ static void nvmf_doca_on_fetch_nvm_sqe_complete(struct nvmf_doca_sq *sq, struct
 		break;
 	default:
 		DOCA_LOG_ERR("Received unsupported NVM command: opcode %u", cmd->opc);
-		post_error_cqe_from_response(request);
+		nvmf_doca_request_post_error_cqe(request);
 		return;
 	}
 
@@ -3337,23 +3211,23 @@ static void nvmf_doca_on_fetch_nvm_sqe_complete(struct nvmf_doca_sq *sq, struct
 	case SPDK_NVME_DATA_NONE:
 		/**
 		 * This will begin an async flow passing through the following methods
-		 * begin_nvme_cmd_data_none ---> post_cqe_from_response ---> nvmf_doca_on_post_cqe_complete
+		 * begin_nvme_cmd_data_none ---> nvmf_doca_request_post_cqe ---> nvmf_doca_on_post_cqe_complete
 		 */
 		begin_nvme_cmd_data_none(request);
 		break;
 	case SPDK_NVME_DATA_HOST_TO_CONTROLLER:
 		/**
 		 * This will begin an async flow passing through the following methods
-		 * begin_nvme_cmd_data_host_to_dpu ---> nvme_cmd_map_prps ---> buffers_ready_copy_data_host_to_dpu
-		 * --> execute_spdk_request ---> post_cqe_from_response ---> nvmf_doca_on_post_cqe_complete
+		 * begin_nvme_cmd_data_host_to_dpu ---> nvmf_doca_request_map_prps ---> nvmf_doca_spdk_request_exec
+		 * ---> nvmf_doca_request_post_cqe ---> nvmf_doca_on_post_nvm_cqe_complete
 		 */
 		begin_nvme_cmd_data_host_to_dpu(request);
 		break;
 	case SPDK_NVME_DATA_CONTROLLER_TO_HOST:
 		/**
 		 * This will begin an async flow passing through the following methods
-		 * begin_nvme_cmd_data_dpu_to_host ---> nvme_cmd_map_prps ---> buffers_ready_copy_data_dpu_to_host
-		 * ---> copy_dpu_data_to_host ---> post_cqe_from_response ---> nvmf_doca_on_post_cqe_complete
+		 * begin_nvme_cmd_data_dpu_to_host ---> nvmf_doca_request_map_prps ---> nvmf_doca_spdk_request_exec
+		 * ---> nvmf_doca_request_post_cqe ---> nvmf_doca_on_post_nvm_cqe_complete
 		 */
 		begin_nvme_cmd_data_dpu_to_host(request);
 		break;
@@ -3420,31 +3294,6 @@ static void nvmf_doca_on_copy_data_complete(struct nvmf_doca_sq *sq,
 	nvmf_doca_request_complete(request);
 }
 
-/*
- * Callback invoked once NVM command data copied to Host.
- *
- * The source and destination buffers must be freed at some point using doca_buf_dec_refcount()
- *
- * @sq [in]: The SQ used for the copy operation
- * @dst [in]: The buffer used as destination in the copy operation
- * @src [in]: The buffer used as source in the copy operation
- * @user_data [in]: Same user data previously provided in nvmf_doca_sq_copy_data()
- */
-static void nvmf_doca_on_copy_nvm_data_complete(struct nvmf_doca_sq *sq,
-						struct doca_buf *dst,
-						struct doca_buf *src,
-						union doca_data user_data)
-{
-	(void)sq;
-	(void)dst;
-	(void)src;
-
-	struct nvmf_doca_request *request = user_data.ptr;
-	request->num_of_buffers--;
-	if (request->num_of_buffers == 0)
-		nvmf_doca_request_complete(request);
-}
-
 /**
  * Implementation of the DOCA transport
  */
@@ -3466,6 +3315,7 @@ const struct spdk_nvmf_transport_ops spdk_nvmf_transport_doca = {
 	.poll_group_add = nvmf_doca_poll_group_add,
 	.poll_group_remove = nvmf_doca_poll_group_remove,
 	.poll_group_poll = nvmf_doca_poll_group_poll,
+	.poll_group_dump_stat = nvmf_doca_poll_group_dump_stat,
 
 	.req_free = nvmf_doca_req_free,
 	.req_complete = nvmf_doca_req_complete,
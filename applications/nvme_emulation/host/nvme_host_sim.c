@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <spdk/env.h>
+#include <spdk/util.h>
+
+#include <doca_log.h>
+
+#include "nvme_host_sim.h"
+
+DOCA_LOG_REGISTER(NVME_HOST_SIM);
+
+/*
+ * Get the next number from the random generator of the simulator
+ *
+ * @sim [in]: The simulator
+ * @return: Pseudo random 64 bit number
+ */
+static uint64_t nvme_host_sim_rand(struct nvme_host_sim *sim)
+{
+	/* xorshift64* */
+	sim->rand_state ^= sim->rand_state >> 12;
+	sim->rand_state ^= sim->rand_state << 25;
+	sim->rand_state ^= sim->rand_state >> 27;
+
+	return sim->rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Get the size of a region rounded up to whole pages
+ *
+ * @size [in]: Size of the region in bytes
+ * @return: The size rounded up to a multiple of the page size
+ */
+static size_t nvme_host_sim_page_align(size_t size)
+{
+	return SPDK_CEIL_DIV(size, NVME_HOST_SIM_PAGE_SIZE) * NVME_HOST_SIM_PAGE_SIZE;
+}
+
+size_t nvme_host_sim_memory_size(const struct nvme_host_sim_attr *attr)
+{
+	uint32_t pages_per_cmd = SPDK_CEIL_DIV(attr->prp1_offset + attr->io_size, NVME_HOST_SIM_PAGE_SIZE);
+
+	return nvme_host_sim_page_align(attr->queue_depth * sizeof(struct spdk_nvme_cmd)) +
+	       nvme_host_sim_page_align(attr->queue_depth * sizeof(struct spdk_nvme_cpl)) +
+	       (size_t)attr->io_depth * (1 + pages_per_cmd) * NVME_HOST_SIM_PAGE_SIZE;
+}
+
+/*
+ * Get the address of a data page of a command
+ *
+ * In contiguous mode the pages of a command are adjacent. In scatter mode the pages of all commands are interleaved
+ * and each command walks them backwards, so no two consecutive PRP entries are contiguous in memory
+ *
+ * @sim [in]: The simulator
+ * @data_pages [in]: Start of the data pages region
+ * @cid [in]: The CID of the command
+ * @page [in]: Index of the page inside the command
+ * @return: Address of the page
+ */
+static uint64_t nvme_host_sim_page_address(const struct nvme_host_sim *sim,
+					   uint8_t *data_pages,
+					   uint16_t cid,
+					   uint32_t page)
+{
+	size_t page_idx;
+
+	if (sim->attr.scatter_pages)
+		page_idx = (size_t)(sim->pages_per_cmd - 1 - page) * sim->attr.io_depth + cid;
+	else
+		page_idx = (size_t)cid * sim->pages_per_cmd + page;
+
+	return (uintptr_t)(data_pages + page_idx * NVME_HOST_SIM_PAGE_SIZE);
+}
+
+/*
+ * Prepare the PRP entries of a command, the data pages of a CID never change
+ *
+ * @sim [in]: The simulator
+ * @cid [in]: The CID of the command
+ * @data_pages [in]: Start of the data pages region
+ * @prp_list [in]: The PRP list page of the command
+ */
+static void nvme_host_sim_init_cmd(struct nvme_host_sim *sim, uint16_t cid, uint8_t *data_pages, uint64_t *prp_list)
+{
+	struct nvme_host_sim_cmd *cmd = &sim->cmds[cid];
+	uint32_t first_length = NVME_HOST_SIM_PAGE_SIZE - sim->attr.prp1_offset;
+
+	cmd->prp1 = nvme_host_sim_page_address(sim, data_pages, cid, 0) + sim->attr.prp1_offset;
+	if (sim->attr.io_size <= first_length) {
+		cmd->prp2 = 0;
+	} else if (sim->attr.io_size - first_length <= NVME_HOST_SIM_PAGE_SIZE) {
+		cmd->prp2 = nvme_host_sim_page_address(sim, data_pages, cid, 1);
+	} else {
+		for (uint32_t page = 1; page < sim->pages_per_cmd; page++)
+			prp_list[page - 1] = nvme_host_sim_page_address(sim, data_pages, cid, page);
+		cmd->prp2 = (uintptr_t)prp_list;
+	}
+}
+
+doca_error_t nvme_host_sim_create(const struct nvme_host_sim_attr *attr, struct nvme_host_sim *sim)
+{
+	size_t sq_size = nvme_host_sim_page_align(attr->queue_depth * sizeof(struct spdk_nvme_cmd));
+	size_t cq_size = nvme_host_sim_page_align(attr->queue_depth * sizeof(struct spdk_nvme_cpl));
+	uint8_t *prp_lists;
+
+	memset(sim, 0, sizeof(*sim));
+	sim->attr = *attr;
+
+	if (attr->io_depth == 0 || attr->io_depth >= attr->queue_depth || attr->batch_size == 0) {
+		DOCA_LOG_ERR("Failed to create NVMe Host simulator: IO depth %u must be in [1, %u) and batch size non zero",
+			     attr->io_depth,
+			     attr->queue_depth);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	if (attr->io_size == 0 || attr->io_size % NVME_HOST_SIM_LBA_SIZE != 0 ||
+	    attr->prp1_offset >= NVME_HOST_SIM_PAGE_SIZE || attr->prp1_offset % 4 != 0 ||
+	    attr->num_lbas < attr->io_size / NVME_HOST_SIM_LBA_SIZE) {
+		DOCA_LOG_ERR("Failed to create NVMe Host simulator: Invalid IO size %u or PRP1 offset %u",
+			     attr->io_size,
+			     attr->prp1_offset);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	sim->pages_per_cmd = SPDK_CEIL_DIV(attr->prp1_offset + attr->io_size, NVME_HOST_SIM_PAGE_SIZE);
+	if (sim->pages_per_cmd - 1 > NVME_HOST_SIM_PAGE_SIZE / sizeof(uint64_t)) {
+		DOCA_LOG_ERR("Failed to create NVMe Host simulator: IO size %u does not fit a single PRP list",
+			     attr->io_size);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	sim->memory_size = nvme_host_sim_memory_size(attr);
+	sim->memory = aligned_alloc(NVME_HOST_SIM_PAGE_SIZE, sim->memory_size);
+	sim->cmds = calloc(attr->io_depth, sizeof(*sim->cmds));
+	sim->free_cids = calloc(attr->io_depth, sizeof(*sim->free_cids));
+	if (sim->memory == NULL || sim->cmds == NULL || sim->free_cids == NULL) {
+		DOCA_LOG_ERR("Failed to create NVMe Host simulator: Failed to allocate %zu bytes of Host memory",
+			     sim->memory_size);
+		nvme_host_sim_destroy(sim);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+	memset(sim->memory, 0, sim->memory_size);
+
+	sim->sq = sim->memory;
+	sim->cq = (struct spdk_nvme_cpl *)((uint8_t *)sim->memory + sq_size);
+	prp_lists = (uint8_t *)sim->memory + sq_size + cq_size;
+	for (uint16_t cid = 0; cid < attr->io_depth; cid++) {
+		nvme_host_sim_init_cmd(sim,
+				       cid,
+				       prp_lists + (size_t)attr->io_depth * NVME_HOST_SIM_PAGE_SIZE,
+				       (uint64_t *)(prp_lists + (size_t)cid * NVME_HOST_SIM_PAGE_SIZE));
+		sim->free_cids[sim->num_free_cids++] = attr->io_depth - 1 - cid;
+	}
+
+	sim->cq_phase = 1;
+	sim->rand_state = attr->seed != 0 ? attr->seed : 1;
+	sim->stats.min_lat_ticks = UINT64_MAX;
+
+	return DOCA_SUCCESS;
+}
+
+void nvme_host_sim_destroy(struct nvme_host_sim *sim)
+{
+	free(sim->free_cids);
+	sim->free_cids = NULL;
+	free(sim->cmds);
+	sim->cmds = NULL;
+	free(sim->memory);
+	sim->memory = NULL;
+}
+
+uint32_t nvme_host_sim_submit(struct nvme_host_sim *sim)
+{
+	uint32_t num_lbas_per_cmd = sim->attr.io_size / NVME_HOST_SIM_LBA_SIZE;
+	uint64_t num_slots = sim->attr.num_lbas / num_lbas_per_cmd;
+	uint64_t now = spdk_get_ticks();
+	uint32_t num_submitted = 0;
+
+	while (!sim->stop_submit && sim->num_free_cids != 0 && num_submitted < sim->attr.batch_size) {
+		uint16_t cid = sim->free_cids[--sim->num_free_cids];
+		struct nvme_host_sim_cmd *cmd = &sim->cmds[cid];
+		struct spdk_nvme_cmd *sqe = &sim->sq[sim->sq_tail];
+		uint64_t rand = nvme_host_sim_rand(sim);
+		uint64_t slba = ((rand >> 8) % num_slots) * num_lbas_per_cmd;
+
+		cmd->opc = (rand & 0xff) % 100 < sim->attr.read_percentage ? SPDK_NVME_OPC_READ : SPDK_NVME_OPC_WRITE;
+		cmd->submit_ticks = now;
+
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opc = cmd->opc;
+		sqe->psdt = SPDK_NVME_PSDT_PRP;
+		sqe->cid = cid;
+		sqe->nsid = 1;
+		sqe->dptr.prp.prp1 = cmd->prp1;
+		sqe->dptr.prp.prp2 = cmd->prp2;
+		sqe->cdw10 = (uint32_t)slba;
+		sqe->cdw11 = (uint32_t)(slba >> 32);
+		sqe->cdw12 = num_lbas_per_cmd - 1;
+
+		sim->sq_tail = (sim->sq_tail + 1) % sim->attr.queue_depth;
+		sim->num_outstanding++;
+		num_submitted++;
+	}
+
+	if (num_submitted != 0)
+		sim->stats.num_sq_dbs++;
+
+	return num_submitted;
+}
+
+uint32_t nvme_host_sim_reap(struct nvme_host_sim *sim)
+{
+	struct nvme_host_sim_stats *stats = &sim->stats;
+	uint64_t now = spdk_get_ticks();
+	uint32_t num_reaped = 0;
+
+	while (sim->cq[sim->cq_head].status.p == sim->cq_phase) {
+		const struct spdk_nvme_cpl *cpl = &sim->cq[sim->cq_head];
+		struct nvme_host_sim_cmd *cmd = &sim->cmds[cpl->cid];
+		uint64_t lat_ticks = now - cmd->submit_ticks;
+
+		if (cpl->status.sct != SPDK_NVME_SCT_GENERIC || cpl->status.sc != SPDK_NVME_SC_SUCCESS) {
+			stats->num_errors++;
+		} else {
+			if (cmd->opc == SPDK_NVME_OPC_READ)
+				stats->num_reads++;
+			else
+				stats->num_writes++;
+			stats->bytes += sim->attr.io_size;
+		}
+		stats->lat_ticks += lat_ticks;
+		stats->min_lat_ticks = spdk_min(stats->min_lat_ticks, lat_ticks);
+		stats->max_lat_ticks = spdk_max(stats->max_lat_ticks, lat_ticks);
+
+		sim->free_cids[sim->num_free_cids++] = cpl->cid;
+		sim->num_outstanding--;
+
+		sim->cq_head++;
+		if (sim->cq_head == sim->attr.queue_depth) {
+			sim->cq_head = 0;
+			sim->cq_phase = !sim->cq_phase;
+		}
+		num_reaped++;
+	}
+
+	if (num_reaped != 0)
+		stats->num_cq_dbs++;
+
+	return num_reaped;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef NVME_HOST_SIM_H_
+#define NVME_HOST_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <spdk/nvme_spec.h>
+
+#include <doca_error.h>
+
+/*
+ * In-process NVMe Host that drives a single SQ/CQ pair the same way an NVMe driver would
+ *
+ * Commands are built in an SQ ring with PRP1, PRP2 and PRP lists pointing at data pages in the simulator memory, and
+ * completions are reaped from the CQ ring according to the phase bit. The simulator does not ring DBs by itself, it
+ * returns the new indexes so the caller can deliver them through whatever stands in for the PCIe BAR
+ */
+
+#define NVME_HOST_SIM_LBA_SIZE 512
+#define NVME_HOST_SIM_PAGE_SIZE 4096
+
+struct nvme_host_sim_attr {
+	uint16_t queue_depth;	  /**< Number of elements in the SQ and CQ */
+	uint16_t io_depth;	  /**< Maximal number of outstanding commands, less than queue_depth */
+	uint16_t batch_size;	  /**< Maximal number of SQEs submitted per SQ DB */
+	uint32_t io_size;	  /**< Data length of each command, a multiple of NVME_HOST_SIM_LBA_SIZE */
+	uint32_t read_percentage; /**< Percentage of read commands, the rest are writes */
+	uint32_t prp1_offset;	  /**< Offset of the data inside the first page, a multiple of 4 bytes */
+	bool scatter_pages;	  /**< Whether data pages of a command are contiguous in memory or scattered */
+	uint64_t num_lbas;	  /**< Size of the namespace, commands target random LBAs below it */
+	uint32_t seed;		  /**< Seed of the random generator picking opcodes and LBAs */
+};
+
+struct nvme_host_sim_cmd {
+	uint64_t submit_ticks; /**< Time at which the command was placed in the SQ */
+	uint64_t prp1;	       /**< PRP1 of the command, points into its first data page */
+	uint64_t prp2;	       /**< PRP2 of the command, second data page or PRP list, 0 if not needed */
+	uint8_t opc;	       /**< The opcode of the outstanding command */
+};
+
+struct nvme_host_sim_stats {
+	uint64_t num_reads;	/**< Number of completed read commands */
+	uint64_t num_writes;	/**< Number of completed write commands */
+	uint64_t num_errors;	/**< Number of commands completed with error status */
+	uint64_t num_sq_dbs;	/**< Number of SQ DBs returned to the caller */
+	uint64_t num_cq_dbs;	/**< Number of CQ DBs returned to the caller */
+	uint64_t bytes;		/**< Number of data bytes transferred by completed commands */
+	uint64_t lat_ticks;	/**< Accumulated submit to reap latency */
+	uint64_t min_lat_ticks; /**< Lowest submit to reap latency */
+	uint64_t max_lat_ticks; /**< Highest submit to reap latency */
+};
+
+struct nvme_host_sim {
+	struct nvme_host_sim_attr attr;	  /**< The simulator attributes */
+	void *memory;			  /**< All of the Host memory: rings, PRP lists and data pages */
+	size_t memory_size;		  /**< Size of the Host memory */
+	struct spdk_nvme_cmd *sq;	  /**< The SQ ring */
+	struct spdk_nvme_cpl *cq;	  /**< The CQ ring */
+	struct nvme_host_sim_cmd *cmds;	  /**< Command context indexed by CID */
+	uint16_t *free_cids;		  /**< Stack of unused CIDs */
+	uint16_t num_free_cids;		  /**< Number of CIDs in the stack */
+	uint32_t pages_per_cmd;		  /**< Number of data pages spanned by a command */
+	uint16_t sq_tail;		  /**< Index where the next SQE is written */
+	uint16_t cq_head;		  /**< Index of the next CQE to reap */
+	uint8_t cq_phase;		  /**< Expected phase of the next CQE */
+	uint32_t num_outstanding;	  /**< Number of submitted commands that were not reaped */
+	bool stop_submit;		  /**< Once set no new commands are submitted */
+	uint64_t rand_state;		  /**< State of the random generator */
+	struct nvme_host_sim_stats stats; /**< Completion counters */
+};
+
+/*
+ * Get the number of bytes of Host memory needed by a simulator
+ *
+ * @attr [in]: The simulator attributes
+ * @return: Size of the Host memory in bytes
+ */
+size_t nvme_host_sim_memory_size(const struct nvme_host_sim_attr *attr);
+
+/*
+ * Create an NVMe Host simulator
+ *
+ * @attr [in]: The simulator attributes
+ * @sim [in]: The simulator to initialize
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t nvme_host_sim_create(const struct nvme_host_sim_attr *attr, struct nvme_host_sim *sim);
+
+/*
+ * Destroy an NVMe Host simulator
+ *
+ * @sim [in]: The simulator to destroy
+ */
+void nvme_host_sim_destroy(struct nvme_host_sim *sim);
+
+/*
+ * Fill the SQ with new commands up to the IO depth and the batch size
+ *
+ * @sim [in]: The simulator
+ * @return: Number of submitted commands, the caller must ring the SQ DB with sq_tail if not 0
+ */
+uint32_t nvme_host_sim_submit(struct nvme_host_sim *sim);
+
+/*
+ * Reap completions from the CQ
+ *
+ * @sim [in]: The simulator
+ * @return: Number of reaped completions, the caller must ring the CQ DB with cq_head if not 0
+ */
+uint32_t nvme_host_sim_reap(struct nvme_host_sim *sim);
+
+#endif // NVME_HOST_SIM_H_
@@ -24,9 +24,11 @@
  */
 
 #include "nvmf_doca_io.h"
+#include "nvmf_doca_io_common.h"
 #include "nvme_pci_type_config.h"
 #include <doca_transport_common.h>
 
+#include <spdk/env.h>
 #include <spdk/util.h>
 
 #include <doca_log.h>
@@ -36,7 +38,10 @@ DOCA_LOG_REGISTER(NVME_PCI_COMMON);
 extern doca_dpa_func_t io_thread;
 extern doca_dpa_func_t io_thread_init_rpc;
 
-#define CACHELINE_SIZE_BYTES 64
+/* SQE fetch task user data: index of first SQE in the low 32 bits and number of SQEs in the high 32 bits */
+#define SQE_FETCH_USER_DATA(first_idx, num_sqes) ((uint64_t)(first_idx) | ((uint64_t)(num_sqes) << 32))
+#define SQE_FETCH_FIRST_IDX(user_data) ((uint32_t)((user_data) & UINT32_MAX))
+#define SQE_FETCH_NUM_SQES(user_data) ((uint32_t)((user_data) >> 32))
 
 /*
  * Method invoked once bind DB done message is received from DPA
@@ -796,6 +801,8 @@ struct nvmf_doca_queue_create_attr {
 	uint16_t queue_depth;		     /**< The log of the queue number of elements */
 	uint8_t element_size;		     /**< Size in bytes of each element in the queue */
 	bool is_read_from_remote; /**< true in case queue will be used to read memory from Host to local buffers */
+	bool coalesce_elements;	  /**< true in case element buffers should span until end of queue, allowing the
+				       task of an element to copy a contiguous run of elements starting from it */
 	doca_dma_task_memcpy_completion_cb_t success_cb; /**< Callback invoked upon DMA of each element */
 	doca_dma_task_memcpy_completion_cb_t error_cb;	 /**< Callback invoked upon DMA failure of each element */
 	doca_ctx_state_changed_callback_t dma_state_changed_cb; /**< Callback invoked upon DMA state change */
@@ -919,12 +926,14 @@ static doca_error_t nvmf_doca_queue_create(const struct nvmf_doca_queue_create_a
 	}
 
 	for (uint32_t idx = 0; idx < num_elements; idx++) {
+		size_t element_buf_len = attr->coalesce_elements ? (num_elements - idx) * attr->element_size :
+								   attr->element_size;
 		void *local_element_address = (uint8_t *)queue->local_queue_address + idx * attr->element_size;
 		struct doca_buf *local_element_buf;
 		result = doca_buf_inventory_buf_get_by_addr(queue->inventory,
 							    queue->local_queue_mmap,
 							    local_element_address,
-							    attr->element_size,
+							    element_buf_len,
 							    &local_element_buf);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to create NVMf DOCA Queue: Failed to get local buffer from inventory - %s",
@@ -937,7 +946,7 @@ static doca_error_t nvmf_doca_queue_create(const struct nvmf_doca_queue_create_a
 		result = doca_buf_inventory_buf_get_by_addr(queue->inventory,
 							    attr->remote_queue_mmap,
 							    remote_element_address,
-							    attr->element_size,
+							    element_buf_len,
 							    &remote_element_buf);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR(
@@ -1713,6 +1722,7 @@ doca_error_t nvmf_doca_io_create(const struct nvmf_doca_io_create_attr *attr, st
 	io->copy_data_cb = attr->copy_data_cb;
 	io->stop_sq_cb = attr->stop_sq_cb;
 	io->stop_io_cb = attr->stop_io_cb;
+	io->ops = attr->ops;
 
 	return DOCA_SUCCESS;
 }
@@ -1783,7 +1793,7 @@ struct nvmf_doca_dma_pool_create_attr {
 	struct doca_pe *pe;				 /**< Progress engine to be used by DMA context */
 	struct doca_dev *dev;				 /**< A doca device representing the emulation manager */
 	uint32_t max_dma_operations;			 /**< The maximal number of DMA copy operations */
-	uint32_t max_dma_operation_size;		 /**< The maximal size in bytes of the DMA copy operation */
+	uint32_t num_class_bufs[NVMF_DOCA_DMA_POOL_NUM_CLASSES]; /**< Number of local buffers in each size class */
 	struct doca_mmap *host_data_mmap;		 /**< An mmap granting access to the Host Data memory */
 	doca_dma_task_memcpy_completion_cb_t success_cb; /**< Callback invoked upon DMA of data buffer */
 	doca_dma_task_memcpy_completion_cb_t error_cb;	 /**< Callback invoked upon DMA failure of data buffer */
@@ -1791,28 +1801,6 @@ struct nvmf_doca_dma_pool_create_attr {
 	void *dma_user_data; /**< User data to be provided in the callbacks as the ctx_user_data argument */
 };
 
-struct doca_buf *nvmf_doca_sq_get_dpu_buffer(struct nvmf_doca_sq *sq)
-{
-	struct doca_buf *buf;
-
-	doca_buf_pool_buf_alloc(sq->dma_pool.local_data_pool, &buf);
-
-	return buf;
-}
-
-struct doca_buf *nvmf_doca_sq_get_host_buffer(struct nvmf_doca_sq *sq, uintptr_t host_io_address)
-{
-	struct doca_buf *buf;
-
-	doca_buf_inventory_buf_get_by_addr(sq->dma_pool.host_data_inventory,
-					   sq->dma_pool.host_data_mmap,
-					   (void *)host_io_address,
-					   DMA_POOL_DATA_BUFFER_SIZE,
-					   &buf);
-
-	return buf;
-}
-
 void nvmf_doca_sq_copy_data(struct nvmf_doca_sq *sq,
 			    struct doca_buf *dst_buffer,
 			    struct doca_buf *src_buffer,
@@ -1908,57 +1896,21 @@ static doca_error_t nvmf_doca_dma_pool_create(const struct nvmf_doca_dma_pool_cr
 	doca_error_t result;
 
 	memset(dma_pool, 0, sizeof(*dma_pool));
+	dma_pool->start_ticks = spdk_get_ticks();
 
-	uint32_t local_data_memory_size = attr->max_dma_operations * attr->max_dma_operation_size;
-	dma_pool->local_data_memory = spdk_dma_zmalloc(local_data_memory_size, CACHELINE_SIZE_BYTES, NULL);
-	if (dma_pool->local_data_memory == NULL) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to allocate memory for local data");
-		return DOCA_ERROR_NO_MEMORY;
-	}
-
-	result = doca_mmap_create(&dma_pool->local_data_mmap);
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to create local data mmap - %s",
-			     doca_error_get_name(result));
-		return result;
-	}
-	result = doca_mmap_set_memrange(dma_pool->local_data_mmap, dma_pool->local_data_memory, local_data_memory_size);
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to create local data mmap - %s",
-			     doca_error_get_name(result));
-		return result;
-	}
-	result = doca_mmap_set_permissions(dma_pool->local_data_mmap, DOCA_ACCESS_FLAG_LOCAL_READ_WRITE);
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to set local data mmap permissions - %s",
-			     doca_error_get_name(result));
-		return result;
-	}
-	result = doca_mmap_add_dev(dma_pool->local_data_mmap, attr->dev);
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to add device to local dma mmap - %s",
-			     doca_error_get_name(result));
-		return result;
-	}
-	result = doca_mmap_start(dma_pool->local_data_mmap);
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to start local dma mmap - %s",
-			     doca_error_get_name(result));
+	result = nvmf_doca_dma_pool_classes_create(attr->dev, attr->num_class_bufs, dma_pool);
+	if (result != DOCA_SUCCESS)
 		return result;
-	}
 
-	result = doca_buf_pool_create(attr->max_dma_operations,
-				      attr->max_dma_operation_size,
-				      dma_pool->local_data_mmap,
-				      &dma_pool->local_data_pool);
+	result = doca_buf_inventory_create(attr->max_dma_operations, &dma_pool->local_view_inventory);
 	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to create local data pool - %s",
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to create local view inventory - %s",
 			     doca_error_get_name(result));
 		return result;
 	}
-	result = doca_buf_pool_start(dma_pool->local_data_pool);
+	result = doca_buf_inventory_start(dma_pool->local_view_inventory);
 	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to start local data pool - %s",
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to start local view inventory - %s",
 			     doca_error_get_name(result));
 		return result;
 	}
@@ -2077,66 +2029,119 @@ static void nvmf_doca_dma_pool_destroy(struct nvmf_doca_dma_pool *dma_pool)
 		dma_pool->host_data_inventory = NULL;
 	}
 
-	if (dma_pool->local_data_pool != NULL) {
-		result = doca_buf_pool_destroy(dma_pool->local_data_pool);
+	if (dma_pool->local_view_inventory != NULL) {
+		result = doca_buf_inventory_destroy(dma_pool->local_view_inventory);
 		if (result != DOCA_SUCCESS)
-			DOCA_LOG_ERR("Failed to destroy NVMf DOCA DMA pool: Failed to destroy local data pool %s",
+			DOCA_LOG_ERR("Failed to destroy NVMf DOCA DMA pool: Failed to destroy local view inventory %s",
 				     doca_error_get_name(result));
-		dma_pool->local_data_pool = NULL;
+		dma_pool->local_view_inventory = NULL;
 	}
 
-	if (dma_pool->local_data_mmap != NULL) {
-		result = doca_mmap_destroy(dma_pool->local_data_mmap);
-		if (result != DOCA_SUCCESS)
-			DOCA_LOG_ERR("Failed to destroy NVMf DOCA DMA pool: Failed to destroy local data mmap %s",
-				     doca_error_get_name(result));
-		dma_pool->local_data_mmap = NULL;
-	}
+	nvmf_doca_dma_pool_classes_destroy(dma_pool);
+}
 
-	if (dma_pool->local_data_memory != NULL) {
-		spdk_dma_free(dma_pool->local_data_memory);
-		dma_pool->local_data_memory = NULL;
-	}
+/*
+ * Submit a single DMA that reads a contiguous run of SQEs from Host
+ *
+ * The task of the first SQE in the run is used, its buffers span until the end of the queue
+ *
+ * @sq [in]: The SQ to read from
+ * @first_idx [in]: Index of the first SQE in the run
+ * @num_sqes [in]: Number of SQEs in the run, must not cross the end of the queue
+ * @db_ticks [in]: Time at which the Host DB that produced the run was received
+ * @flags [in]: Task submit flags
+ */
+static void nvmf_doca_sq_fetch_sqes(struct nvmf_doca_sq *sq,
+				    uint32_t first_idx,
+				    uint32_t num_sqes,
+				    uint64_t db_ticks,
+				    uint32_t flags)
+{
+	struct doca_dma_task_memcpy *sqe_task = sq->queue.elements[first_idx];
+	struct doca_buf *src_buffer = (struct doca_buf *)doca_dma_task_memcpy_get_src(sqe_task);
+	struct doca_buf *dst_buffer = doca_dma_task_memcpy_get_dst(sqe_task);
+	struct doca_task *task = doca_dma_task_memcpy_as_task(sqe_task);
+	union doca_data task_user_data;
+	void *src_head;
+
+	doca_buf_get_head(src_buffer, &src_head);
+	doca_buf_set_data(src_buffer, src_head, num_sqes * sizeof(struct nvmf_doca_sqe));
+	doca_buf_reset_data_len(dst_buffer);
+
+	task_user_data.u64 = SQE_FETCH_USER_DATA(first_idx, num_sqes);
+	doca_task_set_user_data(task, task_user_data);
+	sq->fetch_db_ticks[first_idx] = db_ticks;
+
+	doca_task_submit_ex(task, flags);
+
+	sq->fetch_stats.num_dmas++;
+	sq->fetch_stats.num_sqes += num_sqes;
 }
 
 /*
  * Update the producer index of the SQ
  *
- * This may cause read operations of SQEs
+ * This may cause read operations of SQEs. All SQEs between the old and new producer index are read using a single
+ * DMA, or two in case the range wraps around the end of the queue
  *
  * @sq [in]: The SQ that is being updated
  * @new_pi [in]: The new SQ producer index as provided by the Host
  */
 static void nvmf_doca_sq_update_pi(struct nvmf_doca_sq *sq, uint32_t new_pi)
 {
-	struct doca_dma_task_memcpy *sqe_task;
-	struct doca_buf *dst_buffer;
-	uint16_t sqe_idx;
-	uint16_t pi = sq->pi;
-	uint16_t num_sqes;
-	if (new_pi >= pi) {
-		num_sqes = (new_pi - pi);
-	} else {
-		num_sqes = ((sq->queue.num_elements - pi) + new_pi);
-	}
+	uint32_t pi = sq->pi;
+	uint32_t num_elements = sq->queue.num_elements;
+	uint64_t db_ticks;
+
+	if (new_pi == pi || new_pi >= num_elements)
+		return;
 
-	for (uint16_t sqe_count = 0; sqe_count < num_sqes; sqe_count++) {
-		sqe_idx = (pi + sqe_count) % sq->queue.num_elements;
-		sqe_task = sq->queue.elements[sqe_idx];
+	db_ticks = spdk_get_ticks();
+	sq->fetch_stats.num_doorbells++;
 
-		dst_buffer = doca_dma_task_memcpy_get_dst(sqe_task);
-		doca_buf_reset_data_len(dst_buffer);
-		if (sqe_count == (num_sqes - 1)) {
-			doca_task_submit_ex(doca_dma_task_memcpy_as_task(sqe_task), DOCA_TASK_SUBMIT_FLAG_FLUSH);
-		} else {
-			doca_task_submit_ex(doca_dma_task_memcpy_as_task(sqe_task),
-					    DOCA_TASK_SUBMIT_FLAG_OPTIMIZE_REPORTS);
-		}
+	if (new_pi > pi) {
+		nvmf_doca_sq_fetch_sqes(sq, pi, new_pi - pi, db_ticks, DOCA_TASK_SUBMIT_FLAG_FLUSH);
+	} else if (new_pi == 0) {
+		nvmf_doca_sq_fetch_sqes(sq, pi, num_elements - pi, db_ticks, DOCA_TASK_SUBMIT_FLAG_FLUSH);
+	} else {
+		nvmf_doca_sq_fetch_sqes(sq, pi, num_elements - pi, db_ticks, DOCA_TASK_SUBMIT_FLAG_OPTIMIZE_REPORTS);
+		nvmf_doca_sq_fetch_sqes(sq, 0, new_pi, db_ticks, DOCA_TASK_SUBMIT_FLAG_FLUSH);
 	}
 
 	sq->pi = new_pi;
 }
 
+/*
+ * Log the SQE fetch counters of the SQ
+ *
+ * @sq [in]: The SQ
+ */
+static void nvmf_doca_sq_log_fetch_stats(const struct nvmf_doca_sq *sq)
+{
+	const struct nvmf_doca_sq_fetch_stats *stats = &sq->fetch_stats;
+	uint64_t ticks_hz = spdk_get_ticks_hz();
+
+	if (stats->num_dmas == 0)
+		return;
+
+	DOCA_LOG_INFO("SQ %u fetch: %lu DBs, %lu DMAs, %lu SQEs, %.2f SQEs per DMA",
+		      sq->sq_id,
+		      stats->num_doorbells,
+		      stats->num_dmas,
+		      stats->num_sqes,
+		      (double)stats->num_sqes / stats->num_dmas);
+
+	for (uint32_t bucket = 0; bucket < NVMF_DOCA_SQ_FETCH_LAT_BUCKETS; bucket++) {
+		if (stats->lat_samples[bucket] == 0)
+			continue;
+		DOCA_LOG_INFO("SQ %u fetch: batch size >= %u: %lu DMAs, avg DB to dispatch latency %.3f usec",
+			      sq->sq_id,
+			      1U << bucket,
+			      stats->lat_samples[bucket],
+			      (double)stats->lat_ticks[bucket] * 1000000 / stats->lat_samples[bucket] / ticks_hz);
+	}
+}
+
 /*
  * Method invoked once Host DB message is received from DPA
  *
@@ -2156,7 +2161,9 @@ static void nvmf_doca_io_handle_host_db_msg(struct nvmf_doca_io *io, const struc
 }
 
 /*
- * Callback invoked once a SQE has been successfully read from Host
+ * Callback invoked once a run of SQEs has been successfully read from Host
+ *
+ * Each SQE in the run is dispatched in order
  *
  * @task [in]: The DMA memcpy task
  * @task_user_data [in]: User data that was previously provided with the task
@@ -2169,12 +2176,21 @@ static void nvmf_doca_sq_sqe_read_cb(struct doca_dma_task_memcpy *task,
 	struct doca_buf *sqe_buf;
 	struct nvmf_doca_sqe *sqe;
 	struct nvmf_doca_sq *sq = ctx_user_data.ptr;
-	uint16_t sqe_idx = task_user_data.u64;
+	uint32_t first_idx = SQE_FETCH_FIRST_IDX(task_user_data.u64);
+	uint32_t num_sqes = SQE_FETCH_NUM_SQES(task_user_data.u64);
+	uint32_t bucket;
 
 	sqe_buf = doca_dma_task_memcpy_get_dst(task);
 	doca_buf_get_data(sqe_buf, (void **)&sqe);
 
-	sq->io->fetch_sqe_cb(sq, sqe, sqe_idx);
+	for (uint32_t sqe_count = 0; sqe_count < num_sqes; sqe_count++)
+		sq->io->fetch_sqe_cb(sq, &sqe[sqe_count], first_idx + sqe_count);
+
+	bucket = 31 - __builtin_clz(num_sqes);
+	if (bucket >= NVMF_DOCA_SQ_FETCH_LAT_BUCKETS)
+		bucket = NVMF_DOCA_SQ_FETCH_LAT_BUCKETS - 1;
+	sq->fetch_stats.lat_ticks[bucket] += spdk_get_ticks() - sq->fetch_db_ticks[first_idx];
+	sq->fetch_stats.lat_samples[bucket]++;
 }
 
 /*
@@ -2236,146 +2252,6 @@ static void nvmf_doca_sq_queue_dma_state_changed_cb(const union doca_data user_d
 	}
 }
 
-/*
- * Creates NVMF doca requests pool and associates it with the given SQ.
- *
- * @sq [in]: The SQ that holds the requests pool
- * @num_requests [in]: Number of requests to be allocated
- * @doca_pg [in]: Doca poll group taking care of the request
- * @return: DOCA_SUCCESS on success and DOCA_ERROR_NO_MEMORY when allocation fails.
- */
-static doca_error_t nvmf_doca_request_pool_create(struct nvmf_doca_sq *sq, size_t num_requests)
-{
-	sq->request_pool_memory = calloc(num_requests, sizeof(struct nvmf_doca_request));
-	if (sq->request_pool_memory == NULL) {
-		DOCA_LOG_ERR("Failed to create NVMf DOCA SQ SPDK request pool: Failed to allocate memory for requests");
-		return DOCA_ERROR_NO_MEMORY;
-	}
-
-	TAILQ_INIT(&sq->request_pool);
-	for (size_t request_idx = 0; request_idx < num_requests; request_idx++) {
-		struct nvmf_doca_request *request = &(sq->request_pool_memory[request_idx]);
-		request->request.cmd = (union nvmf_h2c_msg *)&request->command;
-		request->request.rsp = (union nvmf_c2h_msg *)&request->cq_entry;
-		request->request.qpair = &sq->spdk_qp;
-		request->request.stripped_data = NULL;
-		TAILQ_INSERT_TAIL(&(sq->request_pool), request, link);
-	}
-	return DOCA_SUCCESS;
-}
-
-/*
- * Destroys NVMF doca requests pool.
- *
- * @sq [in]: The SQ that holds the requests pool
- * @return: DOCA_SUCCESS on success and DOCCA_ERROR otherwise
- */
-static doca_error_t nvmf_doca_request_pool_destroy(struct nvmf_doca_sq *sq)
-{
-	if (sq->request_pool_memory != NULL) {
-		TAILQ_INIT(&(sq->request_pool));
-		free(sq->request_pool_memory);
-		sq->request_pool_memory = NULL;
-	}
-
-	return DOCA_SUCCESS;
-}
-
-/*
- * This function is responsible for obtaining an NVMF request object from the pool associated
- * with the given SQ.
- *
- * @sq [in]: The SQ that holds the requests pool
- * @return: NVMF doca request
- */
-struct nvmf_doca_request *nvmf_doca_request_get(struct nvmf_doca_sq *sq)
-{
-	struct nvmf_doca_request *request = TAILQ_FIRST(&sq->request_pool);
-	if (request == NULL) {
-		return NULL;
-	}
-
-	TAILQ_REMOVE(&(sq->request_pool), request, link);
-
-	return request;
-}
-
-/*
- * This method is responsible for freeing an NVMF request that has been processed.
- * It returns the request back to the pool associated with the given SQ, making it available for reuse.
- *
- * @sq [in]: The SQ that holds the requests pool
- * @request [in]: NVMF doca request
- */
-static void nvmf_doca_request_free_impl(struct nvmf_doca_sq *sq, struct nvmf_doca_request *request)
-{
-	memset(&request->command, 0, sizeof(request->command));
-	memset(&request->cq_entry, 0, sizeof(request->cq_entry));
-	request->data_from_alloc = false;
-	request->cb_arg = NULL;
-	request->doca_cb = NULL;
-	request->request.data = NULL;
-	request->request.iovcnt = 0;
-	request->request.length = 0;
-	request->prp_dpu_buf = NULL;
-	request->prp_host_buf = NULL;
-	request->num_of_buffers = 0;
-	request->residual_length = 0;
-	request->sqe_idx = 0;
-
-	TAILQ_INSERT_TAIL(&sq->request_pool, request, link);
-}
-
-/*
- * This method completes an NVMF request by invoking its associated callback and then freeing the request.
- *
- * @request [in]: NVMF doca request to complete
- */
-void nvmf_doca_request_complete(struct nvmf_doca_request *request)
-{
-	if (request->doca_cb != NULL) {
-		request->doca_cb(request, request->cb_arg);
-	}
-}
-
-/*
- * Determines the correct SQ for the request and then invokes the internal mechanism to free the request.
- *
- * @request [in]: NVMF doca request to free
- */
-void nvmf_doca_request_free(struct nvmf_doca_request *request)
-{
-	struct nvmf_doca_sq *sq = SPDK_CONTAINEROF(request->request.qpair, struct nvmf_doca_sq, spdk_qp);
-
-	int used_host_bufs = request->request.iovcnt;
-	int used_dpu_bufs = request->request.iovcnt;
-	while (used_dpu_bufs > 0) {
-		if (request->dpu_buffer[used_dpu_bufs - 1])
-			doca_buf_dec_refcount(request->dpu_buffer[used_dpu_bufs - 1], NULL);
-		used_dpu_bufs--;
-	}
-
-	while (used_host_bufs > 0) {
-		if (request->host_buffer[used_host_bufs - 1])
-			doca_buf_dec_refcount(request->host_buffer[used_host_bufs - 1], NULL);
-		used_host_bufs--;
-	}
-
-	if (request->prp_dpu_buf != NULL) {
-		doca_buf_dec_refcount(request->prp_dpu_buf, NULL);
-	}
-
-	if (request->prp_host_buf != NULL) {
-		doca_buf_dec_refcount(request->prp_host_buf, NULL);
-	}
-
-	if (request->data_from_alloc) {
-		free(request->request.data);
-	}
-
-	nvmf_doca_request_free_impl(sq, request);
-}
-
 /*
  * Destroy NVMf DOCA SQ
  *
@@ -2397,6 +2273,9 @@ static void nvmf_doca_sq_destroy(struct nvmf_doca_sq *sq)
 
 	nvmf_doca_queue_destroy(&sq->queue);
 
+	free(sq->fetch_db_ticks);
+	sq->fetch_db_ticks = NULL;
+
 	nvmf_doca_request_pool_destroy(sq);
 }
 
@@ -2411,6 +2290,8 @@ struct nvmf_doca_sq_create_attr {
 	uint32_t sq_id;				       /**< The NVMe CQ ID that is associated with this IO */
 	struct nvmf_doca_io *io;		       /**< The IO that the SQ is added to */
 	struct spdk_nvmf_transport *transport;	       /**< The doca transport includes this SQ */
+	uint32_t dma_pool_64k_bufs;		       /**< Number of 64KiB DPU data buffers */
+	uint32_t dma_pool_1m_bufs;		       /**< Number of 1MiB DPU data buffers */
 	void *ctx;				       /**< Opaque structure that can be set by user */
 };
 
@@ -2439,6 +2320,7 @@ static doca_error_t nvmf_doca_sq_create(const struct nvmf_doca_sq_create_attr *a
 		.queue_depth = attr->sq_depth,
 		.element_size = sizeof(struct nvmf_doca_sqe),
 		.is_read_from_remote = true,
+		.coalesce_elements = true,
 		.success_cb = nvmf_doca_sq_sqe_read_cb,
 		.error_cb = nvmf_doca_sq_sqe_read_error_cb,
 		.dma_state_changed_cb = nvmf_doca_sq_queue_dma_state_changed_cb,
@@ -2450,12 +2332,24 @@ static doca_error_t nvmf_doca_sq_create(const struct nvmf_doca_sq_create_attr *a
 		return result;
 	}
 
+	sq->fetch_db_ticks = calloc(attr->sq_depth, sizeof(*sq->fetch_db_ticks));
+	if (sq->fetch_db_ticks == NULL) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA SQ: Failed to allocate memory for SQE fetch timestamps");
+		nvmf_doca_sq_destroy(sq);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
 	const uint32_t num_sq_elements = attr->sq_depth;
 	struct nvmf_doca_dma_pool_create_attr dma_pool_attr = {
 		.pe = attr->pe,
 		.dev = attr->dev,
 		.max_dma_operations = num_sq_elements * NVMF_REQ_MAX_BUFFERS,
-		.max_dma_operation_size = DMA_POOL_DATA_BUFFER_SIZE,
+		.num_class_bufs =
+			{
+				[NVMF_DOCA_DMA_POOL_CLASS_4K] = num_sq_elements * NVMF_REQ_MAX_BUFFERS,
+				[NVMF_DOCA_DMA_POOL_CLASS_64K] = attr->dma_pool_64k_bufs,
+				[NVMF_DOCA_DMA_POOL_CLASS_1M] = attr->dma_pool_1m_bufs,
+			},
 		.host_data_mmap = attr->host_sq_mmap,
 		.success_cb = nvmf_doca_dma_pool_copy_cb,
 		.error_cb = nvmf_doca_dma_pool_copy_error_cb,
@@ -2591,6 +2485,9 @@ static void nvmf_doca_sq_stop_continue(struct nvmf_doca_sq *sq)
 		return;
 	}
 
+	nvmf_doca_sq_log_fetch_stats(sq);
+	nvmf_doca_sq_log_dma_pool_stats(sq);
+
 	io->stop_sq_cb(sq);
 }
 
@@ -2612,6 +2509,8 @@ void nvmf_doca_io_add_sq(struct nvmf_doca_io *io, const struct nvmf_doca_io_add_
 		.sq_id = attr->sq_id,
 		.io = io,
 		.transport = attr->transport,
+		.dma_pool_64k_bufs = attr->dma_pool_64k_bufs,
+		.dma_pool_1m_bufs = attr->dma_pool_1m_bufs,
 		.ctx = attr->ctx,
 	};
 	doca_error_t result = nvmf_doca_sq_create(&sq_attr, sq);
@@ -48,6 +48,15 @@
 #define NVMF_DOCA_SQE_SIZE 64
 
 #define DMA_POOL_DATA_BUFFER_SIZE (1UL << 12)
+#define DMA_POOL_DATA_BUFFER_SIZE_64K (1UL << 16)
+#define DMA_POOL_DATA_BUFFER_SIZE_1M (1UL << 20)
+
+enum nvmf_doca_dma_pool_class {
+	NVMF_DOCA_DMA_POOL_CLASS_4K,
+	NVMF_DOCA_DMA_POOL_CLASS_64K,
+	NVMF_DOCA_DMA_POOL_CLASS_1M,
+	NVMF_DOCA_DMA_POOL_NUM_CLASSES,
+};
 
 struct nvmf_doca_cqe {
 	uint8_t data[NVMF_DOCA_CQE_SIZE]; /**< The contents of the CQE */
@@ -92,13 +101,29 @@ struct nvmf_doca_cq {
 
 typedef void (*nvmf_doca_cq_post_cqe_cb)(struct nvmf_doca_cq *cq, union doca_data user_data);
 
+struct nvmf_doca_dma_pool_class_stats {
+	uint64_t requests; /**< Number of data buffer allocations for which this was the best fitting class */
+	uint64_t misses;   /**< Number of such allocations that found the class exhausted */
+	uint64_t allocs;   /**< Number of buffers handed out from this class, including fallbacks */
+	uint64_t bytes;	   /**< Number of data bytes mapped to buffers of this class */
+};
+
+struct nvmf_doca_dma_pool_class {
+	uint32_t buf_size;			     /**< Size in bytes of each buffer in the class */
+	uint32_t num_bufs;			     /**< Number of buffers in the class, 0 if disabled */
+	void *local_data_memory;		     /**< Memory allocated for local data buffers */
+	struct doca_mmap *local_data_mmap;	     /**< The mmap for the local data buffers */
+	struct doca_buf_pool *local_data_pool;	     /**< Pool of local data buffers */
+	struct nvmf_doca_dma_pool_class_stats stats; /**< Allocation and throughput counters */
+};
+
 struct nvmf_doca_dma_pool {
-	void *local_data_memory;			/**< Memory allocated for local data buffers */
-	struct doca_mmap *local_data_mmap;		/**< The mmap for the local data buffers */
-	struct doca_buf_pool *local_data_pool;		/**< Pool of local data buffers */
-	struct doca_mmap *host_data_mmap;		/**< mmap granting access to Host data buffers */
-	struct doca_buf_inventory *host_data_inventory; /**< Inventory for allocating Host data buffers */
-	struct doca_dma *dma;				/**< DMA context used for copying data between Host and DPU */
+	struct nvmf_doca_dma_pool_class classes[NVMF_DOCA_DMA_POOL_NUM_CLASSES]; /**< Size classed local buffers */
+	struct doca_buf_inventory *local_view_inventory; /**< Inventory for buffers pointing into local data buffers */
+	struct doca_mmap *host_data_mmap;		 /**< mmap granting access to Host data buffers */
+	struct doca_buf_inventory *host_data_inventory;	 /**< Inventory for allocating Host data buffers */
+	struct doca_dma *dma;				 /**< DMA context used for copying data between Host and DPU */
+	uint64_t start_ticks;				 /**< Creation time, used for reporting throughput */
 };
 
 struct nvmf_doca_io;
@@ -112,10 +137,13 @@ struct nvmf_doca_request {
 	struct nvmf_doca_sq *doca_sq;			    /**< The SQ handling the request */
 	struct spdk_nvme_cpl cq_entry;			    /**< Completion queue entry */
 	struct spdk_nvme_cmd command;			    /**< The NVMe command */
-	struct doca_buf *dpu_buffer[NVMF_REQ_MAX_BUFFERS];  /**< Array of pointers to DPU data buffers */
-	struct doca_buf *host_buffer[NVMF_REQ_MAX_BUFFERS]; /**< Array of pointers to host data buffers */
+	struct doca_buf *dpu_buffer[NVMF_REQ_MAX_BUFFERS];  /**< DPU side buffer of each DMA segment */
+	struct doca_buf *host_buffer[NVMF_REQ_MAX_BUFFERS]; /**< Host side buffer of each DMA segment */
+	struct doca_buf *dpu_data_buffer[NVMF_REQ_MAX_BUFFERS]; /**< Size classed DPU buffers backing the IOVs */
 	struct doca_buf *prp_host_buf;
 	struct doca_buf *prp_dpu_buf;
+	uint32_t num_segments;		     /**< Number of DMA segments in dpu_buffer and host_buffer */
+	uint32_t num_dpu_data_buffers;	     /**< Number of buffers in dpu_data_buffer */
 	uint32_t num_of_buffers;	     /**< Counter for the number of buffers full so far */
 	uint32_t residual_length;	     /**< The remainder of the NVMe request for write or read operations */
 	uint16_t sqe_idx;		     /**< The SQE index of this request*/
@@ -143,6 +171,17 @@ enum nvmf_doca_sq_db_state {
 
 typedef void (*nvmf_doca_sq_stop_cb)(struct nvmf_doca_sq *sq);
 
+/* Fetch latency is bucketed by the number of SQEs per DMA: 1, 2-3, 4-7, ..., 128 and above */
+#define NVMF_DOCA_SQ_FETCH_LAT_BUCKETS 8
+
+struct nvmf_doca_sq_fetch_stats {
+	uint64_t num_doorbells; /**< Number of Host DBs that advanced the SQ producer index */
+	uint64_t num_dmas;	/**< Number of DMA tasks submitted for fetching SQEs */
+	uint64_t num_sqes;	/**< Number of SQEs fetched from Host */
+	uint64_t lat_ticks[NVMF_DOCA_SQ_FETCH_LAT_BUCKETS];   /**< Accumulated DB to dispatch latency in ticks */
+	uint64_t lat_samples[NVMF_DOCA_SQ_FETCH_LAT_BUCKETS]; /**< Number of DMAs accounted in each bucket */
+};
+
 struct nvmf_doca_sq {
 	struct spdk_nvmf_qpair spdk_qp;		       /**< The NVMf Target QPair */
 	struct nvmf_doca_queue queue;		       /**< Queue used for reading SQEs from Host */
@@ -156,6 +195,8 @@ struct nvmf_doca_sq {
 	void *ctx;				       /**< Opaque structure that can be set by user */
 	enum nvmf_doca_sq_db_state db_state;	       /**< The state of the SQ DB */
 	doca_error_t result;			       /**< Stored error in case add operation fails midway */
+	uint64_t *fetch_db_ticks;		       /**< DB arrival time of the fetch starting at given index */
+	struct nvmf_doca_sq_fetch_stats fetch_stats;   /**< SQE fetch coalescing and latency counters */
 	struct nvmf_doca_request *request_pool_memory; /**< Pointer to NVMF doca request pool memory */
 	TAILQ_HEAD(, nvmf_doca_request) request_pool;  /**< List of the NVMF doca requests */
 	TAILQ_ENTRY(nvmf_doca_sq) link;		       /**< Pointer to next SQ in list */
@@ -177,6 +218,28 @@ typedef void (*nvmf_doca_io_stop_cb)(struct nvmf_doca_io *io);
 
 struct nvmf_doca_pci_dev_admin;
 
+typedef void (*nvmf_doca_io_copy_data_fn)(struct nvmf_doca_sq *sq,
+					  struct doca_buf *dst_buffer,
+					  struct doca_buf *src_buffer,
+					  size_t length,
+					  union doca_data user_data);
+typedef void (*nvmf_doca_io_post_cqe_fn)(struct nvmf_doca_io *io,
+					 const struct nvmf_doca_cqe *cqe,
+					 union doca_data user_data);
+typedef void (*nvmf_doca_io_exec_fn)(struct nvmf_doca_request *request);
+
+/*
+ * Operations the NVM command data path of nvmf_doca_io_common relies on
+ *
+ * The DOCA transport moves data and CQEs with DMA and executes commands through the NVMf target, a loopback IO may
+ * replace any of them with a software stand-in while running the very same data path
+ */
+struct nvmf_doca_io_ops {
+	nvmf_doca_io_copy_data_fn copy_data; /**< Copy data between Host and DPU, see nvmf_doca_sq_copy_data() */
+	nvmf_doca_io_post_cqe_fn post_cqe;   /**< Post a CQE to the Host CQ, see nvmf_doca_io_post_cqe() */
+	nvmf_doca_io_exec_fn exec;	     /**< Execute the command, nvmf_doca_request_complete() once done */
+};
+
 struct nvmf_doca_io {
 	struct nvmf_doca_pci_dev_poll_group *poll_group; /**< Doca poll group this IO belongs to */
 	struct nvmf_doca_pci_dev_admin *pci_dev_admin;	 /**< The PCI device admin context */
@@ -190,6 +253,7 @@ struct nvmf_doca_io {
 	nvmf_doca_sq_copy_data_cb copy_data_cb;		 /**< Callback invoked once data copy operation completes */
 	nvmf_doca_sq_stop_cb stop_sq_cb;		 /**< Callback invoked once an SQ has been stopped */
 	nvmf_doca_io_stop_cb stop_io_cb;		 /**< Callback invoked once an IO has been stopped */
+	const struct nvmf_doca_io_ops *ops;		 /**< Operations used by the NVM command data path */
 	void *ctx;					 /**< Opaque structure that can be set by user */
 	TAILQ_HEAD(, nvmf_doca_sq) sq_list;		 /**< List of the added SQs */
 	TAILQ_ENTRY(nvmf_doca_io) pci_dev_admin_link;	 /**< Link to next doca io, used by PCI device NVMf context */
@@ -213,6 +277,7 @@ struct nvmf_doca_io_create_attr {
 	nvmf_doca_sq_copy_data_cb copy_data_cb; /**< Callback invoked once data copy operation completes */
 	nvmf_doca_sq_stop_cb stop_sq_cb;	/**< Callback invoked once an SQ has been stopped */
 	nvmf_doca_io_stop_cb stop_io_cb;	/**< Callback invoked once an IO has been stopped */
+	const struct nvmf_doca_io_ops *ops;	/**< Operations used by the NVM command data path */
 };
 
 /*
@@ -254,6 +319,8 @@ struct nvmf_doca_io_add_sq_attr {
 	uintptr_t host_sq_address;	       /**< I/O address of the CQ on the Host */
 	uint32_t sq_id;			       /**< The NVMe CQ ID that is associated with this IO */
 	struct spdk_nvmf_transport *transport; /**< The doca transport includes this IO */
+	uint32_t dma_pool_64k_bufs;	       /**< Number of 64KiB DPU data buffers, 0 to disable the class */
+	uint32_t dma_pool_1m_bufs;	       /**< Number of 1MiB DPU data buffers, 0 to disable the class */
 	void *ctx;			       /**< Opaque structure that can be set by user */
 };
 
@@ -308,6 +375,31 @@ void nvmf_doca_io_post_cqe(struct nvmf_doca_io *io, const struct nvmf_doca_cqe *
  */
 struct doca_buf *nvmf_doca_sq_get_dpu_buffer(struct nvmf_doca_sq *sq);
 
+/*
+ * Get DPU data buffer from the best fitting size class for the given length
+ *
+ * The smallest enabled class that can hold the length is preferred, or the largest enabled class in case none can.
+ * If the preferred class is exhausted then a smaller class is used and the caller is expected to chain buffers.
+ * Buffer must be freed by caller using doca_buf_dec_refcount()
+ *
+ * @sq [in]: The SQ to be used for the copy operation
+ * @length [in]: The remaining length of data that needs to be mapped
+ * @return: Empty buffer of at least 4KiB on success and NULL otherwise
+ */
+struct doca_buf *nvmf_doca_sq_get_dpu_data_buffer(struct nvmf_doca_sq *sq, size_t length);
+
+/*
+ * Get buffer pointing to part of a DPU data buffer, can be used as DPU side of a copy operation
+ *
+ * Buffer must be freed by caller using doca_buf_dec_refcount()
+ *
+ * @sq [in]: The SQ to be used for the copy operation
+ * @address [in]: Address inside a buffer previously returned by nvmf_doca_sq_get_dpu_data_buffer()
+ * @length [in]: Length of the buffer
+ * @return: Buffer pointing to the given DPU address on success and NULL otherwise
+ */
+struct doca_buf *nvmf_doca_sq_get_dpu_buffer_view(struct nvmf_doca_sq *sq, void *address, size_t length);
+
 /*
  * Get buffer pointing to Host memory, can be used to copy data between Host and DPU
  *
@@ -315,9 +407,10 @@ struct doca_buf *nvmf_doca_sq_get_dpu_buffer(struct nvmf_doca_sq *sq);
  *
  * @sq [in]: The SQ to be used for the copy operation
  * @host_io_address [in]: I/O address of Host buffer
+ * @length [in]: Length of the Host buffer
  * @return: Buffer pointing to the given Host I/O address
  */
-struct doca_buf *nvmf_doca_sq_get_host_buffer(struct nvmf_doca_sq *sq, uintptr_t host_io_address);
+struct doca_buf *nvmf_doca_sq_get_host_buffer(struct nvmf_doca_sq *sq, uintptr_t host_io_address, size_t length);
 
 /*
  * Copy data between Host and DPU
@@ -0,0 +1,719 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvmf_doca_io_common.h"
+
+#include <spdk/env.h>
+#include <spdk/util.h>
+
+#include <doca_log.h>
+#include <doca_mmap.h>
+
+DOCA_LOG_REGISTER(NVMF_DOCA_IO_COMMON);
+
+#define CACHELINE_SIZE_BYTES 64
+
+static const uint32_t dma_pool_class_buf_sizes[NVMF_DOCA_DMA_POOL_NUM_CLASSES] = {
+	[NVMF_DOCA_DMA_POOL_CLASS_4K] = DMA_POOL_DATA_BUFFER_SIZE,
+	[NVMF_DOCA_DMA_POOL_CLASS_64K] = DMA_POOL_DATA_BUFFER_SIZE_64K,
+	[NVMF_DOCA_DMA_POOL_CLASS_1M] = DMA_POOL_DATA_BUFFER_SIZE_1M,
+};
+
+struct doca_buf *nvmf_doca_sq_get_dpu_buffer(struct nvmf_doca_sq *sq)
+{
+	struct doca_buf *buf;
+
+	doca_buf_pool_buf_alloc(sq->dma_pool.classes[NVMF_DOCA_DMA_POOL_CLASS_4K].local_data_pool, &buf);
+
+	return buf;
+}
+
+struct doca_buf *nvmf_doca_sq_get_dpu_data_buffer(struct nvmf_doca_sq *sq, size_t length)
+{
+	struct nvmf_doca_dma_pool_class *classes = sq->dma_pool.classes;
+	struct doca_buf *buf;
+	int preferred = NVMF_DOCA_DMA_POOL_CLASS_4K;
+
+	for (int cls = 0; cls < NVMF_DOCA_DMA_POOL_NUM_CLASSES; cls++) {
+		if (classes[cls].local_data_pool == NULL)
+			continue;
+		preferred = cls;
+		if (classes[cls].buf_size >= length)
+			break;
+	}
+
+	classes[preferred].stats.requests++;
+	for (int cls = preferred; cls >= 0; cls--) {
+		if (classes[cls].local_data_pool == NULL)
+			continue;
+		if (doca_buf_pool_buf_alloc(classes[cls].local_data_pool, &buf) == DOCA_SUCCESS) {
+			classes[cls].stats.allocs++;
+			classes[cls].stats.bytes += spdk_min(length, classes[cls].buf_size);
+			return buf;
+		}
+		if (cls == preferred)
+			classes[cls].stats.misses++;
+	}
+
+	return NULL;
+}
+
+struct doca_buf *nvmf_doca_sq_get_dpu_buffer_view(struct nvmf_doca_sq *sq, void *address, size_t length)
+{
+	struct nvmf_doca_dma_pool_class *classes = sq->dma_pool.classes;
+	struct doca_buf *buf;
+
+	for (int cls = 0; cls < NVMF_DOCA_DMA_POOL_NUM_CLASSES; cls++) {
+		uint8_t *start = classes[cls].local_data_memory;
+
+		if (start == NULL || (uint8_t *)address < start ||
+		    (uint8_t *)address >= start + (size_t)classes[cls].num_bufs * classes[cls].buf_size)
+			continue;
+
+		if (doca_buf_inventory_buf_get_by_addr(sq->dma_pool.local_view_inventory,
+						       classes[cls].local_data_mmap,
+						       address,
+						       length,
+						       &buf) != DOCA_SUCCESS)
+			return NULL;
+
+		return buf;
+	}
+
+	return NULL;
+}
+
+struct doca_buf *nvmf_doca_sq_get_host_buffer(struct nvmf_doca_sq *sq, uintptr_t host_io_address, size_t length)
+{
+	struct doca_buf *buf;
+
+	doca_buf_inventory_buf_get_by_addr(sq->dma_pool.host_data_inventory,
+					   sq->dma_pool.host_data_mmap,
+					   (void *)host_io_address,
+					   length,
+					   &buf);
+
+	return buf;
+}
+
+/*
+ * Create the local buffers of a single DMA pool size class
+ *
+ * @dev [in]: A doca device representing the emulation manager, NULL if buffers are only accessed by the CPU
+ * @buf_size [in]: Size in bytes of each buffer in the class
+ * @num_bufs [in]: Number of buffers in the class
+ * @pool_class [out]: The size class to initialize
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t nvmf_doca_dma_pool_class_create(struct doca_dev *dev,
+						    uint32_t buf_size,
+						    uint32_t num_bufs,
+						    struct nvmf_doca_dma_pool_class *pool_class)
+{
+	doca_error_t result;
+
+	pool_class->buf_size = buf_size;
+	pool_class->num_bufs = num_bufs;
+	if (num_bufs == 0)
+		return DOCA_SUCCESS;
+
+	size_t local_data_memory_size = (size_t)num_bufs * buf_size;
+	pool_class->local_data_memory = spdk_dma_zmalloc(local_data_memory_size, CACHELINE_SIZE_BYTES, NULL);
+	if (pool_class->local_data_memory == NULL) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to allocate memory for %u local data buffers of %u bytes",
+			     num_bufs,
+			     buf_size);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	result = doca_mmap_create(&pool_class->local_data_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to create local data mmap - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	result = doca_mmap_set_memrange(pool_class->local_data_mmap,
+					pool_class->local_data_memory,
+					local_data_memory_size);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to create local data mmap - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	result = doca_mmap_set_permissions(pool_class->local_data_mmap, DOCA_ACCESS_FLAG_LOCAL_READ_WRITE);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to set local data mmap permissions - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	if (dev != NULL) {
+		result = doca_mmap_add_dev(pool_class->local_data_mmap, dev);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to add device to local dma mmap - %s",
+				     doca_error_get_name(result));
+			return result;
+		}
+	}
+	result = doca_mmap_start(pool_class->local_data_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to start local dma mmap - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+
+	result = doca_buf_pool_create(num_bufs, buf_size, pool_class->local_data_mmap, &pool_class->local_data_pool);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to create local data pool - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	result = doca_buf_pool_start(pool_class->local_data_pool);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA DMA pool: Failed to start local data pool - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Destroy the local buffers of a single DMA pool size class
+ *
+ * @pool_class [in]: The size class to destroy
+ */
+static void nvmf_doca_dma_pool_class_destroy(struct nvmf_doca_dma_pool_class *pool_class)
+{
+	doca_error_t result;
+
+	if (pool_class->local_data_pool != NULL) {
+		result = doca_buf_pool_destroy(pool_class->local_data_pool);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy NVMf DOCA DMA pool: Failed to destroy local data pool %s",
+				     doca_error_get_name(result));
+		pool_class->local_data_pool = NULL;
+	}
+
+	if (pool_class->local_data_mmap != NULL) {
+		result = doca_mmap_destroy(pool_class->local_data_mmap);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy NVMf DOCA DMA pool: Failed to destroy local data mmap %s",
+				     doca_error_get_name(result));
+		pool_class->local_data_mmap = NULL;
+	}
+
+	if (pool_class->local_data_memory != NULL) {
+		spdk_dma_free(pool_class->local_data_memory);
+		pool_class->local_data_memory = NULL;
+	}
+}
+
+doca_error_t nvmf_doca_dma_pool_classes_create(struct doca_dev *dev,
+					      const uint32_t num_class_bufs[NVMF_DOCA_DMA_POOL_NUM_CLASSES],
+					      struct nvmf_doca_dma_pool *dma_pool)
+{
+	doca_error_t result;
+
+	for (int cls = 0; cls < NVMF_DOCA_DMA_POOL_NUM_CLASSES; cls++) {
+		result = nvmf_doca_dma_pool_class_create(dev,
+							 dma_pool_class_buf_sizes[cls],
+							 num_class_bufs[cls],
+							 &dma_pool->classes[cls]);
+		if (result != DOCA_SUCCESS)
+			return result;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+void nvmf_doca_dma_pool_classes_destroy(struct nvmf_doca_dma_pool *dma_pool)
+{
+	for (int cls = 0; cls < NVMF_DOCA_DMA_POOL_NUM_CLASSES; cls++)
+		nvmf_doca_dma_pool_class_destroy(&dma_pool->classes[cls]);
+}
+
+/*
+ * Log the allocation and throughput counters of the DMA pool size classes
+ *
+ * @sq [in]: The SQ owning the DMA pool
+ */
+void nvmf_doca_sq_log_dma_pool_stats(const struct nvmf_doca_sq *sq)
+{
+	const struct nvmf_doca_dma_pool *dma_pool = &sq->dma_pool;
+	double elapsed_sec = (double)(spdk_get_ticks() - dma_pool->start_ticks) / spdk_get_ticks_hz();
+
+	for (int cls = 0; cls < NVMF_DOCA_DMA_POOL_NUM_CLASSES; cls++) {
+		const struct nvmf_doca_dma_pool_class *pool_class = &dma_pool->classes[cls];
+		const struct nvmf_doca_dma_pool_class_stats *stats = &pool_class->stats;
+
+		if (stats->requests == 0 && stats->allocs == 0)
+			continue;
+		DOCA_LOG_INFO("SQ %u DMA pool %u bytes class: %lu buffers, hit rate %.2f%%, %lu allocs, %.2f MiB/s",
+			      sq->sq_id,
+			      pool_class->buf_size,
+			      (uint64_t)pool_class->num_bufs,
+			      stats->requests == 0 ? 0.0 :
+						     100.0 * (stats->requests - stats->misses) / stats->requests,
+			      stats->allocs,
+			      elapsed_sec == 0 ? 0.0 : stats->bytes / elapsed_sec / (1024 * 1024));
+	}
+}
+
+/*
+ * Creates NVMF doca requests pool and associates it with the given SQ.
+ *
+ * @sq [in]: The SQ that holds the requests pool
+ * @num_requests [in]: Number of requests to be allocated
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR_NO_MEMORY when allocation fails.
+ */
+doca_error_t nvmf_doca_request_pool_create(struct nvmf_doca_sq *sq, size_t num_requests)
+{
+	sq->request_pool_memory = calloc(num_requests, sizeof(struct nvmf_doca_request));
+	if (sq->request_pool_memory == NULL) {
+		DOCA_LOG_ERR("Failed to create NVMf DOCA SQ SPDK request pool: Failed to allocate memory for requests");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	TAILQ_INIT(&sq->request_pool);
+	for (size_t request_idx = 0; request_idx < num_requests; request_idx++) {
+		struct nvmf_doca_request *request = &(sq->request_pool_memory[request_idx]);
+		request->request.cmd = (union nvmf_h2c_msg *)&request->command;
+		request->request.rsp = (union nvmf_c2h_msg *)&request->cq_entry;
+		request->request.qpair = &sq->spdk_qp;
+		request->request.stripped_data = NULL;
+		TAILQ_INSERT_TAIL(&(sq->request_pool), request, link);
+	}
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Destroys NVMF doca requests pool.
+ *
+ * @sq [in]: The SQ that holds the requests pool
+ * @return: DOCA_SUCCESS on success and DOCCA_ERROR otherwise
+ */
+doca_error_t nvmf_doca_request_pool_destroy(struct nvmf_doca_sq *sq)
+{
+	if (sq->request_pool_memory != NULL) {
+		TAILQ_INIT(&(sq->request_pool));
+		free(sq->request_pool_memory);
+		sq->request_pool_memory = NULL;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * This function is responsible for obtaining an NVMF request object from the pool associated
+ * with the given SQ.
+ *
+ * @sq [in]: The SQ that holds the requests pool
+ * @return: NVMF doca request
+ */
+struct nvmf_doca_request *nvmf_doca_request_get(struct nvmf_doca_sq *sq)
+{
+	struct nvmf_doca_request *request = TAILQ_FIRST(&sq->request_pool);
+	if (request == NULL) {
+		return NULL;
+	}
+
+	TAILQ_REMOVE(&(sq->request_pool), request, link);
+
+	return request;
+}
+
+/*
+ * This method is responsible for freeing an NVMF request that has been processed.
+ * It returns the request back to the pool associated with the given SQ, making it available for reuse.
+ *
+ * @sq [in]: The SQ that holds the requests pool
+ * @request [in]: NVMF doca request
+ */
+static void nvmf_doca_request_free_impl(struct nvmf_doca_sq *sq, struct nvmf_doca_request *request)
+{
+	memset(&request->command, 0, sizeof(request->command));
+	memset(&request->cq_entry, 0, sizeof(request->cq_entry));
+	request->data_from_alloc = false;
+	request->cb_arg = NULL;
+	request->doca_cb = NULL;
+	request->request.data = NULL;
+	request->request.iovcnt = 0;
+	request->request.length = 0;
+	request->prp_dpu_buf = NULL;
+	request->prp_host_buf = NULL;
+	request->num_segments = 0;
+	request->num_dpu_data_buffers = 0;
+	request->num_of_buffers = 0;
+	request->residual_length = 0;
+	request->sqe_idx = 0;
+
+	TAILQ_INSERT_TAIL(&sq->request_pool, request, link);
+}
+
+/*
+ * This method completes an NVMF request by invoking its associated callback and then freeing the request.
+ *
+ * @request [in]: NVMF doca request to complete
+ */
+void nvmf_doca_request_complete(struct nvmf_doca_request *request)
+{
+	if (request->doca_cb != NULL) {
+		request->doca_cb(request, request->cb_arg);
+	}
+}
+
+/*
+ * Determines the correct SQ for the request and then invokes the internal mechanism to free the request.
+ *
+ * @request [in]: NVMF doca request to free
+ */
+void nvmf_doca_request_free(struct nvmf_doca_request *request)
+{
+	struct nvmf_doca_sq *sq = SPDK_CONTAINEROF(request->request.qpair, struct nvmf_doca_sq, spdk_qp);
+
+	for (uint32_t idx = 0; idx < request->num_segments; idx++) {
+		if (request->dpu_buffer[idx])
+			doca_buf_dec_refcount(request->dpu_buffer[idx], NULL);
+		if (request->host_buffer[idx])
+			doca_buf_dec_refcount(request->host_buffer[idx], NULL);
+	}
+
+	for (uint32_t idx = 0; idx < request->num_dpu_data_buffers; idx++) {
+		if (request->dpu_data_buffer[idx])
+			doca_buf_dec_refcount(request->dpu_data_buffer[idx], NULL);
+	}
+
+	if (request->prp_dpu_buf != NULL) {
+		doca_buf_dec_refcount(request->prp_dpu_buf, NULL);
+	}
+
+	if (request->prp_host_buf != NULL) {
+		doca_buf_dec_refcount(request->prp_host_buf, NULL);
+	}
+
+	if (request->data_from_alloc) {
+		free(request->request.data);
+	}
+
+	nvmf_doca_request_free_impl(sq, request);
+}
+
+/*
+ * Add a DMA segment copying between a contiguous Host range and part of a DPU data buffer
+ *
+ * @request [in]: The NVMf request
+ * @host_io_address [in]: I/O address of the Host range
+ * @dpu_address [in]: Address inside one of the request DPU data buffers
+ * @length [in]: Length of the segment
+ */
+static void nvmf_doca_request_add_dma_segment(struct nvmf_doca_request *request,
+					      uint64_t host_io_address,
+					      void *dpu_address,
+					      uint32_t length)
+{
+	uint32_t idx = request->num_segments;
+
+	request->host_buffer[idx] = nvmf_doca_sq_get_host_buffer(request->doca_sq, host_io_address, length);
+	request->dpu_buffer[idx] = nvmf_doca_sq_get_dpu_buffer_view(request->doca_sq, dpu_address, length);
+	request->num_segments++;
+}
+
+/*
+ * Map the Host pages described by the PRP entries of an NVM command to size classed DPU buffers
+ *
+ * Each IOV is backed by a single DPU data buffer, a page never crosses two of them. Pages that are contiguous in Host
+ * memory and land in the same DPU data buffer are merged into a single DMA segment
+ *
+ * @request [in]: The NVMf request
+ * @prp_entries [in]: I/O addresses of the Host pages, only the first one may be unaligned
+ * @num_prp_entries [in]: Number of PRP entries
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t nvmf_doca_request_map_prp_entries(struct nvmf_doca_request *request,
+						      const uint64_t *prp_entries,
+						      uint32_t num_prp_entries)
+{
+	DOCA_LOG_TRC("Entering function %s", __func__);
+
+	struct iovec *iov = NULL;
+	struct iovec *seg_iov = NULL;
+	size_t data_buf_len = 0;
+	uint64_t seg_host_address = 0;
+	uint8_t *seg_dpu_address = NULL;
+	uint32_t seg_length = 0;
+	uint32_t length = request->request.length;
+
+	for (uint32_t idx = 0; idx < num_prp_entries && length != 0; idx++) {
+		uint64_t host_address = prp_entries[idx];
+		uint32_t page_length = NVME_PAGE_SIZE - (host_address % NVME_PAGE_SIZE);
+
+		page_length = spdk_min(length, page_length);
+
+		/* Chain a new DPU data buffer once the page does not fit into the current one */
+		if (iov == NULL || iov->iov_len + page_length > data_buf_len) {
+			struct doca_buf *data_buf = nvmf_doca_sq_get_dpu_data_buffer(request->doca_sq, length);
+			if (data_buf == NULL) {
+				DOCA_LOG_ERR("Failed to map PRP entries: No DPU data buffer available");
+				return DOCA_ERROR_NO_MEMORY;
+			}
+
+			request->dpu_data_buffer[request->num_dpu_data_buffers++] = data_buf;
+			iov = &request->request.iov[request->request.iovcnt++];
+			doca_buf_get_head(data_buf, &iov->iov_base);
+			doca_buf_get_len(data_buf, &data_buf_len);
+			iov->iov_len = 0;
+		}
+
+		uint8_t *dpu_address = (uint8_t *)iov->iov_base + iov->iov_len;
+		if (seg_length != 0 && seg_iov == iov && seg_host_address + seg_length == host_address) {
+			seg_length += page_length;
+		} else {
+			if (seg_length != 0)
+				nvmf_doca_request_add_dma_segment(request, seg_host_address, seg_dpu_address, seg_length);
+			seg_iov = iov;
+			seg_host_address = host_address;
+			seg_dpu_address = dpu_address;
+			seg_length = page_length;
+		}
+
+		iov->iov_len += page_length;
+		length -= page_length;
+	}
+	if (seg_length != 0)
+		nvmf_doca_request_add_dma_segment(request, seg_host_address, seg_dpu_address, seg_length);
+
+	request->num_of_buffers = request->num_segments;
+
+	return DOCA_SUCCESS;
+}
+
+/*********************************************************************************************************************
+ * NVM Command Data Path
+ *********************************************************************************************************************/
+
+void nvmf_doca_request_post_cqe(struct nvmf_doca_request *request, void *arg)
+{
+	(void)arg;
+
+	struct nvmf_doca_io *io = request->doca_sq->io;
+	union doca_data user_data;
+	user_data.ptr = request;
+
+	// Update SQ head
+	request->request.rsp->nvme_cpl.sqhd = request->sqe_idx;
+
+	io->ops->post_cqe(io, (const struct nvmf_doca_cqe *)&request->request.rsp->nvme_cpl, user_data);
+}
+
+void nvmf_doca_request_post_error_cqe(struct nvmf_doca_request *request)
+{
+	request->request.rsp->nvme_cpl.cid = request->request.cmd->nvme_cmd.cid;
+	request->request.rsp->nvme_cpl.status.sc = 1;
+
+	nvmf_doca_request_post_cqe(request, request);
+}
+
+/*
+ * Begin async copy of all DMA segments of the request
+ *
+ * @request [in]: The NVMf request
+ * @to_host [in]: Direction of the copy, from DPU to Host if true and from Host to DPU otherwise
+ */
+static void nvmf_doca_request_copy_segments(struct nvmf_doca_request *request, bool to_host)
+{
+	struct nvmf_doca_sq *sq = request->doca_sq;
+	union doca_data user_data;
+	size_t segment_length;
+
+	user_data.ptr = request;
+	request->num_of_buffers = request->num_segments;
+
+	for (uint32_t idx = 0; idx < request->num_segments; idx++) {
+		doca_buf_get_len(request->host_buffer[idx], &segment_length);
+		sq->io->ops->copy_data(sq,
+				       to_host ? request->host_buffer[idx] : request->dpu_buffer[idx],
+				       to_host ? request->dpu_buffer[idx] : request->host_buffer[idx],
+				       segment_length,
+				       user_data);
+	}
+}
+
+/*
+ * Begin async operation of copying data from DPU to Host once an NVM read was executed
+ *
+ * @request [in]: The NVMf request
+ * @arg [in]: Argument associated with the callback
+ */
+static void nvmf_doca_request_copy_data_to_host(struct nvmf_doca_request *request, void *arg)
+{
+	DOCA_LOG_TRC("Entering function %s", __func__);
+
+	(void)arg;
+	request->doca_cb = nvmf_doca_request_post_cqe;
+
+	nvmf_doca_request_copy_segments(request, true);
+}
+
+/*
+ * Execute an NVM write once its data was copied from Host
+ *
+ * @request [in]: The NVMf request
+ * @arg [in]: Argument associated with the callback
+ */
+static void nvmf_doca_request_exec_write(struct nvmf_doca_request *request, void *arg)
+{
+	(void)arg;
+
+	request->doca_cb = nvmf_doca_request_post_cqe;
+	request->doca_sq->io->ops->exec(request);
+}
+
+/*
+ * Continue once the data buffers of the request are mapped, copy data from Host before a write and execute a read
+ * right away
+ *
+ * @request [in]: The NVMf request
+ */
+static void nvmf_doca_request_buffers_ready(struct nvmf_doca_request *request)
+{
+	DOCA_LOG_TRC("Entering function %s", __func__);
+
+	if (request->request.cmd->nvme_cmd.opc == SPDK_NVME_OPC_WRITE) {
+		request->doca_cb = nvmf_doca_request_exec_write;
+		nvmf_doca_request_copy_segments(request, false);
+	} else {
+		request->doca_cb = nvmf_doca_request_copy_data_to_host;
+		request->doca_sq->io->ops->exec(request);
+	}
+}
+
+/*
+ * Map the Host pages described by the PRP entries and continue with the data copy, fail the request if mapping fails
+ *
+ * @request [in]: The NVMf request
+ * @prp_entries [in]: I/O addresses of the Host pages, only the first one may be unaligned
+ * @num_prp_entries [in]: Number of PRP entries
+ */
+static void nvmf_doca_request_map_prp_entries_and_continue(struct nvmf_doca_request *request,
+							   const uint64_t *prp_entries,
+							   uint32_t num_prp_entries)
+{
+	if (nvmf_doca_request_map_prp_entries(request, prp_entries, num_prp_entries) != DOCA_SUCCESS) {
+		nvmf_doca_request_post_error_cqe(request);
+		return;
+	}
+
+	nvmf_doca_request_buffers_ready(request);
+}
+
+/*
+ * Map the data described by the PRP list once it was copied from Host
+ *
+ * @request [in]: The NVMf request which holds the PRP list
+ * @arg [in]: Argument associated with the callback
+ */
+static void nvmf_doca_request_prp_list_ready(struct nvmf_doca_request *request, void *arg)
+{
+	DOCA_LOG_TRC("Entering function %s", __func__);
+
+	(void)arg;
+	uint64_t prp_entries[NVMF_REQ_MAX_BUFFERS];
+	uint64_t *prp_list_addr;
+	uint32_t num_prp_entries;
+
+	doca_buf_get_head(request->prp_dpu_buf, (void **)&prp_list_addr);
+
+	prp_entries[0] = request->request.cmd->nvme_cmd.dptr.prp.prp1;
+	num_prp_entries = 1 + SPDK_CEIL_DIV(request->residual_length, NVME_PAGE_SIZE);
+	num_prp_entries = spdk_min(num_prp_entries, NVMF_REQ_MAX_BUFFERS);
+	memcpy(&prp_entries[1], prp_list_addr, (num_prp_entries - 1) * sizeof(*prp_entries));
+
+	doca_buf_dec_refcount(request->prp_dpu_buf, NULL);
+	request->prp_dpu_buf = NULL;
+	doca_buf_dec_refcount(request->prp_host_buf, NULL);
+	request->prp_host_buf = NULL;
+
+	nvmf_doca_request_map_prp_entries_and_continue(request, prp_entries, num_prp_entries);
+}
+
+void nvmf_doca_request_map_prps(struct nvmf_doca_request *request)
+{
+	DOCA_LOG_TRC("Entering function %s", __func__);
+
+	struct nvmf_doca_sq *sq = request->doca_sq;
+	uint64_t prp_entries[2];
+	uint64_t prp1 = request->request.cmd->nvme_cmd.dptr.prp.prp1;
+	uint64_t prp2 = request->request.cmd->nvme_cmd.dptr.prp.prp2;
+	uint32_t length = request->request.length;
+	uint32_t remaining_length;
+	union doca_data user_data;
+
+	/* PRP1 may start with unaligned page address */
+	remaining_length = NVME_PAGE_SIZE - (prp1 % NVME_PAGE_SIZE);
+	remaining_length = spdk_min(length, remaining_length);
+
+	length -= remaining_length;
+
+	if (length <= NVME_PAGE_SIZE) {
+		/* Data is described by PRP1 and, if it crosses exactly one memory page boundary, by PRP2 */
+		prp_entries[0] = prp1;
+		prp_entries[1] = prp2;
+		nvmf_doca_request_map_prp_entries_and_continue(request, prp_entries, length == 0 ? 1 : 2);
+		return;
+	}
+
+	/* PRP list used and PRP2 holds a pointer to it */
+	request->prp_host_buf = nvmf_doca_sq_get_host_buffer(sq, prp2, DMA_POOL_DATA_BUFFER_SIZE);
+	request->prp_dpu_buf = nvmf_doca_sq_get_dpu_buffer(sq);
+
+	user_data.ptr = request;
+	request->residual_length = length;
+	request->doca_cb = nvmf_doca_request_prp_list_ready;
+	request->num_of_buffers = 1;
+
+	sq->io->ops->copy_data(sq,
+			       request->prp_dpu_buf,
+			       request->prp_host_buf,
+			       SPDK_CEIL_DIV(length, NVME_PAGE_SIZE) * sizeof(uint64_t),
+			       user_data);
+}
+
+void nvmf_doca_request_on_copy_nvm_data(struct nvmf_doca_sq *sq,
+					struct doca_buf *dst,
+					struct doca_buf *src,
+					union doca_data user_data)
+{
+	(void)sq;
+	(void)dst;
+	(void)src;
+
+	struct nvmf_doca_request *request = user_data.ptr;
+	request->num_of_buffers--;
+	if (request->num_of_buffers == 0)
+		nvmf_doca_request_complete(request);
+}
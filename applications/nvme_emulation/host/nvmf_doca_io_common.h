@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef NVMF_DOCA_IO_COMMON_H_
+#define NVMF_DOCA_IO_COMMON_H_
+
+#include <stdint.h>
+
+#include <doca_error.h>
+#include <doca_dev.h>
+
+#include "nvmf_doca_io.h"
+
+/*
+ * Helpers shared by every implementation of the NVMf DOCA IO data path, they only depend on the DMA pool and request
+ * pool of the SQ and reach the Host through the nvmf_doca_io_ops of the IO, not through DMA directly
+ */
+
+#define NVME_PAGE_SIZE 4096
+
+/*
+ * Create the local buffers of all DMA pool size classes
+ *
+ * @dev [in]: A doca device that will access the buffers, NULL if buffers are only accessed by the CPU
+ * @num_class_bufs [in]: Number of buffers in each size class, 0 to disable the class
+ * @dma_pool [in]: The DMA pool holding the size classes
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t nvmf_doca_dma_pool_classes_create(struct doca_dev *dev,
+					      const uint32_t num_class_bufs[NVMF_DOCA_DMA_POOL_NUM_CLASSES],
+					      struct nvmf_doca_dma_pool *dma_pool);
+
+/*
+ * Destroy the local buffers of all DMA pool size classes
+ *
+ * @dma_pool [in]: The DMA pool holding the size classes
+ */
+void nvmf_doca_dma_pool_classes_destroy(struct nvmf_doca_dma_pool *dma_pool);
+
+/*
+ * Log the allocation and throughput counters of the DMA pool size classes
+ *
+ * @sq [in]: The SQ owning the DMA pool
+ */
+void nvmf_doca_sq_log_dma_pool_stats(const struct nvmf_doca_sq *sq);
+
+/*
+ * Create the pool of NVMf DOCA requests of the SQ
+ *
+ * @sq [in]: The SQ that holds the requests pool
+ * @num_requests [in]: Number of requests to be allocated
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR_NO_MEMORY when allocation fails
+ */
+doca_error_t nvmf_doca_request_pool_create(struct nvmf_doca_sq *sq, size_t num_requests);
+
+/*
+ * Destroy the pool of NVMf DOCA requests of the SQ
+ *
+ * @sq [in]: The SQ that holds the requests pool
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t nvmf_doca_request_pool_destroy(struct nvmf_doca_sq *sq);
+
+/*
+ * Post the CQE held by the NVMf response of the request through the operations of its IO
+ *
+ * @request [in]: The NVMf request which holds the response
+ * @arg [in]: Argument associated with the callback
+ */
+void nvmf_doca_request_post_cqe(struct nvmf_doca_request *request, void *arg);
+
+/*
+ * Post an error CQE for the request
+ *
+ * @request [in]: The NVMf request
+ */
+void nvmf_doca_request_post_error_cqe(struct nvmf_doca_request *request);
+
+/*
+ * Run the data path of an NVM read or write whose data is described by PRP entries
+ *
+ * Fetches the PRP list from Host if needed and maps the Host pages to size classed DPU buffers. A write copies its
+ * data from Host and then executes, a read executes and then copies its data to Host, both post the CQE at the end.
+ * Copies, CQEs and execution go through the nvmf_doca_io_ops of the IO, so the same flow runs on DMA and on the
+ * loopback. Each completed copy must be reported with nvmf_doca_request_on_copy_nvm_data()
+ *
+ * @request [in]: The NVMf request, request.length must hold the data length of the command
+ */
+void nvmf_doca_request_map_prps(struct nvmf_doca_request *request);
+
+/*
+ * Callback to be invoked once a copy started by the NVM command data path completes
+ *
+ * The source and destination buffers are released once the request is freed
+ *
+ * @sq [in]: The SQ used for the copy operation
+ * @dst [in]: The buffer used as destination in the copy operation
+ * @src [in]: The buffer used as source in the copy operation
+ * @user_data [in]: Same user data previously provided to the copy operation
+ */
+void nvmf_doca_request_on_copy_nvm_data(struct nvmf_doca_sq *sq,
+					struct doca_buf *dst,
+					struct doca_buf *src,
+					union doca_data user_data);
+
+#endif // NVMF_DOCA_IO_COMMON_H_
@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <spdk/env.h>
+#include <spdk/util.h>
+
+#include <doca_log.h>
+
+#include "nvmf_doca_io_common.h"
+#include "nvmf_doca_loopback.h"
+
+DOCA_LOG_REGISTER(NVMF_DOCA_LOOPBACK);
+
+/* Worst case number of operations per SQE: PRP list fetch, one copy per DMA segment and the CQE post */
+#define LOOPBACK_OPS_PER_SQE (NVMF_REQ_MAX_BUFFERS + 2)
+
+/*
+ * Queue an operation to be completed by nvmf_doca_loopback_qp_progress()
+ *
+ * @qp [in]: The QP
+ * @type [in]: The operation type
+ * @user_data [in]: User data to provide on completion
+ * @return: The queued operation to be filled by caller on success and NULL otherwise
+ */
+static struct nvmf_doca_loopback_op *nvmf_doca_loopback_op_push(struct nvmf_doca_loopback_qp *qp,
+								  enum nvmf_doca_loopback_op_type type,
+								  union doca_data user_data)
+{
+	struct nvmf_doca_loopback_op *op;
+	uint32_t num_pending = qp->ops_tail - qp->ops_head;
+
+	if (num_pending == qp->ops_size) {
+		DOCA_LOG_ERR("Failed to queue loopback operation: QP %u has %u pending operations",
+			     qp->sq.sq_id,
+			     num_pending);
+		return NULL;
+	}
+
+	op = &qp->ops[qp->ops_tail % qp->ops_size];
+	op->type = type;
+	op->user_data = user_data;
+	qp->ops_tail++;
+
+	if (num_pending + 1 > qp->stats.max_inflight_ops)
+		qp->stats.max_inflight_ops = num_pending + 1;
+
+	return op;
+}
+
+/*
+ * Queue a fetch of a contiguous run of SQEs
+ *
+ * @qp [in]: The QP
+ * @first_idx [in]: Index of the first SQE in the run
+ * @num_sqes [in]: Number of SQEs in the run, must not cross the end of the queue
+ */
+static void nvmf_doca_loopback_fetch_sqes(struct nvmf_doca_loopback_qp *qp, uint32_t first_idx, uint32_t num_sqes)
+{
+	union doca_data user_data = {.u64 = 0};
+	struct nvmf_doca_loopback_op *op;
+
+	op = nvmf_doca_loopback_op_push(qp, NVMF_DOCA_LOOPBACK_OP_FETCH_SQES, user_data);
+	if (op == NULL)
+		return;
+
+	op->fetch.first_idx = first_idx;
+	op->fetch.num_sqes = num_sqes;
+	qp->stats.num_fetches++;
+}
+
+void nvmf_doca_loopback_qp_ring_sq_db(struct nvmf_doca_loopback_qp *qp, uint32_t db_value)
+{
+	struct nvmf_doca_sq *sq = &qp->sq;
+	uint32_t pi = sq->pi;
+
+	if (db_value == pi)
+		return;
+
+	qp->stats.num_doorbells++;
+	if (db_value > pi) {
+		nvmf_doca_loopback_fetch_sqes(qp, pi, db_value - pi);
+	} else {
+		nvmf_doca_loopback_fetch_sqes(qp, pi, qp->depth - pi);
+		if (db_value != 0)
+			nvmf_doca_loopback_fetch_sqes(qp, 0, db_value);
+	}
+
+	sq->pi = db_value;
+}
+
+void nvmf_doca_loopback_qp_ring_cq_db(struct nvmf_doca_loopback_qp *qp, uint32_t db_value)
+{
+	qp->io.cq.ci = db_value;
+}
+
+void nvmf_doca_loopback_sq_copy_data(struct nvmf_doca_sq *sq,
+				     struct doca_buf *dst_buffer,
+				     struct doca_buf *src_buffer,
+				     size_t length,
+				     union doca_data user_data)
+{
+	struct nvmf_doca_loopback_qp *qp = SPDK_CONTAINEROF(sq, struct nvmf_doca_loopback_qp, sq);
+	struct nvmf_doca_loopback_op *op;
+
+	doca_buf_reset_data_len(dst_buffer);
+	doca_buf_set_data_len(src_buffer, length);
+
+	op = nvmf_doca_loopback_op_push(qp, NVMF_DOCA_LOOPBACK_OP_COPY_DATA, user_data);
+	if (op == NULL)
+		return;
+
+	op->copy.dst = dst_buffer;
+	op->copy.src = src_buffer;
+	op->copy.length = length;
+}
+
+void nvmf_doca_loopback_io_post_cqe(struct nvmf_doca_io *io,
+				    const struct nvmf_doca_cqe *cqe,
+				    union doca_data user_data)
+{
+	struct nvmf_doca_loopback_qp *qp = SPDK_CONTAINEROF(io, struct nvmf_doca_loopback_qp, io);
+	struct nvmf_doca_cq *cq = &io->cq;
+	struct nvmf_doca_loopback_op *op;
+
+	op = nvmf_doca_loopback_op_push(qp, NVMF_DOCA_LOOPBACK_OP_POST_CQE, user_data);
+	if (op == NULL)
+		return;
+
+	op->post.cqe_idx = cq->pi % qp->depth;
+	op->post.cqe = *cqe;
+
+	/**
+	 * Update the phase bit according to the iteration
+	 * For every even iteration the phase should be 1, while for odd should be 0
+	 */
+	((struct spdk_nvme_cpl *)&op->post.cqe)->status.p = !((cq->pi / qp->depth) % 2);
+
+	cq->pi++;
+}
+
+/*
+ * Complete a single operation and invoke its callback
+ *
+ * @qp [in]: The QP
+ * @op [in]: The operation, a copy that stays valid even if the callback queues new operations
+ */
+static void nvmf_doca_loopback_op_complete(struct nvmf_doca_loopback_qp *qp, const struct nvmf_doca_loopback_op *op)
+{
+	struct nvmf_doca_io *io = &qp->io;
+	void *src_address;
+	void *dst_address;
+	uint64_t start_ticks = spdk_get_ticks();
+
+	switch (op->type) {
+	case NVMF_DOCA_LOOPBACK_OP_FETCH_SQES:
+		memcpy(&qp->local_sqes[op->fetch.first_idx],
+		       &qp->host_sq[op->fetch.first_idx],
+		       op->fetch.num_sqes * sizeof(struct nvmf_doca_sqe));
+		qp->stats.num_sqes += op->fetch.num_sqes;
+		qp->stats.fetch_ticks += spdk_get_ticks() - start_ticks;
+
+		for (uint32_t idx = 0; idx < op->fetch.num_sqes; idx++) {
+			uint32_t sqe_idx = op->fetch.first_idx + idx;
+
+			io->fetch_sqe_cb(&qp->sq, &qp->local_sqes[sqe_idx], sqe_idx);
+		}
+		break;
+	case NVMF_DOCA_LOOPBACK_OP_COPY_DATA:
+		doca_buf_get_data(op->copy.src, &src_address);
+		doca_buf_get_data(op->copy.dst, &dst_address);
+		memcpy(dst_address, src_address, op->copy.length);
+		doca_buf_set_data_len(op->copy.dst, op->copy.length);
+		qp->stats.num_copies++;
+		qp->stats.copy_bytes += op->copy.length;
+		qp->stats.copy_ticks += spdk_get_ticks() - start_ticks;
+
+		io->copy_data_cb(&qp->sq, op->copy.dst, op->copy.src, op->user_data);
+		break;
+	case NVMF_DOCA_LOOPBACK_OP_POST_CQE:
+		qp->host_cq[op->post.cqe_idx] = op->post.cqe;
+		qp->msix_pending = true;
+		qp->stats.num_cqes++;
+		qp->stats.post_ticks += spdk_get_ticks() - start_ticks;
+
+		io->post_cqe_cb(&io->cq, op->user_data);
+		break;
+	default:
+		DOCA_LOG_ERR("Unknown loopback operation type %d", op->type);
+		break;
+	}
+}
+
+uint32_t nvmf_doca_loopback_qp_progress(struct nvmf_doca_loopback_qp *qp, uint32_t max_ops)
+{
+	struct nvmf_doca_loopback_op op;
+	uint32_t num_completed = 0;
+
+	while (num_completed < max_ops && qp->ops_head != qp->ops_tail) {
+		op = qp->ops[qp->ops_head % qp->ops_size];
+		qp->ops_head++;
+		nvmf_doca_loopback_op_complete(qp, &op);
+		num_completed++;
+	}
+
+	if (qp->msix_pending && qp->enable_msix) {
+		uint64_t start_ticks = spdk_get_ticks();
+
+		qp->msix_pending = false;
+		qp->stats.num_msix++;
+		qp->msix_cb(qp);
+		qp->stats.post_ticks += spdk_get_ticks() - start_ticks;
+	}
+
+	return num_completed;
+}
+
+uint32_t nvmf_doca_loopback_qp_num_pending(const struct nvmf_doca_loopback_qp *qp)
+{
+	return qp->ops_tail - qp->ops_head;
+}
+
+/*
+ * Create the mmap through which Host memory is accessed
+ *
+ * @attr [in]: The QP create attributes
+ * @qp [in]: The QP
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t nvmf_doca_loopback_host_mmap_create(const struct nvmf_doca_loopback_qp_create_attr *attr,
+							struct nvmf_doca_loopback_qp *qp)
+{
+	doca_error_t result;
+
+	result = doca_mmap_create(&qp->host_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to create Host mmap - %s", doca_error_get_name(result));
+		return result;
+	}
+	result = doca_mmap_set_memrange(qp->host_mmap, attr->host_memory, attr->host_memory_size);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to set Host mmap memory range - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	result = doca_mmap_set_permissions(qp->host_mmap, DOCA_ACCESS_FLAG_LOCAL_READ_WRITE);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to set Host mmap permissions - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	result = doca_mmap_start(qp->host_mmap);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to start Host mmap - %s", doca_error_get_name(result));
+		return result;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Create the DMA pool of the SQ, the DMA context is not needed since copies are done by the CPU
+ *
+ * @attr [in]: The QP create attributes
+ * @qp [in]: The QP
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t nvmf_doca_loopback_dma_pool_create(const struct nvmf_doca_loopback_qp_create_attr *attr,
+						       struct nvmf_doca_loopback_qp *qp)
+{
+	struct nvmf_doca_dma_pool *dma_pool = &qp->sq.dma_pool;
+	const uint32_t max_dma_operations = attr->depth * NVMF_REQ_MAX_BUFFERS;
+	const uint32_t num_class_bufs[NVMF_DOCA_DMA_POOL_NUM_CLASSES] = {
+		[NVMF_DOCA_DMA_POOL_CLASS_4K] = max_dma_operations,
+		[NVMF_DOCA_DMA_POOL_CLASS_64K] = attr->dma_pool_64k_bufs,
+		[NVMF_DOCA_DMA_POOL_CLASS_1M] = attr->dma_pool_1m_bufs,
+	};
+	doca_error_t result;
+
+	dma_pool->start_ticks = spdk_get_ticks();
+
+	result = nvmf_doca_dma_pool_classes_create(NULL, num_class_bufs, dma_pool);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = doca_buf_inventory_create(max_dma_operations, &dma_pool->local_view_inventory);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to create local view inventory - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	result = doca_buf_inventory_start(dma_pool->local_view_inventory);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to start local view inventory - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+
+	result = doca_buf_inventory_create(max_dma_operations, &dma_pool->host_data_inventory);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to create Host data inventory - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	result = doca_buf_inventory_start(dma_pool->host_data_inventory);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to start Host data inventory - %s",
+			     doca_error_get_name(result));
+		return result;
+	}
+	dma_pool->host_data_mmap = qp->host_mmap;
+
+	return DOCA_SUCCESS;
+}
+
+doca_error_t nvmf_doca_loopback_qp_create(const struct nvmf_doca_loopback_qp_create_attr *attr,
+					  struct nvmf_doca_loopback_qp *qp)
+{
+	struct nvmf_doca_io *io = &qp->io;
+	struct nvmf_doca_sq *sq = &qp->sq;
+	doca_error_t result;
+
+	memset(qp, 0, sizeof(*qp));
+	qp->depth = attr->depth;
+	qp->host_sq = (struct nvmf_doca_sqe *)attr->host_sq_address;
+	qp->host_cq = (struct nvmf_doca_cqe *)attr->host_cq_address;
+	qp->enable_msix = attr->enable_msix;
+	qp->msix_cb = attr->msix_cb;
+
+	qp->local_sqes = calloc(attr->depth, sizeof(*qp->local_sqes));
+	qp->ops_size = attr->depth * LOOPBACK_OPS_PER_SQE;
+	qp->ops = calloc(qp->ops_size, sizeof(*qp->ops));
+	if (qp->local_sqes == NULL || qp->ops == NULL) {
+		DOCA_LOG_ERR("Failed to create loopback QP: Failed to allocate memory for local SQ and operations");
+		nvmf_doca_loopback_qp_destroy(qp);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	result = nvmf_doca_loopback_host_mmap_create(attr, qp);
+	if (result != DOCA_SUCCESS) {
+		nvmf_doca_loopback_qp_destroy(qp);
+		return result;
+	}
+
+	result = nvmf_doca_request_pool_create(sq, attr->depth);
+	if (result != DOCA_SUCCESS) {
+		nvmf_doca_loopback_qp_destroy(qp);
+		return result;
+	}
+
+	result = nvmf_doca_loopback_dma_pool_create(attr, qp);
+	if (result != DOCA_SUCCESS) {
+		nvmf_doca_loopback_qp_destroy(qp);
+		return result;
+	}
+
+	io->cq.cq_id = attr->qid;
+	io->cq.io = io;
+	io->cq.queue.num_elements = attr->depth;
+	io->post_cqe_cb = attr->post_cqe_cb;
+	io->fetch_sqe_cb = attr->fetch_sqe_cb;
+	io->copy_data_cb = attr->copy_data_cb;
+	io->ctx = attr->ctx;
+	qp->io_ops.copy_data = nvmf_doca_loopback_sq_copy_data;
+	qp->io_ops.post_cqe = nvmf_doca_loopback_io_post_cqe;
+	qp->io_ops.exec = attr->exec;
+	io->ops = &qp->io_ops;
+	TAILQ_INIT(&io->sq_list);
+	TAILQ_INSERT_TAIL(&io->sq_list, sq, link);
+
+	sq->io = io;
+	sq->sq_id = attr->qid;
+	sq->spdk_qp.qid = attr->qid;
+	sq->ctx = attr->ctx;
+	sq->state = NVMF_DOCA_SQ_STATE_READY;
+	sq->result = DOCA_SUCCESS;
+
+	return DOCA_SUCCESS;
+}
+
+void nvmf_doca_loopback_qp_destroy(struct nvmf_doca_loopback_qp *qp)
+{
+	struct nvmf_doca_dma_pool *dma_pool = &qp->sq.dma_pool;
+	doca_error_t result;
+
+	if (dma_pool->host_data_inventory != NULL) {
+		result = doca_buf_inventory_destroy(dma_pool->host_data_inventory);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy loopback QP: Failed to destroy Host data inventory %s",
+				     doca_error_get_name(result));
+		dma_pool->host_data_inventory = NULL;
+	}
+	if (dma_pool->local_view_inventory != NULL) {
+		result = doca_buf_inventory_destroy(dma_pool->local_view_inventory);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy loopback QP: Failed to destroy local view inventory %s",
+				     doca_error_get_name(result));
+		dma_pool->local_view_inventory = NULL;
+	}
+	dma_pool->host_data_mmap = NULL;
+	nvmf_doca_dma_pool_classes_destroy(dma_pool);
+
+	nvmf_doca_request_pool_destroy(&qp->sq);
+
+	if (qp->host_mmap != NULL) {
+		result = doca_mmap_destroy(qp->host_mmap);
+		if (result != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to destroy loopback QP: Failed to destroy Host mmap %s",
+				     doca_error_get_name(result));
+		qp->host_mmap = NULL;
+	}
+
+	free(qp->ops);
+	qp->ops = NULL;
+	free(qp->local_sqes);
+	qp->local_sqes = NULL;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef NVMF_DOCA_LOOPBACK_H_
+#define NVMF_DOCA_LOOPBACK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <doca_error.h>
+#include <doca_buf.h>
+#include <doca_mmap.h>
+
+#include "nvmf_doca_io.h"
+
+/*
+ * Software loopback of the NVMf DOCA IO data path
+ *
+ * Stands in for the DPA thread, the emulated DBs, the DMA contexts and the MSI-X of nvmf_doca_io, so that the data
+ * path on top of it can be exercised and profiled on any CPU. Host memory is a region of the local process and Host
+ * I/O addresses are plain virtual addresses inside of it. Every operation completes asynchronously from
+ * nvmf_doca_loopback_qp_progress() in submission order, and invokes the same callbacks nvmf_doca_io would. The IO of
+ * the QP carries nvmf_doca_io_ops, so the NVM command data path of nvmf_doca_io_common runs unchanged on top of it
+ */
+
+struct nvmf_doca_loopback_qp;
+
+typedef void (*nvmf_doca_loopback_msix_cb)(struct nvmf_doca_loopback_qp *qp);
+
+enum nvmf_doca_loopback_op_type {
+	NVMF_DOCA_LOOPBACK_OP_FETCH_SQES,
+	NVMF_DOCA_LOOPBACK_OP_COPY_DATA,
+	NVMF_DOCA_LOOPBACK_OP_POST_CQE,
+};
+
+struct nvmf_doca_loopback_op {
+	enum nvmf_doca_loopback_op_type type; /**< The operation that stands in for a DMA task */
+	union doca_data user_data;	      /**< User data to provide on completion */
+	union {
+		struct {
+			uint32_t first_idx; /**< Index of first SQE in the run */
+			uint32_t num_sqes;  /**< Number of SQEs in the run, never crosses the end of the queue */
+		} fetch;
+		struct {
+			struct doca_buf *dst; /**< The destination buffer */
+			struct doca_buf *src; /**< The source buffer */
+			size_t length;	      /**< The copy length */
+		} copy;
+		struct {
+			uint32_t cqe_idx;	  /**< Index in the Host CQ to write to */
+			struct nvmf_doca_cqe cqe; /**< Contents of the CQE including the phase bit */
+		} post;
+	};
+};
+
+struct nvmf_doca_loopback_stats {
+	uint64_t num_doorbells;	   /**< Number of SQ DBs that advanced the producer index */
+	uint64_t num_fetches;	   /**< Number of SQE fetch operations, at most two per DB */
+	uint64_t num_sqes;	   /**< Number of SQEs fetched from Host */
+	uint64_t num_copies;	   /**< Number of data copy operations */
+	uint64_t copy_bytes;	   /**< Number of bytes copied between Host and DPU buffers */
+	uint64_t num_cqes;	   /**< Number of CQEs posted to Host */
+	uint64_t num_msix;	   /**< Number of MSI-X raised towards Host */
+	uint64_t fetch_ticks;	   /**< Ticks spent copying SQEs, excluding the callbacks */
+	uint64_t copy_ticks;	   /**< Ticks spent copying data, excluding the callbacks */
+	uint64_t post_ticks;	   /**< Ticks spent writing CQEs and raising MSI-X, excluding the callbacks */
+	uint32_t max_inflight_ops; /**< High watermark of pending operations */
+};
+
+struct nvmf_doca_loopback_qp {
+	struct nvmf_doca_io io;		       /**< Holds the callbacks and the CQ indexes */
+	struct nvmf_doca_io_ops io_ops;	       /**< Loopback copy and CQE post, used by the NVM command data path */
+	struct nvmf_doca_sq sq;		       /**< The SQ, including its DMA pool and request pool */
+	struct nvmf_doca_sqe *host_sq;	       /**< The Host SQ ring */
+	struct nvmf_doca_cqe *host_cq;	       /**< The Host CQ ring */
+	struct nvmf_doca_sqe *local_sqes;      /**< Local copy of the SQ ring, where fetched SQEs land */
+	uint16_t depth;			       /**< Number of elements in each of the rings */
+	struct doca_mmap *host_mmap;	       /**< mmap covering the Host memory */
+	struct nvmf_doca_loopback_op *ops;     /**< Ring of pending operations */
+	uint32_t ops_size;		       /**< Number of elements in the ring of pending operations */
+	uint32_t ops_head;		       /**< Index of the oldest pending operation */
+	uint32_t ops_tail;		       /**< Index where the next operation is queued */
+	bool enable_msix;		       /**< Whether to raise MSI-X after posting CQEs */
+	bool msix_pending;		       /**< A CQE was posted since the last MSI-X */
+	nvmf_doca_loopback_msix_cb msix_cb;    /**< Stand-in for the MSI-X, invoked once per progress */
+	struct nvmf_doca_loopback_stats stats; /**< Per stand-in operation counters */
+};
+
+struct nvmf_doca_loopback_qp_create_attr {
+	uint32_t qid;				/**< The NVMe ID of the SQ and CQ */
+	uint16_t depth;				/**< The size of the SQ and CQ */
+	void *host_memory;			/**< Host memory holding the rings, PRP lists and data pages */
+	size_t host_memory_size;		/**< Size of the Host memory */
+	uintptr_t host_sq_address;		/**< Address of the SQ inside the Host memory */
+	uintptr_t host_cq_address;		/**< Address of the CQ inside the Host memory */
+	uint32_t dma_pool_64k_bufs;		/**< Number of 64KiB DPU data buffers, 0 to disable the class */
+	uint32_t dma_pool_1m_bufs;		/**< Number of 1MiB DPU data buffers, 0 to disable the class */
+	bool enable_msix;			/**< Whether to raise MSI-X after posting CQEs */
+	nvmf_doca_cq_post_cqe_cb post_cqe_cb;	/**< Callback invoked once a CQE is posted to Host */
+	nvmf_doca_sq_fetch_sqe_cb fetch_sqe_cb; /**< Callback invoked once a SQE is fetched from host */
+	nvmf_doca_sq_copy_data_cb copy_data_cb; /**< Callback invoked once data copy operation completes */
+	nvmf_doca_loopback_msix_cb msix_cb;	/**< Callback invoked once MSI-X is raised */
+	nvmf_doca_io_exec_fn exec;		/**< Executes NVM commands in place of the NVMf target */
+	void *ctx;				/**< Opaque structure that can be set by user */
+};
+
+/*
+ * Create a loopback QP made of one SQ and the CQ it completes to
+ *
+ * @attr [in]: The QP create attributes
+ * @qp [in]: The QP to be initialized
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t nvmf_doca_loopback_qp_create(const struct nvmf_doca_loopback_qp_create_attr *attr,
+					  struct nvmf_doca_loopback_qp *qp);
+
+/*
+ * Destroy a loopback QP
+ *
+ * All requests must have been freed and no operations may be pending
+ *
+ * @qp [in]: The QP to destroy
+ */
+void nvmf_doca_loopback_qp_destroy(struct nvmf_doca_loopback_qp *qp);
+
+/*
+ * Stand-in for a Host write to the SQ tail DB
+ *
+ * Queues one fetch of the new SQEs, or two in case they wrap around the end of the SQ
+ *
+ * @qp [in]: The QP
+ * @db_value [in]: The new SQ tail
+ */
+void nvmf_doca_loopback_qp_ring_sq_db(struct nvmf_doca_loopback_qp *qp, uint32_t db_value);
+
+/*
+ * Stand-in for a Host write to the CQ head DB
+ *
+ * @qp [in]: The QP
+ * @db_value [in]: The new CQ head
+ */
+void nvmf_doca_loopback_qp_ring_cq_db(struct nvmf_doca_loopback_qp *qp, uint32_t db_value);
+
+/*
+ * Copy data between Host and DPU, same semantics as nvmf_doca_sq_copy_data()
+ *
+ * @sq [in]: The SQ of the loopback QP
+ * @dst_buffer [in]: The destination buffer
+ * @src_buffer [in]: The source buffer
+ * @length [in]: The copy operation length
+ * @user_data [in]: User data to associate with the operation, same data will be available on completion of the copy
+ */
+void nvmf_doca_loopback_sq_copy_data(struct nvmf_doca_sq *sq,
+				     struct doca_buf *dst_buffer,
+				     struct doca_buf *src_buffer,
+				     size_t length,
+				     union doca_data user_data);
+
+/*
+ * Post a CQE to the Host CQ, same semantics as nvmf_doca_io_post_cqe()
+ *
+ * @io [in]: The IO of the loopback QP
+ * @cqe [in]: Contents of the CQE
+ * @user_data [in]: User data to associate with the operation, same data will be available on completion
+ */
+void nvmf_doca_loopback_io_post_cqe(struct nvmf_doca_io *io,
+				    const struct nvmf_doca_cqe *cqe,
+				    union doca_data user_data);
+
+/*
+ * Complete pending operations in submission order, invoking their callbacks
+ *
+ * Operations queued by the callbacks are completed by the same call as long as the budget allows
+ *
+ * @qp [in]: The QP
+ * @max_ops [in]: Maximal number of operations to complete
+ * @return: Number of completed operations
+ */
+uint32_t nvmf_doca_loopback_qp_progress(struct nvmf_doca_loopback_qp *qp, uint32_t max_ops);
+
+/*
+ * Get the number of operations that were queued and did not complete yet
+ *
+ * @qp [in]: The QP
+ * @return: Number of pending operations
+ */
+uint32_t nvmf_doca_loopback_qp_num_pending(const struct nvmf_doca_loopback_qp *qp);
+
+#endif // NVMF_DOCA_LOOPBACK_H_
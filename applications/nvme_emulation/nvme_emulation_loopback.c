@@ -0,0 +1,850 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "spdk/stdinc.h"
+
+#include "spdk/env.h"
+#include "spdk/event.h"
+#include "spdk/string.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+#include <doca_log.h>
+
+#include "host/nvme_host_sim.h"
+#include "host/nvmf_doca_io_common.h"
+#include "host/nvmf_doca_loopback.h"
+
+DOCA_LOG_REGISTER(NVME_EMULATION_LOOPBACK);
+
+/*
+ * NVMe emulation loopback benchmark
+ *
+ * Runs the NVM command data path of the DOCA transport against an in-process NVMe Host, replacing the emulated PCI
+ * device, DPA and DMA with the software loopback of nvmf_doca_loopback, and the bdev layer with a RAM disk. One
+ * SPDK thread is created for each core of the application core mask, each driving its own set of queues, so that
+ * per-layer CPU cost and IOPS scaling can be measured without a BlueField
+ */
+
+#define LOOPBACK_BENCH_PROGRESS_BUDGET 256 /* Max loopback operations completed per queue per poll */
+
+enum loopback_bench_opt {
+	LOOPBACK_BENCH_OPT_IO_SIZE = 0x1000,
+	LOOPBACK_BENCH_OPT_IO_DEPTH,
+	LOOPBACK_BENCH_OPT_QUEUE_DEPTH,
+	LOOPBACK_BENCH_OPT_BATCH_SIZE,
+	LOOPBACK_BENCH_OPT_NUM_QUEUES,
+	LOOPBACK_BENCH_OPT_READ_PERCENTAGE,
+	LOOPBACK_BENCH_OPT_PRP1_OFFSET,
+	LOOPBACK_BENCH_OPT_SCATTER,
+	LOOPBACK_BENCH_OPT_MSIX,
+	LOOPBACK_BENCH_OPT_DURATION,
+	LOOPBACK_BENCH_OPT_RAMDISK_MB,
+	LOOPBACK_BENCH_OPT_DMA_POOL_64K_BUFS,
+	LOOPBACK_BENCH_OPT_DMA_POOL_1M_BUFS,
+};
+
+static const struct option loopback_bench_long_opts[] = {
+	{"io-size", required_argument, NULL, LOOPBACK_BENCH_OPT_IO_SIZE},
+	{"io-depth", required_argument, NULL, LOOPBACK_BENCH_OPT_IO_DEPTH},
+	{"queue-depth", required_argument, NULL, LOOPBACK_BENCH_OPT_QUEUE_DEPTH},
+	{"batch-size", required_argument, NULL, LOOPBACK_BENCH_OPT_BATCH_SIZE},
+	{"num-queues", required_argument, NULL, LOOPBACK_BENCH_OPT_NUM_QUEUES},
+	{"read-percentage", required_argument, NULL, LOOPBACK_BENCH_OPT_READ_PERCENTAGE},
+	{"prp1-offset", required_argument, NULL, LOOPBACK_BENCH_OPT_PRP1_OFFSET},
+	{"scatter", no_argument, NULL, LOOPBACK_BENCH_OPT_SCATTER},
+	{"msix", no_argument, NULL, LOOPBACK_BENCH_OPT_MSIX},
+	{"duration", required_argument, NULL, LOOPBACK_BENCH_OPT_DURATION},
+	{"ramdisk-mb", required_argument, NULL, LOOPBACK_BENCH_OPT_RAMDISK_MB},
+	{"dma-pool-64k-bufs", required_argument, NULL, LOOPBACK_BENCH_OPT_DMA_POOL_64K_BUFS},
+	{"dma-pool-1m-bufs", required_argument, NULL, LOOPBACK_BENCH_OPT_DMA_POOL_1M_BUFS},
+	{NULL, 0, NULL, 0},
+};
+
+struct loopback_bench_cfg {
+	uint32_t io_size;	    /**< Data length of each command */
+	uint32_t io_depth;	    /**< Outstanding commands per queue */
+	uint32_t queue_depth;	    /**< Number of elements in each SQ and CQ */
+	uint32_t batch_size;	    /**< Maximal number of SQEs per SQ DB */
+	uint32_t num_queues;	    /**< Number of queues per worker */
+	uint32_t read_percentage;   /**< Percentage of read commands */
+	uint32_t prp1_offset;	    /**< Offset of the data inside the first page */
+	bool scatter_pages;	    /**< Whether data pages of a command are scattered in Host memory */
+	bool msix;		    /**< Reap completions only after MSI-X instead of polling the CQ */
+	uint32_t duration_sec;	    /**< Measurement duration */
+	uint32_t ramdisk_mb;	    /**< Size of the RAM disk of each worker */
+	uint32_t dma_pool_64k_bufs; /**< Number of 64KiB DPU data buffers per queue */
+	uint32_t dma_pool_1m_bufs;  /**< Number of 1MiB DPU data buffers per queue */
+};
+
+static struct loopback_bench_cfg bench_cfg = {
+	.io_size = 4096,
+	.io_depth = 32,
+	.queue_depth = 128,
+	.batch_size = 8,
+	.num_queues = 1,
+	.read_percentage = 50,
+	.prp1_offset = 0,
+	.scatter_pages = false,
+	.msix = false,
+	.duration_sec = 10,
+	.ramdisk_mb = 64,
+	.dma_pool_64k_bufs = 16,
+	.dma_pool_1m_bufs = 0,
+};
+
+enum loopback_bench_layer {
+	LOOPBACK_BENCH_LAYER_HOST,    /* Host simulator building SQEs and reaping CQEs */
+	LOOPBACK_BENCH_LAYER_FETCH,   /* SQE fetch stand-in */
+	LOOPBACK_BENCH_LAYER_MAP,     /* Request setup and DPU buffer mapping once the SQE is fetched */
+	LOOPBACK_BENCH_LAYER_DMA,     /* Data copy stand-in */
+	LOOPBACK_BENCH_LAYER_BACKEND, /* RAM disk */
+	LOOPBACK_BENCH_LAYER_CQE,     /* CQE post and MSI-X stand-in */
+	LOOPBACK_BENCH_LAYER_RELEASE, /* Release of the request and its buffers */
+	LOOPBACK_BENCH_LAYER_OTHER,   /* Callback dispatch, PRP list mapping and polling overhead */
+	LOOPBACK_BENCH_NUM_LAYERS,
+};
+
+static const char *const loopback_bench_layer_names[LOOPBACK_BENCH_NUM_LAYERS] = {
+	[LOOPBACK_BENCH_LAYER_HOST] = "host",
+	[LOOPBACK_BENCH_LAYER_FETCH] = "fetch",
+	[LOOPBACK_BENCH_LAYER_MAP] = "map",
+	[LOOPBACK_BENCH_LAYER_DMA] = "dma",
+	[LOOPBACK_BENCH_LAYER_BACKEND] = "backend",
+	[LOOPBACK_BENCH_LAYER_CQE] = "cqe",
+	[LOOPBACK_BENCH_LAYER_RELEASE] = "release",
+	[LOOPBACK_BENCH_LAYER_OTHER] = "other",
+};
+
+struct loopback_bench_worker;
+
+struct loopback_bench_queue {
+	struct nvme_host_sim host;	      /**< The NVMe Host driving the queue */
+	struct nvmf_doca_loopback_qp qp;      /**< The loopback SQ and CQ */
+	struct loopback_bench_worker *worker; /**< The worker polling the queue */
+	bool host_created;		      /**< Whether host was created */
+	bool qp_created;		      /**< Whether qp was created */
+	bool msix_pending;		      /**< An MSI-X was raised since the Host last reaped the CQ */
+};
+
+struct loopback_bench_worker {
+	uint32_t core;					 /**< The core the worker runs on */
+	struct spdk_thread *thread;			 /**< The SPDK thread of the worker */
+	struct spdk_poller *poller;			 /**< Poller driving Host and target */
+	struct loopback_bench_queue *queues;		 /**< The queues of the worker */
+	uint8_t *ramdisk;				 /**< Backing store of the namespace */
+	uint64_t ramdisk_size;				 /**< Size of the backing store */
+	doca_error_t result;				 /**< Error in case worker failed to start */
+	bool stopping;					 /**< Host stopped submitting, draining */
+	uint64_t start_ticks;				 /**< Time measurement started */
+	uint64_t stop_ticks;				 /**< Time measurement stopped */
+	uint64_t ios_at_stop;				 /**< Number of completed commands at stop */
+	uint64_t poll_ticks;				 /**< Total ticks spent in the poller */
+	uint64_t layer_ticks[LOOPBACK_BENCH_NUM_LAYERS]; /**< Ticks spent in each layer */
+	struct nvme_host_sim_stats host_stats;		 /**< Host counters of all queues */
+	struct nvmf_doca_loopback_stats loopback_stats;	 /**< Loopback counters of all queues */
+	TAILQ_ENTRY(loopback_bench_worker) link;	 /**< Link to next worker */
+};
+
+static TAILQ_HEAD(, loopback_bench_worker) bench_workers = TAILQ_HEAD_INITIALIZER(bench_workers);
+static struct spdk_thread *bench_app_thread;
+static struct spdk_poller *bench_timer;
+static uint32_t bench_num_running_workers;
+static int bench_rc;
+
+/*********************************************************************************************************************
+ * Target data path, runs the NVM command flow of the DOCA transport with a RAM disk instead of the bdev layer
+ *********************************************************************************************************************/
+
+/*
+ * Execute the NVM command against the RAM disk, stands in for spdk_nvmf_request_exec()
+ *
+ * @request [in]: The request, its IOVs hold the data
+ */
+static void loopback_bench_execute(struct nvmf_doca_request *request)
+{
+	struct loopback_bench_queue *queue = request->doca_sq->ctx;
+	struct loopback_bench_worker *worker = queue->worker;
+	const struct spdk_nvme_cmd *cmd = &request->request.cmd->nvme_cmd;
+	uint64_t start_ticks = spdk_get_ticks();
+	uint64_t offset = (((uint64_t)cmd->cdw11 << 32) | cmd->cdw10) * NVME_HOST_SIM_LBA_SIZE;
+	bool is_write = cmd->opc == SPDK_NVME_OPC_WRITE;
+
+	/* Completion of the NVMf target fills the CID of the response */
+	request->request.rsp->nvme_cpl.cid = cmd->cid;
+
+	if (offset + request->request.length > worker->ramdisk_size) {
+		request->request.rsp->nvme_cpl.status.sc = SPDK_NVME_SC_LBA_OUT_OF_RANGE;
+	} else {
+		for (uint32_t idx = 0; idx < request->request.iovcnt; idx++) {
+			struct iovec *iov = &request->request.iov[idx];
+
+			if (is_write)
+				memcpy(worker->ramdisk + offset, iov->iov_base, iov->iov_len);
+			else
+				memcpy(iov->iov_base, worker->ramdisk + offset, iov->iov_len);
+			offset += iov->iov_len;
+		}
+	}
+	worker->layer_ticks[LOOPBACK_BENCH_LAYER_BACKEND] += spdk_get_ticks() - start_ticks;
+
+	nvmf_doca_request_complete(request);
+}
+
+/*
+ * Callback invoked once an SQE has been fetched from the Host SQ
+ *
+ * @sq [in]: The SQ used for the fetch operation
+ * @sqe [in]: The SQE that was fetched from Host
+ * @sqe_idx [in]: The SQE index
+ */
+static void loopback_bench_on_fetch_sqe(struct nvmf_doca_sq *sq, struct nvmf_doca_sqe *sqe, uint16_t sqe_idx)
+{
+	struct loopback_bench_queue *queue = sq->ctx;
+	struct loopback_bench_worker *worker = queue->worker;
+	uint64_t start_ticks = spdk_get_ticks();
+	uint64_t backend_ticks = worker->layer_ticks[LOOPBACK_BENCH_LAYER_BACKEND];
+	struct spdk_nvme_cmd *cmd = (struct spdk_nvme_cmd *)&sqe->data[0];
+	struct nvmf_doca_request *request = nvmf_doca_request_get(sq);
+
+	if (request == NULL) {
+		DOCA_LOG_ERR("Queue %u: No free request for SQE %u", sq->sq_id, sqe_idx);
+		return;
+	}
+
+	request->request.cmd = (union nvmf_h2c_msg *)cmd;
+	request->doca_sq = sq;
+	request->sqe_idx = sqe_idx;
+
+	if (cmd->opc != SPDK_NVME_OPC_READ && cmd->opc != SPDK_NVME_OPC_WRITE) {
+		request->request.rsp->nvme_cpl.cid = cmd->cid;
+		request->request.rsp->nvme_cpl.status.sc = SPDK_NVME_SC_INVALID_OPCODE;
+		worker->layer_ticks[LOOPBACK_BENCH_LAYER_MAP] += spdk_get_ticks() - start_ticks;
+		nvmf_doca_request_post_cqe(request, NULL);
+		return;
+	}
+
+	/* Same flow as the DOCA transport, a read also executes from here when it needs no PRP list */
+	request->request.length = ((cmd->cdw12 & UINT16_MAX) + 1) * NVME_HOST_SIM_LBA_SIZE;
+	nvmf_doca_request_map_prps(request);
+
+	backend_ticks = worker->layer_ticks[LOOPBACK_BENCH_LAYER_BACKEND] - backend_ticks;
+	worker->layer_ticks[LOOPBACK_BENCH_LAYER_MAP] += spdk_get_ticks() - start_ticks - backend_ticks;
+}
+
+/*
+ * Callback invoked once a CQE has been posted to the Host CQ
+ *
+ * @cq [in]: The CQ used for the post operation
+ * @user_data [in]: Same user data previously provided in nvmf_doca_loopback_io_post_cqe()
+ */
+static void loopback_bench_on_post_cqe(struct nvmf_doca_cq *cq, union doca_data user_data)
+{
+	struct loopback_bench_queue *queue = cq->io->ctx;
+	uint64_t start_ticks = spdk_get_ticks();
+
+	nvmf_doca_request_free(user_data.ptr);
+	queue->worker->layer_ticks[LOOPBACK_BENCH_LAYER_RELEASE] += spdk_get_ticks() - start_ticks;
+}
+
+/*
+ * Callback invoked once an MSI-X is raised towards the Host
+ *
+ * @qp [in]: The loopback QP that raised the MSI-X
+ */
+static void loopback_bench_on_msix(struct nvmf_doca_loopback_qp *qp)
+{
+	struct loopback_bench_queue *queue = qp->io.ctx;
+
+	queue->msix_pending = true;
+}
+
+/*********************************************************************************************************************
+ * Workers
+ *********************************************************************************************************************/
+
+/*
+ * Destroy the queues and RAM disk of a worker
+ *
+ * @worker [in]: The worker
+ */
+static void loopback_bench_worker_cleanup(struct loopback_bench_worker *worker)
+{
+	if (worker->queues != NULL) {
+		for (uint32_t idx = 0; idx < bench_cfg.num_queues; idx++) {
+			struct loopback_bench_queue *queue = &worker->queues[idx];
+
+			if (queue->qp_created)
+				nvmf_doca_loopback_qp_destroy(&queue->qp);
+			if (queue->host_created)
+				nvme_host_sim_destroy(&queue->host);
+		}
+		free(worker->queues);
+		worker->queues = NULL;
+	}
+
+	free(worker->ramdisk);
+	worker->ramdisk = NULL;
+}
+
+/*
+ * Report the results of all workers and stop the application
+ */
+static void loopback_bench_report(void)
+{
+	struct loopback_bench_worker *worker;
+	double total_iops = 0;
+	double total_mibps = 0;
+	uint32_t num_workers = 0;
+	uint64_t ticks_hz = spdk_get_ticks_hz();
+
+	TAILQ_FOREACH(worker, &bench_workers, link)
+	{
+		const struct nvme_host_sim_stats *host_stats = &worker->host_stats;
+		const struct nvmf_doca_loopback_stats *lb_stats = &worker->loopback_stats;
+		uint64_t num_ios = host_stats->num_reads + host_stats->num_writes;
+		double elapsed_sec = (double)(worker->stop_ticks - worker->start_ticks) / ticks_hz;
+		double iops;
+		double mibps;
+		uint64_t accounted_ticks = 0;
+
+		if (worker->result != DOCA_SUCCESS || num_ios == 0 || elapsed_sec == 0)
+			continue;
+
+		iops = worker->ios_at_stop / elapsed_sec;
+		mibps = iops * bench_cfg.io_size / (1024 * 1024);
+		total_iops += iops;
+		total_mibps += mibps;
+		num_workers++;
+
+		DOCA_LOG_INFO("Core %u: %.0f IOPS, %.2f MiB/s, latency avg %.2f min %.2f max %.2f usec, %lu errors",
+			      worker->core,
+			      iops,
+			      mibps,
+			      (double)host_stats->lat_ticks * 1000000 / (num_ios + host_stats->num_errors) / ticks_hz,
+			      (double)host_stats->min_lat_ticks * 1000000 / ticks_hz,
+			      (double)host_stats->max_lat_ticks * 1000000 / ticks_hz,
+			      host_stats->num_errors);
+		DOCA_LOG_INFO("Core %u: %.2f SQEs per SQ DB, %.2f SQEs per fetch, %.2f copies per IO, %.2f CQEs per MSI-X",
+			      worker->core,
+			      host_stats->num_sq_dbs == 0 ? 0.0 : (double)lb_stats->num_sqes / host_stats->num_sq_dbs,
+			      lb_stats->num_fetches == 0 ? 0.0 : (double)lb_stats->num_sqes / lb_stats->num_fetches,
+			      (double)lb_stats->num_copies / num_ios,
+			      lb_stats->num_msix == 0 ? 0.0 : (double)lb_stats->num_cqes / lb_stats->num_msix);
+
+		worker->layer_ticks[LOOPBACK_BENCH_LAYER_FETCH] = lb_stats->fetch_ticks;
+		worker->layer_ticks[LOOPBACK_BENCH_LAYER_DMA] = lb_stats->copy_ticks;
+		worker->layer_ticks[LOOPBACK_BENCH_LAYER_CQE] = lb_stats->post_ticks;
+		for (int layer = 0; layer < LOOPBACK_BENCH_LAYER_OTHER; layer++)
+			accounted_ticks += worker->layer_ticks[layer];
+		worker->layer_ticks[LOOPBACK_BENCH_LAYER_OTHER] =
+			worker->poll_ticks > accounted_ticks ? worker->poll_ticks - accounted_ticks : 0;
+
+		for (int layer = 0; layer < LOOPBACK_BENCH_NUM_LAYERS; layer++) {
+			DOCA_LOG_INFO("Core %u: layer %-8s %8.1f ticks per IO, %5.1f%% of poll time",
+				      worker->core,
+				      loopback_bench_layer_names[layer],
+				      (double)worker->layer_ticks[layer] / num_ios,
+				      worker->poll_ticks == 0 ? 0.0 :
+								100.0 * worker->layer_ticks[layer] / worker->poll_ticks);
+		}
+	}
+
+	if (num_workers == 0) {
+		DOCA_LOG_ERR("No worker completed any IO");
+		bench_rc = -1;
+		return;
+	}
+
+	DOCA_LOG_INFO("Total: %u cores, %u queues per core, %.0f IOPS, %.2f MiB/s, %.0f IOPS per core",
+		      num_workers,
+		      bench_cfg.num_queues,
+		      total_iops,
+		      total_mibps,
+		      total_iops / num_workers);
+}
+
+/*
+ * Runs on the application thread once a worker finished
+ *
+ * @arg [in]: The worker
+ */
+static void loopback_bench_worker_done(void *arg)
+{
+	struct loopback_bench_worker *worker = arg;
+
+	if (worker->result != DOCA_SUCCESS)
+		bench_rc = -1;
+
+	bench_num_running_workers--;
+	if (bench_num_running_workers != 0)
+		return;
+
+	spdk_poller_unregister(&bench_timer);
+	loopback_bench_report();
+	spdk_app_stop(bench_rc);
+}
+
+/*
+ * Finish the worker once all of its queues drained, runs on the worker thread
+ *
+ * @worker [in]: The worker
+ */
+static void loopback_bench_worker_finish(struct loopback_bench_worker *worker)
+{
+	for (uint32_t idx = 0; idx < bench_cfg.num_queues; idx++) {
+		struct loopback_bench_queue *queue = &worker->queues[idx];
+		const struct nvme_host_sim_stats *host_stats = &queue->host.stats;
+		const struct nvmf_doca_loopback_stats *lb_stats = &queue->qp.stats;
+
+		worker->host_stats.num_reads += host_stats->num_reads;
+		worker->host_stats.num_writes += host_stats->num_writes;
+		worker->host_stats.num_errors += host_stats->num_errors;
+		worker->host_stats.num_sq_dbs += host_stats->num_sq_dbs;
+		worker->host_stats.num_cq_dbs += host_stats->num_cq_dbs;
+		worker->host_stats.bytes += host_stats->bytes;
+		worker->host_stats.lat_ticks += host_stats->lat_ticks;
+		worker->host_stats.min_lat_ticks = spdk_min(worker->host_stats.min_lat_ticks, host_stats->min_lat_ticks);
+		worker->host_stats.max_lat_ticks = spdk_max(worker->host_stats.max_lat_ticks, host_stats->max_lat_ticks);
+
+		worker->loopback_stats.num_doorbells += lb_stats->num_doorbells;
+		worker->loopback_stats.num_fetches += lb_stats->num_fetches;
+		worker->loopback_stats.num_sqes += lb_stats->num_sqes;
+		worker->loopback_stats.num_copies += lb_stats->num_copies;
+		worker->loopback_stats.copy_bytes += lb_stats->copy_bytes;
+		worker->loopback_stats.num_cqes += lb_stats->num_cqes;
+		worker->loopback_stats.num_msix += lb_stats->num_msix;
+		worker->loopback_stats.fetch_ticks += lb_stats->fetch_ticks;
+		worker->loopback_stats.copy_ticks += lb_stats->copy_ticks;
+		worker->loopback_stats.post_ticks += lb_stats->post_ticks;
+		worker->loopback_stats.max_inflight_ops =
+			spdk_max(worker->loopback_stats.max_inflight_ops, lb_stats->max_inflight_ops);
+
+		nvmf_doca_sq_log_dma_pool_stats(&queue->qp.sq);
+	}
+
+	spdk_poller_unregister(&worker->poller);
+	loopback_bench_worker_cleanup(worker);
+	spdk_thread_send_msg(bench_app_thread, loopback_bench_worker_done, worker);
+	spdk_thread_exit(spdk_get_thread());
+}
+
+/*
+ * Poll the Host simulators and the loopback QPs of the worker
+ *
+ * @arg [in]: The worker
+ * @return: SPDK_POLLER_BUSY if any work was done and SPDK_POLLER_IDLE otherwise
+ */
+static int loopback_bench_worker_poll(void *arg)
+{
+	struct loopback_bench_worker *worker = arg;
+	uint64_t start_ticks = spdk_get_ticks();
+	uint64_t host_ticks;
+	uint32_t num_work = 0;
+	bool drained = true;
+
+	for (uint32_t idx = 0; idx < bench_cfg.num_queues; idx++) {
+		struct loopback_bench_queue *queue = &worker->queues[idx];
+		uint32_t num_submitted;
+		uint32_t num_reaped = 0;
+
+		host_ticks = spdk_get_ticks();
+		num_submitted = nvme_host_sim_submit(&queue->host);
+		if (num_submitted != 0)
+			nvmf_doca_loopback_qp_ring_sq_db(&queue->qp, queue->host.sq_tail);
+		worker->layer_ticks[LOOPBACK_BENCH_LAYER_HOST] += spdk_get_ticks() - host_ticks;
+
+		num_work += nvmf_doca_loopback_qp_progress(&queue->qp, LOOPBACK_BENCH_PROGRESS_BUDGET);
+
+		host_ticks = spdk_get_ticks();
+		if (!bench_cfg.msix || queue->msix_pending) {
+			queue->msix_pending = false;
+			num_reaped = nvme_host_sim_reap(&queue->host);
+			if (num_reaped != 0)
+				nvmf_doca_loopback_qp_ring_cq_db(&queue->qp, queue->host.cq_head);
+		}
+		worker->layer_ticks[LOOPBACK_BENCH_LAYER_HOST] += spdk_get_ticks() - host_ticks;
+
+		num_work += num_submitted + num_reaped;
+		if (queue->host.num_outstanding != 0 || nvmf_doca_loopback_qp_num_pending(&queue->qp) != 0)
+			drained = false;
+	}
+
+	worker->poll_ticks += spdk_get_ticks() - start_ticks;
+
+	if (worker->stopping && drained)
+		loopback_bench_worker_finish(worker);
+
+	return num_work != 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+/*
+ * Stop submitting new commands and start draining, runs on the worker thread
+ *
+ * @arg [in]: The worker
+ */
+static void loopback_bench_worker_stop(void *arg)
+{
+	struct loopback_bench_worker *worker = arg;
+
+	worker->stop_ticks = spdk_get_ticks();
+	worker->stopping = true;
+	for (uint32_t idx = 0; idx < bench_cfg.num_queues; idx++) {
+		struct nvme_host_sim *host = &worker->queues[idx].host;
+
+		host->stop_submit = true;
+		worker->ios_at_stop += host->stats.num_reads + host->stats.num_writes;
+	}
+}
+
+/*
+ * Create the RAM disk and queues of the worker and start polling, runs on the worker thread
+ *
+ * @arg [in]: The worker
+ */
+static void loopback_bench_worker_start(void *arg)
+{
+	struct loopback_bench_worker *worker = arg;
+
+	worker->ramdisk_size = (uint64_t)bench_cfg.ramdisk_mb * 1024 * 1024;
+	worker->ramdisk = calloc(1, worker->ramdisk_size);
+	worker->queues = calloc(bench_cfg.num_queues, sizeof(*worker->queues));
+	if (worker->ramdisk == NULL || worker->queues == NULL) {
+		DOCA_LOG_ERR("Core %u: Failed to allocate RAM disk and queues", worker->core);
+		worker->result = DOCA_ERROR_NO_MEMORY;
+		goto fail;
+	}
+
+	for (uint32_t idx = 0; idx < bench_cfg.num_queues; idx++) {
+		struct loopback_bench_queue *queue = &worker->queues[idx];
+		struct nvme_host_sim_attr host_attr = {
+			.queue_depth = bench_cfg.queue_depth,
+			.io_depth = bench_cfg.io_depth,
+			.batch_size = bench_cfg.batch_size,
+			.io_size = bench_cfg.io_size,
+			.read_percentage = bench_cfg.read_percentage,
+			.prp1_offset = bench_cfg.prp1_offset,
+			.scatter_pages = bench_cfg.scatter_pages,
+			.num_lbas = worker->ramdisk_size / NVME_HOST_SIM_LBA_SIZE,
+			.seed = worker->core * bench_cfg.num_queues + idx + 1,
+		};
+
+		queue->worker = worker;
+		worker->result = nvme_host_sim_create(&host_attr, &queue->host);
+		if (worker->result != DOCA_SUCCESS)
+			goto fail;
+		queue->host_created = true;
+
+		struct nvmf_doca_loopback_qp_create_attr qp_attr = {
+			.qid = idx + 1,
+			.depth = bench_cfg.queue_depth,
+			.host_memory = queue->host.memory,
+			.host_memory_size = queue->host.memory_size,
+			.host_sq_address = (uintptr_t)queue->host.sq,
+			.host_cq_address = (uintptr_t)queue->host.cq,
+			.dma_pool_64k_bufs = bench_cfg.dma_pool_64k_bufs,
+			.dma_pool_1m_bufs = bench_cfg.dma_pool_1m_bufs,
+			.enable_msix = bench_cfg.msix,
+			.post_cqe_cb = loopback_bench_on_post_cqe,
+			.fetch_sqe_cb = loopback_bench_on_fetch_sqe,
+			.copy_data_cb = nvmf_doca_request_on_copy_nvm_data,
+			.msix_cb = loopback_bench_on_msix,
+			.exec = loopback_bench_execute,
+			.ctx = queue,
+		};
+		worker->result = nvmf_doca_loopback_qp_create(&qp_attr, &queue->qp);
+		if (worker->result != DOCA_SUCCESS)
+			goto fail;
+		queue->qp_created = true;
+	}
+
+	worker->host_stats.min_lat_ticks = UINT64_MAX;
+	worker->start_ticks = spdk_get_ticks();
+	worker->poller = spdk_poller_register(loopback_bench_worker_poll, worker, 0);
+	return;
+
+fail:
+	loopback_bench_worker_cleanup(worker);
+	spdk_thread_send_msg(bench_app_thread, loopback_bench_worker_done, worker);
+	spdk_thread_exit(spdk_get_thread());
+}
+
+/*
+ * Stop all workers once the measurement duration elapsed
+ *
+ * @arg [in]: Unused
+ * @return: SPDK_POLLER_BUSY
+ */
+static int loopback_bench_timeout(void *arg)
+{
+	(void)arg;
+
+	struct loopback_bench_worker *worker;
+
+	spdk_poller_unregister(&bench_timer);
+	TAILQ_FOREACH(worker, &bench_workers, link)
+	{
+		if (worker->result == DOCA_SUCCESS)
+			spdk_thread_send_msg(worker->thread, loopback_bench_worker_stop, worker);
+	}
+
+	return SPDK_POLLER_BUSY;
+}
+
+/*
+ * Callback that is invoked once SPDK starts the application, creates one worker per core
+ *
+ * @cookie [in]: Unused
+ */
+static void loopback_bench_started(void *cookie)
+{
+	(void)cookie;
+
+	struct loopback_bench_worker *worker;
+	struct spdk_cpuset cpumask;
+	char thread_name[32];
+	uint32_t core;
+
+	bench_app_thread = spdk_get_thread();
+
+	SPDK_ENV_FOREACH_CORE(core)
+	{
+		worker = calloc(1, sizeof(*worker));
+		if (worker == NULL) {
+			DOCA_LOG_ERR("Failed to allocate worker for core %u", core);
+			bench_rc = -1;
+			continue;
+		}
+		worker->core = core;
+		snprintf(thread_name, sizeof(thread_name), "loopback_bench_%u", core);
+		spdk_cpuset_zero(&cpumask);
+		spdk_cpuset_set_cpu(&cpumask, core, true);
+		worker->thread = spdk_thread_create(thread_name, &cpumask);
+		if (worker->thread == NULL) {
+			DOCA_LOG_ERR("Failed to create SPDK thread for core %u", core);
+			free(worker);
+			bench_rc = -1;
+			continue;
+		}
+		TAILQ_INSERT_TAIL(&bench_workers, worker, link);
+		bench_num_running_workers++;
+	}
+
+	if (bench_num_running_workers == 0) {
+		spdk_app_stop(-1);
+		return;
+	}
+
+	DOCA_LOG_INFO("Running %u workers for %u seconds: %u queues each, depth %u, IO size %u, %u%% reads, %s pages",
+		      bench_num_running_workers,
+		      bench_cfg.duration_sec,
+		      bench_cfg.num_queues,
+		      bench_cfg.io_depth,
+		      bench_cfg.io_size,
+		      bench_cfg.read_percentage,
+		      bench_cfg.scatter_pages ? "scattered" : "contiguous");
+
+	bench_timer = spdk_poller_register(loopback_bench_timeout, NULL, (uint64_t)bench_cfg.duration_sec * 1000000);
+	TAILQ_FOREACH(worker, &bench_workers, link)
+	{
+		spdk_thread_send_msg(worker->thread, loopback_bench_worker_start, worker);
+	}
+}
+
+/*********************************************************************************************************************
+ * Command line
+ *********************************************************************************************************************/
+
+/*
+ * Print the usage of the benchmark specific options
+ */
+static void loopback_bench_usage(void)
+{
+	printf(" --io-size <bytes>          data length of each command (default %u)\n", bench_cfg.io_size);
+	printf(" --io-depth <num>           outstanding commands per queue (default %u)\n", bench_cfg.io_depth);
+	printf(" --queue-depth <num>        number of SQ and CQ elements (default %u)\n", bench_cfg.queue_depth);
+	printf(" --batch-size <num>         max SQEs per SQ doorbell (default %u)\n", bench_cfg.batch_size);
+	printf(" --num-queues <num>         queues per core (default %u)\n", bench_cfg.num_queues);
+	printf(" --read-percentage <pct>    percentage of reads (default %u)\n", bench_cfg.read_percentage);
+	printf(" --prp1-offset <bytes>      offset of data in the first page (default %u)\n", bench_cfg.prp1_offset);
+	printf(" --scatter                  scatter the data pages of each command in Host memory\n");
+	printf(" --msix                     reap completions on MSI-X instead of polling the CQ\n");
+	printf(" --duration <sec>           measurement duration (default %u)\n", bench_cfg.duration_sec);
+	printf(" --ramdisk-mb <MiB>         RAM disk size per core (default %u)\n", bench_cfg.ramdisk_mb);
+	printf(" --dma-pool-64k-bufs <num>  64KiB DPU data buffers per queue (default %u)\n", bench_cfg.dma_pool_64k_bufs);
+	printf(" --dma-pool-1m-bufs <num>   1MiB DPU data buffers per queue (default %u)\n", bench_cfg.dma_pool_1m_bufs);
+}
+
+/*
+ * Parse a benchmark specific option
+ *
+ * @ch [in]: The option
+ * @arg [in]: The option argument
+ * @return: 0 on success and negative errno otherwise
+ */
+static int loopback_bench_parse_arg(int ch, char *arg)
+{
+	long value = 0;
+
+	if (arg != NULL) {
+		value = spdk_strtol(arg, 10);
+		if (value < 0) {
+			fprintf(stderr, "Invalid value %s\n", arg);
+			return -EINVAL;
+		}
+	}
+
+	switch (ch) {
+	case LOOPBACK_BENCH_OPT_IO_SIZE:
+		bench_cfg.io_size = value;
+		break;
+	case LOOPBACK_BENCH_OPT_IO_DEPTH:
+		bench_cfg.io_depth = value;
+		break;
+	case LOOPBACK_BENCH_OPT_QUEUE_DEPTH:
+		bench_cfg.queue_depth = value;
+		break;
+	case LOOPBACK_BENCH_OPT_BATCH_SIZE:
+		bench_cfg.batch_size = value;
+		break;
+	case LOOPBACK_BENCH_OPT_NUM_QUEUES:
+		bench_cfg.num_queues = value;
+		break;
+	case LOOPBACK_BENCH_OPT_READ_PERCENTAGE:
+		bench_cfg.read_percentage = value;
+		break;
+	case LOOPBACK_BENCH_OPT_PRP1_OFFSET:
+		bench_cfg.prp1_offset = value;
+		break;
+	case LOOPBACK_BENCH_OPT_SCATTER:
+		bench_cfg.scatter_pages = true;
+		break;
+	case LOOPBACK_BENCH_OPT_MSIX:
+		bench_cfg.msix = true;
+		break;
+	case LOOPBACK_BENCH_OPT_DURATION:
+		bench_cfg.duration_sec = value;
+		break;
+	case LOOPBACK_BENCH_OPT_RAMDISK_MB:
+		bench_cfg.ramdisk_mb = value;
+		break;
+	case LOOPBACK_BENCH_OPT_DMA_POOL_64K_BUFS:
+		bench_cfg.dma_pool_64k_bufs = value;
+		break;
+	case LOOPBACK_BENCH_OPT_DMA_POOL_1M_BUFS:
+		bench_cfg.dma_pool_1m_bufs = value;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Validate the combination of benchmark options
+ *
+ * @return: true if valid and false otherwise
+ */
+static bool loopback_bench_cfg_valid(void)
+{
+	uint32_t pages_per_cmd = SPDK_CEIL_DIV(bench_cfg.prp1_offset + bench_cfg.io_size, NVME_PAGE_SIZE);
+
+	if (bench_cfg.queue_depth > UINT16_MAX || bench_cfg.io_depth == 0 ||
+	    bench_cfg.io_depth >= bench_cfg.queue_depth) {
+		fprintf(stderr, "IO depth must be non zero and less than the queue depth\n");
+		return false;
+	}
+	if (bench_cfg.io_size == 0 || bench_cfg.io_size % NVME_HOST_SIM_LBA_SIZE != 0 ||
+	    bench_cfg.io_size / NVME_HOST_SIM_LBA_SIZE > UINT16_MAX + 1 || pages_per_cmd > NVMF_REQ_MAX_BUFFERS) {
+		fprintf(stderr,
+			"IO size must be a multiple of %u spanning at most %u pages\n",
+			NVME_HOST_SIM_LBA_SIZE,
+			NVMF_REQ_MAX_BUFFERS);
+		return false;
+	}
+	if (bench_cfg.read_percentage > 100 || bench_cfg.batch_size == 0 || bench_cfg.num_queues == 0 ||
+	    bench_cfg.duration_sec == 0 || (uint64_t)bench_cfg.ramdisk_mb * 1024 * 1024 < bench_cfg.io_size) {
+		fprintf(stderr, "Invalid read percentage, batch size, number of queues, duration or RAM disk size\n");
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * NVMe emulation loopback benchmark main function
+ *
+ * @argc [in]: command line arguments size
+ * @argv [in]: array of command line arguments
+ * @return: EXIT_SUCCESS on success and EXIT_FAILURE otherwise
+ */
+int main(int argc, char **argv)
+{
+	struct doca_log_backend *sdk_log;
+	struct spdk_app_opts opts = {};
+	int rc;
+	doca_error_t result;
+
+	/* Register a logger backend */
+	result = doca_log_backend_create_standard();
+	if (result != DOCA_SUCCESS)
+		return EXIT_FAILURE;
+
+	result = doca_log_level_set_global_sdk_limit(DOCA_LOG_LEVEL_ERROR);
+	if (result != DOCA_SUCCESS)
+		return EXIT_FAILURE;
+
+	/* Register a logger backend for internal SDK errors and warnings */
+	result = doca_log_backend_create_with_file_sdk(stderr, &sdk_log);
+	if (result != DOCA_SUCCESS)
+		return EXIT_FAILURE;
+	result = doca_log_backend_set_sdk_level(sdk_log, DOCA_LOG_LEVEL_ERROR);
+	if (result != DOCA_SUCCESS)
+		return EXIT_FAILURE;
+
+	spdk_app_opts_init(&opts, sizeof(opts));
+	opts.name = "nvme_loopback";
+	rc = spdk_app_parse_args(argc,
+				 argv,
+				 &opts,
+				 "",
+				 loopback_bench_long_opts,
+				 loopback_bench_parse_arg,
+				 loopback_bench_usage);
+	if (rc != SPDK_APP_PARSE_ARGS_SUCCESS)
+		exit(rc);
+	if (!loopback_bench_cfg_valid())
+		return EXIT_FAILURE;
+
+	/* Blocks until the application is exiting */
+	rc = spdk_app_start(&opts, loopback_bench_started, NULL);
+	spdk_app_fini();
+
+	if (rc != 0)
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
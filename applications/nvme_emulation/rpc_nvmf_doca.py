@@ -60,6 +60,19 @@ def list_functions(client, dev_name):
 	params['dev-name'] = dev_name
 	return client.call('nvmf_doca_list_functions', params)
 
+def create_transport(client, dma_pool_64k_bufs=None, dma_pool_1m_bufs=None):
+	"""Creates the DOCA transport with DOCA specific options.
+
+	"""
+	params = {}
+
+	params['trtype'] = 'DOCA'
+	if dma_pool_64k_bufs is not None:
+		params['dma_pool_64k_bufs'] = dma_pool_64k_bufs
+	if dma_pool_1m_bufs is not None:
+		params['dma_pool_1m_bufs'] = dma_pool_1m_bufs
+	return client.call('nvmf_create_transport', params)
+
 
 def spdk_rpc_plugin_initialize(subparsers):
 	def nvmf_doca_get_managers(args):
@@ -94,3 +107,12 @@ def spdk_rpc_plugin_initialize(subparsers):
 	p.add_argument('-d', '--dev-name', help='The PCI type', type=str)
 	p.set_defaults(func=nvmf_doca_list_functions)
 
+	def nvmf_doca_create_transport(args):
+		create_transport(args.client, args.dma_pool_64k_bufs, args.dma_pool_1m_bufs)
+
+	p = subparsers.add_parser('nvmf_doca_create_transport',
+				  help='Creates the DOCA transport, pool counters are reported by nvmf_get_stats')
+	p.add_argument('--dma-pool-64k-bufs', help='Number of 64KiB DPU data buffers per IO SQ', type=int)
+	p.add_argument('--dma-pool-1m-bufs', help='Number of 1MiB DPU data buffers per IO SQ', type=int)
+	p.set_defaults(func=nvmf_doca_create_transport)
+
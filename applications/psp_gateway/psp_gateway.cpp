@@ -257,6 +257,20 @@ int main(int argc, char **argv)
 
 		PSP_GatewayImpl psp_svc(&app_config, &psp_flows);
 
+		if (app_config.crypto_id_churn_rounds > 0) {
+			result = psp_svc.check_crypto_id_churn(app_config.crypto_id_churn_rounds);
+			exit_status = result == DOCA_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+			goto dpdk_cleanup;
+		}
+
+		if (app_config.bench_tunnels > 0) {
+			result = psp_svc.benchmark_tunnel_setup(app_config.bench_tunnels);
+			exit_status = result == DOCA_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+			goto dpdk_cleanup;
+		}
+
+		psp_svc.warm_up_stubs();
+
 		struct lcore_params lcore_params = {
 			&force_quit,
 			&app_config,
@@ -280,6 +294,10 @@ int main(int argc, char **argv)
 		grpc::ServerBuilder builder;
 		builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
 		builder.RegisterService(&psp_svc);
+		// Accept the keepalive pings of the peers' channels, which are sent even without calls
+		builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+		builder.AddChannelArgument(GRPC_ARG_HTTP2_MIN_RECV_PING_INTERVAL_WITHOUT_DATA_MS,
+					   PSP_GatewayImpl::KEEPALIVE_TIME_MS);
 		auto server_instance = builder.BuildAndStart();
 
 		if (!server_instance) {
@@ -304,10 +322,15 @@ int main(int argc, char **argv)
 			psp_svc.try_connect(remotes_to_connect);
 			sleep(1);
 
+			psp_svc.complete_inflight_sessions();
+			psp_svc.remove_idle_sessions();
+
 			if (app_config.print_stats) {
 				psp_flows.show_static_flow_counts();
 				psp_svc.show_flow_counts();
 			}
+			if (app_config.print_stats || (app_config.print_perf_flags & PSP_PERF_INSERTION_PRINT))
+				psp_svc.show_tunnel_request_stats();
 		}
 
 		DOCA_LOG_INFO("Shutting down");
@@ -143,6 +143,11 @@ struct psp_gw_app_config {
 
 	uint32_t max_tunnels; /* The maximum number of outgoing tunnel connections supported on this host */
 
+	uint32_t idle_timeout_sec; /* Seconds without egress traffic before a tunnel is torn down, 0 to never */
+
+	uint32_t crypto_id_churn_rounds; /* Rounds of the crypto_id churn check to run instead of the app, if any */
+	uint32_t bench_tunnels;		 /* Tunnels of the setup benchmark to run instead of the app, if any */
+
 	struct psp_gw_net_config net_config; /* List of remote peers supporting PSP connections */
 
 	/**
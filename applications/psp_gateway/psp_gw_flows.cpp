@@ -23,6 +23,7 @@
  *
  */
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -705,7 +706,9 @@ doca_error_t PSP_GatewayFlows::ingress_acl_pipe_create(bool ipv4)
 	return result;
 }
 
-doca_error_t PSP_GatewayFlows::add_ingress_src_ip6_entry(psp_session_t *session, int dst_vip_id)
+doca_error_t PSP_GatewayFlows::add_ingress_src_ip6_entry(psp_session_t *session,
+							 int dst_vip_id,
+							 psp_session_entries *entries)
 {
 	doca_flow_match match = {};
 	match.tun.type = DOCA_FLOW_TUN_PSP;
@@ -720,17 +723,56 @@ doca_error_t PSP_GatewayFlows::add_ingress_src_ip6_entry(psp_session_t *session,
 	doca_flow_actions actions = {};
 	actions.meta.u32[2] = dst_vip_id;
 
-	return add_single_entry(0, ingress_src_ip6_pipe, pf_dev->port_obj, &match, &actions, nullptr, nullptr, nullptr);
+	return add_batch_entry(ingress_src_ip6_pipe,
+			       &match,
+			       &actions,
+			       nullptr,
+			       nullptr,
+			       entries->ip6_status,
+			       &entries->ip6_entry);
 }
 
 doca_error_t PSP_GatewayFlows::add_ingress_acl_entry(psp_session_t *session)
 {
-	struct doca_flow_pipe *pipe;
+	std::vector<psp_session_t *> sessions = {session};
+	std::vector<doca_error_t> results;
+
+	doca_error_t result = add_ingress_acl_entries(sessions, results);
+	return result != DOCA_SUCCESS ? result : results[0];
+}
+
+doca_error_t PSP_GatewayFlows::add_ingress_acl_entries(const std::vector<psp_session_t *> &sessions,
+							std::vector<doca_error_t> &results)
+{
+	std::vector<psp_session_entries> entries(sessions.size());
+	doca_error_t result;
+
 	if (app_config->disable_ingress_acl) {
 		DOCA_LOG_ERR("Cannot insert ingress ACL flow; disabled");
 		return DOCA_ERROR_BAD_STATE;
 	}
 
+	results.assign(sessions.size(), DOCA_SUCCESS);
+	for (size_t i = 0; i < sessions.size(); i++)
+		entries[i].result = enqueue_ingress_acl_entry(sessions[i], &entries[i]);
+
+	result = process_batch();
+
+	for (size_t i = 0; i < sessions.size(); i++) {
+		results[i] = complete_session_entries(entries[i], &sessions[i]->acl_entry, &sessions[i]->acl_inflight);
+		if (results[i] != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to process ACL entry on SPI %d: %s",
+				     sessions[i]->spi_ingress,
+				     doca_error_get_descr(results[i]));
+	}
+
+	return result;
+}
+
+doca_error_t PSP_GatewayFlows::enqueue_ingress_acl_entry(psp_session_t *session, psp_session_entries *entries)
+{
+	struct doca_flow_pipe *pipe;
+
 	doca_flow_match match = {};
 	match.parser_meta.psp_syndrome = 0;
 	doca_flow_header_format *match_hdr = app_config->mode == PSP_GW_MODE_TUNNEL ? &match.inner : &match.outer;
@@ -760,16 +802,12 @@ doca_error_t PSP_GatewayFlows::add_ingress_acl_entry(psp_session_t *session)
 			dst_vip_id = rte_hash_lookup(app_config->ip6_table, session->dst_vip.ipv6_addr);
 		}
 		match.meta.u32[2] = dst_vip_id;
-		doca_error_t result = add_ingress_src_ip6_entry(session, dst_vip_id);
+		doca_error_t result = add_ingress_src_ip6_entry(session, dst_vip_id, entries);
 		if (result != DOCA_SUCCESS)
 			return result;
 	}
 
-	doca_error_t result = DOCA_SUCCESS;
-	IF_SUCCESS(result,
-		   add_single_entry(0, pipe, pf_dev->port_obj, &match, nullptr, nullptr, nullptr, &session->acl_entry));
-
-	return result;
+	return add_batch_entry(pipe, &match, nullptr, nullptr, nullptr, entries->status, &session->acl_entry);
 }
 
 doca_error_t PSP_GatewayFlows::syndrome_stats_pipe_create(void)
@@ -943,7 +981,9 @@ doca_error_t PSP_GatewayFlows::egress_acl_pipe_create(bool ipv4)
 	return result;
 }
 
-doca_error_t PSP_GatewayFlows::add_egress_dst_ip6_entry(psp_session_t *session, int dst_vip_id)
+doca_error_t PSP_GatewayFlows::add_egress_dst_ip6_entry(psp_session_t *session,
+							int dst_vip_id,
+							psp_session_entries *entries)
 {
 	doca_flow_match match = {};
 	SET_IP6_ADDR(match.outer.ip6.dst_ip,
@@ -955,10 +995,151 @@ doca_error_t PSP_GatewayFlows::add_egress_dst_ip6_entry(psp_session_t *session,
 	doca_flow_actions actions = {};
 	actions.meta.u32[2] = dst_vip_id;
 
-	return add_single_entry(0, egress_dst_ip6_pipe, pf_dev->port_obj, &match, &actions, nullptr, nullptr, nullptr);
+	return add_batch_entry(egress_dst_ip6_pipe,
+			       &match,
+			       &actions,
+			       nullptr,
+			       nullptr,
+			       entries->ip6_status,
+			       &entries->ip6_entry);
 }
 
 doca_error_t PSP_GatewayFlows::add_encrypt_entry(psp_session_t *session, const void *encrypt_key)
+{
+	std::vector<psp_session_and_key_t> sessions_keys = {{session, (void *)encrypt_key}};
+	std::vector<doca_error_t> results;
+
+	doca_error_t result = add_encrypt_entries(sessions_keys, results);
+	return result != DOCA_SUCCESS ? result : results[0];
+}
+
+doca_error_t PSP_GatewayFlows::add_encrypt_entries(const std::vector<psp_session_and_key_t> &sessions_keys,
+						    std::vector<doca_error_t> &results)
+{
+	std::vector<psp_session_entries> entries(sessions_keys.size());
+	doca_error_t result;
+
+	results.assign(sessions_keys.size(), DOCA_SUCCESS);
+	for (size_t i = 0; i < sessions_keys.size(); i++)
+		entries[i].result = enqueue_encrypt_entry(sessions_keys[i].first, sessions_keys[i].second, &entries[i]);
+
+	result = process_batch();
+
+	for (size_t i = 0; i < sessions_keys.size(); i++) {
+		psp_session_t *session = sessions_keys[i].first;
+
+		results[i] = complete_session_entries(entries[i],
+						      &session->encap_encrypt_entry,
+						      &session->encrypt_inflight);
+		if (results[i] != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to process encrypt entry for crypto_id %d: %s",
+				     session->crypto_id,
+				     doca_error_get_descr(results[i]));
+			continue;
+		}
+
+		DOCA_LOG_DBG("Created session entry: %p", session->encap_encrypt_entry);
+		session->pkt_count_egress = UINT64_MAX; // force next query to detect a change
+	}
+
+	return result;
+}
+
+doca_error_t PSP_GatewayFlows::complete_session_entries(const psp_session_entries &entries,
+							 doca_flow_pipe_entry **entry,
+							 std::shared_ptr<psp_session_entries> *inflight)
+{
+	if (entries.status->entries_in_queue || entries.ip6_status->entries_in_queue) {
+		// The entries may still be installed later; the session owns them until they complete
+		if (!*inflight)
+			*inflight = std::make_shared<psp_session_entries>(entries);
+		return DOCA_ERROR_IN_PROGRESS;
+	}
+
+	doca_error_t result = entries.result;
+	if (result == DOCA_SUCCESS && (entries.status->failure || entries.ip6_status->failure))
+		result = DOCA_ERROR_BAD_STATE;
+
+	if (result != DOCA_SUCCESS) {
+		// Don't leave a partial session behind
+		if (entries.status->nb_processed && !entries.status->failure)
+			remove_entry(*entry);
+		if (entries.ip6_status->nb_processed && !entries.ip6_status->failure)
+			remove_entry(entries.ip6_entry);
+		*entry = nullptr;
+	}
+
+	// Last, as the entries may be the in-flight ones
+	inflight->reset();
+
+	return result;
+}
+
+doca_error_t PSP_GatewayFlows::process_inflight_entries(void)
+{
+	uint32_t nb_inflight = 0;
+
+	for (const auto &status : orphan_statuses)
+		nb_inflight += status->entries_in_queue;
+	if (nb_inflight == 0)
+		return DOCA_SUCCESS;
+
+	doca_error_t result = doca_flow_entries_process(pf_dev->port_obj, 0, 0, nb_inflight);
+	if (result != DOCA_SUCCESS)
+		DOCA_LOG_ERR("Failed to process in-flight entries: %s", doca_error_get_descr(result));
+
+	orphan_statuses.erase(std::remove_if(orphan_statuses.begin(),
+					     orphan_statuses.end(),
+					     [](const std::shared_ptr<entries_status> &status) {
+						     return status->entries_in_queue == 0;
+					     }),
+			      orphan_statuses.end());
+
+	return result;
+}
+
+doca_error_t PSP_GatewayFlows::complete_inflight_encrypt_entry(psp_session_t *session)
+{
+	if (!session->encrypt_inflight)
+		return DOCA_SUCCESS;
+
+	doca_error_t result = complete_session_entries(*session->encrypt_inflight,
+						       &session->encap_encrypt_entry,
+						       &session->encrypt_inflight);
+	if (result == DOCA_SUCCESS)
+		session->pkt_count_egress = UINT64_MAX; // force next query to detect a change
+
+	return result;
+}
+
+doca_error_t PSP_GatewayFlows::complete_inflight_acl_entry(psp_session_t *session)
+{
+	if (!session->acl_inflight)
+		return DOCA_SUCCESS;
+
+	return complete_session_entries(*session->acl_inflight, &session->acl_entry, &session->acl_inflight);
+}
+
+doca_error_t PSP_GatewayFlows::remove_entry(doca_flow_pipe_entry *entry)
+{
+	doca_error_t result;
+
+	result = doca_flow_pipe_remove_entry(0, DOCA_FLOW_NO_WAIT, entry);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to remove entry: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	result = doca_flow_entries_process(pf_dev->port_obj, 0, DEFAULT_TIMEOUT_US, 1);
+	if (result != DOCA_SUCCESS)
+		DOCA_LOG_ERR("Failed to process entry removal: %s", doca_error_get_descr(result));
+
+	return result;
+}
+
+doca_error_t PSP_GatewayFlows::enqueue_encrypt_entry(psp_session_t *session,
+						     const void *encrypt_key,
+						     psp_session_entries *entries)
 {
 	DOCA_LOG_DBG("\n>> %s", __FUNCTION__);
 	doca_error_t result = DOCA_SUCCESS;
@@ -1013,7 +1194,7 @@ doca_error_t PSP_GatewayFlows::add_encrypt_entry(psp_session_t *session, const v
 			dst_vip_id = rte_hash_lookup(app_config->ip6_table, session->dst_vip.ipv6_addr);
 		}
 		encap_encrypt_match.meta.u32[2] = dst_vip_id;
-		result = add_egress_dst_ip6_entry(session, dst_vip_id);
+		result = add_egress_dst_ip6_entry(session, dst_vip_id, entries);
 		if (result != DOCA_SUCCESS)
 			return result;
 	}
@@ -1036,24 +1217,18 @@ doca_error_t PSP_GatewayFlows::add_encrypt_entry(psp_session_t *session, const v
 
 	encap_actions.crypto.crypto_id = session->crypto_id;
 
-	result = add_single_entry(0,
-				  pipe,
-				  pf_dev->port_obj,
-				  &encap_encrypt_match,
-				  &encap_actions,
-				  nullptr,
-				  nullptr,
-				  &session->encap_encrypt_entry);
-
+	result = add_batch_entry(pipe,
+				 &encap_encrypt_match,
+				 &encap_actions,
+				 nullptr,
+				 nullptr,
+				 entries->status,
+				 &session->encap_encrypt_entry);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to add encrypt_encap pipe entry: %s", doca_error_get_descr(result));
 		return result;
 	}
 
-	DOCA_LOG_DBG("Created session entry: %p", session->encap_encrypt_entry);
-
-	session->pkt_count_egress = UINT64_MAX; // force next query to detect a change
-
 	return result;
 }
 
@@ -1149,9 +1324,36 @@ doca_error_t PSP_GatewayFlows::remove_encrypt_entry(psp_session_t *session)
 		return result;
 	}
 
+	session->encap_encrypt_entry = nullptr;
+
 	return result;
 }
 
+doca_error_t PSP_GatewayFlows::remove_ingress_acl_entry(psp_session_t *session)
+{
+	doca_error_t result = remove_entry(session->acl_entry);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	session->acl_entry = nullptr;
+	return DOCA_SUCCESS;
+}
+
+doca_error_t PSP_GatewayFlows::query_encrypt_pkt_count(const psp_session_t *session, uint64_t *pkt_count)
+{
+	doca_flow_resource_query encap_encrypt_stats = {};
+
+	if (!session->encap_encrypt_entry)
+		return DOCA_ERROR_NOT_FOUND;
+
+	doca_error_t result = doca_flow_resource_query_entry(session->encap_encrypt_entry, &encap_encrypt_stats);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	*pkt_count = encap_encrypt_stats.counter.total_pkts;
+	return DOCA_SUCCESS;
+}
+
 doca_error_t PSP_GatewayFlows::egress_sampling_pipe_create(void)
 {
 	DOCA_LOG_DBG("\n>> %s", __FUNCTION__);
@@ -1831,6 +2033,87 @@ doca_error_t PSP_GatewayFlows::add_single_entry(uint16_t pipe_queue,
 	return result;
 }
 
+doca_error_t PSP_GatewayFlows::add_batch_entry(doca_flow_pipe *pipe,
+					       const doca_flow_match *match,
+					       const doca_flow_actions *actions,
+					       const doca_flow_monitor *mon,
+					       const doca_flow_fwd *fwd,
+					       const std::shared_ptr<entries_status> &status,
+					       doca_flow_pipe_entry **entry)
+{
+	doca_error_t result;
+
+	if (nb_batch_entries == MAX_ENTRIES_PER_BATCH) {
+		result = process_batch();
+		if (result != DOCA_SUCCESS)
+			return result;
+	}
+
+	result = doca_flow_pipe_add_entry(0,
+					  pipe,
+					  match,
+					  actions,
+					  mon,
+					  fwd,
+					  DOCA_FLOW_WAIT_FOR_BATCH,
+					  status.get(),
+					  entry);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to add entry: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	if (status->entries_in_queue++ == 0)
+		batch_statuses.push_back(status);
+	nb_batch_entries++;
+
+	return DOCA_SUCCESS;
+}
+
+doca_error_t PSP_GatewayFlows::process_batch(void)
+{
+	doca_error_t result = DOCA_SUCCESS;
+	uint32_t nb_pending = nb_batch_entries;
+
+	while (nb_pending > 0) {
+		result = doca_flow_entries_process(pf_dev->port_obj, 0, DEFAULT_TIMEOUT_US, nb_pending);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to process entries: %s", doca_error_get_descr(result));
+			break;
+		}
+
+		uint32_t nb_left = 0;
+		for (const auto &status : batch_statuses)
+			nb_left += status->entries_in_queue;
+
+		if (nb_left == nb_pending) {
+			DOCA_LOG_ERR("Timed out processing entries; %u of %u left", nb_left, nb_batch_entries);
+			result = DOCA_ERROR_TIME_OUT;
+			break;
+		}
+		nb_pending = nb_left;
+	}
+
+	if (result != DOCA_SUCCESS) {
+		// The callback of an entry left in the queue still writes to its status
+		for (const auto &status : batch_statuses) {
+			if (status->entries_in_queue)
+				orphan_statuses.push_back(status);
+		}
+	}
+	orphan_statuses.erase(std::remove_if(orphan_statuses.begin(),
+					     orphan_statuses.end(),
+					     [](const std::shared_ptr<entries_status> &status) {
+						     return status->entries_in_queue == 0;
+					     }),
+			      orphan_statuses.end());
+
+	nb_batch_entries = 0;
+	batch_statuses.clear();
+
+	return result;
+}
+
 struct PSP_GatewayFlows::pipe_query {
 	doca_flow_pipe *pipe;	     // used to query misses
 	doca_flow_pipe_entry *entry; // used to query static entries
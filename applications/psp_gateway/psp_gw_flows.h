@@ -26,9 +26,11 @@
 #ifndef _PSP_GW_FLOWS_H_
 #define _PSP_GW_FLOWS_H_
 
+#include <memory>
 #include <netinet/in.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <rte_ether.h>
 
@@ -56,6 +58,17 @@ struct psp_pf_dev {
 	std::string src_pip_str;
 };
 
+/**
+ * @brief The flow entries enqueued for one flow of a session
+ *        (encryption or ingress ACL) and their completion status.
+ */
+struct psp_session_entries {
+	std::shared_ptr<entries_status> status{std::make_shared<entries_status>()};	/* encrypt/ACL entry */
+	std::shared_ptr<entries_status> ip6_status{std::make_shared<entries_status>()}; /* IPv6 VIP ID entry */
+	doca_flow_pipe_entry *ip6_entry{};						/* IPv6 VIP ID entry */
+	doca_error_t result{DOCA_SUCCESS};						/* Enqueue result */
+};
+
 /**
  * @brief describes a PSP tunnel connection to a single address
  *        on a peer.
@@ -78,8 +91,16 @@ struct psp_session_t {
 	doca_flow_pipe_entry *acl_entry;	   /* DOC AFlow ACL entry */
 	uint64_t pkt_count_egress;		   /* Count of encap_encrypt_entry */
 	uint64_t pkt_count_ingress;		   /* Count of acl_entry */
+
+	uint64_t idle_pkt_count_egress; /* Count of encap_encrypt_entry at the last idle check */
+	uint64_t last_active_tsc;	/* Time egress traffic was last seen by the idle check */
+
+	std::shared_ptr<psp_session_entries> encrypt_inflight; /* Encrypt entries still queued, if any */
+	std::shared_ptr<psp_session_entries> acl_inflight;     /* ACL entries still queued, if any */
 };
 
+using psp_session_and_key_t = std::pair<psp_session_t *, void *>;
+
 /**
  * @brief The entity which owns all the doca flow shared
  *        resources and flow pipes (but not sessions).
@@ -129,6 +150,18 @@ public:
 	 */
 	doca_error_t add_encrypt_entry(psp_session_t *session, const void *encrypt_key);
 
+	/**
+	 * @brief Adds the encryption flow entries for a batch of sessions.
+	 * All entries (including the IPv6 destination entries) are enqueued
+	 * and their completions are processed together.
+	 *
+	 * @sessions_keys [in]: the sessions and their encryption keys
+	 * @results [out]: the result of each session, in the same order
+	 * @return: DOCA_SUCCESS if the batch was processed and DOCA_ERROR otherwise
+	 */
+	doca_error_t add_encrypt_entries(const std::vector<psp_session_and_key_t> &sessions_keys,
+					 std::vector<doca_error_t> &results);
+
 	/**
 	 * @brief Adds an ingress ACL entry for the given session to accept
 	 *        the combination of src_vip and SPI.
@@ -138,6 +171,18 @@ public:
 	 */
 	doca_error_t add_ingress_acl_entry(psp_session_t *session);
 
+	/**
+	 * @brief Adds the ingress ACL entries for a batch of sessions.
+	 * All entries (including the IPv6 source entries) are enqueued
+	 * and their completions are processed together.
+	 *
+	 * @sessions [in]: the sessions for which ingress ACL flows should be created
+	 * @results [out]: the result of each session, in the same order
+	 * @return: DOCA_SUCCESS if the batch was processed and DOCA_ERROR otherwise
+	 */
+	doca_error_t add_ingress_acl_entries(const std::vector<psp_session_t *> &sessions,
+					     std::vector<doca_error_t> &results);
+
 	/**
 	 * @brief Removes the indicated flow entry.
 	 *
@@ -146,6 +191,54 @@ public:
 	 */
 	doca_error_t remove_encrypt_entry(psp_session_t *session);
 
+	/**
+	 * @brief Removes the ingress ACL entry of the given session.
+	 *
+	 * @session [in/out]: The session whose ACL flow should be removed
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t remove_ingress_acl_entry(psp_session_t *session);
+
+	/**
+	 * @brief Processes the completions of the entries which were still
+	 * queued when their batch was processed, without waiting for them.
+	 *
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t process_inflight_entries(void);
+
+	/**
+	 * @brief Collects the result of the encryption entries of a session
+	 * which were still queued when they were added. If they failed, the
+	 * installed part of the flow is removed; the caller still owns the
+	 * crypto_id of the session.
+	 *
+	 * @session [in/out]: the session whose encryption entries are in flight
+	 * @return: DOCA_SUCCESS once installed, DOCA_ERROR_IN_PROGRESS while
+	 *          still queued and DOCA_ERROR otherwise
+	 */
+	doca_error_t complete_inflight_encrypt_entry(psp_session_t *session);
+
+	/**
+	 * @brief Collects the result of the ingress ACL entries of a session
+	 * which were still queued when they were added. If they failed, the
+	 * installed part of the flow is removed.
+	 *
+	 * @session [in/out]: the session whose ACL entries are in flight
+	 * @return: DOCA_SUCCESS once installed, DOCA_ERROR_IN_PROGRESS while
+	 *          still queued and DOCA_ERROR otherwise
+	 */
+	doca_error_t complete_inflight_acl_entry(psp_session_t *session);
+
+	/**
+	 * @brief Queries the number of packets encrypted for the given session.
+	 *
+	 * @session [in]: the session whose encryption flow should be queried
+	 * @pkt_count [out]: the number of packets which hit the encryption flow
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t query_encrypt_pkt_count(const psp_session_t *session, uint64_t *pkt_count);
+
 	/**
 	 * @brief Shows flow counters for pipes which have a fixed number of entries,
 	 *        if any counter values have changed since the last invocation.
@@ -246,6 +339,84 @@ private:
 				      const doca_flow_fwd *fwd,
 				      doca_flow_pipe_entry **entry);
 
+	/**
+	 * @brief wrapper for doca_flow_pipe_add_entry() on queue 0 which
+	 * defers processing until process_batch() is called. The batch is
+	 * flushed first if it already holds MAX_ENTRIES_PER_BATCH entries.
+	 *
+	 * @pipe [in]: the pipe on which to add the entry
+	 * @match [in]: packet match criteria
+	 * @actions [in]: packet mod actions
+	 * @mon [in]: packet monitoring actions
+	 * @fwd [in]: packet forwarding actions
+	 * @status [in/out]: the status which collects the entry completion
+	 * @entry [out]: the newly created flow entry
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t add_batch_entry(doca_flow_pipe *pipe,
+				     const doca_flow_match *match,
+				     const doca_flow_actions *actions,
+				     const doca_flow_monitor *mon,
+				     const doca_flow_fwd *fwd,
+				     const std::shared_ptr<entries_status> &status,
+				     doca_flow_pipe_entry **entry);
+
+	/**
+	 * @brief Processes all the entries enqueued by add_batch_entry().
+	 * Per-entry failures are reported through their entries_status.
+	 * On failure, the statuses of the entries left in the queue are
+	 * kept alive until a later call processes them.
+	 *
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t process_batch(void);
+
+	/**
+	 * @brief Collects the result of the entries of a session once their
+	 * batch was processed. If the session failed, its installed entries
+	 * are removed. Entries which are still queued are handed over to the
+	 * session, which keeps them until a later call completes them.
+	 *
+	 * @entries [in]: the entries enqueued for the session
+	 * @entry [in/out]: the main entry of the session, reset on failure
+	 * @inflight [in/out]: the in-flight entries of the session; set while
+	 *                     some entries are queued and reset otherwise
+	 * @return: DOCA_SUCCESS on success, DOCA_ERROR_IN_PROGRESS if some
+	 *          entries are still queued and DOCA_ERROR otherwise
+	 */
+	doca_error_t complete_session_entries(const psp_session_entries &entries,
+					      doca_flow_pipe_entry **entry,
+					      std::shared_ptr<psp_session_entries> *inflight);
+
+	/**
+	 * @brief Removes a flow entry and waits for its completion
+	 *
+	 * @entry [in]: the entry to remove
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t remove_entry(doca_flow_pipe_entry *entry);
+
+	/**
+	 * @brief Enqueues the encryption flow entries of a session
+	 *
+	 * @session [in]: the session for which an encryption flow should be created
+	 * @encrypt_key [in]: the encryption key to use for the session
+	 * @entries [in/out]: the entries enqueued for the session
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t enqueue_encrypt_entry(psp_session_t *session,
+					   const void *encrypt_key,
+					   psp_session_entries *entries);
+
+	/**
+	 * @brief Enqueues the ingress ACL flow entries of a session
+	 *
+	 * @session [in]: the session for which an ingress ACL flow should be created
+	 * @entries [in/out]: the entries enqueued for the session
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t enqueue_ingress_acl_entry(psp_session_t *session, psp_session_entries *entries);
+
 	/**
 	 * Generates the outer/encap header contents for a given session for ipv6 tunnel encap
 	 *
@@ -337,18 +508,20 @@ private:
 	 *
 	 * @session [in]: the session for which an encryption flow should be created
 	 * @dst_vip_id [in]: the hash of the destination vip to set in meta data
+	 * @entries [in/out]: the entries enqueued for the session
 	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
 	 */
-	doca_error_t add_egress_dst_ip6_entry(psp_session_t *session, int dst_vip_id);
+	doca_error_t add_egress_dst_ip6_entry(psp_session_t *session, int dst_vip_id, psp_session_entries *entries);
 
 	/**
 	 * Add entry to ipv6 source address pipe
 	 *
 	 * @session [in]: the session for which an decryption flow should be created
 	 * @dst_vip_id [in]: the hash of the destination vip to set in meta data
+	 * @entries [in/out]: the entries enqueued for the session
 	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
 	 */
-	doca_error_t add_ingress_src_ip6_entry(psp_session_t *session, int dst_vip_id);
+	doca_error_t add_ingress_src_ip6_entry(psp_session_t *session, int dst_vip_id, psp_session_entries *entries);
 
 	/**
 	 * Creates the pipe to mark and randomly sample outgoing packets
@@ -511,6 +684,17 @@ private:
 	// Sum of all static pipe entries the last time
 	// show_static_flow_counts() was invoked.
 	uint64_t prev_static_flow_count{UINT64_MAX};
+
+	// Entries enqueued by add_batch_entry() and not yet processed;
+	// must stay below the depth of the DOCA Flow queue.
+	static const uint32_t MAX_ENTRIES_PER_BATCH = 64;
+	uint32_t nb_batch_entries{};
+	std::vector<std::shared_ptr<entries_status>> batch_statuses;
+
+	// Statuses of entries still queued after their batch failed; their
+	// completions may arrive while processing a later batch, or are
+	// collected by process_inflight_entries().
+	std::vector<std::shared_ptr<entries_status>> orphan_statuses;
 };
 
 #endif /* _PSP_GW_FLOWS_H_ */
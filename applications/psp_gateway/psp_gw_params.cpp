@@ -340,6 +340,73 @@ static doca_error_t handle_max_tunnels_param(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/**
+ * @brief Configures the idle time after which a tunnel is torn down.
+ *
+ * @param [in]: A pointer to the parameter
+ * @config [in/out]: A void pointer to the application config struct
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t handle_idle_timeout_param(void *param, void *config)
+{
+	auto *app_config = (struct psp_gw_app_config *)config;
+	int *int_param = (int *)param;
+	if (*int_param < 0) {
+		DOCA_LOG_ERR("The idle timeout (idle-timeout) must not be negative, instead received: %d", *int_param);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	app_config->idle_timeout_sec = *int_param;
+	DOCA_LOG_INFO("Configured idle-timeout = %d", app_config->idle_timeout_sec);
+
+	return DOCA_SUCCESS;
+}
+
+/**
+ * @brief Configures the number of rounds of the crypto_id churn check.
+ *
+ * @param [in]: A pointer to the parameter
+ * @config [in/out]: A void pointer to the application config struct
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t handle_crypto_id_churn_param(void *param, void *config)
+{
+	auto *app_config = (struct psp_gw_app_config *)config;
+	int *int_param = (int *)param;
+	if (*int_param < 0) {
+		DOCA_LOG_ERR("The number of churn rounds (crypto-id-churn) must not be negative, instead received: %d",
+			     *int_param);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	app_config->crypto_id_churn_rounds = *int_param;
+	DOCA_LOG_INFO("Configured crypto-id-churn = %d", app_config->crypto_id_churn_rounds);
+
+	return DOCA_SUCCESS;
+}
+
+/**
+ * @brief Configures the number of tunnels of the tunnel setup benchmark.
+ *
+ * @param [in]: A pointer to the parameter
+ * @config [in/out]: A void pointer to the application config struct
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t handle_bench_tunnels_param(void *param, void *config)
+{
+	auto *app_config = (struct psp_gw_app_config *)config;
+	int *int_param = (int *)param;
+	if (*int_param < 0) {
+		DOCA_LOG_ERR("The tunnel count (bench-tunnels) must not be negative, instead received: %d", *int_param);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	app_config->bench_tunnels = *int_param;
+	DOCA_LOG_INFO("Configured bench-tunnels = %d", app_config->bench_tunnels);
+
+	return DOCA_SUCCESS;
+}
+
 /**
  * @brief Configures the PSP crypt-offset.
  *
@@ -1301,6 +1368,36 @@ static doca_error_t psp_gw_register_params(void)
 	if (result != DOCA_SUCCESS)
 		return result;
 
+	result = psp_gw_register_single_param(nullptr,
+					      "idle-timeout",
+					      "Tear down tunnels without egress traffic for this many seconds (0: never, default)",
+					      handle_idle_timeout_param,
+					      DOCA_ARGP_TYPE_INT,
+					      false,
+					      false);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = psp_gw_register_single_param(nullptr,
+					      "crypto-id-churn",
+					      "Check for crypto_id leaks over N tunnel create/destroy rounds and exit",
+					      handle_crypto_id_churn_param,
+					      DOCA_ARGP_TYPE_INT,
+					      false,
+					      false);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	result = psp_gw_register_single_param(nullptr,
+					      "bench-tunnels",
+					      "Measure the setup rate of N tunnels per request size and exit",
+					      handle_bench_tunnels_param,
+					      DOCA_ARGP_TYPE_INT,
+					      false,
+					      false);
+	if (result != DOCA_SUCCESS)
+		return result;
+
 	result = psp_gw_register_single_param("o",
 					      "crypt-offset",
 					      "Specify the PSP crypt offset",
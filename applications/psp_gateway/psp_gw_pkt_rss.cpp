@@ -144,11 +144,18 @@ int lcore_pkt_proc_func(void *lcore_args)
 
 	uint16_t queue_id = lcore_id - 1;
 
+	// A single L-Core completes the tunnel requests, so their flows are not
+	// inserted by all the L-Cores contending for sessions_mutex
+	bool poll_tunnel_responses = lcore_id == rte_get_next_lcore(-1, 1, 0);
+
 	struct rte_mbuf *rx_packets[MAX_RX_BURST_SIZE];
 
 	double tsc_to_seconds = 1.0 / (double)rte_get_timer_hz();
 
-	DOCA_LOG_INFO("L-Core %d polling queue %d (all ports)", lcore_id, queue_id);
+	DOCA_LOG_INFO("L-Core %d polling queue %d (all ports)%s",
+		      lcore_id,
+		      queue_id,
+		      poll_tunnel_responses ? " and tunnel responses" : "");
 
 	while (!*params->force_quit) {
 		uint16_t port_id = params->pf_dev->port_id;
@@ -156,6 +163,9 @@ int lcore_pkt_proc_func(void *lcore_args)
 
 		uint16_t nb_rx_packets = rte_eth_rx_burst(port_id, queue_id, rx_packets, MAX_RX_BURST_SIZE);
 
+		if (poll_tunnel_responses)
+			params->psp_svc->poll_tunnel_responses();
+
 		if (!nb_rx_packets)
 			continue;
 
@@ -51,6 +51,7 @@ struct lcore_params {
  * Note multiple such packets may be received during the
  * creation of the tunnel; in any case, they will be resubmitted
  * to the encryption pipeline once the new flow has been created.
+ * The first worker L-Core also completes the tunnel requests.
  *
  * @lcore_args [in]: a pointer to an lcore_params struct
  * @return: 0 on success (the main loop exited normally), negative value otherwise
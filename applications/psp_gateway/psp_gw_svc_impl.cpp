@@ -23,11 +23,16 @@
  *
  */
 
+#include <algorithm>
 #include <arpa/inet.h>
+#include <unistd.h>
 
+#include <grpc/support/time.h>
 #include <grpcpp/client_context.h>
 #include <grpcpp/create_channel.h>
 
+#include <rte_mbuf.h>
+
 #include <doca_flow_crypto.h>
 #include <doca_log.h>
 
@@ -47,6 +52,27 @@ PSP_GatewayImpl::PSP_GatewayImpl(psp_gw_app_config *config, PSP_GatewayFlows *ps
 {
 }
 
+PSP_GatewayImpl::~PSP_GatewayImpl(void)
+{
+	void *tag;
+	bool ok;
+
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex);
+		for (auto &pending : pending_requests)
+			pending.second->context.TryCancel();
+	}
+	client_cq.Shutdown();
+	while (client_cq.Next(&tag, &ok))
+		;
+
+	for (auto &pending : pending_requests) {
+		for (struct rte_mbuf *packet : pending.second->held_packets)
+			rte_pktmbuf_free(packet);
+	}
+	pending_requests.clear();
+}
+
 doca_error_t PSP_GatewayImpl::handle_miss_packet(struct rte_mbuf *packet)
 {
 	std::string dst_vip;
@@ -82,7 +108,13 @@ doca_error_t PSP_GatewayImpl::handle_miss_packet(struct rte_mbuf *packet)
 	}
 
 	// Create the new tunnel instance, if one does not already exist
-	if (sessions.count({src_vip, dst_vip}) == 0) {
+	bool has_tunnel;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex);
+		auto session_iter = sessions.find({src_vip, dst_vip});
+		has_tunnel = session_iter != sessions.end() && session_iter->second.encap_encrypt_entry;
+	}
+	if (!has_tunnel) {
 		// Determine the peer which owns the virtual destination
 		struct ip_pair vip_pair = {src_vip_addr, dst_vip_addr};
 		auto *peer = lookup_vip_pair(vip_pair);
@@ -91,13 +123,11 @@ doca_error_t PSP_GatewayImpl::handle_miss_packet(struct rte_mbuf *packet)
 			return DOCA_ERROR_NOT_FOUND;
 		}
 
-		doca_error_t result = request_tunnel_to_host(peer, &vip_pair, true, false, true);
-		if (result != DOCA_SUCCESS) {
-			return result;
-		}
+		// The packet is held and resubmitted once the peer responds
+		return request_tunnel_async(peer, &vip_pair, {src_vip, dst_vip}, packet);
 	}
 
-	// A new tunnel was created; we can now resubmit the packet
+	// The tunnel was created meanwhile; we can now resubmit the packet
 	// and it will be encrypted and sent to the right port.
 	if (!reinject_packet(packet, pf->port_id)) {
 		DOCA_LOG_ERR("Failed to resubmit packet from vnet addr %s to %s on port %d",
@@ -114,6 +144,193 @@ doca_error_t PSP_GatewayImpl::request_tunnel_to_host(struct psp_gw_peer *peer,
 						     bool supply_reverse_params,
 						     bool suppress_failure_msg,
 						     bool has_vip_pair)
+{
+	::grpc::ClientContext context;
+	::psp_gateway::MultiTunnelRequest request;
+	::psp_gateway::MultiTunnelResponse response;
+	uint64_t start_time = rte_get_tsc_cycles();
+	int vip_pair_id;
+
+	doca_error_t result =
+		build_tunnel_request(peer, vip_pair, supply_reverse_params, has_vip_pair, request, &vip_pair_id);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	auto *stub = get_stub(peer->svc_addr);
+	::grpc::Status status = stub->RequestMultipleTunnelParams(&context, request, &response);
+
+	return process_tunnel_response(peer,
+				       vip_pair_id,
+				       supply_reverse_params,
+				       suppress_failure_msg,
+				       request,
+				       response,
+				       status,
+				       start_time);
+}
+
+doca_error_t PSP_GatewayImpl::request_tunnel_async(struct psp_gw_peer *peer,
+						   struct ip_pair *vip_pair,
+						   const session_key &vips,
+						   struct rte_mbuf *packet)
+{
+	std::lock_guard<std::mutex> lock(pending_mutex);
+
+	auto pending_iter = pending_requests.find(vips);
+	if (pending_iter != pending_requests.end()) {
+		// The tunnel is already being requested; resubmit the packet once it is created
+		hold_packet(pending_iter->second.get(), packet);
+		return DOCA_SUCCESS;
+	}
+
+	uint32_t &nb_inflight = inflight_per_peer[peer->svc_addr];
+	if (nb_inflight >= MAX_INFLIGHT_REQUESTS_PER_PEER) {
+		DOCA_LOG_DBG("Too many requests in flight to peer %s; dropping packet", peer->svc_addr.c_str());
+		request_stats.nb_dropped_peer_cap++;
+		return DOCA_ERROR_AGAIN;
+	}
+
+	auto pending = std::make_unique<pending_tunnel_request>();
+	pending->peer = peer;
+	pending->vips = vips;
+	pending->start_tsc = rte_get_tsc_cycles();
+
+	doca_error_t result = build_tunnel_request(peer, vip_pair, true, true, pending->request, &pending->vip_pair_id);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	pending->context.set_deadline(std::chrono::system_clock::now() +
+				      std::chrono::seconds(TUNNEL_REQUEST_TIMEOUT_SEC));
+	auto *stub = get_stub(peer->svc_addr);
+	pending->reader = stub->PrepareAsyncRequestMultipleTunnelParams(&pending->context, pending->request, &client_cq);
+	pending->reader->StartCall();
+	pending->reader->Finish(&pending->response, &pending->status, pending.get());
+
+	hold_packet(pending.get(), packet);
+	nb_inflight++;
+	pending_requests.emplace(vips, std::move(pending));
+
+	return DOCA_SUCCESS;
+}
+
+void PSP_GatewayImpl::hold_packet(pending_tunnel_request *pending, struct rte_mbuf *packet)
+{
+	if (pending->held_packets.size() >= MAX_HELD_PACKETS) {
+		request_stats.nb_dropped_held++;
+		return; // dropped; the sender is expected to retransmit
+	}
+
+	// The RSS loop frees the packet after this call returns
+	rte_mbuf_refcnt_update(packet, 1);
+	pending->held_packets.push_back(packet);
+}
+
+size_t PSP_GatewayImpl::poll_tunnel_responses(void)
+{
+	size_t nb_completed = 0;
+	void *tag;
+	bool ok;
+
+	while (client_cq.AsyncNext(&tag, &ok, gpr_time_0(GPR_CLOCK_MONOTONIC)) ==
+	       ::grpc::CompletionQueue::GOT_EVENT) {
+		std::unique_ptr<pending_tunnel_request> pending;
+		{
+			std::lock_guard<std::mutex> lock(pending_mutex);
+			auto pending_iter = pending_requests.find(((pending_tunnel_request *)tag)->vips);
+			pending = std::move(pending_iter->second);
+			pending_requests.erase(pending_iter);
+			inflight_per_peer[pending->peer->svc_addr]--;
+		}
+
+		doca_error_t result = process_tunnel_response(pending->peer,
+							      pending->vip_pair_id,
+							      true,
+							      false,
+							      pending->request,
+							      pending->response,
+							      pending->status,
+							      pending->start_tsc);
+		if (result == DOCA_SUCCESS) {
+			record_tunnel_latency(rte_get_tsc_cycles() - pending->start_tsc);
+		} else {
+			std::lock_guard<std::mutex> lock(pending_mutex);
+			request_stats.nb_failed++;
+		}
+
+		// A new tunnel was created; we can now resubmit the held packets
+		// and they will be encrypted and sent to the right port.
+		for (struct rte_mbuf *packet : pending->held_packets) {
+			if (result != DOCA_SUCCESS || !reinject_packet(packet, pf->port_id))
+				rte_pktmbuf_free(packet);
+		}
+		nb_completed++;
+	}
+
+	return nb_completed;
+}
+
+void PSP_GatewayImpl::record_tunnel_latency(uint64_t latency_tsc)
+{
+	uint64_t latency_us = latency_tsc * 1000000 / rte_get_tsc_hz();
+	int bucket = latency_us ? 63 - __builtin_clzll(latency_us) : 0;
+
+	std::lock_guard<std::mutex> lock(pending_mutex);
+	request_stats.nb_created++;
+	request_stats.total_latency_tsc += latency_tsc;
+	request_stats.max_latency_tsc = std::max(request_stats.max_latency_tsc, latency_tsc);
+	request_stats.latency_hist[std::min(bucket, LATENCY_BUCKETS - 1)]++;
+}
+
+double PSP_GatewayImpl::latency_percentile_ms(const tunnel_request_stats &stats, double percentile)
+{
+	uint64_t nb_samples = 0;
+
+	for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+		nb_samples += stats.latency_hist[bucket];
+		if (nb_samples >= percentile * stats.nb_created)
+			return 1e-3 * (2ULL << bucket); // upper bound of the bucket
+	}
+	return 1e-3 * (2ULL << (LATENCY_BUCKETS - 1));
+}
+
+void PSP_GatewayImpl::show_tunnel_request_stats(void)
+{
+	tunnel_request_stats stats;
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex);
+		stats = request_stats;
+	}
+
+	if (stats.nb_created == shown_request_stats.nb_created && stats.nb_failed == shown_request_stats.nb_failed &&
+	    stats.nb_dropped_peer_cap == shown_request_stats.nb_dropped_peer_cap &&
+	    stats.nb_dropped_held == shown_request_stats.nb_dropped_held)
+		return;
+	shown_request_stats = stats;
+
+	double tsc_to_ms = 1e3 / rte_get_tsc_hz();
+	if (stats.nb_created > 0) {
+		DOCA_LOG_INFO("Tunnels created from misses: %lu (%lu failed), latency avg %f ms, p50 < %f ms, "
+			      "p99 < %f ms, max %f ms",
+			      stats.nb_created,
+			      stats.nb_failed,
+			      tsc_to_ms * stats.total_latency_tsc / stats.nb_created,
+			      latency_percentile_ms(stats, 0.5),
+			      latency_percentile_ms(stats, 0.99),
+			      tsc_to_ms * stats.max_latency_tsc);
+	} else {
+		DOCA_LOG_INFO("Tunnels created from misses: 0 (%lu failed)", stats.nb_failed);
+	}
+	DOCA_LOG_INFO("Miss packets dropped: %lu at the per-peer request limit, %lu at the held packet limit",
+		      stats.nb_dropped_peer_cap,
+		      stats.nb_dropped_held);
+}
+
+doca_error_t PSP_GatewayImpl::build_tunnel_request(struct psp_gw_peer *peer,
+						   struct ip_pair *vip_pair,
+						   bool supply_reverse_params,
+						   bool has_vip_pair,
+						   ::psp_gateway::MultiTunnelRequest &request,
+						   int *vip_pair_id)
 {
 	doca_error_t result;
 	uint32_t key_len_bits = psp_version_to_key_length_bits(config->net_config.default_psp_proto_ver);
@@ -124,15 +341,14 @@ doca_error_t PSP_GatewayImpl::request_tunnel_to_host(struct psp_gw_peer *peer,
 
 	const std::string &peer_svc_pip = peer->svc_addr;
 	int spi_key_idx = 0;
-	int vip_pair_id = -1;
-
-	auto *stub = get_stub(peer_svc_pip);
 
-	::grpc::ClientContext context;
-	::psp_gateway::MultiTunnelRequest request;
+	*vip_pair_id = -1;
 	request.set_request_id(++next_request_id);
 	request.add_psp_versions_accepted(config->net_config.default_psp_proto_ver);
 
+	std::vector<psp_session_t *> acl_sessions;
+	std::unique_lock<std::mutex> acl_lock(sessions_mutex, std::defer_lock);
+
 	if (supply_reverse_params) {
 		result = generate_keys_spis(key_len_bits, nb_pairs, keys.data(), spis.data());
 		if (result != DOCA_SUCCESS) {
@@ -152,7 +368,7 @@ doca_error_t PSP_GatewayImpl::request_tunnel_to_host(struct psp_gw_peer *peer,
 			    !is_ip_equal(local_virt_ip, &vip_pair->src_vip))
 				continue;
 			else
-				vip_pair_id = vip_pair_idx;
+				*vip_pair_id = vip_pair_idx;
 		} else
 			spi_key_idx = vip_pair_idx;
 		std::string local_vip;
@@ -179,37 +395,53 @@ doca_error_t PSP_GatewayImpl::request_tunnel_to_host(struct psp_gw_peer *peer,
 				  key_len_bits / 8);
 
 			if (!config->disable_ingress_acl) {
+				if (!acl_lock.owns_lock())
+					acl_lock.lock();
 				auto &session = sessions[{local_vip, peer_vip}];
+				if (session.acl_inflight) {
+					DOCA_LOG_ERR("ACL entries of the previous tunnel to peer %s still queued",
+						     peer_svc_pip.c_str());
+					return DOCA_ERROR_IN_PROGRESS;
+				}
 				session.spi_ingress = single_request->reverse_params().spi();
 				copy_ip_addr(*local_virt_ip, session.src_vip);
 				copy_ip_addr(*peer_virt_ip, session.dst_vip);
 				session.pkt_count_ingress = UINT64_MAX;
-
-				result = psp_flows->add_ingress_acl_entry(&session);
-				if (result != DOCA_SUCCESS) {
-					DOCA_LOG_ERR("Failed to open ACL (%s <- %s) on SPI %d: %s",
-						     local_vip.c_str(),
-						     peer_vip.c_str(),
-						     session.spi_ingress,
-						     doca_error_get_descr(result));
-					return result;
-				}
-
-				DOCA_LOG_DBG("Opened ACL (%s <- %s) on SPI %d",
-					     local_vip.c_str(),
-					     peer_vip.c_str(),
-					     session.spi_ingress);
+				acl_sessions.push_back(&session);
 			}
 		}
 	}
 
-	if (has_vip_pair && vip_pair_id == -1) {
+	if (has_vip_pair && *vip_pair_id == -1) {
 		DOCA_LOG_ERR("Virtual IPs not found");
 		return DOCA_ERROR_NOT_FOUND;
 	}
 
-	::psp_gateway::MultiTunnelResponse response;
-	::grpc::Status status = stub->RequestMultipleTunnelParams(&context, request, &response);
+	if (!acl_sessions.empty()) {
+		std::vector<doca_error_t> acl_results;
+
+		result = add_ingress_acl_entries(acl_sessions, acl_results);
+		if (result != DOCA_SUCCESS)
+			return result;
+		for (doca_error_t acl_result : acl_results) {
+			if (acl_result != DOCA_SUCCESS)
+				return acl_result;
+		}
+	}
+	return DOCA_SUCCESS;
+}
+
+doca_error_t PSP_GatewayImpl::process_tunnel_response(struct psp_gw_peer *peer,
+						      int vip_pair_id,
+						      bool supply_reverse_params,
+						      bool suppress_failure_msg,
+						      const ::psp_gateway::MultiTunnelRequest &request,
+						      const ::psp_gateway::MultiTunnelResponse &response,
+						      const ::grpc::Status &status,
+						      uint64_t start_time)
+{
+	doca_error_t result;
+	const std::string &peer_svc_pip = peer->svc_addr;
 
 	if (!status.ok() || response.tunnels_params_size() != request.tunnels_size()) {
 		if (!suppress_failure_msg) {
@@ -220,8 +452,13 @@ doca_error_t PSP_GatewayImpl::request_tunnel_to_host(struct psp_gw_peer *peer,
 		return DOCA_ERROR_IO_FAILED;
 	}
 
+	std::lock_guard<std::mutex> lock(sessions_mutex);
 	std::vector<psp_session_and_key_t> new_session_keys;
+	doca_error_t first_failure = DOCA_SUCCESS;
+	int nb_failed = 0;
 	for (int i = 0; i < response.tunnels_params_size(); i++) {
+		int pair_id = vip_pair_id >= 0 ? vip_pair_id : i;
+
 		if (supply_reverse_params) {
 			if (response.tunnels_params(i).encap_type() !=
 			    request.tunnels(i).reverse_params().encap_type()) {
@@ -230,61 +467,152 @@ doca_error_t PSP_GatewayImpl::request_tunnel_to_host(struct psp_gw_peer *peer,
 				return DOCA_ERROR_INVALID_VALUE;
 			}
 		}
-		if (!has_vip_pair)
-			vip_pair_id = i;
+		if (i < response.tunnels_status_size() && response.tunnels_status(i) != DOCA_SUCCESS) {
+			// The peer could not create the flows of this tunnel; leave it to be requested again
+			result = (doca_error_t)response.tunnels_status(i);
+			DOCA_LOG_ERR("Peer %s failed to set up tunnel (%s -> %s): %s",
+				     peer_svc_pip.c_str(),
+				     ip_to_string(peer->vip_pairs[pair_id].src_vip).c_str(),
+				     ip_to_string(peer->vip_pairs[pair_id].dst_vip).c_str(),
+				     doca_error_get_descr(result));
+			if (first_failure == DOCA_SUCCESS)
+				first_failure = result;
+			nb_failed++;
+			continue;
+		}
 		result = prepare_session(peer_svc_pip,
-					 peer->vip_pairs[vip_pair_id],
+					 peer->vip_pairs[pair_id],
 					 response.tunnels_params(i),
 					 new_session_keys);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to prepare session for peer %s, request %ld: (%s -> %s): %s",
 				     peer_svc_pip.c_str(),
 				     request.request_id(),
-				     ip_to_string(peer->vip_pairs[i].src_vip).c_str(),
-				     ip_to_string(peer->vip_pairs[i].dst_vip).c_str(),
+				     ip_to_string(peer->vip_pairs[pair_id].src_vip).c_str(),
+				     ip_to_string(peer->vip_pairs[pair_id].dst_vip).c_str(),
 				     doca_error_get_descr(result));
 			return result;
 		}
 	}
-	result = add_encrypt_entries(new_session_keys, peer_svc_pip);
+	std::vector<doca_error_t> encrypt_results;
+	result = add_encrypt_entries(new_session_keys, peer_svc_pip, encrypt_results);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to add encrypt entries for peer %s: %s",
 			     peer_svc_pip.c_str(),
 			     doca_error_get_descr(result));
 		return result;
 	}
+	for (doca_error_t encrypt_result : encrypt_results) {
+		if (encrypt_result == DOCA_SUCCESS)
+			continue;
+		if (first_failure == DOCA_SUCCESS)
+			first_failure = encrypt_result;
+		nb_failed++;
+	}
 
-	return DOCA_SUCCESS;
+	show_tunnel_setup_rate(request.request_id(), response.tunnels_params_size(), nb_failed, start_time);
+
+	return first_failure;
 }
 
 doca_error_t PSP_GatewayImpl::add_encrypt_entries(std::vector<psp_session_and_key_t> &new_sessions_keys,
-						  std::string peer_svc_addr)
+						  std::string peer_svc_addr,
+						  std::vector<doca_error_t> &results)
 {
 	DOCA_LOG_DBG("Adding %d encrypt entries for peer %s", (int)new_sessions_keys.size(), peer_svc_addr.c_str());
 
 	uint64_t start_time = rte_get_tsc_cycles();
-	for (int i = 0; i < (int)new_sessions_keys.size(); i++) {
-		doca_error_t result =
-			psp_flows->add_encrypt_entry(new_sessions_keys[i].first, new_sessions_keys[i].second);
-		if (result != DOCA_SUCCESS) {
-			DOCA_LOG_ERR("Failed to add encrypt entry for %s: %s",
-				     peer_svc_addr.c_str(),
-				     doca_error_get_descr(result));
-			return result;
+	doca_error_t result = psp_flows->add_encrypt_entries(new_sessions_keys, results);
+	int nb_failed = 0;
+	for (size_t i = 0; i < results.size(); i++) {
+		if (results[i] == DOCA_SUCCESS)
+			continue;
+		if (results[i] == DOCA_ERROR_IN_PROGRESS) {
+			// The session keeps its entries and crypto_id until complete_inflight_sessions()
+			DOCA_LOG_WARN("Encrypt entry for %s on SPI %d still queued",
+				      peer_svc_addr.c_str(),
+				      new_sessions_keys[i].first->spi_egress);
+			nb_inflight_flows++;
+			nb_failed++;
+			continue;
 		}
+		DOCA_LOG_ERR("Failed to add encrypt entry for %s on SPI %d: %s",
+			     peer_svc_addr.c_str(),
+			     new_sessions_keys[i].first->spi_egress,
+			     doca_error_get_descr(results[i]));
+		// The crypto_id of a session left without an encryption flow is not in use
+		release_crypto_id(new_sessions_keys[i].first->crypto_id);
+		nb_failed++;
 	}
+	if (result != DOCA_SUCCESS)
+		return result;
+
 	uint64_t end_time = rte_get_tsc_cycles();
 	double total_time = (end_time - start_time) / (double)rte_get_tsc_hz();
 	double kilo_eps = 1e-3 * new_sessions_keys.size() / total_time;
 	if (config->print_perf_flags & PSP_PERF_INSERTION_PRINT) {
-		DOCA_LOG_INFO("Added %d encrypt entries in %f seconds, %f Kilo-EPS",
+		DOCA_LOG_INFO("Added %d encrypt entries (%d failed) in %f seconds, %f Kilo-EPS",
 			      (int)new_sessions_keys.size(),
+			      nb_failed,
 			      total_time,
 			      kilo_eps);
 	}
 	return DOCA_SUCCESS;
 }
 
+doca_error_t PSP_GatewayImpl::add_ingress_acl_entries(std::vector<psp_session_t *> &acl_sessions,
+						      std::vector<doca_error_t> &results)
+{
+	doca_error_t result = psp_flows->add_ingress_acl_entries(acl_sessions, results);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to add %d ACL entries: %s", (int)acl_sessions.size(), doca_error_get_descr(result));
+		return result;
+	}
+
+	for (size_t i = 0; i < acl_sessions.size(); i++) {
+		std::string local_vip = ip_to_string(acl_sessions[i]->src_vip);
+		std::string peer_vip = ip_to_string(acl_sessions[i]->dst_vip);
+
+		if (results[i] == DOCA_ERROR_IN_PROGRESS) {
+			// Completed by complete_inflight_sessions()
+			DOCA_LOG_WARN("ACL (%s <- %s) on SPI %d still queued",
+				      local_vip.c_str(),
+				      peer_vip.c_str(),
+				      acl_sessions[i]->spi_ingress);
+			nb_inflight_flows++;
+			continue;
+		}
+		if (results[i] != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to open ACL (%s <- %s) on SPI %d: %s",
+				     local_vip.c_str(),
+				     peer_vip.c_str(),
+				     acl_sessions[i]->spi_ingress,
+				     doca_error_get_descr(results[i]));
+			continue;
+		}
+		DOCA_LOG_DBG("Opened ACL (%s <- %s) on SPI %d",
+			     local_vip.c_str(),
+			     peer_vip.c_str(),
+			     acl_sessions[i]->spi_ingress);
+	}
+	return DOCA_SUCCESS;
+}
+
+void PSP_GatewayImpl::show_tunnel_setup_rate(uint64_t request_id, int nb_tunnels, int nb_failed, uint64_t start_tsc)
+{
+	if (!(config->print_perf_flags & PSP_PERF_INSERTION_PRINT))
+		return;
+
+	double total_time = (rte_get_tsc_cycles() - start_tsc) / (double)rte_get_tsc_hz();
+	double kilo_tps = 1e-3 * (nb_tunnels - nb_failed) / total_time;
+	DOCA_LOG_INFO("Request %lu: set up %d tunnels (%d failed) in %f seconds, %f Kilo-TPS",
+		      request_id,
+		      nb_tunnels,
+		      nb_failed,
+		      total_time,
+		      kilo_tps);
+}
+
 doca_error_t PSP_GatewayImpl::prepare_session(std::string peer_svc_addr,
 					      struct ip_pair &vip_pair,
 					      const psp_gateway::TunnelParameters &params,
@@ -309,12 +637,27 @@ doca_error_t PSP_GatewayImpl::prepare_session(std::string peer_svc_addr,
 		return DOCA_ERROR_IO_FAILED;
 	}
 
+	session_key session_pair = {local_vip, peer_vip};
+	auto session_iter = sessions.find(session_pair);
+	if (session_iter != sessions.end() && session_iter->second.encrypt_inflight) {
+		// Its crypto_id is released once the queued entries complete
+		DOCA_LOG_ERR("Encrypt entries of the previous tunnel to peer %s still queued", peer_svc_addr.c_str());
+		return DOCA_ERROR_IN_PROGRESS;
+	}
+	if (session_iter != sessions.end() && session_iter->second.encap_encrypt_entry) {
+		// The tunnel is being re-established; give back the crypto_id of the previous flow
+		doca_error_t result = remove_encrypt_entry(&session_iter->second);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to remove previous encrypt entry for peer %s", peer_svc_addr.c_str());
+			return result;
+		}
+	}
+
 	uint32_t crypto_id = next_crypto_id();
 	if (crypto_id == UINT32_MAX) {
 		DOCA_LOG_ERR("Exhausted available crypto_ids; cannot complete new tunnel");
 		return DOCA_ERROR_NO_MEMORY;
 	}
-	session_key session_pair = {local_vip, peer_vip};
 	auto &session = sessions[session_pair];
 	session.dst_vip = vip_pair.dst_vip; // allready set if other direction was supplied
 	session.src_vip = vip_pair.src_vip; // allready set if other direction was supplied
@@ -322,11 +665,14 @@ doca_error_t PSP_GatewayImpl::prepare_session(std::string peer_svc_addr,
 	session.crypto_id = crypto_id;
 	session.psp_proto_ver = params.psp_version();
 	session.vc = params.virt_cookie();
+	session.idle_pkt_count_egress = 0;
+	session.last_active_tsc = rte_get_tsc_cycles();
 	void *enc_key = (void *)params.encryption_key().c_str();
 
 	if (rte_ether_unformat_addr(params.mac_addr().c_str(), &session.dst_mac)) {
 		DOCA_LOG_ERR("Failed to convert mac addr: %s", params.mac_addr().c_str());
 		sessions.erase(session_pair);
+		release_crypto_id(crypto_id);
 		return DOCA_ERROR_INVALID_VALUE;
 	}
 
@@ -334,6 +680,7 @@ doca_error_t PSP_GatewayImpl::prepare_session(std::string peer_svc_addr,
 	if (parse_ip_addr(params.ip_addr(), enforce_l3_type, &session.dst_pip) != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to parse dst_pip %s", params.ip_addr().c_str());
 		sessions.erase(session_pair);
+		release_crypto_id(crypto_id);
 		return DOCA_ERROR_INVALID_VALUE;
 	}
 	sessions_keys_prepared.push_back({&session, enc_key});
@@ -386,7 +733,16 @@ int PSP_GatewayImpl::select_psp_version(const ::psp_gateway::MultiTunnelRequest
 
 	response->set_request_id(request->request_id());
 
+	uint64_t start_time = rte_get_tsc_cycles();
+	std::lock_guard<std::mutex> lock(sessions_mutex);
 	std::vector<psp_session_and_key_t> reversed_sessions_keys;
+	std::vector<int> reversed_tun_idx;
+	std::vector<psp_session_t *> acl_sessions;
+	std::vector<int> acl_tun_idx;
+
+	// The flows of all the tunnels are inserted in one batch each; a tunnel
+	// whose flows failed is reported in its tunnels_status.
+	std::vector<doca_error_t> tunnels_status(request->tunnels_size(), DOCA_SUCCESS);
 
 	for (int tun_idx = 0; tun_idx < request->tunnels_size(); tun_idx++) {
 		const ::psp_gateway::SingleTunnelRequest &single_request = request->tunnels(tun_idx);
@@ -416,25 +772,17 @@ int PSP_GatewayImpl::select_psp_version(const ::psp_gateway::MultiTunnelRequest
 
 		if (!config->disable_ingress_acl) {
 			auto &session = sessions[{local_vip_str, peer_vip_str}];
-			session.spi_ingress = params->spi();
-			copy_ip_addr(local_vip, session.src_vip);
-			copy_ip_addr(peer_vip, session.dst_vip);
-			session.pkt_count_ingress = UINT64_MAX;
-
-			result = psp_flows->add_ingress_acl_entry(&session);
-			if (result != DOCA_SUCCESS) {
-				DOCA_LOG_ERR("Failed to open ACL (%s <- %s) on SPI %d: %s",
-					     local_vip_str.c_str(),
-					     peer_vip_str.c_str(),
-					     session.spi_ingress,
-					     doca_error_get_descr(result));
-				return ::grpc::Status(grpc::INTERNAL, "Failed to create ingress ACL session flow");
+			if (session.acl_inflight) {
+				// The previous ACL entries are still queued; let the peer request again
+				tunnels_status[tun_idx] = DOCA_ERROR_IN_PROGRESS;
+			} else {
+				session.spi_ingress = params->spi();
+				copy_ip_addr(local_vip, session.src_vip);
+				copy_ip_addr(peer_vip, session.dst_vip);
+				session.pkt_count_ingress = UINT64_MAX;
+				acl_sessions.push_back(&session);
+				acl_tun_idx.push_back(tun_idx);
 			}
-
-			DOCA_LOG_DBG("Opened ACL (%s <- %s) on SPI %d",
-				     local_vip_str.c_str(),
-				     peer_vip_str.c_str(),
-				     session.spi_ingress);
 		}
 
 		if (single_request.has_reverse_params()) {
@@ -455,24 +803,46 @@ int PSP_GatewayImpl::select_psp_version(const ::psp_gateway::MultiTunnelRequest
 						      "Failed to prepare session for peer " +
 							      std::to_string(request->request_id()));
 			}
-			DOCA_LOG_DBG("Created return flow (%s -> %s) on SPI %d to peer %s",
-				     local_vip_str.c_str(),
-				     peer_vip_str.c_str(),
-				     single_request.reverse_params().spi(),
-				     peer.c_str());
+			reversed_tun_idx.push_back(tun_idx);
+		}
+	}
+
+	if (acl_sessions.size() > 0) {
+		std::vector<doca_error_t> acl_results;
+
+		result = add_ingress_acl_entries(acl_sessions, acl_results);
+		if (result != DOCA_SUCCESS)
+			return ::grpc::Status(grpc::INTERNAL, "Failed to create ingress ACL session flows");
+		for (size_t i = 0; i < acl_results.size(); i++) {
+			if (acl_results[i] != DOCA_SUCCESS)
+				tunnels_status[acl_tun_idx[i]] = acl_results[i];
 		}
 	}
 
 	if (reversed_sessions_keys.size() > 0) {
-		result = add_encrypt_entries(reversed_sessions_keys, peer);
+		std::vector<doca_error_t> encrypt_results;
+
+		result = add_encrypt_entries(reversed_sessions_keys, peer, encrypt_results);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to add encrypt entries for peer %s: %s",
 				     peer.c_str(),
 				     doca_error_get_descr(result));
 			return ::grpc::Status(grpc::INTERNAL, "Failed to create encrypt entries");
 		}
+		for (size_t i = 0; i < encrypt_results.size(); i++) {
+			if (encrypt_results[i] != DOCA_SUCCESS && tunnels_status[reversed_tun_idx[i]] == DOCA_SUCCESS)
+				tunnels_status[reversed_tun_idx[i]] = encrypt_results[i];
+		}
 	}
 
+	int nb_failed = 0;
+	for (doca_error_t tunnel_status : tunnels_status) {
+		response->add_tunnels_status(tunnel_status);
+		if (tunnel_status != DOCA_SUCCESS)
+			nb_failed++;
+	}
+	show_tunnel_setup_rate(request->request_id(), request->tunnels_size(), nb_failed, start_time);
+
 	return ::grpc::Status::OK;
 }
 
@@ -588,20 +958,362 @@ psp_gw_peer *PSP_GatewayImpl::lookup_vip_pair(ip_pair &vip_pair)
 
 doca_error_t PSP_GatewayImpl::show_flow_counts(void)
 {
+	std::lock_guard<std::mutex> lock(sessions_mutex);
 	for (auto &session : sessions) {
 		psp_flows->show_session_flow_count(session.first, session.second);
 	}
 	return DOCA_SUCCESS;
 }
 
+size_t PSP_GatewayImpl::remove_idle_sessions(void)
+{
+	if (config->idle_timeout_sec == 0)
+		return 0;
+
+	std::lock_guard<std::mutex> lock(sessions_mutex);
+	uint64_t now = rte_get_tsc_cycles();
+	uint64_t idle_timeout_tsc = config->idle_timeout_sec * rte_get_tsc_hz();
+	size_t nb_removed = 0;
+
+	for (auto session_iter = sessions.begin(); session_iter != sessions.end(); /* increment below */) {
+		psp_session_t &session = session_iter->second;
+		uint64_t pkt_count;
+
+		// The flows of a session are not torn down while some of its entries are queued
+		if (session.encrypt_inflight || session.acl_inflight ||
+		    psp_flows->query_encrypt_pkt_count(&session, &pkt_count) != DOCA_SUCCESS) {
+			++session_iter;
+			continue;
+		}
+
+		if (pkt_count != session.idle_pkt_count_egress) {
+			session.idle_pkt_count_egress = pkt_count;
+			session.last_active_tsc = now;
+			++session_iter;
+			continue;
+		}
+
+		if (now - session.last_active_tsc < idle_timeout_tsc || remove_encrypt_entry(&session) != DOCA_SUCCESS) {
+			++session_iter;
+			continue;
+		}
+
+		DOCA_LOG_DBG("Removed idle session (%s -> %s)",
+			     session_iter->first.first.c_str(),
+			     session_iter->first.second.c_str());
+		++nb_removed;
+
+		// Keep the session while it still accepts traffic from the peer
+		if (session.acl_entry)
+			++session_iter;
+		else
+			session_iter = sessions.erase(session_iter);
+	}
+
+	if (nb_removed > 0) {
+		nb_idle_sessions_removed += nb_removed;
+		DOCA_LOG_INFO("Removed %zu idle sessions (%lu since startup), %zu crypto_ids available",
+			      nb_removed,
+			      nb_idle_sessions_removed,
+			      nb_free_crypto_ids());
+	}
+
+	return nb_removed;
+}
+
+size_t PSP_GatewayImpl::complete_inflight_sessions(void)
+{
+	std::lock_guard<std::mutex> lock(sessions_mutex);
+	size_t nb_completed = 0;
+
+	if (nb_inflight_flows == 0)
+		return 0;
+
+	psp_flows->process_inflight_entries();
+
+	for (auto &session_iter : sessions) {
+		psp_session_t &session = session_iter.second;
+		doca_error_t result;
+
+		if (session.encrypt_inflight) {
+			result = psp_flows->complete_inflight_encrypt_entry(&session);
+			if (result != DOCA_ERROR_IN_PROGRESS) {
+				if (result != DOCA_SUCCESS) {
+					DOCA_LOG_ERR("Queued encrypt entry (%s -> %s) failed: %s",
+						     session_iter.first.first.c_str(),
+						     session_iter.first.second.c_str(),
+						     doca_error_get_descr(result));
+					release_crypto_id(session.crypto_id);
+				}
+				nb_inflight_flows--;
+				nb_completed++;
+			}
+		}
+
+		if (session.acl_inflight) {
+			result = psp_flows->complete_inflight_acl_entry(&session);
+			if (result != DOCA_ERROR_IN_PROGRESS) {
+				if (result != DOCA_SUCCESS)
+					DOCA_LOG_ERR("Queued ACL entry (%s <- %s) failed: %s",
+						     session_iter.first.first.c_str(),
+						     session_iter.first.second.c_str(),
+						     doca_error_get_descr(result));
+				nb_inflight_flows--;
+				nb_completed++;
+			}
+		}
+	}
+
+	return nb_completed;
+}
+
+doca_error_t PSP_GatewayImpl::create_test_tunnels(uint32_t first_idx,
+						  uint32_t nb_tunnels,
+						  uint64_t request_id,
+						  std::vector<session_key> &vips,
+						  uint32_t *nb_failed)
+{
+	uint32_t psp_ver = config->net_config.default_psp_proto_ver;
+	uint32_t key_len_bits = psp_version_to_key_length_bits(psp_ver);
+	uint32_t key_len_words = key_len_bits / 32;
+	std::vector<uint32_t> keys(nb_tunnels * key_len_words);
+	std::vector<uint32_t> spis(nb_tunnels);
+	::psp_gateway::MultiTunnelRequest request;
+	::psp_gateway::MultiTunnelResponse response;
+
+	*nb_failed = nb_tunnels;
+	if (first_idx + nb_tunnels > MAX_TEST_TUNNELS) {
+		DOCA_LOG_ERR("Cannot create more than %u test tunnels", MAX_TEST_TUNNELS);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	doca_error_t result = generate_keys_spis(key_len_bits, nb_tunnels, keys.data(), spis.data());
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	request.set_request_id(request_id);
+	request.add_psp_versions_accepted(psp_ver);
+	for (uint32_t i = 0; i < nb_tunnels; i++) {
+		struct doca_flow_ip_addr peer_vip = {};
+		struct doca_flow_ip_addr local_vip = {};
+
+		peer_vip.type = local_vip.type = DOCA_FLOW_L3_TYPE_IP4;
+		peer_vip.ipv4_addr = htonl(TEST_PEER_VIP_BASE + first_idx + i);
+		local_vip.ipv4_addr = htonl(TEST_LOCAL_VIP_BASE + first_idx + i);
+
+		// As sent by the peer: its VIP is the source
+		::psp_gateway::SingleTunnelRequest *single_request = request.add_tunnels();
+		single_request->set_inner_type(4);
+		single_request->set_virt_src_ip(ip_to_string(peer_vip));
+		single_request->set_virt_dst_ip(ip_to_string(local_vip));
+		fill_tunnel_params(psp_ver,
+				   &keys[i * key_len_words],
+				   spis[i],
+				   single_request->mutable_reverse_params());
+		vips.push_back({single_request->virt_dst_ip(), single_request->virt_src_ip()});
+	}
+
+	::grpc::Status status = RequestMultipleTunnelParams(nullptr, &request, &response);
+	if (!status.ok()) {
+		DOCA_LOG_ERR("Failed to create %u test tunnels: %s", nb_tunnels, status.error_message().c_str());
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	for (int retry = 0; retry < TEST_INFLIGHT_RETRIES; retry++) {
+		{
+			std::lock_guard<std::mutex> lock(sessions_mutex);
+			if (nb_inflight_flows == 0)
+				break;
+		}
+		complete_inflight_sessions();
+		usleep(1000);
+	}
+
+	*nb_failed = 0;
+	for (int i = 0; i < response.tunnels_status_size(); i++) {
+		if (response.tunnels_status(i) != DOCA_SUCCESS)
+			(*nb_failed)++;
+	}
+	return DOCA_SUCCESS;
+}
+
+doca_error_t PSP_GatewayImpl::destroy_test_tunnels(const std::vector<session_key> &vips)
+{
+	std::lock_guard<std::mutex> lock(sessions_mutex);
+	doca_error_t result = DOCA_SUCCESS;
+
+	for (const session_key &session_pair : vips) {
+		auto session_iter = sessions.find(session_pair);
+		if (session_iter == sessions.end())
+			continue;
+
+		psp_session_t &session = session_iter->second;
+		if (session.encrypt_inflight || session.acl_inflight) {
+			DOCA_LOG_ERR("Cannot destroy test tunnel (%s -> %s); entries still queued",
+				     session_pair.first.c_str(),
+				     session_pair.second.c_str());
+			result = DOCA_ERROR_IN_PROGRESS;
+			continue;
+		}
+		if (session.encap_encrypt_entry && remove_encrypt_entry(&session) != DOCA_SUCCESS) {
+			result = DOCA_ERROR_BAD_STATE;
+			continue;
+		}
+		if (session.acl_entry && psp_flows->remove_ingress_acl_entry(&session) != DOCA_SUCCESS) {
+			result = DOCA_ERROR_BAD_STATE;
+			continue;
+		}
+		sessions.erase(session_iter);
+	}
+	return result;
+}
+
+doca_error_t PSP_GatewayImpl::check_crypto_id_churn(uint32_t nb_rounds)
+{
+	uint32_t nb_tunnels = std::min(config->max_tunnels, MAX_TEST_TUNNELS);
+	std::vector<session_key> vips;
+	size_t nb_free_start;
+
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex);
+		nb_free_start = nb_free_crypto_ids();
+	}
+
+	DOCA_LOG_INFO("Checking crypto_id churn: %u rounds of %u tunnels, %zu crypto_ids available",
+		      nb_rounds,
+		      nb_tunnels,
+		      nb_free_start);
+
+	for (uint32_t round = 0; round < nb_rounds; round++) {
+		uint32_t nb_failed;
+
+		// Tunnels which failed still hold sessions, and must not hold crypto_ids
+		vips.clear();
+		doca_error_t create_result = create_test_tunnels(0, nb_tunnels, round + 1, vips, &nb_failed);
+		doca_error_t result = destroy_test_tunnels(vips);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Round %u: failed to destroy test tunnels: %s",
+				     round,
+				     doca_error_get_descr(result));
+			return result;
+		}
+
+		std::lock_guard<std::mutex> lock(sessions_mutex);
+		size_t nb_free = nb_free_crypto_ids();
+		if (nb_free != nb_free_start) {
+			DOCA_LOG_ERR("Round %u (%s): %zu crypto_ids available, expected %zu",
+				     round,
+				     doca_error_get_descr(create_result),
+				     nb_free,
+				     nb_free_start);
+			return DOCA_ERROR_BAD_STATE;
+		}
+		DOCA_LOG_DBG("Round %u (%s, %u tunnels failed): all crypto_ids returned",
+			     round,
+			     doca_error_get_descr(create_result),
+			     nb_failed);
+	}
+
+	DOCA_LOG_INFO("Crypto_id churn check passed: %zu crypto_ids available", nb_free_start);
+	return DOCA_SUCCESS;
+}
+
+doca_error_t PSP_GatewayImpl::benchmark_tunnel_setup(uint32_t nb_tunnels)
+{
+	uint64_t tsc_hz = rte_get_tsc_hz();
+	uint64_t request_id = 0;
+	doca_error_t result = DOCA_SUCCESS;
+
+	if (nb_tunnels > std::min(config->max_tunnels, MAX_TEST_TUNNELS)) {
+		DOCA_LOG_ERR("Cannot benchmark %u tunnels; max-tunnels is %u", nb_tunnels, config->max_tunnels);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	DOCA_LOG_INFO("Benchmarking the setup of %u tunnels per request size", nb_tunnels);
+
+	for (uint32_t request_size = 1;; request_size = std::min(request_size * BENCH_REQUEST_SIZE_STEP, nb_tunnels)) {
+		std::vector<session_key> vips;
+		uint32_t nb_failed = 0;
+		uint64_t max_request_tsc = 0;
+		uint64_t start_tsc = rte_get_tsc_cycles();
+
+		for (uint32_t first_idx = 0; first_idx < nb_tunnels; first_idx += request_size) {
+			uint32_t nb_request_failed;
+			uint64_t request_tsc = rte_get_tsc_cycles();
+
+			result = create_test_tunnels(first_idx,
+						     std::min(request_size, nb_tunnels - first_idx),
+						     ++request_id,
+						     vips,
+						     &nb_request_failed);
+			if (result != DOCA_SUCCESS)
+				break;
+			max_request_tsc = std::max(max_request_tsc, rte_get_tsc_cycles() - request_tsc);
+			nb_failed += nb_request_failed;
+		}
+
+		double total_time = (rte_get_tsc_cycles() - start_tsc) / (double)tsc_hz;
+		if (result == DOCA_SUCCESS) {
+			DOCA_LOG_INFO("Request size %u: set up %u tunnels (%u failed) in %f seconds, %f Kilo-TPS, "
+				      "max %f ms per request",
+				      request_size,
+				      nb_tunnels,
+				      nb_failed,
+				      total_time,
+				      1e-3 * (nb_tunnels - nb_failed) / total_time,
+				      1e3 * max_request_tsc / (double)tsc_hz);
+		}
+
+		doca_error_t destroy_result = destroy_test_tunnels(vips);
+		if (result == DOCA_SUCCESS)
+			result = destroy_result;
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Tunnel setup benchmark failed at request size %u: %s",
+				     request_size,
+				     doca_error_get_descr(result));
+			return result;
+		}
+
+		if (request_size == nb_tunnels)
+			break;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+size_t PSP_GatewayImpl::nb_free_crypto_ids(void) const
+{
+	return free_crypto_ids.size() + config->max_tunnels + 1 - next_crypto_id_;
+}
+
 uint32_t PSP_GatewayImpl::next_crypto_id(void)
 {
+	if (!free_crypto_ids.empty()) {
+		uint32_t crypto_id = free_crypto_ids.back();
+		free_crypto_ids.pop_back();
+		return crypto_id;
+	}
 	if (next_crypto_id_ > config->max_tunnels) {
 		return UINT32_MAX;
 	}
 	return next_crypto_id_++;
 }
 
+void PSP_GatewayImpl::release_crypto_id(uint32_t crypto_id)
+{
+	free_crypto_ids.push_back(crypto_id);
+}
+
+doca_error_t PSP_GatewayImpl::remove_encrypt_entry(psp_session_t *session)
+{
+	doca_error_t result = psp_flows->remove_encrypt_entry(session);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	release_crypto_id(session->crypto_id);
+	return DOCA_SUCCESS;
+}
+
 ::psp_gateway::PSP_Gateway::Stub *PSP_GatewayImpl::get_stub(const std::string &peer_ip)
 {
 	auto stubs_iter = stubs.find(peer_ip);
@@ -615,7 +1327,13 @@ uint32_t PSP_GatewayImpl::next_crypto_id(void)
 	}
 	grpc::ChannelArguments args;
 	args.SetMaxReceiveMessageSize(10 * 1024 * 1024); // 10 MB
+	// Keep the channel connected while idle, so a miss packet never waits for a reconnect
+	args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, KEEPALIVE_TIME_MS);
+	args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, KEEPALIVE_TIMEOUT_MS);
+	args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+	args.SetInt(GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA, 0);
 	auto channel = grpc::CreateCustomChannel(peer_addr, grpc::InsecureChannelCredentials(), args);
+	channel->GetState(true); // start connecting now
 	stubs_iter = stubs.emplace(peer_ip, psp_gateway::PSP_Gateway::NewStub(channel)).first;
 
 	DOCA_LOG_INFO("Created gRPC stub for peer %s", peer_addr.c_str());
@@ -623,6 +1341,12 @@ uint32_t PSP_GatewayImpl::next_crypto_id(void)
 	return stubs_iter->second.get();
 }
 
+void PSP_GatewayImpl::warm_up_stubs(void)
+{
+	for (auto &peer : config->net_config.peers)
+		get_stub(peer.svc_addr);
+}
+
 void PSP_GatewayImpl::debug_key(const char *msg_prefix, const void *key, size_t key_size_bytes) const
 {
 	if (!DEBUG_KEYS) {
@@ -26,21 +26,23 @@
 #ifndef _PSP_GW_SVC_H
 #define _PSP_GW_SVC_H
 
+#include <atomic>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <vector>
 
 #include <doca_flow.h>
 
 #include <psp_gateway.pb.h>
 #include <psp_gateway.grpc.pb.h>
+#include <grpcpp/completion_queue.h>
 #include "psp_gw_config.h"
 #include "psp_gw_flows.h"
 
 struct psp_pf_dev;
 struct doca_flow_crypto_psp_spi_key_bulk;
 
-using psp_session_and_key_t = std::pair<psp_session_t *, void *>;
-
 /**
  * @brief Implementation of the PSP_Gateway service.
  *
@@ -60,6 +62,22 @@ class PSP_GatewayImpl : public psp_gateway::PSP_Gateway::Service {
 public:
 	static constexpr uint16_t DEFAULT_HTTP_PORT_NUM = 3000;
 
+	// Interval and timeout of the keepalive pings on the channels to the peers
+	static constexpr int KEEPALIVE_TIME_MS = 10000;
+	static constexpr int KEEPALIVE_TIMEOUT_MS = 5000;
+
+	// Tunnel requests sent from the miss path which may be outstanding to a single peer
+	static constexpr uint32_t MAX_INFLIGHT_REQUESTS_PER_PEER = 8;
+
+	// Miss packets held per outstanding tunnel request, resubmitted when it completes
+	static constexpr size_t MAX_HELD_PACKETS = 32;
+
+	// Deadline of a tunnel request sent from the miss path
+	static constexpr int TUNNEL_REQUEST_TIMEOUT_SEC = 5;
+
+	// Buckets of the tunnel latency histogram, each twice as wide as the previous one
+	static constexpr int LATENCY_BUCKETS = 32;
+
 	/**
 	 * @brief Constructs the object. This operation cannot fail.
 	 *
@@ -67,6 +85,12 @@ public:
 	 */
 	PSP_GatewayImpl(psp_gw_app_config *config, PSP_GatewayFlows *psp_flows);
 
+	/**
+	 * @brief Cancels the outstanding tunnel requests and drains the
+	 *        client completion queue.
+	 */
+	~PSP_GatewayImpl(void);
+
 	/**
 	 * @brief Requests that the recipient allocate multiple SPIs and encryption keys
 	 * so that the initiator can begin sending encrypted traffic.
@@ -101,6 +125,30 @@ public:
 	 */
 	doca_error_t handle_miss_packet(struct rte_mbuf *packet);
 
+	/**
+	 * @brief Completes the tunnel requests sent from the miss path whose
+	 *        responses have arrived, without blocking. Called by a single
+	 *        RSS L-Core on every iteration of its main loop.
+	 *
+	 * @return: the number of tunnel requests completed
+	 */
+	size_t poll_tunnel_responses(void);
+
+	/**
+	 * @brief Displays the latency of the tunnels created from the miss
+	 *        path, from the first miss packet to the creation of the
+	 *        flows, and the miss packets dropped meanwhile, if they have
+	 *        changed since the previous invocation.
+	 */
+	void show_tunnel_request_stats(void);
+
+	/**
+	 * @brief Creates the gRPC channels to all the configured peers and
+	 *        starts connecting them, so the first tunnel request to a
+	 *        peer does not wait for the connection to be established.
+	 */
+	void warm_up_stubs(void);
+
 	/**
 	 * @brief Displays the counters of all tunnel sessions that have
 	 *        changed since the previous invocation.
@@ -119,6 +167,48 @@ public:
 	 */
 	size_t try_connect(std::vector<psp_gw_peer> &peers);
 
+	/**
+	 * @brief Tears down the encryption flows of the sessions which sent no
+	 * traffic for the configured idle timeout, and returns their crypto_ids
+	 * to the free pool. Does nothing if the idle timeout is disabled.
+	 *
+	 * @return: the number of sessions torn down
+	 */
+	size_t remove_idle_sessions(void);
+
+	/**
+	 * @brief Completes the flows of the sessions whose entries were still
+	 * queued when they were added. The crypto_id of a session whose
+	 * encryption flow failed is returned to the free pool; otherwise it
+	 * stays with the session until its encryption flow is removed.
+	 *
+	 * @return: the number of flows completed
+	 */
+	size_t complete_inflight_sessions(void);
+
+	/**
+	 * @brief Repeatedly creates a batch of local tunnels, as if requested
+	 * by a peer, and destroys them, checking that every crypto_id is
+	 * returned to the free pool. Must be called before the gRPC server
+	 * is started.
+	 *
+	 * @nb_rounds [in]: the number of create/destroy rounds
+	 * @return: DOCA_SUCCESS if no crypto_id leaked and DOCA_ERROR otherwise
+	 */
+	doca_error_t check_crypto_id_churn(uint32_t nb_rounds);
+
+	/**
+	 * @brief Measures the tunnel setup rate per request size. For request
+	 * sizes from a single tunnel up to nb_tunnels, growing by a factor of
+	 * BENCH_REQUEST_SIZE_STEP, sets up nb_tunnels local tunnels as if
+	 * requested by a peer, reports the rate and tears them down. Must be
+	 * called before the gRPC server is started.
+	 *
+	 * @nb_tunnels [in]: the number of tunnels to set up per request size
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t benchmark_tunnel_setup(uint32_t nb_tunnels);
+
 private:
 	/**
 	 * @brief Returns the number of bits of the key size as determined
@@ -155,6 +245,121 @@ private:
 					    bool suppress_failure_msg,
 					    bool has_remote);
 
+	/**
+	 * @brief Sends a request for a single tunnel to the given peer without
+	 * waiting for the response, which is completed by poll_tunnel_responses().
+	 * The packet is held until then. If a request for the same tunnel is
+	 * already outstanding, only the packet is held.
+	 *
+	 * @peer [in]: The peer to which we will create a tunnel
+	 * @vip_pair [in]: The source and destination IP addresses of the traffic flow
+	 * @vips [in]: The session key of the tunnel
+	 * @packet [in]: The miss packet to resubmit once the tunnel is created
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t request_tunnel_async(struct psp_gw_peer *peer,
+					  ip_pair *vip_pair,
+					  const session_key &vips,
+					  struct rte_mbuf *packet);
+
+	/**
+	 * @brief Fills a tunnel request to the given peer, including the reverse
+	 * parameters, and opens the ingress ACLs for the return traffic.
+	 *
+	 * @peer [in]: The peer to which we will create a tunnel
+	 * @vip_pair [in]: The source and destination IP addresses of the traffic flow
+	 * @supply_reverse_params [in]: Whether to include tunnel parameters for traffic
+	 * returning to the sender of the request.
+	 * @has_vip_pair [in]: true if vip_pair should be the only tunnel of the request
+	 * @request [out]: The request to send
+	 * @vip_pair_id [out]: The index of vip_pair in the peer, or -1 if not has_vip_pair
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t build_tunnel_request(struct psp_gw_peer *peer,
+					  ip_pair *vip_pair,
+					  bool supply_reverse_params,
+					  bool has_vip_pair,
+					  ::psp_gateway::MultiTunnelRequest &request,
+					  int *vip_pair_id);
+
+	/**
+	 * @brief Creates the sessions and encryption flows of the tunnels
+	 * returned by a peer in response to build_tunnel_request().
+	 *
+	 * @peer [in]: The peer to which we will create a tunnel
+	 * @vip_pair_id [in]: As returned by build_tunnel_request()
+	 * @supply_reverse_params [in]: Whether the request included reverse parameters
+	 * @suppress_failure_msg [in]: Indicates we are okay with a failure to connect
+	 * @request [in]: The request which was sent
+	 * @response [in]: The response of the peer
+	 * @status [in]: The status of the RPC
+	 * @start_time [in]: The TSC value when the request was built
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t process_tunnel_response(struct psp_gw_peer *peer,
+					     int vip_pair_id,
+					     bool supply_reverse_params,
+					     bool suppress_failure_msg,
+					     const ::psp_gateway::MultiTunnelRequest &request,
+					     const ::psp_gateway::MultiTunnelResponse &response,
+					     const ::grpc::Status &status,
+					     uint64_t start_time);
+
+	/**
+	 * @brief A tunnel request sent from the miss path, awaiting its response
+	 */
+	struct pending_tunnel_request {
+		psp_gw_peer *peer;			      /* The peer to which the request was sent */
+		session_key vips;			      /* The (src vip, dst vip) of the tunnel */
+		int vip_pair_id;			      /* The index of the tunnel in the peer */
+		uint64_t start_tsc;			      /* The TSC value of the first miss packet */
+		::grpc::ClientContext context;		      /* The context of the RPC */
+		::psp_gateway::MultiTunnelRequest request;    /* The request sent */
+		::psp_gateway::MultiTunnelResponse response;  /* The response, once completed */
+		::grpc::Status status;			      /* The status, once completed */
+		std::vector<struct rte_mbuf *> held_packets;  /* Packets to resubmit once completed */
+		std::unique_ptr<::grpc::ClientAsyncResponseReader<::psp_gateway::MultiTunnelResponse>> reader;
+	};
+
+	/**
+	 * @brief Latency and drop counters of the tunnel requests sent from the miss path
+	 */
+	struct tunnel_request_stats {
+		uint64_t nb_created;			/* Tunnels created */
+		uint64_t nb_failed;			/* Tunnel requests which failed */
+		uint64_t total_latency_tsc;		/* Sum of the latencies of the created tunnels */
+		uint64_t max_latency_tsc;		/* Highest latency of a created tunnel */
+		uint64_t latency_hist[LATENCY_BUCKETS]; /* Created tunnels per log2(latency in usec) */
+		uint64_t nb_dropped_peer_cap;		/* Miss packets dropped at MAX_INFLIGHT_REQUESTS_PER_PEER */
+		uint64_t nb_dropped_held;		/* Miss packets dropped at MAX_HELD_PACKETS */
+	};
+
+	/**
+	 * @brief Records the latency of a tunnel created from the miss path
+	 *
+	 * @latency_tsc [in]: TSC cycles from the first miss packet to the creation of the flows
+	 */
+	void record_tunnel_latency(uint64_t latency_tsc);
+
+	/**
+	 * @brief Returns the upper bound of the latency percentile of the
+	 * created tunnels, from the histogram.
+	 *
+	 * @stats [in]: the counters to read
+	 * @percentile [in]: the percentile, between 0 and 1
+	 * @return: the latency in milliseconds
+	 */
+	static double latency_percentile_ms(const tunnel_request_stats &stats, double percentile);
+
+	/**
+	 * @brief Holds a reference to a miss packet until its tunnel request
+	 * completes. The packet is dropped if MAX_HELD_PACKETS are already held.
+	 *
+	 * @pending [in/out]: The outstanding tunnel request
+	 * @packet [in]: The packet to hold
+	 */
+	void hold_packet(pending_tunnel_request *pending, struct rte_mbuf *packet);
+
 	/**
 	 * @brief Returns a gRPC client for a given peer
 	 * Note: this assumes only a single PSP app instance per peer
@@ -214,14 +419,41 @@ private:
 	doca_error_t generate_keys_spis(uint32_t key_len_bits, uint32_t nr_keys_spis, uint32_t *keys, uint32_t *spis);
 
 	/**
-	 * @brief Adds encryption entries to pipeline according to sessions
+	 * @brief Adds encryption entries to pipeline according to sessions, in a
+	 * single batch. The crypto_ids of the sessions which failed are released;
+	 * sessions whose entries are still queued keep theirs until
+	 * complete_inflight_sessions() collects the result.
 	 *
 	 * @new_sessions_keys [in]: The new sessions to create entries for
 	 * @peer_svc_addr [in]: The peer to which we will create a tunnel
-	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 * @results [out]: The result of each session, in the same order
+	 * @return: DOCA_SUCCESS if the batch was processed and DOCA_ERROR otherwise
 	 */
 	doca_error_t add_encrypt_entries(std::vector<psp_session_and_key_t> &new_sessions_keys,
-					 std::string peer_svc_addr);
+					 std::string peer_svc_addr,
+					 std::vector<doca_error_t> &results);
+
+	/**
+	 * @brief Adds ingress ACL entries to pipeline according to sessions, in a
+	 * single batch.
+	 *
+	 * @acl_sessions [in]: The sessions to create entries for
+	 * @results [out]: The result of each session, in the same order
+	 * @return: DOCA_SUCCESS if the batch was processed and DOCA_ERROR otherwise
+	 */
+	doca_error_t add_ingress_acl_entries(std::vector<psp_session_t *> &acl_sessions,
+					     std::vector<doca_error_t> &results);
+
+	/**
+	 * @brief Shows the tunnel setup rate of a request, if insertion
+	 * performance printing is enabled.
+	 *
+	 * @request_id [in]: The request whose tunnels were set up
+	 * @nb_tunnels [in]: The number of tunnels in the request
+	 * @nb_failed [in]: The number of tunnels whose flows failed
+	 * @start_tsc [in]: The TSC value at the beginning of the setup
+	 */
+	void show_tunnel_setup_rate(uint64_t request_id, int nb_tunnels, int nb_failed, uint64_t start_tsc);
 	/**
 	 * @brief Prepares the session for the given peer virtual IP
 	 *
@@ -253,6 +485,57 @@ private:
 	 */
 	uint32_t next_crypto_id(void);
 
+	/**
+	 * @brief Returns a crypto_id which is no longer used by any encryption
+	 * flow to the free pool, to be handed out again by next_crypto_id().
+	 *
+	 * @crypto_id [in]: The crypto_id to release
+	 */
+	void release_crypto_id(uint32_t crypto_id);
+
+	/**
+	 * @brief Returns the number of crypto_ids which next_crypto_id() can
+	 * still hand out.
+	 *
+	 * @return: the number of free crypto_ids
+	 */
+	size_t nb_free_crypto_ids(void) const;
+
+	/**
+	 * @brief Creates tunnels between local test VIPs in a single call to
+	 * RequestMultipleTunnelParams(), as if requested by a peer which
+	 * supplied the reverse parameters, and waits for all their flows.
+	 *
+	 * @first_idx [in]: the index of the test VIPs of the first tunnel
+	 * @nb_tunnels [in]: the number of tunnels to create
+	 * @request_id [in]: the request ID to use
+	 * @vips [in/out]: the session keys of the tunnels are appended to it
+	 * @nb_failed [out]: the number of tunnels whose flows failed
+	 * @return: DOCA_SUCCESS if the request was processed and DOCA_ERROR otherwise
+	 */
+	doca_error_t create_test_tunnels(uint32_t first_idx,
+					 uint32_t nb_tunnels,
+					 uint64_t request_id,
+					 std::vector<session_key> &vips,
+					 uint32_t *nb_failed);
+
+	/**
+	 * @brief Removes the flows of the given sessions, releases their
+	 * crypto_ids and erases them.
+	 *
+	 * @vips [in]: the session keys of the tunnels to destroy
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t destroy_test_tunnels(const std::vector<session_key> &vips);
+
+	/**
+	 * @brief Removes the encryption flow of a session and releases its crypto_id
+	 *
+	 * @session [in/out]: The session whose encryption flow should be removed
+	 * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+	 */
+	doca_error_t remove_encrypt_entry(psp_session_t *session);
+
 	// Application state data:
 
 	psp_gw_app_config *config{};
@@ -262,7 +545,7 @@ private:
 	psp_pf_dev *pf{};
 
 	// Used to uniquely populate the request ID in each NewTunnelRequest message.
-	uint64_t next_request_id{};
+	std::atomic<uint64_t> next_request_id{};
 
 	// This flag will cause encryption keys to be logged to stderr, etc.
 	const bool DEBUG_KEYS{false};
@@ -270,11 +553,53 @@ private:
 	// map each svc_addr to an RPC object
 	std::map<std::string, std::unique_ptr<::psp_gateway::PSP_Gateway::Stub>> stubs;
 
+	// Receives the responses of the tunnel requests sent from the miss path
+	::grpc::CompletionQueue client_cq;
+
+	// map tuple of (src vip, dst vip) to its outstanding tunnel request
+	std::map<session_key, std::unique_ptr<pending_tunnel_request>> pending_requests;
+
+	// number of outstanding tunnel requests per svc_addr
+	std::map<std::string, uint32_t> inflight_per_peer;
+
+	// Counters of the tunnel requests sent from the miss path, and their
+	// values when show_tunnel_request_stats() last displayed them
+	tunnel_request_stats request_stats{};
+	tunnel_request_stats shown_request_stats{};
+
+	// Serializes access to the outstanding requests and their counters between
+	// the RSS L-Cores and the main loop. Taken before sessions_mutex when both are needed.
+	std::mutex pending_mutex;
+
 	// map tuple of (src vip, dst vip) to an active session object
 	std::map<session_key, psp_session_t> sessions;
 
+	// Serializes access to the sessions between the gRPC server, the miss path and the main loop.
+	// Never held across an outgoing gRPC call, as the peer may be requesting a tunnel from us.
+	std::mutex sessions_mutex;
+
 	// Used to assign a unique shared-resource ID to each encryption flow.
 	uint32_t next_crypto_id_ = 1;
+
+	// crypto_ids released by removed sessions, reused before next_crypto_id_ is advanced
+	std::vector<uint32_t> free_crypto_ids;
+
+	// Number of sessions torn down for being idle since startup
+	uint64_t nb_idle_sessions_removed{};
+
+	// Number of encrypt/ACL flows whose entries are still queued
+	size_t nb_inflight_flows{};
+
+	// Test VIPs of create_test_tunnels(), from the benchmarking range 198.18.0.0/15
+	static constexpr uint32_t TEST_PEER_VIP_BASE = 0xc6120000;  // 198.18.0.0
+	static constexpr uint32_t TEST_LOCAL_VIP_BASE = 0xc6130000; // 198.19.0.0
+	static constexpr uint32_t MAX_TEST_TUNNELS = 0x10000;
+
+	// Growth factor of the request size between rounds of benchmark_tunnel_setup()
+	static constexpr uint32_t BENCH_REQUEST_SIZE_STEP = 8;
+
+	// Retries of complete_inflight_sessions() before test tunnels are given up
+	static constexpr int TEST_INFLIGHT_RETRIES = 100;
 };
 
 #endif // _PSP_GW_SVC_H
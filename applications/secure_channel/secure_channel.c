@@ -52,6 +52,8 @@ int main(int argc, char **argv)
 	struct comch_cfg *comch_cfg;
 	int exit_status = EXIT_SUCCESS;
 
+	app_cfg.nb_channels = 1;
+
 #ifdef DOCA_ARCH_DPU
 	app_cfg.mode = SC_MODE_DPU;
 #endif
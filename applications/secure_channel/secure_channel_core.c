@@ -23,10 +23,14 @@
  *
  */
 
+#define _GNU_SOURCE
+
 #include <arpa/inet.h>
 #include <errno.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/epoll.h>
 #include <sys/signalfd.h>
@@ -55,6 +59,8 @@
 
 #define NS_PER_SEC 1E9	   /* Nano-seconds per second */
 #define NS_PER_MSEC 1E6	   /* Nano-seconds per millisecond */
+#define MSEC_PER_SEC 1E3   /* Milliseconds per second */
+#define BYTES_PER_GB 1E9   /* Bytes per gigabyte */
 #ifdef CLOCK_MONOTONIC_RAW /* Defined in glibc bits/time.h */
 #define CLOCK_TYPE_ID CLOCK_MONOTONIC_RAW
 #else
@@ -114,6 +120,73 @@ static doca_error_t message_size_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * ARGP Callback - Handle number of channels parameter
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t channels_number_callback(void *param, void *config)
+{
+	struct sc_config *app_cfg = (struct sc_config *)config;
+	int nb_channels = *(int *)param;
+
+	if (nb_channels < 1 || nb_channels > SC_MAX_CHANNELS) {
+		DOCA_LOG_ERR("Number of channels must be between 1 and %d", SC_MAX_CHANNELS);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	app_cfg->nb_channels = nb_channels;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * ARGP Callback - Handle core list parameter, a comma separated list of cores and core ranges such as "0,2,4-7"
+ *
+ * @param [in]: Input parameter
+ * @config [in/out]: Program configuration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t core_list_callback(void *param, void *config)
+{
+	struct sc_config *app_cfg = (struct sc_config *)config;
+	char *core_list, *saveptr, *tok, *end;
+	doca_error_t result = DOCA_SUCCESS;
+	long first, last, core;
+
+	core_list = strdup((char *)param);
+	if (core_list == NULL) {
+		DOCA_LOG_ERR("Failed to allocate core list");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	app_cfg->nb_cores = 0;
+	for (tok = strtok_r(core_list, ",", &saveptr); tok != NULL; tok = strtok_r(NULL, ",", &saveptr)) {
+		first = strtol(tok, &end, 10);
+		last = first;
+		if (end != tok && *end == '-')
+			last = strtol(end + 1, &end, 10);
+		if (end == tok || *end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+			DOCA_LOG_ERR("Invalid core list entry %s", tok);
+			result = DOCA_ERROR_INVALID_VALUE;
+			goto free_list;
+		}
+		for (core = first; core <= last; core++) {
+			if (app_cfg->nb_cores == SC_MAX_CORES) {
+				DOCA_LOG_ERR("Core list exceeds the maximum of %d cores", SC_MAX_CORES);
+				result = DOCA_ERROR_INVALID_VALUE;
+				goto free_list;
+			}
+			app_cfg->cores[app_cfg->nb_cores++] = core;
+		}
+	}
+
+free_list:
+	free(core_list);
+	return result;
+}
+
 /*
  * ARGP Callback - Handle Comm Channel DOCA device PCI address parameter
  *
@@ -167,10 +240,18 @@ void new_consumer_callback(struct doca_comch_event_consumer *event,
 			   uint32_t id)
 {
 	struct cc_ctx *cfg = comch_utils_get_user_data(comch_connection);
+	uint32_t nb_ids = atomic_load(&cfg->nb_consumer_ids);
 
 	(void)event;
 
-	cfg->consumer_id = id;
+	if (nb_ids == SC_MAX_CHANNELS) {
+		DOCA_LOG_ERR("Opposite end created more than %d consumers", SC_MAX_CHANNELS);
+		return;
+	}
+
+	/* Producers poll the counter, so publish the new ID only after it is stored */
+	cfg->consumer_ids[nb_ids] = id;
+	atomic_store(&cfg->nb_consumer_ids, nb_ids + 1);
 }
 
 void expired_consumer_callback(struct doca_comch_event_consumer *event,
@@ -210,8 +291,14 @@ void comch_recv_event_cb(struct doca_comch_event_msg_recv *event,
 		return;
 	}
 
-	cfg->expected_msgs = ntohl(meta->num_msgs);
+	cfg->expected_channels = ntohl(meta->num_channels);
+	if (cfg->expected_channels < 1 || cfg->expected_channels > SC_MAX_CHANNELS) {
+		DOCA_LOG_ERR("Invalid number of channels detected: %d", cfg->expected_channels);
+		cfg->expected_msgs = -1;
+		return;
+	}
 	cfg->expected_msg_size = ntohl(meta->msg_size);
+	cfg->expected_msgs = ntohl(meta->num_msgs);
 }
 
 /*
@@ -397,8 +484,10 @@ static void send_task_fail_callback(struct doca_comch_producer_task_send *task,
 static void *run_producer(void *context)
 {
 	struct doca_comch_producer_task_send *task[MAX_FASTPATH_TASKS] = {0};
-	struct cc_ctx *ctx = (struct cc_ctx *)context;
+	struct sc_thread_ctx *thread_ctx = (struct sc_thread_ctx *)context;
+	struct cc_ctx *ctx = thread_ctx->ctx;
 	struct fast_path_ctx producer_ctx = {0};
+	uint32_t consumer_id;
 	union doca_data ctx_user_data = {0};
 	struct doca_comch_producer *producer;
 	struct local_memory_bufs local_mem;
@@ -427,10 +516,8 @@ static void *run_producer(void *context)
 	/* Producer sends the same buffer repeatedly so only needs to allocate space for one */
 	result =
 		prepare_local_memory(&local_mem, ctx->cfg->cc_dev_pci_addr, msg_len, 1, DOCA_ACCESS_FLAG_PCI_READ_ONLY);
-	if (result != DOCA_SUCCESS) {
-		ctx->send_result->result = result;
+	if (result != DOCA_SUCCESS)
 		goto exit_thread;
-	}
 
 	/* Verify producer can support message size */
 	result = doca_comch_producer_cap_get_max_buf_size(doca_dev_as_devinfo(local_mem.dev), &max_cap);
@@ -498,12 +585,17 @@ static void *run_producer(void *context)
 	}
 
 	/*
-	 * Wait on external consumer to come up.
+	 * Wait on an external consumer to come up, each channel sends to a different one.
 	 * This is handled in the comch progress_engine.
 	 */
-	while (ctx->consumer_id == 0) {
+	while (atomic_load(&ctx->nb_consumer_ids) <= thread_ctx->channel) {
+		if (atomic_load(&ctx->stop_threads)) {
+			result = DOCA_ERROR_BAD_STATE;
+			goto free_tasks;
+		}
 		nanosleep(&ts, &ts);
 	}
+	consumer_id = ctx->consumer_ids[thread_ctx->channel];
 
 	producer_ctx.state = FASTPATH_IN_PROGRESS;
 
@@ -516,7 +608,7 @@ static void *run_producer(void *context)
 								  doca_buf,
 								  NULL,
 								  0,
-								  ctx->consumer_id,
+								  consumer_id,
 								  &task[i]);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to allocate a producer task: %s", doca_error_get_descr(result));
@@ -525,7 +617,7 @@ static void *run_producer(void *context)
 
 		/* May need to wait for a post_recv message before being able to send */
 		result = doca_task_submit(doca_comch_producer_task_send_as_task(task[i]));
-		while (result == DOCA_ERROR_AGAIN) {
+		while (result == DOCA_ERROR_AGAIN && !atomic_load(&ctx->stop_threads)) {
 			result = doca_task_submit(doca_comch_producer_task_send_as_task(task[i]));
 		}
 
@@ -537,9 +629,11 @@ static void *run_producer(void *context)
 		(producer_ctx.submitted_msgs)++;
 	}
 
-	/* Progress until all messages have been sent or an error occurred */
-	while (producer_ctx.state == FASTPATH_IN_PROGRESS)
+	/* Progress until all messages have been sent, an error occurred or the threads are stopped */
+	while (producer_ctx.state == FASTPATH_IN_PROGRESS && !atomic_load(&ctx->stop_threads))
 		doca_pe_progress(producer_pe);
+	if (producer_ctx.state == FASTPATH_IN_PROGRESS)
+		producer_ctx.state = FASTPATH_ERROR;
 
 	if (clock_gettime(CLOCK_TYPE_ID, &producer_ctx.end_time) != 0)
 		DOCA_LOG_ERR("Failed to get timestamp");
@@ -584,10 +678,10 @@ destroy_local_mem:
 	destroy_local_memory(&local_mem);
 
 exit_thread:
-	ctx->send_result->processed_msgs = producer_ctx.completed_msgs;
-	ctx->send_result->start_time = producer_ctx.start_time;
-	ctx->send_result->end_time = producer_ctx.end_time;
-	ctx->send_result->result = result;
+	thread_ctx->result.processed_msgs = producer_ctx.completed_msgs;
+	thread_ctx->result.start_time = producer_ctx.start_time;
+	thread_ctx->result.end_time = producer_ctx.end_time;
+	thread_ctx->result.result = result;
 
 	atomic_fetch_sub(&ctx->active_threads, 1);
 
@@ -673,7 +767,8 @@ static void recv_task_fail_callback(struct doca_comch_consumer_task_post_recv *t
 static void *run_consumer(void *context)
 {
 	struct doca_comch_consumer_task_post_recv *task[MAX_FASTPATH_TASKS] = {0};
-	struct cc_ctx *ctx = (struct cc_ctx *)context;
+	struct sc_thread_ctx *thread_ctx = (struct sc_thread_ctx *)context;
+	struct cc_ctx *ctx = thread_ctx->ctx;
 	struct doca_buf *doca_buf[MAX_FASTPATH_TASKS] = {0};
 	struct doca_comch_consumer *consumer;
 	struct fast_path_ctx consumer_ctx = {0};
@@ -706,10 +801,8 @@ static void *run_consumer(void *context)
 				      msg_len,
 				      total_tasks,
 				      DOCA_ACCESS_FLAG_PCI_READ_WRITE);
-	if (result != DOCA_SUCCESS) {
-		ctx->recv_result->result = result;
+	if (result != DOCA_SUCCESS)
 		goto exit_thread;
-	}
 
 	/* Verify consumer can support message size */
 	result = doca_comch_consumer_cap_get_max_buf_size(doca_dev_as_devinfo(local_mem.dev), &max_cap);
@@ -800,10 +893,12 @@ static void *run_consumer(void *context)
 		}
 	}
 
-	/* Progress until all expected messages have been received or an error occurred */
-	while (consumer_ctx.state == FASTPATH_IN_PROGRESS) {
+	/* Progress until all expected messages have been received, an error occurred or the threads are stopped */
+	while (consumer_ctx.state == FASTPATH_IN_PROGRESS && !atomic_load(&ctx->stop_threads)) {
 		doca_pe_progress(consumer_pe);
 	}
+	if (consumer_ctx.state == FASTPATH_IN_PROGRESS)
+		consumer_ctx.state = FASTPATH_ERROR;
 
 	if (clock_gettime(CLOCK_TYPE_ID, &consumer_ctx.end_time) != 0)
 		DOCA_LOG_ERR("Failed to get timestamp");
@@ -850,10 +945,10 @@ destroy_local_mem:
 	destroy_local_memory(&local_mem);
 
 exit_thread:
-	ctx->recv_result->processed_msgs = consumer_ctx.completed_msgs;
-	ctx->recv_result->start_time = consumer_ctx.start_time;
-	ctx->recv_result->end_time = consumer_ctx.end_time;
-	ctx->recv_result->result = result;
+	thread_ctx->result.processed_msgs = consumer_ctx.completed_msgs;
+	thread_ctx->result.start_time = consumer_ctx.start_time;
+	thread_ctx->result.end_time = consumer_ctx.end_time;
+	thread_ctx->result.result = result;
 
 	atomic_fetch_sub(&ctx->active_threads, 1);
 
@@ -861,55 +956,138 @@ exit_thread:
 }
 
 /*
- * Start threads and wait for them to finish
+ * Get the core a fast path thread is pinned to, cores are assigned round robin in thread start order
  *
- * @ctx [in]: Thread context
- * @comch_cfg [in]: Comch channel to progress on
- * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ * @cfg [in]: Secure Channel configuration
+ * @thread_idx [in]: Index of the thread in start order
+ * @return: core to pin the thread to, negative if no cores were configured
  */
-static doca_error_t start_threads(struct cc_ctx *ctx, struct comch_cfg *comch_cfg)
+static int thread_core(struct sc_config *cfg, uint32_t thread_idx)
 {
-	doca_error_t result;
-	int running_threads;
+	if (cfg->nb_cores == 0)
+		return -1;
+	return cfg->cores[thread_idx % cfg->nb_cores];
+}
 
-	/* set count to determine when threads have finished */
-	atomic_init(&ctx->active_threads, 2);
-	running_threads = 2;
+/*
+ * Start a detached producer or consumer thread, pinned to its core if one was assigned
+ *
+ * @thread_ctx [in]: Thread context
+ * @routine [in]: Thread main function
+ * @name [in]: Thread role, for logging
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t start_thread(struct sc_thread_ctx *thread_ctx, void *(*routine)(void *), const char *name)
+{
+	pthread_attr_t attr;
+	cpu_set_t cpuset;
+	doca_error_t result = DOCA_SUCCESS;
 
-	if (pthread_create(ctx->sendto_t, NULL, run_producer, (void *)ctx) != 0) {
-		DOCA_LOG_ERR("Failed to start sendto thread");
+	if (pthread_attr_init(&attr) != 0) {
+		DOCA_LOG_ERR("Failed to init %s thread attributes", name);
 		return DOCA_ERROR_BAD_STATE;
 	}
 
-	if (pthread_detach(*ctx->sendto_t) != 0) {
-		DOCA_LOG_ERR("Failed to detach sendto thread");
-		return DOCA_ERROR_BAD_STATE;
+	if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0) {
+		DOCA_LOG_ERR("Failed to set %s thread as detached", name);
+		result = DOCA_ERROR_BAD_STATE;
+		goto destroy_attr;
 	}
 
-	if (pthread_create(ctx->recvfrom_t, NULL, run_consumer, (void *)ctx) != 0) {
-		DOCA_LOG_ERR("Failed to start recvfrom thread");
-		return DOCA_ERROR_BAD_STATE;
+	if (thread_ctx->core >= 0) {
+		CPU_ZERO(&cpuset);
+		CPU_SET(thread_ctx->core, &cpuset);
+		if (pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset) != 0) {
+			DOCA_LOG_ERR("Failed to pin %s thread to core %d", name, thread_ctx->core);
+			result = DOCA_ERROR_INVALID_VALUE;
+			goto destroy_attr;
+		}
 	}
 
-	if (pthread_detach(*ctx->recvfrom_t) != 0) {
-		DOCA_LOG_ERR("Failed to detach sendto thread");
-		return DOCA_ERROR_BAD_STATE;
+	if (pthread_create(&thread_ctx->thread, &attr, routine, (void *)thread_ctx) != 0) {
+		DOCA_LOG_ERR("Failed to start %s thread of channel %u", name, thread_ctx->channel);
+		result = DOCA_ERROR_BAD_STATE;
+	}
+
+destroy_attr:
+	pthread_attr_destroy(&attr);
+	return result;
+}
+
+/*
+ * Start producer and consumer threads and wait for them to finish
+ *
+ * Threads are started channel by channel, producer first, and take the configured cores in this order.
+ * On failure, any threads already started are stopped and waited on so their contexts can be freed.
+ *
+ * @ctx [in]: Thread context
+ * @comch_cfg [in]: Comch channel to progress on
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t start_threads(struct cc_ctx *ctx, struct comch_cfg *comch_cfg)
+{
+	uint32_t nb_producers = ctx->cfg->nb_channels;
+	uint32_t nb_consumers = ctx->expected_channels;
+	uint32_t i, thread_idx = 0;
+	struct sc_thread_ctx *thread_ctx;
+	doca_error_t result;
+	int running_threads;
+
+	/* Count only threads that actually started, each decrements the count when it exits */
+	atomic_init(&ctx->active_threads, 0);
+	atomic_init(&ctx->stop_threads, false);
+
+	for (i = 0; i < MAX(nb_producers, nb_consumers); i++) {
+		if (i < nb_producers) {
+			thread_ctx = &ctx->producers[i];
+			thread_ctx->ctx = ctx;
+			thread_ctx->channel = i;
+			thread_ctx->core = thread_core(ctx->cfg, thread_idx++);
+			atomic_fetch_add(&ctx->active_threads, 1);
+			result = start_thread(thread_ctx, run_producer, "producer");
+			if (result != DOCA_SUCCESS) {
+				atomic_fetch_sub(&ctx->active_threads, 1);
+				goto stop_threads;
+			}
+		}
+
+		if (i < nb_consumers) {
+			thread_ctx = &ctx->consumers[i];
+			thread_ctx->ctx = ctx;
+			thread_ctx->channel = i;
+			thread_ctx->core = thread_core(ctx->cfg, thread_idx++);
+			atomic_fetch_add(&ctx->active_threads, 1);
+			result = start_thread(thread_ctx, run_consumer, "consumer");
+			if (result != DOCA_SUCCESS) {
+				atomic_fetch_sub(&ctx->active_threads, 1);
+				goto stop_threads;
+			}
+		}
 	}
 
 	/*
 	 * Progress the comch PE while waiting for the threads to finish.
 	 * Comch handles producer and consumer control messages so must continue to run.
 	 */
+	running_threads = atomic_load(&ctx->active_threads);
 	while (running_threads > 0) {
 		result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Error in comch progression: %s", doca_error_get_descr(result));
-			return result;
+			goto stop_threads;
 		}
 		running_threads = atomic_load(&ctx->active_threads);
 	}
 
 	return DOCA_SUCCESS;
+
+stop_threads:
+	/* Started threads are detached and use their thread contexts, wait for them to exit before these are freed */
+	atomic_store(&ctx->stop_threads, true);
+	while (atomic_load(&ctx->active_threads) > 0)
+		(void)comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
+
+	return result;
 }
 
 /*
@@ -930,21 +1108,81 @@ static double calculate_timediff_ms(struct timespec *end, struct timespec *start
 	return (double)(diff / NS_PER_MSEC);
 }
 
+/*
+ * Helper to calculate a rate per second
+ *
+ * @count [in]: number of units processed
+ * @time_ms [in]: processing time in milliseconds
+ * @return: units per second, 0 if no time elapsed
+ */
+static double calculate_rate(double count, double time_ms)
+{
+	return time_ms > 0 ? count * MSEC_PER_SEC / time_ms : 0;
+}
+
+/*
+ * Log the per channel and aggregate throughput of producer or consumer threads
+ *
+ * The aggregate covers the window from the first thread start to the last thread end.
+ *
+ * @role [in]: Thread role, for logging
+ * @threads [in]: Producer or consumer threads
+ * @nb_threads [in]: Number of threads
+ * @msg_size [in]: Size of each message in bytes
+ */
+static void report_throughput(const char *role, struct sc_thread_ctx *threads, uint32_t nb_threads, uint32_t msg_size)
+{
+	struct timespec *first_start = NULL, *last_end = NULL;
+	struct t_results *res;
+	uint64_t total_msgs = 0;
+	double time_ms;
+	uint32_t i;
+
+	for (i = 0; i < nb_threads; i++) {
+		res = &threads[i].result;
+		time_ms = calculate_timediff_ms(&res->end_time, &res->start_time);
+		DOCA_LOG_INFO("%s channel %u: %u messages in approximately %0.4f milliseconds, %.0f msg/s, %.3f GB/s",
+			      role,
+			      i,
+			      res->processed_msgs,
+			      time_ms,
+			      calculate_rate(res->processed_msgs, time_ms),
+			      calculate_rate((double)res->processed_msgs * msg_size, time_ms) / BYTES_PER_GB);
+
+		total_msgs += res->processed_msgs;
+		if (first_start == NULL || calculate_timediff_ms(first_start, &res->start_time) > 0)
+			first_start = &res->start_time;
+		if (last_end == NULL || calculate_timediff_ms(&res->end_time, last_end) > 0)
+			last_end = &res->end_time;
+	}
+
+	if (nb_threads < 2)
+		return;
+
+	time_ms = calculate_timediff_ms(last_end, first_start);
+	DOCA_LOG_INFO("%s all %u channels: %lu messages in approximately %0.4f milliseconds, %.0f msg/s, %.3f GB/s",
+		      role,
+		      nb_threads,
+		      total_msgs,
+		      time_ms,
+		      calculate_rate(total_msgs, time_ms),
+		      calculate_rate((double)total_msgs * msg_size, time_ms) / BYTES_PER_GB);
+}
+
 doca_error_t sc_start(struct comch_cfg *comch_cfg, struct sc_config *cfg, struct cc_ctx *ctx)
 {
-	struct t_results send_result = {0};
-	struct t_results recv_result = {0};
-	pthread_t sendto_thread, recvfrom_thread;
-	doca_error_t result;
 	struct metadata_msg meta = {0};
+	doca_error_t result;
+	int i;
 
 	ctx->comch_connection = comch_util_get_connection(comch_cfg);
 	ctx->cfg = cfg;
 
-	/* Send a comch metadata message to the other side indicating the number of fastpath messages */
+	/* Send a comch metadata message to the other side indicating the number of fastpath messages and channels */
 	meta.type = START_MSG;
 	meta.num_msgs = htonl(cfg->send_msg_nb);
 	meta.msg_size = htonl(cfg->send_msg_size);
+	meta.num_channels = htonl(cfg->nb_channels);
 	result = comch_utils_send(comch_util_get_connection(comch_cfg), &meta, sizeof(struct metadata_msg));
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to send metadata message: %s", doca_error_get_descr(result));
@@ -965,26 +1203,32 @@ doca_error_t sc_start(struct comch_cfg *comch_cfg, struct sc_config *cfg, struct
 		return DOCA_ERROR_INVALID_VALUE;
 	}
 
-	ctx->sendto_t = &sendto_thread;
-	ctx->recvfrom_t = &recvfrom_thread;
-	ctx->send_result = &send_result;
-	ctx->recv_result = &recv_result;
+	ctx->producers = (struct sc_thread_ctx *)calloc(cfg->nb_channels, sizeof(struct sc_thread_ctx));
+	ctx->consumers = (struct sc_thread_ctx *)calloc(ctx->expected_channels, sizeof(struct sc_thread_ctx));
+	if (ctx->producers == NULL || ctx->consumers == NULL) {
+		DOCA_LOG_ERR("Failed to allocate fast path thread contexts");
+		result = DOCA_ERROR_NO_MEMORY;
+		goto free_threads;
+	}
 
 	result = start_threads(ctx, comch_cfg);
-	if (result != DOCA_SUCCESS) {
-		return result;
-	}
+	if (result != DOCA_SUCCESS)
+		goto free_threads;
 
-	result = ctx->send_result->result;
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Send thread finished unsuccessfully");
-		return result;
+	for (i = 0; i < cfg->nb_channels; i++) {
+		result = ctx->producers[i].result.result;
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Send thread of channel %d finished unsuccessfully", i);
+			goto free_threads;
+		}
 	}
 
-	result = ctx->recv_result->result;
-	if (result != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Receive thread finished unsuccessfully");
-		return result;
+	for (i = 0; i < ctx->expected_channels; i++) {
+		result = ctx->consumers[i].result.result;
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Receive thread of channel %d finished unsuccessfully", i);
+			goto free_threads;
+		}
 	}
 
 	/*
@@ -997,25 +1241,26 @@ doca_error_t sc_start(struct comch_cfg *comch_cfg, struct sc_config *cfg, struct
 		result = comch_utils_send(comch_util_get_connection(comch_cfg), &meta, sizeof(struct metadata_msg));
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to send metadata message: %s", doca_error_get_descr(result));
-			return result;
+			goto free_threads;
 		}
 	} else {
 		while (ctx->expected_msgs != 0) {
 			result = comch_utils_progress_connection(comch_util_get_connection(comch_cfg));
 			if (result != DOCA_SUCCESS) {
 				DOCA_LOG_ERR("Failed to progress comch: %s", doca_error_get_descr(result));
-				return result;
+				goto free_threads;
 			}
 		}
 	}
 
-	DOCA_LOG_INFO("Producer sent %u messages in approximately %0.4f milliseconds",
-		      ctx->send_result->processed_msgs,
-		      calculate_timediff_ms(&ctx->send_result->end_time, &ctx->send_result->start_time));
-	DOCA_LOG_INFO("Consumer received %u messages in approximately %0.4f milliseconds",
-		      ctx->recv_result->processed_msgs,
-		      calculate_timediff_ms(&ctx->recv_result->end_time, &ctx->recv_result->start_time));
+	report_throughput("Producer", ctx->producers, cfg->nb_channels, cfg->send_msg_size);
+	report_throughput("Consumer", ctx->consumers, ctx->expected_channels, ctx->expected_msg_size);
 
+free_threads:
+	free(ctx->producers);
+	free(ctx->consumers);
+	ctx->producers = NULL;
+	ctx->consumers = NULL;
 	return result;
 }
 
@@ -1024,6 +1269,7 @@ doca_error_t register_secure_channel_params(void)
 	doca_error_t result;
 
 	struct doca_argp_param *message_size_param, *messages_number_param, *pci_addr_param, *rep_pci_addr_param;
+	struct doca_argp_param *channels_number_param, *core_list_param;
 
 	/* Create and register message to send param */
 	result = doca_argp_param_create(&message_size_param);
@@ -1051,7 +1297,7 @@ doca_error_t register_secure_channel_params(void)
 	}
 	doca_argp_param_set_short_name(messages_number_param, "n");
 	doca_argp_param_set_long_name(messages_number_param, "num-msgs");
-	doca_argp_param_set_description(messages_number_param, "Number of messages to be sent");
+	doca_argp_param_set_description(messages_number_param, "Number of messages to be sent on each channel");
 	doca_argp_param_set_callback(messages_number_param, messages_number_callback);
 	doca_argp_param_set_type(messages_number_param, DOCA_ARGP_TYPE_INT);
 	doca_argp_param_set_mandatory(messages_number_param);
@@ -1061,6 +1307,43 @@ doca_error_t register_secure_channel_params(void)
 		return result;
 	}
 
+	/* Create and register number of channels param */
+	result = doca_argp_param_create(&channels_number_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(channels_number_param, "c");
+	doca_argp_param_set_long_name(channels_number_param, "channels");
+	doca_argp_param_set_description(channels_number_param,
+					"Number of producer/consumer pairs, each with its own thread, PE and memory");
+	doca_argp_param_set_callback(channels_number_param, channels_number_callback);
+	doca_argp_param_set_type(channels_number_param, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(channels_number_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register core list param */
+	result = doca_argp_param_create(&core_list_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(core_list_param, "cl");
+	doca_argp_param_set_long_name(core_list_param, "core-list");
+	doca_argp_param_set_arguments(core_list_param, "<list>");
+	doca_argp_param_set_description(core_list_param,
+					"Cores to pin producer/consumer threads to, round robin, e.g. \"0,2,4-7\"");
+	doca_argp_param_set_callback(core_list_param, core_list_callback);
+	doca_argp_param_set_type(core_list_param, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(core_list_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	/* Create and register Comm Channel DOCA device PCI address */
 	result = doca_argp_param_create(&pci_addr_param);
 	if (result != DOCA_SUCCESS) {
@@ -33,6 +33,9 @@
 
 #include "comch_utils.h"
 
+#define SC_MAX_CHANNELS 64 /* Maximum number of producer/consumer pairs */
+#define SC_MAX_CORES 256   /* Maximum number of cores fast path threads can be pinned to */
+
 enum sc_mode {
 	SC_MODE_HOST, /* Run endpoint in Host */
 	SC_MODE_DPU   /* Run endpoint in DPU */
@@ -41,7 +44,10 @@ enum sc_mode {
 struct sc_config {
 	enum sc_mode mode;					  /* Mode of operation */
 	int send_msg_size;					  /* Message size in bytes */
-	int send_msg_nb;					  /* Number of messages to send */
+	int send_msg_nb;					  /* Number of messages to send on each channel */
+	int nb_channels;					  /* Number of producer/consumer pairs */
+	int cores[SC_MAX_CORES];				  /* Cores to pin the fast path threads to */
+	int nb_cores;						  /* Number of cores, 0 to leave threads unpinned */
 	char cc_dev_pci_addr[DOCA_DEVINFO_PCI_ADDR_SIZE];	  /* Comm Channel DOCA device PCI address */
 	char cc_dev_rep_pci_addr[DOCA_DEVINFO_REP_PCI_ADDR_SIZE]; /* Comm Channel DOCA device representor PCI address */
 };
@@ -70,19 +76,31 @@ struct fast_path_ctx {
 	enum transfer_state state;  /* State the producer/consumer is in */
 };
 
+struct cc_ctx;
+
+/* Producer or consumer thread of a fast path channel, each one with its own PE, memory and tasks */
+struct sc_thread_ctx {
+	struct cc_ctx *ctx;	 /* Context shared by all the threads */
+	uint32_t channel;	 /* Index of the channel the thread serves */
+	int core;		 /* Core the thread is pinned to, negative if not pinned */
+	pthread_t thread;	 /* Thread handle */
+	struct t_results result; /* Final thread result */
+};
+
 struct cc_ctx {
-	struct sc_config *cfg;	       /* Secure Channel configuration */
-	pthread_t *sendto_t;	       /* Send thread ptr */
-	pthread_t *recvfrom_t;	       /* Receive thread ptr */
-	struct t_results *send_result; /* Final send thread result */
-	struct t_results *recv_result; /* Final recv thread result */
+	struct sc_config *cfg;		 /* Secure Channel configuration */
+	struct sc_thread_ctx *producers; /* Producer threads, one per local channel */
+	struct sc_thread_ctx *consumers; /* Consumer threads, one per channel of the opposite end */
 
 	struct doca_comch_connection *comch_connection; /* Comm channel for fast path control */
-	int expected_msgs;				/* Total messages consumer expects to receive */
+	int expected_msgs;				/* Total messages each consumer expects to receive */
 	int expected_msg_size;				/* Size of messages consumer expects to receive */
-	uint32_t consumer_id; /* ID of consumer created at the opposite end on comch_connection */
+	int expected_channels;				/* Number of channels the opposite end produces on */
+	uint32_t consumer_ids[SC_MAX_CHANNELS];		/* Consumers created by the opposite end */
+	atomic_uint nb_consumer_ids;			/* Number of valid consumer_ids */
 
 	atomic_int active_threads; /* Thread safe counter for detached threads */
+	atomic_bool stop_threads;  /* Set to make the detached threads give up and exit */
 };
 
 enum msg_type {
@@ -92,9 +110,10 @@ enum msg_type {
 
 /* Initial message sent from both sides to configure the opposite end */
 struct metadata_msg {
-	enum msg_type type; /* Indicates the type of message sent */
-	uint32_t num_msgs;  /* Number of messages producer intends to send */
-	uint32_t msg_size;  /* Size of producer messages */
+	enum msg_type type;    /* Indicates the type of message sent */
+	uint32_t num_msgs;     /* Number of messages producer intends to send */
+	uint32_t msg_size;     /* Size of producer messages */
+	uint32_t num_channels; /* Number of producer/consumer pairs the sender runs */
 };
 
 /*
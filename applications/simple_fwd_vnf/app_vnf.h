@@ -35,7 +35,9 @@ struct app_vnf {
 	int (*vnf_init)(void *p); /* A function pointer for initializing all application resources */
 	int (*vnf_process_pkt)(struct simple_fwd_pkt_info *pinfo); /* A function pointer for processing the packets */
 	void (*vnf_flow_age)(uint32_t port_id, uint16_t queue);	   /* A function pointer for the aging handling */
+	void (*vnf_flow_offload)(uint32_t port_id, uint16_t queue); /* A function pointer for draining offload completions */
 	int (*vnf_dump_stats)(uint32_t port_id);		   /* A function pointer for dumping the stats */
+	int (*vnf_route_pkt)(struct simple_fwd_pkt_info *pinfo, uint16_t *port_id); /* Routes SW forwarded packets */
 	int (*vnf_destroy)(void); /* A function pointer for destroying all allocated application resources */
 };
 
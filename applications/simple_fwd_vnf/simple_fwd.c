@@ -26,8 +26,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 #include <arpa/inet.h>
 
+#include <rte_common.h>
+#include <rte_malloc.h>
 #include <rte_random.h>
 
 #include <doca_flow.h>
@@ -73,16 +76,131 @@ DOCA_LOG_REGISTER(SIMPLE_FWD);
 #define PULL_TIME_OUT 10000 /* Maximum timeout for pulling */
 #define NB_ACTION_ARRAY (1) /* Used as the size of muti-actions array for DOCA Flow API */
 #define NB_ACTION_DESC (1)  /* Used as the size of muti-action descs array for DOCA Flow API */
+#define VXLAN_ROUTED_ACTION_IDX (1) /* VXLAN pipe actions that also set the next hop MAC, used with routing */
+#define MAX_PENDING_ENTRIES (128) /* Maximum number of queued and not yet completed new flows per pipe queue */
+#define MAX_COMPLETIONS (64)	  /* Maximum number of entries completions handled per poll */
 
 static struct simple_fwd_app *simple_fwd_ins; /* Instance holding all allocated resources needed for a proper run */
 
 /* user context struct that will be used in entries process callback */
 struct entries_status {
-	bool failure;	  /* will be set to true if some entry status will not be success */
-	int nb_processed; /* will hold the number of entries that was already processed */
-	void *ft_entry;	  /* pointer to struct simple_fwd_ft_entry */
+	bool failure;				/* will be set to true if some entry status will not be success */
+	int nb_processed;			/* will hold the number of entries that was already processed */
+	void *ft_entry;				/* pointer to struct simple_fwd_ft_entry */
+	uint32_t age_sec;			/* aging time requested for the entry */
+	struct simple_fwd_queue_ctx *queue_ctx; /* owning pool, NULL if the status was allocated on the heap */
 };
 
+/* New flows offload statistics of a pipe queue */
+struct simple_fwd_offload_stats {
+	uint64_t queued;      /* Number of new flows queued for HW insertion */
+	uint64_t offloaded;   /* Number of new flows successfully inserted to HW */
+	uint64_t failed;      /* Number of new flows failed HW insertion */
+	uint64_t deferred;    /* Number of new flows not queued since the queue was full */
+	uint64_t sw_fwd_pkts; /* Number of packets forwarded in SW while their flow insertion was pending */
+	uint64_t no_route;    /* Number of new flows whose destination matched no route */
+};
+
+/*
+ * Per pipe queue resources for asynchronous offload of new flows, only the core polling the queue writes them and
+ * the stats core reads the counters, hence every queue gets its own cache lines
+ */
+struct simple_fwd_queue_ctx {
+	struct entries_status *statuses;       /* Pool of entries status objects */
+	struct entries_status **free_statuses; /* Stack of the unused entries status objects of the pool */
+	uint32_t nb_free;		       /* Number of unused entries status objects */
+	uint32_t nb_pending;		       /* Number of queued and not yet completed new flows */
+	struct simple_fwd_offload_stats stats; /* Offload statistics of the queue */
+} __rte_cache_aligned;
+
+/*
+ * Increment a counter read by the stats core, the caller is the only writer of the counter
+ *
+ * @counter [in/out]: counter to increment
+ */
+static inline void simple_fwd_stat_inc(uint64_t *counter)
+{
+	__atomic_store_n(counter, *counter + 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Get an entries status object from the pipe queue pool
+ *
+ * @queue_ctx [in]: pipe queue resources
+ * @return: entries status object on success and NULL when the pool is exhausted
+ */
+static struct entries_status *simple_fwd_get_entries_status(struct simple_fwd_queue_ctx *queue_ctx)
+{
+	struct entries_status *status;
+
+	if (queue_ctx->nb_free == 0)
+		return NULL;
+	status = queue_ctx->free_statuses[--queue_ctx->nb_free];
+	memset(status, 0, sizeof(*status));
+	status->queue_ctx = queue_ctx;
+	return status;
+}
+
+/*
+ * Return an entries status object to its pipe queue pool
+ *
+ * @status [in]: entries status object to release
+ */
+static void simple_fwd_put_entries_status(struct entries_status *status)
+{
+	struct simple_fwd_queue_ctx *queue_ctx = status->queue_ctx;
+
+	queue_ctx->free_statuses[queue_ctx->nb_free++] = status;
+}
+
+/*
+ * Release an entries status object, whether it belongs to a pool or was allocated on the heap
+ *
+ * @status [in]: entries status object to release
+ */
+static void simple_fwd_release_entries_status(struct entries_status *status)
+{
+	if (status->queue_ctx != NULL)
+		simple_fwd_put_entries_status(status);
+	else
+		free(status);
+}
+
+/*
+ * Complete the asynchronous HW insertion of a new flow
+ *
+ * On success the flow is marked as offloaded and its aging is armed, otherwise the flow is removed from the flow
+ * table so the next packet of the connection will retry the insertion. Recycled flows are removed once offloaded, so
+ * generated connections measure the insertion rate without filling the flow table.
+ *
+ * @status [in]: entries status object of the inserted entry
+ */
+static void simple_fwd_complete_new_flow(struct entries_status *status)
+{
+	struct simple_fwd_queue_ctx *queue_ctx = status->queue_ctx;
+	struct simple_fwd_ft_user_ctx *ctx = (struct simple_fwd_ft_user_ctx *)status->ft_entry;
+	struct simple_fwd_pipe_entry *entry = (struct simple_fwd_pipe_entry *)&ctx->data[0];
+	struct simple_fwd_ft_entry *ft_entry = GET_FT_ENTRY(ctx);
+
+	__atomic_store_n(&queue_ctx->nb_pending, queue_ctx->nb_pending - 1, __ATOMIC_RELAXED);
+	if (status->failure) {
+		__atomic_store_n(&entry->is_pending, false, __ATOMIC_RELEASE);
+		simple_fwd_stat_inc(&queue_ctx->stats.failed);
+		entry->hw_entry = NULL;
+		simple_fwd_ft_destroy_entry(simple_fwd_ins->ft, ft_entry);
+		simple_fwd_put_entries_status(status);
+		return;
+	}
+	entry->is_hw = true;
+	simple_fwd_ft_update_age_sec(ft_entry, status->age_sec);
+	simple_fwd_ft_update_expiration(ft_entry);
+	/* Aging only considers the entry once its HW entry and expiration are set */
+	__atomic_store_n(&entry->is_pending, false, __ATOMIC_RELEASE);
+	simple_fwd_stat_inc(&queue_ctx->stats.offloaded);
+	if (entry->recycle)
+		simple_fwd_ft_destroy_entry(simple_fwd_ins->ft, ft_entry);
+}
+
 /*
  * Entry processing callback
  *
@@ -103,6 +221,8 @@ static void simple_fwd_check_for_valid_entry(struct doca_flow_pipe_entry *entry,
 	(void)pipe_queue;
 
 	struct simple_fwd_ft_entry *ft_entry;
+	struct simple_fwd_ft_user_ctx *ctx;
+	struct simple_fwd_pipe_entry *fwd_entry;
 	struct entries_status *entry_status = (struct entries_status *)user_ctx;
 
 	if (entry_status == NULL)
@@ -110,14 +230,21 @@ static void simple_fwd_check_for_valid_entry(struct doca_flow_pipe_entry *entry,
 	if (status != DOCA_FLOW_ENTRY_STATUS_SUCCESS)
 		entry_status->failure = true; /* set failure to true if processing failed */
 	if (op == DOCA_FLOW_ENTRY_OP_AGED) {
-		ft_entry = GET_FT_ENTRY((void *)(entry_status->ft_entry));
+		/* A pending entry is released by its insertion completion, it must not age before */
+		ctx = (struct simple_fwd_ft_user_ctx *)entry_status->ft_entry;
+		fwd_entry = (struct simple_fwd_pipe_entry *)&ctx->data[0];
+		if (__atomic_load_n(&fwd_entry->is_pending, __ATOMIC_ACQUIRE))
+			return;
+		ft_entry = GET_FT_ENTRY(ctx);
 		simple_fwd_ft_destroy_entry(simple_fwd_ins->ft, ft_entry);
-	} else if (op == DOCA_FLOW_ENTRY_OP_ADD)
+	} else if (op == DOCA_FLOW_ENTRY_OP_ADD) {
 		entry_status->nb_processed++;
-	else if (op == DOCA_FLOW_ENTRY_OP_DEL) {
+		if (entry_status->queue_ctx != NULL)
+			simple_fwd_complete_new_flow(entry_status);
+	} else if (op == DOCA_FLOW_ENTRY_OP_DEL) {
 		entry_status->nb_processed--;
 		if (entry_status->nb_processed == 0)
-			free(entry_status);
+			simple_fwd_release_entries_status(entry_status);
 	}
 }
 
@@ -313,6 +440,55 @@ static void simple_fwd_aged_flow_cb(struct simple_fwd_ft_user_ctx *ctx)
 	}
 }
 
+/*
+ * Destroy the per pipe queue offload resources
+ */
+static void simple_fwd_destroy_queue_ctx(void)
+{
+	uint16_t queue;
+
+	if (simple_fwd_ins->queue_ctx == NULL)
+		return;
+	for (queue = 0; queue < simple_fwd_ins->nb_queues; queue++) {
+		free(simple_fwd_ins->queue_ctx[queue].statuses);
+		free(simple_fwd_ins->queue_ctx[queue].free_statuses);
+	}
+	rte_free(simple_fwd_ins->queue_ctx);
+	simple_fwd_ins->queue_ctx = NULL;
+}
+
+/*
+ * Allocate the per pipe queue offload resources, each queue gets a pool of entries status objects large enough
+ * for all the flows the application may hold
+ *
+ * @return: 0 on success and negative value otherwise
+ */
+static int simple_fwd_create_queue_ctx(void)
+{
+	struct simple_fwd_queue_ctx *queue_ctx;
+	uint16_t queue;
+	uint32_t idx;
+
+	simple_fwd_ins->queue_ctx = rte_calloc("simple_fwd_queue_ctx",
+					       simple_fwd_ins->nb_queues,
+					       sizeof(struct simple_fwd_queue_ctx),
+					       RTE_CACHE_LINE_SIZE);
+	if (simple_fwd_ins->queue_ctx == NULL)
+		return -1;
+
+	for (queue = 0; queue < simple_fwd_ins->nb_queues; queue++) {
+		queue_ctx = &simple_fwd_ins->queue_ctx[queue];
+		queue_ctx->statuses = calloc(SIMPLE_FWD_MAX_FLOWS, sizeof(struct entries_status));
+		queue_ctx->free_statuses = calloc(SIMPLE_FWD_MAX_FLOWS, sizeof(struct entries_status *));
+		if (queue_ctx->statuses == NULL || queue_ctx->free_statuses == NULL)
+			return -1;
+		for (idx = 0; idx < SIMPLE_FWD_MAX_FLOWS; idx++)
+			queue_ctx->free_statuses[idx] = &queue_ctx->statuses[idx];
+		queue_ctx->nb_free = SIMPLE_FWD_MAX_FLOWS;
+	}
+	return 0;
+}
+
 /*
  * Destroy flow table used by the application
  *
@@ -320,17 +496,31 @@ static void simple_fwd_aged_flow_cb(struct simple_fwd_ft_user_ctx *ctx)
  */
 static int simple_fwd_destroy_ins(void)
 {
-	uint16_t idx;
+	uint16_t idx, queue;
 
 	if (simple_fwd_ins == NULL)
 		return 0;
 
-	simple_fwd_ft_destroy(simple_fwd_ins->ft);
+	/* Complete all pending insertions before the flow table entries are released */
+	for (idx = 0; idx < SIMPLE_FWD_PORTS; idx++) {
+		if (simple_fwd_ins->ports[idx] == NULL || simple_fwd_ins->queue_ctx == NULL)
+			continue;
+		for (queue = 0; queue < simple_fwd_ins->nb_queues; queue++)
+			doca_flow_entries_process(simple_fwd_ins->ports[idx],
+						  queue,
+						  PULL_TIME_OUT,
+						  MAX_PENDING_ENTRIES);
+	}
+
+	if (simple_fwd_ins->ft != NULL)
+		simple_fwd_ft_destroy(simple_fwd_ins->ft);
+	simple_fwd_route_table_destroy(simple_fwd_ins->routes);
 
 	for (idx = 0; idx < SIMPLE_FWD_PORTS; idx++) {
 		if (simple_fwd_ins->ports[idx])
 			doca_flow_port_stop(simple_fwd_ins->ports[idx]);
 	}
+	simple_fwd_destroy_queue_ctx();
 	free(simple_fwd_ins);
 	simple_fwd_ins = NULL;
 	return 0;
@@ -356,6 +546,7 @@ static int simple_fwd_destroy(void)
  */
 static int simple_fwd_create_ins(struct simple_fwd_port_cfg *port_cfg)
 {
+	doca_error_t result;
 	uint16_t index;
 
 	simple_fwd_ins = (struct simple_fwd_app *)
@@ -375,8 +566,22 @@ static int simple_fwd_create_ins(struct simple_fwd_port_cfg *port_cfg)
 		goto fail_init;
 	}
 	simple_fwd_ins->nb_queues = port_cfg->nb_queues;
+	if (simple_fwd_create_queue_ctx() < 0) {
+		DOCA_LOG_ERR("Failed to allocate queues offload resources");
+		goto fail_init;
+	}
 	for (index = 0; index < SIMPLE_FWD_PORTS; index++)
 		simple_fwd_ins->hairpin_peer[index] = index ^ 1;
+	if (port_cfg->route_file != NULL) {
+		result = simple_fwd_route_table_load(port_cfg->route_file,
+						     SIMPLE_FWD_PORTS,
+						     port_cfg->route_bench,
+						     &simple_fwd_ins->routes);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to load routing table: %s", doca_error_get_descr(result));
+			goto fail_init;
+		}
+	}
 	return 0;
 fail_init:
 	simple_fwd_destroy_ins();
@@ -633,7 +838,7 @@ static void simple_fwd_build_pipe_common_match_fields(struct doca_flow_match *ma
 static int simple_fwd_create_match_pipe(struct simple_fwd_port_cfg *port_cfg, enum doca_flow_tun_type type)
 {
 	struct doca_flow_match match;
-	struct doca_flow_actions actions, *actions_arr[NB_ACTION_ARRAY];
+	struct doca_flow_actions actions, routed_actions, *actions_arr[VXLAN_ROUTED_ACTION_IDX + 1];
 	struct doca_flow_action_descs descs;
 	struct doca_flow_monitor monitor;
 	struct doca_flow_fwd fwd;
@@ -641,6 +846,7 @@ static int simple_fwd_create_match_pipe(struct simple_fwd_port_cfg *port_cfg, en
 	struct doca_flow_pipe_cfg *pipe_cfg;
 	struct doca_flow_pipe **pipe;
 	const char *pipe_name;
+	int nb_actions = NB_ACTION_ARRAY;
 	doca_error_t result;
 
 	memset(&match, 0, sizeof(match));
@@ -665,6 +871,13 @@ static int simple_fwd_create_match_pipe(struct simple_fwd_port_cfg *port_cfg, en
 		actions.meta.pkt_meta = DOCA_HTOBE32(1);
 		actions.decap_type = DOCA_FLOW_RESOURCE_TYPE_NON_SHARED;
 		actions.decap_cfg.is_l2 = true;
+		/* Routed entries address the decapped frame to the next hop, as the SW path does */
+		if (simple_fwd_ins->routes != NULL) {
+			routed_actions = actions;
+			SET_MAC_ADDR(routed_actions.outer.eth.dst_mac, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+			actions_arr[VXLAN_ROUTED_ACTION_IDX] = &routed_actions;
+			nb_actions = VXLAN_ROUTED_ACTION_IDX + 1;
+		}
 		pipe = &simple_fwd_ins->pipe_vxlan[port_cfg->port_id];
 		break;
 	case DOCA_FLOW_TUN_GTPU:
@@ -728,7 +941,7 @@ static int simple_fwd_create_match_pipe(struct simple_fwd_port_cfg *port_cfg, en
 		DOCA_LOG_ERR("Failed to set doca_flow_pipe_cfg match: %s", doca_error_get_descr(result));
 		goto destroy_pipe_cfg;
 	}
-	result = doca_flow_pipe_cfg_set_actions(pipe_cfg, actions_arr, NULL, NULL, NB_ACTION_ARRAY);
+	result = doca_flow_pipe_cfg_set_actions(pipe_cfg, actions_arr, NULL, NULL, nb_actions);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to set doca_flow_pipe_cfg actions: %s", doca_error_get_descr(result));
 		goto destroy_pipe_cfg;
@@ -739,7 +952,11 @@ static int simple_fwd_create_match_pipe(struct simple_fwd_port_cfg *port_cfg, en
 		goto destroy_pipe_cfg;
 	}
 
-	simple_fwd_build_fwd(port_cfg, &fwd);
+	/* With routing the next hop of each flow is resolved when its entry is added */
+	if (simple_fwd_ins->routes != NULL)
+		fwd.type = DOCA_FLOW_FWD_CHANGEABLE;
+	else
+		simple_fwd_build_fwd(port_cfg, &fwd);
 
 	fwd_miss.type = DOCA_FLOW_FWD_PIPE;
 	fwd_miss.next_pipe = simple_fwd_ins->pipe_rss[port_cfg->port_id];
@@ -1323,6 +1540,43 @@ static void simple_fwd_build_entry_monitor(struct simple_fwd_pkt_info *pinfo, st
 	monitor->aging_sec = (uint32_t)rte_rand() % 55 + 5;
 }
 
+/*
+ * Build the forwarding of a routed entry, the next hop is selected by the longest prefix match of the outer
+ * destination and the RSS hash picks the ECMP group member, so all the packets of a flow use the same next hop.
+ * Flows without a route keep the forwarding used when routing is disabled.
+ *
+ * @pinfo [in]: the packet info as represented in the application
+ * @actions [out]: the actions component, its destination MAC is set to the next hop one
+ * @fwd [out]: the forward component to build
+ */
+static void simple_fwd_build_entry_fwd(struct simple_fwd_pkt_info *pinfo,
+				       struct doca_flow_actions *actions,
+				       struct doca_flow_fwd *fwd)
+{
+	struct simple_fwd_port_cfg port_cfg = {0};
+	struct simple_fwd_port_cfg *orig_port_cfg;
+	const struct simple_fwd_route_nh *nh;
+
+	nh = simple_fwd_route_lookup_ipv4(simple_fwd_ins->routes,
+					  simple_fwd_pinfo_outer_ipv4_dst(pinfo),
+					  pinfo->rss_hash);
+	if (nh == NULL) {
+		simple_fwd_stat_inc(&simple_fwd_ins->queue_ctx[pinfo->pipe_queue].stats.no_route);
+		orig_port_cfg = doca_flow_port_priv_data(simple_fwd_ins->ports[pinfo->orig_port_id]);
+		port_cfg.port_id = pinfo->orig_port_id;
+		port_cfg.is_hairpin = orig_port_cfg->is_hairpin;
+		simple_fwd_build_fwd(&port_cfg, fwd);
+		return;
+	}
+
+	fwd->type = DOCA_FLOW_FWD_PORT;
+	fwd->port_id = nh->port_id;
+	memcpy(actions->outer.eth.dst_mac, nh->mac, DOCA_FLOW_ETHER_ADDR_LEN);
+	/* VXLAN entries only modify the MAC of the decapped frame through the routed actions */
+	if (pinfo->tun_type == DOCA_FLOW_TUN_VXLAN)
+		actions->action_idx = VXLAN_ROUTED_ACTION_IDX;
+}
+
 /*
  * Selects the pipe based on the tunneling type
  *
@@ -1341,86 +1595,71 @@ static struct doca_flow_pipe *simple_fwd_select_pipe(struct simple_fwd_pkt_info
 }
 
 /*
- * Adds new entry, with respect to the packet info, to the flow table
+ * Queues insertion of a new entry, with respect to the packet info, without waiting for its completion
  *
  * @pinfo [in]: the packet info as represented in the application
+ * @status [in]: entries status object, owned by the entry once it was queued
  * @user_ctx [in]: user context
- * @age_sec [out]: Aging time for the created entry in seconds
  * @return: created entry pointer on success and NULL otherwise
  */
 static struct doca_flow_pipe_entry *simple_fwd_pipe_add_entry(struct simple_fwd_pkt_info *pinfo,
-							      void *user_ctx,
-							      uint32_t *age_sec)
+							      struct entries_status *status,
+							      void *user_ctx)
 {
 	struct doca_flow_match match;
 	struct doca_flow_monitor monitor = {};
 	struct doca_flow_actions actions = {0};
+	struct doca_flow_fwd fwd = {0};
 	struct doca_flow_pipe *pipe;
 	struct doca_flow_pipe_entry *entry;
-	struct entries_status *status;
-	int num_of_entries = 1;
 	doca_error_t result;
 
-	status = (struct entries_status *)calloc(1, sizeof(struct entries_status));
-
 	memset(&match, 0, sizeof(match));
 	memset(&actions, 0, sizeof(actions));
 
 	pipe = simple_fwd_select_pipe(pinfo);
 	if (pipe == NULL) {
 		DOCA_LOG_WARN("Failed to select pipe on this packet");
-		free(status);
 		return NULL;
 	}
 
 	actions.meta.pkt_meta = DOCA_HTOBE32(1);
 	actions.action_idx = 0;
 
-	status->ft_entry = user_ctx;
-
 	if (pinfo->tun_type != DOCA_FLOW_TUN_VXLAN) {
 		simple_fwd_build_entry_actions(&actions);
 	}
+	if (simple_fwd_ins->routes != NULL)
+		simple_fwd_build_entry_fwd(pinfo, &actions, &fwd);
 
 	simple_fwd_build_entry_match(pinfo, &match);
 	simple_fwd_build_entry_monitor(pinfo, &monitor);
+	status->ft_entry = user_ctx;
+	status->age_sec = monitor.aging_sec;
 	result = doca_flow_pipe_add_entry(pinfo->pipe_queue,
 					  pipe,
 					  &match,
 					  &actions,
 					  &monitor,
-					  NULL,
+					  simple_fwd_ins->routes != NULL ? &fwd : NULL,
 					  DOCA_FLOW_NO_WAIT,
 					  status,
 					  &entry);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed adding entry to pipe");
-		free(status);
 		return NULL;
 	}
 
-	result = doca_flow_entries_process(simple_fwd_ins->ports[pinfo->orig_port_id],
-					   pinfo->pipe_queue,
-					   PULL_TIME_OUT,
-					   num_of_entries);
-
-	if (result != DOCA_SUCCESS)
-		goto error;
-
-	if (status->nb_processed != num_of_entries || status->failure)
-		goto error;
-
-	*age_sec = monitor.aging_sec;
 	return entry;
-
-error:
-	doca_flow_pipe_remove_entry(pinfo->pipe_queue, DOCA_FLOW_NO_WAIT, entry);
-	return NULL;
 }
 
 /*
  * Adds new flow, with respect to the packet info, to the flow table
  *
+ * The HW insertion is only queued, packets of the flow are forwarded in SW until the insertion is completed by
+ * simple_fwd_handle_offload(). When too many insertions are pending on the queue the flow is not added, and the
+ * next packet of the connection will try again.
+ *
  * @pinfo [in]: the packet info as represented in the application
  * @ctx [in]: user context
  * @return: 0 on success and negative value otherwise
@@ -1428,26 +1667,41 @@ error:
 static int simple_fwd_handle_new_flow(struct simple_fwd_pkt_info *pinfo, struct simple_fwd_ft_user_ctx **ctx)
 {
 	doca_error_t result;
+	struct simple_fwd_queue_ctx *queue_ctx = &simple_fwd_ins->queue_ctx[pinfo->pipe_queue];
 	struct simple_fwd_pipe_entry *entry = NULL;
 	struct simple_fwd_ft_entry *ft_entry;
-	uint32_t age_sec;
+	struct entries_status *status;
+
+	if (queue_ctx->nb_pending >= MAX_PENDING_ENTRIES) {
+		simple_fwd_stat_inc(&queue_ctx->stats.deferred);
+		return -1;
+	}
+	status = simple_fwd_get_entries_status(queue_ctx);
+	if (status == NULL) {
+		DOCA_LOG_DBG("No free entries status on queue %u", pinfo->pipe_queue);
+		simple_fwd_stat_inc(&queue_ctx->stats.deferred);
+		return -1;
+	}
 
 	result = simple_fwd_ft_add_new(simple_fwd_ins->ft, pinfo, ctx);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_DBG("Failed create new entry");
+		simple_fwd_put_entries_status(status);
 		return -1;
 	}
 	ft_entry = GET_FT_ENTRY(*ctx);
 	entry = (struct simple_fwd_pipe_entry *)&(*ctx)->data[0];
 	entry->pipe_queue = pinfo->pipe_queue;
-	entry->hw_entry = simple_fwd_pipe_add_entry(pinfo, (void *)(*ctx), &age_sec);
+	entry->recycle = pinfo->recycle;
+	entry->hw_entry = simple_fwd_pipe_add_entry(pinfo, status, (void *)(*ctx));
 	if (entry->hw_entry == NULL) {
+		simple_fwd_put_entries_status(status);
 		simple_fwd_ft_destroy_entry(simple_fwd_ins->ft, ft_entry);
 		return -1;
 	}
-	simple_fwd_ft_update_age_sec(ft_entry, age_sec);
-	simple_fwd_ft_update_expiration(ft_entry);
-	entry->is_hw = true;
+	__atomic_store_n(&entry->is_pending, true, __ATOMIC_RELEASE);
+	__atomic_store_n(&queue_ctx->nb_pending, queue_ctx->nb_pending + 1, __ATOMIC_RELAXED);
+	simple_fwd_stat_inc(&queue_ctx->stats.queued);
 
 	return 0;
 }
@@ -1491,6 +1745,8 @@ static int simple_fwd_handle_packet(struct simple_fwd_pkt_info *pinfo)
 	}
 	entry = (struct simple_fwd_pipe_entry *)&ctx->data[0];
 	entry->total_pkts++;
+	if (entry->is_pending)
+		simple_fwd_stat_inc(&simple_fwd_ins->queue_ctx[pinfo->pipe_queue].stats.sw_fwd_pkts);
 
 	return 0;
 }
@@ -1510,6 +1766,72 @@ static void simple_fwd_handle_aging(uint32_t port_id, uint16_t queue)
 	doca_flow_aging_handle(simple_fwd_ins->ports[port_id], queue, MAX_HANDLING_TIME_MS, 0);
 }
 
+/*
+ * Handles completions of queued flows insertions and removals
+ *
+ * At most MAX_COMPLETIONS completions are handled per call so the packet processing loop is never blocked.
+ *
+ * @port_id [in]: port identifier of the port to handle its completions
+ * @queue [in]: queue index of the queue to handle its completions
+ */
+static void simple_fwd_handle_offload(uint32_t port_id, uint16_t queue)
+{
+	doca_error_t result;
+
+	if (queue >= simple_fwd_ins->nb_queues)
+		return;
+	result = doca_flow_entries_process(simple_fwd_ins->ports[port_id], queue, 0, MAX_COMPLETIONS);
+	if (result != DOCA_SUCCESS)
+		DOCA_LOG_DBG("Failed to process entries on queue %u: %s", queue, doca_error_get_descr(result));
+}
+
+/*
+ * Dump new flows offload statistics summed over all pipe queues
+ */
+static void simple_fwd_dump_offload_stats(void)
+{
+	static uint64_t prev_offloaded;
+	static uint64_t prev_tsc;
+	struct simple_fwd_offload_stats total = {0};
+	struct simple_fwd_offload_stats *stats;
+	uint64_t cur_tsc = rte_rdtsc();
+	uint64_t nb_pending = 0;
+	uint64_t cps = 0;
+	uint16_t queue;
+
+	for (queue = 0; queue < simple_fwd_ins->nb_queues; queue++) {
+		stats = &simple_fwd_ins->queue_ctx[queue].stats;
+		total.queued += __atomic_load_n(&stats->queued, __ATOMIC_RELAXED);
+		total.offloaded += __atomic_load_n(&stats->offloaded, __ATOMIC_RELAXED);
+		total.failed += __atomic_load_n(&stats->failed, __ATOMIC_RELAXED);
+		total.deferred += __atomic_load_n(&stats->deferred, __ATOMIC_RELAXED);
+		total.sw_fwd_pkts += __atomic_load_n(&stats->sw_fwd_pkts, __ATOMIC_RELAXED);
+		total.no_route += __atomic_load_n(&stats->no_route, __ATOMIC_RELAXED);
+		nb_pending += __atomic_load_n(&simple_fwd_ins->queue_ctx[queue].nb_pending, __ATOMIC_RELAXED);
+	}
+	if (prev_tsc != 0 && cur_tsc > prev_tsc)
+		cps = (total.offloaded - prev_offloaded) * rte_get_timer_hz() / (cur_tsc - prev_tsc);
+	prev_offloaded = total.offloaded;
+	prev_tsc = cur_tsc;
+
+	fprintf(stdout, "\n  New flows offload (since start)\n");
+	fprintf(stdout,
+		"  Queued: %-10" PRIu64 " Offloaded: %-10" PRIu64 " Failed: %-10" PRIu64 " Deferred: %-10" PRIu64
+		"\n",
+		total.queued,
+		total.offloaded,
+		total.failed,
+		total.deferred);
+	fprintf(stdout,
+		"  Pending: %-10" PRIu64 " SW forwarded pending pkts: %-10" PRIu64 "\n",
+		nb_pending,
+		total.sw_fwd_pkts);
+	fprintf(stdout, "  Offloaded connections per second (since last show): %" PRIu64 "\n", cps);
+	if (simple_fwd_ins->routes != NULL)
+		fprintf(stdout, "  New flows without route: %" PRIu64 "\n", total.no_route);
+	fflush(stdout);
+}
+
 /*
  * Dump stats of the given port identifier
  *
@@ -1518,7 +1840,39 @@ static void simple_fwd_handle_aging(uint32_t port_id, uint16_t queue)
  */
 static int simple_fwd_dump_stats(uint32_t port_id)
 {
-	return simple_fwd_dump_port_stats(port_id, simple_fwd_ins->ports[port_id]);
+	int result;
+
+	result = simple_fwd_dump_port_stats(port_id, simple_fwd_ins->ports[port_id]);
+	if (result != 0)
+		return result;
+	simple_fwd_dump_offload_stats();
+	return 0;
+}
+
+/*
+ * Route a packet forwarded in SW the same way its HW entry is routed, the destination MAC of the frame sent is set
+ * to the next hop one for every tunnel type
+ *
+ * @pinfo [in]: the packet info as represented in the application
+ * @port_id [out]: egress port of the next hop
+ * @return: 0 on success and negative value when routing is disabled or no route matches
+ */
+static int simple_fwd_route_pkt(struct simple_fwd_pkt_info *pinfo, uint16_t *port_id)
+{
+	const struct simple_fwd_route_nh *nh;
+
+	if (simple_fwd_ins->routes == NULL)
+		return -1;
+
+	nh = simple_fwd_route_lookup_ipv4(simple_fwd_ins->routes,
+					  simple_fwd_pinfo_outer_ipv4_dst(pinfo),
+					  pinfo->rss_hash);
+	if (nh == NULL)
+		return -1;
+
+	memcpy(simple_fwd_pinfo_outer_mac_dst(pinfo), nh->mac, DOCA_FLOW_ETHER_ADDR_LEN);
+	*port_id = nh->port_id;
+	return 0;
 }
 
 /* Stores all functions pointers used by the application */
@@ -1526,7 +1880,9 @@ static struct app_vnf simple_fwd_vnf = {
 	.vnf_init = &simple_fwd_init,		      /* Simple Forward initialization resources function pointer */
 	.vnf_process_pkt = &simple_fwd_handle_packet, /* Simple Forward packet processing function pointer */
 	.vnf_flow_age = &simple_fwd_handle_aging,     /* Simple Forward aging handling function pointer */
+	.vnf_flow_offload = &simple_fwd_handle_offload, /* Simple Forward offload completions function pointer */
 	.vnf_dump_stats = &simple_fwd_dump_stats,     /* Simple Forward dumping stats function pointer */
+	.vnf_route_pkt = &simple_fwd_route_pkt,	      /* Simple Forward SW path routing function pointer */
 	.vnf_destroy = &simple_fwd_destroy,	      /* Simple Forward destroy allocated resources function pointer */
 };
 
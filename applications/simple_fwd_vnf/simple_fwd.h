@@ -33,10 +33,14 @@
 
 #include "simple_fwd_pkt.h"
 #include "simple_fwd_port.h"
+#include "simple_fwd_route.h"
 
 #define SIMPLE_FWD_PORTS (2)	    /* Number of ports used by the application */
 #define SIMPLE_FWD_MAX_FLOWS (8096) /* Maximum number of flows used/added by the application at a given time */
 
+/* Per pipe queue resources for asynchronous offload of new flows */
+struct simple_fwd_queue_ctx;
+
 /* Application resources, such as flow table, pipes and hairpin peers */
 struct simple_fwd_app {
 	struct simple_fwd_ft *ft;			       /* Flow table, used for stprng flows */
@@ -49,13 +53,17 @@ struct simple_fwd_app {
 	struct doca_flow_pipe *pipe_hairpin[SIMPLE_FWD_PORTS]; /* hairpin pipe for non-VxLAN/GRE/GTP traffic */
 	struct doca_flow_pipe *pipe_rss[SIMPLE_FWD_PORTS];     /* RSS pipe, matches every packet and forwards to SW */
 	struct doca_flow_pipe *vxlan_encap_pipe[SIMPLE_FWD_PORTS]; /* vxlan encap pipe on the egress domain */
+	struct simple_fwd_route_table *routes;			   /* LPM routing table, NULL if routing is disabled */
 	uint16_t nb_queues;					   /* flow age query item buffer */
+	struct simple_fwd_queue_ctx *queue_ctx;			   /* Offload resources of each pipe queue */
 	struct doca_flow_aged_query *query_array[0];		   /* buffer for flow aged query items */
 };
 
 /* Simple FWD flow entry representation */
 struct simple_fwd_pipe_entry {
 	bool is_hw;			       /* Wether the entry in HW or not */
+	bool is_pending;		       /* Whether the HW insertion was queued and not completed yet */
+	bool recycle;			       /* Whether the flow is removed as soon as its HW insertion completes */
 	uint64_t total_pkts;		       /* Total number of packets matched the flow */
 	uint64_t total_bytes;		       /* Total number of bytes matched the flow */
 	uint16_t pipe_queue;		       /* Pipe queue of the flow entry */
@@ -100,6 +100,20 @@ static bool simple_fwd_ft_update_counter(struct simple_fwd_ft_entry *e)
 	return update;
 }
 
+/*
+ * Check whether the HW insertion of an entry is still pending, such entry is released by the insertion completion
+ * and must not age before it
+ *
+ * @e [in]: flow entry representation in the application
+ * @return: true if the insertion is pending, false otherwise
+ */
+static bool simple_fwd_ft_is_pending(struct simple_fwd_ft_entry *e)
+{
+	struct simple_fwd_pipe_entry *entry = (struct simple_fwd_pipe_entry *)&e->user_ctx.data[0];
+
+	return __atomic_load_n(&entry->is_pending, __ATOMIC_ACQUIRE);
+}
+
 /*
  * Destroy flow entry in the flow table
  *
@@ -140,7 +154,8 @@ static bool simple_fwd_ft_aging_ft_entry(struct simple_fwd_ft *ft, unsigned int
 		node = LIST_FIRST(&ft->buckets[i].head);
 		while (node) {
 			ptr = LIST_NEXT(node, next);
-			if (node->age_sec && node->expiration < t && !simple_fwd_ft_update_counter(node)) {
+			if (!simple_fwd_ft_is_pending(node) && node->age_sec && node->expiration < t &&
+			    !simple_fwd_ft_update_counter(node)) {
 				DOCA_LOG_DBG("Aging removing flow");
 				_ft_destroy_entry(ft, node);
 				still_aging = true;
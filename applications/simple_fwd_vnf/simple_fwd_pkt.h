@@ -93,6 +93,7 @@ struct simple_fwd_pkt_info {
 	struct simple_fwd_pkt_tun_format tun; /* Tunneling parsing result*/
 	struct simple_fwd_pkt_format inner;   /* Inner packet parsing result */
 	int len;			      /* Length, in bytes, of the packet */
+	bool recycle;			      /* Remove the flow once offloaded, set for generated packets */
 };
 
 /*
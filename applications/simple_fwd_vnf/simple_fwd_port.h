@@ -30,12 +30,14 @@
 
 /* Simple FWD application's port configuration */
 struct simple_fwd_port_cfg {
-	uint16_t port_id;     /* Port identifier for the application */
-	uint16_t nb_queues;   /* Number of initialized queues descriptors (RX/TX) of the port */
-	uint32_t nb_meters;   /* Number of meters of the port used by the application */
-	uint32_t nb_counters; /* Number of counters for the port used by the application */
-	bool is_hairpin;      /* Number of hairpin queues */
-	bool age_thread;      /* Whether or not aging is handled by a dedicated thread */
+	uint16_t port_id;	/* Port identifier for the application */
+	uint16_t nb_queues;	/* Number of initialized queues descriptors (RX/TX) of the port */
+	uint32_t nb_meters;	/* Number of meters of the port used by the application */
+	uint32_t nb_counters;	/* Number of counters for the port used by the application */
+	bool is_hairpin;	/* Number of hairpin queues */
+	bool age_thread;	/* Whether or not aging is handled by a dedicated thread */
+	const char *route_file; /* Routing table file, NULL when next hop routing is disabled */
+	bool route_bench;	/* Whether to benchmark the lookups of the loaded routing table */
 };
 
 /*
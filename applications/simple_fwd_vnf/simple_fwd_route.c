@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <doca_log.h>
+
+#include "simple_fwd_route.h"
+
+DOCA_LOG_REGISTER(SIMPLE_FWD_ROUTE);
+
+#define ROUTE_TBL24_SIZE (1 << 24)	/* Number of tbl24 entries, indexed by the upper 24 bits of the address */
+#define ROUTE_TBL8_SIZE (256)		/* Number of entries of a tbl8 group, indexed by the lower 8 bits */
+#define ROUTE_ENTRY_VALID (1U << 31)	/* The entry holds a route */
+#define ROUTE_ENTRY_EXT (1U << 30)	/* The tbl24 entry points to a tbl8 group */
+#define ROUTE_ENTRY_DEPTH_SHIFT (24)	/* Offset of the prefix length in an entry */
+#define ROUTE_ENTRY_DEPTH_MASK (0x3f)	/* Mask of the prefix length in an entry */
+#define ROUTE_ENTRY_VAL_MASK (0xffffff) /* Mask of the ECMP group or tbl8 group index in an entry */
+#define ROUTE_MAX_TBL8 (1 << 18)	/* Maximum number of tbl8 groups, bounds the IPv4 table memory */
+#define ROUTE_IPV6_LEVELS (16)		/* Number of IPv6 trie levels, each one consumes a byte of the address */
+#define ROUTE_NODE_SIZE (256)		/* Number of slots of an IPv6 trie node */
+#define ROUTE_LINE_MAX (1024)		/* Maximum length of a routing table file line */
+#define ROUTE_BENCH_LOOKUPS (1 << 22)	/* Number of lookups done by the load time benchmark */
+#define ROUTE_DELIM " \t\r\n"		/* Delimiters of the routing table file fields */
+
+/* ECMP group, the set of next hops a prefix is routed to */
+struct route_group {
+	uint16_t nb_nh;						/* Number of next hops in the group */
+	struct simple_fwd_route_nh nh[SIMPLE_FWD_ROUTE_MAX_NH]; /* Next hops of the group */
+};
+
+/* IPv6 trie node, covers a single byte of the address */
+struct route6_node {
+	uint32_t group[ROUTE_NODE_SIZE]; /* ECMP group index + 1 of the longest prefix ending in the slot, 0 for none */
+	uint32_t child[ROUTE_NODE_SIZE]; /* Index of the next level node, 0 for none */
+	uint8_t depth[ROUTE_NODE_SIZE];	 /* Length of the prefix stored in the slot */
+};
+
+/* Longest prefix match routing table */
+struct simple_fwd_route_table {
+	uint32_t *tbl24;	    /* IPv4 first level, one entry per /24 */
+	uint32_t *tbl8;		    /* IPv4 second level groups, allocated for /24s holding longer prefixes */
+	uint32_t nb_tbl8;	    /* Number of used tbl8 groups */
+	uint32_t max_tbl8;	    /* Number of allocated tbl8 entries */
+	struct route6_node *nodes;  /* IPv6 trie nodes, the root is the first one */
+	uint32_t nb_nodes;	    /* Number of used IPv6 trie nodes */
+	uint32_t max_nodes;	    /* Number of allocated IPv6 trie nodes */
+	struct route_group *groups; /* ECMP groups, shared by all the prefixes with the same next hops */
+	uint32_t nb_groups;	    /* Number of used ECMP groups */
+	uint32_t max_groups;	    /* Number of allocated ECMP groups */
+	uint32_t nb_ipv4_routes;    /* Number of IPv4 prefixes loaded */
+	uint32_t nb_ipv6_routes;    /* Number of IPv6 prefixes loaded */
+};
+
+/*
+ * Make sure an array has room for a given number of elements, doubling its size when needed
+ *
+ * @arr [in/out]: the array to grow
+ * @max [in/out]: number of allocated elements
+ * @need [in]: number of elements needed
+ * @elem_size [in]: size of a single element
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_grow(void **arr, uint32_t *max, uint32_t need, size_t elem_size)
+{
+	uint32_t new_max;
+	void *tmp;
+
+	if (need <= *max)
+		return DOCA_SUCCESS;
+	new_max = *max == 0 ? 64 : *max;
+	while (new_max < need)
+		new_max *= 2;
+	tmp = realloc(*arr, (size_t)new_max * elem_size);
+	if (tmp == NULL) {
+		DOCA_LOG_ERR("Failed to allocate %u routing table elements", new_max);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+	*arr = tmp;
+	*max = new_max;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Get the index of an ECMP group, adding it when no identical group exists
+ *
+ * @table [in]: routing table
+ * @group [in]: ECMP group to look for
+ * @group_idx [out]: index of the group
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_add_group(struct simple_fwd_route_table *table,
+				    const struct route_group *group,
+				    uint32_t *group_idx)
+{
+	doca_error_t result;
+	uint32_t idx;
+
+	for (idx = 0; idx < table->nb_groups; idx++) {
+		if (memcmp(&table->groups[idx], group, sizeof(*group)) == 0) {
+			*group_idx = idx;
+			return DOCA_SUCCESS;
+		}
+	}
+	if (table->nb_groups > ROUTE_ENTRY_VAL_MASK) {
+		DOCA_LOG_ERR("Too many ECMP groups");
+		return DOCA_ERROR_FULL;
+	}
+	result = route_grow((void **)&table->groups, &table->max_groups, table->nb_groups + 1, sizeof(*group));
+	if (result != DOCA_SUCCESS)
+		return result;
+	table->groups[table->nb_groups] = *group;
+	*group_idx = table->nb_groups++;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Select the next hop of an ECMP group for a flow
+ *
+ * @table [in]: routing table
+ * @group_idx [in]: index of the ECMP group
+ * @hash [in]: flow hash
+ * @return: the selected next hop
+ */
+static inline const struct simple_fwd_route_nh *route_select_nh(const struct simple_fwd_route_table *table,
+								uint32_t group_idx,
+								uint32_t hash)
+{
+	const struct route_group *group = &table->groups[group_idx];
+
+	return &group->nh[hash % group->nb_nh];
+}
+
+/*
+ * Store a route in a range of DIR-24-8 entries, entries of longer prefixes are kept
+ *
+ * @entries [in]: first entry of the range
+ * @nb_entries [in]: number of entries in the range
+ * @depth [in]: prefix length of the route
+ * @entry [in]: encoded route entry
+ */
+static void route_ipv4_set_range(uint32_t *entries, uint32_t nb_entries, uint8_t depth, uint32_t entry)
+{
+	uint32_t i;
+
+	for (i = 0; i < nb_entries; i++) {
+		if (!(entries[i] & ROUTE_ENTRY_VALID) ||
+		    ((entries[i] >> ROUTE_ENTRY_DEPTH_SHIFT) & ROUTE_ENTRY_DEPTH_MASK) <= depth)
+			entries[i] = entry;
+	}
+}
+
+/*
+ * Add an IPv4 route to the DIR-24-8 tables
+ *
+ * Prefixes up to /24 are expanded over tbl24, longer prefixes move their /24 to a tbl8 group which inherits the
+ * route the tbl24 entry held.
+ *
+ * @table [in]: routing table
+ * @prefix [in]: masked prefix, host order
+ * @depth [in]: prefix length
+ * @group_idx [in]: ECMP group of the route
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_ipv4_add(struct simple_fwd_route_table *table,
+				   uint32_t prefix,
+				   uint8_t depth,
+				   uint32_t group_idx)
+{
+	uint32_t entry = ROUTE_ENTRY_VALID | ((uint32_t)depth << ROUTE_ENTRY_DEPTH_SHIFT) | group_idx;
+	uint32_t idx24 = prefix >> 8;
+	uint32_t tbl8_idx, i;
+	doca_error_t result;
+
+	if (depth <= 24) {
+		for (i = idx24; i < idx24 + (1U << (24 - depth)); i++) {
+			if (table->tbl24[i] & ROUTE_ENTRY_EXT) {
+				tbl8_idx = table->tbl24[i] & ROUTE_ENTRY_VAL_MASK;
+				route_ipv4_set_range(&table->tbl8[tbl8_idx * ROUTE_TBL8_SIZE],
+						     ROUTE_TBL8_SIZE,
+						     depth,
+						     entry);
+			} else
+				route_ipv4_set_range(&table->tbl24[i], 1, depth, entry);
+		}
+		return DOCA_SUCCESS;
+	}
+
+	if (!(table->tbl24[idx24] & ROUTE_ENTRY_EXT)) {
+		if (table->nb_tbl8 == ROUTE_MAX_TBL8) {
+			DOCA_LOG_ERR("Too many IPv4 tbl8 groups");
+			return DOCA_ERROR_FULL;
+		}
+		result = route_grow((void **)&table->tbl8,
+				    &table->max_tbl8,
+				    (table->nb_tbl8 + 1) * ROUTE_TBL8_SIZE,
+				    sizeof(uint32_t));
+		if (result != DOCA_SUCCESS)
+			return result;
+		tbl8_idx = table->nb_tbl8++;
+		for (i = 0; i < ROUTE_TBL8_SIZE; i++)
+			table->tbl8[tbl8_idx * ROUTE_TBL8_SIZE + i] = table->tbl24[idx24];
+		table->tbl24[idx24] = ROUTE_ENTRY_VALID | ROUTE_ENTRY_EXT | tbl8_idx;
+	}
+	tbl8_idx = table->tbl24[idx24] & ROUTE_ENTRY_VAL_MASK;
+	route_ipv4_set_range(&table->tbl8[tbl8_idx * ROUTE_TBL8_SIZE + (prefix & 0xff)],
+			     1U << (32 - depth),
+			     depth,
+			     entry);
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Allocate a zeroed IPv6 trie node
+ *
+ * @table [in]: routing table
+ * @node_idx [out]: index of the new node
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_ipv6_new_node(struct simple_fwd_route_table *table, uint32_t *node_idx)
+{
+	doca_error_t result;
+
+	result = route_grow((void **)&table->nodes,
+			    &table->max_nodes,
+			    table->nb_nodes + 1,
+			    sizeof(struct route6_node));
+	if (result != DOCA_SUCCESS)
+		return result;
+	memset(&table->nodes[table->nb_nodes], 0, sizeof(struct route6_node));
+	*node_idx = table->nb_nodes++;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Add an IPv6 route to the trie, the prefix is expanded over the slots of the node holding its last byte
+ *
+ * @table [in]: routing table
+ * @prefix [in]: masked prefix, network order
+ * @depth [in]: prefix length
+ * @group_idx [in]: ECMP group of the route
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_ipv6_add(struct simple_fwd_route_table *table,
+				   const uint8_t prefix[16],
+				   uint8_t depth,
+				   uint32_t group_idx)
+{
+	uint32_t last_level = depth == 0 ? 0 : (depth - 1) / 8;
+	uint32_t node_idx = 0, child, level, nb_slots, slot;
+	struct route6_node *node;
+	doca_error_t result;
+
+	if (table->nb_nodes == 0) {
+		result = route_ipv6_new_node(table, &node_idx);
+		if (result != DOCA_SUCCESS)
+			return result;
+	}
+
+	for (level = 0; level < last_level; level++) {
+		child = table->nodes[node_idx].child[prefix[level]];
+		if (child == 0) {
+			result = route_ipv6_new_node(table, &child);
+			if (result != DOCA_SUCCESS)
+				return result;
+			table->nodes[node_idx].child[prefix[level]] = child;
+		}
+		node_idx = child;
+	}
+
+	node = &table->nodes[node_idx];
+	nb_slots = 1U << ((last_level + 1) * 8 - depth);
+	for (slot = prefix[last_level]; slot < prefix[last_level] + nb_slots; slot++) {
+		if (node->group[slot] == 0 || node->depth[slot] <= depth) {
+			node->group[slot] = group_idx + 1;
+			node->depth[slot] = depth;
+		}
+	}
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Parse a single next hop of the form <port>@<mac>
+ *
+ * @str [in]: next hop string
+ * @nb_ports [in]: number of ports
+ * @nh [out]: parsed next hop
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_parse_nh(const char *str, uint16_t nb_ports, struct simple_fwd_route_nh *nh)
+{
+	unsigned long port;
+	char *end;
+	char extra;
+
+	port = strtoul(str, &end, 10);
+	if (end == str || *end != '@' || port >= nb_ports)
+		return DOCA_ERROR_INVALID_VALUE;
+	if (sscanf(end + 1,
+		   "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx%c",
+		   &nh->mac[0],
+		   &nh->mac[1],
+		   &nh->mac[2],
+		   &nh->mac[3],
+		   &nh->mac[4],
+		   &nh->mac[5],
+		   &extra) != DOCA_FLOW_ETHER_ADDR_LEN)
+		return DOCA_ERROR_INVALID_VALUE;
+	nh->port_id = port;
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Parse a routing table file line and add its route
+ *
+ * @table [in]: routing table
+ * @line [in]: the line to parse, modified while parsing
+ * @line_nb [in]: line number, for error reporting
+ * @nb_ports [in]: number of ports
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_parse_line(struct simple_fwd_route_table *table,
+				     char *line,
+				     uint32_t line_nb,
+				     uint16_t nb_ports)
+{
+	struct route_group group;
+	uint8_t addr[16];
+	uint32_t group_idx, prefix4;
+	unsigned long depth;
+	char *saveptr, *tok, *slash, *end;
+	bool is_ipv6;
+	doca_error_t result;
+	int i;
+
+	tok = strtok_r(line, ROUTE_DELIM, &saveptr);
+	if (tok == NULL || tok[0] == '#')
+		return DOCA_SUCCESS;
+
+	slash = strchr(tok, '/');
+	if (slash == NULL) {
+		DOCA_LOG_ERR("Line %u: prefix %s has no length", line_nb, tok);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	*slash = '\0';
+	is_ipv6 = strchr(tok, ':') != NULL;
+	if (inet_pton(is_ipv6 ? AF_INET6 : AF_INET, tok, addr) != 1) {
+		DOCA_LOG_ERR("Line %u: invalid prefix %s", line_nb, tok);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	depth = strtoul(slash + 1, &end, 10);
+	if (end == slash + 1 || *end != '\0' || depth > (is_ipv6 ? 128 : 32)) {
+		DOCA_LOG_ERR("Line %u: invalid prefix length %s", line_nb, slash + 1);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	memset(&group, 0, sizeof(group));
+	while ((tok = strtok_r(NULL, ROUTE_DELIM, &saveptr)) != NULL && tok[0] != '#') {
+		if (group.nb_nh == SIMPLE_FWD_ROUTE_MAX_NH) {
+			DOCA_LOG_ERR("Line %u: more than %d next hops", line_nb, SIMPLE_FWD_ROUTE_MAX_NH);
+			return DOCA_ERROR_INVALID_VALUE;
+		}
+		if (route_parse_nh(tok, nb_ports, &group.nh[group.nb_nh]) != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Line %u: invalid next hop %s, expected <port>@<mac> with port < %u",
+				     line_nb,
+				     tok,
+				     nb_ports);
+			return DOCA_ERROR_INVALID_VALUE;
+		}
+		group.nb_nh++;
+	}
+	if (group.nb_nh == 0) {
+		DOCA_LOG_ERR("Line %u: route has no next hop", line_nb);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	result = route_add_group(table, &group, &group_idx);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	if (!is_ipv6) {
+		memcpy(&prefix4, addr, sizeof(prefix4));
+		prefix4 = depth == 0 ? 0 : ntohl(prefix4) & (UINT32_MAX << (32 - depth));
+		result = route_ipv4_add(table, prefix4, depth, group_idx);
+		if (result == DOCA_SUCCESS)
+			table->nb_ipv4_routes++;
+		return result;
+	}
+
+	for (i = 0; i < 16; i++) {
+		if (depth >= (unsigned long)(i + 1) * 8)
+			continue;
+		addr[i] &= depth > (unsigned long)i * 8 ? (uint8_t)(0xff << ((i + 1) * 8 - depth)) : 0;
+	}
+	result = route_ipv6_add(table, addr, depth, group_idx);
+	if (result == DOCA_SUCCESS)
+		table->nb_ipv6_routes++;
+	return result;
+}
+
+/*
+ * Get the time elapsed between two timestamps
+ *
+ * @start [in]: start timestamp
+ * @end [in]: end timestamp
+ * @return: elapsed time in seconds
+ */
+static double route_elapsed_sec(const struct timespec *start, const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Simple xorshift pseudo random generator, used to draw benchmark destinations
+ *
+ * @state [in/out]: generator state, must not be zero
+ * @return: next pseudo random value
+ */
+static inline uint32_t route_rand(uint32_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+/*
+ * Measure the lookup rate of the loaded table over random destinations and log it
+ *
+ * @table [in]: routing table
+ */
+static void route_benchmark(const struct simple_fwd_route_table *table)
+{
+	struct timespec start, end;
+	uint32_t state = 0x9e3779b9;
+	uint32_t i, j, rnd, nb_hits = 0;
+	uint8_t ip6[16] = {0};
+	double elapsed;
+
+	if (table->nb_ipv4_routes > 0) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i = 0; i < ROUTE_BENCH_LOOKUPS; i++) {
+			if (simple_fwd_route_lookup_ipv4(table, route_rand(&state), i) != NULL)
+				nb_hits++;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		elapsed = route_elapsed_sec(&start, &end);
+		DOCA_LOG_INFO("IPv4 LPM: %u random lookups, %u matched, %.2f Mlookups/s",
+			      ROUTE_BENCH_LOOKUPS,
+			      nb_hits,
+			      elapsed > 0 ? ROUTE_BENCH_LOOKUPS / elapsed / 1e6 : 0);
+	}
+
+	if (table->nb_ipv6_routes > 0) {
+		nb_hits = 0;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i = 0; i < ROUTE_BENCH_LOOKUPS; i++) {
+			/* Random global unicast destinations, routed prefixes are within the first 64 bits */
+			for (j = 0; j < 8; j += sizeof(uint32_t)) {
+				rnd = route_rand(&state);
+				memcpy(&ip6[j], &rnd, sizeof(rnd));
+			}
+			ip6[0] = 0x20 | (ip6[0] & 0x1f);
+			if (simple_fwd_route_lookup_ipv6(table, ip6, i) != NULL)
+				nb_hits++;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		elapsed = route_elapsed_sec(&start, &end);
+		DOCA_LOG_INFO("IPv6 LPM: %u random lookups, %u matched, %.2f Mlookups/s",
+			      ROUTE_BENCH_LOOKUPS,
+			      nb_hits,
+			      elapsed > 0 ? ROUTE_BENCH_LOOKUPS / elapsed / 1e6 : 0);
+	}
+}
+
+doca_error_t simple_fwd_route_table_load(const char *path,
+					 uint16_t nb_ports,
+					 bool benchmark,
+					 struct simple_fwd_route_table **table)
+{
+	struct simple_fwd_route_table *tbl;
+	struct timespec start, end;
+	char line[ROUTE_LINE_MAX];
+	uint32_t line_nb = 0;
+	doca_error_t result = DOCA_SUCCESS;
+	FILE *fp;
+
+	fp = fopen(path, "r");
+	if (fp == NULL) {
+		DOCA_LOG_ERR("Failed to open routing table file %s: %s", path, strerror(errno));
+		return DOCA_ERROR_IO_FAILED;
+	}
+
+	tbl = calloc(1, sizeof(*tbl));
+	if (tbl == NULL) {
+		DOCA_LOG_ERR("Failed to allocate routing table");
+		fclose(fp);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+	/* Untouched tbl24 pages are never faulted in, tables of few routes stay small */
+	tbl->tbl24 = calloc(ROUTE_TBL24_SIZE, sizeof(uint32_t));
+	if (tbl->tbl24 == NULL) {
+		DOCA_LOG_ERR("Failed to allocate IPv4 tbl24");
+		result = DOCA_ERROR_NO_MEMORY;
+		goto destroy_table;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		line_nb++;
+		if (strchr(line, '\n') == NULL && !feof(fp)) {
+			DOCA_LOG_ERR("Line %u: longer than %d characters", line_nb, ROUTE_LINE_MAX - 1);
+			result = DOCA_ERROR_INVALID_VALUE;
+			goto destroy_table;
+		}
+		result = route_parse_line(tbl, line, line_nb, nb_ports);
+		if (result != DOCA_SUCCESS)
+			goto destroy_table;
+	}
+	if (ferror(fp)) {
+		DOCA_LOG_ERR("Failed to read routing table file %s", path);
+		result = DOCA_ERROR_IO_FAILED;
+		goto destroy_table;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	fclose(fp);
+
+	DOCA_LOG_INFO("Loaded %u IPv4 and %u IPv6 routes, %u ECMP groups, from %s in %.3f sec",
+		      tbl->nb_ipv4_routes,
+		      tbl->nb_ipv6_routes,
+		      tbl->nb_groups,
+		      path,
+		      route_elapsed_sec(&start, &end));
+	DOCA_LOG_INFO("IPv4 uses %u tbl8 groups, IPv6 trie uses %u nodes", tbl->nb_tbl8, tbl->nb_nodes);
+	/* Random lookups fault in all of tbl24, only do it when asked to */
+	if (benchmark)
+		route_benchmark(tbl);
+
+	*table = tbl;
+	return DOCA_SUCCESS;
+
+destroy_table:
+	fclose(fp);
+	simple_fwd_route_table_destroy(tbl);
+	return result;
+}
+
+void simple_fwd_route_table_destroy(struct simple_fwd_route_table *table)
+{
+	if (table == NULL)
+		return;
+	free(table->tbl24);
+	free(table->tbl8);
+	free(table->nodes);
+	free(table->groups);
+	free(table);
+}
+
+const struct simple_fwd_route_nh *simple_fwd_route_lookup_ipv4(const struct simple_fwd_route_table *table,
+							       doca_be32_t dst_ip,
+							       uint32_t hash)
+{
+	uint32_t ip = ntohl(dst_ip);
+	uint32_t entry = table->tbl24[ip >> 8];
+
+	if (entry & ROUTE_ENTRY_EXT)
+		entry = table->tbl8[(entry & ROUTE_ENTRY_VAL_MASK) * ROUTE_TBL8_SIZE + (ip & 0xff)];
+	if (!(entry & ROUTE_ENTRY_VALID))
+		return NULL;
+	return route_select_nh(table, entry & ROUTE_ENTRY_VAL_MASK, hash);
+}
+
+const struct simple_fwd_route_nh *simple_fwd_route_lookup_ipv6(const struct simple_fwd_route_table *table,
+							       const uint8_t dst_ip[16],
+							       uint32_t hash)
+{
+	const struct route6_node *node;
+	uint32_t node_idx = 0, best = 0;
+	int level;
+
+	if (table->nb_nodes == 0)
+		return NULL;
+	/* Deeper levels hold longer prefixes, the last match found on the way down is the longest one */
+	for (level = 0; level < ROUTE_IPV6_LEVELS; level++) {
+		node = &table->nodes[node_idx];
+		if (node->group[dst_ip[level]] != 0)
+			best = node->group[dst_ip[level]];
+		node_idx = node->child[dst_ip[level]];
+		if (node_idx == 0)
+			break;
+	}
+	if (best == 0)
+		return NULL;
+	return route_select_nh(table, best - 1, hash);
+}
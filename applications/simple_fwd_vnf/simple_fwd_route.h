@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef SIMPLE_FWD_ROUTE_H_
+#define SIMPLE_FWD_ROUTE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <doca_error.h>
+#include <doca_flow.h>
+
+#define SIMPLE_FWD_ROUTE_MAX_NH (16) /* Maximum number of next hops in an ECMP group */
+
+/* Next hop a routed flow is forwarded to */
+struct simple_fwd_route_nh {
+	uint16_t port_id;		       /* Egress port of the next hop */
+	uint8_t mac[DOCA_FLOW_ETHER_ADDR_LEN]; /* Destination MAC of the next hop */
+};
+
+/* Longest prefix match routing table, DIR-24-8 for IPv4 and a multibit trie for IPv6 */
+struct simple_fwd_route_table;
+
+/*
+ * Load a routing table from a text file
+ *
+ * Each non empty line not starting with '#' holds a prefix and its next hops, several next hops form an ECMP group:
+ *	<prefix>/<len> <port>@<mac> [<port>@<mac> ...]
+ * for example "10.0.0.0/8 1@aa:bb:cc:dd:ee:01 1@aa:bb:cc:dd:ee:02".
+ *
+ * @path [in]: path of the routing table file
+ * @nb_ports [in]: number of ports, next hop ports must be lower than it
+ * @benchmark [in]: whether to measure and log the lookup rate of the loaded table
+ * @table [out]: the loaded routing table
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t simple_fwd_route_table_load(const char *path,
+					 uint16_t nb_ports,
+					 bool benchmark,
+					 struct simple_fwd_route_table **table);
+
+/*
+ * Destroy a routing table
+ *
+ * @table [in]: routing table to destroy, may be NULL
+ */
+void simple_fwd_route_table_destroy(struct simple_fwd_route_table *table);
+
+/*
+ * Look up the next hop of an IPv4 destination, the ECMP group member is selected by the flow hash
+ *
+ * @table [in]: routing table
+ * @dst_ip [in]: destination IPv4 address, big endian
+ * @hash [in]: flow hash, e.g. the RSS hash of the packet
+ * @return: the next hop on success and NULL when no route matches
+ */
+const struct simple_fwd_route_nh *simple_fwd_route_lookup_ipv4(const struct simple_fwd_route_table *table,
+							       doca_be32_t dst_ip,
+							       uint32_t hash);
+
+/*
+ * Look up the next hop of an IPv6 destination, the ECMP group member is selected by the flow hash
+ *
+ * @table [in]: routing table
+ * @dst_ip [in]: destination IPv6 address, network order
+ * @hash [in]: flow hash, e.g. the RSS hash of the packet
+ * @return: the next hop on success and NULL when no route matches
+ */
+const struct simple_fwd_route_nh *simple_fwd_route_lookup_ipv6(const struct simple_fwd_route_table *table,
+							       const uint8_t dst_ip[16],
+							       uint32_t hash);
+
+#endif /* SIMPLE_FWD_ROUTE_H_ */
@@ -151,6 +151,8 @@ int main(int argc, char **argv)
 	port_cfg.nb_meters = DEFAULT_NB_METERS;
 	port_cfg.nb_counters = (1 << 13);
 	port_cfg.age_thread = app_cfg.age_thread;
+	port_cfg.route_file = app_cfg.route_file[0] != '\0' ? app_cfg.route_file : NULL;
+	port_cfg.route_bench = app_cfg.route_bench;
 	if (vnf->vnf_init(&port_cfg) != 0) {
 		DOCA_LOG_ERR("VNF application init error");
 		exit_status = EXIT_FAILURE;
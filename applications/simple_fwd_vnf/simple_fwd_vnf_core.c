@@ -46,6 +46,11 @@
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
 #include <rte_net.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+#include <rte_random.h>
 #include <rte_flow.h>
 
 #include <doca_argp.h>
@@ -64,6 +69,9 @@ DOCA_LOG_REGISTER(SIMPLE_FWD_VNF : Core);
 #define VNF_PKT_L2(M) rte_pktmbuf_mtod(M, uint8_t *) /* A marco that points to the start of the data in the mbuf */
 #define VNF_PKT_LEN(M) rte_pktmbuf_pkt_len(M)	     /* A marco that returns the length of the packet */
 #define VNF_RX_BURST_SIZE (32)			     /* Burst size of packets to read, RX burst read size */
+#define VNF_SYN_FLOOD_POOL_SIZE (1023)		     /* Number of mbufs of each core synthetic SYN packets pool */
+#define VNF_SYN_FLOOD_DST_PORT (80)		     /* TCP destination port of the synthetic SYN packets */
+#define VNF_SYN_FLOOD_VNI (0x5f5f)		     /* VXLAN VNI of the synthetic SYN packets */
 
 /* Flag for forcing lcores to stop processing packets, and gracefully terminate the application */
 static volatile bool force_quit;
@@ -99,30 +107,189 @@ static void vnf_adjust_mbuf(struct rte_mbuf *m, struct simple_fwd_pkt_info *pinf
  *
  * @mbuf [in]: DPDK structure represent the packet received
  * @queue_id [in]: Queue ID
+ * @recycle [in]: Whether the flow of the packet is removed as soon as it is offloaded
  * @vnf [in]: Holder for all functions pointers used by the application
+ * @pinfo [out]: the packet info, valid for the SW forwarding of the packet on success
+ * @return: 0 if the packet was parsed as outer IPv4 and processed, negative value otherwise
  */
-static void simple_fwd_process_offload(struct rte_mbuf *mbuf, uint16_t queue_id, struct app_vnf *vnf)
+static int simple_fwd_process_offload(struct rte_mbuf *mbuf,
+				      uint16_t queue_id,
+				      bool recycle,
+				      struct app_vnf *vnf,
+				      struct simple_fwd_pkt_info *pinfo)
 {
+	memset(pinfo, 0, sizeof(struct simple_fwd_pkt_info));
+	if (simple_fwd_parse_packet(VNF_PKT_L2(mbuf), VNF_PKT_LEN(mbuf), pinfo))
+		return -1;
+	pinfo->orig_data = mbuf;
+	pinfo->orig_port_id = mbuf->port;
+	pinfo->pipe_queue = queue_id;
+	pinfo->rss_hash = mbuf->hash.rss;
+	pinfo->recycle = recycle;
+	if (pinfo->outer.l3_type != IPV4)
+		return -1;
+	vnf->vnf_process_pkt(pinfo);
+	vnf_adjust_mbuf(mbuf, pinfo);
+	return 0;
+}
+
+/*
+ * Select the port a packet forwarded in SW is sent on. With a routing table the outer IPv4 destination selects the
+ * next hop as for HW entries and the destination MAC is rewritten, otherwise the packet goes out on the peer port.
+ *
+ * @mbuf [in]: DPDK structure represent the packet received
+ * @pinfo [in]: the packet info if the offload path already parsed the packet, NULL otherwise
+ * @port_id [in]: port the packet was received on
+ * @app_config [in]: application configuration
+ * @vnf [in]: Holder for all functions pointers used by the application
+ * @return: port to transmit the packet on
+ */
+static uint16_t vnf_select_tx_port(struct rte_mbuf *mbuf,
+				   struct simple_fwd_pkt_info *pinfo,
+				   uint16_t port_id,
+				   struct simple_fwd_config *app_config,
+				   struct app_vnf *vnf)
+{
+	struct simple_fwd_pkt_info parsed;
+	uint16_t tx_port;
+
+	if (app_config->route_file[0] == '\0')
+		return port_id ^ 1;
+
+	if (pinfo == NULL) {
+		memset(&parsed, 0, sizeof(struct simple_fwd_pkt_info));
+		if (simple_fwd_parse_packet(VNF_PKT_L2(mbuf), VNF_PKT_LEN(mbuf), &parsed) ||
+		    parsed.outer.l3_type != IPV4)
+			return port_id ^ 1;
+		parsed.orig_port_id = port_id;
+		parsed.rss_hash = mbuf->hash.rss;
+		pinfo = &parsed;
+	}
+	if (vnf->vnf_route_pkt(pinfo, &tx_port) != 0)
+		return port_id ^ 1;
+	return tx_port;
+}
+
+/*
+ * Fill an IPv4 header
+ *
+ * @ip [out]: IPv4 header to fill
+ * @proto [in]: next protocol
+ * @payload_len [in]: length of the IPv4 payload
+ * @rnd [in]: random value the source and destination addresses are taken from
+ */
+static void vnf_fill_ipv4_hdr(struct rte_ipv4_hdr *ip, uint8_t proto, uint16_t payload_len, uint64_t rnd)
+{
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->time_to_live = 64;
+	ip->next_proto_id = proto;
+	ip->total_length = rte_cpu_to_be_16(sizeof(struct rte_ipv4_hdr) + payload_len);
+	/* The parser drops packets with a zero address */
+	ip->src_addr = (rte_be32_t)rnd | RTE_BE32(1);
+	ip->dst_addr = (rte_be32_t)(rnd >> 32) | RTE_BE32(1);
+}
+
+/*
+ * Build a VXLAN encapsulated TCP SYN packet with random inner IPv4 addresses and TCP source port, so every packet
+ * opens a new connection. Only tunneled traffic is offloaded by the application, so the SYN is carried by the VXLAN
+ * tunnel as external traffic would be.
+ *
+ * @m [in]: empty mbuf to build the packet in
+ * @port_id [in]: port the packet is accounted to, as if it was received on it
+ * @return: 0 on success and negative value otherwise
+ */
+static int vnf_build_syn_pkt(struct rte_mbuf *m, uint16_t port_id)
+{
+	const uint16_t inner_len = sizeof(struct rte_ether_hdr) + sizeof(struct rte_ipv4_hdr) +
+				   sizeof(struct rte_tcp_hdr);
+	const uint16_t udp_len = sizeof(struct rte_udp_hdr) + sizeof(struct rte_vxlan_hdr) + inner_len;
+	const uint16_t len = sizeof(struct rte_ether_hdr) + sizeof(struct rte_ipv4_hdr) + udp_len;
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	struct rte_udp_hdr *udp;
+	struct rte_vxlan_hdr *vxlan;
+	struct rte_tcp_hdr *tcp;
+	uint64_t rnd;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m, len);
+	if (eth == NULL)
+		return -1;
+	memset(eth, 0, len);
+	eth->ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV4);
+
+	rnd = rte_rand();
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	vnf_fill_ipv4_hdr(ip, IPPROTO_UDP, udp_len, rnd);
+
+	udp = (struct rte_udp_hdr *)(ip + 1);
+	udp->src_port = (rte_be16_t)(rnd >> 16);
+	udp->dst_port = RTE_BE16(DOCA_FLOW_VXLAN_DEFAULT_PORT);
+	udp->dgram_len = rte_cpu_to_be_16(udp_len);
+
+	vxlan = (struct rte_vxlan_hdr *)(udp + 1);
+	vxlan->vx_flags = RTE_BE32(0x08000000);
+	vxlan->vx_vni = RTE_BE32(VNF_SYN_FLOOD_VNI << 8);
+
+	eth = (struct rte_ether_hdr *)(vxlan + 1);
+	eth->ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV4);
+
+	rnd = rte_rand();
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	vnf_fill_ipv4_hdr(ip, IPPROTO_TCP, sizeof(struct rte_tcp_hdr), rnd);
+
+	rnd = rte_rand();
+	tcp = (struct rte_tcp_hdr *)(ip + 1);
+	tcp->src_port = (rte_be16_t)rnd;
+	tcp->dst_port = RTE_BE16(VNF_SYN_FLOOD_DST_PORT);
+	tcp->sent_seq = (rte_be32_t)(rnd >> 16);
+	tcp->data_off = (sizeof(struct rte_tcp_hdr) / 4) << 4;
+	tcp->tcp_flags = RTE_TCP_SYN_FLAG;
+
+	m->port = port_id;
+	m->hash.rss = (uint32_t)(rnd >> 32);
+	return 0;
+}
+
+/*
+ * Inject a burst of synthetic SYN packets into the offload path of a queue, as if they were received on the port.
+ * The packets are dropped once processed, they only load the new flows insertion path. Their flows are removed as
+ * soon as they are offloaded, so the generator never holds more flows than the pending insertions and the flow
+ * table is not saturated by the measurement.
+ *
+ * @pool [in]: mbuf pool of the synthetic packets
+ * @nb_pkts [in]: number of packets to inject
+ * @port_id [in]: port the packets are accounted to
+ * @queue_id [in]: queue the packets are processed on
+ * @vnf [in]: holder for all functions pointers used by the application
+ */
+static void vnf_syn_flood(struct rte_mempool *pool,
+			  uint16_t nb_pkts,
+			  uint16_t port_id,
+			  uint16_t queue_id,
+			  struct app_vnf *vnf)
+{
+	struct rte_mbuf *mbufs[VNF_RX_BURST_SIZE];
 	struct simple_fwd_pkt_info pinfo;
+	uint16_t j;
 
-	memset(&pinfo, 0, sizeof(struct simple_fwd_pkt_info));
-	if (simple_fwd_parse_packet(VNF_PKT_L2(mbuf), VNF_PKT_LEN(mbuf), &pinfo))
-		return;
-	pinfo.orig_data = mbuf;
-	pinfo.orig_port_id = mbuf->port;
-	pinfo.pipe_queue = queue_id;
-	pinfo.rss_hash = mbuf->hash.rss;
-	if (pinfo.outer.l3_type != IPV4)
+	if (rte_pktmbuf_alloc_bulk(pool, mbufs, nb_pkts) != 0)
 		return;
-	vnf->vnf_process_pkt(&pinfo);
-	vnf_adjust_mbuf(mbuf, &pinfo);
+	for (j = 0; j < nb_pkts; j++) {
+		if (vnf_build_syn_pkt(mbufs[j], port_id) == 0)
+			simple_fwd_process_offload(mbufs[j], queue_id, true, vnf, &pinfo);
+	}
+	rte_pktmbuf_free_bulk(mbufs, nb_pkts);
 }
 
 int simple_fwd_process_pkts(void *process_pkts_params)
 {
+	char pool_name[RTE_MEMPOOL_NAMESIZE];
+	struct rte_mempool *syn_pool = NULL;
 	int result;
 	uint64_t cur_tsc, last_tsc;
 	struct rte_mbuf *mbufs[VNF_RX_BURST_SIZE];
+	struct simple_fwd_pkt_info pinfo;
+	struct simple_fwd_pkt_info *parsed;
 	uint16_t j, nb_rx, queue_id;
 	uint32_t port_id = 0, core_id = rte_lcore_id();
 	struct vnf_per_core_params *params = &core_params_arr[core_id];
@@ -134,14 +301,33 @@ int simple_fwd_process_pkts(void *process_pkts_params)
 		return 0;
 	}
 	DOCA_LOG_TRC("Core %u process queue %u start", core_id, params->queues[0]);
+	if (app_config->syn_flood > 0) {
+		if (!app_config->hw_offload) {
+			DOCA_LOG_ERR("SYN flood generator requires HW offload");
+			return -1;
+		}
+		snprintf(pool_name, sizeof(pool_name), "syn_flood_pool_%u", core_id);
+		syn_pool = rte_pktmbuf_pool_create(pool_name,
+						   VNF_SYN_FLOOD_POOL_SIZE,
+						   0,
+						   0,
+						   RTE_MBUF_DEFAULT_BUF_SIZE,
+						   rte_socket_id());
+		if (syn_pool == NULL) {
+			DOCA_LOG_ERR("Failed to allocate SYN flood mbuf pool on core %u", core_id);
+			return -1;
+		}
+	}
 	last_tsc = rte_rdtsc();
 	while (!force_quit) {
 		if (core_id == rte_get_main_lcore()) {
 			cur_tsc = rte_rdtsc();
 			if (cur_tsc > last_tsc + app_config->stats_timer) {
 				result = vnf->vnf_dump_stats(0);
-				if (result != 0)
+				if (result != 0) {
+					rte_mempool_free(syn_pool);
 					return result;
+				}
 				last_tsc = cur_tsc;
 			}
 		}
@@ -149,17 +335,28 @@ int simple_fwd_process_pkts(void *process_pkts_params)
 			queue_id = params->queues[port_id];
 			nb_rx = rte_eth_rx_burst(port_id, queue_id, mbufs, VNF_RX_BURST_SIZE);
 			for (j = 0; j < nb_rx; j++) {
-				if (app_config->hw_offload)
-					simple_fwd_process_offload(mbufs[j], queue_id, vnf);
+				/* The SW forwarding reuses the packet info parsed by the offload path */
+				parsed = NULL;
+				if (app_config->hw_offload &&
+				    simple_fwd_process_offload(mbufs[j], queue_id, false, vnf, &pinfo) == 0)
+					parsed = &pinfo;
 				if (app_config->rx_only)
 					rte_pktmbuf_free(mbufs[j]);
 				else
-					rte_eth_tx_burst(port_id ^ 1, queue_id, &mbufs[j], 1);
+					rte_eth_tx_burst(vnf_select_tx_port(mbufs[j], parsed, port_id, app_config, vnf),
+							 queue_id,
+							 &mbufs[j],
+							 1);
 			}
+			if (syn_pool != NULL)
+				vnf_syn_flood(syn_pool, app_config->syn_flood, port_id, queue_id, vnf);
+			if (app_config->hw_offload)
+				vnf->vnf_flow_offload(port_id, queue_id);
 			if (app_config->age_thread)
 				vnf->vnf_flow_age(port_id, queue_id);
 		}
 	}
+	rte_mempool_free(syn_pool);
 	return 0;
 }
 
@@ -270,6 +467,64 @@ static doca_error_t age_thread_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Callback function for setting the routing table file
+ *
+ * @param [in]: path of the routing table file
+ * @config [out]: application configuration to set the routing table file
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_file_callback(void *param, void *config)
+{
+	struct simple_fwd_config *app_config = (struct simple_fwd_config *)config;
+	const char *route_file = (char *)param;
+
+	if (strnlen(route_file, PATH_MAX) == PATH_MAX) {
+		DOCA_LOG_ERR("Routing table file path is too long, max %d", PATH_MAX - 1);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	strlcpy(app_config->route_file, route_file, PATH_MAX);
+	DOCA_LOG_DBG("Set route_file:%s", app_config->route_file);
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Callback function for enabling the routing table lookup benchmark
+ *
+ * @param [in]: true to benchmark the routing table after loading it
+ * @config [out]: application configuration to set the routing table benchmark
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t route_bench_callback(void *param, void *config)
+{
+	struct simple_fwd_config *app_config = (struct simple_fwd_config *)config;
+
+	app_config->route_bench = *(bool *)param;
+	DOCA_LOG_DBG("Set route_bench:%s", app_config->route_bench ? "true" : "false");
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Callback function for setting the number of synthetic SYN packets injected per poll
+ *
+ * @param [in]: number of SYN packets per queue poll, 0 disables the generator
+ * @config [out]: application configuration to set the SYN flood generator
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t syn_flood_callback(void *param, void *config)
+{
+	struct simple_fwd_config *app_config = (struct simple_fwd_config *)config;
+	int syn_flood = *(int *)param;
+
+	if (syn_flood < 0 || syn_flood > VNF_RX_BURST_SIZE) {
+		DOCA_LOG_ERR("Invalid syn_flood %d, should be between 0 and %d", syn_flood, VNF_RX_BURST_SIZE);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	app_config->syn_flood = syn_flood;
+	DOCA_LOG_DBG("Set syn_flood:%u", app_config->syn_flood);
+	return DOCA_SUCCESS;
+}
+
 /*
  * Registers all flags used by the application for DOCA argument parser, so that when parsing
  * it can be parsed accordingly
@@ -279,7 +534,8 @@ doca_error_t register_simple_fwd_params(void)
 {
 	doca_error_t result;
 	struct doca_argp_param *stats_param, *nr_queues_param, *rx_only_param, *hw_offload_param;
-	struct doca_argp_param *hairpinq_param, *age_thread_param;
+	struct doca_argp_param *hairpinq_param, *age_thread_param, *route_file_param, *syn_flood_param;
+	struct doca_argp_param *route_bench_param;
 
 	/* Create and register stats timer param */
 	result = doca_argp_param_create(&stats_param);
@@ -385,6 +641,62 @@ doca_error_t register_simple_fwd_params(void)
 		return result;
 	}
 
+	/* Create and register routing table file param */
+	result = doca_argp_param_create(&route_file_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(route_file_param, "rt");
+	doca_argp_param_set_long_name(route_file_param, "route-file");
+	doca_argp_param_set_arguments(route_file_param, "<path>");
+	doca_argp_param_set_description(route_file_param,
+					"Route flows by longest prefix match in the routing table file");
+	doca_argp_param_set_callback(route_file_param, route_file_callback);
+	doca_argp_param_set_type(route_file_param, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(route_file_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register routing table benchmark param */
+	result = doca_argp_param_create(&route_bench_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(route_bench_param, "rb");
+	doca_argp_param_set_long_name(route_bench_param, "route-bench");
+	doca_argp_param_set_description(route_bench_param,
+					"Measure the lookup rate of the routing table after loading it");
+	doca_argp_param_set_callback(route_bench_param, route_bench_callback);
+	doca_argp_param_set_type(route_bench_param, DOCA_ARGP_TYPE_BOOLEAN);
+	result = doca_argp_register_param(route_bench_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register SYN flood generator param */
+	result = doca_argp_param_create(&syn_flood_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(syn_flood_param, "sf");
+	doca_argp_param_set_long_name(syn_flood_param, "syn-flood");
+	doca_argp_param_set_arguments(syn_flood_param, "<num>");
+	doca_argp_param_set_description(syn_flood_param,
+					"Inject <num> SYN packets of new connections per queue poll, needs HW offload");
+	doca_argp_param_set_callback(syn_flood_param, syn_flood_callback);
+	doca_argp_param_set_type(syn_flood_param, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(syn_flood_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	/* Register version callback for DOCA SDK & RUNTIME */
 	result = doca_argp_register_version_callback(sdk_version_callback);
 	if (result != DOCA_SUCCESS) {
@@ -26,6 +26,8 @@
 #ifndef SIMPLE_FWD_VNF_CORE_H_
 #define SIMPLE_FWD_VNF_CORE_H_
 
+#include <limits.h>
+
 #include <dpdk_utils.h>
 
 #include "app_vnf.h"
@@ -35,10 +37,13 @@ struct simple_fwd_config {
 	struct application_dpdk_config *dpdk_cfg; /* DPDK configurations */
 	uint16_t rx_only; /* Whether or not to work in "receive mode" only, where the application does not send received
 			     packets */
-	uint16_t hw_offload;  /* Whether or not HW steering is used */
-	uint64_t stats_timer; /* The time between periodic stats prints */
-	bool is_hairpin;      /* Number of hairpin queues */
-	bool age_thread;      /* Whther or not to use a dedicated thread to handle aged flows */
+	uint16_t hw_offload;	   /* Whether or not HW steering is used */
+	uint64_t stats_timer;	   /* The time between periodic stats prints */
+	bool is_hairpin;	   /* Number of hairpin queues */
+	bool age_thread;	   /* Whther or not to use a dedicated thread to handle aged flows */
+	char route_file[PATH_MAX]; /* Routing table file, empty when next hop routing is disabled */
+	bool route_bench;	   /* Whether to benchmark the lookups of the loaded routing table */
+	uint16_t syn_flood;	   /* Synthetic SYN packets injected per queue poll, 0 when the generator is disabled */
 };
 
 /* Simple FWD VNF parameters to be passed when starting processing packets */
@@ -90,8 +90,8 @@ int main(int argc, char **argv)
 
 		list_devices();
 	} else {
-		struct globals globals;
-		struct stream_data data;
+		struct stream_data streams[MAX_STREAMS];
+		struct worker_data workers[MAX_WORKERS];
 		struct doca_dev *dev = NULL;
 
 		if (!mandatory_args_set(&config)) {
@@ -123,26 +123,17 @@ int main(int argc, char **argv)
 			goto cleanup_rmax;
 		}
 
-		ret = init_globals(&config, dev, &globals);
+		ret = init_workers(&config, dev, streams, workers);
 		if (ret != DOCA_SUCCESS) {
 			exit_code = EXIT_FAILURE;
 			goto cleanup_device;
 		}
 
-		ret = init_stream(&config, dev, &globals, &data);
-		if (ret != DOCA_SUCCESS) {
+		/* main loop, reports statistics while the workers receive */
+		if (!run_workers(&config, workers))
 			exit_code = EXIT_FAILURE;
-			goto cleanup_globals;
-		}
 
-		/* main loop */
-		if (!run_recv_loop(&config, &globals, &data))
-			exit_code = EXIT_FAILURE;
-
-		if (!destroy_stream(dev, &globals, &data))
-			exit_code = EXIT_FAILURE;
-cleanup_globals:
-		if (!destroy_globals(&globals, dev))
+		if (!destroy_workers(dev, workers, config.num_workers))
 			exit_code = EXIT_FAILURE;
 cleanup_device:
 		ret = doca_dev_close(dev);
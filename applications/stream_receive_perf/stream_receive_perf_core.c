@@ -23,7 +23,10 @@
  *
  */
 
+#define _GNU_SOURCE
+
 #include <errno.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,6 +43,9 @@ DOCA_LOG_REGISTER(STREAM_RECEIVE_PERF_CORE);
 
 #include "stream_receive_perf_core.h"
 
+#define BUSY_POLL_IDLE_SPINS 1024 /* Empty polls before an idle worker starts sleeping */
+#define STATS_POLL_INTERVAL_US 100000 /* Interval at which the main thread checks the workers */
+
 /*
  * Handles the completion event for the received stream data.
  * Invoked when the data is successfully received by the DOCA stream.
@@ -82,6 +88,9 @@ bool init_config(struct app_config *config)
 	config->sleep_us = 0;
 	config->min_packets = 0;
 	config->max_packets = 0;
+	config->num_streams = 0;
+	config->num_workers = 1;
+	config->num_worker_cpus = 0;
 	config->affinity_mask_set = false;
 	ret = doca_rmax_cpu_affinity_create(&config->affinity_mask);
 	if (ret != DOCA_SUCCESS) {
@@ -439,6 +448,94 @@ static doca_error_t set_max_packets_param(void *param, void *opaque)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Sets the number of streams parameter in the application configuration
+ *
+ * @param [in]: Pointer to the number of streams
+ * @opaque [in]: Pointer to the application configuration
+ * @return: DOCA_SUCCESS on success, or an error code if the number of streams is invalid
+ */
+static doca_error_t set_streams_param(void *param, void *opaque)
+{
+	struct app_config *config = (struct app_config *)opaque;
+	const int value = *(const int *)param;
+
+	if (value > 0 && value <= MAX_STREAMS)
+		config->num_streams = (uint32_t)value;
+	else {
+		DOCA_LOG_ERR("bad number of streams '%d' was specified, must be 1-%d", value, MAX_STREAMS);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Sets the number of workers parameter in the application configuration
+ *
+ * @param [in]: Pointer to the number of workers
+ * @opaque [in]: Pointer to the application configuration
+ * @return: DOCA_SUCCESS on success, or an error code if the number of workers is invalid
+ */
+static doca_error_t set_workers_param(void *param, void *opaque)
+{
+	struct app_config *config = (struct app_config *)opaque;
+	const int value = *(const int *)param;
+
+	if (value > 0 && value <= MAX_WORKERS)
+		config->num_workers = (uint32_t)value;
+	else {
+		DOCA_LOG_ERR("bad number of workers '%d' was specified, must be 1-%d", value, MAX_WORKERS);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Sets the worker CPU cores parameter in the application configuration.
+ * Parses a string of CPU core indices (e.g., "4,5,6"), worker i is pinned to the i-th core
+ *
+ * @param [in]: Pointer to the worker CPU cores string
+ * @opaque [in]: Pointer to the application configuration
+ * @return: DOCA_SUCCESS on success, or an error code if the CPU cores are invalid
+ */
+static doca_error_t set_worker_cpus_param(void *param, void *opaque)
+{
+	struct app_config *config = (struct app_config *)opaque;
+	const char *input = (const char *)param;
+	char *str, *alloc;
+	doca_error_t ret = DOCA_SUCCESS;
+
+	alloc = str = strdup(input);
+	if (str == NULL) {
+		DOCA_LOG_ERR("unable to allocate memory: %s", strerror(errno));
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	config->num_worker_cpus = 0;
+	while ((str = strtok(str, ",")) != NULL) {
+		int idx;
+		char dummy;
+
+		if (sscanf(str, "%d%c", &idx, &dummy) != 1 || idx < 0 || idx >= CPU_SETSIZE) {
+			DOCA_LOG_ERR("bad CPU index '%s' was specified", str);
+			ret = DOCA_ERROR_INVALID_VALUE;
+			goto exit;
+		}
+		if (config->num_worker_cpus == MAX_WORKERS) {
+			DOCA_LOG_ERR("too many worker CPU cores were specified, maximum is %d", MAX_WORKERS);
+			ret = DOCA_ERROR_INVALID_VALUE;
+			goto exit;
+		}
+
+		config->worker_cpus[config->num_worker_cpus++] = idx;
+		str = NULL;
+	}
+exit:
+	free(alloc);
+
+	return ret;
+}
+
 /*
  * Sets the dump flag in the application configuration.
  * Enables the option to dump packet content for debugging or analysis purposes.
@@ -476,6 +573,9 @@ bool register_argp_params(void)
 	struct doca_argp_param *min_packets_param;
 	struct doca_argp_param *max_packets_param;
 	struct doca_argp_param *sleep_param;
+	struct doca_argp_param *workers_param;
+	struct doca_argp_param *streams_param;
+	struct doca_argp_param *worker_cpus_param;
 	struct doca_argp_param *dump_flag;
 
 	/* --list flag */
@@ -671,7 +771,8 @@ bool register_argp_params(void)
 		return false;
 	}
 	doca_argp_param_set_long_name(sleep_param, "sleep");
-	doca_argp_param_set_description(sleep_param, "Amount of microseconds to sleep between requests (default 0)");
+	doca_argp_param_set_description(sleep_param,
+					"Maximum microseconds to sleep while idle (default 0, always busy-poll)");
 	doca_argp_param_set_callback(sleep_param, set_sleep_param);
 	doca_argp_param_set_type(sleep_param, DOCA_ARGP_TYPE_INT);
 	ret = doca_argp_register_param(sleep_param);
@@ -713,6 +814,59 @@ bool register_argp_params(void)
 		return false;
 	}
 
+	/* --workers parameter */
+	ret = doca_argp_param_create(&workers_param);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_name(ret));
+		return false;
+	}
+	doca_argp_param_set_long_name(workers_param, "workers");
+	doca_argp_param_set_description(workers_param,
+					"Number of worker threads, sharing the streams between them (default 1)");
+	doca_argp_param_set_callback(workers_param, set_workers_param);
+	doca_argp_param_set_type(workers_param, DOCA_ARGP_TYPE_INT);
+	ret = doca_argp_register_param(workers_param);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_name(ret));
+		return false;
+	}
+
+	/* --streams parameter */
+	ret = doca_argp_param_create(&streams_param);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_name(ret));
+		return false;
+	}
+	doca_argp_param_set_long_name(streams_param, "streams");
+	doca_argp_param_set_description(
+		streams_param,
+		"Number of streams, received on consecutive destination ports (default is the number of workers)");
+	doca_argp_param_set_callback(streams_param, set_streams_param);
+	doca_argp_param_set_type(streams_param, DOCA_ARGP_TYPE_INT);
+	ret = doca_argp_register_param(streams_param);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_name(ret));
+		return false;
+	}
+
+	/* --worker-cpus parameter */
+	ret = doca_argp_param_create(&worker_cpus_param);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_name(ret));
+		return false;
+	}
+	doca_argp_param_set_long_name(worker_cpus_param, "worker-cpus");
+	doca_argp_param_set_description(
+		worker_cpus_param,
+		"Comma separated list of CPU cores to pin the workers to (default: the cores the process may run on)");
+	doca_argp_param_set_callback(worker_cpus_param, set_worker_cpus_param);
+	doca_argp_param_set_type(worker_cpus_param, DOCA_ARGP_TYPE_STRING);
+	ret = doca_argp_register_param(worker_cpus_param);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_name(ret));
+		return false;
+	}
+
 	/* --dump flag */
 	ret = doca_argp_param_create(&dump_flag);
 	if (ret != DOCA_SUCCESS) {
@@ -759,6 +913,16 @@ bool mandatory_args_set(struct app_config *config)
 		DOCA_LOG_ERR("Destination port is not set");
 		status = false;
 	}
+	if (config->num_streams == 0)
+		config->num_streams = config->num_workers;
+	if (config->num_streams < config->num_workers) {
+		DOCA_LOG_ERR("Cannot share %u streams between %u workers", config->num_streams, config->num_workers);
+		status = false;
+	}
+	if (config->dst_port != 0 && config->dst_port + config->num_streams - 1 > UINT16_MAX) {
+		DOCA_LOG_ERR("Destination ports of %u streams exceed the port range", config->num_streams);
+		status = false;
+	}
 	return status;
 }
 
@@ -892,69 +1056,109 @@ static void free_callback(void *addr, size_t len, void *opaque)
 }
 
 doca_error_t init_globals(struct app_config *config, struct doca_dev *dev, struct globals *globals)
+{
+	doca_error_t ret;
+
+	(void)config;
+	(void)dev;
+
+	ret = doca_pe_create(&globals->pe);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Error creating progress engine: %s", doca_error_get_name(ret));
+		return ret;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+bool destroy_globals(struct globals *globals, struct doca_dev *dev)
+{
+	doca_error_t ret;
+
+	(void)dev;
+
+	ret = doca_pe_destroy(globals->pe);
+	if (ret != DOCA_SUCCESS) {
+		DOCA_LOG_WARN("Error destroying progress engine: %s", doca_error_get_name(ret));
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Creates the memory map and buffer inventory of a stream. Each stream needs its own
+ * memory map, as a memory map covers a single memory range
+ *
+ * @config [in]: Pointer to the application configuration structure
+ * @dev [in]: Pointer to the device handle opened by the application
+ * @data [in/out]: Pointer to the stream data structure holding the memory resources
+ * @return: DOCA_SUCCESS on successful initialization; appropriate DOCA error otherwise
+ */
+static doca_error_t init_stream_memory(struct app_config *config, struct doca_dev *dev, struct stream_data *data)
 {
 	doca_error_t ret;
 	size_t num_buffers = (config->hdr_size > 0) ? 2 : 1;
 
 	/* create memory-related DOCA objects */
-	ret = doca_mmap_create(&globals->mmap);
+	ret = doca_mmap_create(&data->mmap);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Error creating mmap: %s", doca_error_get_name(ret));
 		return ret;
 	}
-	ret = doca_mmap_add_dev(globals->mmap, dev);
+	ret = doca_mmap_add_dev(data->mmap, dev);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Error adding device to mmap: %s", doca_error_get_name(ret));
-		return ret;
+		goto destroy_mmap;
 	}
 	/* set mmap free callback */
-	ret = doca_mmap_set_free_cb(globals->mmap, free_callback, NULL);
+	ret = doca_mmap_set_free_cb(data->mmap, free_callback, NULL);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to set mmap free callback: %s", doca_error_get_name(ret));
-		return ret;
+		goto destroy_mmap;
 	}
-	ret = doca_buf_inventory_create(num_buffers, &globals->inventory);
+	ret = doca_buf_inventory_create(num_buffers, &data->inventory);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Error creating inventory: %s", doca_error_get_name(ret));
-		return ret;
+		goto destroy_mmap;
 	}
-	ret = doca_buf_inventory_start(globals->inventory);
+	ret = doca_buf_inventory_start(data->inventory);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Error starting inventory: %s", doca_error_get_name(ret));
-		return ret;
-	}
-
-	ret = doca_pe_create(&globals->pe);
-	if (ret != DOCA_SUCCESS) {
-		DOCA_LOG_ERR("Error creating progress engine: %s", doca_error_get_name(ret));
-		return ret;
+		goto destroy_inventory;
 	}
 
 	return DOCA_SUCCESS;
+destroy_inventory:
+	doca_buf_inventory_destroy(data->inventory);
+destroy_mmap:
+	doca_mmap_destroy(data->mmap);
+	return ret;
 }
 
-bool destroy_globals(struct globals *globals, struct doca_dev *dev)
+/*
+ * Destroys the buffer inventory and memory map of a stream, which also frees the stream memory
+ *
+ * @data [in]: Pointer to the stream data structure holding the memory resources
+ * @return: true if resources were successfully destroyed; false otherwise
+ */
+static bool destroy_stream_memory(struct stream_data *data)
 {
 	doca_error_t ret;
 	bool is_ok = true;
 
-	ret = doca_pe_destroy(globals->pe);
-	if (ret != DOCA_SUCCESS) {
-		DOCA_LOG_WARN("Error destroying progress engine: %s", doca_error_get_name(ret));
-		is_ok = false;
-	}
-	ret = doca_buf_inventory_stop(globals->inventory);
+	ret = doca_buf_inventory_stop(data->inventory);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_WARN("Error stopping inventory: %s", doca_error_get_name(ret));
 		is_ok = false;
 	}
-	ret = doca_buf_inventory_destroy(globals->inventory);
+	ret = doca_buf_inventory_destroy(data->inventory);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_WARN("Error destroying inventory: %s", doca_error_get_name(ret));
 		is_ok = false;
 	}
 	/* will also free all allocated memory via callback */
-	ret = doca_mmap_destroy(globals->mmap);
+	ret = doca_mmap_destroy(data->mmap);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_WARN("Error destroying mmap: %s", doca_error_get_name(ret));
 		is_ok = false;
@@ -966,6 +1170,7 @@ bool destroy_globals(struct globals *globals, struct doca_dev *dev)
 doca_error_t init_stream(struct app_config *config,
 			 struct doca_dev *dev,
 			 struct globals *globals,
+			 uint16_t dst_port,
 			 struct stream_data *data)
 {
 	static const size_t page_size = 4096;
@@ -979,10 +1184,14 @@ doca_error_t init_stream(struct app_config *config,
 
 	memset(&size, 0, sizeof(size));
 
+	ret = init_stream_memory(config, dev, data);
+	if (ret != DOCA_SUCCESS)
+		return ret;
+
 	/* create stream object */
 	ret = doca_rmax_in_stream_create(dev, &data->stream);
 	if (ret != DOCA_SUCCESS)
-		return ret;
+		goto destroy_memory;
 
 	/* Register Rx data event handlers */
 	event_user_data.ptr = (void *)data;
@@ -1063,20 +1272,21 @@ doca_error_t init_stream(struct app_config *config,
 		goto destroy_stream;
 	}
 
-	ret = doca_mmap_set_memrange(globals->mmap, ptr_memory, size[0] + size[1]);
+	ret = doca_mmap_set_memrange(data->mmap, ptr_memory, size[0] + size[1]);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to set mmap memory range, %p, size %zu: %s",
 			     ptr_memory,
 			     size[0] + size[1],
 			     doca_error_get_name(ret));
-		goto free_memory;
+		free(ptr_memory);
+		goto destroy_stream;
 	}
 
-	/* start mmap */
-	ret = doca_mmap_start(globals->mmap);
+	/* start mmap, the memory is now freed along with the mmap */
+	ret = doca_mmap_start(data->mmap);
 	if (ret != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Error starting mmap: %s", doca_error_get_name(ret));
-		goto free_memory;
+		goto destroy_stream;
 	}
 
 	if (num_buffers == 1) {
@@ -1094,13 +1304,13 @@ doca_error_t init_stream(struct app_config *config,
 			ret = DOCA_ERROR_NO_MEMORY;
 			if (i > 0)
 				goto destroy_buffers;
-			goto free_memory;
+			goto destroy_stream;
 		}
-		ret = doca_buf_inventory_buf_get_by_addr(globals->inventory, globals->mmap, ptr[i], size[i], &buf);
+		ret = doca_buf_inventory_buf_get_by_addr(data->inventory, data->mmap, ptr[i], size[i], &buf);
 		if (ret != DOCA_SUCCESS) {
 			if (i > 0)
 				goto destroy_buffers;
-			goto free_memory;
+			goto destroy_stream;
 		}
 		if (i == 0)
 			data->buffer = buf;
@@ -1136,13 +1346,14 @@ doca_error_t init_stream(struct app_config *config,
 	ret = doca_rmax_flow_set_dst_ip(data->flow, &config->dst_ip);
 	if (ret != DOCA_SUCCESS)
 		goto destroy_flow;
-	ret = doca_rmax_flow_set_dst_port(data->flow, config->dst_port);
+	ret = doca_rmax_flow_set_dst_port(data->flow, dst_port);
 	if (ret != DOCA_SUCCESS)
 		goto destroy_flow;
 	ret = doca_rmax_flow_attach(data->flow, data->stream);
 	if (ret != DOCA_SUCCESS)
 		goto destroy_flow;
 
+	data->dst_port = dst_port;
 	data->recv_pkts = 0;
 	data->recv_bytes = 0;
 	data->dump = config->dump;
@@ -1160,12 +1371,12 @@ destroy_buffers:
 	err = doca_buf_dec_refcount(data->buffer, NULL);
 	if (err != DOCA_SUCCESS)
 		DOCA_LOG_WARN("Error removing buffers: %s", doca_error_get_name(err));
-free_memory:
-	free(ptr_memory);
 destroy_stream:
 	err = doca_rmax_in_stream_destroy(data->stream);
 	if (err != DOCA_SUCCESS)
 		DOCA_LOG_WARN("Error destroying stream: %s", doca_error_get_name(err));
+destroy_memory:
+	destroy_stream_memory(data);
 	return ret;
 }
 
@@ -1204,6 +1415,8 @@ bool destroy_stream(struct doca_dev *dev, struct globals *globals, struct stream
 		DOCA_LOG_WARN("Error destroying stream: %s", doca_error_get_name(ret));
 		is_ok = false;
 	}
+	if (!destroy_stream_memory(data))
+		is_ok = false;
 	return is_ok;
 }
 
@@ -1211,15 +1424,18 @@ static void handle_completion(struct doca_rmax_in_stream_event_rx_data *event_rx
 {
 	struct stream_data *data = event_user_data.ptr;
 	const struct doca_rmax_in_stream_result *comp = doca_rmax_in_stream_event_rx_data_get_result(event_rx_data);
+	size_t recv_bytes = 0;
 
 	if (!comp)
 		return;
 	if (comp->elements_count <= 0)
 		return;
 
-	data->recv_pkts += comp->elements_count;
 	for (size_t i = 0; i < data->num_buffers; ++i)
-		data->recv_bytes += comp->elements_count * data->pkt_size[i];
+		recv_bytes += comp->elements_count * data->pkt_size[i];
+	/* the statistics are read by the main thread */
+	__atomic_store_n(&data->recv_pkts, data->recv_pkts + comp->elements_count, __ATOMIC_RELAXED);
+	__atomic_store_n(&data->recv_bytes, data->recv_bytes + recv_bytes, __ATOMIC_RELAXED);
 
 	if (!data->dump)
 		return;
@@ -1233,20 +1449,210 @@ static void handle_completion(struct doca_rmax_in_stream_event_rx_data *event_rx
 		}
 }
 
+static void handle_error(struct doca_rmax_in_stream_event_rx_data *event_rx_data, union doca_data event_user_data)
+{
+	struct stream_data *data = event_user_data.ptr;
+	const struct doca_rmax_stream_error *err = doca_rmax_in_stream_event_rx_data_get_error(event_rx_data);
+
+	if (err)
+		DOCA_LOG_ERR("Error: code=%d message=%s", err->code, err->message);
+	else
+		DOCA_LOG_ERR("Unknown error");
+
+	__atomic_store_n(data->run_recv_loop, false, __ATOMIC_RELAXED);
+}
+
+bool run_recv_loop(const struct app_config *config, struct worker_data *worker)
+{
+	uint32_t idle_spins = 0;
+	useconds_t backoff_us = 0;
+
+	while (__atomic_load_n(&worker->run_recv_loop, __ATOMIC_RELAXED)) {
+		if (doca_pe_progress(worker->globals.pe) > 0) {
+			idle_spins = 0;
+			backoff_us = 0;
+			continue;
+		}
+		if (config->sleep_us == 0 || ++idle_spins < BUSY_POLL_IDLE_SPINS)
+			continue;
+
+		/* the streams are idle, back off until the next completion */
+		backoff_us = (backoff_us == 0) ? 1 : backoff_us * 2;
+		if (backoff_us > config->sleep_us)
+			backoff_us = config->sleep_us;
+		if (usleep(backoff_us) != 0) {
+			if (errno != EINTR)
+				DOCA_LOG_ERR("usleep error: %s", strerror(errno));
+			return false;
+		}
+		__atomic_store_n(&worker->idle_sleeps, worker->idle_sleeps + 1, __ATOMIC_RELAXED);
+	}
+
+	return true;
+}
+
 /*
- * Prints the number of received packets and rx bitrate then reset the statistics.
- * Prints information with at least 1 second interval
+ * Picks the CPU core a worker is pinned to: the configured worker cores in order, or else
+ * the cores the process may run on, in order. Cores are reused once all of them are taken
  *
- * @data [in]: Pointer to the stream data
+ * @config [in]: Pointer to the application configuration structure
+ * @allowed [in]: The cores the process may run on
+ * @id [in]: Index of the worker
+ * @return: The CPU core index
+ */
+static int pick_worker_cpu(const struct app_config *config, const cpu_set_t *allowed, uint32_t id)
+{
+	uint32_t num_allowed = CPU_COUNT(allowed);
+	uint32_t nth;
+
+	if (config->num_worker_cpus > 0)
+		return config->worker_cpus[id % config->num_worker_cpus];
+
+	nth = id % num_allowed;
+	for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+		if (!CPU_ISSET(cpu, allowed))
+			continue;
+		if (nth-- == 0)
+			return cpu;
+	}
+	return 0;
+}
+
+doca_error_t init_workers(struct app_config *config,
+			  struct doca_dev *dev,
+			  struct stream_data *streams,
+			  struct worker_data *workers)
+{
+	cpu_set_t allowed;
+	doca_error_t ret;
+	uint32_t i;
+
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+		DOCA_LOG_ERR("Failed to get the process CPU affinity: %s", strerror(errno));
+		return DOCA_ERROR_OPERATING_SYSTEM;
+	}
+
+	for (i = 0; i < config->num_workers; ++i) {
+		struct worker_data *worker = &workers[i];
+		/* each worker receives a contiguous shard of the streams */
+		uint32_t first_stream = i * config->num_streams / config->num_workers;
+		uint32_t end_stream = (i + 1) * config->num_streams / config->num_workers;
+
+		worker->id = i;
+		worker->config = config;
+		worker->streams = &streams[first_stream];
+		worker->num_streams = 0;
+		worker->cpu = pick_worker_cpu(config, &allowed, i);
+		worker->ok = true;
+		worker->idle_sleeps = 0;
+		worker->run_recv_loop = false;
+		worker->last_pkts = 0;
+		worker->last_bytes = 0;
+
+		ret = init_globals(config, dev, &worker->globals);
+		if (ret != DOCA_SUCCESS)
+			goto destroy_workers;
+		for (uint32_t s = first_stream; s < end_stream; ++s) {
+			/* the flow of the stream steers its destination port to the worker */
+			ret = init_stream(config, dev, &worker->globals, config->dst_port + s, &streams[s]);
+			if (ret != DOCA_SUCCESS) {
+				destroy_workers(dev, worker, 1);
+				goto destroy_workers;
+			}
+			streams[s].run_recv_loop = &worker->run_recv_loop;
+			worker->num_streams++;
+		}
+		DOCA_LOG_INFO("Worker %u: CPU %d, ports %u-%u",
+			      i,
+			      worker->cpu,
+			      worker->streams[0].dst_port,
+			      worker->streams[worker->num_streams - 1].dst_port);
+	}
+
+	return DOCA_SUCCESS;
+destroy_workers:
+	DOCA_LOG_ERR("Failed to initialize worker %u: %s", i, doca_error_get_name(ret));
+	destroy_workers(dev, workers, i);
+	return ret;
+}
+
+bool destroy_workers(struct doca_dev *dev, struct worker_data *workers, uint32_t num_workers)
+{
+	bool is_ok = true;
+
+	for (uint32_t i = 0; i < num_workers; ++i) {
+		for (uint32_t s = 0; s < workers[i].num_streams; ++s)
+			if (!destroy_stream(dev, &workers[i].globals, &workers[i].streams[s]))
+				is_ok = false;
+		if (!destroy_globals(&workers[i].globals, dev))
+			is_ok = false;
+	}
+
+	return is_ok;
+}
+
+/*
+ * Worker thread entry point, pins the thread to the worker's CPU core and runs the receive
+ * loop of the worker's streams
+ *
+ * @arg [in]: Pointer to the worker data
+ * @return: NULL
+ */
+static void *worker_main(void *arg)
+{
+	struct worker_data *worker = (struct worker_data *)arg;
+	cpu_set_t cpuset;
+	int ret;
+
+	CPU_ZERO(&cpuset);
+	CPU_SET(worker->cpu, &cpuset);
+	ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+	if (ret != 0) {
+		DOCA_LOG_ERR("Failed to pin worker %u to CPU %d: %s", worker->id, worker->cpu, strerror(ret));
+		worker->ok = false;
+	} else
+		worker->ok = run_recv_loop(worker->config, worker);
+	/* let the main thread know this worker stopped */
+	__atomic_store_n(&worker->run_recv_loop, false, __ATOMIC_RELEASE);
+
+	return NULL;
+}
+
+/*
+ * Logs the number of received packets and rx bitrate over an interval
+ *
+ * @label [in]: Label of the statistics line
+ * @pkts [in]: Number of packets received during the interval
+ * @bytes [in]: Number of bytes received during the interval
+ * @dt [in]: Length of the interval in microseconds
+ */
+static void log_rate(const char *label, size_t pkts, size_t bytes, uint64_t dt)
+{
+	double mbits_received = (double)(bytes * 8) / dt;
+	const char *unit = mbits_received > 1e3 ? "Gbps" : "Mbps";
+	double rate = mbits_received > 1e3 ? mbits_received * 1e-3 : mbits_received;
+
+	DOCA_LOG_INFO("%-12s Got %7zu packets | %7.2lf %s during %7.2lf sec\n", label, pkts, rate, unit, dt * 1e-6);
+}
+
+/*
+ * Prints the number of received packets and rx bitrate of each worker and of all the workers
+ * together since the previous report. Prints information with at least 1 second interval
+ *
+ * @config [in]: Pointer to the application configuration structure
+ * @workers [in/out]: Array of config->num_workers workers
+ * @start [in/out]: Start time of the current interval
  * @return: true if statistics are printed successfully; false otherwise
  */
-static bool print_statistics(struct stream_data *data)
+static bool print_statistics(const struct app_config *config, struct worker_data *workers, struct timespec *start)
 {
 	static const uint64_t us_in_s = 1000000L;
 	struct timespec now;
-	int ret;
+	size_t total_pkts = 0;
+	size_t total_bytes = 0;
+	char label[32];
 	uint64_t dt;
-	double mbits_received;
+	int ret;
 
 	ret = clock_gettime(CLOCK_MONOTONIC_RAW, &now);
 	if (ret != 0) {
@@ -1254,65 +1660,88 @@ static bool print_statistics(struct stream_data *data)
 		return false;
 	}
 
-	dt = (now.tv_sec - data->start.tv_sec) * us_in_s;
-	dt += now.tv_nsec / 1000 - data->start.tv_nsec / 1000;
+	dt = (now.tv_sec - start->tv_sec) * us_in_s;
+	dt += now.tv_nsec / 1000 - start->tv_nsec / 1000;
 	/* ignore intervals shorter than 1 second */
 	if (dt < us_in_s)
 		return true;
 
-	mbits_received = (double)(data->recv_bytes * 8) / dt;
-	const char *unit = mbits_received > 1e3 ? "Gbps" : "Mbps";
-	double rate = mbits_received > 1e3 ? mbits_received * 1e-3 : mbits_received;
-
-	DOCA_LOG_INFO("Got %7zu packets | %7.2lf %s during %7.2lf sec\n", data->recv_pkts, rate, unit, dt * 1e-6);
+	for (uint32_t i = 0; i < config->num_workers; ++i) {
+		struct worker_data *worker = &workers[i];
+		size_t pkts = 0;
+		size_t bytes = 0;
 
-	/* clear stats */
-	data->start.tv_sec = now.tv_sec;
-	data->start.tv_nsec = now.tv_nsec;
-	data->recv_pkts = 0;
-	data->recv_bytes = 0;
+		for (uint32_t s = 0; s < worker->num_streams; ++s) {
+			pkts += __atomic_load_n(&worker->streams[s].recv_pkts, __ATOMIC_RELAXED);
+			bytes += __atomic_load_n(&worker->streams[s].recv_bytes, __ATOMIC_RELAXED);
+		}
 
-	return true;
-}
+		snprintf(label, sizeof(label), "Worker %u:", worker->id);
+		log_rate(label, pkts - worker->last_pkts, bytes - worker->last_bytes, dt);
+		DOCA_LOG_DBG("Worker %u: CPU %d, %u streams, %zu idle sleeps",
+			     worker->id,
+			     worker->cpu,
+			     worker->num_streams,
+			     __atomic_load_n(&worker->idle_sleeps, __ATOMIC_RELAXED));
 
-static void handle_error(struct doca_rmax_in_stream_event_rx_data *event_rx_data, union doca_data event_user_data)
-{
-	struct stream_data *data = event_user_data.ptr;
-	const struct doca_rmax_stream_error *err = doca_rmax_in_stream_event_rx_data_get_error(event_rx_data);
+		total_pkts += pkts - worker->last_pkts;
+		total_bytes += bytes - worker->last_bytes;
+		worker->last_pkts = pkts;
+		worker->last_bytes = bytes;
+	}
+	log_rate("Total:", total_pkts, total_bytes, dt);
 
-	if (err)
-		DOCA_LOG_ERR("Error: code=%d message=%s", err->code, err->message);
-	else
-		DOCA_LOG_ERR("Unknown error");
+	start->tv_sec = now.tv_sec;
+	start->tv_nsec = now.tv_nsec;
 
-	data->run_recv_loop = false;
+	return true;
 }
 
-bool run_recv_loop(const struct app_config *config, struct globals *globals, struct stream_data *data)
+bool run_workers(const struct app_config *config, struct worker_data *workers)
 {
-	int ret;
+	struct timespec start;
+	uint32_t num_started;
+	bool is_ok = true;
+	bool running = true;
+
+	for (num_started = 0; num_started < config->num_workers; ++num_started) {
+		workers[num_started].run_recv_loop = true;
+		if (pthread_create(&workers[num_started].thread, NULL, worker_main, &workers[num_started]) != 0) {
+			DOCA_LOG_ERR("Failed to create worker %u thread", num_started);
+			is_ok = false;
+			goto stop_workers;
+		}
+	}
 
-	ret = clock_gettime(CLOCK_MONOTONIC_RAW, &data->start);
-	if (ret != 0) {
+	if (clock_gettime(CLOCK_MONOTONIC_RAW, &start) != 0) {
 		DOCA_LOG_ERR("error getting time: %s", strerror(errno));
-		return false;
+		is_ok = false;
+		goto stop_workers;
 	}
 
-	data->run_recv_loop = true;
-
-	while (data->run_recv_loop) {
-		(void)doca_pe_progress(globals->pe);
-
-		if (!print_statistics(data))
-			return false;
-		if (config->sleep_us > 0) {
-			if (usleep(config->sleep_us) != 0) {
-				if (errno != EINTR)
-					DOCA_LOG_ERR("usleep error: %s", strerror(errno));
-				return false;
-			}
+	while (running) {
+		if (usleep(STATS_POLL_INTERVAL_US) != 0 && errno != EINTR) {
+			DOCA_LOG_ERR("usleep error: %s", strerror(errno));
+			is_ok = false;
+			break;
+		}
+		if (!print_statistics(config, workers, &start)) {
+			is_ok = false;
+			break;
 		}
+		for (uint32_t i = 0; i < config->num_workers; ++i)
+			if (!__atomic_load_n(&workers[i].run_recv_loop, __ATOMIC_ACQUIRE))
+				running = false;
 	}
 
-	return true;
+stop_workers:
+	for (uint32_t i = 0; i < num_started; ++i)
+		__atomic_store_n(&workers[i].run_recv_loop, false, __ATOMIC_RELAXED);
+	for (uint32_t i = 0; i < num_started; ++i) {
+		pthread_join(workers[i].thread, NULL);
+		if (!workers[i].ok)
+			is_ok = false;
+	}
+
+	return is_ok;
 }
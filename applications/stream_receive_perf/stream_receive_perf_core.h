@@ -26,6 +26,7 @@
 #ifndef STREAM_RECEIVE_PERF_CORE_H
 #define STREAM_RECEIVE_PERF_CORE_H
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdnoreturn.h>
@@ -39,7 +40,9 @@
 #include <doca_rmax.h>
 
 #define APP_NAME "doca_stream_receive_perf"
-#define MAX_BUFFERS 2 /* Maximum number of buffers allowed */
+#define MAX_BUFFERS 2	/* Maximum number of buffers allowed */
+#define MAX_WORKERS 64	/* Maximum number of worker threads */
+#define MAX_STREAMS 256 /* Maximum number of streams */
 
 /* Scatter type enum for packet processing */
 enum scatter_type {
@@ -69,33 +72,56 @@ struct app_config {
 	uint32_t num_elements;			      /* Number of elements in the stream buffer */
 	bool affinity_mask_set;			      /* Whether a CPU affinity mask is set */
 	struct doca_rmax_cpu_affinity *affinity_mask; /* CPU affinity mask */
-	useconds_t sleep_us;  /* Sleep duration between packet processing steps (in microseconds) */
+	useconds_t sleep_us;  /* Maximum sleep duration of an idle worker (in microseconds), 0 to always busy-poll */
 	uint32_t min_packets; /* Minimum number of packets to process in a single step */
 	uint32_t max_packets; /* Maximum number of packets to process in a single step */
+	uint32_t num_streams; /* Number of streams, bound to consecutive destination ports */
+	uint32_t num_workers; /* Number of worker threads, sharing the streams between them */
+	int worker_cpus[MAX_WORKERS]; /* CPU cores to pin the workers to, in order */
+	uint32_t num_worker_cpus;     /* Number of CPU cores in worker_cpus, 0 to use the process affinity */
 };
 
-/* Global resources required by the application */
+/* Global resources required by a worker */
 struct globals {
-	struct doca_mmap *mmap;		      /* Memory map for application resources */
-	struct doca_buf_inventory *inventory; /* Buffer inventory for managing memory buffers */
-	struct doca_pe *pe;		      /* Progress engine for processing tasks */
+	struct doca_pe *pe; /* Progress engine polling the streams of the worker */
 };
 
 /* Stream data structure for managing the state and data associated with streaming */
 struct stream_data {
-	size_t num_buffers;		    /* Number of buffers used*/
-	struct timespec start;		    /* Start time of the streaming process */
-	struct doca_rmax_in_stream *stream; /* Stream object for receiving data */
-	struct doca_buf *buffer;	    /* Memory buffer linked to the stream */
-	struct doca_rmax_flow *flow;	    /* Flow object attached to the stream */
-	uint16_t pkt_size[MAX_BUFFERS];	    /* Size of an element in each buffers */
-	uint16_t stride_size[MAX_BUFFERS];  /* Stride size for packet data in the buffers */
-	/* statistics */
+	size_t num_buffers;		      /* Number of buffers used*/
+	uint16_t dst_port;		      /* Destination port the stream is bound to */
+	struct doca_mmap *mmap;		      /* Memory map of the stream buffers */
+	struct doca_buf_inventory *inventory; /* Buffer inventory for managing memory buffers */
+	struct doca_rmax_in_stream *stream;   /* Stream object for receiving data */
+	struct doca_buf *buffer;	      /* Memory buffer linked to the stream */
+	struct doca_rmax_flow *flow;	      /* Flow object attached to the stream */
+	uint16_t pkt_size[MAX_BUFFERS];	      /* Size of an element in each buffers */
+	uint16_t stride_size[MAX_BUFFERS];    /* Stride size for packet data in the buffers */
+	/* statistics, written by the owning worker only */
 	size_t recv_pkts;  /* Number of packets received */
 	size_t recv_bytes; /* Total number of bytes received */
 	/* control flow */
-	bool dump;	    /* Whether to dump the content of received packets */
+	bool dump;	     /* Whether to dump the content of received packets */
+	bool *run_recv_loop; /* Receive loop flag of the owning worker, cleared on stream errors */
+};
+
+/* Worker thread data, each worker polls a contiguous shard of the streams */
+struct worker_data {
+	uint32_t id;			 /* Index of the worker */
+	const struct app_config *config; /* Application configuration */
+	struct globals globals;		 /* Progress engine resources of the worker */
+	struct stream_data *streams;	 /* The streams received by the worker */
+	uint32_t num_streams;		 /* Number of streams received by the worker */
+	int cpu;			 /* CPU core the worker is pinned to */
+	pthread_t thread;		 /* The worker thread */
+	bool ok;			 /* Whether the receive loop exited without error */
+	/* statistics, written by the worker only */
+	size_t idle_sleeps; /* Number of times the worker slept while its streams were idle */
+	/* control flow */
 	bool run_recv_loop; /* Flag to indicate whether the receive loop should continue running */
+	/* statistics snapshot, used by the main thread only */
+	size_t last_pkts;  /* Number of packets received at the last report */
+	size_t last_bytes; /* Number of bytes received at the last report */
 };
 
 /*
@@ -149,8 +175,7 @@ void list_devices(void);
 struct doca_dev *open_device(struct in_addr *dev_ip);
 
 /*
- * Initializes global application resources like memory maps, progress engines,
- * and buffer inventories. These resources are essential for handling stream operations
+ * Initializes the global resources of a worker, i.e. the progress engine polling its streams
  *
  * @config [in]: Pointer to the application configuration structure
  * @dev [in]: Pointer to the device handle opened by the application
@@ -160,8 +185,7 @@ struct doca_dev *open_device(struct in_addr *dev_ip);
 doca_error_t init_globals(struct app_config *config, struct doca_dev *dev, struct globals *globals);
 
 /*
- * Releases and destroys global application resources initialized earlier. This
- * includes stopping memory maps, destroying buffer inventories, and releasing progress engines
+ * Releases and destroys the global resources of a worker initialized earlier
  *
  * @globals [in]: Pointer to the global resources structure to destroy
  * @dev [in]: Pointer to the device handle associated with these resources
@@ -171,40 +195,80 @@ bool destroy_globals(struct globals *globals, struct doca_dev *dev);
 
 /*
  * Configures and initializes a stream for receiving packets.
- * Sets stream parameters, links to memory buffers, and connects to a flow for data reception
+ * Creates the memory map and buffer inventory of the stream, sets stream parameters,
+ * links to memory buffers, and connects to a flow for data reception
  *
  * @config [in]: Pointer to the application configuration structure
  * @dev [in]: Pointer to the device handle opened by the application
- * @globals [in]: Pointer to the global resources structure
+ * @globals [in]: Pointer to the global resources of the worker polling the stream
+ * @dst_port [in]: Destination port to bind the stream to
  * @data [in/out]: Pointer to the stream data structure to initialize
  * @return: DOCA_SUCCESS on successful initialization; appropriate DOCA error otherwise
  */
 doca_error_t init_stream(struct app_config *config,
 			 struct doca_dev *dev,
 			 struct globals *globals,
+			 uint16_t dst_port,
 			 struct stream_data *data);
 
 /*
  * Cleans up and destroys a stream, including flow detachment, stopping the context,
- * buffer release, and stream destruction
+ * buffer release, stream destruction and the release of its memory map
  *
  * @dev [in]: Pointer to the device handle associated with the stream
- * @globals [in]: Pointer to the global resources structure
+ * @globals [in]: Pointer to the global resources of the worker polling the stream
  * @data [in/out]: Pointer to the stream data structure to destroy
  * @return: true if all resources are successfully destroyed; false otherwise
  */
 bool destroy_stream(struct doca_dev *dev, struct globals *globals, struct stream_data *data);
 
 /*
- * Runs the packet reception loop. Progresses the DOCA progress engine,
- * collects statistics periodically, and handles sleep intervals if specified.
- * The loop runs until the `run_recv_loop` flag in the stream_data structure is set to false
+ * Runs the packet reception loop of a worker. Busy-polls the DOCA progress engine while
+ * packets arrive on any of its streams; once they are idle, backs off with exponentially
+ * growing sleeps bounded by the configured sleep duration, and returns to busy-polling on
+ * the next completion. The loop runs until the `run_recv_loop` flag of the worker is set to false
  *
- * @config [in]: Pointer to the application configuration structure, defining loop behavior such as sleep intervals
- * @globals [in]: Pointer to the global resources structure, including progress engine
- * @data [in/out]: Pointer to the stream data structure, managing control flow and maintaining statistics
+ * @config [in]: Pointer to the application configuration structure, defining the maximum sleep interval
+ * @worker [in/out]: Pointer to the worker data, managing control flow and maintaining statistics
  * @return: true if the loop runs and exits successfully; false otherwise
  */
-bool run_recv_loop(const struct app_config *config, struct globals *globals, struct stream_data *data);
+bool run_recv_loop(const struct app_config *config, struct worker_data *worker);
+
+/*
+ * Initializes the workers and their streams. The configured streams, bound to consecutive
+ * destination ports, are split into contiguous shards, one per worker, and each worker
+ * is assigned the CPU core it is pinned to
+ *
+ * @config [in]: Pointer to the application configuration structure
+ * @dev [in]: Pointer to the device handle opened by the application
+ * @streams [out]: Array of config->num_streams streams to initialize
+ * @workers [out]: Array of config->num_workers workers to initialize
+ * @return: DOCA_SUCCESS on successful initialization; appropriate DOCA error otherwise
+ */
+doca_error_t init_workers(struct app_config *config,
+			  struct doca_dev *dev,
+			  struct stream_data *streams,
+			  struct worker_data *workers);
+
+/*
+ * Destroys the streams and global resources of the workers
+ *
+ * @dev [in]: Pointer to the device handle associated with the workers
+ * @workers [in]: Array of workers to destroy
+ * @num_workers [in]: Number of workers in the array
+ * @return: true if all resources are successfully destroyed; false otherwise
+ */
+bool destroy_workers(struct doca_dev *dev, struct worker_data *workers, uint32_t num_workers);
+
+/*
+ * Runs the receive loop of each worker on its own thread, pinned to the worker's CPU core,
+ * and reports the per-worker and total throughput every second from the calling thread.
+ * Returns once any worker stops, after stopping all the others
+ *
+ * @config [in]: Pointer to the application configuration structure
+ * @workers [in/out]: Array of config->num_workers initialized workers
+ * @return: true if all the workers exited successfully; false otherwise
+ */
+bool run_workers(const struct app_config *config, struct worker_data *workers);
 
 #endif // STREAM_RECEIVE_PERF_CORE_H
@@ -23,12 +23,15 @@
  *
  */
 
+#include <errno.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <rte_cycles.h>
 #include <rte_ethdev.h>
 #include <rte_hash_crc.h>
+#include <rte_malloc.h>
 
 #include <dpdk_utils.h>
 #include <doca_dpdk.h>
@@ -40,6 +43,7 @@
 #include "upf_accel.h"
 #include "upf_accel_flow_processing.h"
 #include "upf_accel_pipeline.h"
+#include "upf_accel_session.h"
 
 DOCA_LOG_REGISTER(UPF_ACCEL);
 
@@ -57,40 +61,6 @@ static inline uint32_t port_id_and_idx_to_quota_counter(enum upf_accel_port port
 	return port_id * UPF_ACCEL_NUM_QUOTA_COUNTERS_PER_PORT + idx;
 }
 
-/*
- * Get the offset of a meter.
- *
- * Meters are organized as follows:
- *
- *         --       --
- *         |        | Meter[0]
- *         |        | Meter[1]
- *         | PDR[0]- ...
- *         |        |
- *         |        | Meter[UPF_ACCEL_MAX_PDR_NUM_RATE_METERS - 1]
- * Port[0]-         --
- *         |        | Meter[UPF_ACCEL_MAX_PDR_NUM_RATE_METERS]
- *         |        | Meter[UPF_ACCEL_MAX_PDR_NUM_RATE_METERS +1]
- *         | PDR[1] - ...
- *         |        |
- *         |        |
- *         --       -
- *...
- *
- * @port_id [in]: port ID .
- * @pdr_idx [in]: PDR index.
- * @meter_idx [in]: meter index.
- * @return: offset in meter table.
- */
-static inline uint32_t upf_accel_shared_meters_table_offset_get(enum upf_accel_port port_id,
-								uint32_t pdr_idx,
-								uint32_t meter_idx)
-{
-	const uint32_t num_meters_per_port = UPF_ACCEL_MAX_PDR_NUM_RATE_METERS * UPF_ACCEL_MAX_NUM_PDR;
-
-	return (port_id * num_meters_per_port) + UPF_ACCEL_MAX_PDR_NUM_RATE_METERS * pdr_idx + meter_idx;
-}
-
 /*
  * Clamp rate
  *
@@ -143,57 +113,78 @@ static inline struct upf_accel_qer *upf_accel_get_qer_by_qer_id(struct upf_accel
 	return qers->arr_qers;
 }
 
+/*
+ * Get the rate of a PDR shared meter
+ *
+ * QER MBR units: 1 kilobit per second.
+ * CIR and CBS units: 1 byte per second.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context.
+ * @pdr [in]: UPF PDR
+ * @meter_idx [in]: index of the meter in the PDR's QERs array.
+ * @return: CIR and CBS of the meter, the minimal rate if the meter isn't in use
+ */
+static uint64_t upf_accel_pdr_meter_rate_get(struct upf_accel_ctx *upf_accel_ctx,
+					     const struct upf_accel_pdr *pdr,
+					     uint32_t meter_idx)
+{
+	struct upf_accel_qer *qer;
+	uint64_t mbr;
+
+	if (meter_idx >= pdr->qerids_num)
+		return upf_accel_clamp_rate(0);
+
+	qer = upf_accel_get_qer_by_qer_id(upf_accel_ctx->upf_accel_cfg->qers, pdr->qerids[meter_idx]);
+	mbr = (pdr->pdi_si == UPF_ACCEL_PDR_PDI_SI_UL) ? qer->mbr_ul_mbr : qer->mbr_dl_mbr;
+
+	return upf_accel_clamp_rate(1000 * (mbr / CHAR_BIT));
+}
+
 /*
  * Shared meters init for a given port
  *
+ * All the meters of a PDR slot are configured, including those the PDR doesn't use, so the slot can be reused by
+ * a PDR added at runtime by reconfiguring its meters only.
+ *
  * @upf_accel_ctx [in]: UPF Acceleration context.
  * @cfg [in]: shared resource configuration.
- * @qer [in]: UPF PDR
+ * @pdr_idx [in]: index of PDR in the PDRs array.
  * @port_id [in]: port ID.
+ * @bind [in]: bind the meters to the port, only needed the first time they are configured.
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
 static doca_error_t upf_accel_shared_meters_dev_init(struct upf_accel_ctx *upf_accel_ctx,
 						     struct doca_flow_shared_resource_cfg *cfg,
-						     const struct upf_accel_pdr *pdr,
-						     enum upf_accel_port port_id)
+						     uint32_t pdr_idx,
+						     enum upf_accel_port port_id,
+						     bool bind)
 {
+	const struct upf_accel_pdr *pdr = &upf_accel_ctx->upf_accel_cfg->pdrs->arr_pdrs[pdr_idx];
 	struct doca_flow_port *port = upf_accel_ctx->ports[port_id];
-	struct upf_accel_qers *qers = upf_accel_ctx->upf_accel_cfg->qers;
-	uint32_t ids_array[UPF_ACCEL_MAX_NUM_PDR] = {0};
-	struct upf_accel_qer *qer;
-	uint64_t ul_cir_cbs;
-	uint64_t dl_cir_cbs;
+	uint32_t ids_array[UPF_ACCEL_MAX_PDR_NUM_RATE_METERS] = {0};
 	doca_error_t result;
 	uint32_t meter_idx;
 	uint32_t i;
 
-	for (i = 0; i < pdr->qerids_num; ++i) {
-		qer = upf_accel_get_qer_by_qer_id(qers, pdr->qerids[i]);
-
-		/*
-		 * QER MBR units: 1 kilobit per second.
-		 * CBS units: 1 byte per second.
-		 */
-		ul_cir_cbs = upf_accel_clamp_rate(1000 * (qer->mbr_ul_mbr / CHAR_BIT));
-		dl_cir_cbs = upf_accel_clamp_rate(1000 * (qer->mbr_dl_mbr / CHAR_BIT));
-
-		meter_idx = upf_accel_shared_meters_table_offset_get(
-			port_id,
-			upf_accel_get_pdr_index_from_pdrs(upf_accel_ctx->upf_accel_cfg->pdrs, pdr),
-			i);
-		cfg->meter_cfg.cir = cfg->meter_cfg.cbs = (pdr->pdi_si == UPF_ACCEL_PDR_PDI_SI_UL) ? ul_cir_cbs :
-												     dl_cir_cbs;
+	for (i = 0; i < UPF_ACCEL_MAX_PDR_NUM_RATE_METERS; ++i) {
+		meter_idx = upf_accel_shared_meters_table_offset_get(port_id, pdr_idx, i);
+		cfg->meter_cfg.cir = cfg->meter_cfg.cbs = upf_accel_pdr_meter_rate_get(upf_accel_ctx, pdr, i);
 		result = doca_flow_shared_resource_set_cfg(DOCA_FLOW_SHARED_RESOURCE_METER, meter_idx, cfg);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to cfg shared meter");
-			doca_flow_destroy();
 			return result;
 		}
 
 		ids_array[i] = meter_idx;
 	}
 
-	result = doca_flow_shared_resources_bind(DOCA_FLOW_SHARED_RESOURCE_METER, ids_array, pdr->qerids_num, port);
+	if (!bind)
+		return DOCA_SUCCESS;
+
+	result = doca_flow_shared_resources_bind(DOCA_FLOW_SHARED_RESOURCE_METER,
+						 ids_array,
+						 UPF_ACCEL_MAX_PDR_NUM_RATE_METERS,
+						 port);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to bind shared meters to port");
 		return result;
@@ -206,11 +197,11 @@ static doca_error_t upf_accel_shared_meters_dev_init(struct upf_accel_ctx *upf_a
  * Init shared meters level - one for each port and for each domain
  *
  * @upf_accel_ctx [in]: UPF Acceleration context.
- * @pdr [in]: UPF PDR
+ * @pdr_idx [in]: index of PDR in the PDRs array.
+ * @bind [in]: bind the meters to the ports.
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t upf_accel_shared_meters_level_init(struct upf_accel_ctx *upf_accel_ctx,
-						       const struct upf_accel_pdr *pdr)
+static doca_error_t upf_accel_shared_meters_level_init(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx, bool bind)
 {
 	struct doca_flow_shared_resource_cfg cfg = {.meter_cfg = {.limit_type = DOCA_FLOW_METER_LIMIT_TYPE_BYTES,
 								  .color_mode = DOCA_FLOW_METER_COLOR_MODE_BLIND,
@@ -220,7 +211,7 @@ static doca_error_t upf_accel_shared_meters_level_init(struct upf_accel_ctx *upf
 	doca_error_t result;
 
 	for (port_id = 0; port_id < upf_accel_ctx->num_ports; port_id++) {
-		result = upf_accel_shared_meters_dev_init(upf_accel_ctx, &cfg, pdr, port_id);
+		result = upf_accel_shared_meters_dev_init(upf_accel_ctx, &cfg, pdr_idx, port_id, bind);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to init DOCA shared meters port %u tx: %s",
 				     port_id,
@@ -240,15 +231,11 @@ static doca_error_t upf_accel_shared_meters_level_init(struct upf_accel_ctx *upf
  */
 static doca_error_t upf_accel_shared_meters_init(struct upf_accel_ctx *upf_accel_ctx)
 {
-	struct upf_accel_pdrs *pdrs = upf_accel_ctx->upf_accel_cfg->pdrs;
-	const struct upf_accel_pdr *pdr;
 	doca_error_t result;
 	uint32_t pdr_idx;
 
-	for (pdr_idx = 0; pdr_idx < pdrs->num_pdrs; ++pdr_idx) {
-		pdr = &pdrs->arr_pdrs[pdr_idx];
-
-		result = upf_accel_shared_meters_level_init(upf_accel_ctx, pdr);
+	for (pdr_idx = 0; pdr_idx < UPF_ACCEL_MAX_NUM_PDR; ++pdr_idx) {
+		result = upf_accel_shared_meters_level_init(upf_accel_ctx, pdr_idx, true);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to init DOCA shared meters of pdr %u: %s",
 				     pdr_idx,
@@ -401,6 +388,89 @@ static doca_error_t upf_accel_tx_counters_insert(struct upf_accel_ctx *upf_accel
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Set the rates of the SW meters of a PDR slot from its current QERs
+ *
+ * A meter that was never used starts with a full bucket, otherwise its tokens are kept, limited to the new burst
+ * size.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context.
+ * @pdr_idx [in]: index of PDR in the PDRs array.
+ */
+static void upf_accel_sw_meters_pdr_set(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx)
+{
+	const struct upf_accel_pdr *pdr = &upf_accel_ctx->upf_accel_cfg->pdrs->arr_pdrs[pdr_idx];
+	struct upf_accel_sw_meter *meter;
+	enum upf_accel_port port_id;
+	uint64_t tsc = rte_rdtsc();
+	uint64_t rate;
+	uint32_t i;
+
+	for (i = 0; i < UPF_ACCEL_MAX_PDR_NUM_RATE_METERS; ++i) {
+		rate = upf_accel_pdr_meter_rate_get(upf_accel_ctx, pdr, i);
+
+		for (port_id = 0; port_id < upf_accel_ctx->num_ports; port_id++) {
+			meter = &upf_accel_ctx->sw_meters[upf_accel_shared_meters_table_offset_get(port_id, pdr_idx, i)];
+
+			rte_spinlock_lock(&meter->lock);
+			meter->cir = meter->cbs = rate;
+			if (meter->last_tsc) {
+				meter->tokens = RTE_MIN(meter->tokens, meter->cbs);
+			} else {
+				meter->tokens = meter->cbs;
+				meter->last_tsc = tsc;
+			}
+			rte_spinlock_unlock(&meter->lock);
+		}
+	}
+}
+
+/*
+ * Init the SW meters policing the not accelerated flows
+ *
+ * Every HW shared meter gets a SW counterpart with the same rate, located at the same offset. Both get the full QER
+ * MBR, the SW meter is debited by what the HW meter passed, see upf_accel_sw_meters_hw_sync().
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context.
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t upf_accel_sw_meters_init(struct upf_accel_ctx *upf_accel_ctx)
+{
+	uint32_t num_meters = upf_accel_shared_meters_table_offset_get(upf_accel_ctx->num_ports,
+									UPF_ACCEL_MAX_NUM_PDR,
+									UPF_ACCEL_MAX_PDR_NUM_RATE_METERS);
+	uint32_t pdr_idx;
+	uint32_t i;
+
+	upf_accel_ctx->sw_meters = rte_calloc("SW meters",
+					      num_meters,
+					      sizeof(*upf_accel_ctx->sw_meters),
+					      RTE_CACHE_LINE_SIZE);
+	if (!upf_accel_ctx->sw_meters) {
+		DOCA_LOG_ERR("Failed to allocate SW meters");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	for (i = 0; i < num_meters; i++)
+		rte_spinlock_init(&upf_accel_ctx->sw_meters[i].lock);
+
+	for (pdr_idx = 0; pdr_idx < UPF_ACCEL_MAX_NUM_PDR; ++pdr_idx)
+		upf_accel_sw_meters_pdr_set(upf_accel_ctx, pdr_idx);
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Cleanup the SW meters
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context.
+ */
+static void upf_accel_sw_meters_cleanup(struct upf_accel_ctx *upf_accel_ctx)
+{
+	rte_free(upf_accel_ctx->sw_meters);
+	upf_accel_ctx->sw_meters = NULL;
+}
+
 /*
  * Insert entry to the shared meters pipe
  *
@@ -420,6 +490,7 @@ static doca_error_t pipe_shared_meter_common_insert(struct upf_accel_ctx *upf_ac
 	struct doca_flow_match match = {.meta.pkt_meta = DOCA_HTOBE32(pdr->id)};
 	struct doca_flow_monitor mon = {
 		.meter_type = DOCA_FLOW_RESOURCE_TYPE_SHARED,
+		.counter_type = DOCA_FLOW_RESOURCE_TYPE_NON_SHARED,
 	};
 	struct doca_flow_fwd fwd = {
 		.type = DOCA_FLOW_FWD_PIPE,
@@ -438,7 +509,7 @@ static doca_error_t pipe_shared_meter_common_insert(struct upf_accel_ctx *upf_ac
 
 	mon.shared_meter.shared_meter_id = upf_accel_shared_meters_table_offset_get(port_id, pdr_idx, qer_idx);
 
-	if (pipe_pdr_insert(upf_accel_ctx, &entry_cfg, NULL)) {
+	if (pipe_pdr_insert(upf_accel_ctx, &entry_cfg, &upf_accel_ctx->meter_entries[pdr_idx][qer_idx][port_id])) {
 		DOCA_LOG_ERR("Failed to insert p%d tx meter %u entry: %u", port_id, qer_idx, pdr->id);
 		return -1;
 	}
@@ -471,6 +542,121 @@ static doca_error_t pipe_shared_meter_insert(struct upf_accel_ctx *upf_accel_ctx
 	return DOCA_SUCCESS;
 }
 
+doca_error_t upf_accel_pdr_rules_add(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx)
+{
+	const struct upf_accel_pdr *pdr = &upf_accel_ctx->upf_accel_cfg->pdrs->arr_pdrs[pdr_idx];
+	struct upf_accel_qer *qer;
+	doca_error_t result;
+	uint8_t qfi;
+	uint32_t i;
+
+	qfi = UPF_ACCEL_QFI_NONE;
+	if (pdr->qerids_num) {
+		/* QFI is chosen randomly since different QERs might have different QFI values */
+		qer = upf_accel_get_qer_by_qer_id(upf_accel_ctx->upf_accel_cfg->qers, pdr->qerids[pdr->qerids_num - 1]);
+		qfi = qer->qfi;
+	}
+
+	result = upf_accel_tx_counters_insert(upf_accel_ctx,
+					      pdr_idx,
+					      pdr->id,
+					      pdr->farid,
+					      qfi,
+					      pdr->pdi_si,
+					      upf_accel_ctx->smf_entries[pdr_idx]);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	for (i = 0; i < pdr->qerids_num; ++i) {
+		result = pipe_shared_meter_insert(upf_accel_ctx, pdr_idx, i);
+		if (result != DOCA_SUCCESS)
+			return result;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+doca_error_t upf_accel_pdr_rules_remove(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx, uint32_t num_qers)
+{
+	struct doca_flow_pipe_entry **entry;
+	enum upf_accel_port port_id;
+	doca_error_t result;
+	uint32_t i;
+
+	for (port_id = 0; port_id < upf_accel_ctx->num_ports; port_id++) {
+		entry = &upf_accel_ctx->smf_entries[pdr_idx][port_id];
+		if (*entry) {
+			result = doca_flow_pipe_remove_entry(0, DOCA_FLOW_NO_WAIT, *entry);
+			if (result != DOCA_SUCCESS) {
+				DOCA_LOG_ERR("Failed to remove p%d pdr entry %u: %s",
+					     port_id,
+					     pdr_idx,
+					     doca_error_get_descr(result));
+				return result;
+			}
+			*entry = NULL;
+		}
+
+		for (i = 0; i < num_qers; ++i) {
+			entry = &upf_accel_ctx->meter_entries[pdr_idx][i][port_id];
+			if (!*entry)
+				continue;
+
+			result = doca_flow_pipe_remove_entry(0, DOCA_FLOW_NO_WAIT, *entry);
+			if (result != DOCA_SUCCESS) {
+				DOCA_LOG_ERR("Failed to remove p%d tx meter %u entry %u: %s",
+					     port_id,
+					     i,
+					     pdr_idx,
+					     doca_error_get_descr(result));
+				return result;
+			}
+			*entry = NULL;
+		}
+	}
+
+	return DOCA_SUCCESS;
+}
+
+doca_error_t upf_accel_pdr_meters_update(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx)
+{
+	doca_error_t result;
+
+	result = upf_accel_shared_meters_level_init(upf_accel_ctx, pdr_idx, false);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	upf_accel_sw_meters_pdr_set(upf_accel_ctx, pdr_idx);
+
+	return DOCA_SUCCESS;
+}
+
+doca_error_t upf_accel_static_entries_process(struct upf_accel_ctx *upf_accel_ctx, uint32_t num_entries)
+{
+	struct entries_status *ctrl_status;
+	enum upf_accel_port port_id;
+	doca_error_t result;
+
+	for (port_id = 0; port_id < upf_accel_ctx->num_ports; port_id++) {
+		ctrl_status = &upf_accel_ctx->static_entry_ctx[port_id].static_ctx.ctrl_status;
+		ctrl_status->nb_processed = 0;
+		ctrl_status->failure = false;
+
+		result = doca_flow_entries_process(upf_accel_ctx->ports[port_id], 0, DEFAULT_TIMEOUT_US, num_entries);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to process entries on port %u: %s", port_id, doca_error_get_descr(result));
+			return result;
+		}
+
+		if ((num_entries && ctrl_status->nb_processed != (int)num_entries) || ctrl_status->failure) {
+			DOCA_LOG_ERR("Failed to process port %u entries", port_id);
+			return DOCA_ERROR_BAD_STATE;
+		}
+	}
+
+	return DOCA_SUCCESS;
+}
+
 /*
  * Add all SMF related rules
  *
@@ -480,44 +666,16 @@ static doca_error_t pipe_shared_meter_insert(struct upf_accel_ctx *upf_accel_ctx
 static doca_error_t upf_accel_smf_rules_add(struct upf_accel_ctx *upf_accel_ctx)
 {
 	const struct upf_accel_pdrs *pdrs = upf_accel_ctx->upf_accel_cfg->pdrs;
-	const size_t num_pdrs = pdrs->num_pdrs;
-	const struct upf_accel_pdr *pdr;
-	struct upf_accel_qer *qer;
 	doca_error_t result;
 	uint32_t pdr_idx;
-	uint32_t far_id;
-	uint8_t qfi;
-	int pdr_id;
-	uint32_t i;
-
-	for (pdr_idx = 0; pdr_idx < num_pdrs; pdr_idx++) {
-		pdr = &pdrs->arr_pdrs[pdr_idx];
-		far_id = pdr->farid;
-		pdr_id = pdr->id;
-		qfi = UPF_ACCEL_QFI_NONE;
 
-		if (pdr->qerids_num) {
-			/* QFI is chosen randomly since different QERs might have different QFI values */
-			qer = upf_accel_get_qer_by_qer_id(upf_accel_ctx->upf_accel_cfg->qers,
-							  pdr->qerids[pdr->qerids_num - 1]);
-			qfi = qer->qfi;
-		}
+	for (pdr_idx = 0; pdr_idx < pdrs->num_pdrs; pdr_idx++) {
+		if (!pdrs->arr_pdrs[pdr_idx].active)
+			continue;
 
-		result = upf_accel_tx_counters_insert(upf_accel_ctx,
-						      pdr_idx,
-						      pdr_id,
-						      far_id,
-						      qfi,
-						      pdr->pdi_si,
-						      upf_accel_ctx->smf_entries[pdr_idx]);
+		result = upf_accel_pdr_rules_add(upf_accel_ctx, pdr_idx);
 		if (result != DOCA_SUCCESS)
 			return result;
-
-		for (i = 0; i < pdr->qerids_num; ++i) {
-			result = pipe_shared_meter_insert(upf_accel_ctx, pdr_idx, i);
-			if (result != DOCA_SUCCESS)
-				return result;
-		}
 	}
 
 	return DOCA_SUCCESS;
@@ -613,6 +771,8 @@ static uint32_t calculate_hash_table_size(uint16_t num_cores)
  * Quota enforcement counters defined by QER which we consume from
  * the PDR description (if exists), hence, the number of counters we'll have
  * will be at most as the number of PDRs, but per port (i.e. twice).
+ * Counters are bound for every PDR slot, so PDRs added at runtime find theirs
+ * already in place.
  *
  * @upf_accel_ctx [in]: UPF Acceleration context.
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
@@ -627,7 +787,7 @@ static doca_error_t upf_accel_init_quota_counters(struct upf_accel_ctx *upf_acce
 
 	result = alloc_and_populate_quota_counters_ids(0,
 						       upf_accel_ctx->num_ports,
-						       upf_accel_ctx->upf_accel_cfg->pdrs->num_pdrs,
+						       UPF_ACCEL_MAX_NUM_PDR,
 						       &shared_counter_ids);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to populate quota counters ids");
@@ -635,7 +795,7 @@ static doca_error_t upf_accel_init_quota_counters(struct upf_accel_ctx *upf_acce
 	}
 
 	for (port_id = 0; port_id < upf_accel_ctx->num_ports; port_id++) {
-		for (i = 0; i < upf_accel_ctx->upf_accel_cfg->pdrs->num_pdrs; ++i) {
+		for (i = 0; i < UPF_ACCEL_MAX_NUM_PDR; ++i) {
 			result = doca_flow_shared_resource_set_cfg(DOCA_FLOW_SHARED_RESOURCE_COUNTER,
 								   shared_counter_ids.ids[port_id][i],
 								   &cfg);
@@ -646,7 +806,7 @@ static doca_error_t upf_accel_init_quota_counters(struct upf_accel_ctx *upf_acce
 		}
 		result = doca_flow_shared_resources_bind(DOCA_FLOW_SHARED_RESOURCE_COUNTER,
 							 shared_counter_ids.ids[port_id],
-							 upf_accel_ctx->upf_accel_cfg->pdrs->num_pdrs,
+							 UPF_ACCEL_MAX_NUM_PDR,
 							 upf_accel_ctx->ports[port_id]);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to bind shared counter to port %d", port_id);
@@ -692,8 +852,8 @@ static doca_error_t upf_accel_fp_data_init(struct upf_accel_ctx *ctx, struct upf
 	uint16_t num_cores = rte_lcore_count() - 1;
 
 	assert(num_cores > 0);
-	uint16_t quota_cntrs_per_core_num = ctx->upf_accel_cfg->pdrs->num_pdrs / num_cores;
-	uint16_t quota_cntrs_remainder_num = ctx->upf_accel_cfg->pdrs->num_pdrs % num_cores;
+	uint16_t quota_cntrs_per_core_num = UPF_ACCEL_MAX_NUM_PDR / num_cores;
+	uint16_t quota_cntrs_remainder_num = UPF_ACCEL_MAX_NUM_PDR % num_cores;
 	uint32_t ht_size = calculate_hash_table_size(num_cores);
 	char mem_name[RTE_MEMZONE_NAMESIZE];
 	struct rte_hash_parameters dyn_tbl_params = {
@@ -763,6 +923,7 @@ static doca_error_t upf_accel_fp_data_init(struct upf_accel_ctx *ctx, struct upf
 
 		fp_data->ctx = ctx;
 		fp_data->queue_id = queue_id++;
+		fp_data->dyn_tbl_size = dyn_tbl_params.entries;
 
 		upf_accel_sw_aging_ll_init(fp_data, PARSER_PKT_TYPE_TUNNELED);
 		upf_accel_sw_aging_ll_init(fp_data, PARSER_PKT_TYPE_PLAIN);
@@ -798,14 +959,16 @@ static void upf_accel_fp_sw_counters_print(struct upf_accel_fp_data *fp_data_arr
 		sw_counters = &fp_data->sw_counters;
 
 		DOCA_LOG_INFO(
-			"Core %3u sw new_pkts=%-8lu new_bytes=%-8lu ex_pkts=%-8lu ex_bytes=%-8lu err_pkts=%-8lu err_bytes=%-8lu",
+			"Core %3u sw new_pkts=%-8lu new_bytes=%-8lu ex_pkts=%-8lu ex_bytes=%-8lu err_pkts=%-8lu err_bytes=%-8lu rate_drop_pkts=%-8lu rate_drop_bytes=%-8lu",
 			lcore,
 			sw_counters->new_conn.pkts,
 			sw_counters->new_conn.bytes,
 			sw_counters->ex_conn.pkts,
 			sw_counters->ex_conn.bytes,
 			sw_counters->err.pkts,
-			sw_counters->err.bytes);
+			sw_counters->err.bytes,
+			sw_counters->rate_drop.pkts,
+			sw_counters->rate_drop.bytes);
 
 		sw_sum.new_conn.pkts += sw_counters->new_conn.pkts;
 		sw_sum.new_conn.bytes += sw_counters->new_conn.bytes;
@@ -813,16 +976,20 @@ static void upf_accel_fp_sw_counters_print(struct upf_accel_fp_data *fp_data_arr
 		sw_sum.ex_conn.bytes += sw_counters->ex_conn.bytes;
 		sw_sum.err.pkts += sw_counters->err.pkts;
 		sw_sum.err.bytes += sw_counters->err.bytes;
+		sw_sum.rate_drop.pkts += sw_counters->rate_drop.pkts;
+		sw_sum.rate_drop.bytes += sw_counters->rate_drop.bytes;
 	}
 
 	DOCA_LOG_INFO(
-		"TOTAL sw    new_pkts=%-8lu new_bytes=%-8lu ex_pkts=%-8lu ex_bytes=%-8lu err_pkts=%-8lu err_bytes=%-8lu",
+		"TOTAL sw    new_pkts=%-8lu new_bytes=%-8lu ex_pkts=%-8lu ex_bytes=%-8lu err_pkts=%-8lu err_bytes=%-8lu rate_drop_pkts=%-8lu rate_drop_bytes=%-8lu",
 		sw_sum.new_conn.pkts,
 		sw_sum.new_conn.bytes,
 		sw_sum.ex_conn.pkts,
 		sw_sum.ex_conn.bytes,
 		sw_sum.err.pkts,
-		sw_sum.err.bytes);
+		sw_sum.err.bytes,
+		sw_sum.rate_drop.pkts,
+		sw_sum.rate_drop.bytes);
 }
 
 /*
@@ -901,6 +1068,47 @@ static void upf_accel_fp_accel_counters_print(struct upf_accel_fp_data *fp_data_
 		wan_sum.aging_errors);
 }
 
+/*
+ * Print FP acceleration policy debug counters of each worker
+ *
+ * @fp_data_arr [in]: flow processing data array
+ */
+static void upf_accel_fp_policy_counters_print(struct upf_accel_fp_data *fp_data_arr)
+{
+	struct upf_accel_fp_policy_counters policy_sum = {0};
+	struct upf_accel_fp_policy_counters *policy_counters;
+	struct upf_accel_fp_data *fp_data;
+	unsigned int lcore;
+
+	DOCA_LOG_INFO("//////////////////// ACCELERATION POLICY COUNTERS ////////////////////");
+
+	RTE_LCORE_FOREACH_WORKER(lcore)
+	{
+		fp_data = &fp_data_arr[lcore];
+		policy_counters = &fp_data->policy_counters;
+
+		DOCA_LOG_INFO(
+			"Core %3u policy deferred_not_heavy=%-8lu deferred_budget=%-8lu retries=%-8lu retries_succeeded=%-8lu",
+			lcore,
+			policy_counters->deferred_not_heavy,
+			policy_counters->deferred_budget,
+			policy_counters->retries,
+			policy_counters->retries_succeeded);
+
+		policy_sum.deferred_not_heavy += policy_counters->deferred_not_heavy;
+		policy_sum.deferred_budget += policy_counters->deferred_budget;
+		policy_sum.retries += policy_counters->retries;
+		policy_sum.retries_succeeded += policy_counters->retries_succeeded;
+	}
+
+	DOCA_LOG_INFO(
+		"TOTAL policy    deferred_not_heavy=%-8lu deferred_budget=%-8lu retries=%-8lu retries_succeeded=%-8lu",
+		policy_sum.deferred_not_heavy,
+		policy_sum.deferred_budget,
+		policy_sum.retries,
+		policy_sum.retries_succeeded);
+}
+
 /*
  * Print PDR counters of each worker
  *
@@ -921,6 +1129,8 @@ static void upf_accel_pdrs_print(struct upf_accel_ctx *upf_accel_ctx)
 
 	for (pdr_idx = 0; pdr_idx < pdrs->num_pdrs; pdr_idx++) {
 		pdr = &pdrs->arr_pdrs[pdr_idx];
+		if (!pdr->active)
+			continue;
 		pdr_id = pdr->id;
 
 		pdr_sum.counter.total_pkts = 0;
@@ -954,6 +1164,57 @@ static void upf_accel_pdrs_print(struct upf_accel_ctx *upf_accel_ctx)
 	}
 }
 
+/*
+ * Print the SW meters counters of each QER, summed over the PDRs and ports using it
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ */
+static void upf_accel_sw_meters_print(struct upf_accel_ctx *upf_accel_ctx)
+{
+	const struct upf_accel_pdrs *pdrs = upf_accel_ctx->upf_accel_cfg->pdrs;
+	const struct upf_accel_qers *qers = upf_accel_ctx->upf_accel_cfg->qers;
+	uint64_t conform_pkts, conform_bytes, exceed_pkts, exceed_bytes;
+	const struct upf_accel_sw_meter *meter;
+	const struct upf_accel_pdr *pdr;
+	enum upf_accel_port port_id;
+	uint32_t qer_idx, pdr_idx, i;
+
+	DOCA_LOG_INFO("//////////////////// SW QER METERS COUNTERS ////////////////////");
+
+	for (qer_idx = 0; qer_idx < qers->num_qers; qer_idx++) {
+		conform_pkts = conform_bytes = exceed_pkts = exceed_bytes = 0;
+
+		for (pdr_idx = 0; pdr_idx < pdrs->num_pdrs; pdr_idx++) {
+			pdr = &pdrs->arr_pdrs[pdr_idx];
+			if (!pdr->active)
+				continue;
+
+			for (i = 0; i < pdr->qerids_num; i++) {
+				if (pdr->qerids[i] != qers->arr_qers[qer_idx].id)
+					continue;
+
+				for (port_id = 0; port_id < upf_accel_ctx->num_ports; port_id++) {
+					meter = &upf_accel_ctx->sw_meters[upf_accel_shared_meters_table_offset_get(
+						port_id,
+						pdr_idx,
+						i)];
+					conform_pkts += meter->conform_pkts;
+					conform_bytes += meter->conform_bytes;
+					exceed_pkts += meter->exceed_pkts;
+					exceed_bytes += meter->exceed_bytes;
+				}
+			}
+		}
+
+		DOCA_LOG_INFO("QER %2u conform_pkts=%-8lu conform_bytes=%-8lu exceed_pkts=%-8lu exceed_bytes=%-8lu",
+			      qers->arr_qers[qer_idx].id,
+			      conform_pkts,
+			      conform_bytes,
+			      exceed_pkts,
+			      exceed_bytes);
+	}
+}
+
 /*
  * Print Drop Counter
  *
@@ -1053,8 +1314,14 @@ static void upf_accel_debug_counters_print(struct upf_accel_ctx *upf_accel_ctx,
 	DOCA_LOG_INFO("");
 	upf_accel_fp_accel_counters_print(fp_data_arr, "ACCELERATION FAILED");
 	DOCA_LOG_INFO("");
+	upf_accel_fp_policy_counters_print(fp_data_arr);
+	DOCA_LOG_INFO("");
+	upf_accel_session_ctrl_counters_print(upf_accel_ctx);
+	DOCA_LOG_INFO("");
 	upf_accel_pdrs_print(upf_accel_ctx);
 	DOCA_LOG_INFO("");
+	upf_accel_sw_meters_print(upf_accel_ctx);
+	DOCA_LOG_INFO("");
 	upf_accel_static_hw_counters_print(upf_accel_ctx);
 	DOCA_LOG_INFO("");
 }
@@ -1133,6 +1400,58 @@ static enum upf_accel_port upf_accel_single_port_get_fwd_port(enum upf_accel_por
 	return port_id;
 }
 
+/*
+ * Init the RCU variable the workers report their quiescent states to and publish the SMF configuration file rules
+ *
+ * @upf_accel_ctx [in/out]: UPF Acceleration context
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t upf_accel_rcu_init(struct upf_accel_ctx *upf_accel_ctx)
+{
+	const struct upf_accel_config *cfg = upf_accel_ctx->upf_accel_cfg;
+	size_t size = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+
+	upf_accel_ctx->qsv = rte_zmalloc("UPF RCU", size, RTE_CACHE_LINE_SIZE);
+	if (!upf_accel_ctx->qsv) {
+		DOCA_LOG_ERR("Failed to allocate RCU variable");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	if (rte_rcu_qsbr_init(upf_accel_ctx->qsv, RTE_MAX_LCORE)) {
+		DOCA_LOG_ERR("Failed to init RCU variable");
+		rte_free(upf_accel_ctx->qsv);
+		upf_accel_ctx->qsv = NULL;
+		return DOCA_ERROR_INITIALIZATION;
+	}
+
+	upf_accel_ctx->rules = rte_zmalloc("UPF rules", sizeof(*upf_accel_ctx->rules), RTE_CACHE_LINE_SIZE);
+	if (!upf_accel_ctx->rules) {
+		DOCA_LOG_ERR("Failed to allocate rules snapshot");
+		rte_free(upf_accel_ctx->qsv);
+		upf_accel_ctx->qsv = NULL;
+		return DOCA_ERROR_NO_MEMORY;
+	}
+	upf_accel_ctx->rules->pdrs = cfg->pdrs;
+	upf_accel_ctx->rules->fars = cfg->fars;
+	upf_accel_ctx->rules->urrs = cfg->urrs;
+	upf_accel_ctx->rules->qers = cfg->qers;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Cleanup the RCU variable and the published rules snapshot, the rules themselves belong to the configuration
+ *
+ * @upf_accel_ctx [in/out]: UPF Acceleration context
+ */
+static void upf_accel_rcu_cleanup(struct upf_accel_ctx *upf_accel_ctx)
+{
+	rte_free(upf_accel_ctx->rules);
+	upf_accel_ctx->rules = NULL;
+	rte_free(upf_accel_ctx->qsv);
+	upf_accel_ctx->qsv = NULL;
+}
+
 /*
  * UPF Acceleration application deinitialization
  *
@@ -1149,7 +1468,10 @@ static doca_error_t deinit_upf_accel(struct upf_accel_ctx *upf_accel_ctx, struct
 		DOCA_LOG_ERR("Failed to stop doca flow ports: %s", doca_error_get_descr(result));
 	}
 
+	upf_accel_session_ctrl_destroy(upf_accel_ctx);
 	upf_accel_fp_data_cleanup(fp_data_arr);
+	upf_accel_sw_meters_cleanup(upf_accel_ctx);
+	upf_accel_rcu_cleanup(upf_accel_ctx);
 	doca_flow_destroy();
 
 	return result;
@@ -1181,10 +1503,14 @@ static doca_error_t init_upf_accel(struct upf_accel_ctx *upf_accel_ctx, struct u
 		return result;
 	}
 
+	result = upf_accel_rcu_init(upf_accel_ctx);
+	if (result != DOCA_SUCCESS)
+		goto cleanup_doca_flow;
+
 	result = upf_accel_fp_data_init(upf_accel_ctx, fp_data_arr);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to init FP data");
-		goto cleanup_doca_flow;
+		goto cleanup_rcu;
 	}
 
 	ARRAY_INIT(actions_mem_size, ACTIONS_MEM_SIZE(upf_accel_ctx->num_queues, UPF_ACCEL_MAX_NUM_CONNECTIONS));
@@ -1210,6 +1536,12 @@ static doca_error_t init_upf_accel(struct upf_accel_ctx *upf_accel_ctx, struct u
 		goto cleanup_ports;
 	}
 
+	result = upf_accel_sw_meters_init(upf_accel_ctx);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to init SW meters: %s", doca_error_get_descr(result));
+		goto cleanup_ports;
+	}
+
 	result = upf_accel_pipeline_create(upf_accel_ctx);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to create pipeline: %s", doca_error_get_descr(result));
@@ -1240,15 +1572,26 @@ static doca_error_t init_upf_accel(struct upf_accel_ctx *upf_accel_ctx, struct u
 		}
 	}
 
+	if (upf_accel_ctx->upf_accel_cfg->session_ctrl_path) {
+		result = upf_accel_session_ctrl_init(upf_accel_ctx);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to init session control: %s", doca_error_get_descr(result));
+			goto cleanup_ports;
+		}
+	}
+
 	return DOCA_SUCCESS;
 
 cleanup_ports:
+	upf_accel_sw_meters_cleanup(upf_accel_ctx);
 	tmp_result = stop_doca_flow_ports(upf_accel_ctx->num_ports, upf_accel_ctx->ports);
 	if (tmp_result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to stop doca flow ports: %s", doca_error_get_descr(tmp_result));
 	}
 cleanup_fp_data:
 	upf_accel_fp_data_cleanup(*fp_data_arr);
+cleanup_rcu:
+	upf_accel_rcu_cleanup(upf_accel_ctx);
 cleanup_doca_flow:
 	doca_flow_destroy();
 
@@ -1264,10 +1607,10 @@ cleanup_doca_flow:
  */
 static doca_error_t run_upf_accel(struct upf_accel_ctx *upf_accel_ctx, struct upf_accel_fp_data *fp_data_arr)
 {
+	const struct timespec timeout = {.tv_nsec = UPF_ACCEL_SESSION_POLL_PERIOD_MS * NS_PER_S / MS_PER_S};
 	doca_error_t result;
 	sigset_t sigset;
 	int sig;
-	int ret;
 
 	result = upf_accel_signals_mask(&sigset);
 	if (result != DOCA_SUCCESS) {
@@ -1283,10 +1626,16 @@ static doca_error_t run_upf_accel(struct upf_accel_ctx *upf_accel_ctx, struct up
 	DOCA_LOG_INFO("Waiting for traffic, press Ctrl+C for termination");
 
 	while (!force_quit) {
-		ret = sigwait(&sigset, &sig);
-		if (ret) {
-			DOCA_LOG_ERR("Failed to sigwait: %s", strerror(ret));
-			return result;
+		/* Signals are waited for with a timeout, so the session control is served in between */
+		sig = sigtimedwait(&sigset, NULL, &timeout);
+		if (sig < 0) {
+			if (errno != EAGAIN && errno != EINTR) {
+				DOCA_LOG_ERR("Failed to sigtimedwait: %s", strerror(errno));
+				return result;
+			}
+			upf_accel_session_ctrl_poll(upf_accel_ctx);
+			upf_accel_sw_meters_hw_sync(upf_accel_ctx);
+			continue;
 		}
 
 		switch (sig) {
@@ -1384,6 +1733,83 @@ static doca_error_t pkts_before_accel_callback(void *param, void *config)
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Callback to handle the flow insertions budget param
+ *
+ * @param [in]: input param (insertions per second)
+ * @config [in]: UPF Acceleration configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t accel_budget_callback(void *param, void *config)
+{
+	struct upf_accel_config *cfg = (struct upf_accel_config *)config;
+	const int n = *(const int *)param;
+
+	if (n < 0) {
+		DOCA_LOG_ERR("Bad param: accel-budget must be non-negative");
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	cfg->accel_budget = n;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Callback to handle the meters check param
+ *
+ * @param [in]: input param (whether to run the check)
+ * @config [in]: UPF Acceleration configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t meter_check_callback(void *param, void *config)
+{
+	struct upf_accel_config *cfg = (struct upf_accel_config *)config;
+
+	cfg->meter_check = *(bool *)param;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Callback to handle the max number of QERs of a PDR param
+ *
+ * @param [in]: input param (number of QERs)
+ * @config [in]: UPF Acceleration configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t max_pdr_qers_callback(void *param, void *config)
+{
+	struct upf_accel_config *cfg = (struct upf_accel_config *)config;
+	const int n = *(const int *)param;
+
+	if (n < 0 || n > (int)UPF_ACCEL_MAX_PDR_NUM_RATE_METERS) {
+		DOCA_LOG_ERR("Bad param: max-pdr-qers must be between 0 and %lu", UPF_ACCEL_MAX_PDR_NUM_RATE_METERS);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	cfg->max_pdr_qers = n;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Callback to handle the session control socket path
+ *
+ * @param [in]: socket path
+ * @config [in]: UPF Acceleration configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t session_ctrl_path_callback(void *param, void *config)
+{
+	struct upf_accel_config *cfg = (struct upf_accel_config *)config;
+	const char *n = (const char *)param;
+
+	cfg->session_ctrl_path = n;
+
+	return DOCA_SUCCESS;
+}
+
 /*
  * Callback to handle UL port number in fixed port mode
  *
@@ -1429,7 +1855,11 @@ static doca_error_t upf_accel_register_params(void)
 	struct doca_argp_param *vxlan_file_path_param;
 	struct doca_argp_param *aging_time_sec_param;
 	struct doca_argp_param *pkts_before_accel_param;
+	struct doca_argp_param *accel_budget_param;
+	struct doca_argp_param *meter_check_param;
+	struct doca_argp_param *max_pdr_qers_param;
 	struct doca_argp_param *fixed_port_param;
+	struct doca_argp_param *session_ctrl_path_param;
 	doca_error_t result;
 
 	/* Create and register UPF Acceleration JSON PDR definitions file path */
@@ -1503,6 +1933,63 @@ static doca_error_t upf_accel_register_params(void)
 		return result;
 	}
 
+	/* Create and register UPF Acceleration flow insertions budget */
+	result = doca_argp_param_create(&accel_budget_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(accel_budget_param, "b");
+	doca_argp_param_set_long_name(accel_budget_param, "accel-budget");
+	doca_argp_param_set_description(
+		accel_budget_param,
+		"Max flow insertions per second per core, only the top byte rate flows are accelerated within it (0 - unlimited, default)");
+	doca_argp_param_set_callback(accel_budget_param, accel_budget_callback);
+	doca_argp_param_set_type(accel_budget_param, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(accel_budget_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register UPF Acceleration QER meters check */
+	result = doca_argp_param_create(&meter_check_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(meter_check_param, "mc");
+	doca_argp_param_set_long_name(meter_check_param, "meter-check");
+	doca_argp_param_set_description(
+		meter_check_param,
+		"Check that mixed HW and SW forwarded traffic keeps within the QER MBR, then exit");
+	doca_argp_param_set_callback(meter_check_param, meter_check_callback);
+	doca_argp_param_set_type(meter_check_param, DOCA_ARGP_TYPE_BOOLEAN);
+	result = doca_argp_register_param(meter_check_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
+	/* Create and register UPF Acceleration max number of QERs of a PDR */
+	result = doca_argp_param_create(&max_pdr_qers_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(max_pdr_qers_param, "q");
+	doca_argp_param_set_long_name(max_pdr_qers_param, "max-pdr-qers");
+	doca_argp_param_set_description(
+		max_pdr_qers_param,
+		"Max number of QERs of a PDR, including the PDRs of sessions added at runtime (default 4)");
+	doca_argp_param_set_callback(max_pdr_qers_param, max_pdr_qers_callback);
+	doca_argp_param_set_type(max_pdr_qers_param, DOCA_ARGP_TYPE_INT);
+	result = doca_argp_register_param(max_pdr_qers_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	/* Create and register UPF Acceleration Number of packets before accelerating */
 	result = doca_argp_param_create(&fixed_port_param);
 	if (result != DOCA_SUCCESS) {
@@ -1520,6 +2007,25 @@ static doca_error_t upf_accel_register_params(void)
 		return result;
 	}
 
+	/* Create and register UPF Acceleration session control socket path */
+	result = doca_argp_param_create(&session_ctrl_path_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to create ARGP param: %s", doca_error_get_descr(result));
+		return result;
+	}
+	doca_argp_param_set_short_name(session_ctrl_path_param, "s");
+	doca_argp_param_set_long_name(session_ctrl_path_param, "session-ctrl-path");
+	doca_argp_param_set_description(
+		session_ctrl_path_param,
+		"UNIX socket path to receive session establishment/modification/deletion messages on (disabled by default)");
+	doca_argp_param_set_callback(session_ctrl_path_param, session_ctrl_path_callback);
+	doca_argp_param_set_type(session_ctrl_path_param, DOCA_ARGP_TYPE_STRING);
+	result = doca_argp_register_param(session_ctrl_path_param);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to register program param: %s", doca_error_get_descr(result));
+		return result;
+	}
+
 	return DOCA_SUCCESS;
 }
 
@@ -1536,6 +2042,29 @@ static doca_error_t upf_accel_dpdk_config_num_ports(struct application_dpdk_conf
 	return DOCA_SUCCESS;
 }
 
+/*
+ * Check that the PDRs of the SMF configuration file fit the TX meter chain
+ *
+ * @cfg [in]: UPF Acceleration configuration
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t upf_accel_pdrs_qers_check(const struct upf_accel_config *cfg)
+{
+	size_t i;
+
+	for (i = 0; i < cfg->pdrs->num_pdrs; i++) {
+		if (cfg->pdrs->arr_pdrs[i].qerids_num > cfg->max_pdr_qers) {
+			DOCA_LOG_ERR("PDR %u has %u QERs, max-pdr-qers is %u",
+				     cfg->pdrs->arr_pdrs[i].id,
+				     cfg->pdrs->arr_pdrs[i].qerids_num,
+				     cfg->max_pdr_qers);
+			return DOCA_ERROR_INVALID_VALUE;
+		}
+	}
+
+	return DOCA_SUCCESS;
+}
+
 /*
  * UPF Acceleration main function
  *
@@ -1552,6 +2081,8 @@ int main(int argc, char **argv)
 		.hw_aging_time_sec = UPF_ACCEL_HW_AGING_TIME_DEFAULT_SEC,
 		.sw_aging_time_sec = UPF_ACCEL_SW_AGING_TIME_DEFAULT_SEC,
 		.dpi_threshold = UPF_ACCEL_DEFAULT_DPI_THRESHOLD,
+		.accel_budget = UPF_ACCEL_ACCEL_BUDGET_NONE,
+		.max_pdr_qers = UPF_ACCEL_MAX_PDR_NUM_RATE_METERS,
 		.fixed_port = UPF_ACCEL_FIXED_PORT_NONE,
 	};
 	struct application_dpdk_config dpdk_config = {
@@ -1597,6 +2128,13 @@ int main(int argc, char **argv)
 		goto argp_cleanup;
 	}
 
+	if (upf_accel_cfg.meter_check) {
+		result = upf_accel_sw_meters_check();
+		if (result == DOCA_SUCCESS)
+			exit_status = EXIT_SUCCESS;
+		goto dpdk_cleanup;
+	}
+
 	result = upf_accel_dpdk_config_num_ports(&dpdk_config);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to configure num ports");
@@ -1619,6 +2157,10 @@ int main(int argc, char **argv)
 	if (result != DOCA_SUCCESS)
 		goto dpdk_ports_queues_cleanup;
 
+	result = upf_accel_pdrs_qers_check(&upf_accel_cfg);
+	if (result != DOCA_SUCCESS)
+		goto dpdk_smf_cleanup;
+
 	if (upf_accel_cfg.vxlan_config_file_path) {
 		result = upf_accel_vxlan_parse(&upf_accel_cfg);
 		if (result != DOCA_SUCCESS)
@@ -1627,7 +2169,9 @@ int main(int argc, char **argv)
 
 	upf_accel_ctx.num_ports = dpdk_config.port_config.nb_ports;
 	upf_accel_ctx.num_queues = dpdk_config.port_config.nb_queues;
-	upf_accel_ctx.resource.nr_counters = UPF_ACCEL_MAX_NUM_CONNECTIONS;
+	/* Connections and the HW meter entries, whose counters debit the SW meters */
+	upf_accel_ctx.resource.nr_counters = UPF_ACCEL_MAX_NUM_CONNECTIONS +
+					     UPF_ACCEL_MAX_NUM_PDR * UPF_ACCEL_MAX_PDR_NUM_RATE_METERS;
 	upf_accel_ctx.num_shared_resources[DOCA_FLOW_SHARED_RESOURCE_METER] =
 		upf_accel_calc_num_shared_meters(upf_accel_ctx.num_ports);
 	upf_accel_ctx.num_shared_resources[DOCA_FLOW_SHARED_RESOURCE_COUNTER] =
@@ -30,6 +30,8 @@
 
 #include <rte_malloc.h>
 #include <rte_hash.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_spinlock.h>
 
 #include <doca_flow.h>
 #include <doca_flow_net.h>
@@ -90,6 +92,17 @@ enum upf_accel_port {
 
 #define UPF_ACCEL_FIXED_PORT_NONE (-1)
 
+/* No limit on the rate of flow insertions, every flow crossing the DPI threshold is accelerated */
+#define UPF_ACCEL_ACCEL_BUDGET_NONE (0)
+/* Number of flows tracked by the per core heavy hitters summary */
+#define UPF_ACCEL_HH_TOP_K (64)
+/* Period in which the heavy hitters byte counts are halved, turning them into a byte rate estimation */
+#define UPF_ACCEL_HH_EPOCH_MS (100)
+/* Backoff before the first retry of a failed acceleration, doubled on every consecutive failure */
+#define UPF_ACCEL_ACCEL_RETRY_BASE_MS (10)
+/* Maximal number of backoff doublings (10ms << 7 = 1.28s) */
+#define UPF_ACCEL_ACCEL_RETRY_MAX_SHIFT (7)
+
 #define UNUSED(x) ((void)(x))
 
 extern volatile bool force_quit;
@@ -97,6 +110,8 @@ extern volatile bool force_quit;
 typedef enum upf_accel_port (*upf_accel_get_forwarding_port)(enum upf_accel_port port_id);
 
 struct upf_accel_fp_data;
+struct upf_accel_session_ctrl;
+struct json_object;
 
 enum upf_accel_pdr_pdi_si {
 	/* Only those two types are supported */
@@ -187,6 +202,8 @@ struct upf_accel_ip_port_range {
 };
 
 struct upf_accel_pdr {
+	bool active;						/* PDR is installed, false for a free slot */
+	uint64_t seid;						/* ID of the session the PDR belongs to */
 	uint32_t id;						/* PDR ID */
 	uint32_t farid;						/* FAR ID */
 	uint32_t urrids_num;					/* Number of URR IDs */
@@ -206,13 +223,20 @@ struct upf_accel_pdr {
 	struct upf_accel_ip_port_range pdi_sdf_to_port_range;	/* PDI's SDF to port range */
 };
 
+/*
+ * PDRs keep their position in the array for their whole life, since it is used to index their HW resources (shared
+ * counters, meters and SMF entries). The array always has room for UPF_ACCEL_MAX_NUM_PDR PDRs, removed PDRs leave
+ * an inactive slot behind.
+ */
 struct upf_accel_pdrs {
-	size_t num_pdrs;		 /* Number of PDRs */
+	size_t num_pdrs;		 /* Number of used slots, active or not */
 	struct upf_accel_pdr arr_pdrs[]; /* PDRs array */
 };
 
 struct upf_accel_far {
 	uint32_t id;			   /* FAR ID */
+	uint32_t refcnt;		   /* Number of installed PDRs referencing the FAR */
+	uint64_t seid;			   /* ID of the session that created the FAR */
 	struct upf_accel_ip_addr fp_oh_ip; /* Forwardind policy outer header creation IP */
 	uint32_t fp_oh_teid;		   /* Forwarding policy outer header creation teid */
 };
@@ -224,6 +248,8 @@ struct upf_accel_fars {
 
 struct upf_accel_urr {
 	uint32_t id;			    /* URR ID */
+	uint32_t refcnt;		    /* Number of installed PDRs referencing the URR */
+	uint64_t seid;			    /* ID of the session that created the URR */
 	uint64_t volume_quota_total_volume; /* Volume quota total volume */
 };
 
@@ -234,6 +260,8 @@ struct upf_accel_urrs {
 
 struct upf_accel_qer {
 	uint32_t id;	     /* QER ID */
+	uint32_t refcnt;     /* Number of installed PDRs referencing the QER */
+	uint64_t seid;	     /* ID of the session that created the QER */
 	uint8_t qfi;	     /* QFI */
 	uint64_t mbr_dl_mbr; /* MBR downlink */
 	uint64_t mbr_ul_mbr; /* MBR uplink */
@@ -255,6 +283,17 @@ struct upf_accel_vxlans {
 	struct upf_accel_vxlan arr_vxlans[]; /* VXLANs array */
 };
 
+/*
+ * SMF rules published to the workers. A snapshot is never modified once published, the session control publishes a
+ * new one instead and frees the old one after an RCU grace period.
+ */
+struct upf_accel_rules {
+	struct upf_accel_pdrs *pdrs; /* PDRs */
+	struct upf_accel_fars *fars; /* FARs */
+	struct upf_accel_urrs *urrs; /* URRs */
+	struct upf_accel_qers *qers; /* QERs */
+};
+
 struct upf_accel_config {
 	const char *smf_config_file_path;   /* Path to SMF configuration file */
 	struct upf_accel_pdrs *pdrs;	    /* PDRs */
@@ -266,7 +305,11 @@ struct upf_accel_config {
 	uint32_t hw_aging_time_sec;	    /* Amount of seconds before deleting an accelerated flow */
 	uint32_t sw_aging_time_sec;	    /* Amount of seconds before deleting an unaccelerated flow */
 	uint32_t dpi_threshold;		    /* Number of packets handled in SW before deciding to accelerate */
+	uint32_t accel_budget;		    /* Max flow insertions per second per core, 0 for unlimited */
+	uint32_t max_pdr_qers;		    /* Max number of QERs of a PDR, sizes the TX meter chain */
+	const char *session_ctrl_path;	    /* Path of the session control UNIX socket, NULL if disabled */
 	uint32_t fixed_port;		    /* UL port number in fixed port mode */
+	bool meter_check;		    /* Run the QER meters MBR compliance check instead of the datapath */
 };
 
 struct upf_accel_match_tun {
@@ -317,11 +360,29 @@ struct upf_accel_dyn_entry_ctx {
 	} entries[PARSER_PKT_TYPE_NUM];	      /* Pipe entries (accelerated) / Linked list entries (unaccelerated) */
 	struct upf_accel_fp_data *fp_data;    /* Pointer to the data of the handling core */
 	uint32_t pdr_id[PARSER_PKT_TYPE_NUM]; /* PDR ID */
+	uint32_t pdr_idx[PARSER_PKT_TYPE_NUM]; /* PDR index in the PDRs array */
+	uint64_t accel_retry_tsc[PARSER_PKT_TYPE_NUM]; /* Earliest timestamp to retry a failed acceleration */
+	uint8_t accel_retries[PARSER_PKT_TYPE_NUM];    /* Number of consecutive failed accelerations */
+	uint8_t hh_slot[PARSER_PKT_TYPE_NUM];	       /* Last known slot in the heavy hitters summary */
 	int32_t conn_idx;		      /* Position of the connection in the hash table */
 	hash_sig_t hash;		      /* RTE hash (aka signature) */
 	enum upf_accel_flow_status flow_status[PARSER_PKT_TYPE_NUM]; /* Status of an accelerated flow */
 };
 
+struct upf_accel_sw_meter {
+	rte_spinlock_t lock;	/* Meter lock, a meter is shared by all the cores */
+	uint64_t cir;		/* Committed information rate, bytes per second */
+	uint64_t cbs;		/* Committed burst size, bytes */
+	uint64_t tokens;	/* Currently available tokens, bytes */
+	uint64_t last_tsc;	/* Timestamp of the last tokens update */
+	uint64_t hw_bytes;	/* Bytes last read from the counter of the HW meter entry */
+	uint64_t hw_debt;	/* Bytes passed by the HW meter beyond the available tokens, paid by refills */
+	uint64_t conform_pkts;	/* Packets that conformed to the meter (green) */
+	uint64_t conform_bytes; /* Bytes that conformed to the meter (green) */
+	uint64_t exceed_pkts;	/* Packets that exceeded the meter (red) */
+	uint64_t exceed_bytes;	/* Bytes that exceeded the meter (red) */
+} __rte_aligned(RTE_CACHE_LINE_SIZE);
+
 struct upf_accel_static_entry_ctx {
 	struct entries_status ctrl_status; /* Control status */
 };
@@ -339,7 +400,7 @@ struct upf_accel_ctx {
 	uint16_t num_queues;						       /* Number of device queues */
 	struct flow_resources resource;					       /* Flow resources */
 	uint32_t num_shared_resources[SHARED_RESOURCE_NUM_VALUES];	       /* Number of shared resources */
-	const struct upf_accel_config *upf_accel_cfg;			       /* UPF Acceleration configuration */
+	struct upf_accel_config *upf_accel_cfg;				       /* UPF Acceleration configuration */
 	struct doca_flow_pipe *pipes[UPF_ACCEL_PORTS_MAX][UPF_ACCEL_PIPE_NUM]; /* Pipes */
 	struct doca_flow_port *ports[UPF_ACCEL_PORTS_MAX];		       /* Ports */
 	struct doca_dev *dev_arr[UPF_ACCEL_PORTS_MAX];			       /* Devices array */
@@ -349,6 +410,15 @@ struct upf_accel_ctx {
 	struct upf_accel_entry_ctx static_entry_ctx[UPF_ACCEL_PORTS_MAX]; /* Static entries contexs */
 	uint32_t num_static_entries[UPF_ACCEL_PORTS_MAX];		  /* Number of static entries */
 	upf_accel_get_forwarding_port get_fwd_port;			  /* Function pointer to get fwd port */
+	struct upf_accel_sw_meter *sw_meters; /* SW meters of not accelerated flows, laid out as the shared meters */
+	struct doca_flow_pipe_entry *meter_entries[UPF_ACCEL_MAX_NUM_PDR][UPF_ACCEL_MAX_PDR_NUM_RATE_METERS]
+						  [UPF_ACCEL_PORTS_MAX]; /* Resulting hw shared meters entries */
+	uint32_t meter_chain_len;			 /* Number of meters pipes in the TX meter chain */
+	struct rte_rcu_qsbr *qsv;			 /* QSBR variable of the workers reading the SMF rules */
+	struct upf_accel_rules *rules;			 /* SMF rules published to the workers */
+	uint64_t pdrs_gen;				 /* Generation of the last PDRs invalidation */
+	uint64_t pdrs_invalidate_gen[UPF_ACCEL_MAX_NUM_PDR]; /* Generation in which each PDR slot was invalidated */
+	struct upf_accel_session_ctrl *session_ctrl;	     /* Session control, NULL if disabled */
 };
 
 struct upf_accel_action_cfg {
@@ -383,6 +453,55 @@ struct upf_accel_entry_cfg {
 	uint32_t entry_idx;		   /* Entry index */
 };
 
+/*
+ * Get the offset of a meter.
+ *
+ * Meters are organized as follows:
+ *
+ *         --       --
+ *         |        | Meter[0]
+ *         |        | Meter[1]
+ *         | PDR[0]- ...
+ *         |        |
+ *         |        | Meter[UPF_ACCEL_MAX_PDR_NUM_RATE_METERS - 1]
+ * Port[0]-         --
+ *         |        | Meter[UPF_ACCEL_MAX_PDR_NUM_RATE_METERS]
+ *         |        | Meter[UPF_ACCEL_MAX_PDR_NUM_RATE_METERS +1]
+ *         | PDR[1] - ...
+ *         |        |
+ *         |        |
+ *         --       -
+ *...
+ *
+ * @port_id [in]: port ID .
+ * @pdr_idx [in]: PDR index.
+ * @meter_idx [in]: meter index.
+ * @return: offset in meter table.
+ */
+static inline uint32_t upf_accel_shared_meters_table_offset_get(enum upf_accel_port port_id,
+								uint32_t pdr_idx,
+								uint32_t meter_idx)
+{
+	const uint32_t num_meters_per_port = UPF_ACCEL_MAX_PDR_NUM_RATE_METERS * UPF_ACCEL_MAX_NUM_PDR;
+
+	return (port_id * num_meters_per_port) + UPF_ACCEL_MAX_PDR_NUM_RATE_METERS * pdr_idx + meter_idx;
+}
+
+/*
+ * Get the currently published SMF rules
+ *
+ * The rules may be replaced at runtime by the session control, all of them at once. Workers must take the rules
+ * they use together from the same snapshot and must not keep it across their RCU quiescent state reports. The
+ * control thread uses the rules of the configuration instead.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @return: published rules
+ */
+static inline const struct upf_accel_rules *upf_accel_rules_get(const struct upf_accel_ctx *upf_accel_ctx)
+{
+	return __atomic_load_n(&upf_accel_ctx->rules, __ATOMIC_ACQUIRE);
+}
+
 /*
  * Calculate index of a given drop pipe
  *
@@ -439,6 +558,19 @@ doca_error_t upf_accel_smf_parse(struct upf_accel_config *cfg);
  */
 doca_error_t upf_accel_vxlan_parse(struct upf_accel_config *cfg);
 
+/*
+ * Parse the SMF rules of a session control message
+ *
+ * Each of the "<prefix>Pdr", "<prefix>Far", "<prefix>Urr" and "<prefix>Qer" arrays is optional, the rules of a
+ * missing array are left NULL.
+ *
+ * @root [in]: message JSON object
+ * @prefix [in]: prefix of the arrays names, e.g. "create" or "update"
+ * @cfg [out]: the parsed rules, must be released with upf_accel_smf_cleanup()
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t upf_accel_smf_msg_parse(struct json_object *root, const char *prefix, struct upf_accel_config *cfg);
+
 /*
  * Cleans SMF configuration logic
  *
@@ -461,4 +593,47 @@ void upf_accel_vxlan_cleanup(struct upf_accel_config *cfg);
  */
 void upf_accel_sw_aging_ll_init(struct upf_accel_fp_data *fp_data, enum parser_pkt_type pkt_type);
 
+/*
+ * Add the static HW rules (TX counter, encap and shared meters) of a PDR
+ *
+ * Entries are added on queue 0 and must be processed by upf_accel_static_entries_process(). The PDR is taken from the
+ * rules of the configuration.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @pdr_idx [in]: index of the PDR in the PDRs array
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t upf_accel_pdr_rules_add(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx);
+
+/*
+ * Remove the static HW rules of a PDR
+ *
+ * Entries are removed on queue 0 and must be processed by upf_accel_static_entries_process(). Entries that weren't
+ * added are skipped.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @pdr_idx [in]: index of the PDR in the PDRs array
+ * @num_qers [in]: number of QERs the PDR had when its rules were added
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t upf_accel_pdr_rules_remove(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx, uint32_t num_qers);
+
+/*
+ * Apply the current QER rates of a PDR to its HW shared meters and SW meters
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @pdr_idx [in]: index of the PDR in the PDRs array
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t upf_accel_pdr_meters_update(struct upf_accel_ctx *upf_accel_ctx, uint32_t pdr_idx);
+
+/*
+ * Process the static entries pending on queue 0 of every port
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @num_entries [in]: number of entries pending on each port, 0 to process whatever is pending
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t upf_accel_static_entries_process(struct upf_accel_ctx *upf_accel_ctx, uint32_t num_entries);
+
 #endif /* UPF_ACCEL_H_ */
@@ -44,6 +44,18 @@
 #define UPF_ACCEL_MAX_NUM_AGING (UPF_ACCEL_MAX_PKT_BURST * 2)
 /* Maximum timeout for DOCA Flow handling and processing functions. 0 for no limit */
 #define UPF_ACCEL_DOCA_FLOW_MAX_TIMEOUT_US (0)
+/* SW meters check simulated clock, ticking in microseconds */
+#define UPF_ACCEL_METER_CHECK_TSC_HZ (1000000)
+/* SW meters check QER MBR in bytes per second (10 Mbps) */
+#define UPF_ACCEL_METER_CHECK_RATE (1250000)
+/* SW meters check duration of each offered loads phase */
+#define UPF_ACCEL_METER_CHECK_PHASE_US (6000000)
+/* SW meters check interval between packet bursts */
+#define UPF_ACCEL_METER_CHECK_STEP_US (100)
+/* SW meters check interval between HW counters reads, the session control poll period */
+#define UPF_ACCEL_METER_CHECK_SYNC_US (10000)
+/* SW meters check packet length */
+#define UPF_ACCEL_METER_CHECK_PKT_LEN (1000)
 
 struct upf_accel_fp_burst_ctx {
 	struct rte_mbuf *rx_pkts[UPF_ACCEL_MAX_PKT_BURST];	     /* Rx packet burst */
@@ -55,10 +67,12 @@ struct upf_accel_fp_burst_ctx {
 	uint16_t rx_pkts_cnt;					     /* Rx packet burst count */
 	uint16_t tx_pkts_cnt;					     /* Tx packet burst count */
 	bool pkts_drop[UPF_ACCEL_MAX_PKT_BURST];		     /* Packet processing drop indicator */
+	bool pkts_exceed[UPF_ACCEL_MAX_PKT_BURST];		     /* Packet exceeded its QER rate indicator */
 } __rte_aligned(RTE_CACHE_LINE_SIZE);
 
 static_assert(UPF_ACCEL_MAX_PKT_BURST <= RTE_HASH_LOOKUP_BULK_MAX,
 	      "Can't process a burst larger than RTE bulk size limit");
+static_assert(UPF_ACCEL_HH_TOP_K <= UINT8_MAX, "Heavy hitters slot index doesn't fit the connection context");
 
 DOCA_LOG_REGISTER(UPF_ACCEL::FLOW_PROCESSING);
 
@@ -73,6 +87,29 @@ static enum parser_pkt_type upf_accel_fp_get_opposite_pkt_type(enum parser_pkt_t
 	return (pkt_type == PARSER_PKT_TYPE_TUNNELED) ? PARSER_PKT_TYPE_PLAIN : PARSER_PKT_TYPE_TUNNELED;
 }
 
+/*
+ * Stop tracking a flow in the heavy hitters summary
+ *
+ * The slot is freed so it would be the first one replaced by a new flow.
+ *
+ * @hh [in]: heavy hitters summary
+ * @dyn_ctx [in]: dynamic entry context
+ * @pkt_type [in]: packet type
+ */
+static void upf_accel_hh_forget(struct upf_accel_hh_summary *hh,
+				struct upf_accel_dyn_entry_ctx *dyn_ctx,
+				enum parser_pkt_type pkt_type)
+{
+	struct upf_accel_hh_slot *slot = &hh->slots[dyn_ctx->hh_slot[pkt_type]];
+
+	if (slot->conn_idx != dyn_ctx->conn_idx || slot->pkt_type != pkt_type)
+		return;
+
+	slot->conn_idx = UPF_ACCEL_SW_AGING_LL_INVALID_NODE;
+	slot->bytes = 0;
+	slot->err = 0;
+}
+
 /*
  * Delete flow
  *
@@ -94,6 +131,7 @@ static doca_error_t upf_accel_fp_delete_flow(struct upf_accel_fp_data *fp_data,
 			   dyn_ctx->entries[opposite_dir_type].status == DOCA_FLOW_ENTRY_STATUS_ERROR);
 
 	dyn_ctx->flow_status[pkt_type] = UPF_ACCEL_FLOW_STATUS_NONE;
+	upf_accel_hh_forget(&fp_data->hh, dyn_ctx, pkt_type);
 
 	if (!last_entry)
 		return DOCA_SUCCESS;
@@ -630,7 +668,7 @@ static const struct upf_accel_pdr *upf_accel_ran_pdr_lookup(const struct upf_acc
 
 	for (i = 0; i < pdrs->num_pdrs; i++) {
 		pdr = &pdrs->arr_pdrs[i];
-		if (pdr->pdi_si != UPF_ACCEL_PDR_PDI_SI_UL)
+		if (!pdr->active || pdr->pdi_si != UPF_ACCEL_PDR_PDI_SI_UL)
 			continue;
 
 		if (!upf_accel_pdr_tunnel_is_matching(pdr, &match->outer))
@@ -679,7 +717,7 @@ static const struct upf_accel_pdr *upf_accel_wan_pdr_lookup(const struct upf_acc
 
 	for (i = 0; i < pdrs->num_pdrs; i++) {
 		pdr = &pdrs->arr_pdrs[i];
-		if (pdr->pdi_si != UPF_ACCEL_PDR_PDI_SI_DL)
+		if (!pdr->active || pdr->pdi_si != UPF_ACCEL_PDR_PDI_SI_DL)
 			continue;
 
 		if (!upf_accel_pdr_tuple_is_matching(pdr, match))
@@ -907,23 +945,26 @@ static bool upf_accel_fp_tunnel_eq(struct upf_accel_match_tun *tunnel1, struct u
  * @pkt_type [in]: packet type
  * @match [in]: software flow match
  * @pdr_out [out]: pdr
+ * @pdr_idx_out [out]: index of the pdr in the PDRs array
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
 static doca_error_t upf_accel_fp_pdr_lookup(struct upf_accel_fp_data *fp_data,
 					    enum parser_pkt_type pkt_type,
 					    struct upf_accel_match_8t *match,
-					    const struct upf_accel_pdr **pdr_out)
+					    const struct upf_accel_pdr **pdr_out,
+					    uint32_t *pdr_idx_out)
 {
+	const struct upf_accel_pdrs *pdrs = upf_accel_rules_get(fp_data->ctx)->pdrs;
 	const struct upf_accel_pdr *pdr;
 
-	pdr = pkt_type == PARSER_PKT_TYPE_TUNNELED ?
-		      upf_accel_ran_pdr_lookup(fp_data->ctx->upf_accel_cfg->pdrs, match) :
-		      upf_accel_wan_pdr_lookup(fp_data->ctx->upf_accel_cfg->pdrs, &match->inner);
+	pdr = pkt_type == PARSER_PKT_TYPE_TUNNELED ? upf_accel_ran_pdr_lookup(pdrs, match) :
+						     upf_accel_wan_pdr_lookup(pdrs, &match->inner);
 	if (!pdr) {
 		DOCA_LOG_DBG("Failed to lookup PDR for packet type %u", pkt_type);
 		return DOCA_ERROR_NOT_FOUND;
 	}
 	*pdr_out = pdr;
+	*pdr_idx_out = pdr - pdrs->arr_pdrs;
 
 	return DOCA_SUCCESS;
 }
@@ -947,10 +988,11 @@ static doca_error_t upf_accel_fp_conn_lookup(struct upf_accel_fp_data *fp_data,
 	struct upf_accel_entry_ctx *conn;
 	const struct upf_accel_pdr *pdr;
 	doca_error_t result;
+	uint32_t pdr_idx;
 	hash_sig_t hash;
 
 	if (conn_idx < 0) {
-		result = upf_accel_fp_pdr_lookup(fp_data, pkt_type, match, &pdr);
+		result = upf_accel_fp_pdr_lookup(fp_data, pkt_type, match, &pdr, &pdr_idx);
 		if (result != DOCA_SUCCESS)
 			return result;
 
@@ -967,6 +1009,7 @@ static doca_error_t upf_accel_fp_conn_lookup(struct upf_accel_fp_data *fp_data,
 		conn->dyn_ctx.match = *match;
 		conn->dyn_ctx.hash = hash;
 		conn->dyn_ctx.pdr_id[pkt_type] = pdr->id;
+		conn->dyn_ctx.pdr_idx[pkt_type] = pdr_idx;
 		conn->dyn_ctx.fp_data = fp_data;
 		conn->dyn_ctx.conn_idx = conn_idx;
 		conn->dyn_ctx.flow_status[pkt_type] = UPF_ACCEL_FLOW_STATUS_PENDING;
@@ -990,12 +1033,14 @@ static doca_error_t upf_accel_fp_conn_lookup(struct upf_accel_fp_data *fp_data,
 		 * initialization for the other type.
 		 */
 		if (conn->dyn_ctx.flow_status[pkt_type] == UPF_ACCEL_FLOW_STATUS_NONE) {
-			result = upf_accel_fp_pdr_lookup(fp_data, pkt_type, match, &pdr);
+			result = upf_accel_fp_pdr_lookup(fp_data, pkt_type, match, &pdr, &pdr_idx);
 			if (result != DOCA_SUCCESS)
 				return result;
 
 			conn->dyn_ctx.flow_status[pkt_type] = UPF_ACCEL_FLOW_STATUS_PENDING;
 			conn->dyn_ctx.pdr_id[pkt_type] = pdr->id;
+			conn->dyn_ctx.pdr_idx[pkt_type] = pdr_idx;
+			conn->dyn_ctx.accel_retries[pkt_type] = 0;
 			upf_accel_sw_aging_ll_node_init(conn, pkt_type);
 		}
 	}
@@ -1041,9 +1086,152 @@ static void upf_accel_fp_conns_lookup(struct upf_accel_fp_data *fp_data, struct
 	}
 }
 
+/*
+ * Account a SW handled packet in the heavy hitters summary
+ *
+ * @hh [in]: heavy hitters summary
+ * @conn [in]: connection descriptor
+ * @pkt_type [in]: packet type
+ * @len [in]: packet length
+ */
+static void upf_accel_hh_update(struct upf_accel_hh_summary *hh,
+				struct upf_accel_entry_ctx *conn,
+				enum parser_pkt_type pkt_type,
+				uint32_t len)
+{
+	struct upf_accel_hh_slot *slot = &hh->slots[conn->dyn_ctx.hh_slot[pkt_type]];
+	uint8_t min_idx = 0;
+	uint8_t i;
+
+	if (slot->conn_idx == conn->dyn_ctx.conn_idx && slot->pkt_type == pkt_type) {
+		slot->bytes += len;
+		return;
+	}
+
+	for (i = 1; i < UPF_ACCEL_HH_TOP_K; i++)
+		if (hh->slots[i].bytes < hh->slots[min_idx].bytes)
+			min_idx = i;
+
+	slot = &hh->slots[min_idx];
+	slot->conn_idx = conn->dyn_ctx.conn_idx;
+	slot->pkt_type = pkt_type;
+	slot->err = slot->bytes;
+	slot->bytes += len;
+	conn->dyn_ctx.hh_slot[pkt_type] = min_idx;
+}
+
+/*
+ * Halve the heavy hitters counts once per epoch, so they follow the recent byte rate
+ *
+ * @hh [in]: heavy hitters summary
+ */
+static void upf_accel_hh_decay(struct upf_accel_hh_summary *hh)
+{
+	uint64_t epoch_tsc = rte_get_tsc_hz() * UPF_ACCEL_HH_EPOCH_MS / 1000;
+	uint64_t tsc = rte_rdtsc();
+	uint8_t i;
+
+	if (tsc - hh->epoch_tsc < epoch_tsc)
+		return;
+
+	for (i = 0; i < UPF_ACCEL_HH_TOP_K; i++) {
+		hh->slots[i].bytes >>= 1;
+		hh->slots[i].err >>= 1;
+	}
+	hh->epoch_tsc = tsc;
+}
+
+/*
+ * Get the lowest count of the flows tracked by the heavy hitters summary
+ *
+ * Freed slots are skipped, they don't stand for any flow and would otherwise turn every tracked flow into a heavy
+ * hitter.
+ *
+ * @hh [in]: heavy hitters summary
+ * @return: lowest count of the occupied slots, 0 if the summary is empty
+ */
+static uint64_t upf_accel_hh_floor(const struct upf_accel_hh_summary *hh)
+{
+	uint64_t min_bytes = UINT64_MAX;
+	uint8_t i;
+
+	for (i = 0; i < UPF_ACCEL_HH_TOP_K; i++) {
+		if (hh->slots[i].conn_idx == UPF_ACCEL_SW_AGING_LL_INVALID_NODE)
+			continue;
+		min_bytes = RTE_MIN(min_bytes, hh->slots[i].bytes);
+	}
+
+	return min_bytes == UINT64_MAX ? 0 : min_bytes;
+}
+
+/*
+ * Check if a flow is guaranteed to be one of the top-K SW flows by byte rate
+ *
+ * @hh [in]: heavy hitters summary
+ * @conn [in]: connection descriptor
+ * @pkt_type [in]: packet type
+ * @return: true if the flow is a heavy hitter, false otherwise
+ */
+static bool upf_accel_hh_is_heavy(struct upf_accel_hh_summary *hh,
+				  struct upf_accel_entry_ctx *conn,
+				  enum parser_pkt_type pkt_type)
+{
+	struct upf_accel_hh_slot *slot = &hh->slots[conn->dyn_ctx.hh_slot[pkt_type]];
+
+	if (slot->conn_idx != conn->dyn_ctx.conn_idx || slot->pkt_type != pkt_type)
+		return false;
+
+	return slot->bytes - slot->err >= upf_accel_hh_floor(hh);
+}
+
+/*
+ * Consume one flow insertion from the core insertions budget
+ *
+ * @fp_data [in]: flow processing data
+ * @return: true if the insertion is allowed, false if the budget is exhausted
+ */
+static bool upf_accel_accel_budget_take(struct upf_accel_fp_data *fp_data)
+{
+	struct upf_accel_accel_budget *budget = &fp_data->accel_budget;
+	uint32_t rate = fp_data->ctx->upf_accel_cfg->accel_budget;
+	uint64_t tsc = rte_rdtsc();
+	double burst;
+
+	burst = RTE_MAX((double)rate * UPF_ACCEL_HH_EPOCH_MS / 1000, 1.0);
+	budget->tokens += (double)(tsc - budget->last_tsc) * rate / rte_get_tsc_hz();
+	budget->tokens = RTE_MIN(budget->tokens, burst);
+	budget->last_tsc = tsc;
+
+	if (budget->tokens < 1.0)
+		return false;
+
+	budget->tokens -= 1.0;
+	return true;
+}
+
+/*
+ * Schedule the next retry of a failed acceleration with an exponential backoff
+ *
+ * @conn [in]: connection descriptor
+ * @pkt_type [in]: packet type
+ */
+static void upf_accel_accel_retry_backoff(struct upf_accel_entry_ctx *conn, enum parser_pkt_type pkt_type)
+{
+	uint8_t shift = RTE_MIN(conn->dyn_ctx.accel_retries[pkt_type], UPF_ACCEL_ACCEL_RETRY_MAX_SHIFT);
+	uint64_t backoff_tsc = (rte_get_tsc_hz() * UPF_ACCEL_ACCEL_RETRY_BASE_MS / 1000) << shift;
+
+	conn->dyn_ctx.accel_retry_tsc[pkt_type] = rte_rdtsc() + backoff_tsc;
+	if (conn->dyn_ctx.accel_retries[pkt_type] < UINT8_MAX)
+		conn->dyn_ctx.accel_retries[pkt_type]++;
+}
+
 /*
  * Accelerate a unidirectional flow on a connection
  *
+ * Flows that failed to be accelerated are retried once their backoff expires.
+ * When an insertion budget is configured, only flows that are heavy hitters are
+ * accelerated and at most at the budget rate, the rest stay in SW.
+ *
  * @fp_data [in]: flow processing data
  * @port_id [in]: port id
  * @pkt_type [in]: packet type
@@ -1057,19 +1245,34 @@ static doca_error_t upf_accel_fp_flow_accel(struct upf_accel_fp_data *fp_data,
 					    struct upf_accel_match_8t *match,
 					    struct upf_accel_entry_ctx *conn)
 {
+	bool retry = conn->dyn_ctx.flow_status[pkt_type] == UPF_ACCEL_FLOW_STATUS_FAILED_ACCELERATION;
 	doca_error_t ret;
 
 	if (conn->dyn_ctx.flow_status[pkt_type] == UPF_ACCEL_FLOW_STATUS_ACCELERATED)
 		return DOCA_ERROR_ALREADY_EXIST;
-	if (unlikely(conn->dyn_ctx.flow_status[pkt_type] == UPF_ACCEL_FLOW_STATUS_FAILED_ACCELERATION))
+	if (unlikely(retry) && rte_rdtsc() < conn->dyn_ctx.accel_retry_tsc[pkt_type])
 		return DOCA_SUCCESS;
 
-	if (upf_accel_flow_is_alive(conn->dyn_ctx.flow_status[pkt_type]) &&
+	if (!retry && upf_accel_flow_is_alive(conn->dyn_ctx.flow_status[pkt_type]) &&
 	    (conn->dyn_ctx.cnt_pkts[pkt_type] + 1) < fp_data->ctx->upf_accel_cfg->dpi_threshold) {
 		conn->dyn_ctx.flow_status[pkt_type] = UPF_ACCEL_FLOW_STATUS_UNACCELERATED;
 		return DOCA_SUCCESS;
 	}
 
+	if (fp_data->ctx->upf_accel_cfg->accel_budget != UPF_ACCEL_ACCEL_BUDGET_NONE) {
+		if (!upf_accel_hh_is_heavy(&fp_data->hh, conn, pkt_type)) {
+			fp_data->policy_counters.deferred_not_heavy++;
+			goto deferred;
+		}
+		if (!upf_accel_accel_budget_take(fp_data)) {
+			fp_data->policy_counters.deferred_budget++;
+			goto deferred;
+		}
+	}
+
+	if (retry)
+		fp_data->policy_counters.retries++;
+
 	ret = pkt_type == PARSER_PKT_TYPE_TUNNELED ? upf_accel_pipe_8t_accel(fp_data->ctx,
 									     port_id,
 									     fp_data->queue_id,
@@ -1086,17 +1289,31 @@ static doca_error_t upf_accel_fp_flow_accel(struct upf_accel_fp_data *fp_data,
 									     &conn->dyn_ctx.entries[pkt_type].entry);
 	switch (ret) {
 	case DOCA_SUCCESS:
+		if (retry) {
+			fp_data->accel_failed_counters[pkt_type].current--;
+			fp_data->policy_counters.retries_succeeded++;
+		}
 		conn->dyn_ctx.flow_status[pkt_type] = UPF_ACCEL_FLOW_STATUS_ACCELERATED;
+		conn->dyn_ctx.accel_retries[pkt_type] = 0;
 		upf_accel_sw_aging_ll_node_remove(fp_data, conn, pkt_type);
+		upf_accel_hh_forget(&fp_data->hh, &conn->dyn_ctx, pkt_type);
 		break;
 	default:
+		if (!retry) {
+			fp_data->accel_failed_counters[pkt_type].current++;
+			fp_data->accel_failed_counters[pkt_type].total++;
+		}
 		conn->dyn_ctx.flow_status[pkt_type] = UPF_ACCEL_FLOW_STATUS_FAILED_ACCELERATION;
-		fp_data->accel_failed_counters[pkt_type].current++;
-		fp_data->accel_failed_counters[pkt_type].total++;
+		upf_accel_accel_retry_backoff(conn, pkt_type);
 		DOCA_LOG_DBG("Failed to accelerate connection on port %u, type %u.", port_id, pkt_type);
 	}
 
 	return DOCA_SUCCESS;
+
+deferred:
+	if (!retry)
+		conn->dyn_ctx.flow_status[pkt_type] = UPF_ACCEL_FLOW_STATUS_UNACCELERATED;
+	return DOCA_SUCCESS;
 }
 
 /*
@@ -1136,6 +1353,10 @@ static void upf_accel_fp_flows_accel(struct upf_accel_fp_data *fp_data,
 		pkt = burst_ctx->rx_pkts[i];
 		pkt_type = burst_ctx->pkts_type[i];
 
+		if (fp_data->ctx->upf_accel_cfg->accel_budget != UPF_ACCEL_ACCEL_BUDGET_NONE &&
+		    conn->dyn_ctx.flow_status[pkt_type] != UPF_ACCEL_FLOW_STATUS_ACCELERATED)
+			upf_accel_hh_update(&fp_data->hh, conn, pkt_type, rte_pktmbuf_pkt_len(pkt));
+
 		ret = upf_accel_fp_flow_accel(fp_data, rx_port_id, pkt_type, burst_ctx->matches[i], conn);
 		if (ret == DOCA_ERROR_ALREADY_EXIST)
 			DOCA_LOG_DBG("Got a sneaker packet on core %u, port %u, type %u.",
@@ -1191,6 +1412,331 @@ static bool is_flow_unaccelerated(enum parser_pkt_type pkt_type, struct upf_acce
 	       (conn->dyn_ctx.flow_status[pkt_type] == UPF_ACCEL_FLOW_STATUS_UNACCELERATED);
 }
 
+/*
+ * Refill the tokens of a SW meter according to the time passed since its last update
+ *
+ * Only whole tokens are credited, and the timestamp advances only by the cycles they account for, so time that didn't
+ * amount to a whole token is kept for the next refill. Once the bucket is full the remaining time is dropped. New
+ * tokens pay the HW debt first.
+ *
+ * @meter [in]: SW meter, locked by the caller
+ * @tsc [in]: current timestamp
+ * @tsc_hz [in]: timestamp frequency
+ */
+static void upf_accel_sw_meter_refill(struct upf_accel_sw_meter *meter, uint64_t tsc, uint64_t tsc_hz)
+{
+	uint64_t new_tokens;
+	uint64_t credit;
+	uint64_t cycles;
+
+	if (tsc <= meter->last_tsc)
+		return;
+
+	new_tokens = (uint64_t)((double)(tsc - meter->last_tsc) * meter->cir / tsc_hz);
+	if (new_tokens == 0)
+		return;
+
+	/* Tokens the HW meter already spent aren't credited again */
+	credit = new_tokens - RTE_MIN(new_tokens, meter->hw_debt);
+	meter->hw_debt -= new_tokens - credit;
+
+	if (credit >= meter->cbs - meter->tokens) {
+		meter->tokens = meter->cbs;
+		meter->last_tsc = tsc;
+		return;
+	}
+
+	/* Cycles the whole tokens took, rounded up so the meter never runs faster than its CIR */
+	cycles = (uint64_t)((double)new_tokens * tsc_hz / meter->cir) + 1;
+	meter->tokens += credit;
+	meter->last_tsc += RTE_MIN(cycles, tsc - meter->last_tsc);
+}
+
+/*
+ * Police a packet by a chain of SW meters
+ *
+ * Follows the semantics of the HW meters chain - a byte limited color blind srTCM (EBS = 0) per QER, each meter
+ * consumes tokens for the packet only if all the meters before it colored the packet green.
+ *
+ * @meters [in]: the PDR SW meters, locked by the caller
+ * @num_meters [in]: number of meters in the chain
+ * @len [in]: packet length in bytes
+ * @return: true if the packet conforms to all the meters, false otherwise
+ */
+static bool upf_accel_sw_meters_chain_police(struct upf_accel_sw_meter *meters, uint32_t num_meters, uint32_t len)
+{
+	struct upf_accel_sw_meter *meter;
+	uint32_t i;
+
+	for (i = 0; i < num_meters; i++) {
+		meter = &meters[i];
+		if (meter->tokens < len) {
+			meter->exceed_pkts++;
+			meter->exceed_bytes += len;
+			return false;
+		}
+
+		meter->tokens -= len;
+		meter->conform_pkts++;
+		meter->conform_bytes += len;
+	}
+
+	return true;
+}
+
+/*
+ * Apply the QER rate limits on the packets of the burst forwarded by SW
+ *
+ * Packets are grouped by PDR, so the meters of each PDR are locked and refilled once per burst. Packets exceeding
+ * any of their PDR meters are marked to be dropped.
+ *
+ * @fp_data [in]: flow processing data
+ * @tx_port_id [in]: port the burst is sent from
+ * @burst_ctx [in]: packet burst context
+ */
+static void upf_accel_fp_burst_police(struct upf_accel_fp_data *fp_data,
+				      enum upf_accel_port tx_port_id,
+				      struct upf_accel_fp_burst_ctx *burst_ctx)
+{
+	const struct upf_accel_pdrs *pdrs = upf_accel_rules_get(fp_data->ctx)->pdrs;
+	uint32_t pkts_pdr_idx[UPF_ACCEL_MAX_PKT_BURST];
+	uint32_t burst_pdrs[UPF_ACCEL_MAX_PKT_BURST];
+	uint64_t pdrs_seen = 0;
+	uint64_t tsc_hz = rte_get_tsc_hz();
+	uint64_t tsc = rte_rdtsc();
+	struct upf_accel_sw_meter *meters;
+	enum parser_pkt_type pkt_type;
+	const struct upf_accel_pdr *pdr;
+	uint16_t num_burst_pdrs = 0;
+	uint32_t pdr_idx;
+	uint16_t i, j;
+	uint32_t k;
+
+	static_assert(UPF_ACCEL_MAX_NUM_PDR <= 64, "PDRs bitmap is too small");
+
+	for (i = 0; i < burst_ctx->rx_pkts_cnt; i++) {
+		if (burst_ctx->pkts_drop[i])
+			continue;
+
+		pkt_type = burst_ctx->pkts_type[i];
+		pdr_idx = burst_ctx->conns[i]->dyn_ctx.pdr_idx[pkt_type];
+		pkts_pdr_idx[i] = pdr_idx;
+		if (!pdrs->arr_pdrs[pdr_idx].qerids_num || (pdrs_seen & (1ull << pdr_idx)))
+			continue;
+
+		pdrs_seen |= 1ull << pdr_idx;
+		burst_pdrs[num_burst_pdrs++] = pdr_idx;
+	}
+
+	for (j = 0; j < num_burst_pdrs; j++) {
+		pdr_idx = burst_pdrs[j];
+		pdr = &pdrs->arr_pdrs[pdr_idx];
+		meters = &fp_data->ctx->sw_meters[upf_accel_shared_meters_table_offset_get(tx_port_id, pdr_idx, 0)];
+
+		for (k = 0; k < pdr->qerids_num; k++) {
+			rte_spinlock_lock(&meters[k].lock);
+			upf_accel_sw_meter_refill(&meters[k], tsc, tsc_hz);
+		}
+
+		for (i = 0; i < burst_ctx->rx_pkts_cnt; i++) {
+			if (burst_ctx->pkts_drop[i] || pkts_pdr_idx[i] != pdr_idx)
+				continue;
+
+			if (!upf_accel_sw_meters_chain_police(meters,
+							      pdr->qerids_num,
+							      rte_pktmbuf_pkt_len(burst_ctx->rx_pkts[i])))
+				burst_ctx->pkts_exceed[i] = true;
+		}
+
+		for (k = 0; k < pdr->qerids_num; k++)
+			rte_spinlock_unlock(&meters[k].lock);
+	}
+}
+
+/*
+ * Debit a SW meter by the bytes its HW meter passed since the last debit
+ *
+ * The HW meter counter is read after the HW meter policed the packets, so the bytes are taken from the tokens
+ * available now and the rest becomes a debt paid by the next refills. The debt is capped by the CBS, beyond which
+ * the HW meter itself dropped the packets. A counter lower than the last one was read from a re-created entry.
+ *
+ * @meter [in]: SW meter, locked by the caller
+ * @hw_bytes [in]: current bytes counter of the HW meter entry
+ * @tsc [in]: current timestamp
+ * @tsc_hz [in]: timestamp frequency
+ */
+static void upf_accel_sw_meter_hw_debit(struct upf_accel_sw_meter *meter,
+					uint64_t hw_bytes,
+					uint64_t tsc,
+					uint64_t tsc_hz)
+{
+	uint64_t bytes = hw_bytes >= meter->hw_bytes ? hw_bytes - meter->hw_bytes : hw_bytes;
+
+	meter->hw_bytes = hw_bytes;
+	upf_accel_sw_meter_refill(meter, tsc, tsc_hz);
+
+	if (bytes <= meter->tokens) {
+		meter->tokens -= bytes;
+		return;
+	}
+
+	bytes -= meter->tokens;
+	meter->tokens = 0;
+	meter->hw_debt = RTE_MIN(meter->hw_debt + bytes, meter->cbs);
+}
+
+void upf_accel_sw_meters_hw_sync(struct upf_accel_ctx *upf_accel_ctx)
+{
+	const struct upf_accel_pdrs *pdrs = upf_accel_ctx->upf_accel_cfg->pdrs;
+	struct doca_flow_resource_query query_stats;
+	struct doca_flow_pipe_entry *entry;
+	struct upf_accel_sw_meter *meter;
+	uint64_t tsc_hz = rte_get_tsc_hz();
+	const struct upf_accel_pdr *pdr;
+	enum upf_accel_port port_id;
+	uint32_t pdr_idx, i;
+	doca_error_t result;
+
+	for (pdr_idx = 0; pdr_idx < pdrs->num_pdrs; pdr_idx++) {
+		pdr = &pdrs->arr_pdrs[pdr_idx];
+		if (!pdr->active)
+			continue;
+
+		for (i = 0; i < pdr->qerids_num; i++) {
+			for (port_id = 0; port_id < upf_accel_ctx->num_ports; port_id++) {
+				entry = upf_accel_ctx->meter_entries[pdr_idx][i][port_id];
+				if (!entry)
+					continue;
+
+				result = doca_flow_resource_query_entry(entry, &query_stats);
+				if (result != DOCA_SUCCESS) {
+					DOCA_LOG_DBG("Failed to query meter entry of PDR %u QER %u: %s",
+						     pdr->id,
+						     pdr->qerids[i],
+						     doca_error_get_descr(result));
+					continue;
+				}
+
+				meter = &upf_accel_ctx->sw_meters[upf_accel_shared_meters_table_offset_get(port_id,
+													   pdr_idx,
+													   i)];
+				rte_spinlock_lock(&meter->lock);
+				upf_accel_sw_meter_hw_debit(meter,
+							    query_stats.counter.total_bytes,
+							    rte_rdtsc(),
+							    tsc_hz);
+				rte_spinlock_unlock(&meter->lock);
+			}
+		}
+	}
+}
+
+/*
+ * Offer the packets a source accumulated credit for to a meter
+ *
+ * @meter [in]: meter policing the source
+ * @credit [in/out]: bytes the source may still offer
+ * @offered [out]: incremented by the offered bytes
+ * @return: bytes conforming to the meter
+ */
+static uint64_t upf_accel_meter_check_offer(struct upf_accel_sw_meter *meter, uint64_t *credit, uint64_t *offered)
+{
+	uint64_t passed = 0;
+
+	while (*credit >= UPF_ACCEL_METER_CHECK_PKT_LEN) {
+		*credit -= UPF_ACCEL_METER_CHECK_PKT_LEN;
+		*offered += UPF_ACCEL_METER_CHECK_PKT_LEN;
+		if (upf_accel_sw_meters_chain_police(meter, 1, UPF_ACCEL_METER_CHECK_PKT_LEN))
+			passed += UPF_ACCEL_METER_CHECK_PKT_LEN;
+	}
+
+	return passed;
+}
+
+doca_error_t upf_accel_sw_meters_check(void)
+{
+	/* HW and SW offered loads of each phase, in percents of the MBR */
+	static const uint32_t phases[][2] = {{60, 80}, {150, 80}, {0, 150}};
+	const uint64_t rate = UPF_ACCEL_METER_CHECK_RATE;
+	struct upf_accel_sw_meter hw_meter = {.cir = rate, .cbs = rate, .tokens = rate};
+	struct upf_accel_sw_meter sw_meter = {.cir = rate, .cbs = rate, .tokens = rate};
+	uint64_t hw_offered, sw_offered, hw_passed, sw_passed, total_passed = 0;
+	uint64_t hw_credit = 0, sw_credit = 0, hw_counter = 0;
+	uint64_t tsc = 0, end_tsc, limit;
+	doca_error_t result = DOCA_SUCCESS;
+	uint32_t phase;
+
+	for (phase = 0; phase < RTE_DIM(phases); phase++) {
+		hw_offered = sw_offered = hw_passed = sw_passed = 0;
+
+		for (end_tsc = tsc + UPF_ACCEL_METER_CHECK_PHASE_US; tsc < end_tsc;) {
+			tsc += UPF_ACCEL_METER_CHECK_STEP_US;
+			hw_credit += rate * phases[phase][0] * UPF_ACCEL_METER_CHECK_STEP_US / 100 /
+				     UPF_ACCEL_METER_CHECK_TSC_HZ;
+			sw_credit += rate * phases[phase][1] * UPF_ACCEL_METER_CHECK_STEP_US / 100 /
+				     UPF_ACCEL_METER_CHECK_TSC_HZ;
+
+			upf_accel_sw_meter_refill(&hw_meter, tsc, UPF_ACCEL_METER_CHECK_TSC_HZ);
+			hw_passed += upf_accel_meter_check_offer(&hw_meter, &hw_credit, &hw_offered);
+
+			upf_accel_sw_meter_refill(&sw_meter, tsc, UPF_ACCEL_METER_CHECK_TSC_HZ);
+			sw_passed += upf_accel_meter_check_offer(&sw_meter, &sw_credit, &sw_offered);
+
+			/* The HW meter entry counter counts the packets it was offered, whatever their color */
+			if (tsc % UPF_ACCEL_METER_CHECK_SYNC_US == 0)
+				upf_accel_sw_meter_hw_debit(&sw_meter,
+							    hw_counter + hw_offered,
+							    tsc,
+							    UPF_ACCEL_METER_CHECK_TSC_HZ);
+		}
+
+		hw_counter += hw_offered;
+		total_passed += hw_passed + sw_passed;
+		DOCA_LOG_INFO("Meter check phase %u: HW %u%% offered %lu passed %lu, SW %u%% offered %lu passed %lu",
+			      phase,
+			      phases[phase][0],
+			      hw_offered,
+			      hw_passed,
+			      phases[phase][1],
+			      sw_offered,
+			      sw_passed);
+
+		/*
+		 * The MBR over the time passed, plus the bursts of the HW meter and of the SW meter, plus what the HW
+		 * meter passed since the last counters read
+		 */
+		limit = rate * (tsc + UPF_ACCEL_METER_CHECK_SYNC_US) / UPF_ACCEL_METER_CHECK_TSC_HZ + 2 * rate;
+		if (total_passed > limit) {
+			DOCA_LOG_ERR("Meter check phase %u: %lu bytes passed, exceeding the MBR limit of %lu bytes",
+				     phase,
+				     total_passed,
+				     limit);
+			result = DOCA_ERROR_UNEXPECTED;
+		}
+
+		/* Below the MBR the HW meter must not be limited by the SW traffic */
+		if (phases[phase][0] <= 100 && hw_passed != hw_offered) {
+			DOCA_LOG_ERR("Meter check phase %u: HW passed %lu of %lu bytes offered below the MBR",
+				     phase,
+				     hw_passed,
+				     hw_offered);
+			result = DOCA_ERROR_UNEXPECTED;
+		}
+
+		/* Without HW traffic the SW meter gets the MBR once the HW debt is paid */
+		if (phases[phase][0] == 0 &&
+		    sw_passed < rate * (UPF_ACCEL_METER_CHECK_PHASE_US / UPF_ACCEL_METER_CHECK_TSC_HZ - 1) * 9 / 10) {
+			DOCA_LOG_ERR("Meter check phase %u: SW alone passed only %lu bytes", phase, sw_passed);
+			result = DOCA_ERROR_UNEXPECTED;
+		}
+	}
+
+	if (result == DOCA_SUCCESS)
+		DOCA_LOG_INFO("Meter check passed, %lu bytes passed in %lu us", total_passed, tsc);
+
+	return result;
+}
+
 /*
  * Perform miscellaneous post processing operations on the burst. (packet metadata, decap, send)
  *
@@ -1216,6 +1762,12 @@ static void upf_accel_fp_burst_postprocess(struct upf_accel_fp_data *fp_data, st
 			continue;
 		}
 
+		if (burst_ctx->pkts_exceed[i]) {
+			upf_accel_packet_byte_counter_inc(&fp_data->sw_counters.rate_drop, pkt);
+			rte_pktmbuf_free(pkt);
+			continue;
+		}
+
 		DOCA_LOG_DBG(
 			"Core %u, type %u parsed 8t tun_ip=%x teid=%u qfi=%hhu ue_ip=%x extern_ip=%x ue_port=%hu extern_port=%hu ip_proto=%hhu pdr=%u ran_pkts=%lu ran_bytes=%lu, wan_pkts=%lu, wan_bytes=%lu",
 			rte_lcore_id(),
@@ -1258,6 +1810,21 @@ static void upf_accel_aging_init(struct upf_accel_fp_data *fp_data)
 		fp_data->last_hw_aging_tsc[port_id] = rte_rdtsc();
 }
 
+/*
+ * Initialize the acceleration policy state.
+ *
+ * @fp_data [in]: flow processing data
+ */
+static void upf_accel_policy_init(struct upf_accel_fp_data *fp_data)
+{
+	uint8_t i;
+
+	for (i = 0; i < UPF_ACCEL_HH_TOP_K; i++)
+		fp_data->hh.slots[i].conn_idx = UPF_ACCEL_SW_AGING_LL_INVALID_NODE;
+	fp_data->hh.epoch_tsc = rte_rdtsc();
+	fp_data->accel_budget.last_tsc = fp_data->hh.epoch_tsc;
+}
+
 /*
  * If aging is in progress or the aging period timeout has expired, poll for up to UPF_ACCEL_MAX_NUM_AGING entries. Note
  * that this function doesn't process any potential resulting flow removals and relies on the caller to do it
@@ -1316,6 +1883,7 @@ static void upf_accel_fp_run_port(struct upf_accel_fp_data *fp_data,
 	struct upf_accel_match_8t match_mem[UPF_ACCEL_MAX_PKT_BURST];
 	struct upf_accel_fp_burst_ctx burst_ctx = {
 		.pkts_drop = {0},
+		.pkts_exceed = {0},
 	};
 	doca_error_t ret;
 	uint16_t sent;
@@ -1326,6 +1894,7 @@ static void upf_accel_fp_run_port(struct upf_accel_fp_data *fp_data,
 	upf_accel_fp_pkts_match(&burst_ctx, match_mem);
 	upf_accel_fp_conns_lookup(fp_data, &burst_ctx);
 	upf_accel_fp_flows_accel(fp_data, rx_port_id, &burst_ctx);
+	upf_accel_fp_burst_police(fp_data, tx_port_id, &burst_ctx);
 	upf_accel_fp_burst_postprocess(fp_data, &burst_ctx);
 
 	ret = upf_accel_hw_aging_poll(fp_data, rx_port_id);
@@ -1362,6 +1931,65 @@ static void upf_accel_fp_run(struct upf_accel_fp_data *fp_data)
 		upf_accel_fp_run_port(fp_data, port_id, fp_data->ctx->get_fwd_port(port_id));
 }
 
+/*
+ * Release the connections of the PDRs invalidated by the session control
+ *
+ * Does nothing unless a new invalidation was published. Accelerated flows are removed from HW and released by the
+ * entry removal completion, same as aged flows. Not accelerated flows are released right away.
+ *
+ * @fp_data [in]: flow processing data
+ */
+static void upf_accel_fp_pdrs_invalidate(struct upf_accel_fp_data *fp_data)
+{
+	uint64_t gen = __atomic_load_n(&fp_data->ctx->pdrs_gen, __ATOMIC_ACQUIRE);
+	const uint64_t *invalidate_gen = fp_data->ctx->pdrs_invalidate_gen;
+	enum upf_accel_flow_status flow_status;
+	struct upf_accel_entry_ctx *conn;
+	enum parser_pkt_type pkt_type;
+	uint32_t conn_idx;
+	doca_error_t ret;
+
+	if (likely(gen == fp_data->pdrs_gen))
+		return;
+
+	for (conn_idx = 0; conn_idx < fp_data->dyn_tbl_size; conn_idx++) {
+		conn = &fp_data->dyn_tbl_data[conn_idx];
+
+		for (pkt_type = 0; pkt_type < PARSER_PKT_TYPE_NUM; pkt_type++) {
+			flow_status = conn->dyn_ctx.flow_status[pkt_type];
+			if (flow_status == UPF_ACCEL_FLOW_STATUS_NONE ||
+			    invalidate_gen[conn->dyn_ctx.pdr_idx[pkt_type]] <= fp_data->pdrs_gen)
+				continue;
+
+			/* The table data isn't cleared on deletion, make sure the connection is still alive */
+			if (rte_hash_lookup_with_hash(fp_data->dyn_tbl, &conn->dyn_ctx.match.inner, conn->dyn_ctx.hash) !=
+			    (int32_t)conn_idx)
+				break;
+
+			if (flow_status == UPF_ACCEL_FLOW_STATUS_ACCELERATED &&
+			    conn->dyn_ctx.entries[pkt_type].status != DOCA_FLOW_ENTRY_STATUS_ERROR) {
+				ret = doca_flow_pipe_remove_entry(fp_data->queue_id,
+								  DOCA_FLOW_WAIT_FOR_BATCH,
+								  conn->dyn_ctx.entries[pkt_type].entry);
+				if (ret != DOCA_SUCCESS) {
+					DOCA_LOG_ERR("Failed to remove invalidated entry: %s", doca_error_get_descr(ret));
+					fp_data->accel_counters[pkt_type].aging_errors++;
+				}
+				continue;
+			}
+
+			if (flow_status != UPF_ACCEL_FLOW_STATUS_ACCELERATED)
+				upf_accel_sw_aging_ll_node_remove(fp_data, conn, pkt_type);
+
+			ret = upf_accel_fp_delete_flow(fp_data, &conn->dyn_ctx, pkt_type);
+			if (ret != DOCA_SUCCESS)
+				DOCA_LOG_ERR("Failed to delete invalidated flow");
+		}
+	}
+
+	fp_data->pdrs_gen = gen;
+}
+
 /*
  * Check and handles (if exceeds) a quota for pdr
  *
@@ -1374,12 +2002,19 @@ static doca_error_t handle_exceeds_quota_for_pdr(struct upf_accel_ctx *ctx,
 						 uint16_t pdr_id,
 						 struct doca_flow_resource_query *query)
 {
-	struct upf_accel_pdr *pdr = &ctx->upf_accel_cfg->pdrs->arr_pdrs[pdr_id];
-	struct upf_accel_urr *urr;
+	const struct upf_accel_rules *rules = upf_accel_rules_get(ctx);
+	const struct upf_accel_pdr *pdr = &rules->pdrs->arr_pdrs[pdr_id];
+	const struct upf_accel_urrs *urrs = rules->urrs;
+	const struct upf_accel_urr *urr;
 	uint32_t i;
 
+	if (!pdr->active)
+		return DOCA_SUCCESS;
+
 	for (i = 0; i < pdr->urrids_num; ++i) {
-		urr = &ctx->upf_accel_cfg->urrs->arr_urrs[pdr->urrids[i]];
+		if (pdr->urrids[i] >= urrs->num_urrs)
+			continue;
+		urr = &urrs->arr_urrs[pdr->urrids[i]];
 		if (query->counter.total_bytes >= urr->volume_quota_total_volume) {
 			/*
 			 * Quota exceeded.
@@ -1439,20 +2074,38 @@ static doca_error_t handle_exceeds_quotas(struct upf_accel_fp_data *fp_data)
 
 void upf_accel_fp_loop(struct upf_accel_fp_data *fp_data)
 {
+	struct rte_rcu_qsbr *qsv = fp_data->ctx->qsv;
+	unsigned int lcore = rte_lcore_id();
 	doca_error_t result;
 
 	upf_accel_aging_init(fp_data);
+	upf_accel_policy_init(fp_data);
+
+	rte_rcu_qsbr_thread_register(qsv, lcore);
+	rte_rcu_qsbr_thread_online(qsv, lcore);
+	fp_data->pdrs_gen = __atomic_load_n(&fp_data->ctx->pdrs_gen, __ATOMIC_ACQUIRE);
 
 	while (!force_quit) {
+		upf_accel_fp_pdrs_invalidate(fp_data);
+
 		upf_accel_fp_run(fp_data);
 
+		if (fp_data->ctx->upf_accel_cfg->accel_budget != UPF_ACCEL_ACCEL_BUDGET_NONE)
+			upf_accel_hh_decay(&fp_data->hh);
+
 		upf_accel_sw_aging_ll_scan(fp_data, PARSER_PKT_TYPE_TUNNELED);
 		upf_accel_sw_aging_ll_scan(fp_data, PARSER_PKT_TYPE_PLAIN);
 
 		result = handle_exceeds_quotas(fp_data);
 		if (result != DOCA_SUCCESS) {
 			DOCA_LOG_ERR("Failed to handle expired quotas: %s", doca_error_get_descr(result));
-			return;
+			break;
 		}
+
+		/* No reference to the published SMF rules is kept past this point */
+		rte_rcu_qsbr_quiescent(qsv, lcore);
 	}
+
+	rte_rcu_qsbr_thread_offline(qsv, lcore);
+	rte_rcu_qsbr_thread_unregister(qsv, lcore);
 }
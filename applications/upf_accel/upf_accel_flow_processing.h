@@ -44,6 +44,7 @@ struct upf_accel_fp_sw_counters {
 	struct upf_accel_packet_byte_counter new_conn; /* New connections */
 	struct upf_accel_packet_byte_counter ex_conn;  /* Existing connections */
 	struct upf_accel_packet_byte_counter err;      /* Errors */
+	struct upf_accel_packet_byte_counter rate_drop; /* Dropped by the QER SW meters */
 };
 
 struct upf_accel_fp_accel_counters {
@@ -53,6 +54,35 @@ struct upf_accel_fp_accel_counters {
 	uint64_t aging_errors; /* Number of failed aging cases */
 };
 
+struct upf_accel_fp_policy_counters {
+	uint64_t deferred_not_heavy; /* Accelerations deferred since the flow isn't a heavy hitter */
+	uint64_t deferred_budget;    /* Accelerations deferred since the insertion budget was exhausted */
+	uint64_t retries;	     /* Retried failed accelerations */
+	uint64_t retries_succeeded;  /* Retried failed accelerations that succeeded */
+};
+
+struct upf_accel_hh_slot {
+	int32_t conn_idx;	       /* Tracked connection, UPF_ACCEL_SW_AGING_LL_INVALID_NODE if free */
+	enum parser_pkt_type pkt_type; /* Tracked direction of the connection */
+	uint64_t bytes;		       /* Estimated (decayed) byte count */
+	uint64_t err;		       /* Maximal overestimation of the byte count */
+};
+
+/*
+ * Space-saving summary of the connections with the highest SW byte rate.
+ * A connection that isn't tracked replaces the one with the lowest count and
+ * inherits its count as the overestimation error.
+ */
+struct upf_accel_hh_summary {
+	struct upf_accel_hh_slot slots[UPF_ACCEL_HH_TOP_K]; /* Tracked connections */
+	uint64_t epoch_tsc;				    /* Timestamp of the last counts decay */
+};
+
+struct upf_accel_accel_budget {
+	double tokens;	   /* Currently available flow insertions */
+	uint64_t last_tsc; /* Timestamp of the last tokens update */
+};
+
 struct upf_accel_fp_data {
 	struct upf_accel_ctx *ctx;						  /* UPF Acceleration context */
 	uint16_t queue_id;							  /* Queue id */
@@ -65,6 +95,11 @@ struct upf_accel_fp_data {
 	struct upf_accel_fp_accel_counters accel_failed_counters[PARSER_PKT_TYPE_NUM]; /* Port acceleration failed
 											  counters */
 	struct upf_accel_sw_aging_ll sw_aging_ll[PARSER_PKT_TYPE_NUM];		       /* SW Aging linked list */
+	struct upf_accel_fp_policy_counters policy_counters; /* Acceleration policy counters */
+	struct upf_accel_hh_summary hh;			     /* Heavy hitters summary */
+	struct upf_accel_accel_budget accel_budget;	     /* Flow insertions budget */
+	uint32_t dyn_tbl_size;				     /* Number of entries of the dynamic connection table */
+	uint64_t pdrs_gen;				     /* Last handled PDRs invalidation generation */
 	uint64_t last_hw_aging_tsc[UPF_ACCEL_PORTS_MAX]; /* Last HW aging iteration timestamp */
 	bool hw_aging_in_progress[UPF_ACCEL_PORTS_MAX];	 /* HW Aging in progress, more entries pending */
 } __rte_aligned(RTE_CACHE_LINE_SIZE);
@@ -84,6 +119,26 @@ void upf_accel_check_for_valid_entry_aging(struct doca_flow_pipe_entry *entry,
 					   enum doca_flow_entry_op op,
 					   void *user_ctx);
 
+/*
+ * Debit the SW meters by the bytes their HW meters passed since the last call
+ *
+ * The HW meter of a QER and its SW counterpart both get the QER MBR, so the SW meter draws its tokens from what the
+ * HW meter left, read from the counters of the HW meter entries. Must be called by the thread updating the SMF rules.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ */
+void upf_accel_sw_meters_hw_sync(struct upf_accel_ctx *upf_accel_ctx);
+
+/*
+ * Check that mixed HW and SW forwarded traffic of a QER never exceeds its MBR
+ *
+ * Runs the SW meters against a model of the HW meter, synchronized as upf_accel_sw_meters_hw_sync() does, with
+ * several mixes of offered loads.
+ *
+ * @return: DOCA_SUCCESS if every mix complies with the MBR and DOCA_ERROR otherwise
+ */
+doca_error_t upf_accel_sw_meters_check(void);
+
 /*
  * UPF Acceleration flow processing main loop
  *
@@ -633,7 +633,15 @@ static doca_error_t upf_accel_pdr_parse(struct json_object *pdr_arr, struct upf_
 	size_t i;
 
 	num_pdrs = json_object_array_length(pdr_arr);
-	pdrs = rte_zmalloc("UPF PDRs", sizeof(*pdrs) + sizeof(pdrs->arr_pdrs[0]) * num_pdrs, RTE_CACHE_LINE_SIZE);
+	if (num_pdrs > UPF_ACCEL_MAX_NUM_PDR) {
+		DOCA_LOG_ERR("Max Supported PDRs Num is: %lu", UPF_ACCEL_MAX_NUM_PDR);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	/* Room for the max number of PDRs, so PDRs can be added at runtime without moving the existing ones */
+	pdrs = rte_zmalloc("UPF PDRs",
+			   sizeof(*pdrs) + sizeof(pdrs->arr_pdrs[0]) * UPF_ACCEL_MAX_NUM_PDR,
+			   RTE_CACHE_LINE_SIZE);
 	if (!pdrs) {
 		DOCA_LOG_ERR("Failed to allocate PDR memory");
 		return DOCA_ERROR_NO_MEMORY;
@@ -689,6 +697,7 @@ static doca_error_t upf_accel_pdr_parse(struct json_object *pdr_arr, struct upf_
 		err = upf_accel_pdi_parse(pdi, upf_accel_pdr);
 		if (err != DOCA_SUCCESS)
 			goto err_pdr;
+		upf_accel_pdr->active = true;
 
 		DOCA_LOG_INFO(
 			"Parsed PDR id=%u\n\tfarId=%u first_urrid=%u first_qerid=%u\n\tPDI SI=%u QFI=%hhu teid_start=%u teid_end=%u IP=%x/%hhu UEIP=%x/%hhu\n\t\tSDF proto=%d from=%x/%hhu:%hu-%hu to=%x/%hhu:%hu-%hu",
@@ -1113,6 +1122,52 @@ err_json:
 	return err;
 }
 
+doca_error_t upf_accel_smf_msg_parse(struct json_object *root, const char *prefix, struct upf_accel_config *cfg)
+{
+	char name[UPF_ACCEL_PDR_STR_LEN];
+	struct json_object *arr;
+	doca_error_t err;
+
+	snprintf(name, sizeof(name), "%sPdr", prefix);
+	if (json_object_object_get_ex(root, name, &arr)) {
+		err = json_object_get_type(arr) == json_type_array ? upf_accel_pdr_parse(arr, cfg) :
+								      DOCA_ERROR_INVALID_VALUE;
+		if (err != DOCA_SUCCESS)
+			goto err_parse;
+	}
+
+	snprintf(name, sizeof(name), "%sFar", prefix);
+	if (json_object_object_get_ex(root, name, &arr)) {
+		err = json_object_get_type(arr) == json_type_array ? upf_accel_far_parse(arr, cfg) :
+								      DOCA_ERROR_INVALID_VALUE;
+		if (err != DOCA_SUCCESS)
+			goto err_parse;
+	}
+
+	snprintf(name, sizeof(name), "%sUrr", prefix);
+	if (json_object_object_get_ex(root, name, &arr)) {
+		err = json_object_get_type(arr) == json_type_array ? upf_accel_urr_parse(arr, cfg) :
+								      DOCA_ERROR_INVALID_VALUE;
+		if (err != DOCA_SUCCESS)
+			goto err_parse;
+	}
+
+	snprintf(name, sizeof(name), "%sQer", prefix);
+	if (json_object_object_get_ex(root, name, &arr)) {
+		err = json_object_get_type(arr) == json_type_array ? upf_accel_qer_parse(arr, cfg) :
+								      DOCA_ERROR_INVALID_VALUE;
+		if (err != DOCA_SUCCESS)
+			goto err_parse;
+	}
+
+	return DOCA_SUCCESS;
+
+err_parse:
+	DOCA_LOG_ERR("Failed to parse message %s array", name);
+	upf_accel_smf_cleanup(cfg);
+	return err;
+}
+
 /*
  * Cleanup items were created by upf_accel_smf_parse
  *
@@ -836,7 +836,8 @@ static doca_error_t upf_accel_pipe_shared_meter_create(struct upf_accel_ctx *upf
 						       struct doca_flow_pipe **pipe)
 {
 	struct doca_flow_monitor mon = {.meter_type = DOCA_FLOW_RESOURCE_TYPE_SHARED,
-					.shared_meter.shared_meter_id = UINT32_MAX};
+					.shared_meter.shared_meter_id = UINT32_MAX,
+					.counter_type = DOCA_FLOW_RESOURCE_TYPE_NON_SHARED};
 	struct doca_flow_fwd fwd_miss = {
 		.type = DOCA_FLOW_FWD_PIPE,
 		.next_pipe =
@@ -905,7 +906,7 @@ static doca_error_t upf_accel_pipe_meter_chain_create(struct upf_accel_ctx *upf_
 		return result;
 	}
 
-	for (i = upf_accel_ctx->upf_accel_cfg->qers->num_qers - 1; i >= 0; --i) {
+	for (i = upf_accel_ctx->upf_accel_cfg->max_pdr_qers - 1; i >= 0; --i) {
 		result = upf_accel_pipe_shared_meter_create(
 			upf_accel_ctx,
 			pipe_cfg,
@@ -919,7 +920,7 @@ static doca_error_t upf_accel_pipe_meter_chain_create(struct upf_accel_ctx *upf_
 		 * The following color match pipe is to continue to the next meters pipe, since
 		 * the last meters pipe always points to NoMoreMeters for color match, we skip it.
 		 */
-		if (i == (int)(upf_accel_ctx->upf_accel_cfg->qers->num_qers - 1))
+		if (i == (int)(upf_accel_ctx->upf_accel_cfg->max_pdr_qers - 1))
 			continue;
 
 		result = upf_accel_pipe_color_match_create(
@@ -933,6 +934,9 @@ static doca_error_t upf_accel_pipe_meter_chain_create(struct upf_accel_ctx *upf_
 		}
 	}
 
+	/* PDRs added at runtime can't have more QERs than the chain has meters */
+	upf_accel_ctx->meter_chain_len = upf_accel_ctx->upf_accel_cfg->max_pdr_qers;
+
 	return result;
 }
 
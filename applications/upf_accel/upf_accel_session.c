@@ -0,0 +1,1179 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <json-c/json.h>
+
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
+
+#include <doca_log.h>
+
+#include "upf_accel.h"
+#include "upf_accel_session.h"
+
+DOCA_LOG_REGISTER(UPF_ACCEL::SESSION);
+
+/* Maximum length of a session control message, including the terminating newline */
+#define UPF_ACCEL_SESSION_MSG_MAX_LEN (64 * 1024)
+/* Maximum length of a session control reply */
+#define UPF_ACCEL_SESSION_REPLY_MAX_LEN 64
+/* Session ID of the PDRs loaded from the SMF configuration file */
+#define UPF_ACCEL_SESSION_SEID_STATIC 0
+
+/* The rules arrays are handled generically, all the rules start with this header */
+struct upf_accel_session_rule_hdr {
+	uint32_t id;	 /* Rule ID */
+	uint32_t refcnt; /* Number of installed PDRs referencing the rule */
+	uint64_t seid;	 /* ID of the session that created the rule */
+};
+
+#define UPF_ACCEL_SESSION_RULE_HDR_ASSERT(type, name) \
+	static_assert(offsetof(type, id) == offsetof(struct upf_accel_session_rule_hdr, id) && \
+			      offsetof(type, refcnt) == offsetof(struct upf_accel_session_rule_hdr, refcnt) && \
+			      offsetof(type, seid) == offsetof(struct upf_accel_session_rule_hdr, seid), \
+		      name " must start with the rule header")
+
+UPF_ACCEL_SESSION_RULE_HDR_ASSERT(struct upf_accel_far, "FAR");
+UPF_ACCEL_SESSION_RULE_HDR_ASSERT(struct upf_accel_urr, "URR");
+UPF_ACCEL_SESSION_RULE_HDR_ASSERT(struct upf_accel_qer, "QER");
+
+enum upf_accel_session_msg_type {
+	UPF_ACCEL_SESSION_MSG_ESTABLISHMENT,
+	UPF_ACCEL_SESSION_MSG_MODIFICATION,
+	UPF_ACCEL_SESSION_MSG_DELETION,
+};
+
+struct upf_accel_session_msg {
+	enum upf_accel_session_msg_type type;		   /* Message type */
+	uint64_t seid;					   /* Session ID */
+	struct upf_accel_config create;			   /* Rules to create */
+	struct upf_accel_config update;			   /* Rules to update */
+	uint32_t remove_pdrs[UPF_ACCEL_MAX_NUM_PDR];	   /* IDs of the PDRs to remove */
+	uint32_t num_remove_pdrs;			   /* Number of PDRs to remove */
+};
+
+/* Per PDR slot actions of a message */
+struct upf_accel_session_slot_ops {
+	bool remove[UPF_ACCEL_MAX_NUM_PDR]; /* Remove the HW rules and flows of the installed PDR */
+	bool add[UPF_ACCEL_MAX_NUM_PDR];    /* Add the HW rules of the new PDR and activate it */
+	bool meters[UPF_ACCEL_MAX_NUM_PDR]; /* Refresh the meters of the installed PDR */
+};
+
+struct upf_accel_session_ctrl {
+	int listen_fd;					 /* Listening socket */
+	int client_fd;					 /* Connected client socket, -1 if none */
+	size_t buf_len;					 /* Number of bytes in the receive buffer */
+	struct upf_accel_session_counters counters;	 /* Counters */
+	char buf[UPF_ACCEL_SESSION_MSG_MAX_LEN];	 /* Receive buffer */
+};
+
+/*
+ * Get the position of a rule in a rules array
+ *
+ * @arr [in]: rules array
+ * @num [in]: number of rules in the array
+ * @size [in]: size of a rule
+ * @id [in]: rule ID
+ * @return: position of the rule, -1 if not found
+ */
+static int32_t upf_accel_session_rule_idx_get(const void *arr, size_t num, size_t size, uint32_t id)
+{
+	size_t i;
+
+	for (i = 0; i < num; i++) {
+		if (*(const uint32_t *)((const uint8_t *)arr + i * size) == id)
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+ * Merge created and updated rules into a rules array
+ *
+ * The array must have room for the created rules. Updated rules keep their session and references.
+ *
+ * @arr [in/out]: rules array
+ * @num [in/out]: number of rules in the array
+ * @size [in]: size of a rule
+ * @seid [in]: ID of the session creating the rules
+ * @create [in]: rules to create, their IDs must not exist
+ * @num_create [in]: number of rules to create
+ * @update [in]: rules to update, their IDs must exist
+ * @num_update [in]: number of rules to update
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t upf_accel_session_rules_merge(void *arr,
+						  size_t *num,
+						  size_t size,
+						  uint64_t seid,
+						  const void *create,
+						  size_t num_create,
+						  const void *update,
+						  size_t num_update)
+{
+	struct upf_accel_session_rule_hdr old_hdr;
+	struct upf_accel_session_rule_hdr *hdr;
+	const uint8_t *rule;
+	int32_t idx;
+	size_t i;
+
+	for (i = 0; i < num_create; i++) {
+		rule = (const uint8_t *)create + i * size;
+		if (upf_accel_session_rule_idx_get(arr, *num, size, *(const uint32_t *)rule) >= 0) {
+			DOCA_LOG_ERR("Can't create rule %u, ID already exists", *(const uint32_t *)rule);
+			return DOCA_ERROR_ALREADY_EXIST;
+		}
+		hdr = (struct upf_accel_session_rule_hdr *)((uint8_t *)arr + (*num)++ * size);
+		memcpy(hdr, rule, size);
+		hdr->refcnt = 0;
+		hdr->seid = seid;
+	}
+
+	for (i = 0; i < num_update; i++) {
+		rule = (const uint8_t *)update + i * size;
+		idx = upf_accel_session_rule_idx_get(arr, *num, size, *(const uint32_t *)rule);
+		if (idx < 0) {
+			DOCA_LOG_ERR("Can't update rule %u, ID doesn't exist", *(const uint32_t *)rule);
+			return DOCA_ERROR_NOT_FOUND;
+		}
+		hdr = (struct upf_accel_session_rule_hdr *)((uint8_t *)arr + idx * size);
+		old_hdr = *hdr;
+		memcpy(hdr, rule, size);
+		hdr->refcnt = old_hdr.refcnt;
+		hdr->seid = old_hdr.seid;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Take a reference on a rule
+ *
+ * @arr [in/out]: rules array
+ * @num [in]: number of rules in the array
+ * @size [in]: size of a rule
+ * @id [in]: rule ID
+ */
+static void upf_accel_session_rule_get(void *arr, size_t num, size_t size, uint32_t id)
+{
+	int32_t idx;
+
+	idx = upf_accel_session_rule_idx_get(arr, num, size, id);
+	if (idx >= 0)
+		((struct upf_accel_session_rule_hdr *)((uint8_t *)arr + idx * size))->refcnt++;
+}
+
+/*
+ * Allocate a copy of a rules array with room for more rules
+ *
+ * @arr_offset [in]: offset of the rules array in the rules struct
+ * @size [in]: size of a rule
+ * @old [in]: rules struct to copy
+ * @num_old [in]: number of rules in old
+ * @capacity [in]: number of rules the copy must have room for
+ * @return: the copy on success and NULL otherwise
+ */
+static void *upf_accel_session_rules_dup(size_t arr_offset, size_t size, const void *old, size_t num_old, size_t capacity)
+{
+	void *rules;
+
+	rules = rte_zmalloc("UPF session rules", arr_offset + size * capacity, RTE_CACHE_LINE_SIZE);
+	if (!rules) {
+		DOCA_LOG_ERR("Failed to allocate session rules");
+		return NULL;
+	}
+
+	memcpy(rules, old, arr_offset + size * num_old);
+
+	return rules;
+}
+
+/*
+ * Allocate a rules snapshot
+ *
+ * @rules [in]: FARs, URRs and QERs of the snapshot
+ * @pdrs [in]: PDRs of the snapshot
+ * @return: the snapshot on success and NULL otherwise
+ */
+static struct upf_accel_rules *upf_accel_session_snapshot_alloc(const struct upf_accel_config *rules,
+								struct upf_accel_pdrs *pdrs)
+{
+	struct upf_accel_rules *snapshot;
+
+	snapshot = rte_zmalloc("UPF rules", sizeof(*snapshot), RTE_CACHE_LINE_SIZE);
+	if (!snapshot) {
+		DOCA_LOG_ERR("Failed to allocate rules snapshot");
+		return NULL;
+	}
+
+	snapshot->pdrs = pdrs;
+	snapshot->fars = rules->fars;
+	snapshot->urrs = rules->urrs;
+	snapshot->qers = rules->qers;
+
+	return snapshot;
+}
+
+/*
+ * Free a rules snapshot and its rules
+ *
+ * @snapshot [in]: rules snapshot, no worker may use it anymore
+ */
+static void upf_accel_session_snapshot_free(struct upf_accel_rules *snapshot)
+{
+	rte_free(snapshot->qers);
+	rte_free(snapshot->urrs);
+	rte_free(snapshot->fars);
+	rte_free(snapshot->pdrs);
+	rte_free(snapshot);
+}
+
+/*
+ * Make the rules of a snapshot the rules of the configuration, used by the control thread
+ *
+ * @cfg [in/out]: UPF Acceleration configuration
+ * @snapshot [in]: rules snapshot
+ */
+static void upf_accel_session_rules_set(struct upf_accel_config *cfg, const struct upf_accel_rules *snapshot)
+{
+	cfg->pdrs = snapshot->pdrs;
+	cfg->fars = snapshot->fars;
+	cfg->urrs = snapshot->urrs;
+	cfg->qers = snapshot->qers;
+}
+
+/*
+ * Publish a rules snapshot to the workers
+ *
+ * A single pointer store replaces all the rules, so the workers see either the previous rules or the new ones and
+ * never a mix of both.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @snapshot [in]: rules snapshot
+ */
+static void upf_accel_session_rules_publish(struct upf_accel_ctx *upf_accel_ctx, struct upf_accel_rules *snapshot)
+{
+	upf_accel_session_rules_set(upf_accel_ctx->upf_accel_cfg, snapshot);
+	__atomic_store_n(&upf_accel_ctx->rules, snapshot, __ATOMIC_RELEASE);
+}
+
+/*
+ * Get the slot of an installed or being added PDR
+ *
+ * @pdrs [in]: PDRs
+ * @ops [in]: slot actions of the message, NULL to only consider installed PDRs
+ * @pdr_id [in]: PDR ID
+ * @return: slot of the PDR, -1 if not found
+ */
+static int32_t upf_accel_session_pdr_slot_get(const struct upf_accel_pdrs *pdrs,
+					      const struct upf_accel_session_slot_ops *ops,
+					      uint32_t pdr_id)
+{
+	size_t i;
+
+	for (i = 0; i < pdrs->num_pdrs; i++) {
+		if ((pdrs->arr_pdrs[i].active || (ops && ops->add[i])) && pdrs->arr_pdrs[i].id == pdr_id)
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+ * Check if a session has installed or being added PDRs
+ *
+ * @pdrs [in]: PDRs
+ * @ops [in]: slot actions of the message, NULL to only consider installed PDRs
+ * @seid [in]: session ID
+ * @return: true if the session exists
+ */
+static bool upf_accel_session_exists(const struct upf_accel_pdrs *pdrs,
+				     const struct upf_accel_session_slot_ops *ops,
+				     uint64_t seid)
+{
+	size_t i;
+
+	for (i = 0; i < pdrs->num_pdrs; i++) {
+		if ((pdrs->arr_pdrs[i].active || (ops && ops->add[i])) && pdrs->arr_pdrs[i].seid == seid)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Release the unreferenced rules of the sessions that no longer exist
+ *
+ * The rules of the SMF configuration file are never released.
+ *
+ * @arr [in/out]: rules array
+ * @num [in/out]: number of rules in the array
+ * @size [in]: size of a rule
+ * @pdrs [in]: new PDRs
+ * @ops [in]: slot actions of the message
+ */
+static void upf_accel_session_rules_release(void *arr,
+					    size_t *num,
+					    size_t size,
+					    const struct upf_accel_pdrs *pdrs,
+					    const struct upf_accel_session_slot_ops *ops)
+{
+	const struct upf_accel_session_rule_hdr *hdr;
+	size_t i, n = 0;
+
+	for (i = 0; i < *num; i++) {
+		hdr = (const struct upf_accel_session_rule_hdr *)((const uint8_t *)arr + i * size);
+		if (hdr->seid != UPF_ACCEL_SESSION_SEID_STATIC && !hdr->refcnt &&
+		    !upf_accel_session_exists(pdrs, ops, hdr->seid))
+			continue;
+		if (n != i)
+			memcpy((uint8_t *)arr + n * size, hdr, size);
+		n++;
+	}
+
+	*num = n;
+}
+
+/*
+ * Count the references of the new PDRs on the rules and release the rules of the deleted sessions
+ *
+ * @rules [in/out]: new rules
+ * @ops [in]: slot actions of the message
+ */
+static void upf_accel_session_rules_refs_update(struct upf_accel_config *rules,
+						const struct upf_accel_session_slot_ops *ops)
+{
+	const struct upf_accel_pdr *pdr;
+	size_t i;
+	uint32_t j;
+
+	for (i = 0; i < rules->fars->num_fars; i++)
+		rules->fars->arr_fars[i].refcnt = 0;
+	for (i = 0; i < rules->urrs->num_urrs; i++)
+		rules->urrs->arr_urrs[i].refcnt = 0;
+	for (i = 0; i < rules->qers->num_qers; i++)
+		rules->qers->arr_qers[i].refcnt = 0;
+
+	for (i = 0; i < rules->pdrs->num_pdrs; i++) {
+		pdr = &rules->pdrs->arr_pdrs[i];
+		if (!pdr->active && !ops->add[i])
+			continue;
+
+		upf_accel_session_rule_get(rules->fars->arr_fars,
+					   rules->fars->num_fars,
+					   sizeof(rules->fars->arr_fars[0]),
+					   pdr->farid);
+		for (j = 0; j < pdr->urrids_num; j++)
+			upf_accel_session_rule_get(rules->urrs->arr_urrs,
+						   rules->urrs->num_urrs,
+						   sizeof(rules->urrs->arr_urrs[0]),
+						   pdr->urrids[j]);
+		for (j = 0; j < pdr->qerids_num; j++)
+			upf_accel_session_rule_get(rules->qers->arr_qers,
+						   rules->qers->num_qers,
+						   sizeof(rules->qers->arr_qers[0]),
+						   pdr->qerids[j]);
+	}
+
+	upf_accel_session_rules_release(rules->fars->arr_fars,
+					&rules->fars->num_fars,
+					sizeof(rules->fars->arr_fars[0]),
+					rules->pdrs,
+					ops);
+	upf_accel_session_rules_release(rules->urrs->arr_urrs,
+					&rules->urrs->num_urrs,
+					sizeof(rules->urrs->arr_urrs[0]),
+					rules->pdrs,
+					ops);
+	upf_accel_session_rules_release(rules->qers->arr_qers,
+					&rules->qers->num_qers,
+					sizeof(rules->qers->arr_qers[0]),
+					rules->pdrs,
+					ops);
+}
+
+/*
+ * Check that the rules referenced by a PDR exist and fit the pipeline
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @rules [in]: rules the PDR is checked against
+ * @pdr [in]: PDR
+ * @return: true if the PDR is valid
+ */
+static bool upf_accel_session_pdr_valid(struct upf_accel_ctx *upf_accel_ctx,
+					const struct upf_accel_config *rules,
+					const struct upf_accel_pdr *pdr)
+{
+	uint32_t i;
+
+	if (upf_accel_session_rule_idx_get(rules->fars->arr_fars,
+					   rules->fars->num_fars,
+					   sizeof(rules->fars->arr_fars[0]),
+					   pdr->farid) < 0) {
+		DOCA_LOG_ERR("PDR %u references unknown FAR %u", pdr->id, pdr->farid);
+		return false;
+	}
+
+	for (i = 0; i < pdr->urrids_num; i++) {
+		if (upf_accel_session_rule_idx_get(rules->urrs->arr_urrs,
+						   rules->urrs->num_urrs,
+						   sizeof(rules->urrs->arr_urrs[0]),
+						   pdr->urrids[i]) < 0) {
+			DOCA_LOG_ERR("PDR %u references unknown URR %u", pdr->id, pdr->urrids[i]);
+			return false;
+		}
+	}
+
+	/* The meters chain length was set at pipeline creation and can't grow */
+	if (pdr->qerids_num > upf_accel_ctx->meter_chain_len) {
+		DOCA_LOG_ERR("PDR %u has %u QERs, the pipeline supports up to %u",
+			     pdr->id,
+			     pdr->qerids_num,
+			     upf_accel_ctx->meter_chain_len);
+		return false;
+	}
+
+	for (i = 0; i < pdr->qerids_num; i++) {
+		if (upf_accel_session_rule_idx_get(rules->qers->arr_qers,
+						   rules->qers->num_qers,
+						   sizeof(rules->qers->arr_qers[0]),
+						   pdr->qerids[i]) < 0) {
+			DOCA_LOG_ERR("PDR %u references unknown QER %u", pdr->id, pdr->qerids[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Check if a PDR references a QER
+ *
+ * @pdr [in]: PDR
+ * @qer_id [in]: QER ID
+ * @return: true if the QER is referenced
+ */
+static bool upf_accel_session_pdr_has_qer(const struct upf_accel_pdr *pdr, uint32_t qer_id)
+{
+	uint32_t i;
+
+	for (i = 0; i < pdr->qerids_num; i++) {
+		if (pdr->qerids[i] == qer_id)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Build the new rules of a message on top of copies of the installed rules
+ *
+ * Nothing is installed, the PDRs to add are left inactive and the slot actions needed to install the new rules are
+ * returned.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @msg [in]: session message
+ * @rules [out]: new rules, allocated even on failure
+ * @ops [out]: slot actions
+ * @return: PFCP cause
+ */
+static enum upf_accel_session_cause upf_accel_session_rules_build(struct upf_accel_ctx *upf_accel_ctx,
+								  const struct upf_accel_session_msg *msg,
+								  struct upf_accel_config *rules,
+								  struct upf_accel_session_slot_ops *ops)
+{
+	const struct upf_accel_config *cfg = upf_accel_ctx->upf_accel_cfg;
+	const struct upf_accel_pdrs *create_pdrs = msg->create.pdrs;
+	const struct upf_accel_pdrs *update_pdrs = msg->update.pdrs;
+	const struct upf_accel_qer *old_qer;
+	const struct upf_accel_qer *qer;
+	struct upf_accel_pdr *pdr;
+	int32_t slot, idx;
+	uint32_t i, j;
+
+	rules->pdrs = upf_accel_session_rules_dup(offsetof(struct upf_accel_pdrs, arr_pdrs),
+						  sizeof(cfg->pdrs->arr_pdrs[0]),
+						  cfg->pdrs,
+						  cfg->pdrs->num_pdrs,
+						  UPF_ACCEL_MAX_NUM_PDR);
+	rules->fars = upf_accel_session_rules_dup(offsetof(struct upf_accel_fars, arr_fars),
+						  sizeof(cfg->fars->arr_fars[0]),
+						  cfg->fars,
+						  cfg->fars->num_fars,
+						  cfg->fars->num_fars + (msg->create.fars ? msg->create.fars->num_fars : 0));
+	rules->urrs = upf_accel_session_rules_dup(offsetof(struct upf_accel_urrs, arr_urrs),
+						  sizeof(cfg->urrs->arr_urrs[0]),
+						  cfg->urrs,
+						  cfg->urrs->num_urrs,
+						  cfg->urrs->num_urrs + (msg->create.urrs ? msg->create.urrs->num_urrs : 0));
+	rules->qers = upf_accel_session_rules_dup(offsetof(struct upf_accel_qers, arr_qers),
+						  sizeof(cfg->qers->arr_qers[0]),
+						  cfg->qers,
+						  cfg->qers->num_qers,
+						  cfg->qers->num_qers + (msg->create.qers ? msg->create.qers->num_qers : 0));
+	if (!rules->pdrs || !rules->fars || !rules->urrs || !rules->qers)
+		return UPF_ACCEL_SESSION_CAUSE_NO_RESOURCES;
+
+	if (msg->create.fars || msg->update.fars) {
+		if (upf_accel_session_rules_merge(rules->fars->arr_fars,
+						  &rules->fars->num_fars,
+						  sizeof(rules->fars->arr_fars[0]),
+						  msg->seid,
+						  msg->create.fars ? msg->create.fars->arr_fars : NULL,
+						  msg->create.fars ? msg->create.fars->num_fars : 0,
+						  msg->update.fars ? msg->update.fars->arr_fars : NULL,
+						  msg->update.fars ? msg->update.fars->num_fars : 0) != DOCA_SUCCESS)
+			return UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+	}
+
+	if (msg->create.urrs || msg->update.urrs) {
+		if (upf_accel_session_rules_merge(rules->urrs->arr_urrs,
+						  &rules->urrs->num_urrs,
+						  sizeof(rules->urrs->arr_urrs[0]),
+						  msg->seid,
+						  msg->create.urrs ? msg->create.urrs->arr_urrs : NULL,
+						  msg->create.urrs ? msg->create.urrs->num_urrs : 0,
+						  msg->update.urrs ? msg->update.urrs->arr_urrs : NULL,
+						  msg->update.urrs ? msg->update.urrs->num_urrs : 0) != DOCA_SUCCESS)
+			return UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+	}
+
+	if (msg->create.qers || msg->update.qers) {
+		if (upf_accel_session_rules_merge(rules->qers->arr_qers,
+						  &rules->qers->num_qers,
+						  sizeof(rules->qers->arr_qers[0]),
+						  msg->seid,
+						  msg->create.qers ? msg->create.qers->arr_qers : NULL,
+						  msg->create.qers ? msg->create.qers->num_qers : 0,
+						  msg->update.qers ? msg->update.qers->arr_qers : NULL,
+						  msg->update.qers ? msg->update.qers->num_qers : 0) != DOCA_SUCCESS)
+			return UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+	}
+
+	/* Removed PDRs */
+	for (slot = 0; slot < (int32_t)rules->pdrs->num_pdrs; slot++) {
+		pdr = &rules->pdrs->arr_pdrs[slot];
+		if (msg->type == UPF_ACCEL_SESSION_MSG_DELETION && pdr->active && pdr->seid == msg->seid) {
+			pdr->active = false;
+			ops->remove[slot] = true;
+		}
+	}
+
+	for (i = 0; i < msg->num_remove_pdrs; i++) {
+		slot = upf_accel_session_pdr_slot_get(rules->pdrs, NULL, msg->remove_pdrs[i]);
+		if (slot < 0 || rules->pdrs->arr_pdrs[slot].seid != msg->seid) {
+			DOCA_LOG_ERR("Can't remove PDR %u, not found in session %lu", msg->remove_pdrs[i], msg->seid);
+			return UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+		}
+		rules->pdrs->arr_pdrs[slot].active = false;
+		ops->remove[slot] = true;
+	}
+
+	/* Updated PDRs are reinstalled in place */
+	for (i = 0; update_pdrs && i < update_pdrs->num_pdrs; i++) {
+		slot = upf_accel_session_pdr_slot_get(rules->pdrs, NULL, update_pdrs->arr_pdrs[i].id);
+		if (slot < 0 || rules->pdrs->arr_pdrs[slot].seid != msg->seid) {
+			DOCA_LOG_ERR("Can't update PDR %u, not found in session %lu", update_pdrs->arr_pdrs[i].id, msg->seid);
+			return UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+		}
+		pdr = &rules->pdrs->arr_pdrs[slot];
+		*pdr = update_pdrs->arr_pdrs[i];
+		pdr->seid = msg->seid;
+		pdr->active = false;
+		ops->remove[slot] = ops->add[slot] = true;
+	}
+
+	/* Created PDRs take a free slot, slots freed by this message are left for later ones */
+	for (i = 0; create_pdrs && i < create_pdrs->num_pdrs; i++) {
+		if (upf_accel_session_pdr_slot_get(rules->pdrs, ops, create_pdrs->arr_pdrs[i].id) >= 0) {
+			DOCA_LOG_ERR("Can't create PDR %u, ID already exists", create_pdrs->arr_pdrs[i].id);
+			return UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+		}
+
+		for (slot = 0; slot < (int32_t)rules->pdrs->num_pdrs; slot++) {
+			if (!rules->pdrs->arr_pdrs[slot].active && !ops->add[slot] && !ops->remove[slot])
+				break;
+		}
+		if (slot == (int32_t)rules->pdrs->num_pdrs) {
+			if (rules->pdrs->num_pdrs == UPF_ACCEL_MAX_NUM_PDR) {
+				DOCA_LOG_ERR("Can't create PDR %u, no free slot", create_pdrs->arr_pdrs[i].id);
+				return UPF_ACCEL_SESSION_CAUSE_NO_RESOURCES;
+			}
+			rules->pdrs->num_pdrs++;
+		}
+
+		pdr = &rules->pdrs->arr_pdrs[slot];
+		*pdr = create_pdrs->arr_pdrs[i];
+		pdr->seid = msg->seid;
+		pdr->active = false;
+		ops->add[slot] = true;
+	}
+
+	/* PDRs of updated FARs and QERs that stay installed */
+	for (slot = 0; slot < (int32_t)rules->pdrs->num_pdrs; slot++) {
+		pdr = &rules->pdrs->arr_pdrs[slot];
+		if (!pdr->active)
+			continue;
+
+		for (i = 0; msg->update.fars && i < msg->update.fars->num_fars; i++) {
+			if (pdr->farid == msg->update.fars->arr_fars[i].id) {
+				pdr->active = false;
+				ops->remove[slot] = ops->add[slot] = true;
+			}
+		}
+
+		for (i = 0; pdr->active && msg->update.qers && i < msg->update.qers->num_qers; i++) {
+			qer = &msg->update.qers->arr_qers[i];
+			if (!upf_accel_session_pdr_has_qer(pdr, qer->id))
+				continue;
+
+			/* A QFI change affects the encap rule, a rate change only the meters */
+			idx = upf_accel_session_rule_idx_get(cfg->qers->arr_qers,
+							     cfg->qers->num_qers,
+							     sizeof(cfg->qers->arr_qers[0]),
+							     qer->id);
+			old_qer = &cfg->qers->arr_qers[idx];
+			if (old_qer->qfi != qer->qfi) {
+				pdr->active = false;
+				ops->remove[slot] = ops->add[slot] = true;
+			} else {
+				ops->meters[slot] = true;
+			}
+		}
+	}
+
+	for (j = 0; j < rules->pdrs->num_pdrs; j++) {
+		if (ops->add[j] && !upf_accel_session_pdr_valid(upf_accel_ctx, rules, &rules->pdrs->arr_pdrs[j]))
+			return UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+	}
+
+	upf_accel_session_rules_refs_update(rules, ops);
+
+	return UPF_ACCEL_SESSION_CAUSE_ACCEPTED;
+}
+
+/*
+ * Install the HW rules of a message, the new rules must already be published
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @old_pdrs [in]: PDRs the installed HW rules were created from
+ * @ops [in]: slot actions
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t upf_accel_session_hw_apply(struct upf_accel_ctx *upf_accel_ctx,
+					       const struct upf_accel_pdrs *old_pdrs,
+					       const struct upf_accel_session_slot_ops *ops)
+{
+	const struct upf_accel_pdrs *pdrs = upf_accel_ctx->upf_accel_cfg->pdrs;
+	uint32_t num_entries = 0;
+	doca_error_t result;
+	uint32_t slot;
+
+	for (slot = 0; slot < pdrs->num_pdrs; slot++) {
+		if (!ops->remove[slot])
+			continue;
+
+		result = upf_accel_pdr_rules_remove(upf_accel_ctx, slot, old_pdrs->arr_pdrs[slot].qerids_num);
+		if (result != DOCA_SUCCESS)
+			return result;
+		num_entries += 1 + old_pdrs->arr_pdrs[slot].qerids_num;
+	}
+
+	for (slot = 0; slot < pdrs->num_pdrs; slot++) {
+		if (!ops->add[slot] && !ops->meters[slot])
+			continue;
+
+		result = upf_accel_pdr_meters_update(upf_accel_ctx, slot);
+		if (result != DOCA_SUCCESS)
+			return result;
+
+		if (!ops->add[slot])
+			continue;
+
+		result = upf_accel_pdr_rules_add(upf_accel_ctx, slot);
+		if (result != DOCA_SUCCESS)
+			return result;
+		num_entries += 1 + pdrs->arr_pdrs[slot].qerids_num;
+	}
+
+	if (!num_entries)
+		return DOCA_SUCCESS;
+
+	return upf_accel_static_entries_process(upf_accel_ctx, num_entries);
+}
+
+/*
+ * Restore the HW rules of the old rules after upf_accel_session_hw_apply() failed
+ *
+ * The HW rules of every slot the message removed or added are removed, whether they are new ones or what is left of
+ * the old ones, then the HW rules and meters of the old PDRs are installed again. The old rules become the rules of
+ * the configuration.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @old_rules [in]: rules installed before the message
+ * @ops [in]: slot actions of the message
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t upf_accel_session_hw_rollback(struct upf_accel_ctx *upf_accel_ctx,
+						  const struct upf_accel_rules *old_rules,
+						  const struct upf_accel_session_slot_ops *ops)
+{
+	const struct upf_accel_pdrs *old_pdrs = old_rules->pdrs;
+	uint32_t num_entries = 0;
+	doca_error_t result;
+	uint32_t slot;
+
+	for (slot = 0; slot < UPF_ACCEL_MAX_NUM_PDR; slot++) {
+		if (!ops->remove[slot] && !ops->add[slot])
+			continue;
+
+		result = upf_accel_pdr_rules_remove(upf_accel_ctx, slot, UPF_ACCEL_MAX_PDR_NUM_RATE_METERS);
+		if (result != DOCA_SUCCESS)
+			return result;
+	}
+
+	result = upf_accel_static_entries_process(upf_accel_ctx, 0);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	upf_accel_session_rules_set(upf_accel_ctx->upf_accel_cfg, old_rules);
+
+	for (slot = 0; slot < old_pdrs->num_pdrs; slot++) {
+		if (!old_pdrs->arr_pdrs[slot].active)
+			continue;
+
+		if (ops->add[slot] || ops->meters[slot]) {
+			result = upf_accel_pdr_meters_update(upf_accel_ctx, slot);
+			if (result != DOCA_SUCCESS)
+				return result;
+		}
+
+		if (!ops->remove[slot])
+			continue;
+
+		result = upf_accel_pdr_rules_add(upf_accel_ctx, slot);
+		if (result != DOCA_SUCCESS)
+			return result;
+		num_entries += 1 + old_pdrs->arr_pdrs[slot].qerids_num;
+	}
+
+	if (!num_entries)
+		return DOCA_SUCCESS;
+
+	return upf_accel_static_entries_process(upf_accel_ctx, num_entries);
+}
+
+/*
+ * Apply a session message
+ *
+ * The new rules are built aside and published at once, with the PDRs to add still inactive. The workers stop using
+ * the old rules after an RCU grace period, and drop the connections of the removed PDRs during a second one, before
+ * the HW rules are changed. The rules with the added PDRs active are then published, and the previous snapshots are
+ * freed after one more grace period. If the HW rules can't be installed the old HW rules and the old rules are
+ * restored, only the dropped connections are lost.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @msg [in]: session message
+ * @return: PFCP cause
+ */
+static enum upf_accel_session_cause upf_accel_session_apply(struct upf_accel_ctx *upf_accel_ctx,
+							    const struct upf_accel_session_msg *msg)
+{
+	struct upf_accel_rules *old_snapshot = upf_accel_ctx->rules;
+	struct upf_accel_session_slot_ops ops = {0};
+	struct upf_accel_rules *active_snapshot = NULL;
+	struct upf_accel_rules *new_snapshot = NULL;
+	struct upf_accel_pdrs *active_pdrs = NULL;
+	struct upf_accel_config rules = {0};
+	enum upf_accel_session_cause cause;
+	bool session_exists;
+	uint64_t gen;
+	uint32_t slot;
+
+	session_exists = upf_accel_session_exists(old_snapshot->pdrs, NULL, msg->seid);
+	if (msg->type == UPF_ACCEL_SESSION_MSG_ESTABLISHMENT) {
+		if (session_exists) {
+			DOCA_LOG_ERR("Session %lu already exists", msg->seid);
+			return UPF_ACCEL_SESSION_CAUSE_REJECTED;
+		}
+		if (!msg->create.pdrs || !msg->create.pdrs->num_pdrs) {
+			DOCA_LOG_ERR("Session %lu establishment without PDRs", msg->seid);
+			return UPF_ACCEL_SESSION_CAUSE_MANDATORY_IE_MISSING;
+		}
+	} else if (!session_exists) {
+		DOCA_LOG_ERR("Session %lu not found", msg->seid);
+		return UPF_ACCEL_SESSION_CAUSE_SESSION_NOT_FOUND;
+	}
+
+	cause = upf_accel_session_rules_build(upf_accel_ctx, msg, &rules, &ops);
+	if (cause != UPF_ACCEL_SESSION_CAUSE_ACCEPTED)
+		goto free_rules;
+
+	/* Allocate everything before publishing, so only the HW can fail once the workers see the new rules */
+	active_pdrs = upf_accel_session_rules_dup(offsetof(struct upf_accel_pdrs, arr_pdrs),
+						  sizeof(rules.pdrs->arr_pdrs[0]),
+						  rules.pdrs,
+						  rules.pdrs->num_pdrs,
+						  UPF_ACCEL_MAX_NUM_PDR);
+	new_snapshot = upf_accel_session_snapshot_alloc(&rules, rules.pdrs);
+	active_snapshot = upf_accel_session_snapshot_alloc(&rules, active_pdrs);
+	if (!active_pdrs || !new_snapshot || !active_snapshot) {
+		cause = UPF_ACCEL_SESSION_CAUSE_NO_RESOURCES;
+		goto free_rules;
+	}
+
+	for (slot = 0; slot < active_pdrs->num_pdrs; slot++) {
+		if (ops.add[slot])
+			active_pdrs->arr_pdrs[slot].active = true;
+	}
+
+	gen = upf_accel_ctx->pdrs_gen + 1;
+	for (slot = 0; slot < rules.pdrs->num_pdrs; slot++) {
+		if (ops.remove[slot])
+			upf_accel_ctx->pdrs_invalidate_gen[slot] = gen;
+	}
+
+	upf_accel_session_rules_publish(upf_accel_ctx, new_snapshot);
+	__atomic_store_n(&upf_accel_ctx->pdrs_gen, gen, __ATOMIC_RELEASE);
+
+	rte_rcu_qsbr_synchronize(upf_accel_ctx->qsv, RTE_QSBR_THRID_INVALID);
+	/* Every worker checks the invalidation at the start of an iteration, wait for one more */
+	rte_rcu_qsbr_synchronize(upf_accel_ctx->qsv, RTE_QSBR_THRID_INVALID);
+
+	if (upf_accel_session_hw_apply(upf_accel_ctx, old_snapshot->pdrs, &ops) != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to install session %lu HW rules, restoring the previous rules", msg->seid);
+		if (upf_accel_session_hw_rollback(upf_accel_ctx, old_snapshot, &ops) != DOCA_SUCCESS)
+			DOCA_LOG_ERR("Failed to restore the HW rules of session %lu, its PDRs may miss HW rules",
+				     msg->seid);
+
+		upf_accel_session_rules_publish(upf_accel_ctx, old_snapshot);
+		rte_rcu_qsbr_synchronize(upf_accel_ctx->qsv, RTE_QSBR_THRID_INVALID);
+		cause = UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE;
+		goto free_rules;
+	}
+
+	upf_accel_session_rules_publish(upf_accel_ctx, active_snapshot);
+	rte_rcu_qsbr_synchronize(upf_accel_ctx->qsv, RTE_QSBR_THRID_INVALID);
+
+	rte_free(new_snapshot);
+	rte_free(rules.pdrs);
+	upf_accel_session_snapshot_free(old_snapshot);
+
+	return UPF_ACCEL_SESSION_CAUSE_ACCEPTED;
+
+free_rules:
+	rte_free(active_snapshot);
+	rte_free(new_snapshot);
+	rte_free(active_pdrs);
+	rte_free(rules.qers);
+	rte_free(rules.urrs);
+	rte_free(rules.fars);
+	rte_free(rules.pdrs);
+	return cause;
+}
+
+/*
+ * Parse a session message
+ *
+ * @line [in]: message, NULL terminated
+ * @msg [out]: parsed message, its rules must be released with upf_accel_smf_cleanup()
+ * @return: PFCP cause
+ */
+static enum upf_accel_session_cause upf_accel_session_msg_parse(const char *line, struct upf_accel_session_msg *msg)
+{
+	enum upf_accel_session_cause cause = UPF_ACCEL_SESSION_CAUSE_REJECTED;
+	struct json_object *remove_arr;
+	struct json_object *type_obj;
+	struct json_object *seid_obj;
+	struct json_object *root;
+	struct json_object *obj;
+	const char *type;
+	size_t i;
+
+	root = json_tokener_parse(line);
+	if (!root) {
+		DOCA_LOG_ERR("Failed to parse session message");
+		return UPF_ACCEL_SESSION_CAUSE_REJECTED;
+	}
+
+	if (!json_object_object_get_ex(root, "type", &type_obj) || !json_object_object_get_ex(root, "seid", &seid_obj)) {
+		DOCA_LOG_ERR("Session message without type or SEID");
+		cause = UPF_ACCEL_SESSION_CAUSE_MANDATORY_IE_MISSING;
+		goto err_json;
+	}
+
+	msg->seid = json_object_get_uint64(seid_obj);
+	if (msg->seid == UPF_ACCEL_SESSION_SEID_STATIC) {
+		DOCA_LOG_ERR("Session ID %u is reserved", UPF_ACCEL_SESSION_SEID_STATIC);
+		goto err_json;
+	}
+
+	type = json_object_get_string(type_obj);
+	if (!strcmp(type, "establishment"))
+		msg->type = UPF_ACCEL_SESSION_MSG_ESTABLISHMENT;
+	else if (!strcmp(type, "modification"))
+		msg->type = UPF_ACCEL_SESSION_MSG_MODIFICATION;
+	else if (!strcmp(type, "deletion"))
+		msg->type = UPF_ACCEL_SESSION_MSG_DELETION;
+	else {
+		DOCA_LOG_ERR("Unknown session message type %s", type);
+		goto err_json;
+	}
+
+	if (msg->type == UPF_ACCEL_SESSION_MSG_DELETION) {
+		json_object_put(root);
+		return UPF_ACCEL_SESSION_CAUSE_ACCEPTED;
+	}
+
+	if (upf_accel_smf_msg_parse(root, "create", &msg->create) != DOCA_SUCCESS)
+		goto err_json;
+
+	if (msg->type == UPF_ACCEL_SESSION_MSG_ESTABLISHMENT) {
+		json_object_put(root);
+		return UPF_ACCEL_SESSION_CAUSE_ACCEPTED;
+	}
+
+	if (upf_accel_smf_msg_parse(root, "update", &msg->update) != DOCA_SUCCESS)
+		goto err_create;
+
+	if (json_object_object_get_ex(root, "removePdr", &remove_arr)) {
+		if (json_object_get_type(remove_arr) != json_type_array ||
+		    json_object_array_length(remove_arr) > UPF_ACCEL_MAX_NUM_PDR) {
+			DOCA_LOG_ERR("Failed to parse removePdr array");
+			goto err_update;
+		}
+
+		for (i = 0; i < json_object_array_length(remove_arr); i++) {
+			obj = json_object_array_get_idx(remove_arr, i);
+			if (json_object_get_type(obj) != json_type_int) {
+				DOCA_LOG_ERR("Failed to parse removePdr ID %lu", i);
+				goto err_update;
+			}
+			msg->remove_pdrs[msg->num_remove_pdrs++] = json_object_get_int(obj);
+		}
+	}
+
+	json_object_put(root);
+	return UPF_ACCEL_SESSION_CAUSE_ACCEPTED;
+
+err_update:
+	upf_accel_smf_cleanup(&msg->update);
+err_create:
+	upf_accel_smf_cleanup(&msg->create);
+err_json:
+	json_object_put(root);
+	return cause;
+}
+
+/*
+ * Handle a session message and reply to it
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ * @line [in]: message, NULL terminated
+ */
+static void upf_accel_session_msg_handle(struct upf_accel_ctx *upf_accel_ctx, const char *line)
+{
+	struct upf_accel_session_ctrl *ctrl = upf_accel_ctx->session_ctrl;
+	struct upf_accel_session_msg msg = {0};
+	char reply[UPF_ACCEL_SESSION_REPLY_MAX_LEN];
+	enum upf_accel_session_cause cause;
+	uint64_t start_tsc = rte_rdtsc();
+	int len;
+
+	cause = upf_accel_session_msg_parse(line, &msg);
+	if (cause == UPF_ACCEL_SESSION_CAUSE_ACCEPTED) {
+		cause = upf_accel_session_apply(upf_accel_ctx, &msg);
+		upf_accel_smf_cleanup(&msg.update);
+		upf_accel_smf_cleanup(&msg.create);
+	}
+
+	if (cause == UPF_ACCEL_SESSION_CAUSE_ACCEPTED) {
+		switch (msg.type) {
+		case UPF_ACCEL_SESSION_MSG_ESTABLISHMENT:
+			ctrl->counters.establishments++;
+			break;
+		case UPF_ACCEL_SESSION_MSG_MODIFICATION:
+			ctrl->counters.modifications++;
+			break;
+		case UPF_ACCEL_SESSION_MSG_DELETION:
+			ctrl->counters.deletions++;
+			break;
+		}
+	} else
+		ctrl->counters.rejects++;
+	ctrl->counters.apply_tsc += rte_rdtsc() - start_tsc;
+
+	DOCA_LOG_DBG("Session %lu message handled, cause %d", msg.seid, cause);
+
+	len = snprintf(reply, sizeof(reply), "{\"seid\":%lu,\"cause\":%d}\n", msg.seid, cause);
+	if (send(ctrl->client_fd, reply, len, MSG_NOSIGNAL) != len) {
+		DOCA_LOG_ERR("Failed to reply to session message: %s", strerror(errno));
+		close(ctrl->client_fd);
+		ctrl->client_fd = -1;
+	}
+}
+
+doca_error_t upf_accel_session_ctrl_init(struct upf_accel_ctx *upf_accel_ctx)
+{
+	const char *path = upf_accel_ctx->upf_accel_cfg->session_ctrl_path;
+	const struct upf_accel_session_slot_ops ops = {0};
+	struct sockaddr_un addr = {.sun_family = AF_UNIX};
+	struct upf_accel_session_ctrl *ctrl;
+	doca_error_t result;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		DOCA_LOG_ERR("Session control socket path %s is too long", path);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+	strcpy(addr.sun_path, path);
+
+	ctrl = rte_zmalloc("UPF session control", sizeof(*ctrl), RTE_CACHE_LINE_SIZE);
+	if (!ctrl) {
+		DOCA_LOG_ERR("Failed to allocate session control");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+	ctrl->client_fd = -1;
+
+	ctrl->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (ctrl->listen_fd < 0) {
+		DOCA_LOG_ERR("Failed to create session control socket: %s", strerror(errno));
+		result = DOCA_ERROR_IO_FAILED;
+		goto free_ctrl;
+	}
+
+	unlink(path);
+	if (bind(ctrl->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) || listen(ctrl->listen_fd, 1)) {
+		DOCA_LOG_ERR("Failed to listen on session control socket %s: %s", path, strerror(errno));
+		result = DOCA_ERROR_IO_FAILED;
+		goto close_socket;
+	}
+
+	/* The PDRs of the SMF configuration file hold references on their rules too */
+	upf_accel_session_rules_refs_update(upf_accel_ctx->upf_accel_cfg, &ops);
+
+	upf_accel_ctx->session_ctrl = ctrl;
+	DOCA_LOG_INFO("Session control listening on %s", path);
+
+	return DOCA_SUCCESS;
+
+close_socket:
+	close(ctrl->listen_fd);
+free_ctrl:
+	rte_free(ctrl);
+	return result;
+}
+
+void upf_accel_session_ctrl_poll(struct upf_accel_ctx *upf_accel_ctx)
+{
+	struct upf_accel_session_ctrl *ctrl = upf_accel_ctx->session_ctrl;
+	char *line, *end;
+	ssize_t len;
+
+	if (!ctrl)
+		return;
+
+	if (ctrl->client_fd < 0) {
+		ctrl->client_fd = accept4(ctrl->listen_fd, NULL, NULL, SOCK_NONBLOCK);
+		if (ctrl->client_fd < 0)
+			return;
+		ctrl->buf_len = 0;
+		DOCA_LOG_INFO("Session control client connected");
+	}
+
+	while (ctrl->client_fd >= 0) {
+		len = recv(ctrl->client_fd, ctrl->buf + ctrl->buf_len, sizeof(ctrl->buf) - ctrl->buf_len - 1, 0);
+		if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return;
+		if (len <= 0) {
+			DOCA_LOG_INFO("Session control client disconnected");
+			close(ctrl->client_fd);
+			ctrl->client_fd = -1;
+			return;
+		}
+		ctrl->buf_len += len;
+		ctrl->buf[ctrl->buf_len] = '\0';
+
+		line = ctrl->buf;
+		while (ctrl->client_fd >= 0 && (end = strchr(line, '\n'))) {
+			*end = '\0';
+			upf_accel_session_msg_handle(upf_accel_ctx, line);
+			line = end + 1;
+		}
+
+		ctrl->buf_len -= line - ctrl->buf;
+		memmove(ctrl->buf, line, ctrl->buf_len);
+
+		if (ctrl->buf_len == sizeof(ctrl->buf) - 1) {
+			DOCA_LOG_ERR("Session message exceeds %d bytes, dropping the client", UPF_ACCEL_SESSION_MSG_MAX_LEN);
+			close(ctrl->client_fd);
+			ctrl->client_fd = -1;
+		}
+	}
+}
+
+void upf_accel_session_ctrl_counters_print(struct upf_accel_ctx *upf_accel_ctx)
+{
+	struct upf_accel_session_ctrl *ctrl = upf_accel_ctx->session_ctrl;
+	struct upf_accel_session_counters *counters;
+	uint64_t num_msgs;
+
+	if (!ctrl)
+		return;
+
+	counters = &ctrl->counters;
+	num_msgs = counters->establishments + counters->modifications + counters->deletions + counters->rejects;
+
+	DOCA_LOG_INFO("//////////////////// SESSION CONTROL COUNTERS ////////////////////");
+	DOCA_LOG_INFO("establishments=%-8lu modifications=%-8lu deletions=%-8lu rejects=%-8lu avg_apply_us=%-8lu",
+		      counters->establishments,
+		      counters->modifications,
+		      counters->deletions,
+		      counters->rejects,
+		      num_msgs ? counters->apply_tsc * US_PER_S / rte_get_tsc_hz() / num_msgs : 0);
+}
+
+void upf_accel_session_ctrl_destroy(struct upf_accel_ctx *upf_accel_ctx)
+{
+	struct upf_accel_session_ctrl *ctrl = upf_accel_ctx->session_ctrl;
+
+	if (!ctrl)
+		return;
+
+	if (ctrl->client_fd >= 0)
+		close(ctrl->client_fd);
+	close(ctrl->listen_fd);
+	unlink(upf_accel_ctx->upf_accel_cfg->session_ctrl_path);
+	rte_free(ctrl);
+	upf_accel_ctx->session_ctrl = NULL;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 NVIDIA CORPORATION AND AFFILIATES.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of
+ *       conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name of the NVIDIA CORPORATION nor the names of its contributors may be used
+ *       to endorse or promote products derived from this software without specific prior written
+ *       permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NVIDIA CORPORATION BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TOR (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPF_ACCEL_SESSION_H_
+#define UPF_ACCEL_SESSION_H_
+
+#include "upf_accel.h"
+
+/* Period the main thread serves the session control at, in milliseconds */
+#define UPF_ACCEL_SESSION_POLL_PERIOD_MS 10
+
+/*
+ * Session control
+ *
+ * The SMF (or a test client) connects to a UNIX stream socket and sends one JSON message per line:
+ *
+ *   {"type": "establishment" | "modification" | "deletion",
+ *    "seid": <session ID, non zero>,
+ *    "createPdr": [...], "createFar": [...], "createUrr": [...], "createQer": [...],
+ *    "updatePdr": [...], "updateFar": [...], "updateUrr": [...], "updateQer": [...],
+ *    "removePdr": [<PDR ID>, ...]}
+ *
+ * The rules have the same format as in the SMF configuration file. Every message is answered with a line holding
+ * {"seid": <session ID>, "cause": <PFCP cause>}.
+ */
+
+/* PFCP cause values (3GPP TS 29.244) used in the replies */
+enum upf_accel_session_cause {
+	UPF_ACCEL_SESSION_CAUSE_ACCEPTED = 1,
+	UPF_ACCEL_SESSION_CAUSE_REJECTED = 64,
+	UPF_ACCEL_SESSION_CAUSE_SESSION_NOT_FOUND = 65,
+	UPF_ACCEL_SESSION_CAUSE_MANDATORY_IE_MISSING = 66,
+	UPF_ACCEL_SESSION_CAUSE_RULE_FAILURE = 73,
+	UPF_ACCEL_SESSION_CAUSE_NO_RESOURCES = 75,
+};
+
+struct upf_accel_session_counters {
+	uint64_t establishments; /* Applied session establishments */
+	uint64_t modifications;	 /* Applied session modifications */
+	uint64_t deletions;	 /* Applied session deletions */
+	uint64_t rejects;	 /* Rejected messages */
+	uint64_t apply_tsc;	 /* Total TSC cycles spent applying messages */
+};
+
+/*
+ * Create the session control socket
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context, the control is stored in its session_ctrl field
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t upf_accel_session_ctrl_init(struct upf_accel_ctx *upf_accel_ctx);
+
+/*
+ * Handle the pending session control connections and messages, never blocks
+ *
+ * Must be called from the main thread, the one that owns the static HW entries.
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ */
+void upf_accel_session_ctrl_poll(struct upf_accel_ctx *upf_accel_ctx);
+
+/*
+ * Print the session control counters
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ */
+void upf_accel_session_ctrl_counters_print(struct upf_accel_ctx *upf_accel_ctx);
+
+/*
+ * Close the session control socket
+ *
+ * @upf_accel_ctx [in]: UPF Acceleration context
+ */
+void upf_accel_session_ctrl_destroy(struct upf_accel_ctx *upf_accel_ctx);
+
+#endif /* UPF_ACCEL_SESSION_H_ */
@@ -146,14 +146,18 @@ struct urom_worker_notify_rdmo {
 
 /* RDMO request flags */
 enum urom_rdmo_req_flags {
-	UROM_RDMO_REQ_FLAG_FENCE = 1 << 0, /* Complete outstanding ops on this connection before executing request */
+	UROM_RDMO_REQ_FLAG_FENCE = 1 << 0,     /* Complete outstanding ops on this connection before executing it */
+	UROM_RDMO_REQ_FLAG_IOV_LEN32 = 1 << 1, /* Scatter payload uses struct urom_rdmo_scatter_iov32 */
+	UROM_RDMO_REQ_FLAG_DOMAIN = 1 << 2,    /* Order request only within its domain, see urom_rdmo_domain_hdr */
 };
 
 /* RDMO operations id */
 enum urom_rdmo_op_id {
-	UROM_RDMO_OP_FLUSH,   /* RDMO flush operation */
-	UROM_RDMO_OP_APPEND,  /* RDMO append operation */
-	UROM_RDMO_OP_SCATTER, /* RDMO scatter operation */
+	UROM_RDMO_OP_FLUSH,	 /* RDMO flush operation */
+	UROM_RDMO_OP_APPEND,	 /* RDMO append operation */
+	UROM_RDMO_OP_SCATTER,	 /* RDMO scatter operation */
+	UROM_RDMO_OP_GATHER,	 /* RDMO gather operation */
+	UROM_RDMO_OP_ACCUMULATE, /* RDMO accumulate operation */
 };
 
 /* RDMO header structure */
@@ -163,6 +167,20 @@ struct urom_rdmo_hdr {
 	uint32_t flags; /* operation flag */
 };
 
+/*
+ * RDMO ordering domain header, appended after the operation header when UROM_RDMO_REQ_FLAG_DOMAIN is set
+ *
+ * Requests of a client that share a domain key execute one at a time in arrival order. Requests in
+ * different domains run concurrently. Domain appends still wait while an append fetches an uncached
+ * pointer, whatever the domain of either, so pointer cache misses stay serialized. Once an EP fence
+ * such as flush is queued, new domain requests on that EP queue behind it, and the fence waits for
+ * every outstanding request. A failed request releases its domain like a completed one. A natural key
+ * is the target address, for example the append pointer.
+ */
+struct urom_rdmo_domain_hdr {
+	uint64_t key; /* Domain key */
+};
+
 /* RDMO flush header structure */
 struct urom_rdmo_flush_hdr {
 	uint64_t flush_id; /* Flush id */
@@ -184,6 +202,9 @@ struct urom_rdmo_scatter_hdr {
  * IOVs are packed into the Scatter request payload, descriptor followed by data:
  *
  *    | iov 0 | data | iov 1 | data | iov 2 | data |
+ *
+ * IOVs that are contiguous in target memory under the same rkey are written with a single Put,
+ * so senders should keep neighboring IOVs next to each other in the payload.
  */
 struct urom_rdmo_scatter_iov {
 	uint64_t addr; /* Scattered data address */
@@ -191,9 +212,58 @@ struct urom_rdmo_scatter_iov {
 	uint16_t len;  /* Data length */
 };
 
+/* Scatter IOV with 32-bit length, used when the request has UROM_RDMO_REQ_FLAG_IOV_LEN32 set */
+struct urom_rdmo_scatter_iov32 {
+	uint64_t addr; /* Scattered data address */
+	uint64_t rkey; /* Data remote key */
+	uint32_t len;  /* Data length */
+};
+
+/* RDMO gather header structure */
+struct urom_rdmo_gather_hdr {
+	uint64_t gather_id; /* Gather id, echoed back in the response */
+	uint64_t count;	    /* Number of IOVs in the payload */
+};
+
+/*
+ * IOVs are packed back to back into the Gather request payload:
+ *
+ *    | iov 0 | iov 1 | iov 2 |
+ *
+ * The response payload holds the data of all IOVs in request order:
+ *
+ *    | data 0 | data 1 | data 2 |
+ */
+struct urom_rdmo_gather_iov {
+	uint64_t addr; /* Gathered data address */
+	uint64_t rkey; /* Data remote key */
+	uint16_t len;  /* Data length */
+};
+
+/* RDMO accumulate header structure */
+struct urom_rdmo_accumulate_hdr {
+	uint64_t count; /* Number of IOVs in the payload */
+};
+
+/*
+ * IOVs are packed into the Accumulate request payload, descriptor followed by operands:
+ *
+ *    | iov 0 | operands | iov 1 | operands |
+ *
+ * Operand i is atomically added to the integer at addr + i * width. Atomicity is per operand,
+ * a concurrent reader may observe part of a vector applied.
+ */
+struct urom_rdmo_accumulate_iov {
+	uint64_t addr;	/* Target integers address, aligned to width */
+	uint64_t rkey;	/* Target remote key */
+	uint32_t count; /* Number of operands */
+	uint32_t width; /* Operand width in bytes, 4 or 8 */
+};
+
 /* RDMO response id */
 enum urom_rdmo_rsp_id {
-	UROM_RDMO_RSP_FLUSH, /* RDMO flush response id */
+	UROM_RDMO_RSP_FLUSH,  /* RDMO flush response id */
+	UROM_RDMO_RSP_GATHER, /* RDMO gather response id */
 };
 
 /* RDMO response header */
@@ -206,6 +276,13 @@ struct urom_rdmo_flush_rsp_hdr {
 	uint64_t flush_id; /* Flush id */
 };
 
+/* RDMO gather response header, gathered data is carried in the response payload */
+struct urom_rdmo_gather_rsp_hdr {
+	uint64_t gather_id; /* Gather id */
+	uint64_t length;    /* Total gathered data length, 0 if the gather failed */
+	uint32_t status;    /* DOCA_SUCCESS, or the doca_error_t the gather failed with, no data is carried then */
+};
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -62,6 +62,7 @@ static ucs_status_t urom_worker_rdmo_am_cb(void *ctx,
 	struct urom_worker_rdmo_ep *ep;
 	struct urom_worker_rdmo_req *req;
 	struct urom_worker_rdmo_client *client;
+	const struct urom_rdmo_domain_hdr *domain_hdr;
 	struct urom_rdmo_hdr *rdmo_hdr = (struct urom_rdmo_hdr *)header;
 	struct urom_worker_rdmo *rdmo_worker = (struct urom_worker_rdmo *)ctx;
 
@@ -79,7 +80,7 @@ static ucs_status_t urom_worker_rdmo_am_cb(void *ctx,
 	}
 
 	ep = kh_value(rdmo_worker->eps, k);
-	if (rdmo_hdr->op_id > UROM_RDMO_OP_SCATTER) {
+	if (rdmo_hdr->op_id > UROM_RDMO_OP_ACCUMULATE) {
 		DOCA_LOG_ERR("Invalid op_id: %d", rdmo_hdr->op_id);
 		return UCS_OK;
 	}
@@ -102,8 +103,24 @@ static ucs_status_t urom_worker_rdmo_am_cb(void *ctx,
 	if (req->ops == NULL || req->ops->progress == NULL)
 		return UCS_ERR_NO_RESOURCE;
 
+	if (rdmo_hdr->flags & UROM_RDMO_REQ_FLAG_DOMAIN) {
+		if (header_length < sizeof(*rdmo_hdr) + sizeof(*domain_hdr)) {
+			ucs_mpool_put(req);
+			return UCS_ERR_INVALID_PARAM;
+		}
+
+		/* Domain header trails the operation header */
+		domain_hdr = UCS_PTR_BYTE_OFFSET(req->header, header_length - sizeof(*domain_hdr));
+		status = urom_worker_rdmo_domain_get(client, domain_hdr->key, &req->domain);
+		if (status != DOCA_SUCCESS) {
+			ucs_mpool_put(req);
+			return UCS_ERR_NO_MEMORY;
+		}
+	}
+
+	/* A failed request was already completed, its AM data is released like that of a successful one */
 	status = urom_worker_rdmo_req_queue(req);
-	if (status == DOCA_SUCCESS)
+	if (status != DOCA_ERROR_IN_PROGRESS)
 		return UCS_OK;
 	return UCS_INPROGRESS;
 }
@@ -120,6 +137,12 @@ static void urom_worker_rdmo_close(struct urom_worker_ctx *worker_ctx)
 	if (rdmo_worker == NULL)
 		return;
 
+	DOCA_LOG_INFO("Scatter stats: %lu requests, %lu IOVs, %lu puts, %lu bytes",
+		      rdmo_worker->scatter_stats.reqs,
+		      rdmo_worker->scatter_stats.iovs,
+		      rdmo_worker->scatter_stats.puts,
+		      rdmo_worker->scatter_stats.bytes);
+
 	kh_destroy(ep, rdmo_worker->eps);
 	kh_destroy(client, rdmo_worker->clients);
 	ucs_mpool_cleanup(&rdmo_worker->req_mp, 0);
@@ -169,7 +192,8 @@ static doca_error_t urom_worker_rdmo_open(struct urom_worker_ctx *ctx)
 	}
 
 	ucp_params.field_mask = UCP_PARAM_FIELD_FEATURES;
-	ucp_params.features = UCP_FEATURE_AM | UCP_FEATURE_RMA | UCP_FEATURE_AMO64 | UCP_FEATURE_EXPORTED_MEMH;
+	ucp_params.features = UCP_FEATURE_AM | UCP_FEATURE_RMA | UCP_FEATURE_AMO32 | UCP_FEATURE_AMO64 |
+			      UCP_FEATURE_EXPORTED_MEMH;
 	ucp_params.features |= UCP_FEATURE_WAKEUP;
 	status = ucp_init(&ucp_params, ucp_config, &ucp_context);
 	ucp_config_release(ucp_config);
@@ -401,10 +425,16 @@ static doca_error_t urom_worker_rdmo_client_init_cmd(struct urom_worker_rdmo *rd
 		goto mkeys_destroy;
 	}
 
+	client->domains = kh_init(domain);
+	if (client->domains == NULL) {
+		status = DOCA_ERROR_INITIALIZATION;
+		goto rqs_destroy;
+	}
+
 	k = kh_put(client, rdmo_worker->clients, client->id, &ret);
 	if (ret <= 0) {
 		status = DOCA_ERROR_DRIVER;
-		goto rqs_destroy;
+		goto domains_destroy;
 	}
 	kh_value(rdmo_worker->clients, k) = client;
 
@@ -415,6 +445,8 @@ static doca_error_t urom_worker_rdmo_client_init_cmd(struct urom_worker_rdmo *rd
 
 	return DOCA_SUCCESS;
 
+domains_destroy:
+	kh_destroy(domain, client->domains);
 rqs_destroy:
 	kh_destroy(rq, client->rqs);
 mkeys_destroy:
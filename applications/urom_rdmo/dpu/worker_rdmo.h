@@ -83,6 +83,16 @@ struct urom_worker_rdmo_mkey {
 /* Init RDMO mkey map */
 KHASH_MAP_INIT_INT64(mkey, struct urom_worker_rdmo_mkey *);
 
+/* RDMO ordering domain structure */
+struct urom_worker_rdmo_domain {
+	uint64_t key;		    /* Domain key */
+	ucs_list_link_t queued_ops; /* Requests waiting for the running one */
+	int oreqs;		    /* Started and not yet completed requests, at most one */
+};
+
+/* Init RDMO ordering domains map */
+KHASH_MAP_INIT_INT64(domain, struct urom_worker_rdmo_domain *);
+
 /* RDMO client structure */
 struct urom_worker_rdmo_client {
 	struct urom_worker_rdmo *rdmo_worker; /* RDMO worker context */
@@ -93,6 +103,7 @@ struct urom_worker_rdmo_client {
 	uint64_t next_rq_id;		      /* Next request id */
 	khash_t(mkey) * mkeys;		      /* Registered memory regions */
 	ucs_list_link_t paused_ops;	      /* Paused operations list */
+	khash_t(domain) * domains;	      /* Active ordering domains */
 	int pause;			      /* If client is paused */
 	uint64_t get_result;		      /* Client result */
 };
@@ -114,31 +125,55 @@ struct urom_worker_rdmo_req {
 	struct urom_worker_rdmo_client *client; /* RDMO client */
 	struct urom_worker_rdmo_ep *ep;		/* RDMO endpoint */
 	/* AM */
-	uint8_t header[UROM_RDMO_HDR_LEN_MAX]; /* RDMO header data */
-	void *data;			       /* RDMO data */
-	uint64_t length;		       /* RDMO data length */
-	ucp_am_recv_param_t param;	       /* UCP recv parameters */
-	struct urom_worker_rdmo_req_ops *ops;  /* RDMO ops */
-	uint64_t ctx[4];		       /* Request context */
+	uint8_t header[UROM_RDMO_HDR_LEN_MAX];	/* RDMO header data */
+	void *data;				/* RDMO data */
+	uint64_t length;			/* RDMO data length */
+	ucp_am_recv_param_t param;		/* UCP recv parameters */
+	struct urom_worker_rdmo_req_ops *ops;	/* RDMO ops */
+	struct urom_worker_rdmo_domain *domain; /* Ordering domain, NULL if ordered by client pause */
+	uint64_t ctx[4];			/* Request context */
+	doca_error_t result;			/* First error, reported once the pending operations complete */
+};
+
+/* RDMO scatter statistics structure */
+struct urom_worker_rdmo_scatter_stats {
+	uint64_t reqs;	/* Scatter requests */
+	uint64_t iovs;	/* Scatter IOVs received */
+	uint64_t puts;	/* Puts and shared memory copies issued after coalescing */
+	uint64_t bytes; /* Bytes scattered */
 };
 
 /* UROM RDMO worker context structure */
 struct urom_worker_rdmo {
-	struct ucp_data ucp_data;	/* UCP data structure */
-	ucs_mpool_t req_mp;		/* Requests memory map */
-	khash_t(client) * clients;	/* local client connections */
-	khash_t(ep) * eps;		/* Peer endpoints */
-	ucs_list_link_t completed_reqs; /* RDMO worker commands completion list */
+	struct ucp_data ucp_data;			     /* UCP data structure */
+	ucs_mpool_t req_mp;				     /* Requests memory map */
+	khash_t(client) * clients;			     /* local client connections */
+	khash_t(ep) * eps;				     /* Peer endpoints */
+	ucs_list_link_t completed_reqs;			     /* RDMO worker commands completion list */
+	struct urom_worker_rdmo_scatter_stats scatter_stats; /* Scatter statistics */
 };
 
 /* RDMO worker requests operations */
 extern struct urom_worker_rdmo_req_ops *urom_worker_rdmo_ops_table[];
 
+/*
+ * Get the client ordering domain of a key, creating it on first use
+ *
+ * @client [in]: RDMO client
+ * @key [in]: domain key
+ * @domain [out]: RDMO ordering domain
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+doca_error_t urom_worker_rdmo_domain_get(struct urom_worker_rdmo_client *client,
+					 uint64_t key,
+					 struct urom_worker_rdmo_domain **domain);
+
 /*
  * Handle request in client RDMO queue
  *
  * @req [in]: Client RDMO request
- * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ * @return: DOCA_ERROR_IN_PROGRESS if the request is queued or in flight, otherwise the request was completed and
+ * freed, with DOCA_SUCCESS or the DOCA_ERROR it failed with
  */
 doca_error_t urom_worker_rdmo_req_queue(struct urom_worker_rdmo_req *req);
 
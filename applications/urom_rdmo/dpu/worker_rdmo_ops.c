@@ -220,6 +220,8 @@ static doca_error_t urom_worker_rdmo_mem_cache_flush(struct urom_worker_rdmo_cli
 static void urom_worker_rdmo_req_free(struct urom_worker_rdmo_req *req)
 {
 	req->ep->oreqs--;
+	if (req->domain != NULL)
+		req->domain->oreqs--;
 	ucs_mpool_put(req);
 }
 
@@ -236,9 +238,26 @@ static void urom_worker_rdmo_req_free_data(struct urom_worker_rdmo_req *req)
 		ucp_am_data_release(rdmo_worker->ucp_data.ucp_worker, req->data);
 }
 
+/*
+ * Log a request that ran to completion with an error
+ *
+ * Failed requests are completed like successful ones, so they release their EP and domain slots
+ *
+ * @req [in]: RDMO request
+ * @status [in]: request status, anything but DOCA_ERROR_IN_PROGRESS
+ */
+static void urom_worker_rdmo_req_log_status(struct urom_worker_rdmo_req *req, doca_error_t status)
+{
+	if (status != DOCA_SUCCESS)
+		DOCA_LOG_ERR("RDMO request %p failed: %s", req, doca_error_get_descr(status));
+}
+
 /*
  * Launch RDMO request
  *
+ * Domain appends wait for the client pause taken by a pointer cache miss, as other appends do. Every request,
+ * domain or not, queues behind a pending EP fence
+ *
  * @req [in]: RDMO request
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
@@ -246,9 +265,16 @@ static doca_error_t urom_worker_rdmo_req_start(struct urom_worker_rdmo_req *req)
 {
 	struct urom_worker_rdmo_ep *ep = req->ep;
 	struct urom_rdmo_hdr *rdmo_hdr = (struct urom_rdmo_hdr *)req->header;
+	int fence = !!(rdmo_hdr->flags & UROM_RDMO_REQ_FLAG_FENCE);
 	doca_error_t status;
 
-	if (!ucs_list_is_empty(&ep->fenced_ops) || (rdmo_hdr->flags & UROM_RDMO_REQ_FLAG_FENCE && ep->oreqs)) {
+	if (req->domain != NULL && rdmo_hdr->op_id == UROM_RDMO_OP_APPEND && req->client->pause) {
+		DOCA_LOG_DBG("New paused domain request: %p", req);
+		ucs_list_add_tail(&req->client->paused_ops, &req->entry);
+		return DOCA_ERROR_IN_PROGRESS;
+	}
+
+	if (!ucs_list_is_empty(&ep->fenced_ops) || (fence && ep->oreqs)) {
 		DOCA_LOG_DBG("New fenced request: %p", req);
 		ucs_list_add_tail(&ep->fenced_ops, &req->entry);
 		return DOCA_ERROR_IN_PROGRESS;
@@ -260,6 +286,42 @@ static doca_error_t urom_worker_rdmo_req_start(struct urom_worker_rdmo_req *req)
 	return status;
 }
 
+/*
+ * Start the next queued request of an ordering domain, and free the domain once it is idle
+ *
+ * @client [in]: RDMO client owning the domain
+ * @domain [in]: RDMO ordering domain
+ */
+static void urom_worker_rdmo_check_domain(struct urom_worker_rdmo_client *client,
+					  struct urom_worker_rdmo_domain *domain)
+{
+	struct urom_worker_rdmo_req *req;
+	doca_error_t status;
+	khint_t k;
+
+	while (!domain->oreqs && !ucs_list_is_empty(&domain->queued_ops)) {
+		req = ucs_list_extract_head(&domain->queued_ops, struct urom_worker_rdmo_req, entry);
+
+		DOCA_LOG_DBG("Starting domain %#lx req: %p", domain->key, req);
+
+		domain->oreqs++;
+		status = urom_worker_rdmo_req_start(req);
+		if (status != DOCA_ERROR_IN_PROGRESS) {
+			urom_worker_rdmo_req_log_status(req, status);
+			urom_worker_rdmo_req_free_data(req);
+			urom_worker_rdmo_req_free(req);
+		}
+	}
+
+	if (domain->oreqs || !ucs_list_is_empty(&domain->queued_ops))
+		return;
+
+	k = kh_get(domain, client->domains, domain->key);
+	if (k != kh_end(client->domains))
+		kh_del(domain, client->domains, k);
+	free(domain);
+}
+
 /*
  * Check if fence operation is required for the end-point
  *
@@ -268,6 +330,8 @@ static doca_error_t urom_worker_rdmo_req_start(struct urom_worker_rdmo_req *req)
 static void urom_worker_rdmo_check_fenced(struct urom_worker_rdmo_ep *ep)
 {
 	struct urom_worker_rdmo_req *req;
+	struct urom_worker_rdmo_client *client;
+	struct urom_worker_rdmo_domain *domain;
 	const struct urom_rdmo_hdr *rdmo_hdr;
 	doca_error_t status;
 
@@ -289,9 +353,14 @@ static void urom_worker_rdmo_check_fenced(struct urom_worker_rdmo_ep *ep)
 		DOCA_LOG_DBG("Starting req: %p", req);
 		ep->oreqs++;
 		status = req->ops->progress(req);
-		if (status == DOCA_SUCCESS) {
+		if (status != DOCA_ERROR_IN_PROGRESS) {
+			client = req->client;
+			domain = req->domain;
+			urom_worker_rdmo_req_log_status(req, status);
 			urom_worker_rdmo_req_free_data(req);
 			urom_worker_rdmo_req_free(req);
+			if (domain != NULL)
+				urom_worker_rdmo_check_domain(client, domain);
 		}
 	}
 }
@@ -304,6 +373,7 @@ static void urom_worker_rdmo_check_fenced(struct urom_worker_rdmo_ep *ep)
 static void urom_worker_rdmo_check_paused(struct urom_worker_rdmo_client *client)
 {
 	struct urom_worker_rdmo_req *req;
+	struct urom_worker_rdmo_domain *domain;
 	doca_error_t status;
 
 	if (client->pause || ucs_list_is_empty(&client->paused_ops))
@@ -316,9 +386,13 @@ static void urom_worker_rdmo_check_paused(struct urom_worker_rdmo_client *client
 		DOCA_LOG_DBG("Starting req: %p", req);
 
 		status = urom_worker_rdmo_req_start(req);
-		if (status == DOCA_SUCCESS) {
+		if (status != DOCA_ERROR_IN_PROGRESS) {
+			domain = req->domain;
+			urom_worker_rdmo_req_log_status(req, status);
 			urom_worker_rdmo_req_free_data(req);
 			urom_worker_rdmo_req_free(req);
+			if (domain != NULL)
+				urom_worker_rdmo_check_domain(client, domain);
 		}
 	}
 }
@@ -330,9 +404,15 @@ static void urom_worker_rdmo_check_paused(struct urom_worker_rdmo_client *client
  */
 static void urom_worker_rdmo_req_complete(struct urom_worker_rdmo_req *req)
 {
+	struct urom_worker_rdmo_client *client = req->client;
+	struct urom_worker_rdmo_domain *domain = req->domain;
+	struct urom_worker_rdmo_ep *ep = req->ep;
+
 	urom_worker_rdmo_req_free(req);
-	urom_worker_rdmo_check_paused(req->client);
-	urom_worker_rdmo_check_fenced(req->ep);
+	if (domain != NULL)
+		urom_worker_rdmo_check_domain(client, domain);
+	urom_worker_rdmo_check_paused(client);
+	urom_worker_rdmo_check_fenced(ep);
 }
 
 /*
@@ -350,7 +430,8 @@ static void urom_worker_rdmo_op_cb(void *request, ucs_status_t ucs_status, void
 	struct urom_worker_rdmo_req *req = (struct urom_worker_rdmo_req *)user_data;
 
 	status = req->ops->progress(req);
-	if (status == DOCA_SUCCESS) {
+	if (status != DOCA_ERROR_IN_PROGRESS) {
+		urom_worker_rdmo_req_log_status(req, status);
 		urom_worker_rdmo_req_free_data(req);
 		urom_worker_rdmo_req_complete(req);
 	}
@@ -385,13 +466,13 @@ static void urom_worker_rdmo_am_recv_data_cb(void *request, ucs_status_t ucs_sta
 }
 
 /*
- * RDMO scatter operation callback
+ * RDMO IOV operation callback, used by the scatter, gather and accumulate operations
  *
- * @request [in]: scatter request
+ * @request [in]: IOV request
  * @ucs_status [in]: operation status
  * @user_data [in]: user data
  */
-static void urom_worker_rdmo_scatter_op_send_cb(void *request, ucs_status_t ucs_status, void *user_data)
+static void urom_worker_rdmo_iov_op_send_cb(void *request, ucs_status_t ucs_status, void *user_data)
 {
 	struct urom_worker_rdmo_req *req __attribute__((unused)) = (struct urom_worker_rdmo_req *)user_data;
 
@@ -400,6 +481,45 @@ static void urom_worker_rdmo_scatter_op_send_cb(void *request, ucs_status_t ucs_
 	urom_worker_rdmo_op_cb(request, ucs_status, user_data);
 }
 
+/*
+ * Look up the client memory region that holds an IOV
+ *
+ * @client [in]: RDMO client
+ * @rkey [in]: IOV remote key
+ * @addr [in]: IOV address
+ * @len [in]: IOV length
+ * @rdmo_mkey [out]: memory region holding the IOV
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t urom_worker_rdmo_iov_mkey_get(struct urom_worker_rdmo_client *client,
+						  uint64_t rkey,
+						  uint64_t addr,
+						  uint64_t len,
+						  struct urom_worker_rdmo_mkey **rdmo_mkey)
+{
+	struct urom_worker_rdmo_mkey *iov_mkey;
+	khint_t k;
+
+	k = kh_get(mkey, client->mkeys, rkey);
+	if (k == kh_end(client->mkeys)) {
+		DOCA_LOG_ERR("Unknown rkey: %lu", rkey);
+		return DOCA_ERROR_NOT_FOUND;
+	}
+
+	iov_mkey = kh_value(client->mkeys, k);
+	if (addr < iov_mkey->va || (addr + len) > (iov_mkey->va + iov_mkey->len)) {
+		DOCA_LOG_ERR("IOV out of bounds: %#lx-%#lx mkey: %#lx-%#lx",
+			     addr,
+			     addr + len,
+			     iov_mkey->va,
+			     iov_mkey->va + iov_mkey->len);
+		return DOCA_ERROR_UNEXPECTED;
+	}
+
+	*rdmo_mkey = iov_mkey;
+	return DOCA_SUCCESS;
+}
+
 /*
  * Progress function for flush operations
  *
@@ -547,7 +667,8 @@ static doca_error_t urom_worker_rdmo_append_progress(struct urom_worker_rdmo_req
 			DOCA_LOG_DBG("Initiated Get, req: %p", req);
 			req->ctx[0] = 1; /* Next: cache update */
 
-			req->client->pause = 1; /* Prevent concurrent AMOs */
+			/* Prevent concurrent AMOs, appends of every domain wait for the pointer cache update */
+			req->client->pause = 1;
 
 			return DOCA_ERROR_IN_PROGRESS;
 		}
@@ -556,11 +677,11 @@ static doca_error_t urom_worker_rdmo_append_progress(struct urom_worker_rdmo_req
 	if (req->ctx[0] == 1) {
 		/* Stage 2: update cache */
 		rdmo_mkey = (struct urom_worker_rdmo_mkey *)req->ctx[2];
+		req->client->pause = 0;
 		result = urom_worker_rdmo_mem_cache_put(rdmo_mkey, append_hdr->ptr_addr, req->ctx[1] + req->length);
 		if (result != DOCA_SUCCESS)
 			return result;
 		req->ctx[0] = 2; /* Next: put */
-		req->client->pause = 0;
 	}
 
 	if (req->ctx[0] == 2) {
@@ -668,9 +789,198 @@ static struct urom_worker_rdmo_req_ops urom_worker_rdmo_append_ops = {
 	.progress = urom_worker_rdmo_append_progress,
 };
 
+/* Run of scatter IOVs contiguous in target memory under one rkey, written with a single Put */
+struct urom_worker_rdmo_scatter_run {
+	uint64_t addr;	    /* Run target address */
+	uint64_t rkey;	    /* Run remote key */
+	uint64_t len;	    /* Run length */
+	const void *data;   /* Run data, in the request payload or in the staging buffer once merged */
+	uint64_t niovs;	    /* Number of IOVs merged into the run */
+	uint64_t stage_off; /* Offset of the run in the staging buffer */
+};
+
+/*
+ * Decode the next scatter IOV from the request payload
+ *
+ * @cursor [in/out]: current position in the payload, advanced past the IOV data
+ * @end [in]: end of the payload
+ * @len32 [in]: if the payload uses 32-bit IOV lengths
+ * @iov [out]: decoded IOV as a single IOV run, data points into the payload
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t urom_worker_rdmo_scatter_iov_next(const uint8_t **cursor,
+						      const uint8_t *end,
+						      int len32,
+						      struct urom_worker_rdmo_scatter_run *iov)
+{
+	const struct urom_rdmo_scatter_iov32 *iov32;
+	const struct urom_rdmo_scatter_iov *iov16;
+
+	if (len32) {
+		iov32 = (const struct urom_rdmo_scatter_iov32 *)*cursor;
+		if ((const uint8_t *)(iov32 + 1) > end)
+			return DOCA_ERROR_INVALID_VALUE;
+		iov->addr = iov32->addr;
+		iov->rkey = iov32->rkey;
+		iov->len = iov32->len;
+		iov->data = iov32 + 1;
+	} else {
+		iov16 = (const struct urom_rdmo_scatter_iov *)*cursor;
+		if ((const uint8_t *)(iov16 + 1) > end)
+			return DOCA_ERROR_INVALID_VALUE;
+		iov->addr = iov16->addr;
+		iov->rkey = iov16->rkey;
+		iov->len = iov16->len;
+		iov->data = iov16 + 1;
+	}
+
+	if ((const uint8_t *)iov->data + iov->len > end)
+		return DOCA_ERROR_INVALID_VALUE;
+
+	iov->niovs = 1;
+	*cursor = (const uint8_t *)iov->data + iov->len;
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Write a scatter run to target memory
+ *
+ * @req [in]: RDMO request
+ * @run [in]: scatter run
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t urom_worker_rdmo_scatter_run_put(struct urom_worker_rdmo_req *req,
+						     const struct urom_worker_rdmo_scatter_run *run)
+{
+	struct urom_worker_rdmo_scatter_stats *stats = &req->client->rdmo_worker->scatter_stats;
+	ucs_status_ptr_t ucs_status_ptr;
+	ucp_request_param_t req_param;
+	struct urom_worker_rdmo_mkey *rdmo_mkey;
+	void *sm_addr;
+	doca_error_t result;
+
+	result = urom_worker_rdmo_iov_mkey_get(req->client, run->rkey, run->addr, run->len, &rdmo_mkey);
+	if (result != DOCA_SUCCESS)
+		return result;
+
+	stats->puts++;
+	stats->bytes += run->len;
+
+	if (ucp_rkey_ptr(rdmo_mkey->ucp_rkey, run->addr, &sm_addr) == UCS_OK) {
+		/* Buffer is in shared memory between client and urom_worker */
+		memcpy(sm_addr, run->data, run->len);
+		DOCA_LOG_DBG("Completed copy of %lu IOVs, req: %p", run->niovs, req);
+		return DOCA_SUCCESS;
+	}
+
+	memset(&req_param, 0, sizeof(req_param));
+	req_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+	req_param.cb.send = urom_worker_rdmo_iov_op_send_cb;
+	req_param.user_data = req;
+
+	ucs_status_ptr =
+		ucp_put_nbx(req->client->ep->ep, run->data, run->len, run->addr, rdmo_mkey->ucp_rkey, &req_param);
+	if (UCS_PTR_IS_ERR(ucs_status_ptr))
+		return DOCA_ERROR_DRIVER;
+
+	if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+		DOCA_LOG_DBG("Initiated Put of %lu IOVs to: %#lx len: %lu req %p",
+			     run->niovs,
+			     run->addr,
+			     run->len,
+			     req);
+		req->ctx[1]++; /* Pending completion */
+	} else {
+		DOCA_LOG_DBG("Completed Scatter Put, req: %p", req);
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Issue the Puts of a scatter request, merging IOVs that are contiguous in target memory
+ *
+ * Put sources must be contiguous, so the data of merged IOVs is copied into a staging buffer.
+ * The staging buffer is sized by the payload, which bounds the data of all IOVs, and kept in ctx[2].
+ *
+ * @req [in]: RDMO request
+ * @payload [in]: scatter payload, req->data or the local copy of a rendezvous payload
+ * @count [in]: number of IOVs in the payload
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t urom_worker_rdmo_scatter_issue(struct urom_worker_rdmo_req *req,
+						   const void *payload,
+						   uint64_t count)
+{
+	const struct urom_rdmo_hdr *rdmo_hdr = (const struct urom_rdmo_hdr *)req->header;
+	int len32 = !!(rdmo_hdr->flags & UROM_RDMO_REQ_FLAG_IOV_LEN32);
+	const uint8_t *cursor = (const uint8_t *)payload;
+	const uint8_t *end = cursor + req->length;
+	struct urom_worker_rdmo_scatter_run run = {0};
+	struct urom_worker_rdmo_scatter_run iov;
+	uint64_t stage_off = 0;
+	uint8_t *stage;
+	doca_error_t result;
+	uint64_t i;
+
+	req->client->rdmo_worker->scatter_stats.reqs++;
+	req->client->rdmo_worker->scatter_stats.iovs += count;
+
+	for (i = 0; i < count; i++) {
+		result = urom_worker_rdmo_scatter_iov_next(&cursor, end, len32, &iov);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Scatter payload too short for %lu IOVs", count);
+			return result;
+		}
+
+		if (i > 0 && iov.rkey == run.rkey && iov.addr == run.addr + run.len) {
+			/* Contiguous with the current run, stage both so they go out as one Put */
+			stage = (uint8_t *)req->ctx[2];
+			if (stage == NULL) {
+				stage = malloc(req->length);
+				if (stage == NULL) {
+					DOCA_LOG_ERR("Failed to allocate scatter staging buffer");
+					return DOCA_ERROR_NO_MEMORY;
+				}
+				req->ctx[2] = (uint64_t)stage;
+			}
+
+			if (run.niovs == 1) {
+				run.stage_off = stage_off;
+				memcpy(stage + run.stage_off, run.data, run.len);
+				run.data = stage + run.stage_off;
+				stage_off += run.len;
+			}
+
+			memcpy(stage + stage_off, iov.data, iov.len);
+			stage_off += iov.len;
+			run.len += iov.len;
+			run.niovs++;
+			continue;
+		}
+
+		if (i > 0) {
+			result = urom_worker_rdmo_scatter_run_put(req, &run);
+			if (result != DOCA_SUCCESS)
+				return result;
+		}
+
+		run = iov;
+	}
+
+	if (count > 0)
+		return urom_worker_rdmo_scatter_run_put(req, &run);
+
+	return DOCA_SUCCESS;
+}
+
 /*
  * Progress function for scatter operations
  *
+ * Request context: ctx[0] stage, ctx[1] pending Puts, ctx[2] staging buffer, ctx[3] rendezvous payload.
+ * On failure no more Puts are issued, both buffers are released once the Puts already in flight complete.
+ *
  * @req [in]: RDMO request
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
@@ -680,83 +990,437 @@ static doca_error_t urom_worker_rdmo_scatter_progress(struct urom_worker_rdmo_re
 	ucp_request_param_t req_param;
 	const struct urom_rdmo_hdr *rdmo_hdr = (const struct urom_rdmo_hdr *)req->header;
 	const struct urom_rdmo_scatter_hdr *scatter_hdr = (struct urom_rdmo_scatter_hdr *)(rdmo_hdr + 1);
-	khint_t k;
-	uint64_t prev_rkey = UINT64_MAX;
-	struct urom_worker_rdmo_mkey *rdmo_mkey = NULL;
-	ucp_rkey_h ucp_rkey = NULL;
-	uint64_t *sm_addr;
-	struct urom_rdmo_scatter_iov *iov;
-	void *iov_data;
+	void *payload;
+
+	if (req->ctx[0] == 0) {
+		req->ctx[0] = 1;
+
+		if (req->param.recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
+			/* Stage 1: large payloads arrive by rendezvous, pull them into a local buffer */
+			payload = malloc(req->length);
+			if (payload == NULL) {
+				DOCA_LOG_ERR("Failed to allocate rendezvous scatter payload of %lu bytes", req->length);
+				return DOCA_ERROR_NO_MEMORY;
+			}
+			req->ctx[3] = (uint64_t)payload;
+
+			memset(&req_param, 0, sizeof(req_param));
+			req_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+			req_param.cb.recv_am = urom_worker_rdmo_am_recv_data_cb;
+			req_param.user_data = req;
+
+			ucs_status_ptr = ucp_am_recv_data_nbx(req->client->rdmo_worker->ucp_data.ucp_worker,
+							      req->data,
+							      payload,
+							      req->length,
+							      &req_param);
+			if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+				DOCA_LOG_DBG("Initiated scatter payload receive, len: %lu req %p", req->length, req);
+				return DOCA_ERROR_IN_PROGRESS;
+			}
+			if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK) {
+				req->result = DOCA_ERROR_DRIVER;
+				req->ctx[0] = 2;
+			}
+		}
+	}
+
+	if (req->ctx[0] == 1) {
+		/* Stage 2: Do Puts */
+		payload = req->ctx[3] ? (void *)req->ctx[3] : req->data;
+		req->result = urom_worker_rdmo_scatter_issue(req, payload, scatter_hdr->count);
+
+		/* all sends issued, or issuing stopped at the first failure */
+		req->ctx[0] = 2;
+	}
+
+	if (req->ctx[0] == 2) {
+		/* Stage 3: Wait for all completions */
+		if (req->ctx[1])
+			return DOCA_ERROR_IN_PROGRESS;
+	}
+
+	free((void *)req->ctx[2]);
+	free((void *)req->ctx[3]);
+	req->ctx[2] = 0;
+	req->ctx[3] = 0;
+
+	if (req->result != DOCA_SUCCESS)
+		return req->result;
+
+	DOCA_LOG_DBG("Completed Scatter request: %p", req);
+
+	return DOCA_SUCCESS;
+}
+
+/* RDMO scatter operations */
+static struct urom_worker_rdmo_req_ops urom_worker_rdmo_scatter_ops = {
+	.progress = urom_worker_rdmo_scatter_progress,
+};
+
+/*
+ * Validate a gather request, allocate its response and issue the Gets into the response payload
+ *
+ * A failed Get only stops issuing and is recorded in the request result, the Gets already in flight still
+ * write into the response.
+ *
+ * @req [in]: RDMO request
+ * @return: DOCA_SUCCESS once the Gets are issued, DOCA_ERROR if the request was rejected before issuing any
+ */
+static doca_error_t urom_worker_rdmo_gather_issue(struct urom_worker_rdmo_req *req)
+{
+	ucs_status_ptr_t ucs_status_ptr;
+	ucp_request_param_t req_param;
+	const struct urom_rdmo_hdr *rdmo_hdr = (const struct urom_rdmo_hdr *)req->header;
+	const struct urom_rdmo_gather_hdr *gather_hdr = (struct urom_rdmo_gather_hdr *)(rdmo_hdr + 1);
+	struct urom_worker_rdmo_mkey *rdmo_mkey;
+	struct urom_rdmo_gather_iov *iov;
+	struct urom_rdmo_rsp_hdr *rsp_hdr;
+	struct urom_rdmo_gather_rsp_hdr *gather_rsp;
+	size_t rsp_hdr_len = sizeof(*rsp_hdr) + sizeof(*gather_rsp);
+	uint8_t *rsp_data;
+	void *sm_addr;
+	doca_error_t result;
+	uint64_t i;
+
+	if (req->param.recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
+		DOCA_LOG_ERR("Rendezvous gather not supported");
+		return DOCA_ERROR_NOT_SUPPORTED;
+	}
+
+	if (gather_hdr->count > req->length / sizeof(*iov)) {
+		DOCA_LOG_ERR("Gather payload too short for %lu IOVs", gather_hdr->count);
+		return DOCA_ERROR_INVALID_VALUE;
+	}
+
+	/* Stage 1: validate all IOVs before issuing any Get */
+	iov = (struct urom_rdmo_gather_iov *)req->data;
+	for (i = 0; i < gather_hdr->count; i++) {
+		result = urom_worker_rdmo_iov_mkey_get(req->client, iov[i].rkey, iov[i].addr, iov[i].len, &rdmo_mkey);
+		if (result != DOCA_SUCCESS)
+			return result;
+		req->ctx[3] += iov[i].len;
+	}
+
+	/* Response header and gathered data share one buffer, sent as AM header and payload */
+	rsp_hdr = malloc(rsp_hdr_len + req->ctx[3]);
+	if (rsp_hdr == NULL) {
+		DOCA_LOG_ERR("Failed to allocate gather response of %lu bytes", req->ctx[3]);
+		return DOCA_ERROR_NO_MEMORY;
+	}
+	req->ctx[2] = (uint64_t)rsp_hdr;
+
+	gather_rsp = (struct urom_rdmo_gather_rsp_hdr *)(rsp_hdr + 1);
+	rsp_hdr->rsp_id = UROM_RDMO_RSP_GATHER;
+	gather_rsp->gather_id = gather_hdr->gather_id;
+	gather_rsp->length = req->ctx[3];
+	gather_rsp->status = DOCA_SUCCESS;
+	rsp_data = (uint8_t *)rsp_hdr + rsp_hdr_len;
+
+	/* Stage 2: Do Gets straight into the response payload */
+	for (i = 0; i < gather_hdr->count; i++, iov++) {
+		urom_worker_rdmo_iov_mkey_get(req->client, iov->rkey, iov->addr, iov->len, &rdmo_mkey);
+
+		if (ucp_rkey_ptr(rdmo_mkey->ucp_rkey, iov->addr, &sm_addr) == UCS_OK) {
+			/* Buffer is in shared memory between client and urom_worker */
+			memcpy(rsp_data, sm_addr, iov->len);
+		} else {
+			memset(&req_param, 0, sizeof(req_param));
+			req_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+			req_param.cb.send = urom_worker_rdmo_iov_op_send_cb;
+			req_param.user_data = req;
+
+			ucs_status_ptr = ucp_get_nbx(req->client->ep->ep,
+						     rsp_data,
+						     iov->len,
+						     iov->addr,
+						     rdmo_mkey->ucp_rkey,
+						     &req_param);
+			if (UCS_PTR_IS_ERR(ucs_status_ptr)) {
+				/* Gets already issued still write into the response, wait for them */
+				DOCA_LOG_ERR("Failed to issue gather Get from: %#lx", iov->addr);
+				req->result = DOCA_ERROR_DRIVER;
+				break;
+			}
+
+			if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+				DOCA_LOG_DBG("Initiated Get from: %#lx len: %u req %p", iov->addr, iov->len, req);
+				req->ctx[1]++; /* Pending completion */
+			}
+		}
+
+		rsp_data += iov->len;
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Progress function for gather operations
+ *
+ * Request context: ctx[0] stage, ctx[1] pending Gets, ctx[2] response buffer, ctx[3] gathered data length.
+ * The initiator always gets a response: a failed request is answered with the response header alone, carrying
+ * the failure status, once the Gets already in flight complete.
+ *
+ * @req [in]: RDMO request
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t urom_worker_rdmo_gather_progress(struct urom_worker_rdmo_req *req)
+{
+	ucs_status_ptr_t ucs_status_ptr;
+	ucp_request_param_t req_param;
+	const struct urom_rdmo_hdr *rdmo_hdr = (const struct urom_rdmo_hdr *)req->header;
+	const struct urom_rdmo_gather_hdr *gather_hdr = (struct urom_rdmo_gather_hdr *)(rdmo_hdr + 1);
+	struct urom_rdmo_rsp_hdr *rsp_hdr;
+	struct urom_rdmo_gather_rsp_hdr *gather_rsp;
+	size_t rsp_hdr_len = sizeof(*rsp_hdr) + sizeof(*gather_rsp);
+	uint64_t err_rsp[(sizeof(*rsp_hdr) + sizeof(*gather_rsp) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+	doca_error_t result;
+
+	if (req->ctx[0] == 0) {
+		result = urom_worker_rdmo_gather_issue(req);
+		if (result != DOCA_SUCCESS)
+			req->result = result;
+
+		/* all Gets issued */
+		req->ctx[0] = 1;
+	}
+
+	if (req->ctx[0] == 1) {
+		/* Stage 3: Wait for all Gets, then send the gathered data or the failure status to initiator */
+		if (req->ctx[1])
+			return DOCA_ERROR_IN_PROGRESS;
+
+		memset(&req_param, 0, sizeof(req_param));
+		req_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+		req_param.cb.send = urom_worker_rdmo_op_send_cb;
+		req_param.user_data = req;
+
+		rsp_hdr = (struct urom_rdmo_rsp_hdr *)req->ctx[2];
+		if (req->result != DOCA_SUCCESS) {
+			/* Drop the gathered data, the error response header is copied by UCP on send */
+			free(rsp_hdr);
+			req->ctx[2] = 0;
+			req->ctx[3] = 0;
+
+			rsp_hdr = (struct urom_rdmo_rsp_hdr *)err_rsp;
+			gather_rsp = (struct urom_rdmo_gather_rsp_hdr *)(rsp_hdr + 1);
+			rsp_hdr->rsp_id = UROM_RDMO_RSP_GATHER;
+			gather_rsp->gather_id = gather_hdr->gather_id;
+			gather_rsp->length = 0;
+			gather_rsp->status = req->result;
+			req_param.op_attr_mask |= UCP_OP_ATTR_FIELD_FLAGS;
+			req_param.flags = UCP_AM_SEND_FLAG_COPY_HEADER;
+		}
+
+		ucs_status_ptr = ucp_am_send_nbx(req->param.reply_ep,
+						 UROM_RDMO_AM_ID,
+						 rsp_hdr,
+						 rsp_hdr_len,
+						 (uint8_t *)rsp_hdr + rsp_hdr_len,
+						 req->ctx[3],
+						 &req_param);
+		if (UCS_PTR_IS_ERR(ucs_status_ptr)) {
+			DOCA_LOG_ERR("Failed to send gather response, req: %p", req);
+			free((void *)req->ctx[2]);
+			return DOCA_ERROR_DRIVER;
+		}
+
+		req->ctx[0] = 2;
+
+		if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+			DOCA_LOG_DBG("Initiated gather response, req: %p", req);
+			return DOCA_ERROR_IN_PROGRESS;
+		}
+		if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK) {
+			free((void *)req->ctx[2]);
+			return DOCA_ERROR_DRIVER;
+		}
+
+		/* Fall through */
+	}
+
+	free((void *)req->ctx[2]);
+	if (req->result != DOCA_SUCCESS)
+		return req->result;
+
+	DOCA_LOG_DBG("Completed Gather request: %p", req);
+
+	return DOCA_SUCCESS;
+}
+
+/* RDMO gather operations */
+static struct urom_worker_rdmo_req_ops urom_worker_rdmo_gather_ops = {
+	.progress = urom_worker_rdmo_gather_progress,
+};
+
+/*
+ * Atomically add an operand to an integer in memory shared between client and urom_worker
+ *
+ * @sm_addr [in]: target integer address
+ * @operand [in]: operand, may be unaligned
+ * @width [in]: operand width in bytes, 4 or 8
+ */
+static void urom_worker_rdmo_sm_atomic_add(void *sm_addr, const void *operand, uint32_t width)
+{
+	uint64_t val64;
+	uint32_t val32;
+
+	if (width == sizeof(uint64_t)) {
+		memcpy(&val64, operand, sizeof(val64));
+		__atomic_fetch_add((uint64_t *)sm_addr, val64, __ATOMIC_RELAXED);
+	} else {
+		memcpy(&val32, operand, sizeof(val32));
+		__atomic_fetch_add((uint32_t *)sm_addr, val32, __ATOMIC_RELAXED);
+	}
+}
+
+/*
+ * Post one atomic add per operand of an accumulate IOV that is not in shared memory
+ *
+ * @req [in]: RDMO request
+ * @rdmo_mkey [in]: memory region holding the IOV
+ * @iov [in]: accumulate IOV, followed by its operands
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t urom_worker_rdmo_accumulate_iov_post(struct urom_worker_rdmo_req *req,
+							 struct urom_worker_rdmo_mkey *rdmo_mkey,
+							 const struct urom_rdmo_accumulate_iov *iov)
+{
+	ucs_status_ptr_t ucs_status_ptr;
+	ucp_request_param_t req_param;
+	const uint8_t *operand = (const uint8_t *)(iov + 1);
+	uint64_t target;
+	uint64_t cached;
+	uint64_t val;
+	doca_error_t result;
+	uint32_t j;
+
+	for (j = 0; j < iov->count; j++, operand += iov->width) {
+		target = iov->addr + j * iov->width;
+
+		/* A pointer cached by append is flushed later and would overwrite the add */
+		if (iov->width == sizeof(uint64_t) &&
+		    urom_worker_rdmo_mem_cache_get(rdmo_mkey, target, &cached) == DOCA_SUCCESS) {
+			memcpy(&val, operand, sizeof(val));
+			result = urom_worker_rdmo_mem_cache_put(rdmo_mkey, target, cached + val);
+			if (result != DOCA_SUCCESS)
+				return result;
+			continue;
+		}
+
+		memset(&req_param, 0, sizeof(req_param));
+		req_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA |
+					 UCP_OP_ATTR_FIELD_DATATYPE;
+		req_param.cb.send = urom_worker_rdmo_iov_op_send_cb;
+		req_param.user_data = req;
+		req_param.datatype = ucp_dt_make_contig(iov->width);
+
+		ucs_status_ptr = ucp_atomic_op_nbx(req->client->ep->ep,
+						   UCP_ATOMIC_OP_ADD,
+						   operand,
+						   1,
+						   target,
+						   rdmo_mkey->ucp_rkey,
+						   &req_param);
+		if (UCS_PTR_IS_ERR(ucs_status_ptr))
+			return DOCA_ERROR_DRIVER;
+
+		if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS)
+			req->ctx[1]++; /* Pending completion */
+	}
+
+	DOCA_LOG_DBG("Initiated accumulate of %u operands to: %#lx req %p", iov->count, iov->addr, req);
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Progress function for accumulate operations
+ *
+ * Request context: ctx[0] stage, ctx[1] pending atomics. A failed atomic only stops issuing, the error is reported
+ * once the atomics already in flight complete.
+ *
+ * @req [in]: RDMO request
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t urom_worker_rdmo_accumulate_progress(struct urom_worker_rdmo_req *req)
+{
+	const struct urom_rdmo_hdr *rdmo_hdr = (const struct urom_rdmo_hdr *)req->header;
+	const struct urom_rdmo_accumulate_hdr *acc_hdr = (struct urom_rdmo_accumulate_hdr *)(rdmo_hdr + 1);
+	uintptr_t data_end = (uintptr_t)req->data + req->length;
+	struct urom_worker_rdmo_mkey *rdmo_mkey;
+	struct urom_rdmo_accumulate_iov *iov;
+	uint8_t *operand;
+	uint64_t len;
+	void *sm_addr;
+	doca_error_t result;
 	uint64_t i;
+	uint32_t j;
 
 	if (req->ctx[0] == 0) {
 		if (req->param.recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
-			DOCA_LOG_ERR("Rendezvous scatter not supported");
+			DOCA_LOG_ERR("Rendezvous accumulate not supported");
 			return DOCA_ERROR_NOT_SUPPORTED;
 		}
 
-		/* Stage 2: Do Puts */
-		iov = (struct urom_rdmo_scatter_iov *)req->data;
-		iov_data = (void *)(iov + 1);
-
-		for (i = 0; i < scatter_hdr->count; i++) {
-			if (iov->rkey != prev_rkey) {
-				k = kh_get(mkey, req->client->mkeys, iov->rkey);
-				if (k == kh_end(req->client->mkeys)) {
-					DOCA_LOG_ERR("Unknown rkey: %lu", iov->rkey);
-					return DOCA_SUCCESS;
-				}
+		/* Stage 1: validate all IOVs so a bad one does not leave the vector half applied */
+		iov = (struct urom_rdmo_accumulate_iov *)req->data;
+		for (i = 0; i < acc_hdr->count; i++) {
+			if ((uintptr_t)(iov + 1) > data_end) {
+				DOCA_LOG_ERR("Accumulate payload too short for %lu IOVs", acc_hdr->count);
+				return DOCA_ERROR_INVALID_VALUE;
+			}
 
-				rdmo_mkey = kh_value(req->client->mkeys, k);
-				ucp_rkey = rdmo_mkey->ucp_rkey;
-				prev_rkey = iov->rkey;
+			if ((iov->width != sizeof(uint32_t) && iov->width != sizeof(uint64_t)) ||
+			    iov->addr % iov->width) {
+				DOCA_LOG_ERR("Invalid accumulate target: %#lx width: %u", iov->addr, iov->width);
+				return DOCA_ERROR_INVALID_VALUE;
 			}
 
-			if (iov->addr < rdmo_mkey->va || (iov->addr + iov->len) > (rdmo_mkey->va + rdmo_mkey->len)) {
-				DOCA_LOG_ERR("Scatter IOV out of bounds, put: %#lx-%#lx mkey: %#lx-%#lx",
-					     iov->addr,
-					     iov->addr + iov->len,
-					     rdmo_mkey->va,
-					     rdmo_mkey->va + rdmo_mkey->len);
-				return DOCA_ERROR_UNEXPECTED;
+			len = (uint64_t)iov->count * iov->width;
+			if ((uintptr_t)(iov + 1) + len > data_end) {
+				DOCA_LOG_ERR("Accumulate payload too short for %u operands", iov->count);
+				return DOCA_ERROR_INVALID_VALUE;
 			}
 
-			if (ucp_rkey_ptr(ucp_rkey, iov->addr, (void **)&sm_addr) != UCS_OK) {
-				memset(&req_param, 0, sizeof(req_param));
-				req_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
-				req_param.cb.send = urom_worker_rdmo_scatter_op_send_cb;
-				req_param.user_data = req;
-
-				ucs_status_ptr = ucp_put_nbx(req->client->ep->ep,
-							     iov_data,
-							     iov->len,
-							     iov->addr,
-							     ucp_rkey,
-							     &req_param);
-				if (UCS_PTR_IS_ERR(ucs_status_ptr))
-					return DOCA_ERROR_DRIVER;
-
-				if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
-					DOCA_LOG_DBG("Initiated Put to: %#lx len: %u req %p", iov->addr, iov->len, req);
-					req->ctx[1]++; /* Pending completion */
-				} else {
-					if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK)
-						return DOCA_ERROR_DRIVER;
-
-					DOCA_LOG_DBG("Completed Scatter Put, req: %p", req);
-				}
-			} else {
-				/* Buffer is in shared memory between client and urom_worker */
-				memcpy((void *)sm_addr, iov_data, iov->len);
+			result = urom_worker_rdmo_iov_mkey_get(req->client, iov->rkey, iov->addr, len, &rdmo_mkey);
+			if (result != DOCA_SUCCESS)
+				return result;
+
+			iov = (struct urom_rdmo_accumulate_iov *)((uintptr_t)(iov + 1) + len);
+		}
 
-				DOCA_LOG_DBG("Completed copy, req: %p", req);
+		/* Stage 2: Do one atomic add per operand */
+		iov = (struct urom_rdmo_accumulate_iov *)req->data;
+		for (i = 0; i < acc_hdr->count; i++) {
+			urom_worker_rdmo_iov_mkey_get(req->client,
+						      iov->rkey,
+						      iov->addr,
+						      (uint64_t)iov->count * iov->width,
+						      &rdmo_mkey);
+			operand = (uint8_t *)(iov + 1);
+
+			if (ucp_rkey_ptr(rdmo_mkey->ucp_rkey, iov->addr, &sm_addr) == UCS_OK) {
+				for (j = 0; j < iov->count; j++, operand += iov->width)
+					urom_worker_rdmo_sm_atomic_add((uint8_t *)sm_addr + j * iov->width,
+								       operand,
+								       iov->width);
+				DOCA_LOG_DBG("Completed SM accumulate of %u operands, req: %p", iov->count, req);
+			} else {
+				result = urom_worker_rdmo_accumulate_iov_post(req, rdmo_mkey, iov);
+				if (result != DOCA_SUCCESS) {
+					/* Atomics already issued still read their operands from the payload */
+					req->result = result;
+					break;
+				}
+				operand += (uint64_t)iov->count * iov->width;
 			}
 
-			iov = (struct urom_rdmo_scatter_iov *)((uintptr_t)iov + sizeof(*iov) + iov->len);
-			iov_data = (void *)(iov + 1);
+			iov = (struct urom_rdmo_accumulate_iov *)operand;
 		}
 
-		/* all sends complete */
+		/* all atomics issued */
 		req->ctx[0] = 1;
 	}
 
@@ -766,14 +1430,17 @@ static doca_error_t urom_worker_rdmo_scatter_progress(struct urom_worker_rdmo_re
 			return DOCA_ERROR_IN_PROGRESS;
 	}
 
-	DOCA_LOG_DBG("Completed Scatter request: %p", req);
+	if (req->result != DOCA_SUCCESS)
+		return req->result;
+
+	DOCA_LOG_DBG("Completed Accumulate request: %p", req);
 
 	return DOCA_SUCCESS;
 }
 
-/* RDMO scatter operations */
-static struct urom_worker_rdmo_req_ops urom_worker_rdmo_scatter_ops = {
-	.progress = urom_worker_rdmo_scatter_progress,
+/* RDMO accumulate operations */
+static struct urom_worker_rdmo_req_ops urom_worker_rdmo_accumulate_ops = {
+	.progress = urom_worker_rdmo_accumulate_progress,
 };
 
 /* RDMO worker requests operations */
@@ -781,22 +1448,74 @@ struct urom_worker_rdmo_req_ops *urom_worker_rdmo_ops_table[] = {
 	[UROM_RDMO_OP_FLUSH] = &urom_worker_rdmo_flush_ops,
 	[UROM_RDMO_OP_APPEND] = &urom_worker_rdmo_append_ops,
 	[UROM_RDMO_OP_SCATTER] = &urom_worker_rdmo_scatter_ops,
+	[UROM_RDMO_OP_GATHER] = &urom_worker_rdmo_gather_ops,
+	[UROM_RDMO_OP_ACCUMULATE] = &urom_worker_rdmo_accumulate_ops,
 };
 
+doca_error_t urom_worker_rdmo_domain_get(struct urom_worker_rdmo_client *client,
+					 uint64_t key,
+					 struct urom_worker_rdmo_domain **domain)
+{
+	struct urom_worker_rdmo_domain *new_domain;
+	khint_t k;
+	int ret;
+
+	k = kh_get(domain, client->domains, key);
+	if (k != kh_end(client->domains)) {
+		*domain = kh_value(client->domains, k);
+		return DOCA_SUCCESS;
+	}
+
+	new_domain = calloc(1, sizeof(*new_domain));
+	if (new_domain == NULL) {
+		DOCA_LOG_ERR("Failed to allocate ordering domain");
+		return DOCA_ERROR_NO_MEMORY;
+	}
+
+	new_domain->key = key;
+	ucs_list_head_init(&new_domain->queued_ops);
+
+	k = kh_put(domain, client->domains, key, &ret);
+	if (ret < 0) {
+		DOCA_LOG_ERR("Failed to add ordering domain");
+		free(new_domain);
+		return DOCA_ERROR_DRIVER;
+	}
+	kh_value(client->domains, k) = new_domain;
+
+	DOCA_LOG_DBG("New ordering domain %#lx (client: %p)", key, client);
+	*domain = new_domain;
+
+	return DOCA_SUCCESS;
+}
+
 doca_error_t urom_worker_rdmo_req_queue(struct urom_worker_rdmo_req *req)
 {
 	struct urom_worker_rdmo_client *client = req->client;
+	struct urom_worker_rdmo_domain *domain = req->domain;
 	doca_error_t status;
 
-	if (!ucs_list_is_empty(&client->paused_ops) || client->pause) {
+	if (domain != NULL) {
+		/* Domain requests are ordered only against earlier requests of the same domain */
+		if (domain->oreqs || !ucs_list_is_empty(&domain->queued_ops)) {
+			DOCA_LOG_DBG("New domain %#lx request: %p", domain->key, req);
+			ucs_list_add_tail(&domain->queued_ops, &req->entry);
+			return DOCA_ERROR_IN_PROGRESS;
+		}
+		domain->oreqs++;
+	} else if (!ucs_list_is_empty(&client->paused_ops) || client->pause) {
 		DOCA_LOG_DBG("New paused request: %p", req);
 		ucs_list_add_tail(&client->paused_ops, &req->entry);
 		return DOCA_ERROR_IN_PROGRESS;
 	}
 
 	status = urom_worker_rdmo_req_start(req);
-	if (status == DOCA_SUCCESS)
+	if (status != DOCA_ERROR_IN_PROGRESS) {
+		urom_worker_rdmo_req_log_status(req, status);
 		urom_worker_rdmo_req_free(req);
+		if (domain != NULL)
+			urom_worker_rdmo_check_domain(client, domain);
+	}
 
 	return status;
 }
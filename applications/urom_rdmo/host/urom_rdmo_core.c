@@ -36,6 +36,7 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <malloc.h>
+#include <time.h>
 
 #include <ucp/api/ucp.h>
 
@@ -52,7 +53,14 @@
 DOCA_LOG_REGISTER(UROM::RDMO::CORE);
 
 #define FLUSH_ID 0xbeef		    /* Flush callback id */
+#define GATHER_ID 0xcafe	    /* Gather callback id */
 #define MAX_WORKER_ADDRESS_LEN 1024 /* Maximum address length */
+#define ACCUMULATE_COUNT 16	    /* Number of remote counters the accumulate test adds into */
+#define ACCUMULATE_ROUNDS 2	    /* Number of accumulate requests sent to the same counters */
+#define SCATTER_BENCH_CHUNK_SIZE 8  /* Scatter benchmark IOV size */
+#define SCATTER_BENCH_CHUNKS 512    /* Scatter benchmark IOVs per request */
+#define SCATTER_BENCH_ITERS 1000    /* Scatter benchmark requests per IOV order */
+#define DOMAIN_BENCH_ITERS 1024	    /* Mixed append/scatter benchmark request pairs per mode */
 
 /* Remote buffer descriptor */
 struct rbuf_desc {
@@ -60,6 +68,17 @@ struct rbuf_desc {
 	uint64_t *raddr; /* Remote address */
 };
 
+/* RDMO client response state, updated by the AM reply handler */
+struct rdmo_client_rsp {
+	int flushed;		    /* Set once a flush response arrived */
+	int gathered;		    /* Set once a gather response arrived */
+	void *gather_buf;	    /* Gather destination buffer */
+	size_t gather_len;	    /* Gather destination buffer length */
+	size_t gather_recv;	    /* Gathered data length reported by the response */
+	doca_error_t gather_status; /* Gather status reported by the response */
+	void *gather_desc;	    /* Rendezvous gather data descriptor, NULL if data was delivered eagerly */
+};
+
 /* RDMO client init result */
 struct client_init_result {
 	char *addr;	   /* Device UCP worker address */
@@ -216,7 +235,9 @@ connected:
  * @data [in]: data to scatter
  * @len [in]: data length
  * @chunk_size [in]: chunk size to split data to chunks
+ * @order [in]: order in which chunks are packed into the request, NULL to pack them in address order
  * @rkey [in]: data remote memory key
+ * @flags [in]: extra request flags, with UROM_RDMO_REQ_FLAG_DOMAIN the target is used as domain key
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
 static doca_error_t rdmo_scatter(ucp_worker_h client_ucp_worker,
@@ -225,67 +246,83 @@ static doca_error_t rdmo_scatter(ucp_worker_h client_ucp_worker,
 				 void *data,
 				 size_t len,
 				 int chunk_size,
-				 uint64_t rkey)
+				 const int *order,
+				 uint64_t rkey,
+				 uint32_t flags)
 {
-	int i;
+	int i, chunk;
 	void *hdr;
 	int chunks = len / chunk_size;
 	struct urom_rdmo_hdr *rdmo_hdr;
 	ucs_status_ptr_t ucs_status_ptr;
-	struct urom_rdmo_scatter_iov *iov;
+	struct urom_rdmo_scatter_iov32 *iov;
 	struct urom_rdmo_scatter_hdr *scatter_hdr;
+	struct urom_rdmo_domain_hdr *domain_hdr;
 	ucp_request_param_t req_param = {
 		.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS,
 		.flags = UCP_AM_SEND_FLAG_REPLY,
 	};
-	int req_data_len = chunks * (sizeof(struct urom_rdmo_scatter_iov) + chunk_size);
+	size_t req_data_len = chunks * (sizeof(struct urom_rdmo_scatter_iov32) + chunk_size);
 	size_t hdr_len = sizeof(struct urom_rdmo_hdr) + sizeof(struct urom_rdmo_scatter_hdr);
-	uint8_t req_data[req_data_len];
 
-	memset(req_data, 0, req_data_len);
+	if (flags & UROM_RDMO_REQ_FLAG_DOMAIN)
+		hdr_len += sizeof(*domain_hdr);
+	uint8_t *req_data;
+	doca_error_t result = DOCA_SUCCESS;
+
+	req_data = calloc(1, req_data_len);
+	if (req_data == NULL)
+		return DOCA_ERROR_NO_MEMORY;
 
 	hdr = alloca(hdr_len);
-	if (hdr == NULL)
+	if (hdr == NULL) {
+		free(req_data);
 		return DOCA_ERROR_NO_MEMORY;
+	}
 
 	rdmo_hdr = (struct urom_rdmo_hdr *)hdr;
 	scatter_hdr = (struct urom_rdmo_scatter_hdr *)(rdmo_hdr + 1);
 
 	rdmo_hdr->id = 0;
 	rdmo_hdr->op_id = UROM_RDMO_OP_SCATTER;
-	rdmo_hdr->flags = 0;
+	rdmo_hdr->flags = UROM_RDMO_REQ_FLAG_IOV_LEN32 | flags;
 	scatter_hdr->count = chunks;
 
-	iov = (struct urom_rdmo_scatter_iov *)req_data;
+	if (flags & UROM_RDMO_REQ_FLAG_DOMAIN) {
+		domain_hdr = (struct urom_rdmo_domain_hdr *)(scatter_hdr + 1);
+		domain_hdr->key = target;
+	}
+
+	iov = (struct urom_rdmo_scatter_iov32 *)req_data;
 	for (i = 0; i < chunks; i++) {
-		iov->addr = target;
+		chunk = order ? order[i] : i;
+		iov->addr = target + (uint64_t)chunk * chunk_size;
 		iov->len = chunk_size;
 		iov->rkey = rkey;
-		memcpy(iov + 1, data, chunk_size);
+		memcpy(iov + 1, (uint8_t *)data + (size_t)chunk * chunk_size, chunk_size);
 
-		data += chunk_size;
-		target += chunk_size;
-		iov = (struct urom_rdmo_scatter_iov *)((uintptr_t)iov + sizeof(*iov) + chunk_size);
+		iov = (struct urom_rdmo_scatter_iov32 *)((uintptr_t)iov + sizeof(*iov) + chunk_size);
 	}
 
 	ucs_status_ptr = ucp_am_send_nbx(client_ucp_ep, 0, hdr, hdr_len, req_data, req_data_len, &req_param);
-	if (UCS_PTR_IS_ERR(ucs_status_ptr))
-		return DOCA_ERROR_DRIVER;
-
-	if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+	if (UCS_PTR_IS_ERR(ucs_status_ptr)) {
+		result = DOCA_ERROR_DRIVER;
+	} else if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
 		while (ucp_request_check_status(ucs_status_ptr) == UCS_INPROGRESS)
 			ucp_worker_progress(client_ucp_worker);
 
 		if (ucp_request_check_status(ucs_status_ptr) != UCS_OK)
-			return DOCA_ERROR_DRIVER;
+			result = DOCA_ERROR_DRIVER;
 		ucp_request_free(ucs_status_ptr);
 	} else {
 		if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK)
-			return DOCA_ERROR_DRIVER;
+			result = DOCA_ERROR_DRIVER;
 	}
 
-	DOCA_LOG_INFO("RDMO Scatter complete");
-	return DOCA_SUCCESS;
+	free(req_data);
+	if (result == DOCA_SUCCESS)
+		DOCA_LOG_DBG("RDMO Scatter complete");
+	return result;
 }
 
 /*
@@ -293,10 +330,10 @@ static doca_error_t rdmo_scatter(ucp_worker_h client_ucp_worker,
  *
  * @client_ucp_worker [in]: client UCP worker structure
  * @client_ucp_ep [in]: client UCP endpoint structure
- * @flushed [out]: will be set once the flush operation finished
+ * @rsp [in/out]: client response state, flushed will be set once the flush operation finished
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
-static doca_error_t rdmo_flush(ucp_worker_h client_ucp_worker, ucp_ep_h client_ucp_ep, int *flushed)
+static doca_error_t rdmo_flush(ucp_worker_h client_ucp_worker, ucp_ep_h client_ucp_ep, struct rdmo_client_rsp *rsp)
 {
 	struct urom_rdmo_hdr *hdr;
 	ucs_status_ptr_t ucs_status_ptr;
@@ -314,7 +351,7 @@ static doca_error_t rdmo_flush(ucp_worker_h client_ucp_worker, ucp_ep_h client_u
 	hdr->op_id = UROM_RDMO_OP_FLUSH;
 	hdr->flags = UROM_RDMO_REQ_FLAG_FENCE;
 	flush_hdr->flush_id = FLUSH_ID;
-	*flushed = 0;
+	rsp->flushed = 0;
 
 	ucs_status_ptr = ucp_am_send_nbx(client_ucp_ep, 0, hdr, hdr_len, NULL, 0, &req_param);
 	if (UCS_PTR_IS_ERR(ucs_status_ptr)) {
@@ -338,7 +375,7 @@ static doca_error_t rdmo_flush(ucp_worker_h client_ucp_worker, ucp_ep_h client_u
 
 	DOCA_LOG_INFO("Sent flush request");
 
-	while (!*flushed)
+	while (!rsp->flushed)
 		ucp_worker_progress(client_ucp_worker);
 
 	DOCA_LOG_INFO("Flush complete");
@@ -354,6 +391,7 @@ static doca_error_t rdmo_flush(ucp_worker_h client_ucp_worker, ucp_ep_h client_u
  * @data [in]: data to set
  * @len [in]: data length
  * @rkey [in]: memory remote key
+ * @flags [in]: request flags, with UROM_RDMO_REQ_FLAG_DOMAIN the pointer address is used as domain key
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
 static doca_error_t rdmo_append(ucp_worker_h client_ucp_worker,
@@ -361,29 +399,39 @@ static doca_error_t rdmo_append(ucp_worker_h client_ucp_worker,
 				uint64_t *ptr_addr,
 				void *data,
 				size_t len,
-				uint64_t rkey)
+				uint64_t rkey,
+				uint32_t flags)
 {
 	void *hdr;
 	struct urom_rdmo_hdr *rdmo_hdr;
 	ucs_status_ptr_t ucs_status_ptr;
 	struct urom_rdmo_append_hdr *append_hdr;
+	struct urom_rdmo_domain_hdr *domain_hdr;
 	size_t hdr_len = sizeof(struct urom_rdmo_hdr) + sizeof(struct urom_rdmo_append_hdr);
 	ucp_request_param_t req_param = {
 		.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS,
 		.flags = UCP_AM_SEND_FLAG_REPLY,
 	};
 
+	if (flags & UROM_RDMO_REQ_FLAG_DOMAIN)
+		hdr_len += sizeof(*domain_hdr);
+
 	hdr = alloca(hdr_len);
 	rdmo_hdr = (struct urom_rdmo_hdr *)hdr;
 	append_hdr = (struct urom_rdmo_append_hdr *)(rdmo_hdr + 1);
 
 	rdmo_hdr->id = 0;
 	rdmo_hdr->op_id = UROM_RDMO_OP_APPEND;
-	rdmo_hdr->flags = 0;
+	rdmo_hdr->flags = flags;
 	append_hdr->ptr_addr = (uint64_t)ptr_addr;
 	append_hdr->ptr_rkey = rkey;
 	append_hdr->data_rkey = rkey;
 
+	if (flags & UROM_RDMO_REQ_FLAG_DOMAIN) {
+		domain_hdr = (struct urom_rdmo_domain_hdr *)(append_hdr + 1);
+		domain_hdr->key = (uint64_t)ptr_addr;
+	}
+
 	ucs_status_ptr = ucp_am_send_nbx(client_ucp_ep, 0, hdr, hdr_len, data, len, &req_param);
 	if (UCS_PTR_IS_ERR(ucs_status_ptr)) {
 		DOCA_LOG_ERR("ucp_am_send_nbx() returned error [%s]",
@@ -403,7 +451,388 @@ static doca_error_t rdmo_append(ucp_worker_h client_ucp_worker,
 		if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK)
 			return DOCA_ERROR_DRIVER;
 	}
-	DOCA_LOG_INFO("RDMO Append complete");
+	DOCA_LOG_DBG("RDMO Append complete");
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Benchmark RDMO scatter with IOVs packed in address order versus random order
+ *
+ * Address ordered IOVs are contiguous and are merged by the DPU worker into one Put per request,
+ * random ordered IOVs are not and cost one Put each.
+ *
+ * @client_ucp_worker [in]: client UCP worker structure
+ * @client_ucp_ep [in]: client UCP endpoint structure
+ * @rsp [in]: client response state, used by the closing flush
+ * @target [in]: remote target
+ * @data [in]: data to scatter
+ * @chunk_size [in]: IOV size
+ * @chunks [in]: number of IOVs per request
+ * @iters [in]: number of requests per IOV order
+ * @rkey [in]: data remote memory key
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rdmo_scatter_bench(ucp_worker_h client_ucp_worker,
+				       ucp_ep_h client_ucp_ep,
+				       struct rdmo_client_rsp *rsp,
+				       uint64_t target,
+				       void *data,
+				       int chunk_size,
+				       int chunks,
+				       int iters,
+				       uint64_t rkey)
+{
+	const char *order_names[] = {"sorted", "random"};
+	unsigned int seed = 0x5eed;
+	struct timespec start, end;
+	doca_error_t result;
+	int i, j, tmp, runs, mode;
+	int *order;
+	double elapsed;
+
+	order = malloc(chunks * sizeof(*order));
+	if (order == NULL)
+		return DOCA_ERROR_NO_MEMORY;
+
+	for (mode = 0; mode < 2; mode++) {
+		for (i = 0; i < chunks; i++)
+			order[i] = i;
+
+		/* Fisher-Yates shuffle for the random order */
+		for (i = chunks - 1; mode == 1 && i > 0; i--) {
+			j = rand_r(&seed) % (i + 1);
+			tmp = order[i];
+			order[i] = order[j];
+			order[j] = tmp;
+		}
+
+		/* Puts the worker issues per request, one per run of address contiguous IOVs */
+		for (runs = 1, i = 1; i < chunks; i++)
+			runs += order[i] != order[i - 1] + 1;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i = 0; i < iters; i++) {
+			result = rdmo_scatter(client_ucp_worker,
+					      client_ucp_ep,
+					      target,
+					      data,
+					      (size_t)chunks * chunk_size,
+					      chunk_size,
+					      order,
+					      rkey,
+					      0);
+			if (result != DOCA_SUCCESS)
+				goto free_order;
+		}
+
+		result = rdmo_flush(client_ucp_worker, client_ucp_ep, rsp);
+		if (result != DOCA_SUCCESS)
+			goto free_order;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+		DOCA_LOG_INFO("Scatter %s: %d IOVs of %d bytes per request, %d puts per request, %.0f req/s, %.2f MB/s",
+			      order_names[mode],
+			      chunks,
+			      chunk_size,
+			      runs,
+			      iters / elapsed,
+			      (double)iters * chunks * chunk_size / elapsed / 1e6);
+	}
+
+	result = DOCA_SUCCESS;
+
+free_order:
+	free(order);
+	return result;
+}
+
+/*
+ * Benchmark mixed RDMO append and scatter traffic with and without ordering domains
+ *
+ * Without domains an append that misses the DPU pointer cache pauses every later request of the
+ * client. With domains the appends are ordered on their pointer and the scatters on their target,
+ * so the two streams proceed independently like two clients would.
+ *
+ * @client_ucp_worker [in]: client UCP worker structure
+ * @client_ucp_ep [in]: client UCP endpoint structure
+ * @rsp [in]: client response state, used by the flushes
+ * @queue [in]: remote append queue, a pointer followed by room for iters appends of 8 bytes
+ * @scatter_target [in]: remote scatter target, room for 64 bytes
+ * @data [in]: data to append and scatter
+ * @iters [in]: number of append and scatter pairs per mode
+ * @rkey [in]: data remote memory key
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rdmo_domain_bench(ucp_worker_h client_ucp_worker,
+				      ucp_ep_h client_ucp_ep,
+				      struct rdmo_client_rsp *rsp,
+				      uint64_t queue,
+				      uint64_t scatter_target,
+				      void *data,
+				      int iters,
+				      uint64_t rkey)
+{
+	const uint32_t mode_flags[] = {0, UROM_RDMO_REQ_FLAG_DOMAIN};
+	const char *mode_names[] = {"connection ordered", "ordering domains"};
+	struct timespec start, end;
+	uint64_t queue_head;
+	doca_error_t result;
+	double elapsed;
+	int i, mode;
+
+	for (mode = 0; mode < 2; mode++) {
+		/* Rewind the append queue pointer, the flush also drops the DPU pointer cache */
+		queue_head = queue + sizeof(uint64_t);
+		result = rdmo_scatter(client_ucp_worker,
+				      client_ucp_ep,
+				      queue,
+				      &queue_head,
+				      sizeof(queue_head),
+				      sizeof(queue_head),
+				      NULL,
+				      rkey,
+				      0);
+		if (result != DOCA_SUCCESS)
+			return result;
+
+		result = rdmo_flush(client_ucp_worker, client_ucp_ep, rsp);
+		if (result != DOCA_SUCCESS)
+			return result;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i = 0; i < iters; i++) {
+			result = rdmo_append(client_ucp_worker,
+					     client_ucp_ep,
+					     (uint64_t *)queue,
+					     data,
+					     sizeof(uint64_t),
+					     rkey,
+					     mode_flags[mode]);
+			if (result != DOCA_SUCCESS)
+				return result;
+
+			result = rdmo_scatter(client_ucp_worker,
+					      client_ucp_ep,
+					      scatter_target,
+					      data,
+					      64,
+					      8,
+					      NULL,
+					      rkey,
+					      mode_flags[mode]);
+			if (result != DOCA_SUCCESS)
+				return result;
+		}
+
+		result = rdmo_flush(client_ucp_worker, client_ucp_ep, rsp);
+		if (result != DOCA_SUCCESS)
+			return result;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+		DOCA_LOG_INFO("Mixed append/scatter, %s: %d pairs, %.0f req/s",
+			      mode_names[mode],
+			      iters,
+			      2.0 * iters / elapsed);
+	}
+
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Handle RDMO gather operation
+ *
+ * @client_ucp_worker [in]: client UCP worker structure
+ * @client_ucp_ep [in]: client UCP endpoint structure
+ * @rsp [in/out]: client response state, gathered will be set once the gather operation finished
+ * @source [in]: remote source
+ * @data [out]: buffer to gather to
+ * @len [in]: data length
+ * @chunk_size [in]: chunk size to split data to chunks
+ * @rkey [in]: data remote memory key
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rdmo_gather(ucp_worker_h client_ucp_worker,
+				ucp_ep_h client_ucp_ep,
+				struct rdmo_client_rsp *rsp,
+				uint64_t source,
+				void *data,
+				size_t len,
+				int chunk_size,
+				uint64_t rkey)
+{
+	int i;
+	void *hdr;
+	int chunks = len / chunk_size;
+	struct urom_rdmo_hdr *rdmo_hdr;
+	ucs_status_ptr_t ucs_status_ptr;
+	struct urom_rdmo_gather_iov *iov;
+	struct urom_rdmo_gather_hdr *gather_hdr;
+	ucp_request_param_t req_param = {
+		.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS,
+		.flags = UCP_AM_SEND_FLAG_REPLY,
+	};
+	ucp_request_param_t recv_param = {0};
+	int req_data_len = chunks * sizeof(struct urom_rdmo_gather_iov);
+	size_t hdr_len = sizeof(struct urom_rdmo_hdr) + sizeof(struct urom_rdmo_gather_hdr);
+	uint8_t req_data[req_data_len];
+
+	memset(req_data, 0, req_data_len);
+
+	hdr = alloca(hdr_len);
+	if (hdr == NULL)
+		return DOCA_ERROR_NO_MEMORY;
+
+	rdmo_hdr = (struct urom_rdmo_hdr *)hdr;
+	gather_hdr = (struct urom_rdmo_gather_hdr *)(rdmo_hdr + 1);
+
+	rdmo_hdr->id = 0;
+	rdmo_hdr->op_id = UROM_RDMO_OP_GATHER;
+	rdmo_hdr->flags = 0;
+	gather_hdr->gather_id = GATHER_ID;
+	gather_hdr->count = chunks;
+
+	iov = (struct urom_rdmo_gather_iov *)req_data;
+	for (i = 0; i < chunks; i++) {
+		iov[i].addr = source;
+		iov[i].len = chunk_size;
+		iov[i].rkey = rkey;
+		source += chunk_size;
+	}
+
+	rsp->gathered = 0;
+	rsp->gather_buf = data;
+	rsp->gather_len = len;
+	rsp->gather_recv = 0;
+	rsp->gather_status = DOCA_SUCCESS;
+	rsp->gather_desc = NULL;
+
+	ucs_status_ptr = ucp_am_send_nbx(client_ucp_ep, 0, hdr, hdr_len, req_data, req_data_len, &req_param);
+	if (UCS_PTR_IS_ERR(ucs_status_ptr))
+		return DOCA_ERROR_DRIVER;
+
+	if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+		while (ucp_request_check_status(ucs_status_ptr) == UCS_INPROGRESS)
+			ucp_worker_progress(client_ucp_worker);
+
+		if (ucp_request_check_status(ucs_status_ptr) != UCS_OK)
+			return DOCA_ERROR_DRIVER;
+		ucp_request_free(ucs_status_ptr);
+	} else {
+		if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK)
+			return DOCA_ERROR_DRIVER;
+	}
+
+	DOCA_LOG_INFO("Sent gather request");
+
+	while (!rsp->gathered)
+		ucp_worker_progress(client_ucp_worker);
+
+	if (rsp->gather_status != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Gather failed on the worker: %s", doca_error_get_descr(rsp->gather_status));
+		if (rsp->gather_desc != NULL)
+			ucp_am_data_release(client_ucp_worker, rsp->gather_desc);
+		return rsp->gather_status;
+	}
+
+	if (rsp->gather_recv != len) {
+		DOCA_LOG_ERR("Gathered %lu bytes, expected %lu", rsp->gather_recv, len);
+		if (rsp->gather_desc != NULL)
+			ucp_am_data_release(client_ucp_worker, rsp->gather_desc);
+		return DOCA_ERROR_UNEXPECTED;
+	}
+
+	/* Large responses arrive by rendezvous and must be pulled into the destination buffer */
+	if (rsp->gather_desc != NULL) {
+		ucs_status_ptr = ucp_am_recv_data_nbx(client_ucp_worker, rsp->gather_desc, data, len, &recv_param);
+		if (UCS_PTR_IS_ERR(ucs_status_ptr))
+			return DOCA_ERROR_DRIVER;
+
+		if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+			while (ucp_request_check_status(ucs_status_ptr) == UCS_INPROGRESS)
+				ucp_worker_progress(client_ucp_worker);
+
+			if (ucp_request_check_status(ucs_status_ptr) != UCS_OK)
+				return DOCA_ERROR_DRIVER;
+			ucp_request_free(ucs_status_ptr);
+		} else {
+			if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK)
+				return DOCA_ERROR_DRIVER;
+		}
+	}
+
+	DOCA_LOG_INFO("RDMO Gather complete");
+	return DOCA_SUCCESS;
+}
+
+/*
+ * Handle RDMO accumulate operation
+ *
+ * @client_ucp_worker [in]: client UCP worker structure
+ * @client_ucp_ep [in]: client UCP endpoint structure
+ * @target [in]: remote 64-bit counters address
+ * @operands [in]: values to add, one per counter
+ * @count [in]: number of counters
+ * @rkey [in]: counters remote memory key
+ * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
+ */
+static doca_error_t rdmo_accumulate(ucp_worker_h client_ucp_worker,
+				    ucp_ep_h client_ucp_ep,
+				    uint64_t target,
+				    const uint64_t *operands,
+				    uint32_t count,
+				    uint64_t rkey)
+{
+	void *hdr;
+	struct urom_rdmo_hdr *rdmo_hdr;
+	ucs_status_ptr_t ucs_status_ptr;
+	struct urom_rdmo_accumulate_iov *iov;
+	struct urom_rdmo_accumulate_hdr *acc_hdr;
+	ucp_request_param_t req_param = {
+		.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS,
+		.flags = UCP_AM_SEND_FLAG_REPLY,
+	};
+	int req_data_len = sizeof(struct urom_rdmo_accumulate_iov) + count * sizeof(*operands);
+	size_t hdr_len = sizeof(struct urom_rdmo_hdr) + sizeof(struct urom_rdmo_accumulate_hdr);
+	uint8_t req_data[req_data_len];
+
+	hdr = alloca(hdr_len);
+	if (hdr == NULL)
+		return DOCA_ERROR_NO_MEMORY;
+
+	rdmo_hdr = (struct urom_rdmo_hdr *)hdr;
+	acc_hdr = (struct urom_rdmo_accumulate_hdr *)(rdmo_hdr + 1);
+
+	rdmo_hdr->id = 0;
+	rdmo_hdr->op_id = UROM_RDMO_OP_ACCUMULATE;
+	rdmo_hdr->flags = 0;
+	acc_hdr->count = 1;
+
+	iov = (struct urom_rdmo_accumulate_iov *)req_data;
+	iov->addr = target;
+	iov->rkey = rkey;
+	iov->count = count;
+	iov->width = sizeof(*operands);
+	memcpy(iov + 1, operands, count * sizeof(*operands));
+
+	ucs_status_ptr = ucp_am_send_nbx(client_ucp_ep, 0, hdr, hdr_len, req_data, req_data_len, &req_param);
+	if (UCS_PTR_IS_ERR(ucs_status_ptr))
+		return DOCA_ERROR_DRIVER;
+
+	if (UCS_PTR_STATUS(ucs_status_ptr) == UCS_INPROGRESS) {
+		while (ucp_request_check_status(ucs_status_ptr) == UCS_INPROGRESS)
+			ucp_worker_progress(client_ucp_worker);
+
+		if (ucp_request_check_status(ucs_status_ptr) != UCS_OK)
+			return DOCA_ERROR_DRIVER;
+		ucp_request_free(ucs_status_ptr);
+	} else {
+		if (UCS_PTR_STATUS(ucs_status_ptr) != UCS_OK)
+			return DOCA_ERROR_DRIVER;
+	}
+
+	DOCA_LOG_INFO("RDMO Accumulate complete");
 	return DOCA_SUCCESS;
 }
 
@@ -426,20 +855,43 @@ static ucs_status_t rdmo_am_cb(void *arg,
 			       const ucp_am_recv_param_t *param)
 {
 	(void)header_length;
-	(void)data;
-	(void)length;
-	(void)param;
 
-	int *flushed = (int *)arg;
+	struct rdmo_client_rsp *rsp = (struct rdmo_client_rsp *)arg;
 	struct urom_rdmo_rsp_hdr *rsp_hdr;
 	struct urom_rdmo_flush_rsp_hdr *flush_hdr;
+	struct urom_rdmo_gather_rsp_hdr *gather_hdr;
 
 	rsp_hdr = (struct urom_rdmo_rsp_hdr *)header;
-	flush_hdr = (struct urom_rdmo_flush_rsp_hdr *)(rsp_hdr + 1);
-	*flushed = 1;
 
-	DOCA_LOG_INFO("Received AM Reply, ID: %#lx", flush_hdr->flush_id);
-	return UCS_OK;
+	switch (rsp_hdr->rsp_id) {
+	case UROM_RDMO_RSP_FLUSH:
+		flush_hdr = (struct urom_rdmo_flush_rsp_hdr *)(rsp_hdr + 1);
+		rsp->flushed = 1;
+		DOCA_LOG_INFO("Received AM Reply, ID: %#lx", flush_hdr->flush_id);
+		return UCS_OK;
+	case UROM_RDMO_RSP_GATHER:
+		gather_hdr = (struct urom_rdmo_gather_rsp_hdr *)(rsp_hdr + 1);
+		rsp->gather_recv = length;
+		rsp->gather_status = (doca_error_t)gather_hdr->status;
+		rsp->gathered = 1;
+		DOCA_LOG_INFO("Received gather Reply, ID: %#lx length: %lu status: %s",
+			      gather_hdr->gather_id,
+			      length,
+			      doca_error_get_name(rsp->gather_status));
+
+		if (param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
+			/* Keep the descriptor, data is fetched by the gather caller */
+			rsp->gather_desc = data;
+			return UCS_INPROGRESS;
+		}
+
+		if (length <= rsp->gather_len)
+			memcpy(rsp->gather_buf, data, length);
+		return UCS_OK;
+	default:
+		DOCA_LOG_ERR("Unknown AM Reply: %u", rsp_hdr->rsp_id);
+		return UCS_OK;
+	}
 }
 
 /*
@@ -449,7 +901,7 @@ static ucs_status_t rdmo_am_cb(void *arg,
  * @port [in]: socket port
  * @client_ucp_ep [out]: set client UCP endpoint
  * @ucp_worker [out]: set client UCP worker
- * @flushed [out]: client argument will be set once flush op is done
+ * @rsp [in]: client response state, updated by the AM reply handler
  * @ucp_context_p [out]: set UCP context
  * @return: DOCA_SUCCESS on success and DOCA_ERROR otherwise
  */
@@ -457,7 +909,7 @@ static doca_error_t rdmo_wireup_client(char *server_name,
 				       int port,
 				       ucp_ep_h *client_ucp_ep,
 				       ucp_worker_h *ucp_worker,
-				       int *flushed,
+				       struct rdmo_client_rsp *rsp,
 				       ucp_context_h *ucp_context_p)
 {
 	doca_error_t result;
@@ -542,7 +994,7 @@ static doca_error_t rdmo_wireup_client(char *server_name,
 			      UCP_AM_HANDLER_PARAM_FIELD_ARG;
 	am_param.id = 0;
 	am_param.cb = rdmo_am_cb;
-	am_param.arg = flushed;
+	am_param.arg = rsp;
 
 	ucs_status = ucp_worker_set_am_recv_handler(client_ucp_worker, &am_param);
 	if (ucs_status != UCS_OK) {
@@ -1444,7 +1896,7 @@ doca_error_t rdmo_server(char *device_name)
 	ucp_mem_h memh;
 	size_t bytes_sent = 8;
 	int port = 18515;
-	uint64_t rq_id = 0, expected_ptr;
+	uint64_t rq_id = 0, expected_ptr, acc_sum, expected_sum;
 	bool succeeded = true;
 	void *queue_buf = NULL;
 	ucp_context_h ucp_context;
@@ -1454,6 +1906,7 @@ doca_error_t rdmo_server(char *device_name)
 	ucp_worker_h server_ucp_worker;
 	doca_error_t result, tmp_result;
 	size_t i, *queue_ptr, send_len = 8;
+	uint64_t *counters;
 	uint64_t rbuf_desc_len, rkey = 0;
 	/* DOCA UROM objects */
 	struct doca_pe *pe;
@@ -1557,6 +2010,41 @@ doca_error_t rdmo_server(char *device_name)
 	} else
 		DOCA_LOG_INFO("Scatter operation was finished successfully");
 
+	/* Worker progress accumulate, counters live in the upper half the other tests never touch */
+	counters = (uint64_t *)((uintptr_t)queue_buf + queue_len / 2);
+	expected_sum = ACCUMULATE_ROUNDS * ACCUMULATE_COUNT * (ACCUMULATE_COUNT + 1) / 2;
+	do {
+		ucp_worker_progress(server_ucp_worker);
+		sched_yield();
+		for (acc_sum = 0, i = 0; i < ACCUMULATE_COUNT; i++)
+			acc_sum += __atomic_load_n(&counters[i], __ATOMIC_RELAXED);
+	} while (acc_sum < expected_sum);
+
+	succeeded = true;
+	for (i = 0; i < ACCUMULATE_COUNT; i++) {
+		if (counters[i] != ACCUMULATE_ROUNDS * (i + 1)) {
+			succeeded = false;
+			DOCA_LOG_ERR("Accumulate bad counter[%ld]: %lu, expected: %lu",
+				     i,
+				     counters[i],
+				     ACCUMULATE_ROUNDS * (i + 1));
+		}
+	}
+
+	if (!succeeded) {
+		DOCA_LOG_ERR("Accumulate operation failed");
+		result = DOCA_ERROR_BAD_STATE;
+		goto memh_unmap;
+	} else
+		DOCA_LOG_INFO("Accumulate operation was finished successfully");
+
+	/* Client-Server barrier, keep memory registered while the client runs the scatter benchmark */
+	result = cs_barrier(NULL, port, RDMO_MODE_SERVER);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to execute barrier between client and server");
+		goto memh_unmap;
+	}
+
 	result = DOCA_SUCCESS;
 
 memh_unmap:
@@ -1592,12 +2080,16 @@ doca_error_t rdmo_client(char *server_name)
 	ucp_context_h ucp_context;
 	size_t queue_len = 128 * 1024;
 	struct rbuf_desc *rbuf_desc = NULL;
-	int flushed = 0, port = 18515;
+	struct rdmo_client_rsp rsp = {0};
+	int port = 18515;
 	uint64_t rkey, rbuf_desc_len, *queue_ptr;
 	int scatter_chunk_size = 8, scatter_chunks = 16;
+	uint64_t operands[ACCUMULATE_COUNT];
+	char *gather_buf;
+	size_t i, j;
 
 	/* Client wireup */
-	result = rdmo_wireup_client(server_name, port, &client_ucp_ep, &ucp_worker, &flushed, &ucp_context);
+	result = rdmo_wireup_client(server_name, port, &client_ucp_ep, &ucp_worker, &rsp, &ucp_context);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("rdmo_wireup_client() returned error");
 		return result;
@@ -1630,14 +2122,14 @@ doca_error_t rdmo_client(char *server_name)
 	send_len = 8;
 
 	/* RDMO append operation */
-	result = rdmo_append(ucp_worker, client_ucp_ep, queue_ptr, send_buf, send_len, rkey);
+	result = rdmo_append(ucp_worker, client_ucp_ep, queue_ptr, send_buf, send_len, rkey, 0);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to start append RDMO op");
 		goto free_buf;
 	}
 
 	/* RDMO flush operation */
-	result = rdmo_flush(ucp_worker, client_ucp_ep, &flushed);
+	result = rdmo_flush(ucp_worker, client_ucp_ep, &rsp);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to start flush RDMO op");
 		goto free_buf;
@@ -1659,19 +2151,116 @@ doca_error_t rdmo_client(char *server_name)
 			      send_buf,
 			      send_len,
 			      scatter_chunk_size,
-			      rkey);
+			      NULL,
+			      rkey,
+			      0);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to start scatter RDMO op");
 		goto free_buf;
 	}
 
 	/* RDMO flush operation */
-	result = rdmo_flush(ucp_worker, client_ucp_ep, &flushed);
+	result = rdmo_flush(ucp_worker, client_ucp_ep, &rsp);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to start flush RDMO op");
+		goto free_buf;
+	}
+
+	/* RDMO gather operation, read back the scattered chunks in one round trip */
+	gather_buf = calloc(1, send_len);
+	if (gather_buf == NULL) {
+		DOCA_LOG_ERR("Failed to allocate gather buffer memory");
+		result = DOCA_ERROR_NO_MEMORY;
+		goto free_buf;
+	}
+
+	result = rdmo_gather(ucp_worker,
+			     client_ucp_ep,
+			     &rsp,
+			     (uint64_t)queue_ptr,
+			     gather_buf,
+			     send_len,
+			     scatter_chunk_size,
+			     rkey);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to start gather RDMO op");
+		free(gather_buf);
+		goto free_buf;
+	}
+
+	for (i = 0; i < send_len; i++) {
+		if (gather_buf[i] != data_val) {
+			DOCA_LOG_ERR("Gather bad data[%ld]: %#x, expected: %#x", i, gather_buf[i], data_val);
+			result = DOCA_ERROR_BAD_STATE;
+		}
+	}
+	free(gather_buf);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Gather operation failed");
+		goto free_buf;
+	}
+	DOCA_LOG_INFO("Gather operation was finished successfully");
+
+	/* RDMO accumulate operation, every round adds i + 1 to counter i */
+	for (i = 0; i < ACCUMULATE_COUNT; i++)
+		operands[i] = i + 1;
+
+	for (j = 0; j < ACCUMULATE_ROUNDS; j++) {
+		result = rdmo_accumulate(ucp_worker,
+					 client_ucp_ep,
+					 (uint64_t)queue_ptr + queue_len / 2,
+					 operands,
+					 ACCUMULATE_COUNT,
+					 rkey);
+		if (result != DOCA_SUCCESS) {
+			DOCA_LOG_ERR("Failed to start accumulate RDMO op");
+			goto free_buf;
+		}
+	}
+
+	/* RDMO flush operation */
+	result = rdmo_flush(ucp_worker, client_ucp_ep, &rsp);
 	if (result != DOCA_SUCCESS) {
 		DOCA_LOG_ERR("Failed to start flush RDMO op");
 		goto free_buf;
 	}
 
+	/* RDMO scatter benchmark, coalesced sorted IOVs versus random IOVs */
+	result = rdmo_scatter_bench(ucp_worker,
+				    client_ucp_ep,
+				    &rsp,
+				    (uint64_t)queue_ptr,
+				    send_buf,
+				    SCATTER_BENCH_CHUNK_SIZE,
+				    SCATTER_BENCH_CHUNKS,
+				    SCATTER_BENCH_ITERS,
+				    rkey);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to run scatter benchmark");
+		goto free_buf;
+	}
+
+	/* RDMO ordering domains benchmark, appends use the second quarter of the queue buffer */
+	result = rdmo_domain_bench(ucp_worker,
+				   client_ucp_ep,
+				   &rsp,
+				   (uint64_t)queue_ptr + queue_len / 4,
+				   (uint64_t)queue_ptr,
+				   send_buf,
+				   DOMAIN_BENCH_ITERS,
+				   rkey);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to run ordering domains benchmark");
+		goto free_buf;
+	}
+
+	/* Client-Server barrier */
+	result = cs_barrier(server_name, port, RDMO_MODE_CLIENT);
+	if (result != DOCA_SUCCESS) {
+		DOCA_LOG_ERR("Failed to execute barrier between client and server");
+		goto free_buf;
+	}
+
 	return DOCA_SUCCESS;
 
 free_buf: